@@ -942,6 +942,8 @@ typedef JMETHOD(boolean, jpeg_marker_parser_method, (j_decompress_ptr cinfo));
 #define jpeg_abort		jAbort
 #define jpeg_destroy		jDestroy
 #define jpeg_resync_to_restart	jResyncRestart
+#define jpeg_simd_level		jSimdLevel
+#define jpeg_simd_force		jSimdForce
 #endif /* NEED_SHORT_EXTERNAL_NAMES */
 
 
@@ -1118,6 +1120,20 @@ EXTERN(void) jpeg_destroy JPP((j_common_ptr cinfo));
 EXTERN(boolean) jpeg_resync_to_restart JPP((j_decompress_ptr cinfo,
 					    int desired));
 
+/* Instruction set levels of the SIMD code (see jsimd.c).  The library
+ * detects the highest level the CPU supports at run time; each level
+ * implies the ones below it.
+ */
+#define JSIMD_NONE	0	/* portable C code only */
+#define JSIMD_SSE2	1	/* SSE2 */
+#define JSIMD_AVX2	2	/* AVX2 (with SSSE3 and SSE4.1) */
+#define JSIMD_AVX512	3	/* AVX-512 F and BW */
+
+/* Level used for objects initialized from now on */
+EXTERN(int) jpeg_simd_level JPP((void));
+/* Cap the level for testing and benchmarking; returns the resulting level */
+EXTERN(int) jpeg_simd_force JPP((int level));
+
 
 /* These marker codes are exported since applications and data source modules
  * are likely to want to use them.
@@ -0,0 +1,131 @@
+/*
+ * jsimd.h
+ *
+ * This file is part of the Independent JPEG Group's software.
+ * For conditions of distribution and use, see the accompanying README file.
+ *
+ * This include file contains the declarations for the run-time SIMD
+ * dispatcher (jsimd.c).  These declarations are private to the library
+ * modules that have SIMD versions of their inner loops and to the
+ * instruction-set specific files (jsimdsse.c, jsimdavx.c, jsimd512.c).
+ *
+ * The dispatcher detects the CPU features once, and then hands out a
+ * table of method pointers for the selected instruction set level (see
+ * jpeg_simd_level() and jpeg_simd_force() in jpeglib.h).  A module looks
+ * at the table when it is initialized and uses a SIMD method wherever
+ * the table has one; a NULL entry selects the portable C code.  All SIMD
+ * methods produce exactly the same output as the C code they replace.
+ */
+
+#ifndef JSIMD_H
+#define JSIMD_H
+
+
+/*
+ * SIMD code is compiled for 8-bit samples on x86 and x86-64, by compilers
+ * that can generate code for a given instruction set per function
+ * (GCC 4.9 or later, Clang, MSVC).  Define NO_SIMD to build the portable
+ * C code only; the dispatcher then always reports JSIMD_NONE.
+ */
+
+#if BITS_IN_JSAMPLE == 8 && !defined(NO_SIMD)
+#if defined(__x86_64__) || defined(__i386__) || \
+    defined(_M_X64) || defined(_M_AMD64) || defined(_M_IX86)
+#if defined(_MSC_VER) || defined(__clang__) || (defined(__GNUC__) && \
+    (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))
+#define JSIMD_X86_SUPPORTED
+#endif
+#endif
+#endif
+
+#ifdef JSIMD_X86_SUPPORTED
+#if defined(__GNUC__) || defined(__clang__)
+/* Compile a function for the given instruction set, whatever -m options
+ * are used for the rest of the library.
+ */
+#define JSIMD_TARGET(isa)	__attribute__((target(isa)))
+#else
+#define JSIMD_TARGET(isa)	/* MSVC accepts intrinsics of any ISA */
+#endif
+#endif
+
+
+/* Same as DCTELEM in jdct.h, which is not included here */
+#if BITS_IN_JSAMPLE == 8
+typedef int jsimd_dctelem;
+#else
+typedef INT32 jsimd_dctelem;
+#endif
+
+/* One bit per coefficient of a block */
+#ifdef _MSC_VER
+typedef unsigned __int64 jsimd_bitmap;
+#else
+typedef unsigned long long jsimd_bitmap;
+#endif
+
+
+/* The method table.  Row methods process a single row; the calling module
+ * takes care of the edge handling and of the loop over the rows.
+ */
+
+struct jsimd_methods {
+  /* jccolor.c: RGB => YCbCr conversion of num_cols pixels */
+  JMETHOD(void, rgb_ycc_convert, (JSAMPROW inptr, JSAMPROW outptr0,
+				  JSAMPROW outptr1, JSAMPROW outptr2,
+				  JDIMENSION num_cols));
+  /* jdcolor.c: YCbCr => RGB conversion of num_cols pixels */
+  JMETHOD(void, ycc_rgb_convert, (JSAMPROW inptr0, JSAMPROW inptr1,
+				  JSAMPROW inptr2, JSAMPROW outptr,
+				  JDIMENSION num_cols));
+  /* jcsample.c: 2:1 downsampling of input_data[0] (h2v1) or of
+   * input_data[0..1] (h2v2) into output_cols samples; the input rows have
+   * been edge-expanded to 2 * output_cols samples.  The smoothing version
+   * also reads the context rows input_data[-1] and input_data[2].
+   */
+  JMETHOD(void, h2v1_downsample, (JSAMPARRAY input_data, JSAMPROW outptr,
+				  JDIMENSION output_cols));
+  JMETHOD(void, h2v2_downsample, (JSAMPARRAY input_data, JSAMPROW outptr,
+				  JDIMENSION output_cols));
+  JMETHOD(void, h2v2_smooth_downsample, (JSAMPARRAY input_data,
+					 JSAMPROW outptr,
+					 JDIMENSION output_cols,
+					 int smoothing_factor));
+  /* jdsample.c: 2:1 horizontal box upsampling of one row; writes
+   * output_width samples, rounded up to an even count.
+   */
+  JMETHOD(void, h2_upsample, (JSAMPROW inptr, JSAMPROW outptr,
+			      JDIMENSION output_width));
+  /* jfdctint.c: replacement for jpeg_fdct_islow */
+  JMETHOD(void, fdct_islow, (jsimd_dctelem * data, JSAMPARRAY sample_data,
+			     JDIMENSION start_col));
+  /* jidctint.c: replacement for jpeg_idct_islow */
+  inverse_DCT_method_ptr idct_islow;
+  /* jchuff.c: store the 64 coefficients of block in zigzag order
+   * (coef[k] = block[jpeg_natural_order[k]]), and return a bitmap
+   * in which bit k is set when coef[k] is nonzero.
+   */
+  JMETHOD(jsimd_bitmap, huff_zigzag, (JCOEFPTR block, JCOEFPTR coef));
+};
+
+
+/* Short forms of external names for systems with brain-damaged linkers. */
+
+#ifdef NEED_SHORT_EXTERNAL_NAMES
+#define jsimd_methods		jSimdMethods
+#define jsimd_fill_sse2		jSimdFillSSE2
+#define jsimd_fill_avx2		jSimdFillAVX2
+#define jsimd_fill_avx512	jSimdFillAVX512
+#endif /* NEED_SHORT_EXTERNAL_NAMES */
+
+/* Method table for the current level; valid for the life of the process */
+EXTERN(const struct jsimd_methods *) jsimd_methods JPP((void));
+
+#ifdef JSIMD_X86_SUPPORTED
+/* Each of these sets the entries it has a method for, keeping the others */
+EXTERN(void) jsimd_fill_sse2 JPP((struct jsimd_methods * methods));
+EXTERN(void) jsimd_fill_avx2 JPP((struct jsimd_methods * methods));
+EXTERN(void) jsimd_fill_avx512 JPP((struct jsimd_methods * methods));
+#endif
+
+#endif /* JSIMD_H */
@@ -12,6 +12,7 @@
 #define JPEG_INTERNALS
 #include "jinclude.h"
 #include "jpeglib.h"
+#include "jsimd.h"
 
 
 /* Private subobject */
@@ -21,6 +22,9 @@ typedef struct {
 
   /* Private state for RGB->YCC conversion */
   INT32 * rgb_ycc_tab;		/* => table for RGB to YCbCr conversion */
+
+  /* SIMD row methods, or NULL entries for the C code */
+  const struct jsimd_methods * simd;
 } my_color_converter;
 
 typedef my_color_converter * my_cconvert_ptr;
@@ -185,6 +189,29 @@ rgb_ycc_convert (j_compress_ptr cinfo,
 }
 
 
+/*
+ * Same as above, using the SIMD row method of jsimd.c.
+ * The tables are not needed for this.
+ */
+
+METHODDEF(void)
+rgb_ycc_convert_simd (j_compress_ptr cinfo,
+		      JSAMPARRAY input_buf, JSAMPIMAGE output_buf,
+		      JDIMENSION output_row, int num_rows)
+{
+  my_cconvert_ptr cconvert = (my_cconvert_ptr) cinfo->cconvert;
+
+  while (--num_rows >= 0) {
+    (*cconvert->simd->rgb_ycc_convert) (*input_buf++,
+					output_buf[0][output_row],
+					output_buf[1][output_row],
+					output_buf[2][output_row],
+					cinfo->image_width);
+    output_row++;
+  }
+}
+
+
 /**************** Cases other than RGB -> YCbCr **************/
 
 
@@ -441,6 +468,7 @@ jinit_color_converter (j_compress_ptr cinfo)
   cinfo->cconvert = &cconvert->pub;
   /* set start_pass to null method until we find out differently */
   cconvert->pub.start_pass = null_method;
+  cconvert->simd = jsimd_methods();
 
   /* Make sure input_components agrees with in_color_space */
   switch (cinfo->in_color_space) {
@@ -525,6 +553,10 @@ jinit_color_converter (j_compress_ptr cinfo)
     case JCS_RGB:
       cconvert->pub.start_pass = rgb_ycc_start;
       cconvert->pub.color_convert = rgb_ycc_convert;
+      if (cconvert->simd->rgb_ycc_convert != NULL) {
+	cconvert->pub.start_pass = null_method;
+	cconvert->pub.color_convert = rgb_ycc_convert_simd;
+      }
       break;
     case JCS_YCbCr:
       cconvert->pub.color_convert = null_convert;
@@ -550,6 +582,10 @@ jinit_color_converter (j_compress_ptr cinfo)
       /* compute normal YCC first */
       cconvert->pub.start_pass = rgb_ycc_start;
       cconvert->pub.color_convert = rgb_ycc_convert;
+      if (cconvert->simd->rgb_ycc_convert != NULL) {
+	cconvert->pub.start_pass = null_method;
+	cconvert->pub.color_convert = rgb_ycc_convert_simd;
+      }
       break;
     case JCS_YCbCr:
       /* need quantization scale by factor of 2 after DCT */
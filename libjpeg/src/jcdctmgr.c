@@ -16,6 +16,7 @@
 #include "jinclude.h"
 #include "jpeglib.h"
 #include "jdct.h"		/* Private declarations for DCT subsystem */
+#include "jsimd.h"
 
 
 /* Private subobject for this module */
@@ -30,6 +31,9 @@ typedef struct {
   /* Same as above for the floating-point case. */
   float_DCT_method_ptr do_float_dct[MAX_COMPONENTS];
 #endif
+
+  /* SIMD methods, or NULL entries for the C code */
+  const struct jsimd_methods * simd;
 } my_fdct_controller;
 
 typedef my_fdct_controller * my_fdct_ptr;
@@ -324,6 +328,8 @@ start_pass_fdctmgr (j_compress_ptr cinfo)
 #ifdef DCT_ISLOW_SUPPORTED
       case JDCT_ISLOW:
 	fdct->do_dct[ci] = jpeg_fdct_islow;
+	if (fdct->simd->fdct_islow != NULL)
+	  fdct->do_dct[ci] = fdct->simd->fdct_islow;
 	method = JDCT_ISLOW;
 	break;
 #endif
@@ -456,6 +462,7 @@ jinit_forward_dct (j_compress_ptr cinfo)
     ((j_common_ptr) cinfo, JPOOL_IMAGE, SIZEOF(my_fdct_controller));
   cinfo->fdct = &fdct->pub;
   fdct->pub.start_pass = start_pass_fdctmgr;
+  fdct->simd = jsimd_methods();
 
   for (ci = 0, compptr = cinfo->comp_info; ci < cinfo->num_components;
        ci++, compptr++) {
@@ -23,6 +23,7 @@
 #define JPEG_INTERNALS
 #include "jinclude.h"
 #include "jpeglib.h"
+#include "jsimd.h"
 
 
 /* The legal range of a DCT coefficient is
@@ -31,12 +32,51 @@
  * Hence the magnitude should always fit in sample data precision + 2 bits.
  */
 
+/* Sequential Huffman encoding has a fast path which collects bits in a
+ * 64-bit accumulator and stores them 8 bytes at a time when none of those
+ * bytes needs 0xFF stuffing.  It writes straight into the destination
+ * buffer, so it is used only for MCUs that are guaranteed to fit into the
+ * free space (FAST_BYTES_PER_BLOCK per block is an upper bound including
+ * stuffing); the bytewise code handles the rest, including restarts and
+ * output suspension.  Define NO_HUFF_FAST_PATH to use the bytewise code
+ * only, e.g. for compilers without a 64-bit integer type.
+ */
+
+#ifndef NO_HUFF_FAST_PATH
+#define HUFF_FAST_PATH_SUPPORTED
+#ifdef _MSC_VER
+typedef unsigned __int64 bit_buf_type;
+#else
+typedef unsigned long long bit_buf_type;
+#endif
+#define BIT_BUF_SIZE  64	/* size of bit_buf_type in bits */
+#define FAST_BYTES_PER_BLOCK  (DCTSIZE2 * 8)
+#endif
+
+/* With a SIMD zigzag scan (jsimd.c), the fast path gets a bitmap of the
+ * nonzero coefficients of a block and jumps from one to the next with a
+ * count-trailing-zeros instead of testing all 63 AC coefficients.
+ */
+
+#if defined(HUFF_FAST_PATH_SUPPORTED) && defined(JSIMD_X86_SUPPORTED)
+#define HUFF_ZIGZAG_SUPPORTED
+#if defined(__GNUC__) || defined(__clang__)
+#define huff_ctz(bits)  __builtin_ctzll(bits)
+#else
+#include <intrin.h>
+#endif
+#endif
+
+
 /* Derived data constructed for each Huffman table */
 
 typedef struct {
   unsigned int ehufco[256];	/* code for each symbol */
   char ehufsi[256];		/* length of code for each symbol */
   /* If no code has been allocated for a symbol S, ehufsi[S] contains 0 */
+#ifdef HUFF_FAST_PATH_SUPPORTED
+  unsigned int ehufcs[256];	/* code << 8 | length, for the fast path */
+#endif
 } c_derived_tbl;
 
 
@@ -106,6 +146,11 @@ typedef struct {
   unsigned int BE;		/* # of buffered correction bits before MCU */
   char * bit_buffer;		/* buffer for correction bits (1 per char) */
   /* packing correction bits tightly would save some space but cost time... */
+
+#ifdef HUFF_ZIGZAG_SUPPORTED
+  /* SIMD zigzag scan for the fast path, or NULL */
+  JMETHOD(jsimd_bitmap, huff_zigzag, (JCOEFPTR block, JCOEFPTR coef));
+#endif
 } huff_entropy_encoder;
 
 typedef huff_entropy_encoder * huff_entropy_ptr;
@@ -236,6 +281,14 @@ jpeg_make_c_derived_tbl (j_compress_ptr cinfo, boolean isDC, int tblno,
     dtbl->ehufco[i] = huffcode[p];
     dtbl->ehufsi[i] = huffsize[p];
   }
+
+#ifdef HUFF_FAST_PATH_SUPPORTED
+  /* Pack code and length so that the fast path needs a single load
+   * per symbol; codeless symbols keep length 0.
+   */
+  for (i = 0; i < 256; i++)
+    dtbl->ehufcs[i] = (dtbl->ehufco[i] << 8) | (unsigned int) dtbl->ehufsi[i];
+#endif
 }
 
 
@@ -1014,6 +1067,272 @@ encode_one_block (working_state * state, JCOEFPTR block, int last_dc_val,
 }
 
 
+#ifdef HUFF_FAST_PATH_SUPPORTED
+
+/* Working state of the fast path while writing an MCU.
+ * The valid bits of put_buffer are right-justified; there are
+ * BIT_BUF_SIZE - free_bits of them (any bits above are stale).
+ */
+
+typedef struct {
+  bit_buf_type put_buffer;	/* bit-accumulation buffer */
+  int free_bits;		/* # of unused bits in put_buffer */
+  JOCTET * next_output_byte;	/* => next byte to write in buffer */
+} fast_state;
+
+
+/* Store the 8 bytes of a full accumulator, stuffing a zero byte after
+ * each 0xFF.  The test looks for a byte whose value is 0xFF, so the common
+ * case costs a single check.
+ */
+
+LOCAL(void)
+fast_flush (fast_state * state, bit_buf_type put_buffer)
+{
+  register JOCTET * buffer = state->next_output_byte;
+  register int shift;
+  int c;
+
+  if ((put_buffer & 0x8080808080808080ULL &
+       ~(put_buffer + 0x0101010101010101ULL)) == 0) {
+    buffer[0] = (JOCTET) (put_buffer >> 56);
+    buffer[1] = (JOCTET) (put_buffer >> 48);
+    buffer[2] = (JOCTET) (put_buffer >> 40);
+    buffer[3] = (JOCTET) (put_buffer >> 32);
+    buffer[4] = (JOCTET) (put_buffer >> 24);
+    buffer[5] = (JOCTET) (put_buffer >> 16);
+    buffer[6] = (JOCTET) (put_buffer >> 8);
+    buffer[7] = (JOCTET) (put_buffer);
+    buffer += 8;
+  } else {
+    for (shift = 56; shift >= 0; shift -= 8) {
+      c = (int) (put_buffer >> shift) & 0xFF;
+      *buffer++ = (JOCTET) c;
+      if (c == 0xFF)		/* need to stuff a zero byte? */
+	*buffer++ = 0;
+    }
+  }
+
+  state->next_output_byte = buffer;
+}
+
+
+/* Append size bits of code (already masked) to the accumulator.
+ * size is at most 16 + 15 bits, a Huffman code plus its value bits.
+ */
+
+#define fast_put_bits(state,code,size)  \
+	{ if (((state)->free_bits -= (size)) < 0) {  \
+	    fast_flush(state, ((state)->put_buffer <<  \
+			       ((size) + (state)->free_bits)) |  \
+			      ((bit_buf_type) (code) >> -(state)->free_bits));  \
+	    (state)->free_bits += BIT_BUF_SIZE;  \
+	    (state)->put_buffer = (bit_buf_type) (code);  \
+	  } else  \
+	    (state)->put_buffer = ((state)->put_buffer << (size)) | (code); }
+
+
+/* Emit the run of r zeros and the nonzero coefficient temp (fast path).
+ * Uses the local variables of encode_one_block_fast().
+ */
+
+#define fast_put_ac(r,temp)  \
+	{ /* if run length > 15, must emit special run-length-16 codes (0xF0) */  \
+	  while (r > 15) {  \
+	    cs = actbl->ehufcs[0xF0];  \
+	    if ((size = (int) (cs & 0xFF)) == 0)  \
+	      ERREXIT(cinfo, JERR_HUFF_MISSING_CODE);  \
+	    code = cs >> 8;  \
+	    fast_put_bits(state, code, size);  \
+	    r -= 16;  \
+	  }  \
+	  if ((temp2 = temp) < 0) {  \
+	    temp = -temp;  \
+	    temp2--;  \
+	  }  \
+	  nbits = 0;  \
+	  do nbits++;  \
+	  while ((temp >>= 1));  \
+	  if (nbits >= max_coef_bits)  \
+	    ERREXIT(cinfo, JERR_BAD_DCT_COEF);  \
+	  cs = actbl->ehufcs[(r << 4) + nbits];  \
+	  if ((size = (int) (cs & 0xFF)) == 0)  \
+	    ERREXIT(cinfo, JERR_HUFF_MISSING_CODE);  \
+	  code = ((cs >> 8) << nbits) |  \
+		 ((unsigned int) temp2 & ((((unsigned int) 1) << nbits) - 1));  \
+	  size += nbits;  \
+	  fast_put_bits(state, code, size); }
+
+
+#if defined(HUFF_ZIGZAG_SUPPORTED) && !defined(huff_ctz)
+
+/* Index of the lowest set bit; bits must not be 0 */
+
+LOCAL(int)
+huff_ctz (jsimd_bitmap bits)
+{
+  unsigned long index;
+
+#if defined(_M_X64) || defined(_M_AMD64)
+  _BitScanForward64(&index, bits);
+#else
+  if (! _BitScanForward(&index, (unsigned long) bits)) {
+    _BitScanForward(&index, (unsigned long) (bits >> 32));
+    index += 32;
+  }
+#endif
+  return (int) index;
+}
+
+#endif
+
+
+/* Encode a single block's worth of coefficients (fast path).
+ * The Huffman symbol and the value bits that follow it are merged
+ * into a single fast_put_bits() call.
+ */
+
+LOCAL(void)
+encode_one_block_fast (j_compress_ptr cinfo, fast_state * state,
+		       JCOEFPTR block, int last_dc_val,
+		       c_derived_tbl *dctbl, c_derived_tbl *actbl)
+{
+  register int temp, temp2;
+  register int nbits;
+  register int r, k;
+  register unsigned int cs, code;
+  int size;
+  int Se = cinfo->lim_Se;
+  int max_coef_bits = cinfo->data_precision + 3;
+  const int * natural_order = cinfo->natural_order;
+#ifdef HUFF_ZIGZAG_SUPPORTED
+  huff_entropy_ptr entropy = (huff_entropy_ptr) cinfo->entropy;
+#endif
+
+  /* Encode the DC coefficient difference per section F.1.2.1 */
+
+  temp = temp2 = block[0] - last_dc_val;
+  if (temp < 0) {
+    temp = -temp;
+    temp2--;
+  }
+  nbits = 0;
+  while (temp) {
+    nbits++;
+    temp >>= 1;
+  }
+  if (nbits > max_coef_bits)
+    ERREXIT(cinfo, JERR_BAD_DCT_COEF);
+
+  cs = dctbl->ehufcs[nbits];
+  if ((size = (int) (cs & 0xFF)) == 0)
+    ERREXIT(cinfo, JERR_HUFF_MISSING_CODE);
+  code = ((cs >> 8) << nbits) |
+	 ((unsigned int) temp2 & ((((unsigned int) 1) << nbits) - 1));
+  size += nbits;
+  fast_put_bits(state, code, size);
+
+  /* Encode the AC coefficients per section F.1.2.2 */
+
+#ifdef HUFF_ZIGZAG_SUPPORTED
+  if (entropy->huff_zigzag != NULL) {
+    JCOEF coef[DCTSIZE2];
+    jsimd_bitmap bits;
+
+    /* Drop the DC bit; the bits left are AC coefficients 1..63 */
+    bits = (*entropy->huff_zigzag) (block, coef) >> 1;
+    k = 0;
+    while (bits != 0) {
+      r = huff_ctz(bits);	/* r = run length of zeros */
+      k += r + 1;
+      bits >>= r + 1;		/* r + 1 <= 63 */
+      temp = coef[k];
+      fast_put_ac(r, temp);
+    }
+    r = Se - k;			/* trailing zeros */
+  } else
+#endif
+  {
+    r = 0;			/* r = run length of zeros */
+
+    for (k = 1; k <= Se; k++) {
+      if ((temp = block[natural_order[k]]) == 0) {
+	r++;
+	continue;
+      }
+
+      fast_put_ac(r, temp);
+
+      r = 0;			/* reset zero run length */
+    }
+  }
+
+  /* If the last coef(s) were zero, emit an end-of-block code */
+  if (r > 0) {
+    cs = actbl->ehufcs[0];
+    if ((size = (int) (cs & 0xFF)) == 0)
+      ERREXIT(cinfo, JERR_HUFF_MISSING_CODE);
+    code = cs >> 8;
+    fast_put_bits(state, code, size);
+  }
+}
+
+
+/*
+ * Encode and output one MCU using the fast path.
+ * The caller has made sure that the MCU fits into the output buffer
+ * and that no restart marker is due.
+ */
+
+LOCAL(void)
+encode_mcu_huff_fast (j_compress_ptr cinfo, JBLOCKARRAY MCU_data)
+{
+  huff_entropy_ptr entropy = (huff_entropy_ptr) cinfo->entropy;
+  fast_state state;
+  JOCTET * buffer;
+  int blkn, ci, nbits, c;
+  jpeg_component_info * compptr;
+
+  /* Load up working state, right-justifying the saved bits */
+  nbits = entropy->saved.put_bits;
+  state.put_buffer = (bit_buf_type) (entropy->saved.put_buffer >> (24 - nbits));
+  state.free_bits = BIT_BUF_SIZE - nbits;
+  state.next_output_byte = cinfo->dest->next_output_byte;
+
+  /* Encode the MCU data blocks */
+  for (blkn = 0; blkn < cinfo->blocks_in_MCU; blkn++) {
+    ci = cinfo->MCU_membership[blkn];
+    compptr = cinfo->cur_comp_info[ci];
+    encode_one_block_fast(cinfo, &state,
+			  MCU_data[blkn][0], entropy->saved.last_dc_val[ci],
+			  entropy->dc_derived_tbls[compptr->dc_tbl_no],
+			  entropy->ac_derived_tbls[compptr->ac_tbl_no]);
+    /* Update last_dc_val */
+    entropy->saved.last_dc_val[ci] = MCU_data[blkn][0][0];
+  }
+
+  /* Write out the complete bytes; at most 7 bits stay behind,
+   * left-justified in 24 bits as the bytewise code keeps them.
+   */
+  buffer = state.next_output_byte;
+  for (nbits = BIT_BUF_SIZE - state.free_bits; nbits >= 8; nbits -= 8) {
+    c = (int) (state.put_buffer >> (nbits - 8)) & 0xFF;
+    *buffer++ = (JOCTET) c;
+    if (c == 0xFF)		/* need to stuff a zero byte? */
+      *buffer++ = 0;
+  }
+  entropy->saved.put_buffer =
+    ((INT32) state.put_buffer & ((((INT32) 1) << nbits) - 1)) << (24 - nbits);
+  entropy->saved.put_bits = nbits;
+
+  /* Completed MCU, so update the destination */
+  cinfo->dest->free_in_buffer -= (size_t) (buffer - cinfo->dest->next_output_byte);
+  cinfo->dest->next_output_byte = buffer;
+}
+
+#endif /* HUFF_FAST_PATH_SUPPORTED */
+
+
 /*
  * Encode and output one MCU's worth of Huffman-compressed coefficients.
  */
@@ -1026,6 +1345,20 @@ encode_mcu_huff (j_compress_ptr cinfo, JBLOCKARRAY MCU_data)
   int blkn, ci;
   jpeg_component_info * compptr;
 
+#ifdef HUFF_FAST_PATH_SUPPORTED
+  /* Take the fast path unless a restart marker is due or the MCU
+   * might not fit into the space left in the output buffer.
+   */
+  if ((cinfo->restart_interval == 0 || entropy->restarts_to_go != 0) &&
+      cinfo->dest->free_in_buffer >=
+      (size_t) (cinfo->blocks_in_MCU + 1) * FAST_BYTES_PER_BLOCK) {
+    encode_mcu_huff_fast(cinfo, MCU_data);
+    if (cinfo->restart_interval)
+      entropy->restarts_to_go--;
+    return TRUE;
+  }
+#endif
+
   /* Load up working state */
   state.next_output_byte = cinfo->dest->next_output_byte;
   state.free_in_buffer = cinfo->dest->free_in_buffer;
@@ -1576,6 +1909,12 @@ start_pass_huff (j_compress_ptr cinfo, boolean gather_statistics)
       entropy->pub.encode_mcu = encode_mcu_gather;
     else
       entropy->pub.encode_mcu = encode_mcu_huff;
+#ifdef HUFF_ZIGZAG_SUPPORTED
+    /* The SIMD scan covers full 8x8 blocks in the standard order only */
+    entropy->huff_zigzag = NULL;
+    if (cinfo->lim_Se == DCTSIZE2-1 && cinfo->natural_order == jpeg_natural_order)
+      entropy->huff_zigzag = jsimd_methods()->huff_zigzag;
+#endif
   }
 
   for (ci = 0; ci < cinfo->comps_in_scan; ci++) {
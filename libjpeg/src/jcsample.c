@@ -50,6 +50,8 @@
 #include "jinclude.h"
 #include "jpeglib.h"
 
+#include "jsimd.h"
+
 
 /* Pointer to routine to downsample a single component */
 typedef JMETHOD(void, downsample1_ptr,
@@ -72,6 +74,9 @@ typedef struct {
    */
   UINT8 h_expand[MAX_COMPONENTS];
   UINT8 v_expand[MAX_COMPONENTS];
+
+  /* SIMD row methods, or NULL entries for the C code */
+  const struct jsimd_methods * simd;
 } my_downsampler;
 
 typedef my_downsampler * my_downsample_ptr;
@@ -470,6 +475,75 @@ fullsize_smooth_downsample (j_compress_ptr cinfo, jpeg_component_info *compptr,
 #endif /* INPUT_SMOOTHING_SUPPORTED */
 
 
+/*
+ * Versions of the 2:1 downsamplers that hand each row (pair) to the
+ * SIMD row methods of jsimd.c.  The edge expansion is the same as above.
+ */
+
+METHODDEF(void)
+h2v1_downsample_simd (j_compress_ptr cinfo, jpeg_component_info * compptr,
+		      JSAMPARRAY input_data, JSAMPARRAY output_data)
+{
+  my_downsample_ptr downsample = (my_downsample_ptr) cinfo->downsample;
+  int inrow;
+  JDIMENSION output_cols = compptr->width_in_blocks * compptr->DCT_h_scaled_size;
+
+  expand_right_edge(input_data, cinfo->max_v_samp_factor,
+		    cinfo->image_width, output_cols * 2);
+
+  for (inrow = 0; inrow < cinfo->max_v_samp_factor; inrow++)
+    (*downsample->simd->h2v1_downsample) (input_data + inrow,
+					  output_data[inrow], output_cols);
+}
+
+
+METHODDEF(void)
+h2v2_downsample_simd (j_compress_ptr cinfo, jpeg_component_info * compptr,
+		      JSAMPARRAY input_data, JSAMPARRAY output_data)
+{
+  my_downsample_ptr downsample = (my_downsample_ptr) cinfo->downsample;
+  int inrow, outrow;
+  JDIMENSION output_cols = compptr->width_in_blocks * compptr->DCT_h_scaled_size;
+
+  expand_right_edge(input_data, cinfo->max_v_samp_factor,
+		    cinfo->image_width, output_cols * 2);
+
+  for (inrow = outrow = 0; inrow < cinfo->max_v_samp_factor;
+       inrow += 2, outrow++)
+    (*downsample->simd->h2v2_downsample) (input_data + inrow,
+					  output_data[outrow], output_cols);
+}
+
+
+#ifdef INPUT_SMOOTHING_SUPPORTED
+
+METHODDEF(void)
+h2v2_smooth_downsample_simd (j_compress_ptr cinfo,
+			     jpeg_component_info * compptr,
+			     JSAMPARRAY input_data, JSAMPARRAY output_data)
+{
+  my_downsample_ptr downsample = (my_downsample_ptr) cinfo->downsample;
+  int inrow, outrow;
+  JDIMENSION output_cols = compptr->width_in_blocks * compptr->DCT_h_scaled_size;
+
+  /* Expand input data enough to let all the output samples be generated
+   * by the standard loop.  Special-casing padded output would be more
+   * efficient.
+   */
+  expand_right_edge(input_data - 1, cinfo->max_v_samp_factor + 2,
+		    cinfo->image_width, output_cols * 2);
+
+  for (inrow = outrow = 0; inrow < cinfo->max_v_samp_factor;
+       inrow += 2, outrow++)
+    (*downsample->simd->h2v2_smooth_downsample) (input_data + inrow,
+						 output_data[outrow],
+						 output_cols,
+						 cinfo->smoothing_factor);
+}
+
+#endif /* INPUT_SMOOTHING_SUPPORTED */
+
+
 /*
  * Module initialization routine for downsampling.
  * Note that we must select a routine for each component.
@@ -494,6 +568,8 @@ jinit_downsampler (j_compress_ptr cinfo)
   if (cinfo->CCIR601_sampling)
     ERREXIT(cinfo, JERR_CCIR601_NOTIMPL);
 
+  downsample->simd = jsimd_methods();
+
   /* Verify we can handle the sampling factors, and set up method pointers */
   for (ci = 0, compptr = cinfo->comp_info; ci < cinfo->num_components;
        ci++, compptr++) {
@@ -519,15 +595,23 @@ jinit_downsampler (j_compress_ptr cinfo)
 	       v_in_group == v_out_group) {
       smoothok = FALSE;
       downsample->methods[ci] = h2v1_downsample;
+      if (downsample->simd->h2v1_downsample != NULL)
+	downsample->methods[ci] = h2v1_downsample_simd;
     } else if (h_in_group == h_out_group * 2 &&
 	       v_in_group == v_out_group * 2) {
 #ifdef INPUT_SMOOTHING_SUPPORTED
       if (cinfo->smoothing_factor) {
 	downsample->methods[ci] = h2v2_smooth_downsample;
+	if (downsample->simd->h2v2_smooth_downsample != NULL)
+	  downsample->methods[ci] = h2v2_smooth_downsample_simd;
 	downsample->pub.need_context_rows = TRUE;
       } else
 #endif
+      {
 	downsample->methods[ci] = h2v2_downsample;
+	if (downsample->simd->h2v2_downsample != NULL)
+	  downsample->methods[ci] = h2v2_downsample_simd;
+      }
     } else if ((h_in_group % h_out_group) == 0 &&
 	       (v_in_group % v_out_group) == 0) {
       smoothok = FALSE;
@@ -12,6 +12,7 @@
 #define JPEG_INTERNALS
 #include "jinclude.h"
 #include "jpeglib.h"
+#include "jsimd.h"
 
 
 #if RANGE_BITS < 2
@@ -35,6 +36,9 @@ typedef struct {
   INT32 * R_y_tab;		/* => table for R to Y conversion */
   INT32 * G_y_tab;		/* => table for G to Y conversion */
   INT32 * B_y_tab;		/* => table for B to Y conversion */
+
+  /* SIMD row methods, or NULL entries for the C code */
+  const struct jsimd_methods * simd;
 } my_color_deconverter;
 
 typedef my_color_deconverter * my_cconvert_ptr;
@@ -228,6 +232,28 @@ ycc_rgb_convert (j_decompress_ptr cinfo,
 }
 
 
+/*
+ * Same as above for normal YCbCr, using the SIMD row method of jsimd.c.
+ * The tables are not needed for this.
+ */
+
+METHODDEF(void)
+ycc_rgb_convert_simd (j_decompress_ptr cinfo,
+		      JSAMPIMAGE input_buf, JDIMENSION input_row,
+		      JSAMPARRAY output_buf, int num_rows)
+{
+  my_cconvert_ptr cconvert = (my_cconvert_ptr) cinfo->cconvert;
+
+  while (--num_rows >= 0) {
+    (*cconvert->simd->ycc_rgb_convert) (input_buf[0][input_row],
+					input_buf[1][input_row],
+					input_buf[2][input_row],
+					*output_buf++, cinfo->output_width);
+    input_row++;
+  }
+}
+
+
 /**************** Cases other than YCC -> RGB ****************/
 
 
@@ -611,6 +637,7 @@ jinit_color_deconverter (j_decompress_ptr cinfo)
     ((j_common_ptr) cinfo, JPOOL_IMAGE, SIZEOF(my_color_deconverter));
   cinfo->cconvert = &cconvert->pub;
   cconvert->pub.start_pass = start_pass_dcolor;
+  cconvert->simd = jsimd_methods();
 
   /* Make sure num_components agrees with jpeg_color_space */
   switch (cinfo->jpeg_color_space) {
@@ -686,8 +713,12 @@ jinit_color_deconverter (j_decompress_ptr cinfo)
       cconvert->pub.color_convert = gray_rgb_convert;
       break;
     case JCS_YCbCr:
-      cconvert->pub.color_convert = ycc_rgb_convert;
-      build_ycc_rgb_table(cinfo);
+      if (cconvert->simd->ycc_rgb_convert != NULL)
+	cconvert->pub.color_convert = ycc_rgb_convert_simd;
+      else {
+	cconvert->pub.color_convert = ycc_rgb_convert;
+	build_ycc_rgb_table(cinfo);
+      }
       break;
     case JCS_BG_YCC:
       cconvert->pub.color_convert = ycc_rgb_convert;
@@ -20,6 +20,7 @@
 #include "jinclude.h"
 #include "jpeglib.h"
 #include "jdct.h"		/* Private declarations for DCT subsystem */
+#include "jsimd.h"
 
 
 /*
@@ -50,6 +51,9 @@ typedef struct {
    * per-component comp_info structures.
    */
   int cur_method[MAX_COMPONENTS];
+
+  /* SIMD methods, or NULL entries for the C code */
+  const struct jsimd_methods * simd;
 } my_idct_controller;
 
 typedef my_idct_controller * my_idct_ptr;
@@ -231,6 +235,8 @@ start_pass (j_decompress_ptr cinfo)
 #ifdef DCT_ISLOW_SUPPORTED
       case JDCT_ISLOW:
 	method_ptr = jpeg_idct_islow;
+	if (idct->simd->idct_islow != NULL)
+	  method_ptr = idct->simd->idct_islow;
 	method = JDCT_ISLOW;
 	break;
 #endif
@@ -370,6 +376,7 @@ jinit_inverse_dct (j_decompress_ptr cinfo)
 				SIZEOF(my_idct_controller));
   cinfo->idct = &idct->pub;
   idct->pub.start_pass = start_pass;
+  idct->simd = jsimd_methods();
 
   for (ci = 0, compptr = cinfo->comp_info; ci < cinfo->num_components;
        ci++, compptr++) {
@@ -22,6 +22,7 @@
 #define JPEG_INTERNALS
 #include "jinclude.h"
 #include "jpeglib.h"
+#include "jsimd.h"
 
 
 /* Pointer to routine to upsample a single component */
@@ -57,6 +58,9 @@ typedef struct {
    */
   UINT8 h_expand[MAX_COMPONENTS];
   UINT8 v_expand[MAX_COMPONENTS];
+
+  /* SIMD row methods, or NULL entries for the C code */
+  const struct jsimd_methods * simd;
 } my_upsampler;
 
 typedef my_upsampler * my_upsample_ptr;
@@ -272,6 +276,43 @@ h2v2_upsample (j_decompress_ptr cinfo, jpeg_component_info * compptr,
 }
 
 
+/*
+ * Versions of the 2h1v and 2h2v upsamplers that use the SIMD row method
+ * of jsimd.c; the row duplication of 2h2v is the same as above.
+ */
+
+METHODDEF(void)
+h2v1_upsample_simd (j_decompress_ptr cinfo, jpeg_component_info * compptr,
+		    JSAMPARRAY input_data, JSAMPIMAGE output_data_ptr)
+{
+  my_upsample_ptr upsample = (my_upsample_ptr) cinfo->upsample;
+  JSAMPARRAY output_data = *output_data_ptr;
+  int outrow;
+
+  for (outrow = 0; outrow < cinfo->max_v_samp_factor; outrow++)
+    (*upsample->simd->h2_upsample) (input_data[outrow], output_data[outrow],
+				    cinfo->output_width);
+}
+
+
+METHODDEF(void)
+h2v2_upsample_simd (j_decompress_ptr cinfo, jpeg_component_info * compptr,
+		    JSAMPARRAY input_data, JSAMPIMAGE output_data_ptr)
+{
+  my_upsample_ptr upsample = (my_upsample_ptr) cinfo->upsample;
+  JSAMPARRAY output_data, output_end;
+
+  output_data = *output_data_ptr;
+  output_end = output_data + cinfo->max_v_samp_factor;
+  for (; output_data < output_end; output_data += 2) {
+    (*upsample->simd->h2_upsample) (*input_data++, *output_data,
+				    cinfo->output_width);
+    jcopy_sample_rows(output_data, output_data + 1,
+		      1, cinfo->output_width);
+  }
+}
+
+
 /*
  * Module initialization routine for upsampling.
  */
@@ -290,6 +331,7 @@ jinit_upsampler (j_decompress_ptr cinfo)
   upsample->pub.start_pass = start_pass_upsample;
   upsample->pub.upsample = sep_upsample;
   upsample->pub.need_context_rows = FALSE; /* until we find out differently */
+  upsample->simd = jsimd_methods();
 
   if (cinfo->CCIR601_sampling)	/* this isn't supported */
     ERREXIT(cinfo, JERR_CCIR601_NOTIMPL);
@@ -320,10 +362,14 @@ jinit_upsampler (j_decompress_ptr cinfo)
     if (h_in_group * 2 == h_out_group && v_in_group == v_out_group) {
       /* Special case for 2h1v upsampling */
       upsample->methods[ci] = h2v1_upsample;
+      if (upsample->simd->h2_upsample != NULL)
+	upsample->methods[ci] = h2v1_upsample_simd;
     } else if (h_in_group * 2 == h_out_group &&
 	       v_in_group * 2 == v_out_group) {
       /* Special case for 2h2v upsampling */
       upsample->methods[ci] = h2v2_upsample;
+      if (upsample->simd->h2_upsample != NULL)
+	upsample->methods[ci] = h2v2_upsample_simd;
     } else if ((h_out_group % h_in_group) == 0 &&
 	       (v_out_group % v_in_group) == 0) {
       /* Generic integral-factors upsampling method */
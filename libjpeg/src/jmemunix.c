@@ -0,0 +1,248 @@
+/*
+ * jmemunix.c
+ *
+ * This file is part of the Independent JPEG Group's software.
+ * For conditions of distribution and use, see the accompanying README file.
+ *
+ * This file provides the system-dependent portion of the JPEG memory
+ * manager for Linux and other POSIX systems.  Memory comes from malloc(),
+ * as in jmemnobs.c; in addition, when max_memory_to_use is set and a
+ * big image does not fit in it, the virtual arrays are swapped out to
+ * temporary files.
+ *
+ * The temporary files are created in the directory named by the TMPDIR
+ * environment variable, or else in TEMP_DIRECTORY.  On Linux they are
+ * opened with O_TMPFILE, so they never have a name; elsewhere the file is
+ * unlinked right after mkstemp() has created it.  Either way, the space is
+ * given back when the file is closed, even if the process dies.
+ *
+ * The default is /var/tmp rather than /tmp, since /tmp is often a tmpfs,
+ * and pages of a tmpfs (like those of a memfd) would count against the
+ * same memory as the arrays they are meant to relieve.
+ *
+ * jpeg_mem_init returns 0, so that there is no memory limit and no
+ * temporary file unless the application (or the JPEGMEM environment
+ * variable, see jmemmgr.c) sets max_memory_to_use.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE		/* for O_TMPFILE in <fcntl.h> */
+#endif
+
+#define JPEG_INTERNALS
+#include "jinclude.h"
+#include "jpeglib.h"
+#include "jmemsys.h"		/* import the system-dependent declarations */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifndef HAVE_STDLIB_H		/* <stdlib.h> should declare malloc(),free() */
+extern void * malloc JPP((size_t size));
+extern void free JPP((void *ptr));
+#endif
+
+#ifndef NO_GETENV
+#ifndef HAVE_STDLIB_H		/* <stdlib.h> should declare getenv() */
+extern char * getenv JPP((const char * name));
+#endif
+#endif
+
+#ifndef TEMP_DIRECTORY		/* can override from jconfig.h or Makefile */
+#define TEMP_DIRECTORY  "/var/tmp"
+#endif
+
+#ifndef O_CLOEXEC
+#define O_CLOEXEC  0
+#endif
+
+
+/*
+ * Memory allocation and freeing are controlled by the regular library
+ * routines malloc() and free().
+ */
+
+GLOBAL(void *)
+jpeg_get_small (j_common_ptr cinfo, size_t sizeofobject)
+{
+  return (void *) malloc(sizeofobject);
+}
+
+GLOBAL(void)
+jpeg_free_small (j_common_ptr cinfo, void * object, size_t sizeofobject)
+{
+  free(object);
+}
+
+
+/*
+ * "Large" objects are treated the same as "small" ones.
+ */
+
+GLOBAL(void FAR *)
+jpeg_get_large (j_common_ptr cinfo, size_t sizeofobject)
+{
+  return (void FAR *) malloc(sizeofobject);
+}
+
+GLOBAL(void)
+jpeg_free_large (j_common_ptr cinfo, void FAR * object, size_t sizeofobject)
+{
+  free(object);
+}
+
+
+/*
+ * This routine computes the total memory space available for allocation.
+ * Whatever is above max_memory_to_use goes to the backing store.
+ */
+
+GLOBAL(long)
+jpeg_mem_available (j_common_ptr cinfo, long min_bytes_needed,
+		    long max_bytes_needed, long already_allocated)
+{
+  if (cinfo->mem->max_memory_to_use)
+    return cinfo->mem->max_memory_to_use - already_allocated;
+
+  /* No limit: everything stays in memory */
+  return max_bytes_needed;
+}
+
+
+/*
+ * Backing store (temporary file) management.
+ * The file is accessed with pread() and pwrite() on its descriptor;
+ * temp_file holds the stdio stream only to keep jmemsys.h unchanged.
+ * Both calls may transfer less than asked, or be interrupted by a signal.
+ */
+
+METHODDEF(void)
+read_file_store (j_common_ptr cinfo, backing_store_ptr info,
+		 void FAR * buffer_address,
+		 long file_offset, long byte_count)
+{
+  int fd = fileno(info->temp_file);
+  char * ptr = (char *) buffer_address;
+  ssize_t nbytes;
+
+  while (byte_count > 0) {
+    nbytes = pread(fd, ptr, (size_t) byte_count, (off_t) file_offset);
+    if (nbytes < 0 && errno == EINTR)
+      continue;
+    if (nbytes <= 0)
+      ERREXIT(cinfo, JERR_TFILE_READ);
+    ptr += nbytes;
+    file_offset += (long) nbytes;
+    byte_count -= (long) nbytes;
+  }
+}
+
+
+METHODDEF(void)
+write_file_store (j_common_ptr cinfo, backing_store_ptr info,
+		  void FAR * buffer_address,
+		  long file_offset, long byte_count)
+{
+  int fd = fileno(info->temp_file);
+  const char * ptr = (const char *) buffer_address;
+  ssize_t nbytes;
+
+  while (byte_count > 0) {
+    nbytes = pwrite(fd, ptr, (size_t) byte_count, (off_t) file_offset);
+    if (nbytes < 0 && errno == EINTR)
+      continue;
+    if (nbytes <= 0)
+      ERREXIT(cinfo, JERR_TFILE_WRITE);
+    ptr += nbytes;
+    file_offset += (long) nbytes;
+    byte_count -= (long) nbytes;
+  }
+}
+
+
+METHODDEF(void)
+close_file_store (j_common_ptr cinfo, backing_store_ptr info)
+{
+  fclose(info->temp_file);	/* the file goes away with its last descriptor */
+  TRACEMSS(cinfo, 1, JTRC_TFILE_CLOSE, info->temp_name);
+}
+
+
+/*
+ * Create an anonymous temporary file; returns its descriptor, or -1.
+ * temp_name receives a name for the trace and error messages.
+ */
+
+LOCAL(int)
+open_temp_file (char * temp_name)
+{
+  const char * dir = NULL;
+  int fd;
+
+#ifndef NO_GETENV
+  dir = getenv("TMPDIR");
+#endif
+  /* Leave room for the file name part within TEMP_NAME_LENGTH */
+  if (dir == NULL || dir[0] == '\0' ||
+      strlen(dir) + 11 >= (size_t) TEMP_NAME_LENGTH)
+    dir = TEMP_DIRECTORY;
+
+#ifdef O_TMPFILE
+  fd = open(dir, O_TMPFILE | O_RDWR | O_EXCL | O_CLOEXEC, 0600);
+  if (fd >= 0) {
+    sprintf(temp_name, "%s/(tmpfile)", dir);
+    return fd;
+  }
+  /* else the file system does not support it: fall back to mkstemp() */
+#endif
+
+  sprintf(temp_name, "%s/JPGXXXXXX", dir);
+  fd = mkstemp(temp_name);
+  if (fd >= 0) {
+    unlink(temp_name);
+    (void) fcntl(fd, F_SETFD, FD_CLOEXEC);
+  }
+  return fd;
+}
+
+
+/*
+ * Initial opening of a backing-store object.
+ */
+
+GLOBAL(void)
+jpeg_open_backing_store (j_common_ptr cinfo, backing_store_ptr info,
+			 long total_bytes_needed)
+{
+  int fd;
+
+  if ((fd = open_temp_file(info->temp_name)) < 0)
+    ERREXITS(cinfo, JERR_TFILE_CREATE, info->temp_name);
+  if ((info->temp_file = fdopen(fd, "w+b")) == NULL) {
+    close(fd);
+    ERREXITS(cinfo, JERR_TFILE_CREATE, info->temp_name);
+  }
+  info->read_backing_store = read_file_store;
+  info->write_backing_store = write_file_store;
+  info->close_backing_store = close_file_store;
+  TRACEMSS(cinfo, 1, JTRC_TFILE_OPEN, info->temp_name);
+}
+
+
+/*
+ * These routines take care of any system-dependent initialization and
+ * cleanup required.  Here, there isn't any.
+ */
+
+GLOBAL(long)
+jpeg_mem_init (j_common_ptr cinfo)
+{
+  return 0;			/* just set max_memory_to_use to 0 */
+}
+
+GLOBAL(void)
+jpeg_mem_term (j_common_ptr cinfo)
+{
+  /* no work */
+}
@@ -0,0 +1,265 @@
+/*
+ * jsimd.c
+ *
+ * This file is part of the Independent JPEG Group's software.
+ * For conditions of distribution and use, see the accompanying README file.
+ *
+ * This file contains the run-time SIMD dispatcher: CPU feature detection,
+ * the method tables of the instruction set levels, and the level controls
+ * jpeg_simd_level() and jpeg_simd_force().
+ *
+ * The CPU is examined once, on the first call of any entry point here,
+ * and the method tables are filled in at the same time.  The environment
+ * variables JSIMD_FORCENONE, JSIMD_FORCESSE2 and JSIMD_FORCEAVX2, when set
+ * to 1, give the initial cap of the level; jpeg_simd_force() replaces the
+ * cap later on.  Modules take their methods from the table when they are
+ * initialized, so a new level applies to the objects started afterwards.
+ */
+
+#define JPEG_INTERNALS
+#include "jinclude.h"
+#include "jpeglib.h"
+#include "jsimd.h"
+
+#ifdef JSIMD_X86_SUPPORTED
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#ifndef NO_GETENV
+#ifndef HAVE_STDLIB_H		/* <stdlib.h> should declare getenv() */
+extern char * getenv JPP((const char * name));
+#endif
+#endif
+
+
+/*
+ * The first callers may come from several threads at once.  One of them
+ * claims the initialization, the others wait until it is complete; after
+ * that, the tables and the detected level are only read.
+ */
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ATOMIC_LOAD(var)	__atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+#define ATOMIC_STORE(var,val)	__atomic_store_n(&(var), (val), __ATOMIC_RELEASE)
+#define ATOMIC_CLAIM(var)	__sync_bool_compare_and_swap(&(var), 0L, 1L)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+/* Volatile accesses have acquire/release semantics with MSVC */
+#define ATOMIC_LOAD(var)	(var)
+#define ATOMIC_STORE(var,val)	((var) = (val))
+#define ATOMIC_CLAIM(var)	(_InterlockedCompareExchange(&(var), 1L, 0L) == 0L)
+#else
+/* No atomic operations: the first call must not race with other ones */
+#define ATOMIC_LOAD(var)	(var)
+#define ATOMIC_STORE(var,val)	((var) = (val))
+#define ATOMIC_CLAIM(var)	((var) == 0L ? ((var) = 1L, TRUE) : FALSE)
+#endif
+
+#define SIMD_UNINIT	0L	/* values of simd_state */
+#define SIMD_BUSY	1L
+#define SIMD_READY	2L
+
+static volatile long simd_state = SIMD_UNINIT;
+static volatile long simd_cap = JSIMD_AVX512;	/* level cap */
+static int simd_detected = JSIMD_NONE;		/* highest level of the CPU */
+
+static struct jsimd_methods simd_tables[JSIMD_AVX512 + 1];
+
+
+#ifdef JSIMD_X86_SUPPORTED
+
+LOCAL(void)
+simd_cpuid (unsigned int leaf, unsigned int regs[4])
+{
+#ifdef _MSC_VER
+  int r[4];
+
+  __cpuidex(r, (int) leaf, 0);
+  regs[0] = (unsigned int) r[0]; regs[1] = (unsigned int) r[1];
+  regs[2] = (unsigned int) r[2]; regs[3] = (unsigned int) r[3];
+#else
+  __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+
+/* Which register states the operating system saves (XCR0) */
+
+LOCAL(unsigned int)
+simd_xgetbv (void)
+{
+#ifdef _MSC_VER
+  return (unsigned int) _xgetbv(0);
+#else
+  unsigned int eax, edx;
+
+  /* xgetbv, spelled out for assemblers that do not know it */
+  __asm__ __volatile__ (".byte 0x0f, 0x01, 0xd0"
+			: "=a" (eax), "=d" (edx) : "c" (0));
+  return eax;
+#endif
+}
+
+#endif /* JSIMD_X86_SUPPORTED */
+
+
+/*
+ * Find the highest level that both the CPU and the operating system
+ * support.  The AVX2 methods also use SSSE3 and SSE4.1 instructions.
+ */
+
+LOCAL(int)
+simd_detect (void)
+{
+#ifdef JSIMD_X86_SUPPORTED
+  unsigned int regs[4];
+  unsigned int max_leaf, xcr0;
+
+#ifdef _MSC_VER
+  simd_cpuid(0, regs);
+  max_leaf = regs[0];
+#else
+  max_leaf = __get_cpuid_max(0, NULL);	/* 0 if there is no cpuid */
+#endif
+  if (max_leaf < 1)
+    return JSIMD_NONE;
+
+  simd_cpuid(1, regs);
+  if ((regs[3] & (1U << 26)) == 0)	/* SSE2 */
+    return JSIMD_NONE;
+  if (max_leaf < 7 ||
+      (regs[2] & (1U << 9)) == 0 ||	/* SSSE3 */
+      (regs[2] & (1U << 19)) == 0 ||	/* SSE4.1 */
+      (regs[2] & (1U << 27)) == 0 ||	/* OSXSAVE */
+      (regs[2] & (1U << 28)) == 0)	/* AVX */
+    return JSIMD_SSE2;
+  xcr0 = simd_xgetbv();
+  if ((xcr0 & 0x06) != 0x06)		/* XMM and YMM state */
+    return JSIMD_SSE2;
+
+  simd_cpuid(7, regs);
+  if ((regs[1] & (1U << 5)) == 0)	/* AVX2 */
+    return JSIMD_SSE2;
+  if ((regs[1] & (1U << 16)) == 0 ||	/* AVX-512 F */
+      (regs[1] & (1U << 30)) == 0 ||	/* AVX-512 BW */
+      (xcr0 & 0xE0) != 0xE0)		/* opmask and ZMM state */
+    return JSIMD_AVX2;
+  return JSIMD_AVX512;
+#else
+  return JSIMD_NONE;
+#endif
+}
+
+
+/*
+ * Initial level cap from the environment.
+ */
+
+LOCAL(long)
+simd_env_cap (void)
+{
+#ifndef NO_GETENV
+  static const struct {
+    const char * name;
+    long level;
+  } simd_env[] = {
+    { "JSIMD_FORCENONE", JSIMD_NONE },
+    { "JSIMD_FORCESSE2", JSIMD_SSE2 },
+    { "JSIMD_FORCEAVX2", JSIMD_AVX2 }
+  };
+  const char * env;
+  int i;
+
+  for (i = 0; i < (int) (SIZEOF(simd_env) / SIZEOF(simd_env[0])); i++) {
+    if ((env = getenv(simd_env[i].name)) != NULL && env[0] == '1')
+      return simd_env[i].level;
+  }
+#endif
+  return JSIMD_AVX512;
+}
+
+
+/*
+ * Detect the CPU and fill in the method tables, once.
+ * Each level starts from the methods of the level below.
+ */
+
+LOCAL(void)
+simd_init (void)
+{
+  if (ATOMIC_LOAD(simd_state) == SIMD_READY)
+    return;
+
+  if (! ATOMIC_CLAIM(simd_state)) {
+    while (ATOMIC_LOAD(simd_state) != SIMD_READY)
+      ;				/* another thread is at it */
+    return;
+  }
+
+  MEMZERO(&simd_tables[JSIMD_NONE], SIZEOF(struct jsimd_methods));
+#ifdef JSIMD_X86_SUPPORTED
+  simd_tables[JSIMD_SSE2] = simd_tables[JSIMD_NONE];
+  jsimd_fill_sse2(&simd_tables[JSIMD_SSE2]);
+  simd_tables[JSIMD_AVX2] = simd_tables[JSIMD_SSE2];
+  jsimd_fill_avx2(&simd_tables[JSIMD_AVX2]);
+  simd_tables[JSIMD_AVX512] = simd_tables[JSIMD_AVX2];
+  jsimd_fill_avx512(&simd_tables[JSIMD_AVX512]);
+#else
+  simd_tables[JSIMD_SSE2] = simd_tables[JSIMD_NONE];
+  simd_tables[JSIMD_AVX2] = simd_tables[JSIMD_NONE];
+  simd_tables[JSIMD_AVX512] = simd_tables[JSIMD_NONE];
+#endif
+
+  simd_detected = simd_detect();
+  ATOMIC_STORE(simd_cap, simd_env_cap());
+  ATOMIC_STORE(simd_state, SIMD_READY);
+}
+
+
+/*
+ * Level used for objects initialized from now on.
+ */
+
+GLOBAL(int)
+jpeg_simd_level (void)
+{
+  long cap;
+
+  simd_init();
+  cap = ATOMIC_LOAD(simd_cap);
+  return (cap < (long) simd_detected) ? (int) cap : simd_detected;
+}
+
+
+/*
+ * Cap the level: JSIMD_NONE forces the C code, JSIMD_AVX512 (or any higher
+ * value) allows everything the CPU has.  Returns the resulting level,
+ * which may be lower than requested.
+ */
+
+GLOBAL(int)
+jpeg_simd_force (int level)
+{
+  simd_init();
+  if (level < JSIMD_NONE)
+    level = JSIMD_NONE;
+  if (level > JSIMD_AVX512)
+    level = JSIMD_AVX512;
+  ATOMIC_STORE(simd_cap, (long) level);
+  return jpeg_simd_level();
+}
+
+
+/*
+ * Method table of the current level.
+ */
+
+GLOBAL(const struct jsimd_methods *)
+jsimd_methods (void)
+{
+  return &simd_tables[jpeg_simd_level()];
+}
@@ -0,0 +1,70 @@
+/*
+ * jsimd512.c
+ *
+ * This file is part of the Independent JPEG Group's software.
+ * For conditions of distribution and use, see the accompanying README file.
+ *
+ * This file contains the AVX-512 methods of the SIMD dispatcher (jsimd.c).
+ * The AVX-512 level starts from the AVX2 methods; the only one replaced
+ * here is the zigzag scan of the Huffman encoder, where two-source word
+ * permutes do the whole reordering of a block in registers.
+ */
+
+#define JPEG_INTERNALS
+#include "jinclude.h"
+#include "jpeglib.h"
+#include "jsimd.h"
+
+#ifdef JSIMD_X86_SUPPORTED
+
+#include <immintrin.h>
+
+#define AVX512			JSIMD_TARGET("avx512f,avx512bw")
+
+
+/*
+ * Zigzag scan: coef[k] = block[jpeg_natural_order[k]].  The permute index
+ * selects from the 64 words of the two source vectors, as the natural
+ * order table does; the test instruction then gives the nonzero bitmap.
+ */
+
+static const short zigzag_index[DCTSIZE2] = {
+   0,  1,  8, 16,  9,  2,  3, 10,
+  17, 24, 32, 25, 18, 11,  4,  5,
+  12, 19, 26, 33, 40, 48, 41, 34,
+  27, 20, 13,  6,  7, 14, 21, 28,
+  35, 42, 49, 56, 57, 50, 43, 36,
+  29, 22, 15, 23, 30, 37, 44, 51,
+  58, 59, 52, 45, 38, 31, 39, 46,
+  53, 60, 61, 54, 47, 55, 62, 63
+};
+
+AVX512 METHODDEF(jsimd_bitmap)
+avx512_huff_zigzag (JCOEFPTR block, JCOEFPTR coef)
+{
+  __m512i lo = _mm512_loadu_si512((const void *) block);
+  __m512i hi = _mm512_loadu_si512((const void *) (block + 32));
+  __m512i zz0, zz1;
+
+  zz0 = _mm512_permutex2var_epi16(lo,
+	  _mm512_loadu_si512((const void *) zigzag_index), hi);
+  zz1 = _mm512_permutex2var_epi16(lo,
+	  _mm512_loadu_si512((const void *) (zigzag_index + 32)), hi);
+  _mm512_storeu_si512((void *) coef, zz0);
+  _mm512_storeu_si512((void *) (coef + 32), zz1);
+
+  return (jsimd_bitmap) _mm512_test_epi16_mask(zz0, zz0) |
+	 ((jsimd_bitmap) _mm512_test_epi16_mask(zz1, zz1) << 32);
+}
+
+
+GLOBAL(void)
+jsimd_fill_avx512 (struct jsimd_methods * methods)
+{
+#if DCTSIZE2 == 64
+  if (SIZEOF(JCOEF) == 2)		/* loaded as 16-bit lanes */
+    methods->huff_zigzag = avx512_huff_zigzag;
+#endif
+}
+
+#endif /* JSIMD_X86_SUPPORTED */
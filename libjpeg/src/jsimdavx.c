@@ -0,0 +1,696 @@
+/*
+ * jsimdavx.c
+ *
+ * This file is part of the Independent JPEG Group's software.
+ * For conditions of distribution and use, see the accompanying README file.
+ *
+ * This file contains the AVX2 methods of the SIMD dispatcher (jsimd.c):
+ * the RGB <=> YCbCr color conversions of jccolor.c and jdcolor.c, the 2:1
+ * downsamplers and upsampler, and the accurate integer forward and
+ * inverse DCTs of jfdctint.c and jidctint.c.  The AVX2 level starts from
+ * the SSE2 methods, so anything not done here stays with jsimdsse.c.
+ *
+ * All methods give exactly the same results as the C code.  The color
+ * conversions evaluate the same fixed-point sums as the lookup tables of
+ * jccolor.c and jdcolor.c, split into 16-bit factors for _mm256_madd_epi16;
+ * the DCTs follow jfdctint.c and jidctint.c step by step in 32-bit lanes.
+ */
+
+#define JPEG_INTERNALS
+#include "jinclude.h"
+#include "jpeglib.h"
+#include "jdct.h"		/* Private declarations for DCT subsystem */
+#include "jsimd.h"
+
+#ifdef JSIMD_X86_SUPPORTED
+
+#include <immintrin.h>
+
+#define AVX2			JSIMD_TARGET("avx2")
+
+/* The color conversions handle the default pixel layout only */
+#if RGB_RED == 0 && RGB_GREEN == 1 && RGB_BLUE == 2 && RGB_PIXELSIZE == 3
+#define AVX2_RGB_SUPPORTED
+#endif
+
+/* Pair of 16-bit factors for _mm256_madd_epi16: lo * a + hi * b */
+#define PAIR16(a,b)	\
+  _mm256_set1_epi32((int) (((unsigned int) (b) << 16) | ((a) & 0xFFFF)))
+
+/* 16 samples of a 16-bit vector, saturated to bytes, in order */
+#define AVX2_PACK16(v)	\
+  _mm256_castsi256_si128(_mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), 0x08))
+
+
+#ifdef AVX2_RGB_SUPPORTED
+
+/*
+ * pshufb masks to split 16 RGB pixels (three 16-byte vectors) into planes
+ * and back.  rgb_split[c][i] picks the bytes of component c that are in
+ * input vector i; rgb_merge[i][c] places component c into output vector i.
+ */
+
+static const signed char rgb_split[3][3][16] = {
+  { { 0, 3, 6, 9, 12, 15, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128 },
+    { -128, -128, -128, -128, -128, -128, 2, 5, 8, 11, 14, -128, -128, -128, -128, -128 },
+    { -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 1, 4, 7, 10, 13 } },
+  { { 1, 4, 7, 10, 13, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128 },
+    { -128, -128, -128, -128, -128, 0, 3, 6, 9, 12, 15, -128, -128, -128, -128, -128 },
+    { -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 2, 5, 8, 11, 14 } },
+  { { 2, 5, 8, 11, 14, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128 },
+    { -128, -128, -128, -128, -128, 1, 4, 7, 10, 13, -128, -128, -128, -128, -128, -128 },
+    { -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, 0, 3, 6, 9, 12, 15 } }
+};
+
+static const signed char rgb_merge[3][3][16] = {
+  { { 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128, -128, 5 },
+    { -128, 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128, -128 },
+    { -128, -128, 0, -128, -128, 1, -128, -128, 2, -128, -128, 3, -128, -128, 4, -128 } },
+  { { -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128, 10, -128 },
+    { 5, -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128, 10 },
+    { -128, 5, -128, -128, 6, -128, -128, 7, -128, -128, 8, -128, -128, 9, -128, -128 } },
+  { { -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15, -128, -128 },
+    { -128, -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15, -128 },
+    { 10, -128, -128, 11, -128, -128, 12, -128, -128, 13, -128, -128, 14, -128, -128, 15 } }
+};
+
+#define MASK(tab)	_mm_loadu_si128((const __m128i *) (tab))
+
+
+/*
+ * RGB => YCbCr, as rgb_ycc_convert in jccolor.c:
+ *	Y  = ( 19595 * R + 38470 * G +  7471 * B + ONE_HALF) >> 16
+ *	Cb = (-11058 * R - 21710 * G + 32768 * B + CBCR_OFFSET + ONE_HALF-1) >> 16
+ *	Cr = ( 32768 * R - 27439 * G -  5329 * B + CBCR_OFFSET + ONE_HALF-1) >> 16
+ * Factors that do not fit in 16 bits are split over two products.
+ */
+
+#define Y_R	19595		/* FIX(0.299) */
+#define Y_G	38470		/* FIX(0.587) */
+#define Y_B	7471		/* FIX(0.114) */
+#define CB_R	(-11058)	/* -FIX(0.168735892) */
+#define CB_G	(-21710)	/* -FIX(0.331264108) */
+#define CR_G	(-27439)	/* -FIX(0.418687589) */
+#define CR_B	(-5329)		/* -FIX(0.081312411) */
+#define CBCR_ROUND	((128L << 16) + 32767L)
+
+/* Y, Cb and Cr of 8 pixels in 32-bit lanes, from the 16-bit pairs
+ * rg = (R,G), bg = (B,G) and bb = (B,B), rr = (R,R), gb = (G,B)
+ */
+#define AVX2_RGB_YCC(y, cb, cr, rg, bg, rr, bb, gb)  \
+  y = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(  \
+	_mm256_madd_epi16(rg, PAIR16(Y_R, Y_G - 16384)),  \
+	_mm256_madd_epi16(bg, PAIR16(Y_B, 16384))), vhalf), 16);  \
+  cb = _mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(  \
+	 _mm256_madd_epi16(rg, PAIR16(CB_R, CB_G)),  \
+	 _mm256_madd_epi16(bb, PAIR16(16384, 16384))), vcbcr), 16);  \
+  cr = _mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(  \
+	 _mm256_madd_epi16(rr, PAIR16(16384, 16384)),  \
+	 _mm256_madd_epi16(gb, PAIR16(CR_G, CR_B))), vcbcr), 16);
+
+AVX2 METHODDEF(void)
+avx2_rgb_ycc_convert (JSAMPROW inptr, JSAMPROW outptr0, JSAMPROW outptr1,
+		      JSAMPROW outptr2, JDIMENSION num_cols)
+{
+  register int r, g, b;
+  JDIMENSION col;
+  __m256i vhalf = _mm256_set1_epi32(32768);
+  __m256i vcbcr = _mm256_set1_epi32((int) CBCR_ROUND);
+  __m256i r16, g16, b16, rg, bg, rr, bb, gb;
+  __m256i ylo, yhi, cblo, cbhi, crlo, crhi;
+  __m128i in0, in1, in2;
+
+  for (col = 0; col + 16 <= num_cols; col += 16) {
+    in0 = _mm_loadu_si128((const __m128i *) inptr);
+    in1 = _mm_loadu_si128((const __m128i *) (inptr + 16));
+    in2 = _mm_loadu_si128((const __m128i *) (inptr + 32));
+    r16 = _mm256_cvtepu8_epi16(_mm_or_si128(_mm_or_si128(
+	    _mm_shuffle_epi8(in0, MASK(rgb_split[0][0])),
+	    _mm_shuffle_epi8(in1, MASK(rgb_split[0][1]))),
+	    _mm_shuffle_epi8(in2, MASK(rgb_split[0][2]))));
+    g16 = _mm256_cvtepu8_epi16(_mm_or_si128(_mm_or_si128(
+	    _mm_shuffle_epi8(in0, MASK(rgb_split[1][0])),
+	    _mm_shuffle_epi8(in1, MASK(rgb_split[1][1]))),
+	    _mm_shuffle_epi8(in2, MASK(rgb_split[1][2]))));
+    b16 = _mm256_cvtepu8_epi16(_mm_or_si128(_mm_or_si128(
+	    _mm_shuffle_epi8(in0, MASK(rgb_split[2][0])),
+	    _mm_shuffle_epi8(in1, MASK(rgb_split[2][1]))),
+	    _mm_shuffle_epi8(in2, MASK(rgb_split[2][2]))));
+    inptr += 48;
+
+    /* The unpacks and the final packs both work within 128-bit lanes,
+     * so the pixel order comes out right.
+     */
+    rg = _mm256_unpacklo_epi16(r16, g16);
+    bg = _mm256_unpacklo_epi16(b16, g16);
+    rr = _mm256_unpacklo_epi16(r16, r16);
+    bb = _mm256_unpacklo_epi16(b16, b16);
+    gb = _mm256_unpacklo_epi16(g16, b16);
+    AVX2_RGB_YCC(ylo, cblo, crlo, rg, bg, rr, bb, gb)
+    rg = _mm256_unpackhi_epi16(r16, g16);
+    bg = _mm256_unpackhi_epi16(b16, g16);
+    rr = _mm256_unpackhi_epi16(r16, r16);
+    bb = _mm256_unpackhi_epi16(b16, b16);
+    gb = _mm256_unpackhi_epi16(g16, b16);
+    AVX2_RGB_YCC(yhi, cbhi, crhi, rg, bg, rr, bb, gb)
+
+    _mm_storeu_si128((__m128i *) (outptr0 + col),
+		     AVX2_PACK16(_mm256_packs_epi32(ylo, yhi)));
+    _mm_storeu_si128((__m128i *) (outptr1 + col),
+		     AVX2_PACK16(_mm256_packs_epi32(cblo, cbhi)));
+    _mm_storeu_si128((__m128i *) (outptr2 + col),
+		     AVX2_PACK16(_mm256_packs_epi32(crlo, crhi)));
+  }
+
+  for (; col < num_cols; col++) {
+    r = GETJSAMPLE(inptr[RGB_RED]);
+    g = GETJSAMPLE(inptr[RGB_GREEN]);
+    b = GETJSAMPLE(inptr[RGB_BLUE]);
+    inptr += RGB_PIXELSIZE;
+    outptr0[col] = (JSAMPLE) ((Y_R * r + Y_G * g + Y_B * b + 32768L) >> 16);
+    outptr1[col] = (JSAMPLE) ((CB_R * r + CB_G * g + 32768L * b
+			       + CBCR_ROUND) >> 16);
+    outptr2[col] = (JSAMPLE) ((32768L * r + CR_G * g + CR_B * b
+			       + CBCR_ROUND) >> 16);
+  }
+}
+
+
+/*
+ * YCbCr => RGB, as ycc_rgb_convert in jdcolor.c.  With x = Cb or Cr
+ * minus CENTERJSAMPLE, the table entries are
+ *	Cr_r_tab = (91881 * x + ONE_HALF) >> 16
+ *		 = x + ((26345 * x + ONE_HALF) >> 16)
+ *	Cb_b_tab = (116130 * x + ONE_HALF) >> 16
+ *		 = 2*x + ((-14942 * x + ONE_HALF) >> 16)
+ *	Cb_g_tab + Cr_g_tab = -22553 * cbx - 46802 * crx + ONE_HALF
+ *		 = -65536 * crx + (-22553 * cbx + 18734 * crx + ONE_HALF)
+ * and the range limiting is a clamp to 0..MAXJSAMPLE.
+ */
+
+#define R_CR	26345		/* FIX(1.402) - 65536 */
+#define B_CB	(-14942)	/* FIX(1.772) - 2*65536 */
+#define G_CB	(-22553)	/* -FIX(0.344136286) */
+#define G_CR	18734		/* 65536 - FIX(0.714136286) */
+
+AVX2 METHODDEF(void)
+avx2_ycc_rgb_convert (JSAMPROW inptr0, JSAMPROW inptr1, JSAMPROW inptr2,
+		      JSAMPROW outptr, JDIMENSION num_cols)
+{
+  register int y, cbx, crx, v;
+  JDIMENSION col;
+  __m256i vcenter = _mm256_set1_epi16(CENTERJSAMPLE);
+  __m256i vtwo = _mm256_set1_epi16(2);
+  __m256i vhalf = _mm256_set1_epi32(32768);
+  __m256i y16, cb16, cr16, lo, hi, r16, g16, b16;
+  __m128i r8, g8, b8;
+
+  for (col = 0; col + 16 <= num_cols; col += 16) {
+    y16 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (inptr0 + col)));
+    cb16 = _mm256_sub_epi16(_mm256_cvtepu8_epi16(
+	     _mm_loadu_si128((const __m128i *) (inptr1 + col))), vcenter);
+    cr16 = _mm256_sub_epi16(_mm256_cvtepu8_epi16(
+	     _mm_loadu_si128((const __m128i *) (inptr2 + col))), vcenter);
+
+    /* (x, 2) * (factor, 16384) adds ONE_HALF in the same step */
+    lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(cr16, vtwo), PAIR16(R_CR, 16384));
+    hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(cr16, vtwo), PAIR16(R_CR, 16384));
+    r16 = _mm256_packs_epi32(_mm256_srai_epi32(lo, 16), _mm256_srai_epi32(hi, 16));
+    r16 = _mm256_add_epi16(_mm256_add_epi16(y16, cr16), r16);
+
+    lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(cb16, vtwo), PAIR16(B_CB, 16384));
+    hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(cb16, vtwo), PAIR16(B_CB, 16384));
+    b16 = _mm256_packs_epi32(_mm256_srai_epi32(lo, 16), _mm256_srai_epi32(hi, 16));
+    b16 = _mm256_add_epi16(_mm256_add_epi16(y16, _mm256_add_epi16(cb16, cb16)),
+			   b16);
+
+    lo = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(cb16, cr16),
+					    PAIR16(G_CB, G_CR)), vhalf);
+    hi = _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(cb16, cr16),
+					    PAIR16(G_CB, G_CR)), vhalf);
+    g16 = _mm256_packs_epi32(_mm256_srai_epi32(lo, 16), _mm256_srai_epi32(hi, 16));
+    g16 = _mm256_add_epi16(_mm256_sub_epi16(y16, cr16), g16);
+
+    r8 = AVX2_PACK16(r16);
+    g8 = AVX2_PACK16(g16);
+    b8 = AVX2_PACK16(b16);
+    _mm_storeu_si128((__m128i *) outptr, _mm_or_si128(_mm_or_si128(
+		     _mm_shuffle_epi8(r8, MASK(rgb_merge[0][0])),
+		     _mm_shuffle_epi8(g8, MASK(rgb_merge[0][1]))),
+		     _mm_shuffle_epi8(b8, MASK(rgb_merge[0][2]))));
+    _mm_storeu_si128((__m128i *) (outptr + 16), _mm_or_si128(_mm_or_si128(
+		     _mm_shuffle_epi8(r8, MASK(rgb_merge[1][0])),
+		     _mm_shuffle_epi8(g8, MASK(rgb_merge[1][1]))),
+		     _mm_shuffle_epi8(b8, MASK(rgb_merge[1][2]))));
+    _mm_storeu_si128((__m128i *) (outptr + 32), _mm_or_si128(_mm_or_si128(
+		     _mm_shuffle_epi8(r8, MASK(rgb_merge[2][0])),
+		     _mm_shuffle_epi8(g8, MASK(rgb_merge[2][1]))),
+		     _mm_shuffle_epi8(b8, MASK(rgb_merge[2][2]))));
+    outptr += 48;
+  }
+
+  for (; col < num_cols; col++) {
+    y = GETJSAMPLE(inptr0[col]);
+    cbx = GETJSAMPLE(inptr1[col]) - CENTERJSAMPLE;
+    crx = GETJSAMPLE(inptr2[col]) - CENTERJSAMPLE;
+    v = y + crx + (int) ((R_CR * (INT32) crx + 32768L) >> 16);
+    outptr[RGB_RED] = (JSAMPLE) (v < 0 ? 0 : v > MAXJSAMPLE ? MAXJSAMPLE : v);
+    v = y - crx + (int) ((G_CB * (INT32) cbx + G_CR * (INT32) crx
+			  + 32768L) >> 16);
+    outptr[RGB_GREEN] = (JSAMPLE) (v < 0 ? 0 : v > MAXJSAMPLE ? MAXJSAMPLE : v);
+    v = y + 2 * cbx + (int) ((B_CB * (INT32) cbx + 32768L) >> 16);
+    outptr[RGB_BLUE] = (JSAMPLE) (v < 0 ? 0 : v > MAXJSAMPLE ? MAXJSAMPLE : v);
+    outptr += RGB_PIXELSIZE;
+  }
+}
+
+#endif /* AVX2_RGB_SUPPORTED */
+
+
+/*
+ * 2:1 downsamplers, 32 output samples per step; see jsimdsse.c.
+ * _mm256_packus_epi16 packs within 128-bit lanes, so the quadwords
+ * are put back in order afterwards.
+ */
+
+#define AVX2_EVEN(v, mask)  _mm256_and_si256(v, mask)
+#define AVX2_ODD(v)         _mm256_srli_epi16(v, 8)
+
+AVX2 METHODDEF(void)
+avx2_h2v1_downsample (JSAMPARRAY input_data, JSAMPROW outptr,
+		      JDIMENSION output_cols)
+{
+  register JSAMPROW inptr = input_data[0];
+  register int bias;
+  JDIMENSION outcol;
+  __m256i mask = _mm256_set1_epi16(0x00FF);
+  __m256i vbias = _mm256_set1_epi32(0x00010000);	/* 0,1,0,1,... */
+  __m256i in0, in1, sum0, sum1;
+
+  for (outcol = 0; outcol + 32 <= output_cols; outcol += 32) {
+    in0 = _mm256_loadu_si256((const __m256i *) inptr);
+    in1 = _mm256_loadu_si256((const __m256i *) (inptr + 32));
+    sum0 = _mm256_add_epi16(_mm256_add_epi16(AVX2_EVEN(in0, mask),
+					     AVX2_ODD(in0)), vbias);
+    sum1 = _mm256_add_epi16(_mm256_add_epi16(AVX2_EVEN(in1, mask),
+					     AVX2_ODD(in1)), vbias);
+    sum0 = _mm256_srli_epi16(sum0, 1);
+    sum1 = _mm256_srli_epi16(sum1, 1);
+    _mm256_storeu_si256((__m256i *) outptr, _mm256_permute4x64_epi64(
+			_mm256_packus_epi16(sum0, sum1), 0xD8));
+    inptr += 64; outptr += 32;
+  }
+  bias = 0;			/* outcol is even here */
+  for (; outcol < output_cols; outcol++) {
+    *outptr++ = (JSAMPLE) ((GETJSAMPLE(*inptr) + GETJSAMPLE(inptr[1])
+			    + bias) >> 1);
+    bias ^= 1;
+    inptr += 2;
+  }
+}
+
+
+AVX2 METHODDEF(void)
+avx2_h2v2_downsample (JSAMPARRAY input_data, JSAMPROW outptr,
+		      JDIMENSION output_cols)
+{
+  register JSAMPROW inptr0 = input_data[0];
+  register JSAMPROW inptr1 = input_data[1];
+  register int bias;
+  JDIMENSION outcol;
+  __m256i mask = _mm256_set1_epi16(0x00FF);
+  __m256i vbias = _mm256_set1_epi32(0x00020001);	/* 1,2,1,2,... */
+  __m256i a0, a1, b0, b1, sum0, sum1;
+
+  for (outcol = 0; outcol + 32 <= output_cols; outcol += 32) {
+    a0 = _mm256_loadu_si256((const __m256i *) inptr0);
+    a1 = _mm256_loadu_si256((const __m256i *) (inptr0 + 32));
+    b0 = _mm256_loadu_si256((const __m256i *) inptr1);
+    b1 = _mm256_loadu_si256((const __m256i *) (inptr1 + 32));
+    sum0 = _mm256_add_epi16(
+	     _mm256_add_epi16(AVX2_EVEN(a0, mask), AVX2_ODD(a0)),
+	     _mm256_add_epi16(AVX2_EVEN(b0, mask), AVX2_ODD(b0)));
+    sum1 = _mm256_add_epi16(
+	     _mm256_add_epi16(AVX2_EVEN(a1, mask), AVX2_ODD(a1)),
+	     _mm256_add_epi16(AVX2_EVEN(b1, mask), AVX2_ODD(b1)));
+    sum0 = _mm256_srli_epi16(_mm256_add_epi16(sum0, vbias), 2);
+    sum1 = _mm256_srli_epi16(_mm256_add_epi16(sum1, vbias), 2);
+    _mm256_storeu_si256((__m256i *) outptr, _mm256_permute4x64_epi64(
+			_mm256_packus_epi16(sum0, sum1), 0xD8));
+    inptr0 += 64; inptr1 += 64; outptr += 32;
+  }
+  bias = 1;			/* outcol is even here */
+  for (; outcol < output_cols; outcol++) {
+    *outptr++ = (JSAMPLE) ((GETJSAMPLE(*inptr0) + GETJSAMPLE(inptr0[1]) +
+			    GETJSAMPLE(*inptr1) + GETJSAMPLE(inptr1[1])
+			    + bias) >> 2);
+    bias ^= 3;
+    inptr0 += 2; inptr1 += 2;
+  }
+}
+
+
+/*
+ * 2:1 horizontal upsampler: 16 samples are widened to 16 bits and each
+ * one copied into the high byte of its own lane.
+ */
+
+AVX2 METHODDEF(void)
+avx2_h2_upsample (JSAMPROW inptr, JSAMPROW outptr, JDIMENSION output_width)
+{
+  register JSAMPLE invalue;
+  JDIMENSION incol;
+  JDIMENSION input_cols = (output_width + 1) >> 1;
+  __m256i v0, v1;
+
+  for (incol = 0; incol + 32 <= input_cols; incol += 32) {
+    v0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) inptr));
+    v1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *) (inptr + 16)));
+    _mm256_storeu_si256((__m256i *) outptr,
+			_mm256_or_si256(v0, _mm256_slli_epi16(v0, 8)));
+    _mm256_storeu_si256((__m256i *) (outptr + 32),
+			_mm256_or_si256(v1, _mm256_slli_epi16(v1, 8)));
+    inptr += 32; outptr += 64;
+  }
+  for (; incol < input_cols; incol++) {
+    invalue = *inptr++;		/* don't need GETJSAMPLE() here */
+    *outptr++ = invalue;
+    *outptr++ = invalue;
+  }
+}
+
+
+/*
+ * Accurate integer DCTs.  A block is held in eight vectors of 32-bit
+ * lanes, one row per vector; a pass over the columns works on the rows
+ * directly, and a pass over the rows works on the transposed block.
+ * The arithmetic is that of jfdctint.c and jidctint.c; since the products
+ * are formed with 32-bit wraparound just like the C code's, even the
+ * results for out-of-range input match.
+ */
+
+#define CONST_BITS  13
+#define PASS1_BITS  2
+
+#define FIX_0_298631336  2446		/* FIX(0.298631336) */
+#define FIX_0_390180644  3196		/* FIX(0.390180644) */
+#define FIX_0_541196100  4433		/* FIX(0.541196100) */
+#define FIX_0_765366865  6270		/* FIX(0.765366865) */
+#define FIX_0_899976223  7373		/* FIX(0.899976223) */
+#define FIX_1_175875602  9633		/* FIX(1.175875602) */
+#define FIX_1_501321110  12299		/* FIX(1.501321110) */
+#define FIX_1_847759065  15137		/* FIX(1.847759065) */
+#define FIX_1_961570560  16069		/* FIX(1.961570560) */
+#define FIX_2_053119869  16819		/* FIX(2.053119869) */
+#define FIX_2_562915447  20995		/* FIX(2.562915447) */
+#define FIX_3_072711026  25172		/* FIX(3.072711026) */
+
+#define ADD(a,b)	_mm256_add_epi32(a, b)
+#define SUB(a,b)	_mm256_sub_epi32(a, b)
+#define MUL(a,c)	_mm256_mullo_epi32(a, _mm256_set1_epi32(c))
+#define SHIFT(a,n)	_mm256_sra_epi32(a, n)
+
+
+AVX2 LOCAL(void)
+avx2_transpose (__m256i v[DCTSIZE])
+{
+  __m256i t0, t1, t2, t3, t4, t5, t6, t7;
+  __m256i u0, u1, u2, u3, u4, u5, u6, u7;
+
+  t0 = _mm256_unpacklo_epi32(v[0], v[1]);
+  t1 = _mm256_unpackhi_epi32(v[0], v[1]);
+  t2 = _mm256_unpacklo_epi32(v[2], v[3]);
+  t3 = _mm256_unpackhi_epi32(v[2], v[3]);
+  t4 = _mm256_unpacklo_epi32(v[4], v[5]);
+  t5 = _mm256_unpackhi_epi32(v[4], v[5]);
+  t6 = _mm256_unpacklo_epi32(v[6], v[7]);
+  t7 = _mm256_unpackhi_epi32(v[6], v[7]);
+
+  u0 = _mm256_unpacklo_epi64(t0, t2);
+  u1 = _mm256_unpackhi_epi64(t0, t2);
+  u2 = _mm256_unpacklo_epi64(t1, t3);
+  u3 = _mm256_unpackhi_epi64(t1, t3);
+  u4 = _mm256_unpacklo_epi64(t4, t6);
+  u5 = _mm256_unpackhi_epi64(t4, t6);
+  u6 = _mm256_unpacklo_epi64(t5, t7);
+  u7 = _mm256_unpackhi_epi64(t5, t7);
+
+  v[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+  v[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+  v[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+  v[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+  v[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+  v[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+  v[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+  v[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+
+/*
+ * One pass of jpeg_fdct_islow; v[k] holds input k of eight 1-D DCTs.
+ * The first pass also does the unsigned->signed conversion.
+ */
+
+AVX2 LOCAL(void)
+avx2_fdct_pass (__m256i v[DCTSIZE], boolean first_pass)
+{
+  __m256i tmp0, tmp1, tmp2, tmp3, tmp10, tmp11, tmp12, tmp13, z1, round;
+  __m128i shift;
+
+  if (first_pass) {
+    round = _mm256_set1_epi32(1 << (CONST_BITS-PASS1_BITS-1));
+    shift = _mm_cvtsi32_si128(CONST_BITS-PASS1_BITS);
+  } else {
+    round = _mm256_set1_epi32(1 << (CONST_BITS+PASS1_BITS-1));
+    shift = _mm_cvtsi32_si128(CONST_BITS+PASS1_BITS);
+  }
+
+  /* Even part */
+
+  tmp0 = ADD(v[0], v[7]);
+  tmp1 = ADD(v[1], v[6]);
+  tmp2 = ADD(v[2], v[5]);
+  tmp3 = ADD(v[3], v[4]);
+
+  tmp10 = ADD(tmp0, tmp3);
+  tmp12 = SUB(tmp0, tmp3);
+  tmp11 = ADD(tmp1, tmp2);
+  tmp13 = SUB(tmp1, tmp2);
+
+  tmp0 = SUB(v[0], v[7]);
+  tmp1 = SUB(v[1], v[6]);
+  tmp2 = SUB(v[2], v[5]);
+  tmp3 = SUB(v[3], v[4]);
+
+  if (first_pass) {
+    /* Apply unsigned->signed conversion. */
+    v[0] = _mm256_slli_epi32(SUB(ADD(tmp10, tmp11),
+				 _mm256_set1_epi32(8 * CENTERJSAMPLE)),
+			     PASS1_BITS);
+    v[4] = _mm256_slli_epi32(SUB(tmp10, tmp11), PASS1_BITS);
+  } else {
+    /* Add fudge factor here for final descale. */
+    tmp10 = ADD(tmp10, _mm256_set1_epi32(1 << (PASS1_BITS-1)));
+    v[0] = _mm256_srai_epi32(ADD(tmp10, tmp11), PASS1_BITS);
+    v[4] = _mm256_srai_epi32(SUB(tmp10, tmp11), PASS1_BITS);
+  }
+
+  z1 = ADD(MUL(ADD(tmp12, tmp13), FIX_0_541196100), round);
+  v[2] = SHIFT(ADD(z1, MUL(tmp12, FIX_0_765366865)), shift);
+  v[6] = SHIFT(SUB(z1, MUL(tmp13, FIX_1_847759065)), shift);
+
+  /* Odd part */
+
+  tmp12 = ADD(tmp0, tmp2);
+  tmp13 = ADD(tmp1, tmp3);
+
+  z1 = ADD(MUL(ADD(tmp12, tmp13), FIX_1_175875602), round);
+  tmp12 = ADD(MUL(tmp12, - FIX_0_390180644), z1);
+  tmp13 = ADD(MUL(tmp13, - FIX_1_961570560), z1);
+
+  z1 = MUL(ADD(tmp0, tmp3), - FIX_0_899976223);
+  tmp0 = ADD(MUL(tmp0, FIX_1_501321110), ADD(z1, tmp12));
+  tmp3 = ADD(MUL(tmp3, FIX_0_298631336), ADD(z1, tmp13));
+
+  z1 = MUL(ADD(tmp1, tmp2), - FIX_2_562915447);
+  tmp1 = ADD(MUL(tmp1, FIX_3_072711026), ADD(z1, tmp13));
+  tmp2 = ADD(MUL(tmp2, FIX_2_053119869), ADD(z1, tmp12));
+
+  v[1] = SHIFT(tmp0, shift);
+  v[3] = SHIFT(tmp1, shift);
+  v[5] = SHIFT(tmp2, shift);
+  v[7] = SHIFT(tmp3, shift);
+}
+
+
+AVX2 METHODDEF(void)
+avx2_fdct_islow (jsimd_dctelem * data, JSAMPARRAY sample_data,
+		 JDIMENSION start_col)
+{
+  __m256i v[DCTSIZE];
+  int ctr;
+
+  /* Pass 1 processes rows: load them as columns of the transposed block */
+  for (ctr = 0; ctr < DCTSIZE; ctr++)
+    v[ctr] = _mm256_cvtepu8_epi32(
+	       _mm_loadl_epi64((const __m128i *) (sample_data[ctr] + start_col)));
+  avx2_transpose(v);
+  avx2_fdct_pass(v, TRUE);
+
+  /* Pass 2 processes columns */
+  avx2_transpose(v);
+  avx2_fdct_pass(v, FALSE);
+
+  for (ctr = 0; ctr < DCTSIZE; ctr++)
+    _mm256_storeu_si256((__m256i *) (data + DCTSIZE * ctr), v[ctr]);
+}
+
+
+/*
+ * One pass of jpeg_idct_islow, v[k] being input k of eight 1-D IDCTs.
+ * round is the descale fudge factor (plus the range center in the second
+ * pass), shifted up by CONST_BITS as it is added to the scaled DC term.
+ */
+
+AVX2 LOCAL(void)
+avx2_idct_pass (__m256i v[DCTSIZE], __m256i round, __m128i shift)
+{
+  __m256i tmp0, tmp1, tmp2, tmp3, tmp10, tmp11, tmp12, tmp13, z1, z2, z3;
+
+  /* Even part */
+
+  tmp0 = ADD(_mm256_slli_epi32(ADD(v[0], v[4]), CONST_BITS), round);
+  tmp1 = ADD(_mm256_slli_epi32(SUB(v[0], v[4]), CONST_BITS), round);
+
+  z1 = MUL(ADD(v[2], v[6]), FIX_0_541196100);
+  tmp2 = ADD(z1, MUL(v[2], FIX_0_765366865));
+  tmp3 = SUB(z1, MUL(v[6], FIX_1_847759065));
+
+  tmp10 = ADD(tmp0, tmp2);
+  tmp13 = SUB(tmp0, tmp2);
+  tmp11 = ADD(tmp1, tmp3);
+  tmp12 = SUB(tmp1, tmp3);
+
+  /* Odd part */
+
+  tmp0 = v[7];
+  tmp1 = v[5];
+  tmp2 = v[3];
+  tmp3 = v[1];
+
+  z2 = ADD(tmp0, tmp2);
+  z3 = ADD(tmp1, tmp3);
+
+  z1 = MUL(ADD(z2, z3), FIX_1_175875602);
+  z2 = ADD(MUL(z2, - FIX_1_961570560), z1);
+  z3 = ADD(MUL(z3, - FIX_0_390180644), z1);
+
+  z1 = MUL(ADD(tmp0, tmp3), - FIX_0_899976223);
+  tmp0 = ADD(MUL(tmp0, FIX_0_298631336), ADD(z1, z2));
+  tmp3 = ADD(MUL(tmp3, FIX_1_501321110), ADD(z1, z3));
+
+  z1 = MUL(ADD(tmp1, tmp2), - FIX_2_562915447);
+  tmp1 = ADD(MUL(tmp1, FIX_2_053119869), ADD(z1, z3));
+  tmp2 = ADD(MUL(tmp2, FIX_3_072711026), ADD(z1, z2));
+
+  /* Final output stage */
+
+  v[0] = SHIFT(ADD(tmp10, tmp3), shift);
+  v[7] = SHIFT(SUB(tmp10, tmp3), shift);
+  v[1] = SHIFT(ADD(tmp11, tmp2), shift);
+  v[6] = SHIFT(SUB(tmp11, tmp2), shift);
+  v[2] = SHIFT(ADD(tmp12, tmp1), shift);
+  v[5] = SHIFT(SUB(tmp12, tmp1), shift);
+  v[3] = SHIFT(ADD(tmp13, tmp0), shift);
+  v[4] = SHIFT(SUB(tmp13, tmp0), shift);
+}
+
+
+/*
+ * The C code skips the column pass for columns whose AC terms are all
+ * zero, and outputs DC << PASS1_BITS; this is done here with a blend, as
+ * the full computation differs when the scaled DC term overflows.  The
+ * zero row test of the second pass needs no such care: the full
+ * computation of an all-zero row gives the same low bits, which are all
+ * that remain after the RANGE_MASK.
+ */
+
+AVX2 METHODDEF(void)
+avx2_idct_islow (j_decompress_ptr cinfo, jpeg_component_info * compptr,
+		 JCOEFPTR coef_block,
+		 JSAMPARRAY output_buf, JDIMENSION output_col)
+{
+  ISLOW_MULT_TYPE * quantptr = (ISLOW_MULT_TYPE *) compptr->dct_table;
+  __m256i v[DCTSIZE];
+  __m256i ac, dc, a, b;
+  __m128i lo, hi;
+  int ctr;
+
+  /* Pass 1: process columns from input */
+  ac = _mm256_setzero_si256();
+  for (ctr = 0; ctr < DCTSIZE; ctr++) {
+    a = _mm256_cvtepi16_epi32(
+	  _mm_loadu_si128((const __m128i *) (coef_block + DCTSIZE * ctr)));
+    if (ctr > 0)
+      ac = _mm256_or_si256(ac, a);
+    v[ctr] = _mm256_mullo_epi32(a,
+	       _mm256_loadu_si256((const __m256i *) (quantptr + DCTSIZE * ctr)));
+  }
+  dc = _mm256_slli_epi32(v[0], PASS1_BITS);
+  ac = _mm256_cmpeq_epi32(ac, _mm256_setzero_si256());
+
+  avx2_idct_pass(v, _mm256_set1_epi32(1 << (CONST_BITS-PASS1_BITS-1)),
+		 _mm_cvtsi32_si128(CONST_BITS-PASS1_BITS));
+  for (ctr = 0; ctr < DCTSIZE; ctr++)
+    v[ctr] = _mm256_blendv_epi8(v[ctr], dc, ac);
+
+  /* Pass 2: process rows */
+  avx2_transpose(v);
+  avx2_idct_pass(v, _mm256_set1_epi32(((RANGE_CENTER << (PASS1_BITS+3)) +
+				       (1 << (PASS1_BITS+2))) << CONST_BITS),
+		 _mm_cvtsi32_si128(CONST_BITS+PASS1_BITS+3));
+  avx2_transpose(v);
+
+  /* range_limit[x & RANGE_MASK] is MAX(0, MIN(MAXJSAMPLE,
+   * (x & RANGE_MASK) - RANGE_SUBSET)); the packs saturate.
+   */
+  for (ctr = 0; ctr < DCTSIZE; ctr++)
+    v[ctr] = _mm256_sub_epi32(
+	       _mm256_and_si256(v[ctr], _mm256_set1_epi32(RANGE_MASK)),
+	       _mm256_set1_epi32(RANGE_SUBSET));
+  for (ctr = 0; ctr < DCTSIZE; ctr += 4) {
+    a = _mm256_packs_epi32(v[ctr], v[ctr+1]);
+    b = _mm256_packs_epi32(v[ctr+2], v[ctr+3]);
+    /* Row halves come out as 0a 1a 2a 3a | 0b 1b 2b 3b */
+    a = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(a, b),
+				    _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+    lo = _mm256_castsi256_si128(a);
+    hi = _mm256_extracti128_si256(a, 1);
+    _mm_storel_epi64((__m128i *) (output_buf[ctr] + output_col), lo);
+    _mm_storel_epi64((__m128i *) (output_buf[ctr+1] + output_col),
+		     _mm_unpackhi_epi64(lo, lo));
+    _mm_storel_epi64((__m128i *) (output_buf[ctr+2] + output_col), hi);
+    _mm_storel_epi64((__m128i *) (output_buf[ctr+3] + output_col),
+		     _mm_unpackhi_epi64(hi, hi));
+  }
+}
+
+
+GLOBAL(void)
+jsimd_fill_avx2 (struct jsimd_methods * methods)
+{
+#ifdef AVX2_RGB_SUPPORTED
+  methods->rgb_ycc_convert = avx2_rgb_ycc_convert;
+  methods->ycc_rgb_convert = avx2_ycc_rgb_convert;
+#endif
+  methods->h2v1_downsample = avx2_h2v1_downsample;
+  methods->h2v2_downsample = avx2_h2v2_downsample;
+  methods->h2_upsample = avx2_h2_upsample;
+#if DCTSIZE == 8
+  methods->fdct_islow = avx2_fdct_islow;
+  if (SIZEOF(ISLOW_MULT_TYPE) == 4)	/* loaded as 32-bit lanes */
+    methods->idct_islow = avx2_idct_islow;
+#endif
+}
+
+#endif /* JSIMD_X86_SUPPORTED */
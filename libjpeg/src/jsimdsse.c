@@ -0,0 +1,302 @@
+/*
+ * jsimdsse.c
+ *
+ * This file is part of the Independent JPEG Group's software.
+ * For conditions of distribution and use, see the accompanying README file.
+ *
+ * This file contains the SSE2 methods of the SIMD dispatcher (jsimd.c):
+ * the 2:1 downsamplers of jcsample.c, the 2:1 horizontal upsampler of
+ * jdsample.c, and the zigzag scan of the sequential Huffman encoder.
+ *
+ * These produce exactly the same output as the C code they replace.
+ * Samples left over after the last full vector step are done with scalar
+ * code, so the methods never read or write beyond the row widths given.
+ */
+
+#define JPEG_INTERNALS
+#include "jinclude.h"
+#include "jpeglib.h"
+#include "jsimd.h"
+
+#ifdef JSIMD_X86_SUPPORTED
+
+#include <emmintrin.h>
+
+#define SSE2			JSIMD_TARGET("sse2")
+
+/* Even and odd samples of 16 input bytes, zero-extended to 16 bits */
+#define SSE2_EVEN(v, mask)  _mm_and_si128(v, mask)
+#define SSE2_ODD(v)         _mm_srli_epi16(v, 8)
+
+
+/*
+ * 2:1 downsamplers.
+ *
+ * Each vector step handles 8 output samples in 16-bit lanes, and since a
+ * step always starts at an even output column the alternating bias pattern
+ * is a constant per lane (0,1,0,1,... for h2v1 and 1,2,1,2,... for h2v2).
+ */
+
+SSE2 METHODDEF(void)
+sse2_h2v1_downsample (JSAMPARRAY input_data, JSAMPROW outptr,
+		      JDIMENSION output_cols)
+{
+  register JSAMPROW inptr = input_data[0];
+  register int bias;
+  JDIMENSION outcol;
+  __m128i mask = _mm_set1_epi16(0x00FF);
+  __m128i vbias = _mm_set1_epi32(0x00010000);	/* 0,1,0,1,... */
+  __m128i in0, in1, sum0, sum1;
+
+  for (outcol = 0; outcol + 16 <= output_cols; outcol += 16) {
+    in0 = _mm_loadu_si128((const __m128i *) inptr);
+    in1 = _mm_loadu_si128((const __m128i *) (inptr + 16));
+    sum0 = _mm_add_epi16(_mm_add_epi16(SSE2_EVEN(in0, mask), SSE2_ODD(in0)),
+			 vbias);
+    sum1 = _mm_add_epi16(_mm_add_epi16(SSE2_EVEN(in1, mask), SSE2_ODD(in1)),
+			 vbias);
+    sum0 = _mm_srli_epi16(sum0, 1);
+    sum1 = _mm_srli_epi16(sum1, 1);
+    _mm_storeu_si128((__m128i *) outptr, _mm_packus_epi16(sum0, sum1));
+    inptr += 32; outptr += 16;
+  }
+  bias = 0;			/* outcol is even here */
+  for (; outcol < output_cols; outcol++) {
+    *outptr++ = (JSAMPLE) ((GETJSAMPLE(*inptr) + GETJSAMPLE(inptr[1])
+			    + bias) >> 1);
+    bias ^= 1;
+    inptr += 2;
+  }
+}
+
+
+SSE2 METHODDEF(void)
+sse2_h2v2_downsample (JSAMPARRAY input_data, JSAMPROW outptr,
+		      JDIMENSION output_cols)
+{
+  register JSAMPROW inptr0 = input_data[0];
+  register JSAMPROW inptr1 = input_data[1];
+  register int bias;
+  JDIMENSION outcol;
+  __m128i mask = _mm_set1_epi16(0x00FF);
+  __m128i vbias = _mm_set1_epi32(0x00020001);	/* 1,2,1,2,... */
+  __m128i a0, a1, b0, b1, sum0, sum1;
+
+  for (outcol = 0; outcol + 16 <= output_cols; outcol += 16) {
+    a0 = _mm_loadu_si128((const __m128i *) inptr0);
+    a1 = _mm_loadu_si128((const __m128i *) (inptr0 + 16));
+    b0 = _mm_loadu_si128((const __m128i *) inptr1);
+    b1 = _mm_loadu_si128((const __m128i *) (inptr1 + 16));
+    sum0 = _mm_add_epi16(_mm_add_epi16(SSE2_EVEN(a0, mask), SSE2_ODD(a0)),
+			 _mm_add_epi16(SSE2_EVEN(b0, mask), SSE2_ODD(b0)));
+    sum1 = _mm_add_epi16(_mm_add_epi16(SSE2_EVEN(a1, mask), SSE2_ODD(a1)),
+			 _mm_add_epi16(SSE2_EVEN(b1, mask), SSE2_ODD(b1)));
+    sum0 = _mm_srli_epi16(_mm_add_epi16(sum0, vbias), 2);
+    sum1 = _mm_srli_epi16(_mm_add_epi16(sum1, vbias), 2);
+    _mm_storeu_si128((__m128i *) outptr, _mm_packus_epi16(sum0, sum1));
+    inptr0 += 32; inptr1 += 32; outptr += 16;
+  }
+  bias = 1;			/* outcol is even here */
+  for (; outcol < output_cols; outcol++) {
+    *outptr++ = (JSAMPLE) ((GETJSAMPLE(*inptr0) + GETJSAMPLE(inptr0[1]) +
+			    GETJSAMPLE(*inptr1) + GETJSAMPLE(inptr1[1])
+			    + bias) >> 2);
+    bias ^= 3;
+    inptr0 += 2; inptr1 += 2;
+  }
+}
+
+
+/*
+ * The smoothing downsampler keeps the C code for the first and the last
+ * output column (which need edge replication) and for the leftover
+ * columns; the interior is done 8 samples at a time.  membersum and
+ * neighsum fit in 16 bits, so _mm_madd_epi16 forms the exact 32-bit
+ * value membersum * memberscale + neighsum * neighscale.
+ */
+
+SSE2 METHODDEF(void)
+sse2_h2v2_smooth_downsample (JSAMPARRAY input_data, JSAMPROW outptr,
+			     JDIMENSION output_cols, int smoothing_factor)
+{
+  register JSAMPROW inptr0 = input_data[0];
+  register JSAMPROW inptr1 = input_data[1];
+  register JSAMPROW above_ptr = input_data[-1];
+  register JSAMPROW below_ptr = input_data[2];
+  JDIMENSION colctr;
+  INT32 membersum, neighsum, memberscale, neighscale;
+  __m128i mask = _mm_set1_epi16(0x00FF);
+  __m128i vround = _mm_set1_epi32(32768);
+  __m128i vscale, v0, v1, va, vb, member, edge, corner, lo, hi;
+
+  memberscale = 16384 - smoothing_factor * 80; /* scaled (1-5*SF)/4 */
+  neighscale = smoothing_factor * 16; /* scaled SF/4 */
+  vscale = _mm_set1_epi32((int) ((neighscale << 16) | memberscale));
+
+  /* Special case for first column: pretend column -1 is same as column 0 */
+  membersum = GETJSAMPLE(*inptr0) + GETJSAMPLE(inptr0[1]) +
+	      GETJSAMPLE(*inptr1) + GETJSAMPLE(inptr1[1]);
+  neighsum = GETJSAMPLE(*above_ptr) + GETJSAMPLE(above_ptr[1]) +
+	     GETJSAMPLE(*below_ptr) + GETJSAMPLE(below_ptr[1]) +
+	     GETJSAMPLE(*inptr0) + GETJSAMPLE(inptr0[2]) +
+	     GETJSAMPLE(*inptr1) + GETJSAMPLE(inptr1[2]);
+  neighsum += neighsum;
+  neighsum += GETJSAMPLE(*above_ptr) + GETJSAMPLE(above_ptr[2]) +
+	      GETJSAMPLE(*below_ptr) + GETJSAMPLE(below_ptr[2]);
+  membersum = membersum * memberscale + neighsum * neighscale;
+  *outptr++ = (JSAMPLE) ((membersum + 32768) >> 16);
+  inptr0 += 2; inptr1 += 2; above_ptr += 2; below_ptr += 2;
+
+  /* Interior columns, 8 at a time; the loads reach inptr[17] at most,
+   * which stays inside the edge-expanded row for all full steps.
+   */
+  for (colctr = output_cols - 2; colctr >= 8; colctr -= 8) {
+    /* members: in0[2k], in0[2k+1], in1[2k], in1[2k+1] */
+    v0 = _mm_loadu_si128((const __m128i *) inptr0);
+    v1 = _mm_loadu_si128((const __m128i *) inptr1);
+    member = _mm_add_epi16(_mm_add_epi16(SSE2_EVEN(v0, mask), SSE2_ODD(v0)),
+			   _mm_add_epi16(SSE2_EVEN(v1, mask), SSE2_ODD(v1)));
+    /* edge neighbors above and below the members */
+    va = _mm_loadu_si128((const __m128i *) above_ptr);
+    vb = _mm_loadu_si128((const __m128i *) below_ptr);
+    edge = _mm_add_epi16(_mm_add_epi16(SSE2_EVEN(va, mask), SSE2_ODD(va)),
+			 _mm_add_epi16(SSE2_EVEN(vb, mask), SSE2_ODD(vb)));
+    /* edge neighbors to the left (column 2k-1) and right (2k+2) */
+    v0 = _mm_loadu_si128((const __m128i *) (inptr0 - 1));
+    v1 = _mm_loadu_si128((const __m128i *) (inptr1 - 1));
+    edge = _mm_add_epi16(edge, _mm_add_epi16(SSE2_EVEN(v0, mask),
+					     SSE2_EVEN(v1, mask)));
+    v0 = _mm_loadu_si128((const __m128i *) (inptr0 + 2));
+    v1 = _mm_loadu_si128((const __m128i *) (inptr1 + 2));
+    edge = _mm_add_epi16(edge, _mm_add_epi16(SSE2_EVEN(v0, mask),
+					     SSE2_EVEN(v1, mask)));
+    /* The edge-neighbors count twice as much as corner-neighbors */
+    edge = _mm_add_epi16(edge, edge);
+    /* corner neighbors */
+    va = _mm_loadu_si128((const __m128i *) (above_ptr - 1));
+    vb = _mm_loadu_si128((const __m128i *) (below_ptr - 1));
+    corner = _mm_add_epi16(SSE2_EVEN(va, mask), SSE2_EVEN(vb, mask));
+    va = _mm_loadu_si128((const __m128i *) (above_ptr + 2));
+    vb = _mm_loadu_si128((const __m128i *) (below_ptr + 2));
+    corner = _mm_add_epi16(corner, _mm_add_epi16(SSE2_EVEN(va, mask),
+						 SSE2_EVEN(vb, mask)));
+    edge = _mm_add_epi16(edge, corner);
+    /* membersum * memberscale + neighsum * neighscale, rounded */
+    lo = _mm_madd_epi16(_mm_unpacklo_epi16(member, edge), vscale);
+    hi = _mm_madd_epi16(_mm_unpackhi_epi16(member, edge), vscale);
+    lo = _mm_srai_epi32(_mm_add_epi32(lo, vround), 16);
+    hi = _mm_srai_epi32(_mm_add_epi32(hi, vround), 16);
+    lo = _mm_packs_epi32(lo, hi);
+    _mm_storel_epi64((__m128i *) outptr, _mm_packus_epi16(lo, lo));
+    inptr0 += 16; inptr1 += 16; above_ptr += 16; below_ptr += 16;
+    outptr += 8;
+  }
+
+  for (; colctr > 0; colctr--) {
+    membersum = GETJSAMPLE(*inptr0) + GETJSAMPLE(inptr0[1]) +
+		GETJSAMPLE(*inptr1) + GETJSAMPLE(inptr1[1]);
+    neighsum = GETJSAMPLE(*above_ptr) + GETJSAMPLE(above_ptr[1]) +
+	       GETJSAMPLE(*below_ptr) + GETJSAMPLE(below_ptr[1]) +
+	       GETJSAMPLE(inptr0[-1]) + GETJSAMPLE(inptr0[2]) +
+	       GETJSAMPLE(inptr1[-1]) + GETJSAMPLE(inptr1[2]);
+    neighsum += neighsum;
+    neighsum += GETJSAMPLE(above_ptr[-1]) + GETJSAMPLE(above_ptr[2]) +
+		GETJSAMPLE(below_ptr[-1]) + GETJSAMPLE(below_ptr[2]);
+    membersum = membersum * memberscale + neighsum * neighscale;
+    *outptr++ = (JSAMPLE) ((membersum + 32768) >> 16);
+    inptr0 += 2; inptr1 += 2; above_ptr += 2; below_ptr += 2;
+  }
+
+  /* Special case for last column */
+  membersum = GETJSAMPLE(*inptr0) + GETJSAMPLE(inptr0[1]) +
+	      GETJSAMPLE(*inptr1) + GETJSAMPLE(inptr1[1]);
+  neighsum = GETJSAMPLE(*above_ptr) + GETJSAMPLE(above_ptr[1]) +
+	     GETJSAMPLE(*below_ptr) + GETJSAMPLE(below_ptr[1]) +
+	     GETJSAMPLE(inptr0[-1]) + GETJSAMPLE(inptr0[1]) +
+	     GETJSAMPLE(inptr1[-1]) + GETJSAMPLE(inptr1[1]);
+  neighsum += neighsum;
+  neighsum += GETJSAMPLE(above_ptr[-1]) + GETJSAMPLE(above_ptr[1]) +
+	      GETJSAMPLE(below_ptr[-1]) + GETJSAMPLE(below_ptr[1]);
+  membersum = membersum * memberscale + neighsum * neighscale;
+  *outptr = (JSAMPLE) ((membersum + 32768) >> 16);
+}
+
+
+/*
+ * 2:1 horizontal upsampler: each input sample is stored twice.
+ */
+
+SSE2 METHODDEF(void)
+sse2_h2_upsample (JSAMPROW inptr, JSAMPROW outptr, JDIMENSION output_width)
+{
+  register JSAMPLE invalue;
+  JDIMENSION incol;
+  JDIMENSION input_cols = (output_width + 1) >> 1;
+  __m128i v;
+
+  for (incol = 0; incol + 16 <= input_cols; incol += 16) {
+    v = _mm_loadu_si128((const __m128i *) inptr);
+    _mm_storeu_si128((__m128i *) outptr, _mm_unpacklo_epi8(v, v));
+    _mm_storeu_si128((__m128i *) (outptr + 16), _mm_unpackhi_epi8(v, v));
+    inptr += 16; outptr += 32;
+  }
+  for (; incol < input_cols; incol++) {
+    invalue = *inptr++;		/* don't need GETJSAMPLE() here */
+    *outptr++ = invalue;
+    *outptr++ = invalue;
+  }
+}
+
+
+/*
+ * Zigzag scan for the Huffman encoder.  The gather uses constant offsets
+ * (the order of jpeg_natural_order); the nonzero test is done 8
+ * coefficients at a time.
+ */
+
+#define ZZ8(k, a,b,c,d,e,f,g,h)  \
+  coef[k]   = block[a]; coef[k+1] = block[b]; coef[k+2] = block[c];  \
+  coef[k+3] = block[d]; coef[k+4] = block[e]; coef[k+5] = block[f];  \
+  coef[k+6] = block[g]; coef[k+7] = block[h];
+
+SSE2 METHODDEF(jsimd_bitmap)
+sse2_huff_zigzag (JCOEFPTR block, JCOEFPTR coef)
+{
+  __m128i zero = _mm_setzero_si128();
+  __m128i v0, v1;
+  unsigned int zeros[4];
+  int i;
+
+  ZZ8( 0,  0,  1,  8, 16,  9,  2,  3, 10)
+  ZZ8( 8, 17, 24, 32, 25, 18, 11,  4,  5)
+  ZZ8(16, 12, 19, 26, 33, 40, 48, 41, 34)
+  ZZ8(24, 27, 20, 13,  6,  7, 14, 21, 28)
+  ZZ8(32, 35, 42, 49, 56, 57, 50, 43, 36)
+  ZZ8(40, 29, 22, 15, 23, 30, 37, 44, 51)
+  ZZ8(48, 58, 59, 52, 45, 38, 31, 39, 46)
+  ZZ8(56, 53, 60, 61, 54, 47, 55, 62, 63)
+
+  for (i = 0; i < 4; i++) {
+    v0 = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i *) (coef + 16*i)),
+			 zero);
+    v1 = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i *) (coef + 16*i + 8)),
+			 zero);
+    zeros[i] = (unsigned int) _mm_movemask_epi8(_mm_packs_epi16(v0, v1));
+  }
+
+  return ~((jsimd_bitmap) zeros[0] | ((jsimd_bitmap) zeros[1] << 16) |
+	   ((jsimd_bitmap) zeros[2] << 32) | ((jsimd_bitmap) zeros[3] << 48));
+}
+
+
+GLOBAL(void)
+jsimd_fill_sse2 (struct jsimd_methods * methods)
+{
+  methods->h2v1_downsample = sse2_h2v1_downsample;
+  methods->h2v2_downsample = sse2_h2v2_downsample;
+  methods->h2v2_smooth_downsample = sse2_h2v2_smooth_downsample;
+  methods->h2_upsample = sse2_h2_upsample;
+  methods->huff_zigzag = sse2_huff_zigzag;
+}
+
+#endif /* JSIMD_X86_SUPPORTED */
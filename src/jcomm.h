@@ -172,8 +172,21 @@ typedef struct jpeg_info_t
     j_int_t   jit_imgh; ///< nominal image height
     j_int_t   jit_nchs; ///< # of color components in JPEG image
     jpeg_cs_t jcs_type; ///< colorspace of JPEG image ( @see jpeg_color_space_t )
+    j_size_t  jst_peak; ///< predicted peak memory of decoding, in bytes ( @see jdec_info() )
 } jpeg_info_t, * jinfo_ptr_t;
 
+/**
+ * @struct j_rect_t
+ * @brief  矩形区域（以像素为单位），多区域编码（jenc_crops()）与 无损变换 共用。
+ */
+typedef struct j_rect_t
+{
+    j_int_t jit_x; ///< X 坐标
+    j_int_t jit_y; ///< Y 坐标
+    j_int_t jit_w; ///< 宽度
+    j_int_t jit_h; ///< 高度
+} j_rect_t;
+
 ////////////////////////////////////////////////////////////////////////////////
 
 #endif // __JCOMM_H__
@@ -12,6 +12,9 @@
 #error "Please include jcomm.h before this file!"
 #endif // __JCOMM_H__
 
+#ifndef __JCOMM_INL__
+#define __JCOMM_INL__
+
 #include "jpeglib.h"
 #include <setjmp.h>
 
@@ -112,3 +115,5 @@ static inline j_uint_t jval_align(j_uint_t jut_val, j_uint_t jut_align)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+
+#endif // __JCOMM_INL__
@@ -10,23 +10,29 @@
 
 #include "jcomm.h"
 #include "jdecoder.h"
+#include "jthread.h"
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 
+#define JPEG_INTERNALS
 #include "jcomm.inl"
 
 ////////////////////////////////////////////////////////////////////////////////
 // JPEG 解码器 相关常量与数据类型
 
-/** 定义文件指针位置的 无效值 */
-#define JFS_INVALID_FPOS     ((j_fpos_t)-1)
-
 /** 定义 JPEG 解码操作的上下文 结构体类型标识 */
 #define JDEC_HANDLE_TYPE     0x4A504547
 
 /** 重定义 libjpeg 中的 JPEG 解码器结构体 名称 */
 typedef struct jpeg_decompress_struct  jdec_obj_t;
 
+/**
+ * 预测峰值内存时，libjpeg 各个小对象（模块结构体、查找表、Huffman 表、
+ * 数据源缓存、内存池的头部与余量 等）合计的 固定开销上限（字节）。
+ */
+#define JDEC_MPEAK_FIXED     (64 * 1024)
+
 /**
  * @struct jdec_ctx_t
  * @brief  JPEG 解码操作的上下文。
@@ -39,6 +45,7 @@ typedef struct jdec_ctx_t
     jdec_obj_t      jdec_obj;  ///< JPEG 解码器 操作结构体
 
     j_bool_t        jbl_work;  ///< JPEG 解码器是否处于工作状态
+    j_size_t        jst_mbud;  ///< 内存预算（字节，为 0 时 不作限制，参看 jdec_config_budget()）
 
     /**
      * @brief 解码输入源模式的相关工作参数。
@@ -46,6 +53,7 @@ typedef struct jdec_ctx_t
     struct
     {
         jctl_mode_t jct_mode;  ///< 输入模式
+        j_bool_t    jbl_spos;  ///< 文件流模式，jfp_spos 是否为有效的文件指针位置
 
         union
         {
@@ -122,6 +130,7 @@ static j_int_t jdec_load_mode(jdec_this_t jdec_this)
         }
         else
         {
+            jdec_this->jmode.jbl_spos = J_TRUE;
             jpeg_stdio_src(&jdec_this->jdec_obj, jdec_this->jmode.jfs_istr);
             jit_err = JDEC_ERR_OK;
         }
@@ -161,10 +170,10 @@ static j_void_t jdec_unload_mode(jdec_this_t jdec_this)
     if (JCTL_MODE_FSTREAM == jdec_this->jmode.jct_mode)
     {
         // 文件流模式时，重置文件指针位置
-        if (JFS_INVALID_FPOS != jdec_this->jmode.jfp_spos)
+        if (jdec_this->jmode.jbl_spos)
         {
             fsetpos(jdec_this->jmode.jfs_istr, &jdec_this->jmode.jfp_spos);
-            jdec_this->jmode.jfp_spos = JFS_INVALID_FPOS;
+            jdec_this->jmode.jbl_spos = J_FALSE;
         }
     }
     else if (JCTL_MODE_FSZPATH == jdec_this->jmode.jct_mode)
@@ -211,6 +220,141 @@ static j_int_t jdec_update_path(jdec_this_t jdec_this, j_fszpath_t jsz_path)
     return JDEC_ERR_OK;
 }
 
+/**********************************************************/
+/**
+ * @brief 按已读取的 文件头信息，预测 解码操作的 峰值内存（字节）。
+ * @note
+ * 1. jdec_ptr 须已完成 jpeg_read_header()，jcs_conv 须为 有效的色彩空间转换；
+ *    该操作会改写 jdec_ptr 的 输出参数（色彩空间、缩放、缓冲图像模式、输出尺寸），
+ *    jpeg_start_decompress() 会按 其后的设置 重新计算；
+ * 2. 按 libjpeg 各模块的分配方式 计算：DCT 系数缓存（多扫描 或 缓冲图像模式 时
+ *    为整幅图像，jdcoefct.c）、主控制器 与 上采样 的行缓存（jdmainct.c、jdsample.c）、
+ *    输出行的指针数组，以及 JDEC_MPEAK_FIXED；不包括 调用方提供的 输出像素缓存。
+ * 
+ * @param [in ] jdec_ptr : 已读取文件头的 libjpeg 解码器。
+ * @param [in ] jcs_conv : 解码输出的 色彩空间。
+ * @param [in ] jut_sden : 缩放分母（1、2、4、8）。
+ * @param [in ] jbl_bimg : 是否为 缓冲图像模式（jdec_ladder() 的各个缩放输出）。
+ * @param [in ] jst_mmax : 解码器的 内存上限（max_memory_to_use，为 0 时 不设上限）。
+ * 
+ * @return j_size_t : 预测的 峰值内存（字节）。
+ */
+static j_size_t jdec_mpeak_predict(
+                    jdec_obj_t * jdec_ptr,
+                    jctl_cs_t    jcs_conv,
+                    j_uint_t     jut_sden,
+                    j_bool_t     jbl_bimg,
+                    j_size_t     jst_mmax)
+{
+    jpeg_component_info * jcomp_ptr = J_NULL;
+    j_bool_t jbl_luma  = J_FALSE;
+    j_size_t jst_bcol  = 0;
+    j_size_t jst_coef  = 0;
+    j_size_t jst_strip = 0;
+    j_size_t jst_rows  = 0;
+    j_int_t  jit_iter  = 0;
+
+    jdec_ptr->out_color_space = jcs_to_lib(JCTL_CS_TYPE(jcs_conv));
+    jdec_ptr->scale_num       = 1;
+    jdec_ptr->scale_denom     = jut_sden;
+    jdec_ptr->buffered_image  = jbl_bimg;
+    jpeg_calc_output_dimensions(jdec_ptr);
+
+    // 彩色 => 灰度 时，只处理 亮度分量（jdcolor.c 清除了其他分量的 component_needed）
+    jbl_luma = (JCS_GRAYSCALE == jdec_ptr->out_color_space) &&
+               ((JCS_YCbCr  == jdec_ptr->jpeg_color_space) ||
+                (JCS_BG_YCC == jdec_ptr->jpeg_color_space));
+
+    for (jit_iter = 0; jit_iter < jdec_ptr->num_components; ++jit_iter)
+    {
+        jcomp_ptr = &jdec_ptr->comp_info[jit_iter];
+
+        // DCT 系数缓存 对全部分量分配，jst_strip 为 其最小的 访问窗口
+        jst_bcol   = (j_size_t)jround_up((long)jcomp_ptr->width_in_blocks,
+                                         (long)jcomp_ptr->h_samp_factor);
+        jst_coef  += jst_bcol * sizeof(JBLOCK) *
+                     (j_size_t)jround_up((long)jcomp_ptr->height_in_blocks,
+                                         (long)jcomp_ptr->v_samp_factor);
+        jst_strip += jst_bcol * sizeof(JBLOCK) * jcomp_ptr->v_samp_factor *
+                     (jdec_ptr->progressive_mode ? 3 : 1);
+
+        if (jbl_luma && (jit_iter > 0))
+        {
+            continue;
+        }
+
+        // 主控制器：每个 iMCU 行 的 IDCT 输出
+        jst_rows += (j_size_t)jcomp_ptr->width_in_blocks * jcomp_ptr->DCT_h_scaled_size *
+                    jcomp_ptr->v_samp_factor * jcomp_ptr->DCT_v_scaled_size;
+
+        // 上采样：非全尺寸的分量，需要 max_v_samp_factor 行 输出宽度 的缓存
+        if ((jcomp_ptr->h_samp_factor * jcomp_ptr->DCT_h_scaled_size !=
+             jdec_ptr->max_h_samp_factor * jdec_ptr->min_DCT_h_scaled_size) ||
+            (jcomp_ptr->v_samp_factor * jcomp_ptr->DCT_v_scaled_size !=
+             jdec_ptr->max_v_samp_factor * jdec_ptr->min_DCT_v_scaled_size))
+        {
+            jst_rows += (j_size_t)jround_up((long)jdec_ptr->output_width,
+                                            (long)jdec_ptr->max_h_samp_factor) *
+                        jdec_ptr->max_v_samp_factor;
+        }
+    }
+
+    // 单扫描 的顺序模式，只需要 单个 MCU 的系数缓存（已计入 JDEC_MPEAK_FIXED）
+    if (!jbl_bimg && !jpeg_has_multiple_scans(jdec_ptr))
+    {
+        jst_coef = 0;
+    }
+
+    jst_rows += (j_size_t)jdec_ptr->output_height * sizeof(j_mptr_t) + JDEC_MPEAK_FIXED;
+
+    // 设有内存上限时，放不下的 系数缓存 换出至 临时文件（jmemmgr.c 的 realize_virt_arrays()），
+    // 内存中 只保留 上限的余量，但至少 一个访问窗口；不支持临时文件的平台，超出上限时 解码失败
+    if ((jst_mmax > 0) && (jst_coef + jst_rows > jst_mmax))
+    {
+        jst_coef = (jst_mmax > jst_rows) ? (jst_mmax - jst_rows) : 0;
+        if (jst_coef < jst_strip)
+            jst_coef = jst_strip;
+    }
+
+    return (jst_coef + jst_rows);
+}
+
+/**********************************************************/
+/**
+ * @brief 按已读取的 文件头信息，预测 各种有效的 输出色彩空间（1/1 尺寸）中
+ *        解码操作的 最大峰值内存（字节），即 jpeg_info_t::jst_peak 的值。
+ * @note  jdec_ptr 的要求 与 jdec_mpeak_predict() 相同。
+ */
+static j_size_t jdec_mpeak_max(jdec_obj_t * jdec_ptr, jpeg_cs_t jcs_type)
+{
+    static const jctl_cs_t JCS_conv[] =
+    {
+        JCTL_CS_GRAY  , JCTL_CS_RGB   , JCTL_CS_YCC , JCTL_CS_CMYK,
+        JCTL_CS_YCCK  , JCTL_CS_BG_RGB, JCTL_CS_BG_YCC,
+    };
+
+    j_size_t jst_mpeak = 0;
+    j_size_t jst_mconv = 0;
+    j_uint_t jut_iter  = 0;
+
+    for (jut_iter = 0; jut_iter < sizeof(JCS_conv) / sizeof(JCS_conv[0]); ++jut_iter)
+    {
+        if (!jdec_ccs_valid(JDEC_CCS_MAKE(JCS_conv[jut_iter], jcs_type)))
+            continue;
+
+        jst_mconv = jdec_mpeak_predict(
+                        jdec_ptr,
+                        JCS_conv[jut_iter],
+                        1,
+                        J_FALSE,
+                        (j_size_t)jdec_ptr->mem->max_memory_to_use);
+        if (jst_mpeak < jst_mconv)
+            jst_mpeak = jst_mconv;
+    }
+
+    return jst_mpeak;
+}
+
 /**********************************************************/
 /**
  * @brief 配置输入源后，更新 JPEG 图像源基本信息。
@@ -262,6 +406,7 @@ static j_int_t jdec_update_info(jdec_this_t jdec_this)
         jdec_this->jinfo.jit_imgh = jdec_ptr->image_height;
         jdec_this->jinfo.jit_nchs = jdec_ptr->num_components;
         jdec_this->jinfo.jcs_type = jcs_to_comm(jdec_ptr->jpeg_color_space);
+        jdec_this->jinfo.jst_peak = jdec_mpeak_max(jdec_ptr, jdec_this->jinfo.jcs_type);
 
         //======================================
         jit_err = JDEC_ERR_OK;
@@ -323,6 +468,367 @@ static inline j_void_t jdec_shutdown(jdec_this_t jdec_this)
     jdec_this->jbl_work = J_FALSE;
 }
 
+/**
+ * @struct jdec_lctx_t
+ * @brief  多分辨率解码操作（jdec_ladder()）的工作上下文。
+ */
+typedef struct jdec_lctx_t
+{
+    j_fmemory_t   jmt_iptr;    ///< 输入的 JPEG 数据（内存模式，即为配置的输入缓存）
+    j_size_t      jst_mlen;    ///< 输入的 JPEG 数据字节数
+    j_fmemory_t   jmt_fbuf;    ///< 文件流模式 或 文件模式 时，读入全部输入数据的缓存
+    jdec_this_t   jdec_csrc;   ///< 执行（唯一一次）熵解码，持有 DCT 系数的解码器
+    jdec_rung_t * jrung_arr;   ///< 各个缩放输出的描述信息数组
+    jdec_this_t * jdec_rarr;   ///< 各个缩放输出对应的解码器
+    j_uint_t      jut_nrung;   ///< 缩放输出的数量
+    j_size_t      jst_mmax;    ///< 各个解码器的 内存上限（即 jdec_config_memory() 的设置值）
+} jdec_lctx_t;
+
+/**********************************************************/
+/**
+ * @brief 读入全部的 JPEG 输入数据（内存模式时，直接引用配置的输入缓存）。
+ * 
+ * @param [in    ] jdec_this : JPEG 解码操作的上下文对象。
+ * @param [in,out] jlctx_ptr : 接收输入数据的 jmt_iptr、jst_mlen、jmt_fbuf 字段。
+ * 
+ * @return j_int_t : 错误码，请参看 jdec_errno_t 相关枚举值。
+ */
+static j_int_t jdec_ladder_input(jdec_this_t jdec_this, jdec_lctx_t * jlctx_ptr)
+{
+    j_int_t     jit_err  = JDEC_ERR_UNKNOWN;
+    j_fstream_t jfs_iptr = J_NULL;
+    j_size_t    jst_cap  = 0;
+    j_size_t    jst_rlen = 0;
+    j_fmemory_t jmt_nbuf = J_NULL;
+
+    if (JCTL_MODE_FMEMORY == jdec_this->jmode.jct_mode)
+    {
+        jlctx_ptr->jmt_iptr = jdec_this->jmode.jmt_iptr;
+        jlctx_ptr->jst_mlen = jdec_this->jmode.jst_mlen;
+        return JDEC_ERR_OK;
+    }
+
+    //======================================
+    // 文件流模式 或 文件模式，先将全部输入数据读入缓存，
+    // 以便 各个缩放输出 的解码器，都能重新解析文件头信息
+
+    jit_err = jdec_load_mode(jdec_this);
+    if (JDEC_ERR_OK != jit_err)
+    {
+        jdec_unload_mode(jdec_this);
+        return jit_err;
+    }
+
+    jfs_iptr = (JCTL_MODE_FSTREAM == jdec_this->jmode.jct_mode) ?
+                    jdec_this->jmode.jfs_istr : jdec_this->jmode.jfs_file;
+
+    for (;;)
+    {
+        if (jst_rlen >= jst_cap)
+        {
+            jst_cap  = (0 == jst_cap) ? (64 * 1024) : (2 * jst_cap);
+            jmt_nbuf = (j_fmemory_t)realloc(jlctx_ptr->jmt_fbuf, jst_cap);
+            if (J_NULL == jmt_nbuf)
+            {
+                jit_err = JDEC_ERR_MALLOC;
+                break;
+            }
+
+            jlctx_ptr->jmt_fbuf = jmt_nbuf;
+        }
+
+        jst_rlen += fread(jlctx_ptr->jmt_fbuf + jst_rlen,
+                          1, jst_cap - jst_rlen, jfs_iptr);
+        if (jst_rlen < jst_cap)
+        {
+            jit_err = (jst_rlen > 0) ? JDEC_ERR_OK : JDEC_ERR_READ_HEADER;
+            break;
+        }
+    }
+
+    jdec_unload_mode(jdec_this);
+
+    jlctx_ptr->jmt_iptr = jlctx_ptr->jmt_fbuf;
+    jlctx_ptr->jst_mlen = jst_rlen;
+
+    return jit_err;
+}
+
+/**********************************************************/
+/**
+ * @brief 为单个缩放输出，准备好其解码器。
+ * @note
+ * 解码器以 缓冲图像模式（buffered_image）启动，此时尚未读取任何熵编码数据；
+ * 随后直接复制 jdec_csrc 中已解码的 DCT 系数 与 各分量锁定的量化表，并将输入端
+ * 标记为 已全部读取，余下的输出过程（缩放 IDCT、上采样、色彩转换）即与 libjpeg
+ * 常规解码完全一致。
+ * 
+ * @param [in ] jlctx_ptr : 多分辨率解码操作的工作上下文。
+ * @param [in ] jut_ridx  : 缩放输出的索引号。
+ * @param [in ] jcs_conv  : JPEG 解码输出的像素（色彩空间）格式。
+ * 
+ * @return j_int_t : 错误码，请参看 jdec_errno_t 相关枚举值。
+ */
+static j_int_t jdec_ladder_setup(
+                    jdec_lctx_t * jlctx_ptr,
+                    j_uint_t      jut_ridx,
+                    jctl_cs_t     jcs_conv)
+{
+    jdec_rung_t      * jrung_ptr = &jlctx_ptr->jrung_arr[jut_ridx];
+    jdec_this_t        jdec_rctx = jlctx_ptr->jdec_rarr[jut_ridx];
+    jdec_obj_t       * jsrc_ptr  = &jlctx_ptr->jdec_csrc->jdec_obj;
+    jdec_obj_t       * jdec_ptr  = &jdec_rctx->jdec_obj;
+    jvirt_barray_ptr * jsrc_arr  = jsrc_ptr->coef->coef_arrays;
+    jvirt_barray_ptr * jdst_arr  = J_NULL;
+    JBLOCKARRAY        jblk_src  = J_NULL;
+    JBLOCKARRAY        jblk_dst  = J_NULL;
+    jpeg_component_info * jcomp_ptr = J_NULL;
+    j_int_t            jit_iter  = 0;
+    j_uint_t           jut_brow  = 0;
+    j_uint_t           jut_nrow  = 0;
+    j_uint_t           jut_ncol  = 0;
+
+    if (0 != setjmp(jdec_rctx->jerr_mgr.jerr_jmp))
+    {
+        return JDEC_ERR_EXCEPTION;
+    }
+
+    jpeg_mem_src(jdec_ptr, jlctx_ptr->jmt_iptr, (unsigned long)jlctx_ptr->jst_mlen);
+    if (JPEG_HEADER_OK != jpeg_read_header(jdec_ptr, J_TRUE))
+    {
+        return JDEC_ERR_READ_HEADER;
+    }
+
+    jdec_ptr->out_color_space    = jcs_to_lib(JCTL_CS_TYPE(jcs_conv));
+    jdec_ptr->scale_num          = 1;
+    jdec_ptr->scale_denom        = jrung_ptr->jut_sden;
+    jdec_ptr->buffered_image     = J_TRUE;
+    jdec_ptr->do_block_smoothing = J_FALSE;
+
+    if (!jpeg_start_decompress(jdec_ptr))
+    {
+        return JDEC_ERR_START_FAILED;
+    }
+
+    jrung_ptr->jut_outw = jdec_ptr->output_width;
+    jrung_ptr->jut_outh = jdec_ptr->output_height;
+
+    //======================================
+    // 复制 DCT 系数（包括 对齐到采样因子 的填充块）
+
+    jdst_arr = jdec_ptr->coef->coef_arrays;
+
+    for (jit_iter = 0; jit_iter < jdec_ptr->num_components; ++jit_iter)
+    {
+        jcomp_ptr = &jdec_ptr->comp_info[jit_iter];
+        jut_nrow  = (j_uint_t)jround_up((long)jcomp_ptr->height_in_blocks,
+                                        (long)jcomp_ptr->v_samp_factor);
+        jut_ncol  = (j_uint_t)jround_up((long)jcomp_ptr->width_in_blocks,
+                                        (long)jcomp_ptr->h_samp_factor);
+
+        for (jut_brow = 0; jut_brow < jut_nrow; ++jut_brow)
+        {
+            jblk_src = (*jsrc_ptr->mem->access_virt_barray)(
+                            (j_common_ptr)jsrc_ptr, jsrc_arr[jit_iter],
+                            jut_brow, 1, J_FALSE);
+            jblk_dst = (*jdec_ptr->mem->access_virt_barray)(
+                            (j_common_ptr)jdec_ptr, jdst_arr[jit_iter],
+                            jut_brow, 1, J_TRUE);
+            memcpy(jblk_dst[0], jblk_src[0], jut_ncol * sizeof(JBLOCK));
+        }
+    }
+
+    //======================================
+    // 复制各分量 锁定的量化表：libjpeg 在分量首次出现于某个扫描时 才锁定其量化表
+    // （latch_quant_tables()），本解码器只启动了第一个扫描，非交错 或 渐进式
+    // 图像中 不在第一个扫描的分量，其 quant_table 仍为空，IDCT 将输出 平坦的灰色
+
+    for (jit_iter = 0; jit_iter < jdec_ptr->num_components; ++jit_iter)
+    {
+        jcomp_ptr = &jdec_ptr->comp_info[jit_iter];
+        if (J_NULL == jsrc_ptr->comp_info[jit_iter].quant_table)
+        {
+            continue;
+        }
+
+        if (J_NULL == jcomp_ptr->quant_table)
+        {
+            jcomp_ptr->quant_table = (JQUANT_TBL *)(*jdec_ptr->mem->alloc_small)(
+                                        (j_common_ptr)jdec_ptr, JPOOL_IMAGE, sizeof(JQUANT_TBL));
+        }
+
+        memcpy(jcomp_ptr->quant_table,
+               jsrc_ptr->comp_info[jit_iter].quant_table,
+               sizeof(JQUANT_TBL));
+    }
+
+    //======================================
+    // 标记输入端 已读取全部扫描数据（其状态与 consume_data() 读完最后一行 iMCU 一致）
+
+    jdec_ptr->input_iMCU_row = jdec_ptr->total_iMCU_rows;
+    (*jdec_ptr->inputctl->finish_input_pass)(jdec_ptr);
+    jdec_ptr->inputctl->eoi_reached = J_TRUE;
+
+    return JDEC_ERR_OK;
+}
+
+/**********************************************************/
+/**
+ * @brief 多分辨率解码操作中，执行单个缩放输出 的任务回调函数。
+ */
+static j_void_t jdec_ladder_task(
+                    j_void_t * jvt_ctxt,
+                    j_uint_t   jut_widx,
+                    j_uint_t   jut_tidx)
+{
+    jdec_lctx_t * jlctx_ptr = (jdec_lctx_t *)jvt_ctxt;
+    jdec_rung_t * jrung_ptr = &jlctx_ptr->jrung_arr[jut_tidx];
+    jdec_this_t   jdec_rctx = jlctx_ptr->jdec_rarr[jut_tidx];
+    jdec_obj_t  * jdec_ptr  = J_NULL;
+    j_mptr_t      jmt_pxls  = jrung_ptr->jmt_pxls;
+    j_uint_t      jut_iter  = 0;
+
+    // 准备阶段已失败的缩放输出，直接跳过
+    if (JDEC_ERR_OK != jrung_ptr->jit_err)
+    {
+        return;
+    }
+
+    jdec_ptr = &jdec_rctx->jdec_obj;
+
+    if (JDEC_ERR_OK != jdec_grow_rows(jdec_rctx, jrung_ptr->jut_outh))
+    {
+        jrung_ptr->jit_err = JDEC_ERR_MALLOC;
+        return;
+    }
+
+    for (jut_iter = 0; jut_iter < jrung_ptr->jut_outh; ++jut_iter)
+    {
+        jdec_rctx->jrows.jar_rows[jut_iter] = jmt_pxls;
+        jmt_pxls += jrung_ptr->jit_step;
+    }
+
+    if (0 != setjmp(jdec_rctx->jerr_mgr.jerr_jmp))
+    {
+        jrung_ptr->jit_err = JDEC_ERR_EXCEPTION;
+        return;
+    }
+
+    jpeg_start_output(jdec_ptr, jdec_ptr->input_scan_number);
+
+    while (jdec_ptr->output_scanline < jdec_ptr->output_height)
+    {
+        jpeg_read_scanlines(
+            jdec_ptr,
+            &jdec_rctx->jrows.jar_rows[jdec_ptr->output_scanline],
+            jdec_ptr->output_height - jdec_ptr->output_scanline);
+    }
+
+    jpeg_finish_output(jdec_ptr);
+}
+
+/**********************************************************/
+/**
+ * @brief 预测 多分辨率解码操作 的峰值内存（字节）。
+ * @note
+ * 1. 合计 输入数据的缓存（文件流模式 或 文件模式）、熵解码器的 DCT 系数缓存，
+ *    以及 各个缩放输出的解码器（缓冲图像模式，各自复制一份 DCT 系数）；
+ * 2. 输出参数 会影响 熵解码（jdhuff.c 按缩放尺寸 省略系数），故不使用 jdec_csrc，
+ *    而是 另用一个临时的解码器 读取文件头。
+ * 
+ * @param [in ] jlctx_ptr : 多分辨率解码操作的工作上下文（已读入 输入数据）。
+ * @param [in ] jcs_conv  : 解码输出的 色彩空间（须为 有效的转换）。
+ * 
+ * @return j_size_t : 预测的 峰值内存（字节），读取文件头失败时 返回 0。
+ */
+static j_size_t jdec_ladder_mpeak(jdec_lctx_t * jlctx_ptr, jctl_cs_t jcs_conv)
+{
+    jdec_this_t  jdec_temp = jdec_alloc(J_NULL);
+    jdec_obj_t * jdec_ptr  = J_NULL;
+    j_size_t     jst_mpeak = 0;
+    j_uint_t     jut_iter  = 0;
+
+    if (J_NULL == jdec_temp)
+    {
+        return 0;
+    }
+
+    jdec_ptr = &jdec_temp->jdec_obj;
+
+    if (0 != setjmp(jdec_temp->jerr_mgr.jerr_jmp))
+    {
+        jdec_release(jdec_temp);
+        return 0;
+    }
+
+    jpeg_mem_src(jdec_ptr, jlctx_ptr->jmt_iptr, (unsigned long)jlctx_ptr->jst_mlen);
+    if (JPEG_HEADER_OK == jpeg_read_header(jdec_ptr, J_TRUE))
+    {
+        // 熵解码器 只有 DCT 系数缓存，按 1/8 缩放 计（其行缓存 可忽略）
+        jst_mpeak = jdec_mpeak_predict(jdec_ptr, jcs_conv, 8, J_TRUE, jlctx_ptr->jst_mmax);
+
+        for (jut_iter = 0; jut_iter < jlctx_ptr->jut_nrung; ++jut_iter)
+        {
+            switch (jlctx_ptr->jrung_arr[jut_iter].jut_sden)
+            {
+            case 1: case 2: case 4: case 8:
+                jst_mpeak += jdec_mpeak_predict(
+                                jdec_ptr,
+                                jcs_conv,
+                                jlctx_ptr->jrung_arr[jut_iter].jut_sden,
+                                J_TRUE,
+                                jlctx_ptr->jst_mmax);
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        if (J_NULL != jlctx_ptr->jmt_fbuf)
+        {
+            jst_mpeak += jlctx_ptr->jst_mlen;
+        }
+    }
+
+    jdec_release(jdec_temp);
+
+    return jst_mpeak;
+}
+
+/**********************************************************/
+/**
+ * @brief 释放多分辨率解码操作的工作上下文中的资源。
+ */
+static j_void_t jdec_ladder_free(jdec_lctx_t * jlctx_ptr)
+{
+    j_uint_t jut_iter = 0;
+
+    if (J_NULL != jlctx_ptr->jdec_rarr)
+    {
+        for (jut_iter = 0; jut_iter < jlctx_ptr->jut_nrung; ++jut_iter)
+        {
+            if (J_NULL != jlctx_ptr->jdec_rarr[jut_iter])
+                jdec_release(jlctx_ptr->jdec_rarr[jut_iter]);
+        }
+
+        free(jlctx_ptr->jdec_rarr);
+        jlctx_ptr->jdec_rarr = J_NULL;
+    }
+
+    if (J_NULL != jlctx_ptr->jdec_csrc)
+    {
+        jdec_release(jlctx_ptr->jdec_csrc);
+        jlctx_ptr->jdec_csrc = J_NULL;
+    }
+
+    if (J_NULL != jlctx_ptr->jmt_fbuf)
+    {
+        free(jlctx_ptr->jmt_fbuf);
+        jlctx_ptr->jmt_fbuf = J_NULL;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // JPEG 解码器 外部接口函数
 
@@ -348,6 +854,7 @@ jdec_this_t jdec_alloc(j_void_t * jvt_reserved)
     jdec_this->jut_size = sizeof(jdec_ctx_t);
     jdec_this->jut_type = JDEC_HANDLE_TYPE;
     jdec_this->jbl_work = J_FALSE;
+    jdec_this->jst_mbud = 0;
 
     jdec_this->jmode.jct_mode = JCTL_MODE_UNKNOWN;
     jdec_this->jmode.jst_mlen = 0;
@@ -360,6 +867,7 @@ jdec_this_t jdec_alloc(j_void_t * jvt_reserved)
     jdec_this->jinfo.jit_imgh = 0;
     jdec_this->jinfo.jit_nchs = 0;
     jdec_this->jinfo.jcs_type = JPEG_CS_UNKNOWN;
+    jdec_this->jinfo.jst_peak = 0;
 
     jdec_this->jrows.jut_size = 0;
     jdec_this->jrows.jar_rows = J_NULL;
@@ -474,7 +982,7 @@ j_int_t jdec_config(
         if (J_NULL != jfh_iptr)
         {
             jdec_this->jmode.jct_mode = JCTL_MODE_FSTREAM;
-            jdec_this->jmode.jfp_spos = JFS_INVALID_FPOS;
+            jdec_this->jmode.jbl_spos = J_FALSE;
             jdec_this->jmode.jfs_istr = (j_fstream_t)jfh_iptr;
 
             jit_err = JDEC_ERR_OK;
@@ -512,10 +1020,83 @@ j_int_t jdec_config(
     return JDEC_ERR_OK;
 }
 
+/**********************************************************/
+/**
+ * @brief 设置 解码器 可使用的内存上限（即 libjpeg 的 max_memory_to_use）。
+ * @note
+ * 1. 设置值 对其后的 解码操作 均有效，直至再次设置；
+ *    jst_mmax 为 0 时 不设上限（默认值，也可由 环境变量 JPEGMEM 指定）；
+ * 2. 渐进式 等 需要整幅 DCT 系数缓存 的图像 超出上限时，
+ *    Linux 等 POSIX 平台 会将缓存 换出至 临时文件（目录取 环境变量 TMPDIR，
+ *    缺省为 /var/tmp），以 额外的文件读写 换取 有界的内存占用；
+ *    其他平台 不支持临时文件，此时 解码失败（JDEC_ERR_EXCEPTION）；
+ * 3. 上限 只约束 libjpeg 内部的工作缓存，不包括 调用方提供的 输出像素缓存；
+ * 4. jdec_ladder() 的 熵解码器 与 各个缩放输出的解码器（各自持有一份 DCT 系数），
+ *    均分别使用该上限，所以 其合计的内存占用 最多为 上限 ×（缩放输出数量 + 1）。
+ * 
+ * @param [in ] jdec_this : JPEG 解码操作的上下文对象。
+ * @param [in ] jst_mmax  : 内存上限（以 字节 为单位，0 表示 不设上限）。
+ * 
+ * @return j_int_t : 错误码，请参看 jdec_errno_t 相关枚举值。
+ */
+j_int_t jdec_config_memory(jdec_this_t jdec_this, j_size_t jst_mmax)
+{
+    JASSERT(jdec_valid(jdec_this));
+
+    if (jdec_this->jbl_work)
+    {
+        return JDEC_ERR_WORKING;
+    }
+
+    // max_memory_to_use 为 long 类型，超出其范围时 即视为 不设上限
+    if (jst_mmax > (j_size_t)LONG_MAX)
+    {
+        jst_mmax = 0;
+    }
+
+    jdec_this->jdec_obj.mem->max_memory_to_use = (long)jst_mmax;
+
+    return JDEC_ERR_OK;
+}
+
+/**********************************************************/
+/**
+ * @brief 设置 解码操作的 内存预算：预测的峰值内存 超出预算的图像，直接拒绝解码。
+ * @note
+ * 1. 设置值 对其后的 解码操作 均有效，直至再次设置；jst_mbud 为 0 时 不作限制（默认值）；
+ * 2. 读取文件头后，按 jpeg_info_t::jst_peak 的方式 预测峰值内存，超出预算时
+ *    在 libjpeg 分配任何工作缓存（jpeg_start_decompress()）之前 返回 JDEC_ERR_BUDGET，
+ *    此时 jinfo_ptr 仍会返回 图像基本信息 及 预测值；
+ * 3. jdec_ladder() 的预算 按 全部缩放输出 合计（见 jdec_ladder() 的说明）。
+ * 
+ * @param [in ] jdec_this : JPEG 解码操作的上下文对象。
+ * @param [in ] jst_mbud  : 内存预算（以 字节 为单位，0 表示 不作限制）。
+ * 
+ * @return j_int_t : 错误码，请参看 jdec_errno_t 相关枚举值。
+ */
+j_int_t jdec_config_budget(jdec_this_t jdec_this, j_size_t jst_mbud)
+{
+    JASSERT(jdec_valid(jdec_this));
+
+    if (jdec_this->jbl_work)
+    {
+        return JDEC_ERR_WORKING;
+    }
+
+    jdec_this->jst_mbud = jst_mbud;
+
+    return JDEC_ERR_OK;
+}
+
 /**********************************************************/
 /**
  * @brief 读取 JPEG 图像信息。
- * @note  调用该接口前，先使用 jdec_config() 接口配置输入源。
+ * @note
+ * 1. 调用该接口前，先使用 jdec_config() 接口配置输入源；
+ * 2. jinfo_ptr->jst_peak 为 按文件头信息 预测的 解码峰值内存（字节），
+ *    取 各种有效的输出色彩空间（1/1 尺寸）中的 最大值，已计入 jdec_config_memory()
+ *    的内存上限；包括 libjpeg 的工作缓存（渐进式 或 多扫描 图像 为整幅的 DCT 系数缓存），
+ *    不包括 调用方提供的 输出像素缓存；jdec_start() 会按 实际的输出色彩空间 重新预测。
  * 
  * @param [in ] jdec_this : JPEG 解码操作的上下文对象。
  * @param [out] jinfo_ptr : 操作成功返回的 JPEG 图像信息。
@@ -555,6 +1136,7 @@ j_int_t jdec_info(
     jinfo_ptr->jit_imgh = jdec_this->jinfo.jit_imgh;
     jinfo_ptr->jit_nchs = jdec_this->jinfo.jit_nchs;
     jinfo_ptr->jcs_type = jdec_this->jinfo.jcs_type;
+    jinfo_ptr->jst_peak = jdec_this->jinfo.jst_peak;
 
     return JDEC_ERR_OK;
 }
@@ -572,7 +1154,9 @@ j_int_t jdec_info(
  * 1. 无论 jdec_start() 操作是否成功，
  *    只要 (JPEG_CS_UNKNOWN != jinfo_ptr->jcs_type)，
  *    则说明读取到了 JPEG 图像基本信息；
- * 2. 若入参时为 J_NULL，则忽略读取图像基本信息。
+ * 2. 若入参时为 J_NULL，则忽略读取图像基本信息；
+ * 3. jinfo_ptr->jst_peak 为 按 jcs_conv 预测的 峰值内存，超出 jdec_config_budget()
+ *    的预算时，不启动解码器，返回 JDEC_ERR_BUDGET。
  * 
  * @return j_int_t : 错误码，请参看 jdec_errno_t 相关枚举值。
  */
@@ -595,6 +1179,7 @@ j_int_t jdec_start(
         jinfo_ptr->jit_imgh = 0;
         jinfo_ptr->jit_nchs = 0;
         jinfo_ptr->jcs_type = JPEG_CS_UNKNOWN;
+        jinfo_ptr->jst_peak = 0;
     }
 
     //======================================
@@ -639,6 +1224,7 @@ j_int_t jdec_start(
         jdec_this->jinfo.jit_imgh = jdec_ptr->image_height;
         jdec_this->jinfo.jit_nchs = jdec_ptr->num_components;
         jdec_this->jinfo.jcs_type = jcs_to_comm(jdec_ptr->jpeg_color_space);
+        jdec_this->jinfo.jst_peak = 0;
 
         // 保存返回的 JPEG 图像源基本信息
         if ((J_NULL != jinfo_ptr) && 
@@ -660,8 +1246,23 @@ j_int_t jdec_start(
             break;
         }
 
-        // 设置输出像素的色彩空间
-        jdec_ptr->out_color_space = jcs_to_lib(JCTL_CS_TYPE(jcs_conv));
+        // 预测峰值内存（同时设置了 输出像素的色彩空间），超出预算时 不再启动解码器
+        jdec_this->jinfo.jst_peak = jdec_mpeak_predict(
+                                        jdec_ptr,
+                                        jcs_conv,
+                                        1,
+                                        J_FALSE,
+                                        (j_size_t)jdec_ptr->mem->max_memory_to_use);
+        if (J_NULL != jinfo_ptr)
+        {
+            jinfo_ptr->jst_peak = jdec_this->jinfo.jst_peak;
+        }
+
+        if ((jdec_this->jst_mbud > 0) && (jdec_this->jinfo.jst_peak > jdec_this->jst_mbud))
+        {
+            jit_err = JDEC_ERR_BUDGET;
+            break;
+        }
 
         // 启动解码器
         if (!jpeg_start_decompress(jdec_ptr))
@@ -849,6 +1450,33 @@ j_int_t jdec_finish(jdec_this_t jdec_this)
     return jit_err;
 }
 
+/**********************************************************/
+/**
+ * @brief 中止 JPEG 解码操作（不再读取其余的像素行）。
+ * @note
+ * 1. 只需要图像的前若干像素行时（例如 区域剪切），读完所需的像素行后，
+ *    调用该接口代替 jdec_finish() 关闭解码器，其后的像素行 不再解码；
+ * 2. 所需像素行之前的像素行，可用 jit_step 为 0 的 jdec_read() 读至
+ *    同一个像素行缓存后丢弃。
+ * 
+ * @param [in ] jdec_this : JPEG 解码操作的上下文对象。
+ * 
+ * @return j_int_t : 错误码，请参看 jdec_errno_t 相关枚举值。
+ */
+j_int_t jdec_abort(jdec_this_t jdec_this)
+{
+    JASSERT(jdec_valid(jdec_this));
+
+    if (!jdec_this->jbl_work)
+    {
+        return JDEC_ERR_UNSTART;
+    }
+
+    jdec_shutdown(jdec_this);
+
+    return JDEC_ERR_OK;
+}
+
 /**********************************************************/
 /**
  * @brief 对整幅 JPEG 图像进行 解码操作。
@@ -899,4 +1527,329 @@ j_int_t jdec_image(
     return jit_rows;
 }
 
+/**********************************************************/
+/**
+ * @brief 只解码 JPEG 图像中 [jut_ypos, jut_ypos + jut_rows) 范围内的像素行。
+ * @note
+ * 1. 调用该接口前，应先使用 jdec_config() 配置好输入源模式；
+ * 2. jut_ypos 之前的像素行，解码至 jmt_pxls 的首行后丢弃（不需要额外的缓存），
+ *    读完最后一个所需的像素行后，即中止解码器，其后的像素行 不再解码；
+ *    但 渐进式（progressive）图像，在启动解码器时 就已读入全部扫描数据；
+ * 3. jmt_pxls 只需容纳 jut_rows 个像素行，其首行对应于图像的第 jut_ypos 行；
+ * 4. 范围超出图像高度时，只解码至图像的最后一行。
+ * 
+ * @param [in ] jdec_this : JPEG 解码操作的上下文对象。
+ * @param [in ] jcs_conv  : JPEG 解码输出的像素（色彩空间）格式。
+ * @param [in ] jut_ypos  : 解码输出的 起始像素行。
+ * @param [in ] jut_rows  : 解码输出的 像素行数量。
+ * @param [out] jmt_pxls  : JPEG 解码输出的像素缓存（注意，其大小必须 足够大）。
+ * @param [in ] jit_step  : 遍历像素行时的 步长值（以 字节 为单位）。
+ * @param [out] jinfo_ptr : 操作返回的 JPEG 图像源基本信息（可传入 J_NULL 忽略返回）。
+ * 
+ * @return j_int_t : 
+ * - 返回值 <  0，表示操作失败，产生错误返回的 错误码，请参看 jdec_errno_t 相关枚举值。
+ * - 返回值 >= 0，表示读取的图像像素行数量。
+ */
+j_int_t jdec_rows(
+            jdec_this_t jdec_this,
+            jctl_cs_t   jcs_conv,
+            j_uint_t    jut_ypos,
+            j_uint_t    jut_rows,
+            j_mptr_t    jmt_pxls,
+            j_int_t     jit_step,
+            jinfo_ptr_t jinfo_ptr)
+{
+    j_int_t jit_err;
+    j_int_t jit_rows;
+
+    if ((J_NULL == jmt_pxls) || (jut_rows <= 0))
+    {
+        return JDEC_ERR_EPARAM;
+    }
+
+    jit_err = jdec_start(jdec_this, jcs_conv, jinfo_ptr);
+    if (JDEC_ERR_OK != jit_err)
+    {
+        return jit_err;
+    }
+
+    //======================================
+    // 起始行之前的像素行，逐行解码至 jmt_pxls 的首行（步长为 0）后丢弃
+
+    if (jut_ypos >= jdec_this->jdec_obj.output_height)
+    {
+        jdec_shutdown(jdec_this);
+        return 0;
+    }
+
+    if (jut_ypos > 0)
+    {
+        jit_err = jdec_read(jdec_this, jmt_pxls, 0, jut_ypos);
+        if (jit_err < 0)
+        {
+            return jit_err;
+        }
+    }
+
+    //======================================
+
+    jit_err = jdec_read(jdec_this, jmt_pxls, jit_step, jut_rows);
+    if (jit_err < 0)
+    {
+        return jit_err;
+    }
+
+    jit_rows = jit_err;
+
+    // 已读至图像末尾，正常结束解码；否则 直接中止，其后的像素行 不再解码
+    if (jdec_this->jdec_obj.output_scanline >= jdec_this->jdec_obj.output_height)
+    {
+        jit_err = jdec_finish(jdec_this);
+        if (JDEC_ERR_OK != jit_err)
+        {
+            return jit_err;
+        }
+    }
+    else
+    {
+        jdec_abort(jdec_this);
+    }
+
+    return jit_rows;
+}
+
+/**********************************************************/
+/**
+ * @brief 只执行一次熵解码，同时输出多个缩放尺寸（1/1、1/2、1/4、1/8）的图像。
+ * @note
+ * 1. 调用该接口前，应先使用 jdec_config() 配置好输入源模式，
+ *    文件流模式 与 文件模式 时，会先将全部输入数据读入内存；
+ * 2. 熵解码（jpeg_read_coefficients()）只执行一次，各个缩放输出共享其 DCT 系数，
+ *    再分别执行 libjpeg 的缩放 IDCT（jpeg_idct_4x4()、jpeg_idct_2x2()、
+ *    jpeg_idct_1x1() 等）、上采样 与 色彩转换，输出结果 与 设置相同 scale_denom
+ *    的常规解码 逐字节相同；
+ * 3. 每个缩放输出 作为一个任务，由 jthrd_parallel() 并行执行，
+ *    每个缩放输出 各自持有一份 DCT 系数的副本；
+ * 4. 各个缩放输出的 jut_outw、jut_outh，分别为 ceil(图像宽度 / jut_sden)、
+ *    ceil(图像高度 / jut_sden)，调用方可据此预先分配 jmt_pxls 缓存；
+ * 5. jdec_config_memory() 的内存上限 分别作用于 熵解码器 与 各个缩放输出的解码器，
+ *    超出上限的 DCT 系数缓存 换出至临时文件（参看 jdec_config_memory() 的说明）；
+ * 6. jinfo_ptr->jst_peak 为 熵解码器 与 全部缩放输出 合计的 预测峰值内存（已计入 内存上限），
+ *    超出 jdec_config_budget() 的预算时，在 熵解码 之前 返回 JDEC_ERR_BUDGET。
+ * 
+ * @param [in ] jdec_this : JPEG 解码操作的上下文对象（只提供输入源配置）。
+ * @param [in ] jcs_conv  : JPEG 解码输出的像素（色彩空间）格式。
+ * @param [in,out] jrung_arr : 各个缩放输出的描述信息数组。
+ * @param [in ] jut_nrung : 缩放输出的数量。
+ * @param [in ] jut_nthd  : 工作线程数量（为 0 时，取 jthrd_ncpus() 的值）。
+ * @param [out] jinfo_ptr : 操作返回的 JPEG 图像源基本信息（可传入 J_NULL 忽略返回）。
+ * 
+ * @return j_int_t :
+ * - 返回值 >= 0，表示执行成功的缩放输出数量；
+ * - 返回值 <  0，表示 错误码，参看 jdec_errno_t 相关枚举值。
+ */
+j_int_t jdec_ladder(
+            jdec_this_t   jdec_this,
+            jctl_cs_t     jcs_conv,
+            jdec_rung_t * jrung_arr,
+            j_uint_t      jut_nrung,
+            j_uint_t      jut_nthd,
+            jinfo_ptr_t   jinfo_ptr)
+{
+    JASSERT(jdec_valid(jdec_this));
+
+    j_int_t      jit_err  = JDEC_ERR_UNKNOWN;
+    j_uint_t     jut_iter = 0;
+    jdec_obj_t * jsrc_ptr = J_NULL;
+    jdec_lctx_t  jlctx;
+
+    memset(&jlctx, 0, sizeof(jdec_lctx_t));
+
+    if (J_NULL != jinfo_ptr)
+    {
+        jinfo_ptr->jit_imgw = 0;
+        jinfo_ptr->jit_imgh = 0;
+        jinfo_ptr->jit_nchs = 0;
+        jinfo_ptr->jcs_type = JPEG_CS_UNKNOWN;
+        jinfo_ptr->jst_peak = 0;
+    }
+
+    //======================================
+    // 验证参数有效性
+
+    if ((J_NULL == jrung_arr) && (jut_nrung > 0))
+    {
+        return JDEC_ERR_EPARAM;
+    }
+
+    if (JCTL_MODE_UNKNOWN == jdec_this->jmode.jct_mode)
+    {
+        return JDEC_ERR_UNCONFIG;
+    }
+
+    if (jdec_this->jbl_work)
+    {
+        return JDEC_ERR_WORKING;
+    }
+
+    if (0 == jut_nrung)
+    {
+        return 0;
+    }
+
+    for (jut_iter = 0; jut_iter < jut_nrung; ++jut_iter)
+    {
+        jrung_arr[jut_iter].jut_outw = 0;
+        jrung_arr[jut_iter].jut_outh = 0;
+        jrung_arr[jut_iter].jit_err  = JDEC_ERR_UNKNOWN;
+    }
+
+    //======================================
+
+    do
+    {
+        jit_err = jdec_ladder_input(jdec_this, &jlctx);
+        if (JDEC_ERR_OK != jit_err)
+        {
+            break;
+        }
+
+        jlctx.jrung_arr = jrung_arr;
+        jlctx.jut_nrung = jut_nrung;
+        jlctx.jst_mmax  = (j_size_t)jdec_this->jdec_obj.mem->max_memory_to_use;
+        jlctx.jdec_csrc = jdec_alloc(J_NULL);
+        jlctx.jdec_rarr = (jdec_this_t *)calloc(jut_nrung + 1, sizeof(jdec_this_t));
+        if ((J_NULL == jlctx.jdec_csrc) || (J_NULL == jlctx.jdec_rarr))
+        {
+            jit_err = JDEC_ERR_MALLOC;
+            break;
+        }
+
+        // 各个解码器 均使用 jdec_this 的内存上限
+        jdec_config_memory(jlctx.jdec_csrc, jlctx.jst_mmax);
+
+        //======================================
+        // 读取文件头，并执行 熵解码
+
+        if (0 != setjmp(jlctx.jdec_csrc->jerr_mgr.jerr_jmp))
+        {
+            jit_err = JDEC_ERR_EXCEPTION;
+            goto __EXIT_FUNC;
+        }
+
+        jsrc_ptr = &jlctx.jdec_csrc->jdec_obj;
+
+        jpeg_mem_src(jsrc_ptr, jlctx.jmt_iptr, (unsigned long)jlctx.jst_mlen);
+        if (JPEG_HEADER_OK != jpeg_read_header(jsrc_ptr, J_TRUE))
+        {
+            jit_err = JDEC_ERR_READ_HEADER;
+            break;
+        }
+
+        jdec_this->jinfo.jit_imgw = jsrc_ptr->image_width;
+        jdec_this->jinfo.jit_imgh = jsrc_ptr->image_height;
+        jdec_this->jinfo.jit_nchs = jsrc_ptr->num_components;
+        jdec_this->jinfo.jcs_type = jcs_to_comm(jsrc_ptr->jpeg_color_space);
+        jdec_this->jinfo.jst_peak = 0;
+
+        if ((J_NULL != jinfo_ptr) && 
+            (JPEG_CS_UNKNOWN != jdec_this->jinfo.jcs_type))
+        {
+            jinfo_ptr->jit_imgw = jdec_this->jinfo.jit_imgw;
+            jinfo_ptr->jit_imgh = jdec_this->jinfo.jit_imgh;
+            jinfo_ptr->jit_nchs = jdec_this->jinfo.jit_nchs;
+            jinfo_ptr->jcs_type = jdec_this->jinfo.jcs_type;
+        }
+
+        if (!jdec_ccs_valid(JDEC_CCS_MAKE(jcs_conv, jdec_this->jinfo.jcs_type)))
+        {
+            jit_err = JDEC_ERR_CCS_UNIMPL;
+            break;
+        }
+
+        // 预测峰值内存，超出预算时 不再执行 熵解码
+        jdec_this->jinfo.jst_peak = jdec_ladder_mpeak(&jlctx, jcs_conv);
+        if (J_NULL != jinfo_ptr)
+        {
+            jinfo_ptr->jst_peak = jdec_this->jinfo.jst_peak;
+        }
+
+        if ((jdec_this->jst_mbud > 0) && (jdec_this->jinfo.jst_peak > jdec_this->jst_mbud))
+        {
+            jit_err = JDEC_ERR_BUDGET;
+            break;
+        }
+
+        if (J_NULL == jpeg_read_coefficients(jsrc_ptr))
+        {
+            jit_err = JDEC_ERR_START_FAILED;
+            break;
+        }
+
+        //======================================
+        // 逐个准备 各个缩放输出 的解码器
+
+        for (jut_iter = 0; jut_iter < jut_nrung; ++jut_iter)
+        {
+            switch (jrung_arr[jut_iter].jut_sden)
+            {
+            case 1: case 2: case 4: case 8:
+                break;
+            default:
+                jrung_arr[jut_iter].jit_err = JDEC_ERR_EPARAM;
+                continue;
+            }
+
+            if (J_NULL == jrung_arr[jut_iter].jmt_pxls)
+            {
+                jrung_arr[jut_iter].jit_err = JDEC_ERR_EPARAM;
+                continue;
+            }
+
+            jlctx.jdec_rarr[jut_iter] = jdec_alloc(J_NULL);
+            if (J_NULL == jlctx.jdec_rarr[jut_iter])
+            {
+                jrung_arr[jut_iter].jit_err = JDEC_ERR_MALLOC;
+                continue;
+            }
+
+            jdec_config_memory(jlctx.jdec_rarr[jut_iter], jlctx.jst_mmax);
+
+            jrung_arr[jut_iter].jit_err =
+                jdec_ladder_setup(&jlctx, jut_iter, jcs_conv);
+        }
+
+        // 已不再需要 熵解码 的系数，先行释放
+        jpeg_abort_decompress(jsrc_ptr);
+        jsrc_ptr = J_NULL;
+
+        //======================================
+        // 并行执行 各个缩放输出 的 IDCT、上采样 与 色彩转换
+
+        jthrd_parallel(jut_nthd, jut_nrung, jdec_ladder_task, &jlctx);
+
+        jit_err = 0;
+        for (jut_iter = 0; jut_iter < jut_nrung; ++jut_iter)
+        {
+            if (JDEC_ERR_OK == jrung_arr[jut_iter].jit_err)
+                jit_err += 1;
+        }
+    } while (0);
+
+    //======================================
+
+__EXIT_FUNC:
+    if (J_NULL != jsrc_ptr)
+    {
+        jpeg_abort_decompress(jsrc_ptr);
+        jsrc_ptr = J_NULL;
+    }
+
+    jdec_ladder_free(&jlctx);
+
+    //======================================
+
+    return jit_err;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
@@ -146,6 +146,7 @@ typedef enum __jdec_errno__
     JDEC_ERR_MALLOC        ,   ///< 申请缓存失败
     JDEC_ERR_EPARAM        ,   ///< 输入参数有误
     JDEC_ERR_EXCEPTION     ,   ///< 编码操作过程产生异常错误
+    JDEC_ERR_BUDGET        ,   ///< 预测的峰值内存 超出预算（参看 jdec_config_budget()）
 } jdec_errno_t;
 
 /**********************************************************/
@@ -172,12 +173,37 @@ static inline j_cstring_t jdec_errno_name(j_int_t jit_err)
     case JDEC_ERR_MALLOC       : jsz_name = "JDEC_ERR_MALLOC"      ; break;
     case JDEC_ERR_EPARAM       : jsz_name = "JDEC_ERR_EPARAM"      ; break;
     case JDEC_ERR_EXCEPTION    : jsz_name = "JDEC_ERR_EXCEPTION"   ; break;
+    case JDEC_ERR_BUDGET       : jsz_name = "JDEC_ERR_BUDGET"      ; break;
     default: break;
     }
 
     return jsz_name;
 }
 
+/**
+ * @struct jdec_rung_t
+ * @brief  多分辨率解码操作（jdec_ladder()）中，单个缩放输出的描述信息。
+ */
+typedef struct jdec_rung_t
+{
+    j_uint_t    jut_sden;      ///< [in ] 缩放分母（1、2、4、8，分别输出 1/1、1/2、1/4、1/8 尺寸）
+    j_mptr_t    jmt_pxls;      ///< [in ] 解码输出的像素缓存（注意，其大小必须 足够大）
+    j_int_t     jit_step;      ///< [in ] 遍历像素行时的 步长值（以 字节 为单位）
+
+    j_uint_t    jut_outw;      ///< [out] 输出图像的宽度
+    j_uint_t    jut_outh;      ///< [out] 输出图像的高度
+    j_int_t     jit_err;       ///< [out] 解码操作的错误码（参看 jdec_errno_t）
+} jdec_rung_t;
+
+/**********************************************************/
+/**
+ * @brief 计算按 1/jut_sden 缩放解码后的 图像尺寸（宽度 或 高度）。
+ */
+static inline j_uint_t jdec_scaled_size(j_uint_t jut_size, j_uint_t jut_sden)
+{
+    return (jut_size + jut_sden - 1) / jut_sden;
+}
+
 /**********************************************************/
 /**
  * @brief 申请 JPEG 解码操作的上下文对象。
@@ -225,10 +251,53 @@ j_int_t jdec_config(
             j_fhandle_t jfh_iptr,
             j_size_t    jst_mlen);
 
+/**********************************************************/
+/**
+ * @brief 设置 解码器 可使用的内存上限（即 libjpeg 的 max_memory_to_use）。
+ * @note
+ * 1. 设置值 对其后的 解码操作 均有效，直至再次设置；
+ *    jst_mmax 为 0 时 不设上限（默认值，也可由 环境变量 JPEGMEM 指定）；
+ * 2. 渐进式 等 需要整幅 DCT 系数缓存 的图像 超出上限时，
+ *    Linux 等 POSIX 平台 会将缓存 换出至 临时文件（目录取 环境变量 TMPDIR，
+ *    缺省为 /var/tmp），以 额外的文件读写 换取 有界的内存占用；
+ *    其他平台 不支持临时文件，此时 解码失败（JDEC_ERR_EXCEPTION）；
+ * 3. 上限 只约束 libjpeg 内部的工作缓存，不包括 调用方提供的 输出像素缓存；
+ * 4. jdec_ladder() 的 熵解码器 与 各个缩放输出的解码器（各自持有一份 DCT 系数），
+ *    均分别使用该上限，所以 其合计的内存占用 最多为 上限 ×（缩放输出数量 + 1）。
+ * 
+ * @param [in ] jdec_this : JPEG 解码操作的上下文对象。
+ * @param [in ] jst_mmax  : 内存上限（以 字节 为单位，0 表示 不设上限）。
+ * 
+ * @return j_int_t : 错误码，请参看 jdec_errno_t 相关枚举值。
+ */
+j_int_t jdec_config_memory(jdec_this_t jdec_this, j_size_t jst_mmax);
+
+/**********************************************************/
+/**
+ * @brief 设置 解码操作的 内存预算：预测的峰值内存 超出预算的图像，直接拒绝解码。
+ * @note
+ * 1. 设置值 对其后的 解码操作 均有效，直至再次设置；jst_mbud 为 0 时 不作限制（默认值）；
+ * 2. 读取文件头后，按 jpeg_info_t::jst_peak 的方式 预测峰值内存，超出预算时
+ *    在 libjpeg 分配任何工作缓存（jpeg_start_decompress()）之前 返回 JDEC_ERR_BUDGET，
+ *    此时 jinfo_ptr 仍会返回 图像基本信息 及 预测值；
+ * 3. jdec_ladder() 的预算 按 全部缩放输出 合计（见 jdec_ladder() 的说明）。
+ * 
+ * @param [in ] jdec_this : JPEG 解码操作的上下文对象。
+ * @param [in ] jst_mbud  : 内存预算（以 字节 为单位，0 表示 不作限制）。
+ * 
+ * @return j_int_t : 错误码，请参看 jdec_errno_t 相关枚举值。
+ */
+j_int_t jdec_config_budget(jdec_this_t jdec_this, j_size_t jst_mbud);
+
 /**********************************************************/
 /**
  * @brief 读取 JPEG 图像信息。
- * @note  调用该接口前，先使用 jdec_config() 接口配置输入源。
+ * @note
+ * 1. 调用该接口前，先使用 jdec_config() 接口配置输入源；
+ * 2. jinfo_ptr->jst_peak 为 按文件头信息 预测的 解码峰值内存（字节），
+ *    取 各种有效的输出色彩空间（1/1 尺寸）中的 最大值，已计入 jdec_config_memory()
+ *    的内存上限；包括 libjpeg 的工作缓存（渐进式 或 多扫描 图像 为整幅的 DCT 系数缓存），
+ *    不包括 调用方提供的 输出像素缓存；jdec_start() 会按 实际的输出色彩空间 重新预测。
  * 
  * @param [in ] jdec_this : JPEG 解码操作的上下文对象。
  * @param [out] jinfo_ptr : 操作成功返回的 JPEG 图像信息。
@@ -252,7 +321,9 @@ j_int_t jdec_info(
  * 1. 无论 jdec_start() 操作是否成功，
  *    只要 (JPEG_CS_UNKNOWN != jinfo_ptr->jcs_type)，
  *    则说明读取到了 JPEG 图像基本信息；
- * 2. 若入参时为 J_NULL，则忽略读取图像基本信息。
+ * 2. 若入参时为 J_NULL，则忽略读取图像基本信息；
+ * 3. jinfo_ptr->jst_peak 为 按 jcs_conv 预测的 峰值内存，超出 jdec_config_budget()
+ *    的预算时，不启动解码器，返回 JDEC_ERR_BUDGET。
  * 
  * @return j_int_t : 错误码，请参看 jdec_errno_t 相关枚举值。
  */
@@ -294,6 +365,21 @@ j_int_t jdec_read(
  */
 j_int_t jdec_finish(jdec_this_t jdec_this);
 
+/**********************************************************/
+/**
+ * @brief 中止 JPEG 解码操作（不再读取其余的像素行）。
+ * @note
+ * 1. 只需要图像的前若干像素行时（例如 区域剪切），读完所需的像素行后，
+ *    调用该接口代替 jdec_finish() 关闭解码器，其后的像素行 不再解码；
+ * 2. 所需像素行之前的像素行，可用 jit_step 为 0 的 jdec_read() 读至
+ *    同一个像素行缓存后丢弃。
+ * 
+ * @param [in ] jdec_this : JPEG 解码操作的上下文对象。
+ * 
+ * @return j_int_t : 错误码，请参看 jdec_errno_t 相关枚举值。
+ */
+j_int_t jdec_abort(jdec_this_t jdec_this);
+
 /**********************************************************/
 /**
  * @brief 对整幅 JPEG 图像进行 解码操作。
@@ -318,6 +404,72 @@ j_int_t jdec_image(
             j_int_t     jit_step,
             jinfo_ptr_t jinfo_ptr);
 
+/**********************************************************/
+/**
+ * @brief 只解码 JPEG 图像中 [jut_ypos, jut_ypos + jut_rows) 范围内的像素行。
+ * @note
+ * 1. 调用该接口前，应先使用 jdec_config() 配置好输入源模式；
+ * 2. jut_ypos 之前的像素行，解码至 jmt_pxls 的首行后丢弃（不需要额外的缓存），
+ *    读完最后一个所需的像素行后，即中止解码器，其后的像素行 不再解码；
+ *    但 渐进式（progressive）图像，在启动解码器时 就已读入全部扫描数据；
+ * 3. jmt_pxls 只需容纳 jut_rows 个像素行，其首行对应于图像的第 jut_ypos 行；
+ * 4. 范围超出图像高度时，只解码至图像的最后一行。
+ * 
+ * @param [in ] jdec_this : JPEG 解码操作的上下文对象。
+ * @param [in ] jcs_conv  : JPEG 解码输出的像素（色彩空间）格式。
+ * @param [in ] jut_ypos  : 解码输出的 起始像素行。
+ * @param [in ] jut_rows  : 解码输出的 像素行数量。
+ * @param [out] jmt_pxls  : JPEG 解码输出的像素缓存（注意，其大小必须 足够大）。
+ * @param [in ] jit_step  : 遍历像素行时的 步长值（以 字节 为单位）。
+ * @param [out] jinfo_ptr : 操作返回的 JPEG 图像源基本信息（可传入 J_NULL 忽略返回）。
+ * 
+ * @return j_int_t : 
+ * - 返回值 <  0，表示操作失败，产生错误返回的 错误码，请参看 jdec_errno_t 相关枚举值。
+ * - 返回值 >= 0，表示读取的图像像素行数量。
+ */
+j_int_t jdec_rows(
+            jdec_this_t jdec_this,
+            jctl_cs_t   jcs_conv,
+            j_uint_t    jut_ypos,
+            j_uint_t    jut_rows,
+            j_mptr_t    jmt_pxls,
+            j_int_t     jit_step,
+            jinfo_ptr_t jinfo_ptr);
+
+/**********************************************************/
+/**
+ * @brief 只执行一次熵解码，同时输出多个缩放尺寸（1/1、1/2、1/4、1/8）的图像。
+ * @note
+ * 1. 调用该接口前，应先使用 jdec_config() 配置好输入源模式，
+ *    文件流模式 与 文件模式 时，会先将全部输入数据读入内存；
+ * 2. 熵解码只执行一次，各个缩放输出共享其 DCT 系数，再分别执行 libjpeg 的
+ *    缩放 IDCT、上采样 与 色彩转换，输出结果 与 常规的缩放解码 逐字节相同；
+ * 3. 每个缩放输出 作为一个任务，由 jthrd_parallel() 并行执行；
+ * 4. 输出图像的尺寸，可使用 jdec_scaled_size() 预先计算；
+ * 5. jdec_config_memory() 的内存上限 分别作用于 熵解码器 与 各个缩放输出的解码器，
+ *    超出上限的 DCT 系数缓存 换出至临时文件（参看 jdec_config_memory() 的说明）；
+ * 6. jinfo_ptr->jst_peak 为 熵解码器 与 全部缩放输出 合计的 预测峰值内存（已计入 内存上限），
+ *    超出 jdec_config_budget() 的预算时，在 熵解码 之前 返回 JDEC_ERR_BUDGET。
+ * 
+ * @param [in ] jdec_this : JPEG 解码操作的上下文对象（只提供输入源配置）。
+ * @param [in ] jcs_conv  : JPEG 解码输出的像素（色彩空间）格式。
+ * @param [in,out] jrung_arr : 各个缩放输出的描述信息数组。
+ * @param [in ] jut_nrung : 缩放输出的数量。
+ * @param [in ] jut_nthd  : 工作线程数量（为 0 时，取 jthrd_ncpus() 的值）。
+ * @param [out] jinfo_ptr : 操作返回的 JPEG 图像源基本信息（可传入 J_NULL 忽略返回）。
+ * 
+ * @return j_int_t :
+ * - 返回值 >= 0，表示执行成功的缩放输出数量；
+ * - 返回值 <  0，表示 错误码，参看 jdec_errno_t 相关枚举值。
+ */
+j_int_t jdec_ladder(
+            jdec_this_t   jdec_this,
+            jctl_cs_t     jcs_conv,
+            jdec_rung_t * jrung_arr,
+            j_uint_t      jut_nrung,
+            j_uint_t      jut_nthd,
+            jinfo_ptr_t   jinfo_ptr);
+
 ////////////////////////////////////////////////////////////////////////////////
 
 #ifdef __cplusplus
@@ -372,6 +524,26 @@ public:
         return jdec_config(m_jdec_this, jct_mode, jfh_iptr, jst_mlen);
     }
 
+    /**********************************************************/
+    /**
+     * @brief 设置 解码器 可使用的内存上限（以 字节 为单位，0 表示 不设上限）。
+     * @note  详情请参看 jdec_config_memory() 的说明。
+     */
+    inline j_int_t config_memory(j_size_t jst_mmax)
+    {
+        return jdec_config_memory(m_jdec_this, jst_mmax);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 设置 解码操作的 内存预算（以 字节 为单位，0 表示 不作限制）。
+     * @note  详情请参看 jdec_config_budget() 的说明。
+     */
+    inline j_int_t config_budget(j_size_t jst_mbud)
+    {
+        return jdec_config_budget(m_jdec_this, jst_mbud);
+    }
+
     /**********************************************************/
     /**
      * @brief 读取 JPEG 图像信息。
@@ -415,6 +587,16 @@ public:
         return jdec_finish(m_jdec_this);
     }
 
+    /**********************************************************/
+    /**
+     * @brief 中止 JPEG 解码操作（不再读取其余的像素行）。
+     * @note  详情请参看 jdec_abort() 的说明。
+     */
+    inline j_int_t abort(void)
+    {
+        return jdec_abort(m_jdec_this);
+    }
+
     /**********************************************************/
     /**
      * @brief 对整幅 JPEG 图像进行 解码操作。
@@ -434,6 +616,50 @@ public:
                     jinfo_ptr);
     }
 
+    /**********************************************************/
+    /**
+     * @brief 只解码 JPEG 图像中 [jut_ypos, jut_ypos + jut_rows) 范围内的像素行。
+     * @note  详情请参看 jdec_rows() 的说明。
+     */
+    inline j_int_t decode_rows(
+                jctl_cs_t   jcs_conv,
+                j_uint_t    jut_ypos,
+                j_uint_t    jut_rows,
+                j_mptr_t    jmt_pxls,
+                j_int_t     jit_step,
+                jinfo_ptr_t jinfo_ptr = J_NULL)
+    {
+        return jdec_rows(
+                    m_jdec_this,
+                    jcs_conv,
+                    jut_ypos,
+                    jut_rows,
+                    jmt_pxls,
+                    jit_step,
+                    jinfo_ptr);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 只执行一次熵解码，同时输出多个缩放尺寸的图像。
+     * @note  详情请参看 jdec_ladder() 的说明。
+     */
+    inline j_int_t decode_ladder(
+                jctl_cs_t     jcs_conv,
+                jdec_rung_t * jrung_arr,
+                j_uint_t      jut_nrung,
+                j_uint_t      jut_nthd  = 0,
+                jinfo_ptr_t   jinfo_ptr = J_NULL)
+    {
+        return jdec_ladder(
+                    m_jdec_this,
+                    jcs_conv,
+                    jrung_arr,
+                    jut_nrung,
+                    jut_nthd,
+                    jinfo_ptr);
+    }
+
     // data members
 private:
     jdec_this_t m_jdec_this; ///< JPEG 解码操作的上下文对象
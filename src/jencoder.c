@@ -10,10 +10,15 @@
 
 #include "jcomm.h"
 #include "jencoder.h"
+#include "jthread.h"
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 
+// 捕获 DCT 系数时，需要替换 libjpeg 内部的 熵编码 接口
+#define JPEG_INTERNALS
 #include "jcomm.inl"
+#include "jdct.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // JPEG 编码器 相关常量与数据类型
@@ -27,6 +32,26 @@
 /** 每次编码写入像素行数量 的 默认值 */
 #define JENC_DEF_WROWS      16
 
+/** 并行编码时，每个条带所包含 MCU 行数量 的 默认值 */
+#define JENC_DEF_SROWS      8
+
+/** 捕获 DCT 系数时，哑输出目标 的缓存大小 */
+#define JENC_NULL_DEST_SIZE 4096
+
+/**
+ * 搜索目标字节数时，ln(输出字节数) 对 ln(量化表缩放比例) 的 预估斜率
+ * （仅有上限值的尝试结果时使用，之后按实际尝试结果 割线插值）
+ */
+#define JENC_TSIZE_SLOPE    (-0.7)
+
+/** JPEG 标记码：SOF0 ~ SOF2、DRI、SOS、RST0、EOI */
+#define JENC_MARKER_SOF0    0xC0
+#define JENC_MARKER_SOF2    0xC2
+#define JENC_MARKER_DRI     0xDD
+#define JENC_MARKER_SOS     0xDA
+#define JENC_MARKER_RST0    0xD0
+#define JENC_MARKER_EOI     0xD9
+
 /** 重定义 libjpeg 中的 JPEG 编码器结构体 名称 */
 typedef struct jpeg_compress_struct  jenc_obj_t;
 
@@ -42,7 +67,9 @@ typedef struct jenc_ctx_t
     jenc_obj_t      jenc_obj;  ///< JPEG 编码器 操作对象
 
     j_int_t         jit_qual;  ///< JPEG 编码的压缩质量（1 - 100）
+    jenc_param_t    jparam;    ///< 压缩质量 之外的 JPEG 编码参数（参看 jenc_config_param()）
     j_bool_t        jbl_work;  ///< JPEG 编码器是否处于工作状态
+    jctl_mode_t     jct_dest;  ///< libjpeg 当前输出目标管理对象 所对应的输出模式
 
     /**
      * @brief 编码输出源模式的相关工作参数。
@@ -96,6 +123,92 @@ typedef struct jenc_ctx_t
     } jbuff;
 } jenc_ctx_t;
 
+/**
+ * @struct jenc_stripe_t
+ * @brief  并行编码时，单个条带的编码结果。
+ */
+typedef struct jenc_stripe_t
+{
+    j_int_t         jit_err;   ///< 条带编码的错误码
+    j_size_t        jst_size;  ///< 条带编码得到的 JPEG 数据流 字节数
+    j_mptr_t        jmt_data;  ///< 条带编码得到的 JPEG 数据流（完整的 JPEG 图像）
+} jenc_stripe_t;
+
+/**
+ * @struct jenc_mtctx_t
+ * @brief  并行编码时，各个工作线程共享的任务上下文。
+ */
+typedef struct jenc_mtctx_t
+{
+    jenc_ccs_t      jccs_conv; ///< 色彩空间的转换方式
+    j_mptr_t        jmt_pxls;  ///< 图像的像素缓存
+    j_int_t         jit_step;  ///< 遍历像素行时的 步长值
+    j_uint_t        jut_imgw;  ///< 图像宽度
+    j_uint_t        jut_imgh;  ///< 图像高度
+    j_uint_t        jut_qual;  ///< 编码压缩质量
+    j_uint_t        jut_prow;  ///< 每个条带的像素行数量（MCU 行高度的整数倍）
+    jenc_param_t    jparam;    ///< 各个条带使用的编码参数（只含 采样因子）
+
+    jenc_this_t     jenc_arr[JTHRD_MAX_WORKERS]; ///< 各个工作线程的编码器
+    jenc_stripe_t * jstripes;  ///< 各个条带的编码结果
+} jenc_mtctx_t;
+
+/**
+ * @struct jenc_coef_t
+ * @brief  
+ * 捕获得到的 未量化 DCT 系数（libjpeg 正向 DCT 的原始输出，放大了 8 或 16 倍），
+ * 可按不同的压缩质量 重新量化，只执行熵编码，即可得到相应的 JPEG 数据流。
+ */
+typedef struct jenc_coef_t
+{
+    jenc_ccs_t      jccs_conv; ///< 色彩空间的转换方式
+    j_uint_t        jut_imgw;  ///< 图像宽度
+    j_uint_t        jut_imgh;  ///< 图像高度
+    j_uint_t        jut_ncomp; ///< 颜色分量数量
+    j_uint_t        jut_nmcu;  ///< 捕获过程中，已接收的 MCU 数量
+
+    /**
+     * @brief 各个颜色分量的 DCT 块数组（jut_bh 行 × jut_bw 列，自然顺序存储）。
+     */
+    struct
+    {
+        j_uint_t    jut_bw;    ///< 水平方向的 DCT 块数量
+        j_uint_t    jut_bh;    ///< 垂直方向的 DCT 块数量
+        j_uint_t    jut_qsft;  ///< 量化除数 = 量化表值 << jut_qsft（即 DCT 的放大倍数）
+        j_uint_t    jut_hsmp;  ///< 水平采样因子
+        j_uint_t    jut_vsmp;  ///< 垂直采样因子
+        JBLOCKROW   jblk_ptr;  ///< DCT 块数组
+    } jcomp[MAX_COMPONENTS];
+
+    /**
+     * @brief 捕获过程中，丢弃 JPEG 头部等输出数据的 哑输出目标。
+     */
+    struct jpeg_destination_mgr jdst_mgr;
+    JOCTET          jdst_buff[JENC_NULL_DEST_SIZE];
+} jenc_coef_t;
+
+/**
+ * @struct jenc_bwork_t
+ * @brief  批量编码时，单个工作线程可重复使用的工作对象。
+ */
+typedef struct jenc_bwork_t
+{
+    jenc_this_t     jenc_this; ///< 工作线程的编码器
+    j_size_t        jst_bcap;  ///< 内存模式的输出缓存容量
+    j_mptr_t        jmt_buff;  ///< 内存模式的输出缓存
+} jenc_bwork_t;
+
+/**
+ * @struct jenc_bctx_t
+ * @brief  批量编码时，各个工作线程共享的任务上下文。
+ */
+typedef struct jenc_bctx_t
+{
+    jenc_job_t        * jjob_arr;  ///< 编码任务数组
+    const jenc_coef_t * jcoef_ptr; ///< 质量阶梯编码时，各任务共享的 DCT 系数
+    jenc_bwork_t        jwork_arr[JTHRD_MAX_WORKERS]; ///< 各个工作线程的工作对象
+} jenc_bctx_t;
+
 ////////////////////////////////////////////////////////////////////////////////
 // JPEG 编码器 内部接口函数
 
@@ -161,6 +274,177 @@ static inline j_int_t jenc_grow_rows(jenc_this_t jenc_this, j_uint_t jut_rlow)
     return JENC_ERR_OK;
 }
 
+/**********************************************************/
+/**
+ * @brief 按 jenc_config() 所配置的输出模式，设置 libjpeg 编码器的输出目标。
+ * @note  调用前，须已设置好 错误回调跳转代码（setjmp）。
+ * 
+ * @param [in ] jenc_this : JPEG 编码操作的上下文对象。
+ * 
+ * @return j_int_t : 错误码，请参看 jenc_errno_t 相关枚举值。
+ */
+static j_int_t jenc_setup_dest(jenc_this_t jenc_this)
+{
+    jenc_obj_t * jenc_ptr = &jenc_this->jenc_obj;
+
+    // libjpeg 的 内存输出 与 文件输出 管理对象的大小不同，两者不可交替重用
+    if ((J_NULL != jenc_ptr->dest) &&
+        ((JCTL_MODE_FMEMORY == jenc_this->jct_dest) !=
+         (JCTL_MODE_FMEMORY == jenc_this->jmode.jct_mode)))
+    {
+        jenc_ptr->dest = J_NULL;
+    }
+
+    jenc_this->jct_dest = jenc_this->jmode.jct_mode;
+
+    if (JCTL_MODE_FMEMORY == jenc_this->jmode.jct_mode)
+    {
+        if (J_NULL != jenc_this->jbuff.jmt_mptr)
+        {
+            free(jenc_this->jbuff.jmt_mptr);
+        }
+
+        jenc_this->jbuff.jst_size = jenc_this->jmode.jst_mlen;
+        jenc_this->jbuff.jmt_mptr = jenc_this->jmode.jmt_optr;
+
+        jpeg_mem_dest(
+            jenc_ptr,
+            &jenc_this->jbuff.jmt_mptr,
+            &jenc_this->jbuff.jst_size);
+    }
+    else if (JCTL_MODE_FSTREAM == jenc_this->jmode.jct_mode)
+    {
+        if (J_NULL == jenc_this->jmode.jfs_ostr)
+        {
+            return JENC_ERR_FSTREAM_ISNULL;
+        }
+
+        fgetpos(jenc_this->jmode.jfs_ostr, &jenc_this->jmode.jfp_spos);
+        jpeg_stdio_dest(jenc_ptr, jenc_this->jmode.jfs_ostr);
+    }
+    else if (JCTL_MODE_FSZPATH == jenc_this->jmode.jct_mode)
+    {
+        if ((J_NULL == jenc_this->jmode.jsz_path) ||
+            ('\0' == jenc_this->jmode.jsz_path[0]))
+        {
+            return JENC_ERR_FSZPATH_ISNULL;
+        }
+
+        jenc_this->jmode.jfs_file = 
+            fopen((j_fszpath_t)jenc_this->jmode.jsz_path, "wb+");
+        if (J_NULL == jenc_this->jmode.jfs_file)
+        {
+            return JENC_ERR_FOPEN;
+        }
+
+        jpeg_stdio_dest(jenc_ptr, jenc_this->jmode.jfs_file);
+    }
+    else
+    {
+        return JENC_ERR_UNCONFIG;
+    }
+
+    return JENC_ERR_OK;
+}
+
+/**********************************************************/
+/**
+ * @brief 设置 libjpeg 编码器的图像尺寸、色彩空间 以及 压缩质量 等参数。
+ * @note  调用前，须已设置好 错误回调跳转代码（setjmp）。
+ * 
+ * @param [in ] jenc_ptr  : libjpeg 编码器对象。
+ * @param [in ] jccs_conv : 色彩空间的转换方式（参看 jenc_ccs_t）。
+ * @param [in ] jut_imgw  : 图像宽度。
+ * @param [in ] jut_imgh  : 图像高度。
+ * @param [in ] jit_qual  : 压缩质量（1 - 100）。
+ * @param [in ] jparam_ptr: 编码参数（只使用其中的 采样因子；为 J_NULL 时，取默认值）。
+ */
+static j_void_t jenc_setup_params(
+                    jenc_obj_t         * jenc_ptr,
+                    jenc_ccs_t           jccs_conv,
+                    j_uint_t             jut_imgw,
+                    j_uint_t             jut_imgh,
+                    j_int_t              jit_qual,
+                    const jenc_param_t * jparam_ptr)
+{
+    // 参数验证阶段，可保证 以下断言代码不会被触发
+    JASSERT(JCS_UNKNOWN != jcs_to_lib(JENC_CCS_IN(jccs_conv)));
+    JASSERT(JCS_UNKNOWN != jcs_to_lib(JENC_CCS_OUT(jccs_conv)));
+
+    jenc_ptr->image_width  = (j_int_t)jut_imgw;
+    jenc_ptr->image_height = (j_int_t)jut_imgh;
+
+    // 配置 JPEG 编码输入的色彩空间及通道数量
+    jenc_ptr->input_components = JENC_CCS_NUMC(jccs_conv);
+    jenc_ptr->in_color_space   = jcs_to_lib(JENC_CCS_IN(jccs_conv));
+
+    jpeg_set_defaults(jenc_ptr);
+    jpeg_set_quality(jenc_ptr, jit_qual, J_TRUE);
+
+    // 配置 JPEG 编码输出的色彩空间
+    jpeg_set_colorspace(jenc_ptr, jcs_to_lib(JENC_CCS_OUT(jccs_conv)));
+
+    //======================================
+    // 亮度分量（以及 YCCK 的 K 分量）的采样因子，色度分量固定为 1
+
+    if ((J_NULL == jparam_ptr) ||
+        ((JENC_PARAM_DEFAULT == jparam_ptr->jit_hsamp) &&
+         (JENC_PARAM_DEFAULT == jparam_ptr->jit_vsamp)))
+    {
+        return;
+    }
+
+    if ((JCS_YCbCr  == jenc_ptr->jpeg_color_space) ||
+        (JCS_BG_YCC == jenc_ptr->jpeg_color_space) ||
+        (JCS_YCCK   == jenc_ptr->jpeg_color_space))
+    {
+        jenc_ptr->comp_info[0].h_samp_factor =
+            (JENC_PARAM_DEFAULT == jparam_ptr->jit_hsamp) ? 2 : jparam_ptr->jit_hsamp;
+        jenc_ptr->comp_info[0].v_samp_factor =
+            (JENC_PARAM_DEFAULT == jparam_ptr->jit_vsamp) ? 2 : jparam_ptr->jit_vsamp;
+
+        if (JCS_YCCK == jenc_ptr->jpeg_color_space)
+        {
+            jenc_ptr->comp_info[3].h_samp_factor = jenc_ptr->comp_info[0].h_samp_factor;
+            jenc_ptr->comp_info[3].v_samp_factor = jenc_ptr->comp_info[0].v_samp_factor;
+        }
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 设置 libjpeg 编码器的扫描模式、重启间隔 以及 哈夫曼表优化 等参数。
+ * @note  须在 jenc_setup_params() 之后调用（jpeg_set_defaults() 会重置这些参数）。
+ * 
+ * @param [in ] jenc_ptr  : libjpeg 编码器对象。
+ * @param [in ] jparam_ptr: 编码参数（为 J_NULL 时，取默认值）。
+ */
+static j_void_t jenc_setup_scans(
+                    jenc_obj_t         * jenc_ptr,
+                    const jenc_param_t * jparam_ptr)
+{
+    if (J_NULL == jparam_ptr)
+    {
+        return;
+    }
+
+    if (1 == jparam_ptr->jit_prog)
+    {
+        jpeg_simple_progression(jenc_ptr);
+    }
+
+    if (jparam_ptr->jit_rrows > 0)
+    {
+        jenc_ptr->restart_interval = 0;
+        jenc_ptr->restart_in_rows  = jparam_ptr->jit_rrows;
+    }
+
+    if (jparam_ptr->jbl_optim)
+    {
+        jenc_ptr->optimize_coding = J_TRUE;
+    }
+}
+
 /**********************************************************/
 /**
  * @brief 关闭编码器工作。
@@ -177,7 +461,7 @@ static j_void_t jenc_shutdown(jenc_this_t jenc_this)
     }
     else if (JCTL_MODE_FSTREAM == jenc_this->jmode.jct_mode)
     {
-        jenc_this->jmode.jfp_spos = 0;
+        memset(&jenc_this->jmode.jfp_spos, 0, sizeof(j_fpos_t));
     }
     else if (JCTL_MODE_FSZPATH == jenc_this->jmode.jct_mode)
     {
@@ -193,261 +477,1744 @@ static j_void_t jenc_shutdown(jenc_this_t jenc_this)
     jenc_this->jbl_work = J_FALSE;
 }
 
-////////////////////////////////////////////////////////////////////////////////
-// JPEG 编码器 外部接口函数
-
 /**********************************************************/
 /**
- * @brief 申请 JPEG 编码操作的上下文对象。
+ * @brief 按 jenc_start() 相同的编码参数，计算 MCU 的尺寸（以像素为单位）。
+ * @note  setjmp 只置于此函数内，调用方（jenc_image_mt()）的局部变量
+ *        不会受到 longjmp 的影响。
  * 
- * @param [in ] jvt_reserved : 保留参数（当前使用 J_NULL 即可）。
+ * @param [in ] jenc_this : JPEG 编码操作的上下文对象。
+ * @param [in ] jccs_conv : 色彩空间的转换方式（参看 jenc_ccs_t）。
+ * @param [in ] jut_imgw  : 图像宽度。
+ * @param [in ] jut_imgh  : 图像高度。
+ * @param [out] jut_mcuw  : 操作成功返回的 MCU 宽度。
+ * @param [out] jut_mcuh  : 操作成功返回的 MCU 高度。
  * 
- * @return jenc_this_t :
- * 返回 JPEG 编码操作的上下文对象，为 J_NULL 时表示申请失败。
+ * @return j_int_t : 错误码（JENC_ERR_OK 或 JENC_ERR_EXCEPTION）。
  */
-jenc_this_t jenc_alloc(j_void_t * jvt_reserved)
+static j_int_t jenc_mcu_size(
+                    jenc_this_t jenc_this,
+                    jenc_ccs_t  jccs_conv,
+                    j_uint_t    jut_imgw,
+                    j_uint_t    jut_imgh,
+                    j_uint_t  * jut_mcuw,
+                    j_uint_t  * jut_mcuh)
 {
-    jenc_this_t jenc_this = (jenc_this_t)calloc(1, sizeof(jenc_ctx_t));
-    if (J_NULL == jenc_this)
+    jenc_obj_t * jenc_ptr = &jenc_this->jenc_obj;
+    j_int_t      jit_iter = 0;
+    j_int_t      jit_mcuw = 1;
+    j_int_t      jit_mcuh = 1;
+
+    if (0 != setjmp(jenc_this->jerr_mgr.jerr_jmp))
     {
-        return J_NULL;
+        jpeg_abort_compress(jenc_ptr);
+        return JENC_ERR_EXCEPTION;
     }
 
-    //======================================
-
-    jenc_this->jut_size = sizeof(jenc_ctx_t);
-    jenc_this->jut_type = JENC_HANDLE_TYPE;
-    jenc_this->jit_qual = JENC_DEF_QUALITY;
-    jenc_this->jbl_work = J_FALSE;
-
-    jenc_this->jmode.jct_mode = JCTL_MODE_UNKNOWN;
-    jenc_this->jmode.jst_mlen = 0;
-    jenc_this->jmode.jmt_optr = J_NULL;
-
-    jenc_this->jpath.jst_size = 0;
-    jenc_this->jpath.jsz_path = J_NULL;
-
-    jenc_this->jrows.jut_size = 0;
-    jenc_this->jrows.jar_rows = J_NULL;
-
-    jenc_this->jbuff.jst_size = 0;
-    jenc_this->jbuff.jmt_mptr = J_NULL;
+    jenc_setup_params(
+        jenc_ptr, jccs_conv, jut_imgw, jut_imgh, jenc_this->jit_qual, &jenc_this->jparam);
 
-    jenc_this->jenc_obj.err =
-        jpeg_std_error(&jenc_this->jerr_mgr.jerr_mgr);
-    jenc_this->jerr_mgr.jerr_mgr.error_exit = jerr_exit_callback;
+    // 单通道图像的扫描为 非交错 模式，MCU 为单个 DCT 块
+    if (1 != jenc_ptr->num_components)
+    {
+        for (jit_iter = 0; jit_iter < jenc_ptr->num_components; ++jit_iter)
+        {
+            if (jit_mcuw < jenc_ptr->comp_info[jit_iter].h_samp_factor)
+                jit_mcuw = jenc_ptr->comp_info[jit_iter].h_samp_factor;
+            if (jit_mcuh < jenc_ptr->comp_info[jit_iter].v_samp_factor)
+                jit_mcuh = jenc_ptr->comp_info[jit_iter].v_samp_factor;
+        }
+    }
 
-    jpeg_create_compress(&jenc_this->jenc_obj);
+    *jut_mcuw = (j_uint_t)(jit_mcuw * jenc_ptr->block_size);
+    *jut_mcuh = (j_uint_t)(jit_mcuh * jenc_ptr->block_size);
 
-    //======================================
+    jpeg_abort_compress(jenc_ptr);
 
-    return jenc_this;
+    return JENC_ERR_OK;
 }
 
 /**********************************************************/
 /**
- * @brief 释放 JPEG 编码操作的上下文对象。
+ * @brief 并行编码的条带任务：将第 jut_tidx 个条带编码成独立的 JPEG 数据流。
  */
-j_void_t jenc_release(jenc_this_t jenc_this)
+static j_void_t jenc_stripe_task(
+                    j_void_t * jvt_ctxt,
+                    j_uint_t   jut_widx,
+                    j_uint_t   jut_tidx)
 {
-    if (jenc_valid(jenc_this))
+    jenc_mtctx_t  * jmtctx_ptr = (jenc_mtctx_t *)jvt_ctxt;
+    jenc_stripe_t * jstrip_ptr = &jmtctx_ptr->jstripes[jut_tidx];
+    jenc_this_t     jenc_this  = jmtctx_ptr->jenc_arr[jut_widx];
+    j_uint_t        jut_line   = jut_tidx * jmtctx_ptr->jut_prow;
+    j_uint_t        jut_rows   = jmtctx_ptr->jut_imgh - jut_line;
+
+    if (jut_rows > jmtctx_ptr->jut_prow)
+        jut_rows = jmtctx_ptr->jut_prow;
+
+    //======================================
+    // 每个工作线程使用各自的编码器，并在其上重复编码多个条带
+
+    if (J_NULL == jenc_this)
     {
-        jpeg_destroy_compress(&jenc_this->jenc_obj);
+        jenc_this = jenc_alloc(J_NULL);
+        if (J_NULL == jenc_this)
+        {
+            jstrip_ptr->jit_err = JENC_ERR_MALLOC;
+            return;
+        }
 
-        if (J_NULL != jenc_this->jpath.jsz_path)
-            free(jenc_this->jpath.jsz_path);
+        jmtctx_ptr->jenc_arr[jut_widx] = jenc_this;
+    }
 
-        if (J_NULL != jenc_this->jrows.jar_rows)
-            free(jenc_this->jrows.jar_rows);
+    jstrip_ptr->jit_err = jenc_config(
+                            jenc_this,
+                            JCTL_MODE_FMEMORY,
+                            J_NULL,
+                            0,
+                            jmtctx_ptr->jut_qual);
+    if (JENC_ERR_OK == jstrip_ptr->jit_err)
+    {
+        jstrip_ptr->jit_err = jenc_config_param(jenc_this, &jmtctx_ptr->jparam);
+    }
 
-        if (J_NULL != jenc_this->jbuff.jmt_mptr)
-            free(jenc_this->jbuff.jmt_mptr);
+    if (JENC_ERR_OK != jstrip_ptr->jit_err)
+    {
+        return;
+    }
 
-        free(jenc_this);
+    jstrip_ptr->jit_err = jenc_image(
+                            jenc_this,
+                            jmtctx_ptr->jccs_conv,
+                            jmtctx_ptr->jmt_pxls +
+                                (j_long_t)jut_line * jmtctx_ptr->jit_step,
+                            jmtctx_ptr->jit_step,
+                            jmtctx_ptr->jut_imgw,
+                            jut_rows);
+    if (jstrip_ptr->jit_err < 0)
+    {
+        return;
     }
+
+    // 接管编码器内部缓存中的 JPEG 数据流，避免数据拷贝
+    jstrip_ptr->jit_err  = JENC_ERR_OK;
+    jstrip_ptr->jst_size = jenc_this->jbuff.jst_size;
+    jstrip_ptr->jmt_data = jenc_this->jbuff.jmt_mptr;
+
+    jenc_this->jbuff.jst_size = 0;
+    jenc_this->jbuff.jmt_mptr = J_NULL;
 }
 
 /**********************************************************/
 /**
- * @brief JPEG 编码操作句柄的有效判断。
+ * @brief 在条带编码得到的 JPEG 数据流中，定位 SOF 标记、SOS 标记 以及
+ *        熵编码数据段 的起始偏移位置。
+ * 
+ * @param [in ] jmt_data : JPEG 数据流。
+ * @param [in ] jst_size : JPEG 数据流的字节数。
+ * @param [out] jst_osof : 返回 SOF 标记的偏移位置（J_NULL 时忽略）。
+ * @param [out] jst_osos : 返回 SOS 标记的偏移位置（J_NULL 时忽略）。
+ * @param [out] jst_oecs : 返回 熵编码数据段 的偏移位置。
+ * 
+ * @return j_bool_t : 数据流格式不符合预期时，返回 J_FALSE 。
  */
-j_bool_t jenc_valid(jenc_this_t jenc_this)
+static j_bool_t jenc_stripe_parse(
+                    j_mptr_t   jmt_data,
+                    j_size_t   jst_size,
+                    j_size_t * jst_osof,
+                    j_size_t * jst_osos,
+                    j_size_t * jst_oecs)
 {
-    if (J_NULL == jenc_this)
-    {
-        return J_FALSE;
-    }
+    j_size_t jst_iter = 2;
+    j_size_t jst_mlen = 0;
 
-    if (sizeof(jenc_ctx_t) != jenc_this->jut_size)
+    // 数据流以 SOI 开始，以 EOI 结束
+    if ((jst_size < 4) || (0xFF != jmt_data[0]) || (0xD8 != jmt_data[1]) ||
+        (0xFF != jmt_data[jst_size - 2]) ||
+        (JENC_MARKER_EOI != jmt_data[jst_size - 1]))
     {
         return J_FALSE;
     }
 
-    if (JENC_HANDLE_TYPE != jenc_this->jut_type)
+    while (jst_iter + 4 <= jst_size)
     {
-        return J_FALSE;
+        if (0xFF != jmt_data[jst_iter])
+        {
+            return J_FALSE;
+        }
+
+        jst_mlen = ((j_size_t)jmt_data[jst_iter + 2] << 8) |
+                    (j_size_t)jmt_data[jst_iter + 3];
+
+        if ((jmt_data[jst_iter + 1] >= JENC_MARKER_SOF0) &&
+            (jmt_data[jst_iter + 1] <= JENC_MARKER_SOF2) &&
+            (J_NULL != jst_osof))
+        {
+            *jst_osof = jst_iter;
+        }
+
+        if (JENC_MARKER_SOS == jmt_data[jst_iter + 1])
+        {
+            if (J_NULL != jst_osos)
+                *jst_osos = jst_iter;
+            *jst_oecs = jst_iter + 2 + jst_mlen;
+            return (*jst_oecs <= jst_size - 2);
+        }
+
+        jst_iter += 2 + jst_mlen;
     }
 
-    return J_TRUE;
+    return J_FALSE;
 }
 
 /**********************************************************/
 /**
- * @brief 执行 JPEG 编码工作前，配置相关工作参数（目标输出模式 等）。
+ * @brief 将各个条带的 JPEG 数据流，拼接成一个带 重启间隔（DRI）的 JPEG 数据流。
  * @note
- * 1. jct_mode == JCTL_MODE_FMEMORY, typeof(jht_optr) == j_fmemory_t;
- *    内存模式，即编码压缩后的数据，输出至指定的缓存，
- *    若 ((J_NULL == jht_optr) || (0 == jst_mlen))，或者压缩过程中，指定缓存
- *    大小不足，则取内部自动分配缓存，使用 jenc_fmdata() 和 jenc_fmsize()
- *    两个接口获得这些压缩数据信息。
- * 2. jct_mode == JCTL_MODE_FSTREAM, typeof(jht_optr) == j_fstream_t;
- *    文件流模式，即编码压缩后的数据，输出至指定的文件流中。
- * 3. jct_mode == JCTL_MODE_FSZPATH, typeof(jht_optr) == j_fszpath_t;
- *    文件模式，即编码压缩后的数据，输出至指定路径的外部文件中。
+ * 以第一个条带的 头部信息 为准，修正 SOF 中的图像高度，在 SOS 前插入 DRI 标记，
+ * 各个条带的熵编码数据段之间，依次插入 RST0 ~ RST7 标记，最后以 EOI 结束。
  * 
- * @param [in ] jenc_this : JPEG 编码操作的上下文对象。
- * @param [in ] jct_mode  : JPEG 编码输出模式（参看 jctl_mode_t ）。
- * @param [in ] jht_optr  : 指向目标输出的操作对象。
- * @param [in ] jst_mlen  : 只针对于 内存模式，表示目标输出缓存的容量（按字节计）。
- * @param [in ] jut_qual  : JPEG 编码压缩数据的质量（1 - 100，为 0 时，取默认值）。
+ * @param [in ] jstripes : 各个条带的编码结果。
+ * @param [in ] jut_nstr : 条带数量。
+ * @param [in ] jut_imgh : 图像高度。
+ * @param [in ] jut_rsti : 重启间隔（MCU 数量）。
+ * @param [in ] jmt_optr : 拼接输出的缓存（为 J_NULL 时，只计算所需的字节数）。
  * 
- * @return j_int_t : 错误码，请参看 jenc_errno_t 相关枚举值。
+ * @return j_size_t : 拼接输出的字节数，返回 0 表示 条带数据流格式有误。
  */
-j_int_t jenc_config(
-                jenc_this_t jenc_this,
-                jctl_mode_t jct_mode,
-                j_fhandle_t jht_optr,
-                j_size_t    jst_mlen,
-                j_uint_t    jut_qual)
+static j_size_t jenc_stripe_join(
+                    jenc_stripe_t * jstripes,
+                    j_uint_t        jut_nstr,
+                    j_uint_t        jut_imgh,
+                    j_uint_t        jut_rsti,
+                    j_mptr_t        jmt_optr)
 {
-    JASSERT(jenc_valid(jenc_this));
-
-    j_int_t jit_err = JENC_ERR_UNKNOWN;
+    j_uint_t jut_iter = 0;
+    j_size_t jst_osof = 0;
+    j_size_t jst_osos = 0;
+    j_size_t jst_oecs = 0;
+    j_size_t jst_size = 0;
+    j_size_t jst_necs = 0;
 
     //======================================
+    // 头部信息
 
-    if (jenc_this->jbl_work)
+    if (!jenc_stripe_parse(jstripes[0].jmt_data,
+                           jstripes[0].jst_size,
+                           &jst_osof,
+                           &jst_osos,
+                           &jst_oecs) || (0 == jst_osof))
     {
-        return JENC_ERR_WORKING;
+        return 0;
     }
 
-    //======================================
-    // 输出模式
+    if (J_NULL != jmt_optr)
+    {
+        memcpy(jmt_optr, jstripes[0].jmt_data, jst_osos);
+
+        // 修正 SOF 中的图像高度
+        jmt_optr[jst_osof + 5] = (j_byte_t)(jut_imgh >> 8);
+        jmt_optr[jst_osof + 6] = (j_byte_t)(jut_imgh);
+
+        jmt_optr[jst_osos + 0] = 0xFF;
+        jmt_optr[jst_osos + 1] = JENC_MARKER_DRI;
+        jmt_optr[jst_osos + 2] = 0x00;
+        jmt_optr[jst_osos + 3] = 0x04;
+        jmt_optr[jst_osos + 4] = (j_byte_t)(jut_rsti >> 8);
+        jmt_optr[jst_osos + 5] = (j_byte_t)(jut_rsti);
+
+        memcpy(jmt_optr + jst_osos + 6,
+               jstripes[0].jmt_data + jst_osos,
+               jst_oecs - jst_osos);
+    }
 
-    jit_err = JENC_ERR_EPARAM;
+    jst_size = jst_oecs + 6;
 
-    switch (jct_mode)
+    //======================================
+    // 熵编码数据段
+
+    for (jut_iter = 0; jut_iter < jut_nstr; ++jut_iter)
     {
-    case JCTL_MODE_FMEMORY:
+        if (!jenc_stripe_parse(jstripes[jut_iter].jmt_data,
+                               jstripes[jut_iter].jst_size,
+                               J_NULL,
+                               J_NULL,
+                               &jst_oecs))
         {
-            jenc_this->jmode.jct_mode = JCTL_MODE_FMEMORY;
-            if ((J_NULL == jht_optr) || (0 == jst_mlen))
-            {
-                jenc_this->jmode.jst_mlen = 0;
-                jenc_this->jmode.jmt_optr = J_NULL;
-            }
-            else
-            {
-                jenc_this->jmode.jst_mlen = jst_mlen;
-                jenc_this->jmode.jmt_optr = (j_mptr_t)jht_optr;
-            }
+            return 0;
+        }
 
-            jit_err = JENC_ERR_OK;
+        if ((jut_iter > 0) && (J_NULL != jmt_optr))
+        {
+            jmt_optr[jst_size + 0] = 0xFF;
+            jmt_optr[jst_size + 1] =
+                (j_byte_t)(JENC_MARKER_RST0 + ((jut_iter - 1) & 7));
         }
-        break;
 
-    case JCTL_MODE_FSTREAM:
-        if (J_NULL != jht_optr)
+        if (jut_iter > 0)
         {
-            jenc_this->jmode.jct_mode = JCTL_MODE_FSTREAM;
-            jenc_this->jmode.jfp_spos = 0;
-            jenc_this->jmode.jfs_ostr = (j_fstream_t)jht_optr;
+            jst_size += 2;
+        }
+
+        jst_necs = jstripes[jut_iter].jst_size - 2 - jst_oecs;
+        if (J_NULL != jmt_optr)
+        {
+            memcpy(jmt_optr + jst_size,
+                   jstripes[jut_iter].jmt_data + jst_oecs,
+                   jst_necs);
+        }
+
+        jst_size += jst_necs;
+    }
+
+    //======================================
+
+    if (J_NULL != jmt_optr)
+    {
+        jmt_optr[jst_size + 0] = 0xFF;
+        jmt_optr[jst_size + 1] = JENC_MARKER_EOI;
+    }
+
+    return (jst_size + 2);
+}
+
+/**********************************************************/
+/**
+ * @brief 将拼接后的 JPEG 数据流，写入 jenc_config() 所配置的输出目标。
+ * 
+ * @return j_int_t : 返回值的含义，与 jenc_finish() 的返回值相同。
+ */
+static j_int_t jenc_stripe_output(
+                    jenc_this_t     jenc_this,
+                    jenc_stripe_t * jstripes,
+                    j_uint_t        jut_nstr,
+                    j_uint_t        jut_imgh,
+                    j_uint_t        jut_rsti)
+{
+    j_int_t     jit_err  = JENC_ERR_UNKNOWN;
+    j_size_t    jst_size = 0;
+    j_mptr_t    jmt_optr = J_NULL;
+    j_fstream_t jfs_ostr = J_NULL;
+
+    jst_size = jenc_stripe_join(jstripes, jut_nstr, jut_imgh, jut_rsti, J_NULL);
+    if (0 == jst_size)
+    {
+        return JENC_ERR_EXCEPTION;
+    }
+
+    //======================================
+    // 内存模式：输出缓存足够时，直接拼接至输出缓存，否则拼接至内部缓存
+
+    if (JCTL_MODE_FMEMORY == jenc_this->jmode.jct_mode)
+    {
+        if ((J_NULL != jenc_this->jmode.jmt_optr) &&
+            (jst_size <= jenc_this->jmode.jst_mlen))
+        {
+            jenc_stripe_join(jstripes, jut_nstr, jut_imgh, jut_rsti,
+                             jenc_this->jmode.jmt_optr);
+            return (j_int_t)jst_size;
+        }
+
+        jmt_optr = (j_mptr_t)malloc(jst_size);
+        if (J_NULL == jmt_optr)
+        {
+            return JENC_ERR_MALLOC;
+        }
+
+        jenc_stripe_join(jstripes, jut_nstr, jut_imgh, jut_rsti, jmt_optr);
+
+        jenc_this->jbuff.jst_size = jst_size;
+        jenc_this->jbuff.jmt_mptr = jmt_optr;
+
+        return JENC_ERR_OK;
+    }
+
+    //======================================
+    // 文件流模式 或 文件模式
+
+    if (JCTL_MODE_FSTREAM == jenc_this->jmode.jct_mode)
+    {
+        jfs_ostr = jenc_this->jmode.jfs_ostr;
+    }
+    else
+    {
+        jfs_ostr = fopen((j_fszpath_t)jenc_this->jmode.jsz_path, "wb+");
+        if (J_NULL == jfs_ostr)
+        {
+            return JENC_ERR_FOPEN;
+        }
+    }
+
+    jmt_optr = (j_mptr_t)malloc(jst_size);
+    if (J_NULL == jmt_optr)
+    {
+        jit_err = JENC_ERR_MALLOC;
+    }
+    else
+    {
+        jenc_stripe_join(jstripes, jut_nstr, jut_imgh, jut_rsti, jmt_optr);
 
+        if ((jst_size != fwrite(jmt_optr, 1, jst_size, jfs_ostr)) ||
+            (0 != fflush(jfs_ostr)))
+        {
+            jit_err = JENC_ERR_EXCEPTION;
+        }
+        else
+        {
             jit_err = JENC_ERR_OK;
         }
-        break;
 
-    case JCTL_MODE_FSZPATH:
-        if ((J_NULL != jht_optr) && ('\0' != ((j_fszpath_t)jht_optr)[0]))
+        free(jmt_optr);
+    }
+
+    if (JCTL_MODE_FSZPATH == jenc_this->jmode.jct_mode)
+    {
+        fclose(jfs_ostr);
+    }
+
+    return jit_err;
+}
+
+/**********************************************************/
+/**
+ * @brief 将各个条带拼接至临时缓存，再以 无损转码 的方式 优化哈夫曼表，
+ *        写入 jenc_config() 所配置的输出目标。
+ * @note
+ * 各个条带 共用第一个条带的哈夫曼表，无法在条带内分别优化，
+ * 所以 拼接后 统计整幅图像的符号频率，重新执行一次熵编码（重启间隔保持不变）。
+ * 
+ * @return j_int_t : 返回值的含义，与 jenc_finish() 的返回值相同。
+ */
+static j_int_t jenc_stripe_optimize(
+                    jenc_this_t     jenc_this,
+                    jenc_stripe_t * jstripes,
+                    j_uint_t        jut_nstr,
+                    j_uint_t        jut_imgh,
+                    j_uint_t        jut_rsti)
+{
+    j_int_t            jit_err  = JENC_ERR_UNKNOWN;
+    jenc_obj_t       * jenc_ptr = &jenc_this->jenc_obj;
+    j_size_t           jst_size = 0;
+    j_mptr_t           jmt_data = J_NULL;
+    jvirt_barray_ptr * jvba_arr = J_NULL;
+
+    struct jpeg_decompress_struct jdec_obj;
+
+    jst_size = jenc_stripe_join(jstripes, jut_nstr, jut_imgh, jut_rsti, J_NULL);
+    if (0 == jst_size)
+    {
+        return JENC_ERR_EXCEPTION;
+    }
+
+    jmt_data = (j_mptr_t)malloc(jst_size);
+    if (J_NULL == jmt_data)
+    {
+        return JENC_ERR_MALLOC;
+    }
+
+    jenc_stripe_join(jstripes, jut_nstr, jut_imgh, jut_rsti, jmt_data);
+
+    //======================================
+    // 解码器 与 编码器 共用同一个错误管理对象
+
+    memset(&jdec_obj, 0, sizeof(jdec_obj));
+    jdec_obj.err = &jenc_this->jerr_mgr.jerr_mgr;
+
+    if (0 != setjmp(jenc_this->jerr_mgr.jerr_jmp))
+    {
+        jenc_shutdown(jenc_this);
+        jpeg_destroy_decompress(&jdec_obj);
+        free(jmt_data);
+        return JENC_ERR_EXCEPTION;
+    }
+
+    jpeg_create_decompress(&jdec_obj);
+    jpeg_mem_src(&jdec_obj, jmt_data, jst_size);
+    jpeg_read_header(&jdec_obj, J_TRUE);
+    jvba_arr = jpeg_read_coefficients(&jdec_obj);
+
+    jit_err = jenc_setup_dest(jenc_this);
+    if (JENC_ERR_OK != jit_err)
+    {
+        jenc_shutdown(jenc_this);
+        jpeg_destroy_decompress(&jdec_obj);
+        free(jmt_data);
+        return jit_err;
+    }
+
+    jpeg_copy_critical_parameters(&jdec_obj, jenc_ptr);
+    jenc_ptr->restart_interval = jdec_obj.restart_interval;
+    jenc_ptr->optimize_coding  = J_TRUE;
+    jpeg_write_coefficients(jenc_ptr, jvba_arr);
+
+    //======================================
+    // 熵编码 在 jenc_finish() 中执行，其间仍须读取 解码器 的 DCT 系数
+
+    jenc_this->jbl_work = J_TRUE;
+    jit_err = jenc_finish(jenc_this);
+
+    jpeg_destroy_decompress(&jdec_obj);
+    free(jmt_data);
+
+    return jit_err;
+}
+
+/**********************************************************/
+/**
+ * @brief 哑输出目标：重置输出缓存（丢弃已输出的数据）。
+ */
+static j_void_t jenc_null_init(j_compress_ptr jenc_ptr)
+{
+    jenc_coef_t * jcoef_ptr = (jenc_coef_t *)jenc_ptr->client_data;
+
+    jenc_ptr->dest->next_output_byte = jcoef_ptr->jdst_buff;
+    jenc_ptr->dest->free_in_buffer   = JENC_NULL_DEST_SIZE;
+}
+
+/**********************************************************/
+/**
+ * @brief 哑输出目标：输出缓存已满时，丢弃已输出的数据。
+ */
+static boolean jenc_null_empty(j_compress_ptr jenc_ptr)
+{
+    jenc_null_init(jenc_ptr);
+    return TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 哑输出目标：结束输出（无操作）。
+ */
+static j_void_t jenc_null_term(j_compress_ptr jenc_ptr)
+{
+
+}
+
+/**********************************************************/
+/**
+ * @brief 替换 libjpeg 熵编码的 encode_mcu 接口，将 MCU 中的各个 DCT 块，
+ *        按其所属颜色分量 及 块位置，存放至 jenc_coef_t 的块数组中。
+ * @note  图像边缘的填充块（dummy blocks）不在块数组范围内，直接忽略。
+ */
+static boolean jenc_coef_encode_mcu(j_compress_ptr jenc_ptr, JBLOCKARRAY jmcu_ptr)
+{
+    jenc_coef_t         * jcoef_ptr = (jenc_coef_t *)jenc_ptr->client_data;
+    jpeg_component_info * jcomp_ptr = J_NULL;
+
+    j_int_t  jit_iter = 0;
+    j_int_t  jit_xpos = 0;
+    j_int_t  jit_ypos = 0;
+    j_int_t  jit_blkn = 0;
+    j_uint_t jut_bcol = 0;
+    j_uint_t jut_brow = 0;
+    j_uint_t jut_mcux = jcoef_ptr->jut_nmcu % jenc_ptr->MCUs_per_row;
+    j_uint_t jut_mcuy = jcoef_ptr->jut_nmcu / jenc_ptr->MCUs_per_row;
+
+    for (jit_iter = 0; jit_iter < jenc_ptr->comps_in_scan; ++jit_iter)
+    {
+        jcomp_ptr = jenc_ptr->cur_comp_info[jit_iter];
+
+        for (jit_ypos = 0; jit_ypos < jcomp_ptr->MCU_height; ++jit_ypos)
         {
-            jit_err = jenc_update_path(jenc_this, (j_fszpath_t)jht_optr);
-            if (JENC_ERR_OK == jit_err)
+            jut_brow = jut_mcuy * jcomp_ptr->MCU_height + jit_ypos;
+
+            for (jit_xpos = 0; jit_xpos < jcomp_ptr->MCU_width; ++jit_xpos, ++jit_blkn)
             {
-                jenc_this->jmode.jct_mode = JCTL_MODE_FSZPATH;
-                jenc_this->jmode.jfs_file = J_NULL;
-                jenc_this->jmode.jsz_path = jenc_this->jpath.jsz_path;
+                jut_bcol = jut_mcux * jcomp_ptr->MCU_width + jit_xpos;
+
+                if ((jut_brow < jcomp_ptr->height_in_blocks) &&
+                    (jut_bcol < jcomp_ptr->width_in_blocks))
+                {
+                    memcpy(jcoef_ptr->jcomp[jcomp_ptr->component_index].jblk_ptr +
+                               (j_size_t)jut_brow * jcomp_ptr->width_in_blocks + jut_bcol,
+                           jmcu_ptr[jit_blkn],
+                           sizeof(JBLOCK));
+                }
             }
         }
-        break;
+    }
 
-    default:
-        break;
+    jcoef_ptr->jut_nmcu += 1;
+
+    return TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 替换 libjpeg 熵编码的 finish_pass 接口（无操作）。
+ */
+static j_void_t jenc_coef_finish_pass(j_compress_ptr jenc_ptr)
+{
+
+}
+
+/**********************************************************/
+/**
+ * @brief 释放 jenc_coef_t 中的 DCT 块数组。
+ */
+static j_void_t jenc_coef_free(jenc_coef_t * jcoef_ptr)
+{
+    j_uint_t jut_iter = 0;
+
+    for (jut_iter = 0; jut_iter < MAX_COMPONENTS; ++jut_iter)
+    {
+        if (J_NULL != jcoef_ptr->jcomp[jut_iter].jblk_ptr)
+        {
+            free(jcoef_ptr->jcomp[jut_iter].jblk_ptr);
+            jcoef_ptr->jcomp[jut_iter].jblk_ptr = J_NULL;
+        }
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 对图像执行 色彩转换、降采样 和 DCT 变换，捕获 未量化 的 DCT 系数。
+ * @note
+ * 执行编码流程时，将 libjpeg 正向 DCT 的量化除数（compptr->dct_table）全部置为 1，
+ * 并替换熵编码接口，将 DCT 的原始输出 存放至 jcoef_ptr 中；之后按 libjpeg 相同的
+ * 除数与取整方式 重新量化，结果与 直接编码 完全一致。
+ * 
+ * @param [in ] jenc_this : JPEG 编码操作的上下文对象（须处于空闲状态）。
+ * @param [out] jcoef_ptr : 存放捕获结果（调用方以 0 初始化，用后调用 jenc_coef_free()）。
+ * @param [in ] jccs_conv : 色彩空间的转换方式（参看 jenc_ccs_t）。
+ * @param [in ] jmt_pxls  : 图像的像素缓存。
+ * @param [in ] jit_step  : 遍历像素行时的 步长值（以 字节 为单位）。
+ * @param [in ] jut_imgw  : 图像宽度。
+ * @param [in ] jut_imgh  : 图像高度。
+ * 
+ * @return j_int_t : 错误码，请参看 jenc_errno_t 相关枚举值。
+ */
+static j_int_t jenc_coef_capture(
+                    jenc_this_t   jenc_this,
+                    jenc_coef_t * jcoef_ptr,
+                    jenc_ccs_t    jccs_conv,
+                    j_mptr_t      jmt_pxls,
+                    j_int_t       jit_step,
+                    j_uint_t      jut_imgw,
+                    j_uint_t      jut_imgh)
+{
+    j_int_t      jit_err  = JENC_ERR_UNKNOWN;
+    jenc_obj_t * jenc_ptr = &jenc_this->jenc_obj;
+    j_uint_t     jut_iter = 0;
+    j_uint_t     jut_kpos = 0;
+    j_uint_t     jut_rows = 0;
+
+    jpeg_component_info         * jcomp_ptr = J_NULL;
+    struct jpeg_destination_mgr * jdst_ptr  = jenc_ptr->dest;
+
+    //======================================
+
+    jcoef_ptr->jccs_conv = jccs_conv;
+    jcoef_ptr->jut_imgw  = jut_imgw;
+    jcoef_ptr->jut_imgh  = jut_imgh;
+    jcoef_ptr->jut_nmcu  = 0;
+
+    jcoef_ptr->jdst_mgr.init_destination    = jenc_null_init;
+    jcoef_ptr->jdst_mgr.empty_output_buffer = jenc_null_empty;
+    jcoef_ptr->jdst_mgr.term_destination    = jenc_null_term;
+
+    jit_err = jenc_grow_rows(jenc_this, JENC_DEF_WROWS);
+    if (JENC_ERR_OK != jit_err)
+    {
+        return jit_err;
+    }
+
+    //======================================
+
+    if (0 != setjmp(jenc_this->jerr_mgr.jerr_jmp))
+    {
+        jit_err = JENC_ERR_EXCEPTION;
+        goto __EXIT_FUNC;
+    }
+
+    jenc_ptr->client_data = jcoef_ptr;
+    jenc_ptr->dest        = &jcoef_ptr->jdst_mgr;
+
+    jenc_setup_params(jenc_ptr, jccs_conv, jut_imgw, jut_imgh, 100, &jenc_this->jparam);
+    JASSERT(JDCT_ISLOW == jenc_ptr->dct_method);
+    jpeg_start_compress(jenc_ptr, J_TRUE);
+
+    //======================================
+    // 申请各个颜色分量的 DCT 块数组，置量化除数为 1，并替换熵编码接口
+
+    jcoef_ptr->jut_ncomp = (j_uint_t)jenc_ptr->num_components;
+    for (jut_iter = 0; jut_iter < jcoef_ptr->jut_ncomp; ++jut_iter)
+    {
+        jcomp_ptr = &jenc_ptr->comp_info[jut_iter];
+        for (jut_kpos = 0; jut_kpos < DCTSIZE2; ++jut_kpos)
+        {
+            ((DCTELEM *)jcomp_ptr->dct_table)[jut_kpos] = 1;
+        }
+
+        // 与 libjpeg 的 jcdctmgr.c 中，JDCT_ISLOW 量化除数的计算方式一致
+        jcoef_ptr->jcomp[jut_iter].jut_qsft = jcomp_ptr->component_needed ? 4 : 3;
+        jcoef_ptr->jcomp[jut_iter].jut_bw   = jcomp_ptr->width_in_blocks;
+        jcoef_ptr->jcomp[jut_iter].jut_bh   = jcomp_ptr->height_in_blocks;
+        jcoef_ptr->jcomp[jut_iter].jut_hsmp = (j_uint_t)jcomp_ptr->h_samp_factor;
+        jcoef_ptr->jcomp[jut_iter].jut_vsmp = (j_uint_t)jcomp_ptr->v_samp_factor;
+        jcoef_ptr->jcomp[jut_iter].jblk_ptr = (JBLOCKROW)malloc(
+            (j_size_t)jcoef_ptr->jcomp[jut_iter].jut_bw *
+            jcoef_ptr->jcomp[jut_iter].jut_bh * sizeof(JBLOCK));
+        if (J_NULL == jcoef_ptr->jcomp[jut_iter].jblk_ptr)
+        {
+            jit_err = JENC_ERR_MALLOC;
+            goto __EXIT_FUNC;
+        }
+    }
+
+    jenc_ptr->entropy->encode_mcu  = jenc_coef_encode_mcu;
+    jenc_ptr->entropy->finish_pass = jenc_coef_finish_pass;
+
+    //======================================
+
+    while (jenc_ptr->next_scanline < jenc_ptr->image_height)
+    {
+        jut_rows = jenc_ptr->image_height - jenc_ptr->next_scanline;
+        if (jut_rows > JENC_DEF_WROWS)
+            jut_rows = JENC_DEF_WROWS;
+
+        for (jut_iter = 0; jut_iter < jut_rows; ++jut_iter)
+        {
+            jenc_this->jrows.jar_rows[jut_iter] = jmt_pxls +
+                (j_long_t)(jenc_ptr->next_scanline + jut_iter) * jit_step;
+        }
+
+        jpeg_write_scanlines(jenc_ptr, jenc_this->jrows.jar_rows, jut_rows);
+    }
+
+    jpeg_finish_compress(jenc_ptr);
+
+    jit_err = JENC_ERR_OK;
+
+    //======================================
+
+__EXIT_FUNC:
+    jpeg_abort_compress(jenc_ptr);
+    jenc_ptr->client_data = J_NULL;
+    jenc_ptr->dest        = jdst_ptr;
+
+    return jit_err;
+}
+
+/**********************************************************/
+/**
+ * @brief 按指定的压缩质量，重新量化 jenc_coef_t 中的 DCT 系数，
+ *        只执行熵编码，输出至 jenc_config() 所配置的输出目标。
+ * @note  jcoef_ptr 只被读取，多个编码器可同时使用同一个 jcoef_ptr 。
+ * 
+ * @param [in ] jenc_this : JPEG 编码操作的上下文对象。
+ * @param [in ] jcoef_ptr : 捕获得到的 DCT 系数。
+ * @param [in ] jit_qual  : 压缩质量（1 - 100）。
+ * 
+ * @return j_int_t : 返回值的含义，与 jenc_finish() 的返回值相同。
+ */
+static j_int_t jenc_coef_encode(
+                    jenc_this_t         jenc_this,
+                    const jenc_coef_t * jcoef_ptr,
+                    j_int_t             jit_qual)
+{
+    j_int_t      jit_err  = JENC_ERR_UNKNOWN;
+    jenc_obj_t * jenc_ptr = &jenc_this->jenc_obj;
+    j_uint_t     jut_iter = 0;
+    j_uint_t     jut_brow = 0;
+    j_uint_t     jut_bcol = 0;
+    j_uint_t     jut_kpos = 0;
+    j_uint_t     jut_hsmp = 0;
+    j_uint_t     jut_vsmp = 0;
+
+    jpeg_component_info * jcomp_ptr = J_NULL;
+    JBLOCKROW             jsrc_ptr  = J_NULL;
+    JBLOCKARRAY           jdst_ptr  = J_NULL;
+    JCOEFPTR              jsrc_coef = J_NULL;
+    JCOEFPTR              jdst_coef = J_NULL;
+    j_int_t               jit_coef  = 0;
+    j_int_t               jit_sign  = 0;
+    JQUANT_TBL          * jqtbl_ptr = J_NULL;
+
+    jvirt_barray_ptr      jvba_arr[MAX_COMPONENTS];
+    unsigned long long    jul_rcp[DCTSIZE2];
+    j_int_t               jit_half[DCTSIZE2];
+
+    //======================================
+
+    if (jenc_this->jbl_work)
+    {
+        return JENC_ERR_WORKING;
+    }
+
+    if (0 != setjmp(jenc_this->jerr_mgr.jerr_jmp))
+    {
+        jenc_shutdown(jenc_this);
+        return JENC_ERR_EXCEPTION;
     }
 
+    jit_err = jenc_setup_dest(jenc_this);
+    if (JENC_ERR_OK != jit_err)
+    {
+        jenc_shutdown(jenc_this);
+        return jit_err;
+    }
+
+    //======================================
+    // 以 转码 方式写入 DCT 系数
+
+    jenc_setup_params(
+        jenc_ptr,
+        jcoef_ptr->jccs_conv,
+        jcoef_ptr->jut_imgw,
+        jcoef_ptr->jut_imgh,
+        jit_qual,
+        &jenc_this->jparam);
+    jenc_setup_scans(jenc_ptr, &jenc_this->jparam);
+
+    // 块数组的布局 取决于捕获时的采样因子，编码器的采样因子 须与之相同
+    for (jut_iter = 0; jut_iter < jcoef_ptr->jut_ncomp; ++jut_iter)
+    {
+        if ((jcoef_ptr->jcomp[jut_iter].jut_hsmp !=
+                (j_uint_t)jenc_ptr->comp_info[jut_iter].h_samp_factor) ||
+            (jcoef_ptr->jcomp[jut_iter].jut_vsmp !=
+                (j_uint_t)jenc_ptr->comp_info[jut_iter].v_samp_factor))
+        {
+            jenc_shutdown(jenc_this);
+            return JENC_ERR_EPARAM;
+        }
+    }
+
+    jenc_ptr->jpeg_width  = jenc_ptr->image_width;
+    jenc_ptr->jpeg_height = jenc_ptr->image_height;
+    jenc_ptr->min_DCT_h_scaled_size = DCTSIZE;
+    jenc_ptr->min_DCT_v_scaled_size = DCTSIZE;
+
+    for (jut_iter = 0; jut_iter < jcoef_ptr->jut_ncomp; ++jut_iter)
+    {
+        jut_hsmp = (j_uint_t)jenc_ptr->comp_info[jut_iter].h_samp_factor;
+        jut_vsmp = (j_uint_t)jenc_ptr->comp_info[jut_iter].v_samp_factor;
+
+        jvba_arr[jut_iter] = (*jenc_ptr->mem->request_virt_barray)(
+            (j_common_ptr)jenc_ptr,
+            JPOOL_IMAGE,
+            J_TRUE,
+            (JDIMENSION)(((jcoef_ptr->jcomp[jut_iter].jut_bw + jut_hsmp - 1) / jut_hsmp) * jut_hsmp),
+            (JDIMENSION)(((jcoef_ptr->jcomp[jut_iter].jut_bh + jut_vsmp - 1) / jut_vsmp) * jut_vsmp),
+            (JDIMENSION)jut_vsmp);
+    }
+
+    jpeg_write_coefficients(jenc_ptr, jvba_arr);
+
+    //======================================
+    // 重新量化：与 libjpeg 的 forward_DCT() 相同，q = (|c| + D/2) / D，
+    // D = 量化表值 << jut_qsft，以 倒数乘法 代替除法
+    // （n 与 D 均小于 2^16，floor(n * ceil(2^32 / D) / 2^32) == floor(n / D)）
+
+    for (jut_iter = 0; jut_iter < jcoef_ptr->jut_ncomp; ++jut_iter)
+    {
+        jcomp_ptr = &jenc_ptr->comp_info[jut_iter];
+        jqtbl_ptr = jenc_ptr->quant_tbl_ptrs[jcomp_ptr->quant_tbl_no];
+
+        for (jut_kpos = 0; jut_kpos < DCTSIZE2; ++jut_kpos)
+        {
+            jit_coef = (j_int_t)jqtbl_ptr->quantval[jut_kpos] <<
+                                    jcoef_ptr->jcomp[jut_iter].jut_qsft;
+            jul_rcp[jut_kpos]  = (0x100000000ULL + jit_coef - 1) / jit_coef;
+            jit_half[jut_kpos] = jit_coef >> 1;
+        }
+
+        for (jut_brow = 0; jut_brow < jcoef_ptr->jcomp[jut_iter].jut_bh; ++jut_brow)
+        {
+            jdst_ptr = (*jenc_ptr->mem->access_virt_barray)(
+                (j_common_ptr)jenc_ptr, jvba_arr[jut_iter], jut_brow, 1, J_TRUE);
+            jsrc_ptr = jcoef_ptr->jcomp[jut_iter].jblk_ptr +
+                       (j_size_t)jut_brow * jcoef_ptr->jcomp[jut_iter].jut_bw;
+
+            for (jut_bcol = 0; jut_bcol < jcoef_ptr->jcomp[jut_iter].jut_bw; ++jut_bcol)
+            {
+                jsrc_coef = jsrc_ptr[jut_bcol];
+                jdst_coef = jdst_ptr[0][jut_bcol];
+
+                // 无分支形式：先取绝对值 量化，再恢复符号
+                for (jut_kpos = 0; jut_kpos < DCTSIZE2; ++jut_kpos)
+                {
+                    jit_coef = jsrc_coef[jut_kpos];
+                    jit_sign = -(jit_coef < 0);
+                    jit_coef = (jit_coef ^ jit_sign) - jit_sign;
+                    jit_coef = (j_int_t)(((jit_coef + jit_half[jut_kpos]) *
+                                          jul_rcp[jut_kpos]) >> 32);
+                    jdst_coef[jut_kpos] = (JCOEF)((jit_coef ^ jit_sign) - jit_sign);
+                }
+            }
+        }
+    }
+
+    //======================================
+    // 至此，标识 编码器 处于工作状态，由 jenc_finish() 完成熵编码输出
+
+    jenc_this->jbl_work = J_TRUE;
+
+    return jenc_finish(jenc_this);
+}
+
+/**********************************************************/
+/**
+ * @brief 释放批量编码的任务上下文（包括各个工作线程的工作对象）。
+ */
+static j_void_t jenc_batch_free(jenc_bctx_t * jbctx_ptr)
+{
+    j_uint_t jut_iter = 0;
+
+    for (jut_iter = 0; jut_iter < JTHRD_MAX_WORKERS; ++jut_iter)
+    {
+        if (J_NULL != jbctx_ptr->jwork_arr[jut_iter].jenc_this)
+            jenc_release(jbctx_ptr->jwork_arr[jut_iter].jenc_this);
+
+        if (J_NULL != jbctx_ptr->jwork_arr[jut_iter].jmt_buff)
+            free(jbctx_ptr->jwork_arr[jut_iter].jmt_buff);
+    }
+
+    free(jbctx_ptr);
+}
+
+/**********************************************************/
+/**
+ * @brief 批量编码时，使用工作线程的编码器 执行单个编码任务的编码操作：
+ *        jbctx_ptr->jcoef_ptr 不为 J_NULL 时（质量阶梯编码），
+ *        只按任务的压缩质量 重新量化 与 熵编码，否则 完整编码任务的图像。
+ */
+static j_int_t jenc_batch_encode(
+                    jenc_bctx_t * jbctx_ptr,
+                    jenc_this_t   jenc_this,
+                    jenc_job_t  * jjob_ptr)
+{
+    if (J_NULL != jbctx_ptr->jcoef_ptr)
+    {
+        return jenc_coef_encode(jenc_this, jbctx_ptr->jcoef_ptr, jenc_this->jit_qual);
+    }
+
+    return jenc_image(
+                jenc_this,
+                jjob_ptr->jccs_conv,
+                jjob_ptr->jmt_pxls,
+                jjob_ptr->jit_step,
+                jjob_ptr->jut_imgw,
+                jjob_ptr->jut_imgh);
+}
+
+/**********************************************************/
+/**
+ * @brief 批量编码时，使用第 jut_widx 个工作线程的工作对象 执行单个编码任务。
+ */
+static j_void_t jenc_batch_exec(
+                    jenc_bctx_t * jbctx_ptr,
+                    j_uint_t      jut_widx,
+                    jenc_job_t  * jjob_ptr)
+{
+    jenc_bwork_t * jwork_ptr = &jbctx_ptr->jwork_arr[jut_widx];
+    j_int_t        jit_err   = JENC_ERR_UNKNOWN;
+
+    jjob_ptr->jst_size = 0;
+
+    if (J_NULL == jwork_ptr->jenc_this)
+    {
+        jwork_ptr->jenc_this = jenc_alloc(J_NULL);
+        if (J_NULL == jwork_ptr->jenc_this)
+        {
+            jjob_ptr->jit_err = JENC_ERR_MALLOC;
+            return;
+        }
+    }
+
+    // 工作线程的编码器 在多个任务间重复使用，每个任务都须设置其编码参数
+    jit_err = jenc_config_param(jwork_ptr->jenc_this, jjob_ptr->jparam_ptr);
+    if (JENC_ERR_OK != jit_err)
+    {
+        jjob_ptr->jit_err = jit_err;
+        return;
+    }
+
+    //======================================
+    // 文件流模式 或 文件模式，直接输出至任务指定的目标
+
+    if (JCTL_MODE_FMEMORY != jjob_ptr->jct_mode)
+    {
+        jit_err = jenc_config(
+                    jwork_ptr->jenc_this,
+                    jjob_ptr->jct_mode,
+                    jjob_ptr->jht_optr,
+                    jjob_ptr->jst_mlen,
+                    jjob_ptr->jut_qual);
+        if (JENC_ERR_OK == jit_err)
+        {
+            jit_err = jenc_batch_encode(jbctx_ptr, jwork_ptr->jenc_this, jjob_ptr);
+        }
+
+        jjob_ptr->jit_err = (jit_err < 0) ? jit_err : JENC_ERR_OK;
+        return;
+    }
+
+    //======================================
+    // 内存模式，先输出至工作线程的缓存
+
+    jit_err = jenc_config(
+                jwork_ptr->jenc_this,
+                JCTL_MODE_FMEMORY,
+                jwork_ptr->jmt_buff,
+                jwork_ptr->jst_bcap,
+                jjob_ptr->jut_qual);
+    if (JENC_ERR_OK == jit_err)
+    {
+        jit_err = jenc_batch_encode(jbctx_ptr, jwork_ptr->jenc_this, jjob_ptr);
+    }
+
+    if (jit_err < 0)
+    {
+        jjob_ptr->jit_err = jit_err;
+        return;
+    }
+
+    // 工作线程的缓存容量不足时，编码数据存放在编码器新申请的内部缓存中，
+    // 接管该缓存，作为工作线程后续使用的（更大容量的）缓存
+    if (JENC_ERR_OK == jit_err)
+    {
+        if (J_NULL != jwork_ptr->jmt_buff)
+            free(jwork_ptr->jmt_buff);
+
+        jwork_ptr->jst_bcap = jwork_ptr->jenc_this->jbuff.jst_size;
+        jwork_ptr->jmt_buff = jwork_ptr->jenc_this->jbuff.jmt_mptr;
+        jit_err = (j_int_t)jwork_ptr->jst_bcap;
+
+        jwork_ptr->jenc_this->jbuff.jst_size = 0;
+        jwork_ptr->jenc_this->jbuff.jmt_mptr = J_NULL;
+    }
+
+    jjob_ptr->jst_size = (j_size_t)jit_err;
+
+    if ((J_NULL == jjob_ptr->jht_optr) ||
+        (jjob_ptr->jst_size > jjob_ptr->jst_mlen))
+    {
+        jjob_ptr->jit_err = JENC_ERR_OVERFLOW;
+        return;
+    }
+
+    memcpy(jjob_ptr->jht_optr, jwork_ptr->jmt_buff, jjob_ptr->jst_size);
+    jjob_ptr->jit_err = JENC_ERR_OK;
+}
+
+/**********************************************************/
+/**
+ * @brief 批量编码的任务：执行第 jut_tidx 个编码任务，并统计其耗时。
+ */
+static j_void_t jenc_batch_task(
+                    j_void_t * jvt_ctxt,
+                    j_uint_t   jut_widx,
+                    j_uint_t   jut_tidx)
+{
+    jenc_bctx_t * jbctx_ptr = (jenc_bctx_t *)jvt_ctxt;
+    jenc_job_t  * jjob_ptr  = &jbctx_ptr->jjob_arr[jut_tidx];
+
+    jjob_ptr->jdt_time = jthrd_clock();
+    jenc_batch_exec(jbctx_ptr, jut_widx, jjob_ptr);
+    jjob_ptr->jdt_time = jthrd_clock() - jjob_ptr->jdt_time;
+}
+
+/**********************************************************/
+/**
+ * @brief 返回 压缩质量 对应的 量化表缩放比例 的自然对数值
+ *        （与 libjpeg 的 jpeg_quality_scaling() 一致）。
+ */
+static double jenc_qual_lscale(j_int_t jit_qual)
+{
+    double jdt_scale = (jit_qual < 50) ?
+                            (5000.0 / jit_qual) : (200.0 - 2.0 * jit_qual);
+    return log((jdt_scale < 1.0) ? 1.0 : jdt_scale);
+}
+
+/**********************************************************/
+/**
+ * @brief jenc_qual_lscale() 的逆运算，返回 最接近的 压缩质量。
+ */
+static j_int_t jenc_lscale_qual(double jdt_lscale)
+{
+    double jdt_scale = exp(jdt_lscale);
+    return (j_int_t)(((jdt_scale >= 100.0) ?
+                            (5000.0 / jdt_scale) : (100.0 - 0.5 * jdt_scale)) + 0.5);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JPEG 编码器 外部接口函数
+
+/**********************************************************/
+/**
+ * @brief 申请 JPEG 编码操作的上下文对象。
+ * 
+ * @param [in ] jvt_reserved : 保留参数（当前使用 J_NULL 即可）。
+ * 
+ * @return jenc_this_t :
+ * 返回 JPEG 编码操作的上下文对象，为 J_NULL 时表示申请失败。
+ */
+jenc_this_t jenc_alloc(j_void_t * jvt_reserved)
+{
+    jenc_this_t jenc_this = (jenc_this_t)calloc(1, sizeof(jenc_ctx_t));
+    if (J_NULL == jenc_this)
+    {
+        return J_NULL;
+    }
+
+    //======================================
+
+    jenc_this->jut_size = sizeof(jenc_ctx_t);
+    jenc_this->jut_type = JENC_HANDLE_TYPE;
+    jenc_this->jit_qual = JENC_DEF_QUALITY;
+    jenc_this->jbl_work = J_FALSE;
+    jenc_config_param(jenc_this, J_NULL);
+    jenc_this->jct_dest = JCTL_MODE_UNKNOWN;
+
+    jenc_this->jmode.jct_mode = JCTL_MODE_UNKNOWN;
+    jenc_this->jmode.jst_mlen = 0;
+    jenc_this->jmode.jmt_optr = J_NULL;
+
+    jenc_this->jpath.jst_size = 0;
+    jenc_this->jpath.jsz_path = J_NULL;
+
+    jenc_this->jrows.jut_size = 0;
+    jenc_this->jrows.jar_rows = J_NULL;
+
+    jenc_this->jbuff.jst_size = 0;
+    jenc_this->jbuff.jmt_mptr = J_NULL;
+
+    jenc_this->jenc_obj.err =
+        jpeg_std_error(&jenc_this->jerr_mgr.jerr_mgr);
+    jenc_this->jerr_mgr.jerr_mgr.error_exit = jerr_exit_callback;
+
+    jpeg_create_compress(&jenc_this->jenc_obj);
+
+    //======================================
+
+    return jenc_this;
+}
+
+/**********************************************************/
+/**
+ * @brief 释放 JPEG 编码操作的上下文对象。
+ */
+j_void_t jenc_release(jenc_this_t jenc_this)
+{
+    if (jenc_valid(jenc_this))
+    {
+        jpeg_destroy_compress(&jenc_this->jenc_obj);
+
+        if (J_NULL != jenc_this->jpath.jsz_path)
+            free(jenc_this->jpath.jsz_path);
+
+        if (J_NULL != jenc_this->jrows.jar_rows)
+            free(jenc_this->jrows.jar_rows);
+
+        if (J_NULL != jenc_this->jbuff.jmt_mptr)
+            free(jenc_this->jbuff.jmt_mptr);
+
+        free(jenc_this);
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief JPEG 编码操作句柄的有效判断。
+ */
+j_bool_t jenc_valid(jenc_this_t jenc_this)
+{
+    if (J_NULL == jenc_this)
+    {
+        return J_FALSE;
+    }
+
+    if (sizeof(jenc_ctx_t) != jenc_this->jut_size)
+    {
+        return J_FALSE;
+    }
+
+    if (JENC_HANDLE_TYPE != jenc_this->jut_type)
+    {
+        return J_FALSE;
+    }
+
+    return J_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 执行 JPEG 编码工作前，配置相关工作参数（目标输出模式 等）。
+ * @note
+ * 1. jct_mode == JCTL_MODE_FMEMORY, typeof(jht_optr) == j_fmemory_t;
+ *    内存模式，即编码压缩后的数据，输出至指定的缓存，
+ *    若 ((J_NULL == jht_optr) || (0 == jst_mlen))，或者压缩过程中，指定缓存
+ *    大小不足，则取内部自动分配缓存，使用 jenc_fmdata() 和 jenc_fmsize()
+ *    两个接口获得这些压缩数据信息。
+ * 2. jct_mode == JCTL_MODE_FSTREAM, typeof(jht_optr) == j_fstream_t;
+ *    文件流模式，即编码压缩后的数据，输出至指定的文件流中。
+ * 3. jct_mode == JCTL_MODE_FSZPATH, typeof(jht_optr) == j_fszpath_t;
+ *    文件模式，即编码压缩后的数据，输出至指定路径的外部文件中。
+ * 
+ * @param [in ] jenc_this : JPEG 编码操作的上下文对象。
+ * @param [in ] jct_mode  : JPEG 编码输出模式（参看 jctl_mode_t ）。
+ * @param [in ] jht_optr  : 指向目标输出的操作对象。
+ * @param [in ] jst_mlen  : 只针对于 内存模式，表示目标输出缓存的容量（按字节计）。
+ * @param [in ] jut_qual  : JPEG 编码压缩数据的质量（1 - 100，为 0 时，取默认值）。
+ * 
+ * @return j_int_t : 错误码，请参看 jenc_errno_t 相关枚举值。
+ */
+j_int_t jenc_config(
+                jenc_this_t jenc_this,
+                jctl_mode_t jct_mode,
+                j_fhandle_t jht_optr,
+                j_size_t    jst_mlen,
+                j_uint_t    jut_qual)
+{
+    JASSERT(jenc_valid(jenc_this));
+
+    j_int_t jit_err = JENC_ERR_UNKNOWN;
+
+    //======================================
+
+    if (jenc_this->jbl_work)
+    {
+        return JENC_ERR_WORKING;
+    }
+
+    //======================================
+    // 输出模式
+
+    jit_err = JENC_ERR_EPARAM;
+
+    switch (jct_mode)
+    {
+    case JCTL_MODE_FMEMORY:
+        {
+            jenc_this->jmode.jct_mode = JCTL_MODE_FMEMORY;
+            if ((J_NULL == jht_optr) || (0 == jst_mlen))
+            {
+                jenc_this->jmode.jst_mlen = 0;
+                jenc_this->jmode.jmt_optr = J_NULL;
+            }
+            else
+            {
+                jenc_this->jmode.jst_mlen = jst_mlen;
+                jenc_this->jmode.jmt_optr = (j_mptr_t)jht_optr;
+            }
+
+            jit_err = JENC_ERR_OK;
+        }
+        break;
+
+    case JCTL_MODE_FSTREAM:
+        if (J_NULL != jht_optr)
+        {
+            jenc_this->jmode.jct_mode = JCTL_MODE_FSTREAM;
+            memset(&jenc_this->jmode.jfp_spos, 0, sizeof(j_fpos_t));
+            jenc_this->jmode.jfs_ostr = (j_fstream_t)jht_optr;
+
+            jit_err = JENC_ERR_OK;
+        }
+        break;
+
+    case JCTL_MODE_FSZPATH:
+        if ((J_NULL != jht_optr) && ('\0' != ((j_fszpath_t)jht_optr)[0]))
+        {
+            jit_err = jenc_update_path(jenc_this, (j_fszpath_t)jht_optr);
+            if (JENC_ERR_OK == jit_err)
+            {
+                jenc_this->jmode.jct_mode = JCTL_MODE_FSZPATH;
+                jenc_this->jmode.jfs_file = J_NULL;
+                jenc_this->jmode.jsz_path = jenc_this->jpath.jsz_path;
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    if (JENC_ERR_OK != jit_err)
+    {
+        jenc_this->jmode.jct_mode = JCTL_MODE_UNKNOWN;
+        jenc_this->jmode.jst_mlen = J_NULL;
+        jenc_this->jmode.jmt_optr = J_NULL;
+
+        return jit_err;
+    }
+
+    //======================================
+
+    if (0 == jut_qual)
+        jenc_this->jit_qual = JENC_DEF_QUALITY;
+    else if (jut_qual > 100)
+        jenc_this->jit_qual = 100;
+    else
+        jenc_this->jit_qual = (j_int_t)jut_qual;
+
+    //======================================
+
+    return JENC_ERR_OK;
+}
+
+/**********************************************************/
+/**
+ * @brief 设置 压缩质量 之外的 JPEG 编码参数（采样因子、扫描模式、重启间隔 等）。
+ * @note
+ * 1. 设置的参数 对其后的 jenc_start()、jenc_image()、jenc_image_target_size()、
+ *    jenc_image_mt() 均有效，直至再次设置；jparam_ptr 为 J_NULL 时，恢复全部默认值；
+ * 2. 采样因子 只作用于 带色度分量的输出色彩空间（YCC、BG_YCC、YCCK，
+ *    YCCK 的 K 分量 与 亮度分量 相同），水平 与 垂直 采样因子之积 不可超过 8，
+ *    否则返回 JENC_ERR_EPARAM；对于 YCCK 则不可超过 4（每个 MCU 最多 10 个块），
+ *    否则 编码时 返回 JENC_ERR_EXCEPTION；
+ * 3. jenc_image_mt() 不支持 渐进模式 与 重启间隔（参看其说明）；
+ * 4. jenc_batch()、jenc_ladder()、jenc_crops() 使用内部编码器，不受此设置影响，
+ *    其编码参数 由各个任务的 jparam_ptr 字段指定。
+ * 
+ * @param [in ] jenc_this  : JPEG 编码操作的上下文对象。
+ * @param [in ] jparam_ptr : 编码参数（为 J_NULL 时，恢复默认值）。
+ * 
+ * @return j_int_t : 错误码，请参看 jenc_errno_t 相关枚举值。
+ */
+j_int_t jenc_config_param(
+                jenc_this_t          jenc_this,
+                const jenc_param_t * jparam_ptr)
+{
+    JASSERT(jenc_valid(jenc_this));
+
+    j_int_t jit_hsmp = 0;
+    j_int_t jit_vsmp = 0;
+
+    //======================================
+
+    if (jenc_this->jbl_work)
+    {
+        return JENC_ERR_WORKING;
+    }
+
+    if (J_NULL == jparam_ptr)
+    {
+        jenc_this->jparam.jit_hsamp = JENC_PARAM_DEFAULT;
+        jenc_this->jparam.jit_vsamp = JENC_PARAM_DEFAULT;
+        jenc_this->jparam.jit_prog  = JENC_PARAM_DEFAULT;
+        jenc_this->jparam.jit_rrows = JENC_PARAM_DEFAULT;
+        jenc_this->jparam.jbl_optim = J_FALSE;
+
+        return JENC_ERR_OK;
+    }
+
+    //======================================
+    // 参数验证
+
+    jit_hsmp = (JENC_PARAM_DEFAULT == jparam_ptr->jit_hsamp) ? 2 : jparam_ptr->jit_hsamp;
+    jit_vsmp = (JENC_PARAM_DEFAULT == jparam_ptr->jit_vsamp) ? 2 : jparam_ptr->jit_vsamp;
+
+    if ((jit_hsmp < 1) || (jit_hsmp > MAX_SAMP_FACTOR) ||
+        (jit_vsmp < 1) || (jit_vsmp > MAX_SAMP_FACTOR) ||
+        (jit_hsmp * jit_vsmp > 8))
+    {
+        return JENC_ERR_EPARAM;
+    }
+
+    if ((jparam_ptr->jit_prog < JENC_PARAM_DEFAULT) || (jparam_ptr->jit_prog > 1))
+    {
+        return JENC_ERR_EPARAM;
+    }
+
+    if ((jparam_ptr->jit_rrows < JENC_PARAM_DEFAULT) || (jparam_ptr->jit_rrows > 65535))
+    {
+        return JENC_ERR_EPARAM;
+    }
+
+    //======================================
+
+    jenc_this->jparam = *jparam_ptr;
+
+    return JENC_ERR_OK;
+}
+
+/**********************************************************/
+/**
+ * @brief 在内存模式下，执行编码压缩操作后，所缓存的 JPEG 数据流地址。
+ */
+j_mptr_t jenc_fmdata(jenc_this_t jenc_this)
+{
+    return jenc_this->jbuff.jmt_mptr;
+}
+
+/**********************************************************/
+/**
+ * @brief 在内存模式下，执行编码压缩操作后，所缓存的 JPEG 数据流有效字节数。
+ */
+j_uint_t jenc_fmsize(jenc_this_t jenc_this)
+{
+    return (j_uint_t)jenc_this->jbuff.jst_size;
+}
+
+/**********************************************************/
+/**
+ * @brief 启动 JPEG 编码操作。
+ * @note  启动编码器前，应先调用 jenc_config() 配置好输出模式。
+ * 
+ * @param [in ] jenc_this : JPEG 编码操作的上下文对象。
+ * @param [in ] jccs_conv : 设置色彩空间的转换方式（参看 jenc_ccs_t）。
+ * @param [in ] jut_imgw  : 设置编码输出图像的宽度（以像素为单位）。
+ * @param [in ] jut_imgh  : 设置编码输出图像的高度（以像素为单位）。
+ * 
+ * @return j_int_t : 错误码，请参看 jenc_errno_t 相关枚举值。
+ */
+j_int_t jenc_start(
+                jenc_this_t jenc_this,
+                jenc_ccs_t  jccs_conv,
+                j_uint_t    jut_imgw,
+                j_uint_t    jut_imgh)
+{
+    JASSERT(jenc_valid(jenc_this));
+
+    j_int_t      jit_err  = JENC_ERR_UNKNOWN;
+
+    // 在 setjmp 之后被修改，longjmp 返回后仍须读取，故声明为 volatile
+    jenc_obj_t * volatile jenc_ptr = J_NULL;
+
+    do
+    {
+        //======================================
+
+        if (jenc_this->jbl_work)
+        {
+            jit_err = JENC_ERR_WORKING;
+            break;
+        }
+
+        jenc_ptr = &jenc_this->jenc_obj;
+
+        //======================================
+        // 输入参数已经被检查过
+
+        if (!jenc_ccs_valid(jccs_conv))
+        {
+            jit_err = JENC_ERR_CCS_VALUE;
+            break;
+        }
+
+        if ((jut_imgw <= 0) || (jut_imgh <= 0))
+        {
+            jit_err = JENC_ERR_IMAGE_ZEROSIZE;
+            break;
+        }
+
+        if ((jut_imgw > JPEG_MAX_DIMENSION) || (jut_imgh > JPEG_MAX_DIMENSION))
+        {
+            jit_err = JENC_ERR_IMAGE_OVERSIZE;
+            break;
+        }
+
+        //======================================
+        // 设置错误回调跳转代码
+
+        if (0 != setjmp(jenc_this->jerr_mgr.jerr_jmp))
+        {
+            jit_err = JENC_ERR_EXCEPTION;
+            goto __EXIT_FUNC;
+        }
+
+        //======================================
+        // 设置输出目标
+
+        jit_err = jenc_setup_dest(jenc_this);
+        if (JENC_ERR_OK != jit_err)
+        {
+            break;
+        }
+
+        //======================================
+
+        jenc_setup_params(
+            jenc_ptr, jccs_conv, jut_imgw, jut_imgh, jenc_this->jit_qual, &jenc_this->jparam);
+        jenc_setup_scans(jenc_ptr, &jenc_this->jparam);
+
+        //======================================
+
+        jpeg_start_compress(jenc_ptr, J_TRUE);
+
+        // 至此，标识 编码器 处于工作状态，等待 jenc_write() 操作
+        jenc_this->jbl_work = J_TRUE;
+
+        //======================================
+        jenc_ptr = J_NULL;
+        jit_err  = JENC_ERR_OK;
+    } while (0);
+
+    //======================================
+
+__EXIT_FUNC:
+    if (J_NULL != jenc_ptr)
+    {
+        jenc_shutdown(jenc_this);
+        jenc_ptr = J_NULL;
+    }
+
+    return jit_err;
+}
+
+/**********************************************************/
+/**
+ * @brief 向 JPEG 编码器写入 图像像素 数据，执行编码操作。
+ * @note 
+ * 执行该操作前，应先调用 jenc_start() 启动编码器；
+ * 而完成所有图像像素行编码操作后，调用 jenc_finish() 结束编码工作。
+ * 
+ * @param [in ] jenc_this : JPEG 编码操作的上下文对象。
+ * @param [in ] jmt_pxls  : JPEG 编码输入的像素缓存，其色彩空间在 jenc_start() 已设置。
+ * @param [in ] jit_step  : 遍历像素行时的 步长值（以 字节 为单位）。
+ * @param [in ] jut_rows  : 此次计划写入像素行的数量。
+ * 
+ * @return j_int_t : 
+ * - 返回值 < 0，表示操作失败，产生错误返回的 错误码，请参看 jenc_errno_t 相关枚举值。
+ * - 返回值 > 0，表示写入的图像像素行数量。
+ * - 返回值 = 0，表示图像像素行已经写满，不可再继续写。
+ */
+j_int_t jenc_write(
+                jenc_this_t jenc_this,
+                j_mptr_t    jmt_pxls,
+                j_int_t     jit_step,
+                j_uint_t    jut_rows)
+{
+    JASSERT(jenc_valid(jenc_this));
+
+    j_int_t  jit_err  = JENC_ERR_UNKNOWN;
+    j_uint_t jut_iter = 0;
+
+    do
+    {
+        //======================================
+
+        if (!jenc_this->jbl_work)
+        {
+            jit_err = JENC_ERR_UNSTART;
+            break;
+        }
+
+        // 若图像已经写满，则直接退出
+        if (jenc_this->jenc_obj.next_scanline >=
+            jenc_this->jenc_obj.image_height)
+        {
+            jit_err = 0;
+            break;
+        }
+
+        //======================================
+        // 验证参数有效性
+
+        if ((J_NULL == jmt_pxls) || (jut_rows <= 0))
+        {
+            jit_err = 0;
+            break;
+        }
+
+        //======================================
+        // 构建输入像素行数组
+
+        jit_err = jenc_grow_rows(jenc_this, jut_rows);
+        if (JENC_ERR_OK != jit_err)
+        {
+            break;
+        }
+
+        for (jut_iter = 0; jut_iter < jut_rows; ++jut_iter)
+        {
+            jenc_this->jrows.jar_rows[jut_iter] = jmt_pxls;
+            jmt_pxls += jit_step;
+        }
+
+        //======================================
+        // 开始向 编码器 写入像素数据
+
+        // 设置错误回调跳转代码后，再执行编码操作
+        if (0 == setjmp(jenc_this->jerr_mgr.jerr_jmp))
+        {
+            for (jut_iter = 0; jut_iter < jut_rows; )
+            {
+                jut_iter += jpeg_write_scanlines(
+                                &jenc_this->jenc_obj,
+                                &jenc_this->jrows.jar_rows[jut_iter],
+                                jut_rows - jut_iter);
+
+                if (jenc_this->jenc_obj.next_scanline >=
+                    jenc_this->jenc_obj.image_height)
+                {
+                    break;
+                }
+            }
+
+            jit_err = (j_int_t)jut_iter;
+        }
+        else
+        {
+            // 异常处理
+            jit_err = JENC_ERR_EXCEPTION;
+
+            // 关闭编码器
+            jenc_shutdown(jenc_this);
+        }
+
+        //======================================
+    } while (0);
+
+    return jit_err;
+}
+
+/**********************************************************/
+/**
+ * @brief 完成（结束） JPEG 编码操作。
+ * 
+ * @param [in ] jenc_this : JPEG 编码操作的上下文对象。
+ * 
+ * @return j_int_t :
+ * - 操作失败时，返回值 < 0，表示 错误码，参看 jenc_errno_t 相关枚举值。
+ * - 操作成功时：
+ *   1. 使用 文件流模式 或 文件模式 时，返回值 == JENC_ERR_OK；
+ *   2. 使用 内存模式 时，返回值 > 0，表示输出源中存储的 JPEG 数据的有效字节数；
+ *   3. 使用 内存模式 时，且 返回值 == JENC_ERR_OK，表示输出源的缓存容量不足，
+ *      而输出的 JPEG 编码数据存储在 jenc_this 的内部缓存中，后续可通过
+ *      jenc_fmdata() 和 jenc_fmsize() 获取此次编码得到的 JPEG 数据。
+ */
+j_int_t jenc_finish(jenc_this_t jenc_this)
+{
+    JASSERT(jenc_valid(jenc_this));
+
+    j_int_t jit_err = JENC_ERR_UNKNOWN;
+
+    //======================================
+
+    if (!jenc_this->jbl_work)
+    {
+        return JENC_ERR_UNSTART;
+    }
+
+    //======================================
+
+    // 设置错误回调跳转代码后，再执行操作
+    if (0 == setjmp(jenc_this->jerr_mgr.jerr_jmp))
+    {
+        jpeg_finish_compress(&jenc_this->jenc_obj);
+
+        if ((JCTL_MODE_FMEMORY == jenc_this->jmode.jct_mode) &&
+            (jenc_this->jbuff.jmt_mptr == jenc_this->jmode.jmt_optr))
+        {
+            jit_err = (j_int_t)jenc_this->jbuff.jst_size;
+        }
+        else
+        {
+            jit_err = JENC_ERR_OK;
+        }
+    }
+    else
+    {
+        // 异常处理
+        jit_err = JENC_ERR_EXCEPTION;
+    }
+
+    //======================================
+    // 关闭编码器
+
+    jenc_shutdown(jenc_this);
+
+    //======================================
+
+    return jit_err;
+}
+
+/**********************************************************/
+/**
+ * @brief 对整幅图像像素数据进行 JPEG 编码压缩操作。
+ * @note 
+ * 操作前，应先使用 jenc_config() 配置好输出模式。
+ * 该接口使用 jenc_start()/jenc_write()/jenc_finish() 实现。
+ * 
+ * @param [in ] jenc_this : JPEG 编码操作的上下文对象。
+ * @param [in ] jccs_conv : 设置色彩空间的转换方式（参看 jenc_ccs_t）。
+ * @param [in ] jmt_pxls  : 图像的像素缓存。
+ * @param [in ] jit_step  : 遍历像素行时的 步长值（以 字节 为单位）。
+ * @param [in ] jut_imgw  : 设置编码输出图像的宽度（以像素为单位）。
+ * @param [in ] jut_imgh  : 设置编码输出图像的高度（以像素为单位）。
+ * 
+ * @return j_int_t :
+ * - 操作失败时，返回值 < 0，表示 错误码，参看 jenc_errno_t 相关枚举值。
+ * - 操作成功时：
+ *   1. 使用 文件流模式 或 文件模式 时，返回值 == JENC_ERR_OK；
+ *   2. 使用 内存模式 时，返回值 > 0，表示输出源中存储的 JPEG 数据的有效字节数；
+ *   3. 使用 内存模式 时，且 返回值 == JENC_ERR_OK，表示输出源的缓存容量不足，
+ *      而输出的 JPEG 编码数据存储在 jenc_this 的内部缓存中，后续可通过
+ *      jenc_fmdata() 和 jenc_fmsize() 获取此次编码得到的 JPEG 数据。
+ */
+j_int_t jenc_image(
+                jenc_this_t jenc_this,
+                jenc_ccs_t  jccs_conv,
+                j_mptr_t    jmt_pxls,
+                j_int_t     jit_step,
+                j_uint_t    jut_imgw,
+                j_uint_t    jut_imgh)
+{
+    j_int_t jit_err;
+
+    jit_err = jenc_start(jenc_this, jccs_conv, jut_imgw, jut_imgh);
     if (JENC_ERR_OK != jit_err)
     {
-        jenc_this->jmode.jct_mode = JCTL_MODE_UNKNOWN;
-        jenc_this->jmode.jst_mlen = J_NULL;
-        jenc_this->jmode.jmt_optr = J_NULL;
-
         return jit_err;
     }
 
-    //======================================
-
-    if (0 == jut_qual)
-        jenc_this->jit_qual = JENC_DEF_QUALITY;
-    else if (jut_qual > 100)
-        jenc_this->jit_qual = 100;
-    else
-        jenc_this->jit_qual = (j_int_t)jut_qual;
-
-    //======================================
-
-    return JENC_ERR_OK;
-}
-
-/**********************************************************/
-/**
- * @brief 在内存模式下，执行编码压缩操作后，所缓存的 JPEG 数据流地址。
- */
-j_mptr_t jenc_fmdata(jenc_this_t jenc_this)
-{
-    return jenc_this->jbuff.jmt_mptr;
-}
+    jit_err = jenc_write(jenc_this, jmt_pxls, jit_step, jut_imgh);
+    if (jit_err < 0)
+    {
+        return jit_err;
+    }
 
-/**********************************************************/
-/**
- * @brief 在内存模式下，执行编码压缩操作后，所缓存的 JPEG 数据流有效字节数。
- */
-j_uint_t jenc_fmsize(jenc_this_t jenc_this)
-{
-    return (j_uint_t)jenc_this->jbuff.jst_size;
+    return jenc_finish(jenc_this);
 }
 
 /**********************************************************/
 /**
- * @brief 启动 JPEG 编码操作。
- * @note  启动编码器前，应先调用 jenc_config() 配置好输出模式。
+ * @brief 按水平条带划分图像，使用多个工作线程并行进行 JPEG 编码压缩操作。
+ * @note
+ * 1. 操作前，应先使用 jenc_config() 配置好输出模式；
+ * 2. 图像按 MCU 行划分为多个条带，各个条带使用相同的 量化表 和 哈夫曼表
+ *    独立编码，并以条带的 MCU 数量作为重启间隔（DRI），拼接成一个
+ *    标准的 baseline JPEG 数据流，条带间的熵编码数据段 以 RSTn 标记分隔；
+ * 3. 条带的划分只与 图像尺寸 和 jut_srows 有关，与工作线程数量无关，
+ *    所以，任意线程数量下的编码输出结果都完全相同；
+ * 4. 图像只有一个条带时，等同于 jenc_image() 操作（不带重启间隔）；
+ * 5. jenc_config_param() 设置的 采样因子 与 哈夫曼表优化 同样有效，
+ *    优化哈夫曼表时，拼接后的数据流 再以无损转码的方式 重新熵编码一次；
+ *    而 渐进模式 与 重启间隔 同条带的拼接方式冲突，设置时返回 JENC_ERR_EPARAM 。
  * 
  * @param [in ] jenc_this : JPEG 编码操作的上下文对象。
  * @param [in ] jccs_conv : 设置色彩空间的转换方式（参看 jenc_ccs_t）。
+ * @param [in ] jmt_pxls  : 图像的像素缓存。
+ * @param [in ] jit_step  : 遍历像素行时的 步长值（以 字节 为单位）。
  * @param [in ] jut_imgw  : 设置编码输出图像的宽度（以像素为单位）。
  * @param [in ] jut_imgh  : 设置编码输出图像的高度（以像素为单位）。
+ * @param [in ] jut_nthd  : 工作线程数量（为 0 时，取 CPU 核心数量）。
+ * @param [in ] jut_srows : 每个条带包含的 MCU 行数量（为 0 时，取默认值）。
  * 
- * @return j_int_t : 错误码，请参看 jenc_errno_t 相关枚举值。
+ * @return j_int_t : 返回值的含义，与 jenc_image() 的返回值相同。
  */
-j_int_t jenc_start(
+j_int_t jenc_image_mt(
                 jenc_this_t jenc_this,
                 jenc_ccs_t  jccs_conv,
+                j_mptr_t    jmt_pxls,
+                j_int_t     jit_step,
                 j_uint_t    jut_imgw,
-                j_uint_t    jut_imgh)
+                j_uint_t    jut_imgh,
+                j_uint_t    jut_nthd,
+                j_uint_t    jut_srows)
 {
     JASSERT(jenc_valid(jenc_this));
 
-    j_int_t      jit_err  = JENC_ERR_UNKNOWN;
-    jenc_obj_t * jenc_ptr = J_NULL;
-    j_uint_t     jut_size = 0;
+    j_int_t        jit_err  = JENC_ERR_UNKNOWN;
+    j_uint_t       jut_iter = 0;
+    j_uint_t       jut_mcuw = 0;
+    j_uint_t       jut_mcuh = 0;
+    j_uint_t       jut_ncol = 0;
+    j_uint_t       jut_nstr = 0;
+    jenc_mtctx_t * jmtctx_ptr = J_NULL;
 
     do
     {
@@ -459,11 +2226,6 @@ j_int_t jenc_start(
             break;
         }
 
-        jenc_ptr = &jenc_this->jenc_obj;
-
-        //======================================
-        // 输入参数已经被检查过
-
         if (!jenc_ccs_valid(jccs_conv))
         {
             jit_err = JENC_ERR_CCS_VALUE;
@@ -482,17 +2244,14 @@ j_int_t jenc_start(
             break;
         }
 
-        //======================================
-        // 设置错误回调跳转代码
-
-        if (0 != setjmp(jenc_this->jerr_mgr.jerr_jmp))
+        if (J_NULL == jmt_pxls)
         {
-            jit_err = JENC_ERR_EXCEPTION;
-            goto __EXIT_FUNC;
+            jit_err = JENC_ERR_EPARAM;
+            break;
         }
 
         //======================================
-        // 设置输出目标
+        // 检查输出模式
 
         if (JCTL_MODE_FMEMORY == jenc_this->jmode.jct_mode)
         {
@@ -501,13 +2260,8 @@ j_int_t jenc_start(
                 free(jenc_this->jbuff.jmt_mptr);
             }
 
-            jenc_this->jbuff.jst_size = jenc_this->jmode.jst_mlen;
-            jenc_this->jbuff.jmt_mptr = jenc_this->jmode.jmt_optr;
-
-            jpeg_mem_dest(
-                jenc_ptr,
-                &jenc_this->jbuff.jmt_mptr,
-                &jenc_this->jbuff.jst_size);
+            jenc_this->jbuff.jst_size = 0;
+            jenc_this->jbuff.jmt_mptr = J_NULL;
         }
         else if (JCTL_MODE_FSTREAM == jenc_this->jmode.jct_mode)
         {
@@ -516,9 +2270,6 @@ j_int_t jenc_start(
                 jit_err = JENC_ERR_FSTREAM_ISNULL;
                 break;
             }
-
-            fgetpos(jenc_this->jmode.jfs_ostr, &jenc_this->jmode.jfp_spos);
-            jpeg_stdio_dest(jenc_ptr, jenc_this->jmode.jfs_ostr);
         }
         else if (JCTL_MODE_FSZPATH == jenc_this->jmode.jct_mode)
         {
@@ -528,280 +2279,768 @@ j_int_t jenc_start(
                 jit_err = JENC_ERR_FSZPATH_ISNULL;
                 break;
             }
+        }
+        else
+        {
+            jit_err = JENC_ERR_UNCONFIG;
+            break;
+        }
+
+        //======================================
+        // 条带 以重启间隔拼接，不能再使用 渐进模式 或 另外设置重启间隔
+
+        if ((1 == jenc_this->jparam.jit_prog) || (jenc_this->jparam.jit_rrows > 0))
+        {
+            jit_err = JENC_ERR_EPARAM;
+            break;
+        }
+
+        //======================================
+        // 使用与 jenc_start() 相同的编码参数，计算 MCU 的尺寸
+
+        jit_err = jenc_mcu_size(
+                    jenc_this, jccs_conv, jut_imgw, jut_imgh, &jut_mcuw, &jut_mcuh);
+        if (JENC_ERR_OK != jit_err)
+        {
+            break;
+        }
+
+        //======================================
+        // 划分条带（重启间隔 最大为 65535 个 MCU）
+
+        jut_ncol = (jut_imgw + jut_mcuw - 1) / jut_mcuw;
+
+        if (0 == jut_srows)
+            jut_srows = JENC_DEF_SROWS;
+        if (jut_srows > 0xFFFF / jut_ncol)
+            jut_srows = 0xFFFF / jut_ncol;
+
+        jut_nstr = (jut_imgh + jut_srows * jut_mcuh - 1) / (jut_srows * jut_mcuh);
+        if (jut_nstr <= 1)
+        {
+            jit_err = jenc_image(
+                        jenc_this,
+                        jccs_conv,
+                        jmt_pxls,
+                        jit_step,
+                        jut_imgw,
+                        jut_imgh);
+            break;
+        }
+
+        //======================================
+        // 并行编码各个条带
+
+        jmtctx_ptr = (jenc_mtctx_t *)calloc(1, sizeof(jenc_mtctx_t));
+        if (J_NULL == jmtctx_ptr)
+        {
+            jit_err = JENC_ERR_MALLOC;
+            break;
+        }
+
+        jmtctx_ptr->jstripes =
+            (jenc_stripe_t *)calloc(jut_nstr, sizeof(jenc_stripe_t));
+        if (J_NULL == jmtctx_ptr->jstripes)
+        {
+            jit_err = JENC_ERR_MALLOC;
+            break;
+        }
+
+        jmtctx_ptr->jccs_conv = jccs_conv;
+        jmtctx_ptr->jmt_pxls  = jmt_pxls;
+        jmtctx_ptr->jit_step  = jit_step;
+        jmtctx_ptr->jut_imgw  = jut_imgw;
+        jmtctx_ptr->jut_imgh  = jut_imgh;
+        jmtctx_ptr->jut_qual  = (j_uint_t)jenc_this->jit_qual;
+        jmtctx_ptr->jut_prow  = jut_srows * jut_mcuh;
+
+        // 条带只使用 采样因子，哈夫曼表 在拼接后统一优化
+        jmtctx_ptr->jparam.jit_hsamp = jenc_this->jparam.jit_hsamp;
+        jmtctx_ptr->jparam.jit_vsamp = jenc_this->jparam.jit_vsamp;
+        jmtctx_ptr->jparam.jit_prog  = JENC_PARAM_DEFAULT;
+        jmtctx_ptr->jparam.jit_rrows = JENC_PARAM_DEFAULT;
+        jmtctx_ptr->jparam.jbl_optim = J_FALSE;
+
+        jenc_this->jbl_work = J_TRUE;
+        jthrd_parallel(jut_nthd, jut_nstr, jenc_stripe_task, jmtctx_ptr);
+        jenc_this->jbl_work = J_FALSE;
 
-            jenc_this->jmode.jfs_file = 
-                fopen((j_fszpath_t)jenc_this->jmode.jsz_path, "wb+");
-            if (J_NULL == jenc_this->jmode.jfs_file)
+        // 按条带顺序取第一个错误码，保证结果与线程数量无关
+        jit_err = JENC_ERR_OK;
+        for (jut_iter = 0; jut_iter < jut_nstr; ++jut_iter)
+        {
+            if (JENC_ERR_OK != jmtctx_ptr->jstripes[jut_iter].jit_err)
             {
-                jit_err = JENC_ERR_FOPEN;
+                jit_err = jmtctx_ptr->jstripes[jut_iter].jit_err;
                 break;
             }
+        }
+
+        if (JENC_ERR_OK != jit_err)
+        {
+            break;
+        }
+
+        //======================================
+        // 拼接输出
+
+        if (jenc_this->jparam.jbl_optim)
+        {
+            jit_err = jenc_stripe_optimize(
+                        jenc_this,
+                        jmtctx_ptr->jstripes,
+                        jut_nstr,
+                        jut_imgh,
+                        jut_srows * jut_ncol);
+        }
+        else
+        {
+            jit_err = jenc_stripe_output(
+                        jenc_this,
+                        jmtctx_ptr->jstripes,
+                        jut_nstr,
+                        jut_imgh,
+                        jut_srows * jut_ncol);
+        }
+
+        //======================================
+    } while (0);
+
+    //======================================
+
+    if (J_NULL != jmtctx_ptr)
+    {
+        for (jut_iter = 0; jut_iter < JTHRD_MAX_WORKERS; ++jut_iter)
+        {
+            if (J_NULL != jmtctx_ptr->jenc_arr[jut_iter])
+                jenc_release(jmtctx_ptr->jenc_arr[jut_iter]);
+        }
+
+        if (J_NULL != jmtctx_ptr->jstripes)
+        {
+            for (jut_iter = 0; jut_iter < jut_nstr; ++jut_iter)
+            {
+                if (J_NULL != jmtctx_ptr->jstripes[jut_iter].jmt_data)
+                    free(jmtctx_ptr->jstripes[jut_iter].jmt_data);
+            }
+
+            free(jmtctx_ptr->jstripes);
+        }
+
+        free(jmtctx_ptr);
+        jmtctx_ptr = J_NULL;
+    }
+
+    return jit_err;
+}
+
+/**********************************************************/
+/**
+ * @brief 使用多个工作线程，批量执行 JPEG 编码任务。
+ * @note
+ * 1. 各个编码任务由工作线程以 任务窃取 的方式调度执行，每个工作线程
+ *    使用各自的 编码器上下文 与 内存输出缓存，并在其执行的多个任务间重复使用；
+ * 2. 内存模式的任务，编码数据先输出至工作线程的内部缓存，完成后再拷贝至
+ *    任务指定的输出缓存；若指定缓存为 J_NULL 或 容量不足，该任务的
+ *    jit_err 置为 JENC_ERR_OVERFLOW，jst_size 返回所需的缓存容量；
+ * 3. 各个任务的执行结果，存放在其 jit_err、jst_size 与 jdt_time 字段中，
+ *    任务成功时，jit_err == JENC_ERR_OK ；
+ * 4. 各个任务的编码参数 由其 jparam_ptr 字段指定（为 J_NULL 时，取默认值），
+ *    参数无效的任务，其 jit_err 置为 JENC_ERR_EPARAM 。
+ * 
+ * @param [in ] jjob_arr : 编码任务数组（各个任务的执行结果，也回写于其中）。
+ * @param [in ] jut_njob : 编码任务数量。
+ * @param [in ] jut_nthd : 工作线程数量（为 0 时，取 CPU 核心数量）。
+ * 
+ * @return j_int_t :
+ * - 返回值 >= 0，表示执行成功的任务数量；
+ * - 返回值 <  0，表示 错误码，参看 jenc_errno_t 相关枚举值。
+ */
+j_int_t jenc_batch(
+                jenc_job_t * jjob_arr,
+                j_uint_t     jut_njob,
+                j_uint_t     jut_nthd)
+{
+    jenc_bctx_t * jbctx_ptr = J_NULL;
+    j_uint_t      jut_iter  = 0;
+    j_int_t       jit_nsuc  = 0;
+
+    //======================================
+
+    if ((J_NULL == jjob_arr) && (jut_njob > 0))
+    {
+        return JENC_ERR_EPARAM;
+    }
+
+    if (0 == jut_njob)
+    {
+        return 0;
+    }
+
+    jbctx_ptr = (jenc_bctx_t *)calloc(1, sizeof(jenc_bctx_t));
+    if (J_NULL == jbctx_ptr)
+    {
+        return JENC_ERR_MALLOC;
+    }
+
+    //======================================
+
+    jbctx_ptr->jjob_arr = jjob_arr;
+    jthrd_parallel(jut_nthd, jut_njob, jenc_batch_task, jbctx_ptr);
+
+    for (jut_iter = 0; jut_iter < jut_njob; ++jut_iter)
+    {
+        if (JENC_ERR_OK == jjob_arr[jut_iter].jit_err)
+            jit_nsuc += 1;
+    }
+
+    //======================================
+
+    jenc_batch_free(jbctx_ptr);
+
+    //======================================
+
+    return jit_nsuc;
+}
+
+/**********************************************************/
+/**
+ * @brief 对同一幅图像，按多个压缩质量 编码输出多份 JPEG 数据（质量阶梯）。
+ * @note
+ * 1. 色彩转换、降采样 与 DCT 变换 只执行一次（捕获 未量化 的 DCT 系数），
+ *    之后各个任务（阶梯）只执行 重新量化 与 熵编码，并由多个工作线程并行执行；
+ * 2. 重新量化 与 libjpeg 的量化方式完全一致，各个输出数据流 与 逐个调用
+ *    jenc_image() 的结果 逐字节相同；
+ * 3. 各个任务只使用 jut_qual、jparam_ptr、jct_mode、jht_optr、jst_mlen
+ *    这几个输入字段，其图像参数字段（jccs_conv ~ jut_imgh），由本接口按输入参数填写；
+ * 4. DCT 系数 按第一个任务的 采样因子 捕获，其他任务的 采样因子 须与之相同，
+ *    否则其 jit_err 置为 JENC_ERR_EPARAM；扫描模式、重启间隔 与 哈夫曼表优化
+ *    则可逐个任务设置；
+ * 5. 任务的输出方式 与 执行结果，同 jenc_batch() 的说明。
+ * 
+ * @param [in ] jccs_conv : 设置色彩空间的转换方式（参看 jenc_ccs_t）。
+ * @param [in ] jmt_pxls  : 图像的像素缓存。
+ * @param [in ] jit_step  : 遍历像素行时的 步长值（以 字节 为单位）。
+ * @param [in ] jut_imgw  : 设置编码输出图像的宽度（以像素为单位）。
+ * @param [in ] jut_imgh  : 设置编码输出图像的高度（以像素为单位）。
+ * @param [in ] jjob_arr  : 编码任务数组（每个任务对应一个压缩质量）。
+ * @param [in ] jut_njob  : 编码任务数量。
+ * @param [in ] jut_nthd  : 工作线程数量（为 0 时，取 CPU 核心数量）。
+ * 
+ * @return j_int_t :
+ * - 返回值 >= 0，表示执行成功的任务数量；
+ * - 返回值 <  0，表示 错误码，参看 jenc_errno_t 相关枚举值。
+ */
+j_int_t jenc_ladder(
+                jenc_ccs_t   jccs_conv,
+                j_mptr_t     jmt_pxls,
+                j_int_t      jit_step,
+                j_uint_t     jut_imgw,
+                j_uint_t     jut_imgh,
+                jenc_job_t * jjob_arr,
+                j_uint_t     jut_njob,
+                j_uint_t     jut_nthd)
+{
+    jenc_bctx_t * jbctx_ptr = J_NULL;
+    jenc_coef_t * jcoef_ptr = J_NULL;
+    j_uint_t      jut_iter  = 0;
+    j_int_t       jit_err   = JENC_ERR_UNKNOWN;
+
+    //======================================
+
+    if ((J_NULL == jjob_arr) && (jut_njob > 0))
+    {
+        return JENC_ERR_EPARAM;
+    }
+
+    if (0 == jut_njob)
+    {
+        return 0;
+    }
+
+    if (!jenc_ccs_valid(jccs_conv))
+    {
+        return JENC_ERR_CCS_VALUE;
+    }
+
+    if ((jut_imgw <= 0) || (jut_imgh <= 0))
+    {
+        return JENC_ERR_IMAGE_ZEROSIZE;
+    }
+
+    if ((jut_imgw > JPEG_MAX_DIMENSION) || (jut_imgh > JPEG_MAX_DIMENSION))
+    {
+        return JENC_ERR_IMAGE_OVERSIZE;
+    }
+
+    if (J_NULL == jmt_pxls)
+    {
+        return JENC_ERR_EPARAM;
+    }
+
+    for (jut_iter = 0; jut_iter < jut_njob; ++jut_iter)
+    {
+        jjob_arr[jut_iter].jccs_conv = jccs_conv;
+        jjob_arr[jut_iter].jmt_pxls  = jmt_pxls;
+        jjob_arr[jut_iter].jit_step  = jit_step;
+        jjob_arr[jut_iter].jut_imgw  = jut_imgw;
+        jjob_arr[jut_iter].jut_imgh  = jut_imgh;
+        jjob_arr[jut_iter].jit_err   = JENC_ERR_UNKNOWN;
+        jjob_arr[jut_iter].jst_size  = 0;
+    }
+
+    //======================================
+
+    do
+    {
+        jbctx_ptr = (jenc_bctx_t *)calloc(1, sizeof(jenc_bctx_t));
+        jcoef_ptr = (jenc_coef_t *)calloc(1, sizeof(jenc_coef_t));
+        if ((J_NULL == jbctx_ptr) || (J_NULL == jcoef_ptr))
+        {
+            jit_err = JENC_ERR_MALLOC;
+            break;
+        }
+
+        // 0 号工作线程 即为调用线程，其编码器 先用于捕获 DCT 系数
+        jbctx_ptr->jwork_arr[0].jenc_this = jenc_alloc(J_NULL);
+        if (J_NULL == jbctx_ptr->jwork_arr[0].jenc_this)
+        {
+            jit_err = JENC_ERR_MALLOC;
+            break;
+        }
+
+        // 以第一个任务的 采样因子 捕获 DCT 系数
+        jit_err = jenc_config_param(
+                    jbctx_ptr->jwork_arr[0].jenc_this, jjob_arr[0].jparam_ptr);
+        if (JENC_ERR_OK != jit_err)
+        {
+            break;
+        }
+
+        jit_err = jenc_coef_capture(
+                    jbctx_ptr->jwork_arr[0].jenc_this,
+                    jcoef_ptr,
+                    jccs_conv,
+                    jmt_pxls,
+                    jit_step,
+                    jut_imgw,
+                    jut_imgh);
+        if (JENC_ERR_OK != jit_err)
+        {
+            break;
+        }
+
+        //======================================
+
+        jbctx_ptr->jjob_arr  = jjob_arr;
+        jbctx_ptr->jcoef_ptr = jcoef_ptr;
+        jthrd_parallel(jut_nthd, jut_njob, jenc_batch_task, jbctx_ptr);
+
+        jit_err = 0;
+        for (jut_iter = 0; jut_iter < jut_njob; ++jut_iter)
+        {
+            if (JENC_ERR_OK == jjob_arr[jut_iter].jit_err)
+                jit_err += 1;
+        }
+    } while (0);
+
+    //======================================
+
+    if (J_NULL != jbctx_ptr)
+    {
+        jenc_batch_free(jbctx_ptr);
+        jbctx_ptr = J_NULL;
+    }
+
+    if (J_NULL != jcoef_ptr)
+    {
+        jenc_coef_free(jcoef_ptr);
+        free(jcoef_ptr);
+        jcoef_ptr = J_NULL;
+    }
+
+    return jit_err;
+}
+
+/**********************************************************/
+/**
+ * @brief 从同一幅图像（的像素缓存）中，裁剪多个区域，并行编码输出多份 JPEG 数据。
+ * @note
+ * 1. 每个裁剪区域 作为一个编码任务，由 jenc_batch() 的工作线程并行执行，
+ *    各个任务直接引用 jmt_pxls 中对应的像素，不做拷贝；
+ * 2. jmt_pxls 可以只是图像的一个水平条带（例如 只解码了 全部裁剪区域所覆盖的
+ *    像素行），此时 裁剪区域的坐标 与 jut_imgw、jut_imgh 均相对于该条带；
+ * 3. 各个任务只使用 jut_qual、jparam_ptr、jct_mode、jht_optr、jst_mlen
+ *    这几个输入字段，其图像参数字段（jccs_conv ~ jut_imgh），由本接口按 对应的裁剪区域 填写；
+ *    裁剪区域为空 或 超出图像范围的任务，其 jit_err 置为 JENC_ERR_EPARAM；
+ * 4. 任务的输出方式 与 执行结果，同 jenc_batch() 的说明。
+ * 
+ * @param [in ] jccs_conv : 设置色彩空间的转换方式（参看 jenc_ccs_t）。
+ * @param [in ] jmt_pxls  : 图像的像素缓存。
+ * @param [in ] jit_step  : 遍历像素行时的 步长值（以 字节 为单位）。
+ * @param [in ] jut_imgw  : 像素缓存中 图像的宽度（以像素为单位）。
+ * @param [in ] jut_imgh  : 像素缓存中 图像的高度（以像素为单位）。
+ * @param [in ] jrect_arr : 裁剪区域数组（与 jjob_arr 一一对应）。
+ * @param [in ] jjob_arr  : 编码任务数组（每个任务对应一个裁剪区域）。
+ * @param [in ] jut_njob  : 编码任务数量。
+ * @param [in ] jut_nthd  : 工作线程数量（为 0 时，取 CPU 核心数量）。
+ * 
+ * @return j_int_t :
+ * - 返回值 >= 0，表示执行成功的任务数量；
+ * - 返回值 <  0，表示 错误码，参看 jenc_errno_t 相关枚举值。
+ */
+j_int_t jenc_crops(
+                jenc_ccs_t          jccs_conv,
+                j_mptr_t            jmt_pxls,
+                j_int_t             jit_step,
+                j_uint_t            jut_imgw,
+                j_uint_t            jut_imgh,
+                const j_rect_t    * jrect_arr,
+                jenc_job_t        * jjob_arr,
+                j_uint_t            jut_njob,
+                j_uint_t            jut_nthd)
+{
+    jenc_job_t        * jjob_vset = J_NULL;
+    const j_rect_t    * jrect_ptr = J_NULL;
+    j_uint_t            jut_iter  = 0;
+    j_uint_t            jut_nval  = 0;
+    j_uint_t            jut_ncpt  = 0;
+    j_int_t             jit_err   = JENC_ERR_UNKNOWN;
 
-            jpeg_stdio_dest(jenc_ptr, jenc_this->jmode.jfs_file);
-        }
-        else
-        {
-            jit_err = JENC_ERR_UNCONFIG;
-            break;
-        }
+    //======================================
 
-        //======================================
+    if (((J_NULL == jjob_arr) || (J_NULL == jrect_arr)) && (jut_njob > 0))
+    {
+        return JENC_ERR_EPARAM;
+    }
 
-        // 参数验证阶段，可保证 以下断言代码不会被触发
-        JASSERT(JCS_UNKNOWN != jcs_to_lib(JENC_CCS_IN(jccs_conv)));
-        JASSERT(JCS_UNKNOWN != jcs_to_lib(JENC_CCS_OUT(jccs_conv)));
+    if (0 == jut_njob)
+    {
+        return 0;
+    }
 
-        jenc_ptr->image_width  = (j_int_t)jut_imgw;
-        jenc_ptr->image_height = (j_int_t)jut_imgh;
+    if (!jenc_ccs_valid(jccs_conv))
+    {
+        return JENC_ERR_CCS_VALUE;
+    }
 
-        // 配置 JPEG 编码输入的色彩空间及通道数量
-        jenc_ptr->input_components = JENC_CCS_NUMC(jccs_conv);
-        jenc_ptr->in_color_space   = jcs_to_lib(JENC_CCS_IN(jccs_conv));
+    if (J_NULL == jmt_pxls)
+    {
+        return JENC_ERR_EPARAM;
+    }
 
-        jpeg_set_defaults(jenc_ptr);
-        jpeg_set_quality(jenc_ptr, jenc_this->jit_qual, J_TRUE);
+    // 有效的裁剪区域，其任务 拷贝至 jjob_vset 中，交由 jenc_batch() 执行，
+    // 无效的裁剪区域 不执行编码（也就不会 创建/截断 其输出文件）
+    jjob_vset = (jenc_job_t *)malloc(jut_njob * sizeof(jenc_job_t));
+    if (J_NULL == jjob_vset)
+    {
+        return JENC_ERR_MALLOC;
+    }
 
-        // 配置 JPEG 编码输出的色彩空间
-        jpeg_set_colorspace(jenc_ptr, jcs_to_lib(JENC_CCS_OUT(jccs_conv)));
+    jut_ncpt = JENC_CCS_NUMC(jccs_conv);
 
-        //======================================
+    //======================================
 
-        jpeg_start_compress(jenc_ptr, J_TRUE);
+    for (jut_iter = 0; jut_iter < jut_njob; ++jut_iter)
+    {
+        jrect_ptr = &jrect_arr[jut_iter];
+
+        jjob_arr[jut_iter].jccs_conv = jccs_conv;
+        jjob_arr[jut_iter].jit_step  = jit_step;
+        jjob_arr[jut_iter].jit_err   = JENC_ERR_EPARAM;
+        jjob_arr[jut_iter].jst_size  = 0;
+        jjob_arr[jut_iter].jdt_time  = 0.0;
+
+        if ((jrect_ptr->jit_x < 0) || (jrect_ptr->jit_y < 0) ||
+            (jrect_ptr->jit_w <= 0) || (jrect_ptr->jit_h <= 0) ||
+            ((j_uint_t)jrect_ptr->jit_w > jut_imgw) ||
+            ((j_uint_t)jrect_ptr->jit_h > jut_imgh) ||
+            ((j_uint_t)jrect_ptr->jit_x > jut_imgw - (j_uint_t)jrect_ptr->jit_w) ||
+            ((j_uint_t)jrect_ptr->jit_y > jut_imgh - (j_uint_t)jrect_ptr->jit_h))
+        {
+            jjob_arr[jut_iter].jmt_pxls = J_NULL;
+            jjob_arr[jut_iter].jut_imgw = 0;
+            jjob_arr[jut_iter].jut_imgh = 0;
+            continue;
+        }
 
-        // 至此，标识 编码器 处于工作状态，等待 jenc_write() 操作
-        jenc_this->jbl_work = J_TRUE;
+        jjob_arr[jut_iter].jmt_pxls = jmt_pxls +
+                                      (j_long_t)jit_step * jrect_ptr->jit_y +
+                                      (j_long_t)jut_ncpt * jrect_ptr->jit_x;
+        jjob_arr[jut_iter].jut_imgw = (j_uint_t)jrect_ptr->jit_w;
+        jjob_arr[jut_iter].jut_imgh = (j_uint_t)jrect_ptr->jit_h;
 
-        //======================================
-        jenc_ptr = J_NULL;
-        jit_err  = JENC_ERR_OK;
-    } while (0);
+        jjob_vset[jut_nval++] = jjob_arr[jut_iter];
+    }
 
     //======================================
 
-__EXIT_FUNC:
-    if (J_NULL != jenc_ptr)
+    jit_err = jenc_batch(jjob_vset, jut_nval, jut_nthd);
+    if (jit_err >= 0)
     {
-        jenc_shutdown(jenc_this);
-        jenc_ptr = J_NULL;
+        for (jut_iter = 0, jut_nval = 0; jut_iter < jut_njob; ++jut_iter)
+        {
+            if (J_NULL != jjob_arr[jut_iter].jmt_pxls)
+                jjob_arr[jut_iter] = jjob_vset[jut_nval++];
+        }
     }
 
+    free(jjob_vset);
+
+    //======================================
+
     return jit_err;
 }
 
 /**********************************************************/
 /**
- * @brief 向 JPEG 编码器写入 图像像素 数据，执行编码操作。
- * @note 
- * 执行该操作前，应先调用 jenc_start() 启动编码器；
- * 而完成所有图像像素行编码操作后，调用 jenc_finish() 结束编码工作。
+ * @brief 在指定的 目标字节数 以内，以尽可能高的压缩质量 进行 JPEG 编码压缩操作。
+ * @note
+ * 1. 操作前，应先使用 jenc_config() 配置好输出模式，其配置的压缩质量，
+ *    作为搜索压缩质量的 上限值；
+ * 2. 色彩转换、降采样 与 DCT 变换 只执行一次（捕获 未量化 的 DCT 系数），
+ *    搜索压缩质量时，每次尝试只执行 重新量化 与 熵编码，通常尝试 3 ~ 5 次；
+ * 3. 重新量化 与 libjpeg 的量化方式完全一致，输出数据流 与 按最终压缩质量
+ *    调用 jenc_image() 的结果 逐字节相同；
+ * 4. 压缩质量为 1 时仍超出目标字节数，则返回 JENC_ERR_TARGET_SIZE，
+ *    此时 内存模式 的输出内容 是无效的。
  * 
  * @param [in ] jenc_this : JPEG 编码操作的上下文对象。
- * @param [in ] jmt_pxls  : JPEG 编码输入的像素缓存，其色彩空间在 jenc_start() 已设置。
+ * @param [in ] jccs_conv : 设置色彩空间的转换方式（参看 jenc_ccs_t）。
+ * @param [in ] jmt_pxls  : 图像的像素缓存。
  * @param [in ] jit_step  : 遍历像素行时的 步长值（以 字节 为单位）。
- * @param [in ] jut_rows  : 此次计划写入像素行的数量。
+ * @param [in ] jut_imgw  : 设置编码输出图像的宽度（以像素为单位）。
+ * @param [in ] jut_imgh  : 设置编码输出图像的高度（以像素为单位）。
+ * @param [in ] jst_tsize : 输出 JPEG 数据的 目标字节数（上限值）。
+ * @param [out] jut_qual  : 操作成功时，返回最终使用的压缩质量（可为 J_NULL）。
  * 
- * @return j_int_t : 
- * - 返回值 < 0，表示操作失败，产生错误返回的 错误码，请参看 jenc_errno_t 相关枚举值。
- * - 返回值 > 0，表示写入的图像像素行数量。
- * - 返回值 = 0，表示图像像素行已经写满，不可再继续写。
+ * @return j_int_t : 返回值的含义，与 jenc_image() 的返回值相同。
  */
-j_int_t jenc_write(
+j_int_t jenc_image_target_size(
                 jenc_this_t jenc_this,
+                jenc_ccs_t  jccs_conv,
                 j_mptr_t    jmt_pxls,
                 j_int_t     jit_step,
-                j_uint_t    jut_rows)
+                j_uint_t    jut_imgw,
+                j_uint_t    jut_imgh,
+                j_size_t    jst_tsize,
+                j_uint_t  * jut_qual)
 {
     JASSERT(jenc_valid(jenc_this));
 
-    j_int_t  jit_err  = JENC_ERR_UNKNOWN;
-    j_uint_t jut_iter = 0;
+    j_int_t       jit_err  = JENC_ERR_UNKNOWN;
+    jenc_this_t   jenc_test = J_NULL;
+    jenc_this_t   jenc_tptr = J_NULL;
+    jenc_coef_t * jcoef_ptr = J_NULL;
+    j_int_t       jit_qval  = 0;
+    j_int_t       jit_qlow  = 0;
+    j_int_t       jit_qupr  = jenc_this->jit_qual + 1;
+    j_int_t       jit_wold  = 0;
+    j_int_t       jit_tret  = 0;
+    j_int_t       jit_bret  = 0;
+    j_size_t      jst_slow  = 0;
+    j_size_t      jst_supr  = 0;
+    j_size_t      jst_size  = 0;
+    double        jdt_lupr  = 0.0;
+    double        jdt_kval  = 0.0;
+    j_uint_t      jut_nbad  = 0;
+    j_bool_t      jbl_last  = J_FALSE;
 
     do
     {
         //======================================
 
-        if (!jenc_this->jbl_work)
+        if (jenc_this->jbl_work)
         {
-            jit_err = JENC_ERR_UNSTART;
+            jit_err = JENC_ERR_WORKING;
             break;
         }
 
-        // 若图像已经写满，则直接退出
-        if (jenc_this->jenc_obj.next_scanline >=
-            jenc_this->jenc_obj.image_height)
+        if (!jenc_ccs_valid(jccs_conv))
         {
-            jit_err = 0;
+            jit_err = JENC_ERR_CCS_VALUE;
             break;
         }
 
-        //======================================
-        // 验证参数有效性
-
-        if ((J_NULL == jmt_pxls) || (jut_rows <= 0))
+        if ((jut_imgw <= 0) || (jut_imgh <= 0))
         {
-            jit_err = 0;
+            jit_err = JENC_ERR_IMAGE_ZEROSIZE;
             break;
         }
 
-        //======================================
-        // 构建输入像素行数组
+        if ((jut_imgw > JPEG_MAX_DIMENSION) || (jut_imgh > JPEG_MAX_DIMENSION))
+        {
+            jit_err = JENC_ERR_IMAGE_OVERSIZE;
+            break;
+        }
 
-        jit_err = jenc_grow_rows(jenc_this, jut_rows);
-        if (JENC_ERR_OK != jit_err)
+        if ((J_NULL == jmt_pxls) || (0 == jst_tsize))
         {
+            jit_err = JENC_ERR_EPARAM;
             break;
         }
 
-        for (jut_iter = 0; jut_iter < jut_rows; ++jut_iter)
+        if (JCTL_MODE_UNKNOWN == jenc_this->jmode.jct_mode)
         {
-            jenc_this->jrows.jar_rows[jut_iter] = jmt_pxls;
-            jmt_pxls += jit_step;
+            jit_err = JENC_ERR_UNCONFIG;
+            break;
         }
 
         //======================================
-        // 开始向 编码器 写入像素数据
+        // 捕获 未量化 的 DCT 系数
 
-        // 设置错误回调跳转代码后，再执行编码操作
-        if (0 == setjmp(jenc_this->jerr_mgr.jerr_jmp))
+        jcoef_ptr = (jenc_coef_t *)calloc(1, sizeof(jenc_coef_t));
+        if (J_NULL == jcoef_ptr)
         {
-            for (jut_iter = 0; jut_iter < jut_rows; )
-            {
-                jut_iter += jpeg_write_scanlines(
-                                &jenc_this->jenc_obj,
-                                &jenc_this->jrows.jar_rows[jut_iter],
-                                jut_rows - jut_iter);
+            jit_err = JENC_ERR_MALLOC;
+            break;
+        }
 
-                if (jenc_this->jenc_obj.next_scanline >=
-                    jenc_this->jenc_obj.image_height)
-                {
-                    break;
-                }
-            }
+        jit_err = jenc_coef_capture(
+                    jenc_this,
+                    jcoef_ptr,
+                    jccs_conv,
+                    jmt_pxls,
+                    jit_step,
+                    jut_imgw,
+                    jut_imgh);
+        if (JENC_ERR_OK != jit_err)
+        {
+            break;
+        }
 
-            jit_err = (j_int_t)jut_iter;
+        //======================================
+        // 内存模式 直接在 jenc_this 上尝试，最后一次尝试即为结果时，
+        // 可省去最终的编码输出；其他模式 则借助临时的编码器对象
+
+        if (JCTL_MODE_FMEMORY == jenc_this->jmode.jct_mode)
+        {
+            jenc_tptr = jenc_this;
         }
         else
         {
-            // 异常处理
-            jit_err = JENC_ERR_EXCEPTION;
+            jenc_test = jenc_alloc(J_NULL);
+            if (J_NULL == jenc_test)
+            {
+                jit_err = JENC_ERR_MALLOC;
+                break;
+            }
 
-            // 关闭编码器
-            jenc_shutdown(jenc_this);
+            jenc_config(jenc_test, JCTL_MODE_FMEMORY, J_NULL, 0, 0);
+            jenc_test->jparam = jenc_this->jparam;
+            jenc_tptr = jenc_test;
         }
 
         //======================================
-    } while (0);
-
-    return jit_err;
-}
-
-/**********************************************************/
-/**
- * @brief 完成（结束） JPEG 编码操作。
- * 
- * @param [in ] jenc_this : JPEG 编码操作的上下文对象。
- * 
- * @return j_int_t :
- * - 操作失败时，返回值 < 0，表示 错误码，参看 jenc_errno_t 相关枚举值。
- * - 操作成功时：
- *   1. 使用 文件流模式 或 文件模式 时，返回值 == JENC_ERR_OK；
- *   2. 使用 内存模式 时，返回值 > 0，表示输出源中存储的 JPEG 数据的有效字节数；
- *   3. 使用 内存模式 时，且 返回值 == JENC_ERR_OK，表示输出源的缓存容量不足，
- *      而输出的 JPEG 编码数据存储在 jenc_this 的内部缓存中，后续可通过
- *      jenc_fmdata() 和 jenc_fmsize() 获取此次编码得到的 JPEG 数据。
- */
-j_int_t jenc_finish(jenc_this_t jenc_this)
-{
-    JASSERT(jenc_valid(jenc_this));
-
-    j_int_t jit_err = JENC_ERR_UNKNOWN;
+        // 搜索 满足目标字节数 的最高压缩质量：
+        // 输出字节数 随压缩质量 单调递增，且 ln(字节数) 与 ln(量化表缩放比例)
+        // 近似线性相关，故在区间 (jit_qlow, jit_qupr) 内 按割线插值 选取尝试点，
+        // 连续两次 区间收缩不足一半时 改用二分；首次尝试 上限值（多数情况下
+        // 可直接满足），之后通常只需 2 ~ 4 次尝试
+
+        jit_err = JENC_ERR_OK;
+        while (jit_qupr - jit_qlow > 1)
+        {
+            if (0 == jst_supr)
+            {
+                jit_qval = jit_qupr - 1;
+            }
+            else if (jut_nbad >= 2)
+            {
+                jit_qval = (jit_qlow + jit_qupr) / 2;
+            }
+            else
+            {
+                jdt_lupr = jenc_qual_lscale(jit_qupr);
+                jdt_kval = (0 == jst_slow) ? JENC_TSIZE_SLOPE :
+                                (log((double)jst_slow) - log((double)jst_supr)) /
+                                (jenc_qual_lscale(jit_qlow) - jdt_lupr);
+                jit_qval = jenc_lscale_qual(
+                                jdt_lupr + (log((double)jst_tsize) -
+                                            log((double)jst_supr)) / jdt_kval);
+            }
 
-    //======================================
+            if (jit_qval <= jit_qlow)
+                jit_qval = jit_qlow + 1;
+            if (jit_qval >= jit_qupr)
+                jit_qval = jit_qupr - 1;
 
-    if (!jenc_this->jbl_work)
-    {
-        return JENC_ERR_UNSTART;
-    }
+            jit_tret = jenc_coef_encode(jenc_tptr, jcoef_ptr, jit_qval);
+            if (jit_tret < 0)
+            {
+                jit_err = jit_tret;
+                break;
+            }
 
-    //======================================
+            // 输出至用户缓存时，返回值 即为 输出字节数
+            jst_size = (jit_tret > 0) ?
+                            (j_size_t)jit_tret : (j_size_t)jenc_fmsize(jenc_tptr);
+            jit_wold = (0 == jst_supr) ? 0 : (jit_qupr - jit_qlow);
+            if (jst_size <= jst_tsize)
+            {
+                jit_qlow = jit_qval;
+                jst_slow = jst_size;
+                jit_bret = jit_tret;
+                jbl_last = J_TRUE;
+            }
+            else
+            {
+                jit_qupr = jit_qval;
+                jst_supr = jst_size;
+                jbl_last = J_FALSE;
+            }
 
-    // 设置错误回调跳转代码后，再执行操作
-    if (0 == setjmp(jenc_this->jerr_mgr.jerr_jmp))
-    {
-        jpeg_finish_compress(&jenc_this->jenc_obj);
+            if (jut_nbad >= 2)
+                jut_nbad = 0;
+            else if ((jit_wold > 0) && (2 * (jit_qupr - jit_qlow) > jit_wold))
+                jut_nbad += 1;
+            else
+                jut_nbad = 0;
+        }
 
-        if ((JCTL_MODE_FMEMORY == jenc_this->jmode.jct_mode) &&
-            (jenc_this->jbuff.jmt_mptr == jenc_this->jmode.jmt_optr))
+        if (jit_err < 0)
         {
-            jit_err = (j_int_t)jenc_this->jbuff.jst_size;
+            break;
         }
-        else
+
+        if (0 == jit_qlow)
         {
-            jit_err = JENC_ERR_OK;
+            jit_err = JENC_ERR_TARGET_SIZE;
+            break;
         }
-    }
-    else
-    {
-        // 异常处理
-        jit_err = JENC_ERR_EXCEPTION;
-    }
 
-    //======================================
-    // 关闭编码器
+        //======================================
+        // 按搜索得到的压缩质量，输出至配置的目标
 
-    jenc_shutdown(jenc_this);
+        if (jbl_last && (jenc_tptr == jenc_this))
+            jit_err = jit_bret;
+        else
+            jit_err = jenc_coef_encode(jenc_this, jcoef_ptr, jit_qlow);
 
-    //======================================
+        if ((jit_err >= 0) && (J_NULL != jut_qual))
+        {
+            *jut_qual = (j_uint_t)jit_qlow;
+        }
 
-    return jit_err;
-}
+        //======================================
+    } while (0);
 
-/**********************************************************/
-/**
- * @brief 对整幅图像像素数据进行 JPEG 编码压缩操作。
- * @note 
- * 操作前，应先使用 jenc_config() 配置好输出模式。
- * 该接口使用 jenc_start()/jenc_write()/jenc_finish() 实现。
- * 
- * @param [in ] jenc_this : JPEG 编码操作的上下文对象。
- * @param [in ] jccs_conv : 设置色彩空间的转换方式（参看 jenc_ccs_t）。
- * @param [in ] jmt_pxls  : 图像的像素缓存。
- * @param [in ] jit_step  : 遍历像素行时的 步长值（以 字节 为单位）。
- * @param [in ] jut_imgw  : 设置编码输出图像的宽度（以像素为单位）。
- * @param [in ] jut_imgh  : 设置编码输出图像的高度（以像素为单位）。
- * 
- * @return j_int_t :
- * - 操作失败时，返回值 < 0，表示 错误码，参看 jenc_errno_t 相关枚举值。
- * - 操作成功时：
- *   1. 使用 文件流模式 或 文件模式 时，返回值 == JENC_ERR_OK；
- *   2. 使用 内存模式 时，返回值 > 0，表示输出源中存储的 JPEG 数据的有效字节数；
- *   3. 使用 内存模式 时，且 返回值 == JENC_ERR_OK，表示输出源的缓存容量不足，
- *      而输出的 JPEG 编码数据存储在 jenc_this 的内部缓存中，后续可通过
- *      jenc_fmdata() 和 jenc_fmsize() 获取此次编码得到的 JPEG 数据。
- */
-j_int_t jenc_image(
-                jenc_this_t jenc_this,
-                jenc_ccs_t  jccs_conv,
-                j_mptr_t    jmt_pxls,
-                j_int_t     jit_step,
-                j_uint_t    jut_imgw,
-                j_uint_t    jut_imgh)
-{
-    j_int_t jit_err;
+    //======================================
 
-    jit_err = jenc_start(jenc_this, jccs_conv, jut_imgw, jut_imgh);
-    if (JENC_ERR_OK != jit_err)
+    if (J_NULL != jenc_test)
     {
-        return jit_err;
+        jenc_release(jenc_test);
+        jenc_test = J_NULL;
     }
 
-    jit_err = jenc_write(jenc_this, jmt_pxls, jit_step, jut_imgh);
-    if (jit_err < 0)
+    if (J_NULL != jcoef_ptr)
     {
-        return jit_err;
+        jenc_coef_free(jcoef_ptr);
+        free(jcoef_ptr);
+        jcoef_ptr = J_NULL;
     }
 
-    return jenc_finish(jenc_this);
+    return jit_err;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
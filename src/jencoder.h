@@ -160,6 +160,8 @@ typedef enum jenc_errno_table_t
     JENC_ERR_MALLOC        ,   ///< 申请缓存失败
     JENC_ERR_EPARAM        ,   ///< 输入参数有误
     JENC_ERR_EXCEPTION     ,   ///< 编码操作过程产生异常错误
+    JENC_ERR_OVERFLOW      ,   ///< 指定输出的缓存容量不足
+    JENC_ERR_TARGET_SIZE   ,   ///< 无法满足指定的 目标输出字节数
 } jenc_errno_t;
 
 /**********************************************************/
@@ -186,12 +188,53 @@ static inline j_cstring_t jenc_errno_name(j_int_t jit_err)
     case JENC_ERR_FOPEN          : jsz_name = "JENC_ERR_FOPEN"         ; break;
     case JENC_ERR_EPARAM         : jsz_name = "JENC_ERR_EPARAM"        ; break;
     case JENC_ERR_EXCEPTION      : jsz_name = "JENC_ERR_EXCEPTION"     ; break;
+    case JENC_ERR_OVERFLOW       : jsz_name = "JENC_ERR_OVERFLOW"      ; break;
+    case JENC_ERR_TARGET_SIZE    : jsz_name = "JENC_ERR_TARGET_SIZE"   ; break;
     default: break;
     }
 
     return jsz_name;
 }
 
+/** 编码参数中，表示 使用默认设置 的参数值 */
+#define JENC_PARAM_DEFAULT  (-1)
+
+/**
+ * @struct jenc_param_t
+ * @brief  压缩质量 之外的 JPEG 编码参数（参看 jenc_config_param() 的说明）。
+ */
+typedef struct jenc_param_t
+{
+    j_int_t     jit_hsamp;     ///< 亮度分量的 水平采样因子（1 ~ 4，色度分量 固定为 1）；JENC_PARAM_DEFAULT，取默认值 2
+    j_int_t     jit_vsamp;     ///< 亮度分量的 垂直采样因子（1 ~ 4，色度分量 固定为 1）；JENC_PARAM_DEFAULT，取默认值 2
+    j_int_t     jit_prog;      ///< 扫描模式：0，基线顺序；1，渐进；JENC_PARAM_DEFAULT，基线顺序
+    j_int_t     jit_rrows;     ///< 重启间隔（以 MCU 行为单位）：0，不设置；> 0，设置；JENC_PARAM_DEFAULT，不设置
+    j_bool_t    jbl_optim;     ///< 是否优化哈夫曼表
+} jenc_param_t;
+
+/**
+ * @struct jenc_job_t
+ * @brief  批量编码操作（jenc_batch()）中，单个编码任务的描述信息。
+ */
+typedef struct jenc_job_t
+{
+    jenc_ccs_t  jccs_conv;     ///< [in ] 色彩空间的转换方式（参看 jenc_ccs_t）
+    j_mptr_t    jmt_pxls;      ///< [in ] 图像的像素缓存
+    j_int_t     jit_step;      ///< [in ] 遍历像素行时的 步长值（以 字节 为单位）
+    j_uint_t    jut_imgw;      ///< [in ] 图像宽度
+    j_uint_t    jut_imgh;      ///< [in ] 图像高度
+    j_uint_t    jut_qual;      ///< [in ] 编码压缩质量（1 - 100，为 0 时，取默认值）
+    const jenc_param_t * jparam_ptr; ///< [in ] 压缩质量 之外的 编码参数（为 J_NULL 时，取默认值）
+
+    jctl_mode_t jct_mode;      ///< [in ] 输出模式（参看 jenc_config() 的说明）
+    j_fhandle_t jht_optr;      ///< [in ] 指向目标输出的操作对象
+    j_size_t    jst_mlen;      ///< [in ] 只针对于 内存模式，表示目标输出缓存的容量
+
+    j_int_t     jit_err;       ///< [out] 编码操作的错误码（参看 jenc_errno_t）
+    j_size_t    jst_size;      ///< [out] 编码输出的 JPEG 数据字节数
+    double      jdt_time;      ///< [out] 执行该任务的耗时（以 秒 为单位）
+} jenc_job_t;
+
 /**********************************************************/
 /**
  * @brief 申请 JPEG 编码操作的上下文对象。
@@ -244,6 +287,29 @@ j_int_t jenc_config(
                 j_size_t    jst_mlen,
                 j_uint_t    jut_qual);
 
+/**********************************************************/
+/**
+ * @brief 设置 压缩质量 之外的 JPEG 编码参数（采样因子、扫描模式、重启间隔 等）。
+ * @note
+ * 1. 设置的参数 对其后的 jenc_start()、jenc_image()、jenc_image_target_size()、
+ *    jenc_image_mt() 均有效，直至再次设置；jparam_ptr 为 J_NULL 时，恢复全部默认值；
+ * 2. 采样因子 只作用于 带色度分量的输出色彩空间（YCC、BG_YCC、YCCK，
+ *    YCCK 的 K 分量 与 亮度分量 相同），水平 与 垂直 采样因子之积 不可超过 8，
+ *    否则返回 JENC_ERR_EPARAM；对于 YCCK 则不可超过 4（每个 MCU 最多 10 个块），
+ *    否则 编码时 返回 JENC_ERR_EXCEPTION；
+ * 3. jenc_image_mt() 不支持 渐进模式 与 重启间隔（参看其说明）；
+ * 4. jenc_batch()、jenc_ladder()、jenc_crops() 使用内部编码器，不受此设置影响，
+ *    其编码参数 由各个任务的 jparam_ptr 字段指定。
+ * 
+ * @param [in ] jenc_this  : JPEG 编码操作的上下文对象。
+ * @param [in ] jparam_ptr : 编码参数（为 J_NULL 时，恢复默认值）。
+ * 
+ * @return j_int_t : 错误码，请参看 jenc_errno_t 相关枚举值。
+ */
+j_int_t jenc_config_param(
+                jenc_this_t          jenc_this,
+                const jenc_param_t * jparam_ptr);
+
 /**********************************************************/
 /**
  * @brief 在内存模式下，执行编码压缩操作后，所缓存的 JPEG 数据流地址。
@@ -345,6 +411,179 @@ j_int_t jenc_image(
                 j_uint_t    jut_imgw,
                 j_uint_t    jut_imgh);
 
+/**********************************************************/
+/**
+ * @brief 按水平条带划分图像，使用多个工作线程并行进行 JPEG 编码压缩操作。
+ * @note
+ * 1. 操作前，应先使用 jenc_config() 配置好输出模式；
+ * 2. 图像按 MCU 行划分为多个条带，各个条带使用相同的 量化表 和 哈夫曼表
+ *    独立编码，并以条带的 MCU 数量作为重启间隔（DRI），拼接成一个
+ *    标准的 baseline JPEG 数据流，条带间的熵编码数据段 以 RSTn 标记分隔；
+ * 3. 条带的划分只与 图像尺寸 和 jut_srows 有关，与工作线程数量无关，
+ *    所以，任意线程数量下的编码输出结果都完全相同；
+ * 4. 图像只有一个条带时，等同于 jenc_image() 操作（不带重启间隔）；
+ * 5. jenc_config_param() 设置的 采样因子 与 哈夫曼表优化 同样有效，
+ *    优化哈夫曼表时，拼接后的数据流 再以无损转码的方式 重新熵编码一次；
+ *    而 渐进模式 与 重启间隔 同条带的拼接方式冲突，设置时返回 JENC_ERR_EPARAM 。
+ * 
+ * @param [in ] jenc_this : JPEG 编码操作的上下文对象。
+ * @param [in ] jccs_conv : 设置色彩空间的转换方式（参看 jenc_ccs_t）。
+ * @param [in ] jmt_pxls  : 图像的像素缓存。
+ * @param [in ] jit_step  : 遍历像素行时的 步长值（以 字节 为单位）。
+ * @param [in ] jut_imgw  : 设置编码输出图像的宽度（以像素为单位）。
+ * @param [in ] jut_imgh  : 设置编码输出图像的高度（以像素为单位）。
+ * @param [in ] jut_nthd  : 工作线程数量（为 0 时，取 CPU 核心数量）。
+ * @param [in ] jut_srows : 每个条带包含的 MCU 行数量（为 0 时，取默认值）。
+ * 
+ * @return j_int_t : 返回值的含义，与 jenc_image() 的返回值相同。
+ */
+j_int_t jenc_image_mt(
+                jenc_this_t jenc_this,
+                jenc_ccs_t  jccs_conv,
+                j_mptr_t    jmt_pxls,
+                j_int_t     jit_step,
+                j_uint_t    jut_imgw,
+                j_uint_t    jut_imgh,
+                j_uint_t    jut_nthd,
+                j_uint_t    jut_srows);
+
+/**********************************************************/
+/**
+ * @brief 在指定的 目标字节数 以内，以尽可能高的压缩质量 进行 JPEG 编码压缩操作。
+ * @note
+ * 1. 操作前，应先使用 jenc_config() 配置好输出模式，其配置的压缩质量，
+ *    作为搜索压缩质量的 上限值；
+ * 2. 色彩转换、降采样 与 DCT 变换 只执行一次（捕获 未量化 的 DCT 系数），
+ *    搜索压缩质量时，每次尝试只执行 重新量化 与 熵编码，通常尝试 3 ~ 5 次；
+ * 3. 重新量化 与 libjpeg 的量化方式完全一致，输出数据流 与 按最终压缩质量
+ *    调用 jenc_image() 的结果 逐字节相同；
+ * 4. 压缩质量为 1 时仍超出目标字节数，则返回 JENC_ERR_TARGET_SIZE，
+ *    此时 内存模式 的输出内容 是无效的。
+ * 
+ * @param [in ] jenc_this : JPEG 编码操作的上下文对象。
+ * @param [in ] jccs_conv : 设置色彩空间的转换方式（参看 jenc_ccs_t）。
+ * @param [in ] jmt_pxls  : 图像的像素缓存。
+ * @param [in ] jit_step  : 遍历像素行时的 步长值（以 字节 为单位）。
+ * @param [in ] jut_imgw  : 设置编码输出图像的宽度（以像素为单位）。
+ * @param [in ] jut_imgh  : 设置编码输出图像的高度（以像素为单位）。
+ * @param [in ] jst_tsize : 输出 JPEG 数据的 目标字节数（上限值）。
+ * @param [out] jut_qual  : 操作成功时，返回最终使用的压缩质量（可为 J_NULL）。
+ * 
+ * @return j_int_t : 返回值的含义，与 jenc_image() 的返回值相同。
+ */
+j_int_t jenc_image_target_size(
+                jenc_this_t jenc_this,
+                jenc_ccs_t  jccs_conv,
+                j_mptr_t    jmt_pxls,
+                j_int_t     jit_step,
+                j_uint_t    jut_imgw,
+                j_uint_t    jut_imgh,
+                j_size_t    jst_tsize,
+                j_uint_t  * jut_qual);
+
+/**********************************************************/
+/**
+ * @brief 使用多个工作线程，批量执行 JPEG 编码任务。
+ * @note
+ * 1. 各个编码任务由工作线程以 任务窃取 的方式调度执行，每个工作线程
+ *    使用各自的 编码器上下文 与 内存输出缓存，并在其执行的多个任务间重复使用；
+ * 2. 内存模式的任务，编码数据先输出至工作线程的内部缓存，完成后再拷贝至
+ *    任务指定的输出缓存；若指定缓存为 J_NULL 或 容量不足，该任务的
+ *    jit_err 置为 JENC_ERR_OVERFLOW，jst_size 返回所需的缓存容量；
+ * 3. 各个任务的执行结果，存放在其 jit_err、jst_size 与 jdt_time 字段中，
+ *    任务成功时，jit_err == JENC_ERR_OK ；
+ * 4. 各个任务的编码参数 由其 jparam_ptr 字段指定（为 J_NULL 时，取默认值），
+ *    参数无效的任务，其 jit_err 置为 JENC_ERR_EPARAM 。
+ * 
+ * @param [in ] jjob_arr : 编码任务数组（各个任务的执行结果，也回写于其中）。
+ * @param [in ] jut_njob : 编码任务数量。
+ * @param [in ] jut_nthd : 工作线程数量（为 0 时，取 CPU 核心数量）。
+ * 
+ * @return j_int_t :
+ * - 返回值 >= 0，表示执行成功的任务数量；
+ * - 返回值 <  0，表示 错误码，参看 jenc_errno_t 相关枚举值。
+ */
+j_int_t jenc_batch(
+                jenc_job_t * jjob_arr,
+                j_uint_t     jut_njob,
+                j_uint_t     jut_nthd);
+
+/**********************************************************/
+/**
+ * @brief 对同一幅图像，按多个压缩质量 编码输出多份 JPEG 数据（质量阶梯）。
+ * @note
+ * 1. 色彩转换、降采样 与 DCT 变换 只执行一次（捕获 未量化 的 DCT 系数），
+ *    之后各个任务（阶梯）只执行 重新量化 与 熵编码，并由多个工作线程并行执行；
+ * 2. 重新量化 与 libjpeg 的量化方式完全一致，各个输出数据流 与 逐个调用
+ *    jenc_image() 的结果 逐字节相同；
+ * 3. 各个任务只使用 jut_qual、jparam_ptr、jct_mode、jht_optr、jst_mlen
+ *    这几个输入字段，其图像参数字段（jccs_conv ~ jut_imgh），由本接口按输入参数填写；
+ * 4. DCT 系数 按第一个任务的 采样因子 捕获，其他任务的 采样因子 须与之相同，
+ *    否则其 jit_err 置为 JENC_ERR_EPARAM；扫描模式、重启间隔 与 哈夫曼表优化
+ *    则可逐个任务设置；
+ * 5. 任务的输出方式 与 执行结果，同 jenc_batch() 的说明。
+ * 
+ * @param [in ] jccs_conv : 设置色彩空间的转换方式（参看 jenc_ccs_t）。
+ * @param [in ] jmt_pxls  : 图像的像素缓存。
+ * @param [in ] jit_step  : 遍历像素行时的 步长值（以 字节 为单位）。
+ * @param [in ] jut_imgw  : 设置编码输出图像的宽度（以像素为单位）。
+ * @param [in ] jut_imgh  : 设置编码输出图像的高度（以像素为单位）。
+ * @param [in ] jjob_arr  : 编码任务数组（每个任务对应一个压缩质量）。
+ * @param [in ] jut_njob  : 编码任务数量。
+ * @param [in ] jut_nthd  : 工作线程数量（为 0 时，取 CPU 核心数量）。
+ * 
+ * @return j_int_t :
+ * - 返回值 >= 0，表示执行成功的任务数量；
+ * - 返回值 <  0，表示 错误码，参看 jenc_errno_t 相关枚举值。
+ */
+j_int_t jenc_ladder(
+                jenc_ccs_t   jccs_conv,
+                j_mptr_t     jmt_pxls,
+                j_int_t      jit_step,
+                j_uint_t     jut_imgw,
+                j_uint_t     jut_imgh,
+                jenc_job_t * jjob_arr,
+                j_uint_t     jut_njob,
+                j_uint_t     jut_nthd);
+
+/**********************************************************/
+/**
+ * @brief 从同一幅图像（的像素缓存）中，裁剪多个区域，并行编码输出多份 JPEG 数据。
+ * @note
+ * 1. 每个裁剪区域 作为一个编码任务，由 jenc_batch() 的工作线程并行执行，
+ *    各个任务直接引用 jmt_pxls 中对应的像素，不做拷贝；
+ * 2. jmt_pxls 可以只是图像的一个水平条带（例如 只解码了 全部裁剪区域所覆盖的
+ *    像素行），此时 裁剪区域的坐标 与 jut_imgw、jut_imgh 均相对于该条带；
+ * 3. 各个任务只使用 jut_qual、jparam_ptr、jct_mode、jht_optr、jst_mlen
+ *    这几个输入字段，其图像参数字段（jccs_conv ~ jut_imgh），由本接口按 对应的裁剪区域 填写；
+ *    裁剪区域为空 或 超出图像范围的任务，其 jit_err 置为 JENC_ERR_EPARAM；
+ * 4. 任务的输出方式 与 执行结果，同 jenc_batch() 的说明。
+ * 
+ * @param [in ] jccs_conv : 设置色彩空间的转换方式（参看 jenc_ccs_t）。
+ * @param [in ] jmt_pxls  : 图像的像素缓存。
+ * @param [in ] jit_step  : 遍历像素行时的 步长值（以 字节 为单位）。
+ * @param [in ] jut_imgw  : 像素缓存中 图像的宽度（以像素为单位）。
+ * @param [in ] jut_imgh  : 像素缓存中 图像的高度（以像素为单位）。
+ * @param [in ] jrect_arr : 裁剪区域数组（与 jjob_arr 一一对应）。
+ * @param [in ] jjob_arr  : 编码任务数组（每个任务对应一个裁剪区域）。
+ * @param [in ] jut_njob  : 编码任务数量。
+ * @param [in ] jut_nthd  : 工作线程数量（为 0 时，取 CPU 核心数量）。
+ * 
+ * @return j_int_t :
+ * - 返回值 >= 0，表示执行成功的任务数量；
+ * - 返回值 <  0，表示 错误码，参看 jenc_errno_t 相关枚举值。
+ */
+j_int_t jenc_crops(
+                jenc_ccs_t          jccs_conv,
+                j_mptr_t            jmt_pxls,
+                j_int_t             jit_step,
+                j_uint_t            jut_imgw,
+                j_uint_t            jut_imgh,
+                const j_rect_t    * jrect_arr,
+                jenc_job_t        * jjob_arr,
+                j_uint_t            jut_njob,
+                j_uint_t            jut_nthd);
+
 ////////////////////////////////////////////////////////////////////////////////
 
 #ifdef __cplusplus
@@ -405,6 +644,16 @@ public:
                     jut_qual);
     }
 
+    /**********************************************************/
+    /**
+     * @brief 设置 压缩质量 之外的 JPEG 编码参数（采样因子、扫描模式、重启间隔 等）。
+     * @note  详情请参看 jenc_config_param() 的说明。
+     */
+    inline j_int_t config_param(const jenc_param_t * jparam_ptr)
+    {
+        return jenc_config_param(m_jenc_this, jparam_ptr);
+    }
+
     /**********************************************************/
     /**
      * @brief 在内存模式下，执行编码压缩操作后，所缓存的 JPEG 数据流地址。
@@ -490,6 +739,56 @@ public:
                     jut_imgh);
     }
 
+    /**********************************************************/
+    /**
+     * @brief 按水平条带划分图像，使用多个工作线程并行进行 JPEG 编码压缩操作。
+     * @note  详情请参看 jenc_image_mt() 的说明。
+     */
+    inline j_int_t encode_image_mt(
+                    jenc_ccs_t jccs_conv,
+                    j_mptr_t   jmt_pxls,
+                    j_int_t    jit_step,
+                    j_uint_t   jut_imgw,
+                    j_uint_t   jut_imgh,
+                    j_uint_t   jut_nthd  = 0,
+                    j_uint_t   jut_srows = 0)
+    {
+        return jenc_image_mt(
+                    m_jenc_this,
+                    jccs_conv,
+                    jmt_pxls,
+                    jit_step,
+                    jut_imgw,
+                    jut_imgh,
+                    jut_nthd,
+                    jut_srows);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在指定的 目标字节数 以内，以尽可能高的压缩质量 进行 JPEG 编码压缩操作。
+     * @note  详情请参看 jenc_image_target_size() 的说明。
+     */
+    inline j_int_t encode_image_target_size(
+                    jenc_ccs_t jccs_conv,
+                    j_mptr_t   jmt_pxls,
+                    j_int_t    jit_step,
+                    j_uint_t   jut_imgw,
+                    j_uint_t   jut_imgh,
+                    j_size_t   jst_tsize,
+                    j_uint_t * jut_qual = J_NULL)
+    {
+        return jenc_image_target_size(
+                    m_jenc_this,
+                    jccs_conv,
+                    jmt_pxls,
+                    jit_step,
+                    jut_imgw,
+                    jut_imgh,
+                    jst_tsize,
+                    jut_qual);
+    }
+
     // data members
 private:
     jenc_this_t m_jenc_this; ///< JPEG 编码操作的上下文对象
@@ -0,0 +1,225 @@
+﻿/**
+ * @file jperf.c
+ * Copyright (c) 2024 Gaaagaa. All rights reserved.
+ * 
+ * @author  : Gaaagaa
+ * @date    : 2024-11-08
+ * @version : 1.0.0.0
+ * @brief   : 为 性能测试程序 实现 硬件性能计数器（Linux perf_event_open）的读取接口。
+ */
+
+#include "jperf.h"
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#endif // __linux__
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __linux__
+
+/**
+ * @struct jperf_read_t
+ * @brief  read() 计数器时的数据格式（PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING）。
+ */
+typedef struct jperf_read_t
+{
+    unsigned long long jull_value;  ///< 计数值
+    unsigned long long jull_tena;   ///< 计数器 处于启用状态的时间
+    unsigned long long jull_trun;   ///< 计数器 实际运行（占用 PMU）的时间
+} jperf_read_t;
+
+/**********************************************************/
+/**
+ * @brief 填写 jperf_event_t 对应的 perf_event_attr 事件类型与配置值。
+ */
+static j_void_t jperf_event_attr(j_uint_t jut_event, struct perf_event_attr * jattr_ptr)
+{
+    switch (jut_event)
+    {
+    case JPERF_CYCLES:
+        jattr_ptr->type   = PERF_TYPE_HARDWARE;
+        jattr_ptr->config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+
+    case JPERF_INSTRUCTIONS:
+        jattr_ptr->type   = PERF_TYPE_HARDWARE;
+        jattr_ptr->config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+
+    case JPERF_BRANCH_MISS:
+        jattr_ptr->type   = PERF_TYPE_HARDWARE;
+        jattr_ptr->config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+
+    case JPERF_L1D_MISS:
+        jattr_ptr->type   = PERF_TYPE_HW_CACHE;
+        jattr_ptr->config = PERF_COUNT_HW_CACHE_L1D |
+                            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+
+    case JPERF_LLC_MISS:
+        jattr_ptr->type   = PERF_TYPE_HW_CACHE;
+        jattr_ptr->config = PERF_COUNT_HW_CACHE_LL |
+                            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        break;
+
+    default:
+        jattr_ptr->type   = PERF_TYPE_SOFTWARE;
+        jattr_ptr->config = PERF_COUNT_SW_TASK_CLOCK;
+        break;
+    }
+}
+
+#endif // __linux__
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**********************************************************/
+/**
+ * @brief 为调用线程 打开一组性能计数器（初始为 停止状态）。
+ * @note
+ * 1. 计数器只统计 用户态，且由调用线程 之后创建的线程 继承，
+ *    线程退出（被 join）后，其计数值 累加到 调用线程的计数器中，
+ *    因此 可统计 jthrd_parallel() 的全部工作线程；
+ * 2. 非 Linux 平台、内核不支持 或 权限不足（perf_event_paranoid）时，
+ *    相应的事件 不可用，但接口调用 总是安全的。
+ * 
+ * @param [out] jperf_ptr : 返回的 性能计数器组。
+ * 
+ * @return j_uint_t : 可用的事件数量（为 0 时，表示 性能计数器 完全不可用）。
+ */
+j_uint_t jperf_open(jperf_counter_t * jperf_ptr)
+{
+    j_uint_t jut_iter = 0;
+    j_uint_t jut_nevt = 0;
+
+#ifdef __linux__
+    struct perf_event_attr jattr;
+#endif // __linux__
+
+    jperf_ptr->jit_errno = 0;
+    for (jut_iter = 0; jut_iter < JPERF_EVENT_COUNT; ++jut_iter)
+    {
+        jperf_ptr->jit_fd[jut_iter] = -1;
+
+#ifdef __linux__
+        // 继承（inherit）的计数器 不支持 PERF_FORMAT_GROUP，故各个事件 单独打开
+        memset(&jattr, 0, sizeof(jattr));
+        jattr.size           = sizeof(jattr);
+        jattr.disabled       = 1;
+        jattr.inherit        = 1;
+        jattr.exclude_kernel = 1;
+        jattr.exclude_hv     = 1;
+        jattr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        jperf_event_attr(jut_iter, &jattr);
+
+        jperf_ptr->jit_fd[jut_iter] =
+            (j_int_t)syscall(__NR_perf_event_open, &jattr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+        if (jperf_ptr->jit_fd[jut_iter] < 0)
+        {
+            jperf_ptr->jit_fd[jut_iter] = -1;
+            if (0 == jperf_ptr->jit_errno)
+                jperf_ptr->jit_errno = errno;
+            continue;
+        }
+
+        jut_nevt += 1;
+#endif // __linux__
+    }
+
+    return jut_nevt;
+}
+
+/**********************************************************/
+/**
+ * @brief 关闭 性能计数器组。
+ */
+j_void_t jperf_close(jperf_counter_t * jperf_ptr)
+{
+    j_uint_t jut_iter = 0;
+
+    for (jut_iter = 0; jut_iter < JPERF_EVENT_COUNT; ++jut_iter)
+    {
+#ifdef __linux__
+        if (jperf_ptr->jit_fd[jut_iter] >= 0)
+            close(jperf_ptr->jit_fd[jut_iter]);
+#endif // __linux__
+        jperf_ptr->jit_fd[jut_iter] = -1;
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 清零 并 启动 性能计数器组。
+ */
+j_void_t jperf_start(jperf_counter_t * jperf_ptr)
+{
+#ifdef __linux__
+    j_uint_t jut_iter = 0;
+
+    for (jut_iter = 0; jut_iter < JPERF_EVENT_COUNT; ++jut_iter)
+    {
+        if (jperf_ptr->jit_fd[jut_iter] >= 0)
+            ioctl(jperf_ptr->jit_fd[jut_iter], PERF_EVENT_IOC_RESET, 0);
+    }
+
+    for (jut_iter = 0; jut_iter < JPERF_EVENT_COUNT; ++jut_iter)
+    {
+        if (jperf_ptr->jit_fd[jut_iter] >= 0)
+            ioctl(jperf_ptr->jit_fd[jut_iter], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#else // !__linux__
+    (j_void_t)jperf_ptr;
+#endif // __linux__
+}
+
+/**********************************************************/
+/**
+ * @brief 停止 性能计数器组，并读取 自 jperf_start() 以来的计数值。
+ */
+j_void_t jperf_stop(jperf_counter_t * jperf_ptr, jperf_value_t * jvalue_ptr)
+{
+    j_uint_t jut_iter = 0;
+
+#ifdef __linux__
+    jperf_read_t jread;
+
+    for (jut_iter = 0; jut_iter < JPERF_EVENT_COUNT; ++jut_iter)
+    {
+        if (jperf_ptr->jit_fd[jut_iter] >= 0)
+            ioctl(jperf_ptr->jit_fd[jut_iter], PERF_EVENT_IOC_DISABLE, 0);
+    }
+#endif // __linux__
+
+    for (jut_iter = 0; jut_iter < JPERF_EVENT_COUNT; ++jut_iter)
+    {
+        jvalue_ptr->jbl_valid[jut_iter] = J_FALSE;
+        jvalue_ptr->jdt_value[jut_iter] = 0.0;
+
+#ifdef __linux__
+        if ((jperf_ptr->jit_fd[jut_iter] < 0) ||
+            (sizeof(jread) != read(jperf_ptr->jit_fd[jut_iter], &jread, sizeof(jread))) ||
+            (0 == jread.jull_trun))
+        {
+            continue;
+        }
+
+        // 计数器数量 多于 PMU 的硬件计数器时，内核会分时复用，按运行时间比例 估算全程计数值
+        jvalue_ptr->jbl_valid[jut_iter] = J_TRUE;
+        jvalue_ptr->jdt_value[jut_iter] = (double)jread.jull_value;
+        if (jread.jull_trun < jread.jull_tena)
+        {
+            jvalue_ptr->jdt_value[jut_iter] *=
+                (double)jread.jull_tena / (double)jread.jull_trun;
+        }
+#endif // __linux__
+    }
+}
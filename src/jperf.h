@@ -0,0 +1,115 @@
+﻿/**
+ * @file jperf.h
+ * Copyright (c) 2024 Gaaagaa. All rights reserved.
+ * 
+ * @author  : Gaaagaa
+ * @date    : 2024-11-08
+ * @version : 1.0.0.0
+ * @brief   : 为 性能测试程序 声明 硬件性能计数器（Linux perf_event_open）的读取接口。
+ */
+
+#ifndef __JPERF_H__
+#define __JPERF_H__
+
+#include "jcomm.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @enum  jperf_event_t
+ * @brief 性能计数器所统计的事件。
+ */
+typedef enum jperf_event_t
+{
+    JPERF_CYCLES       = 0,   ///< CPU 周期数
+    JPERF_INSTRUCTIONS = 1,   ///< 退休指令数
+    JPERF_BRANCH_MISS  = 2,   ///< 分支预测失败次数
+    JPERF_L1D_MISS     = 3,   ///< L1 数据缓存 读缺失次数
+    JPERF_LLC_MISS     = 4,   ///< 末级缓存 读缺失次数
+    JPERF_TASK_CLOCK   = 5,   ///< 任务的 CPU 时间（纳秒，软件事件）
+    JPERF_EVENT_COUNT  = 6,   ///< 事件数量
+} jperf_event_t;
+
+/**
+ * @struct jperf_counter_t
+ * @brief  一组性能计数器（各个事件 单独打开，不可用的事件 被忽略）。
+ */
+typedef struct jperf_counter_t
+{
+    j_int_t jit_fd[JPERF_EVENT_COUNT];  ///< 各个事件的 文件描述符（-1 表示不可用）
+    j_int_t jit_errno;                  ///< 首个 不可用事件 打开失败时的 errno
+} jperf_counter_t;
+
+/**
+ * @struct jperf_value_t
+ * @brief  一次统计的 计数值。
+ */
+typedef struct jperf_value_t
+{
+    j_bool_t jbl_valid[JPERF_EVENT_COUNT];  ///< 各个事件的计数值 是否有效
+    double   jdt_value[JPERF_EVENT_COUNT];  ///< 各个事件的计数值（计数器被复用时，已按运行时间比例 缩放）
+} jperf_value_t;
+
+/**********************************************************/
+/**
+ * @brief 获取 jperf_event_t 类型值对应的 字符串名称。
+ */
+static inline j_cstring_t jperf_event_name(j_uint_t jut_event)
+{
+    static const j_cstring_t JSZ_NAME[JPERF_EVENT_COUNT] =
+    {
+        "cycles", "instructions", "branch_misses", "l1d_misses", "llc_misses", "task_clock_ns"
+    };
+
+    return (jut_event < JPERF_EVENT_COUNT) ? JSZ_NAME[jut_event] : "unknown";
+}
+
+/**********************************************************/
+/**
+ * @brief 为调用线程 打开一组性能计数器（初始为 停止状态）。
+ * @note
+ * 1. 计数器只统计 用户态，且由调用线程 之后创建的线程 继承，
+ *    线程退出（被 join）后，其计数值 累加到 调用线程的计数器中，
+ *    因此 可统计 jthrd_parallel() 的全部工作线程；
+ * 2. 非 Linux 平台、内核不支持 或 权限不足（perf_event_paranoid）时，
+ *    相应的事件 不可用，但接口调用 总是安全的。
+ * 
+ * @param [out] jperf_ptr : 返回的 性能计数器组。
+ * 
+ * @return j_uint_t : 可用的事件数量（为 0 时，表示 性能计数器 完全不可用）。
+ */
+j_uint_t jperf_open(jperf_counter_t * jperf_ptr);
+
+/**********************************************************/
+/**
+ * @brief 关闭 性能计数器组。
+ */
+j_void_t jperf_close(jperf_counter_t * jperf_ptr);
+
+/**********************************************************/
+/**
+ * @brief 清零 并 启动 性能计数器组。
+ */
+j_void_t jperf_start(jperf_counter_t * jperf_ptr);
+
+/**********************************************************/
+/**
+ * @brief 停止 性能计数器组，并读取 自 jperf_start() 以来的计数值。
+ */
+j_void_t jperf_stop(jperf_counter_t * jperf_ptr, jperf_value_t * jvalue_ptr);
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}; // extern "C"
+#endif // __cplusplus
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __JPERF_H__
@@ -0,0 +1,404 @@
+﻿/**
+ * @file jthread.c
+ * Copyright (c) 2024 Gaaagaa. All rights reserved.
+ * 
+ * @author  : Gaaagaa
+ * @date    : 2024-10-20
+ * @version : 1.0.0.0
+ * @brief   : 为 JPEG 编码器/解码器 的并行操作，实现简单的多线程任务执行接口。
+ */
+
+#include "jthread.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else // !_WIN32
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+#endif // _WIN32
+
+////////////////////////////////////////////////////////////////////////////////
+// 线程与互斥锁 的平台相关封装
+
+#ifdef _WIN32
+
+typedef CRITICAL_SECTION jthrd_mutex_t;
+typedef HANDLE           jthrd_handle_t;
+
+#define jthrd_mutex_init(jmtx)    InitializeCriticalSection(jmtx)
+#define jthrd_mutex_free(jmtx)    DeleteCriticalSection(jmtx)
+#define jthrd_mutex_lock(jmtx)    EnterCriticalSection(jmtx)
+#define jthrd_mutex_unlock(jmtx)  LeaveCriticalSection(jmtx)
+
+#define JTHRD_ROUTINE             unsigned __stdcall
+#define JTHRD_RETURN              0
+
+#else // !_WIN32
+
+typedef pthread_mutex_t  jthrd_mutex_t;
+typedef pthread_t        jthrd_handle_t;
+
+#define jthrd_mutex_init(jmtx)    pthread_mutex_init(jmtx, J_NULL)
+#define jthrd_mutex_free(jmtx)    pthread_mutex_destroy(jmtx)
+#define jthrd_mutex_lock(jmtx)    pthread_mutex_lock(jmtx)
+#define jthrd_mutex_unlock(jmtx)  pthread_mutex_unlock(jmtx)
+
+#define JTHRD_ROUTINE             void *
+#define JTHRD_RETURN              J_NULL
+
+#endif // _WIN32
+
+////////////////////////////////////////////////////////////////////////////////
+// 任务调度 相关数据类型
+
+/**
+ * @struct jthrd_range_t
+ * @brief  工作线程所持有的 任务索引区间 [jut_head, jut_tail) 。
+ */
+typedef struct jthrd_range_t
+{
+    jthrd_mutex_t   jmtx_lock; ///< 区间操作的互斥锁
+    j_uint_t        jut_head;  ///< 区间头部（下一个待执行的任务索引）
+    j_uint_t        jut_tail;  ///< 区间尾部
+} jthrd_range_t;
+
+/**
+ * @struct jthrd_pctx_t
+ * @brief  jthrd_parallel() 一次调用的 任务调度 上下文。
+ */
+typedef struct jthrd_pctx_t
+{
+    jthrd_task_t    jfunc_ptr; ///< 任务回调函数
+    j_void_t      * jvt_ctxt;  ///< 任务上下文
+    j_uint_t        jut_nthd;  ///< 工作线程数量
+
+    jthrd_range_t   jranges[JTHRD_MAX_WORKERS]; ///< 各个工作线程的任务区间
+} jthrd_pctx_t;
+
+/**
+ * @struct jthrd_warg_t
+ * @brief  工作线程的入口参数。
+ */
+typedef struct jthrd_warg_t
+{
+    jthrd_pctx_t  * jpctx_ptr; ///< 任务调度上下文
+    j_uint_t        jut_widx;  ///< 工作线程索引号
+} jthrd_warg_t;
+
+////////////////////////////////////////////////////////////////////////////////
+// 任务调度 内部接口函数
+
+/**********************************************************/
+/**
+ * @brief 从指定的任务区间头部 取出 一个任务索引。
+ * 
+ * @return j_bool_t : 区间为空时，返回 J_FALSE 。
+ */
+static j_bool_t jthrd_pop_head(jthrd_range_t * jrange_ptr, j_uint_t * jut_tidx)
+{
+    j_bool_t jbl_done = J_FALSE;
+
+    jthrd_mutex_lock(&jrange_ptr->jmtx_lock);
+    if (jrange_ptr->jut_head < jrange_ptr->jut_tail)
+    {
+        *jut_tidx = jrange_ptr->jut_head++;
+        jbl_done  = J_TRUE;
+    }
+    jthrd_mutex_unlock(&jrange_ptr->jmtx_lock);
+
+    return jbl_done;
+}
+
+/**********************************************************/
+/**
+ * @brief 从其他工作线程中，剩余任务最多的区间尾部 窃取 一半任务，
+ *        存放至 jut_widx 工作线程的区间中。
+ * 
+ * @return j_bool_t : 所有区间均已为空时，返回 J_FALSE 。
+ */
+static j_bool_t jthrd_steal(jthrd_pctx_t * jpctx_ptr, j_uint_t jut_widx)
+{
+    j_uint_t jut_iter = 0;
+    j_uint_t jut_vidx = 0;
+    j_uint_t jut_vmax = 0;
+    j_uint_t jut_size = 0;
+    j_uint_t jut_head = 0;
+    j_uint_t jut_tail = 0;
+
+    jthrd_range_t * jrange_ptr = J_NULL;
+
+    for (;;)
+    {
+        //======================================
+        // 查找剩余任务最多的区间
+
+        jut_vmax = 0;
+        for (jut_iter = 0; jut_iter < jpctx_ptr->jut_nthd; ++jut_iter)
+        {
+            if (jut_iter == jut_widx)
+                continue;
+
+            jrange_ptr = &jpctx_ptr->jranges[jut_iter];
+
+            jthrd_mutex_lock(&jrange_ptr->jmtx_lock);
+            jut_size = jrange_ptr->jut_tail - jrange_ptr->jut_head;
+            jthrd_mutex_unlock(&jrange_ptr->jmtx_lock);
+
+            if (jut_size > jut_vmax)
+            {
+                jut_vmax = jut_size;
+                jut_vidx = jut_iter;
+            }
+        }
+
+        if (0 == jut_vmax)
+        {
+            return J_FALSE;
+        }
+
+        //======================================
+        // 从区间尾部窃取一半任务（至少一个）
+
+        jrange_ptr = &jpctx_ptr->jranges[jut_vidx];
+
+        jthrd_mutex_lock(&jrange_ptr->jmtx_lock);
+        jut_size = jrange_ptr->jut_tail - jrange_ptr->jut_head;
+        if (jut_size > 0)
+        {
+            jut_tail = jrange_ptr->jut_tail;
+            jut_head = jut_tail - (jut_size + 1) / 2;
+            jrange_ptr->jut_tail = jut_head;
+        }
+        jthrd_mutex_unlock(&jrange_ptr->jmtx_lock);
+
+        // 检查到执行前的空隙中，该区间已被取空，则重新查找
+        if (0 == jut_size)
+        {
+            continue;
+        }
+
+        jrange_ptr = &jpctx_ptr->jranges[jut_widx];
+
+        jthrd_mutex_lock(&jrange_ptr->jmtx_lock);
+        jrange_ptr->jut_head = jut_head;
+        jrange_ptr->jut_tail = jut_tail;
+        jthrd_mutex_unlock(&jrange_ptr->jmtx_lock);
+
+        //======================================
+
+        break;
+    }
+
+    return J_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 工作线程的任务执行流程。
+ */
+static j_void_t jthrd_work(jthrd_pctx_t * jpctx_ptr, j_uint_t jut_widx)
+{
+    j_uint_t jut_tidx = 0;
+
+    for (;;)
+    {
+        if (jthrd_pop_head(&jpctx_ptr->jranges[jut_widx], &jut_tidx))
+        {
+            jpctx_ptr->jfunc_ptr(jpctx_ptr->jvt_ctxt, jut_widx, jut_tidx);
+        }
+        else if (!jthrd_steal(jpctx_ptr, jut_widx))
+        {
+            break;
+        }
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 工作线程的入口函数。
+ */
+static JTHRD_ROUTINE jthrd_routine(j_void_t * jvt_warg)
+{
+    jthrd_warg_t * jwarg_ptr = (jthrd_warg_t *)jvt_warg;
+    jthrd_work(jwarg_ptr->jpctx_ptr, jwarg_ptr->jut_widx);
+    return JTHRD_RETURN;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 外部接口函数
+
+/**********************************************************/
+/**
+ * @brief 获取当前系统可用的 CPU 核心数量（至少返回 1）。
+ */
+j_uint_t jthrd_ncpus(j_void_t)
+{
+    j_long_t jlt_ncpu = 1;
+
+#ifdef _WIN32
+    SYSTEM_INFO jsys_info;
+    GetSystemInfo(&jsys_info);
+    jlt_ncpu = (j_long_t)jsys_info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    jlt_ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+#endif // _WIN32
+
+    return (j_uint_t)((jlt_ncpu > 0) ? jlt_ncpu : 1);
+}
+
+/**********************************************************/
+/**
+ * @brief 计算 jthrd_parallel() 实际会使用的工作线程数量。
+ */
+j_uint_t jthrd_workers(j_uint_t jut_nthd, j_uint_t jut_ntask)
+{
+    if (0 == jut_nthd)
+        jut_nthd = jthrd_ncpus();
+    if (jut_nthd > JTHRD_MAX_WORKERS)
+        jut_nthd = JTHRD_MAX_WORKERS;
+    if (jut_nthd > jut_ntask)
+        jut_nthd = jut_ntask;
+
+    return ((jut_nthd > 0) ? jut_nthd : 1);
+}
+
+/**********************************************************/
+/**
+ * @brief 获取单调递增的时钟值（以 秒 为单位），用于统计任务耗时。
+ */
+double jthrd_clock(j_void_t)
+{
+#ifdef _WIN32
+    LARGE_INTEGER jli_freq;
+    LARGE_INTEGER jli_tick;
+    QueryPerformanceFrequency(&jli_freq);
+    QueryPerformanceCounter(&jli_tick);
+    return (double)jli_tick.QuadPart / (double)jli_freq.QuadPart;
+#else // !_WIN32
+    struct timespec jts_time;
+    clock_gettime(CLOCK_MONOTONIC, &jts_time);
+    return (double)jts_time.tv_sec + (double)jts_time.tv_nsec / 1000000000.0;
+#endif // _WIN32
+}
+
+/**********************************************************/
+/**
+ * @brief 使用多个工作线程，执行 [0, jut_ntask) 范围内的全部任务。
+ * @note
+ * 1. 任务索引按区间平均分配给各个工作线程，工作线程从自身区间的头部取任务，
+ *    自身区间执行完后，从剩余任务最多的区间尾部 窃取 一半任务继续执行；
+ * 2. 调用线程作为 0 号工作线程参与执行，接口返回时，全部任务均已执行完成；
+ * 3. 同一个工作线程索引号的任务，总是在同一个线程中顺序执行，
+ *    调用方可借此为每个工作线程准备 可重用 的上下文对象。
+ * 
+ * @param [in ] jut_nthd  : 工作线程数量（为 0 时，取 jthrd_ncpus() 的值）。
+ * @param [in ] jut_ntask : 任务数量。
+ * @param [in ] jfunc_ptr : 任务回调函数。
+ * @param [in ] jvt_ctxt  : 任务上下文（回调时传回）。
+ * 
+ * @return j_uint_t : 实际使用的工作线程数量（任务回调的 jut_widx 小于该值）。
+ */
+j_uint_t jthrd_parallel(
+                j_uint_t     jut_nthd,
+                j_uint_t     jut_ntask,
+                jthrd_task_t jfunc_ptr,
+                j_void_t   * jvt_ctxt)
+{
+    jthrd_pctx_t * jpctx_ptr = J_NULL;
+    j_uint_t       jut_iter  = 0;
+    j_uint_t       jut_nrun  = 1;
+
+    jthrd_warg_t   jwarg_arr[JTHRD_MAX_WORKERS];
+    jthrd_handle_t jthrd_arr[JTHRD_MAX_WORKERS];
+
+    //======================================
+
+    jut_nthd = jthrd_workers(jut_nthd, jut_ntask);
+
+    // 单线程（或 申请调度上下文失败）时，直接在调用线程中顺序执行
+    if (jut_nthd > 1)
+    {
+        jpctx_ptr = (jthrd_pctx_t *)calloc(1, sizeof(jthrd_pctx_t));
+    }
+
+    if (J_NULL == jpctx_ptr)
+    {
+        for (jut_iter = 0; jut_iter < jut_ntask; ++jut_iter)
+        {
+            jfunc_ptr(jvt_ctxt, 0, jut_iter);
+        }
+
+        return 1;
+    }
+
+    //======================================
+    // 平均分配任务区间
+
+    jpctx_ptr->jfunc_ptr = jfunc_ptr;
+    jpctx_ptr->jvt_ctxt  = jvt_ctxt;
+    jpctx_ptr->jut_nthd  = jut_nthd;
+
+    for (jut_iter = 0; jut_iter < jut_nthd; ++jut_iter)
+    {
+        jthrd_mutex_init(&jpctx_ptr->jranges[jut_iter].jmtx_lock);
+        jpctx_ptr->jranges[jut_iter].jut_head =
+            (j_uint_t)(((j_ulong_t)jut_ntask * jut_iter) / jut_nthd);
+        jpctx_ptr->jranges[jut_iter].jut_tail =
+            (j_uint_t)(((j_ulong_t)jut_ntask * (jut_iter + 1)) / jut_nthd);
+    }
+
+    //======================================
+    // 启动工作线程（创建失败的线程，其任务区间会被其他线程窃取执行）
+
+    for (jut_iter = 1; jut_iter < jut_nthd; ++jut_iter)
+    {
+        jwarg_arr[jut_nrun].jpctx_ptr = jpctx_ptr;
+        jwarg_arr[jut_nrun].jut_widx  = jut_iter;
+
+#ifdef _WIN32
+        jthrd_arr[jut_nrun] = (HANDLE)_beginthreadex(
+            J_NULL, 0, jthrd_routine, &jwarg_arr[jut_nrun], 0, J_NULL);
+        if (0 != jthrd_arr[jut_nrun])
+            jut_nrun += 1;
+#else // !_WIN32
+        if (0 == pthread_create(
+                    &jthrd_arr[jut_nrun],
+                    J_NULL,
+                    jthrd_routine,
+                    &jwarg_arr[jut_nrun]))
+        {
+            jut_nrun += 1;
+        }
+#endif // _WIN32
+    }
+
+    jthrd_work(jpctx_ptr, 0);
+
+    //======================================
+    // 等待工作线程结束
+
+    for (jut_iter = 1; jut_iter < jut_nrun; ++jut_iter)
+    {
+#ifdef _WIN32
+        WaitForSingleObject(jthrd_arr[jut_iter], INFINITE);
+        CloseHandle(jthrd_arr[jut_iter]);
+#else // !_WIN32
+        pthread_join(jthrd_arr[jut_iter], J_NULL);
+#endif // _WIN32
+    }
+
+    for (jut_iter = 0; jut_iter < jut_nthd; ++jut_iter)
+    {
+        jthrd_mutex_free(&jpctx_ptr->jranges[jut_iter].jmtx_lock);
+    }
+
+    free(jpctx_ptr);
+
+    //======================================
+
+    return jut_nthd;
+}
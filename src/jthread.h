@@ -0,0 +1,88 @@
+﻿/**
+ * @file jthread.h
+ * Copyright (c) 2024 Gaaagaa. All rights reserved.
+ * 
+ * @author  : Gaaagaa
+ * @date    : 2024-10-20
+ * @version : 1.0.0.0
+ * @brief   : 为 JPEG 编码器/解码器 的并行操作，声明简单的多线程任务执行接口。
+ */
+
+#ifndef __JTHREAD_H__
+#define __JTHREAD_H__
+
+#include "jcomm.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+////////////////////////////////////////////////////////////////////////////////
+
+/** 工作线程数量的上限值 */
+#define JTHRD_MAX_WORKERS   64
+
+/**
+ * @brief 任务回调函数类型。
+ * 
+ * @param [in ] jvt_ctxt : 调用 jthrd_parallel() 时传入的任务上下文。
+ * @param [in ] jut_widx : 执行该任务的工作线程索引号（0 ~ 工作线程数量 - 1）。
+ * @param [in ] jut_tidx : 任务索引号（0 ~ 任务数量 - 1）。
+ */
+typedef j_void_t (* jthrd_task_t)(
+                        j_void_t * jvt_ctxt,
+                        j_uint_t   jut_widx,
+                        j_uint_t   jut_tidx);
+
+/**********************************************************/
+/**
+ * @brief 获取当前系统可用的 CPU 核心数量（至少返回 1）。
+ */
+j_uint_t jthrd_ncpus(j_void_t);
+
+/**********************************************************/
+/**
+ * @brief 使用多个工作线程，执行 [0, jut_ntask) 范围内的全部任务。
+ * @note
+ * 1. 任务索引按区间平均分配给各个工作线程，工作线程从自身区间的头部取任务，
+ *    自身区间执行完后，从剩余任务最多的区间尾部 窃取 一半任务继续执行；
+ * 2. 调用线程作为 0 号工作线程参与执行，接口返回时，全部任务均已执行完成；
+ * 3. 同一个工作线程索引号的任务，总是在同一个线程中顺序执行，
+ *    调用方可借此为每个工作线程准备 可重用 的上下文对象。
+ * 
+ * @param [in ] jut_nthd  : 工作线程数量（为 0 时，取 jthrd_ncpus() 的值）。
+ * @param [in ] jut_ntask : 任务数量。
+ * @param [in ] jfunc_ptr : 任务回调函数。
+ * @param [in ] jvt_ctxt  : 任务上下文（回调时传回）。
+ * 
+ * @return j_uint_t : 实际使用的工作线程数量（任务回调的 jut_widx 小于该值）。
+ */
+j_uint_t jthrd_parallel(
+                j_uint_t     jut_nthd,
+                j_uint_t     jut_ntask,
+                jthrd_task_t jfunc_ptr,
+                j_void_t   * jvt_ctxt);
+
+/**********************************************************/
+/**
+ * @brief 计算 jthrd_parallel() 实际会使用的工作线程数量。
+ */
+j_uint_t jthrd_workers(j_uint_t jut_nthd, j_uint_t jut_ntask);
+
+/**********************************************************/
+/**
+ * @brief 获取单调递增的时钟值（以 秒 为单位），用于统计任务耗时。
+ */
+double jthrd_clock(j_void_t);
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}; // extern "C"
+#endif // __cplusplus
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __JTHREAD_H__
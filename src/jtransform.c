@@ -0,0 +1,2596 @@
+﻿/**
+ * @file jtransform.c
+ * Copyright (c) 2024 Gaaagaa. All rights reserved.
+ * 
+ * @author  : Gaaagaa
+ * @date    : 2024-10-26
+ * @version : 1.0.0.0
+ * @brief   : 封装 libjpeg 库的 DCT 系数读写接口（jdtrans.c/jctrans.c），实现 JPEG 无损变换。
+ */
+
+#include "jcomm.h"
+#include "jtransform.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define JPEG_INTERNALS
+#include "jcomm.inl"
+
+////////////////////////////////////////////////////////////////////////////////
+// JPEG 无损变换 相关常量与数据类型
+
+/** 定义 JPEG 无损变换操作的上下文 结构体类型标识 */
+#define JTRANS_HANDLE_TYPE  0x4A54524E
+
+/** 重定义 libjpeg 中的 JPEG 解码器/编码器结构体 名称 */
+typedef struct jpeg_decompress_struct  jtdec_obj_t;
+typedef struct jpeg_compress_struct    jtenc_obj_t;
+
+/**
+ * @struct jtrans_path_t
+ * @brief  在文件模式工作时，提供文件路径的字符串缓存。
+ */
+typedef struct jtrans_path_t
+{
+    j_size_t    jst_size;  ///< 字符串缓存大小
+    j_char_t  * jsz_path;  ///< 字符串缓存
+} jtrans_path_t;
+
+/** 按字节切分 的快速路径 不适用于当前操作时的返回值（内部使用，不会返回给调用方） */
+#define JTRANS_SLICE_SKIP   1
+
+/**
+ * @struct jtrans_slice_t
+ * @brief  按 重启段（RST 标记间的字节区间）切分 JPEG 数据流 所需的解析结果。
+ * @note
+ * 只针对 内存模式 的输入源，在首次使用时解析，调用 jtrans_config_input() 后失效。
+ */
+typedef struct jtrans_slice_t
+{
+    j_bool_t   jbl_scan;  ///< 是否已解析当前输入源
+    j_bool_t   jbl_able;  ///< 当前输入源 是否可按重启段切分
+    j_size_t   jst_ypos;  ///< SOF 标记中 图像高度字段 的偏移量
+    j_size_t   jst_data;  ///< 熵编码数据 的起始偏移量（即 头部信息的字节数）
+    j_uint_t   jut_imgw;  ///< 图像宽度
+    j_uint_t   jut_imgh;  ///< 图像高度
+    j_uint_t   jut_mcuw;  ///< MCU 的像素宽度
+    j_uint_t   jut_mcuh;  ///< MCU 的像素高度
+    j_uint_t   jut_mcux;  ///< 每行的 MCU 数量
+    j_uint_t   jut_mcuy;  ///< MCU 的行数
+    j_uint_t   jut_rsti;  ///< 重启间隔（MCU 数量）
+    j_uint_t   jut_nseg;  ///< 重启段 的数量
+    j_uint_t   jut_capa;  ///< jst_segs 的容量
+    j_size_t * jst_segs;  ///< 各个重启段的起始偏移量（共 jut_nseg + 1 项，末项为 EOI 标记的偏移量 + 2）
+} jtrans_slice_t;
+
+/**
+ * @enum  jtrans_marker_t
+ * @brief 复制 APPn/COM 标记 时的附加处理（可组合，由 变换回调 按输出图像设置）。
+ */
+typedef enum jtrans_marker_t
+{
+    JTRANS_MARKER_COPY   = 0x0000,  ///< 原样复制
+    JTRANS_MARKER_ORIENT = 0x0001,  ///< EXIF(APP1) 的 Orientation 标签 改写为 1（已按其方向 旋转/翻转）
+    JTRANS_MARKER_GRAY   = 0x0002,  ///< 跳过 ICC(APP2)/Adobe(APP14) 标记（输出为 灰度图像，彩色描述 不再适用）
+} jtrans_marker_t;
+
+/**
+ * @struct jtrans_ctx_t
+ * @brief  JPEG 无损变换操作的上下文。
+ */
+typedef struct jtrans_ctx_t
+{
+    j_uint_t        jut_size;  ///< 结构体大小
+    j_uint_t        jut_type;  ///< 结构体类型标识（固定为 JTRANS_HANDLE_TYPE）
+    jerr_mgr_t      jerr_mgr;  ///< JPEG 操作错误管理对象（解码器 与 编码器 共用）
+    jtdec_obj_t     jdec_obj;  ///< 读取 DCT 系数的 JPEG 解码器
+    jtenc_obj_t     jenc_obj;  ///< 写入 DCT 系数的 JPEG 编码器
+
+    jctl_mode_t     jct_srcm;  ///< libjpeg 当前输入源管理对象 所对应的输入模式
+    jctl_mode_t     jct_dest;  ///< libjpeg 当前输出目标管理对象 所对应的输出模式
+
+    /**
+     * @brief 输入源模式的相关工作参数。
+     */
+    struct
+    {
+        jctl_mode_t jct_mode;  ///< 输入模式
+        j_bool_t    jbl_spos;  ///< 文件流模式，jfp_spos 是否为有效的文件指针位置
+
+        union
+        {
+        j_size_t    jst_mlen;  ///< 内存模式，缓存大小
+        j_fpos_t    jfp_spos;  ///< 文件流模式，记录读取前的 文件指针偏移量
+        j_fstream_t jfs_file;  ///< 文件模式，保存打开的文件指针
+        };
+
+        union
+        {
+        j_fmemory_t jmt_iptr;  ///< 内存模式，其为输入 JPEG 数据的缓存地址
+        j_fstream_t jfs_istr;  ///< 文件流模式，其为输入 JPEG 数据的文件流
+        j_fszpath_t jsz_path;  ///< 文件模式，其为输入 JPEG 数据的文件路径
+        };
+    } jimode;
+
+    /**
+     * @brief 输出目标模式的相关工作参数。
+     */
+    struct
+    {
+        jctl_mode_t jct_mode;  ///< 输出模式
+
+        union
+        {
+        j_size_t    jst_mlen;  ///< 内存模式，缓存大小
+        j_fstream_t jfs_file;  ///< 文件模式，保存打开的文件指针
+        };
+
+        union
+        {
+        j_fmemory_t jmt_optr;  ///< 内存模式，其为输出 JPEG 数据的缓存地址
+        j_fstream_t jfs_ostr;  ///< 文件流模式，其为输出 JPEG 数据的文件流
+        j_fszpath_t jsz_path;  ///< 文件模式，其为输出 JPEG 数据的文件路径
+        };
+    } jomode;
+
+    jtrans_path_t   jipath;    ///< 输入文件路径的字符串缓存
+    jtrans_path_t   jopath;    ///< 输出文件路径的字符串缓存
+    jtrans_slice_t  jslice;    ///< 按重启段切分 输入数据流 的解析结果
+    j_uint_t        jut_mkrs;  ///< 复制 APPn/COM 标记 时的附加处理（ jtrans_marker_t 的组合）
+
+    /**
+     * @brief 在内存模式工作时，保存输出的 JPEG 数据流。
+     */
+    struct
+    {
+        j_size_t    jst_size;  ///< 有效字节数
+        j_mptr_t    jmt_mptr;  ///< 缓存地址（可能为 jomode.jmt_optr，也可能为内部分配的缓存）
+    } jbuff;
+} jtrans_ctx_t;
+
+/**
+ * @brief
+ * 变换操作的回调函数类型：在 读取 DCT 系数 与 写入 DCT 系数 之间调用，
+ * 负责调整 编码器 的输出参数，并给出待写入的 DCT 系数虚拟数组。
+ * @note  调用时，错误回调跳转代码（setjmp）已设置好。
+ * 
+ * @param [in ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in ] jsrc_arr    : 源图像的 DCT 系数虚拟数组。
+ * @param [out] jdst_arr    : 返回待写入的 DCT 系数虚拟数组。
+ * @param [in ] jvt_ctxt    : 变换操作的上下文。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+typedef j_int_t (* jtrans_xform_t)(
+                        jtrans_this_t       jtrans_this,
+                        jvirt_barray_ptr  * jsrc_arr,
+                        jvirt_barray_ptr ** jdst_arr,
+                        j_void_t          * jvt_ctxt);
+
+////////////////////////////////////////////////////////////////////////////////
+// JPEG 无损变换 内部接口函数
+
+/**********************************************************/
+/**
+ * @brief 更新文件路径的字符串缓存内容。
+ * 
+ * @param [in ] jpath_ptr : 文件路径的字符串缓存。
+ * @param [in ] jsz_path  : 更新的字符串内容。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+static j_int_t jtrans_update_path(jtrans_path_t * jpath_ptr, j_fszpath_t jsz_path)
+{
+    j_size_t jst_size = strlen(jsz_path);
+
+    if (jst_size >= jpath_ptr->jst_size)
+    {
+        if (J_NULL != jpath_ptr->jsz_path)
+            free(jpath_ptr->jsz_path);
+
+        jpath_ptr->jst_size = (j_size_t)jval_align(jst_size + 32, 32);
+        jpath_ptr->jsz_path = (j_char_t *)calloc(jpath_ptr->jst_size, sizeof(j_char_t));
+    }
+
+    if (J_NULL == jpath_ptr->jsz_path)
+    {
+        jpath_ptr->jst_size = 0;
+        return JTRANS_ERR_MALLOC;
+    }
+
+    strcpy(jpath_ptr->jsz_path, jsz_path);
+    return JTRANS_ERR_OK;
+}
+
+/**********************************************************/
+/**
+ * @brief 释放 内存模式 下内部分配的输出缓存（调用方指定的输出缓存 则不释放）。
+ */
+static j_void_t jtrans_free_buff(jtrans_this_t jtrans_this)
+{
+    if ((J_NULL != jtrans_this->jbuff.jmt_mptr) &&
+        !((JCTL_MODE_FMEMORY == jtrans_this->jomode.jct_mode) &&
+          (jtrans_this->jbuff.jmt_mptr == jtrans_this->jomode.jmt_optr)))
+    {
+        free(jtrans_this->jbuff.jmt_mptr);
+    }
+
+    jtrans_this->jbuff.jst_size = 0;
+    jtrans_this->jbuff.jmt_mptr = J_NULL;
+}
+
+/**********************************************************/
+/**
+ * @brief 按照输入源模式，设置 JPEG 解码器的数据源。
+ * 
+ * @param [in ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+static j_int_t jtrans_load_input(jtrans_this_t jtrans_this)
+{
+    jtdec_obj_t * jdec_ptr = &jtrans_this->jdec_obj;
+
+    // libjpeg 的 内存输入 与 文件输入 管理对象的大小不同，两者不可交替重用
+    if ((J_NULL != jdec_ptr->src) &&
+        ((JCTL_MODE_FMEMORY == jtrans_this->jct_srcm) !=
+         (JCTL_MODE_FMEMORY == jtrans_this->jimode.jct_mode)))
+    {
+        jdec_ptr->src = J_NULL;
+    }
+
+    jtrans_this->jct_srcm = jtrans_this->jimode.jct_mode;
+
+    switch (jtrans_this->jimode.jct_mode)
+    {
+    case JCTL_MODE_FMEMORY:
+        jpeg_mem_src(
+            jdec_ptr,
+            jtrans_this->jimode.jmt_iptr,
+            (unsigned long)jtrans_this->jimode.jst_mlen);
+        break;
+
+    case JCTL_MODE_FSTREAM:
+        if (0 != fgetpos(jtrans_this->jimode.jfs_istr, &jtrans_this->jimode.jfp_spos))
+        {
+            return JTRANS_ERR_FGETPOS;
+        }
+
+        jtrans_this->jimode.jbl_spos = J_TRUE;
+        jpeg_stdio_src(jdec_ptr, jtrans_this->jimode.jfs_istr);
+        break;
+
+    case JCTL_MODE_FSZPATH:
+        jtrans_this->jimode.jfs_file = fopen(jtrans_this->jimode.jsz_path, "rb");
+        if (J_NULL == jtrans_this->jimode.jfs_file)
+        {
+            return JTRANS_ERR_FOPEN;
+        }
+
+        jpeg_stdio_src(jdec_ptr, jtrans_this->jimode.jfs_file);
+        break;
+
+    default:
+        return JTRANS_ERR_UNCONFIG;
+    }
+
+    return JTRANS_ERR_OK;
+}
+
+/**********************************************************/
+/**
+ * @brief 完成变换操作后，卸载输入源模式的相关工作参数。
+ */
+static j_void_t jtrans_unload_input(jtrans_this_t jtrans_this)
+{
+    if (JCTL_MODE_FSTREAM == jtrans_this->jimode.jct_mode)
+    {
+        // 文件流模式时，重置文件指针位置
+        if (jtrans_this->jimode.jbl_spos)
+        {
+            fsetpos(jtrans_this->jimode.jfs_istr, &jtrans_this->jimode.jfp_spos);
+            jtrans_this->jimode.jbl_spos = J_FALSE;
+        }
+    }
+    else if (JCTL_MODE_FSZPATH == jtrans_this->jimode.jct_mode)
+    {
+        // 文件模式时，关闭打开的文件流
+        if (J_NULL != jtrans_this->jimode.jfs_file)
+        {
+            fclose(jtrans_this->jimode.jfs_file);
+            jtrans_this->jimode.jfs_file = J_NULL;
+        }
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 按照输出目标模式，设置 JPEG 编码器的输出目标。
+ * 
+ * @param [in ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+static j_int_t jtrans_setup_dest(jtrans_this_t jtrans_this)
+{
+    jtenc_obj_t * jenc_ptr = &jtrans_this->jenc_obj;
+
+    // libjpeg 的 内存输出 与 文件输出 管理对象的大小不同，两者不可交替重用
+    if ((J_NULL != jenc_ptr->dest) &&
+        ((JCTL_MODE_FMEMORY == jtrans_this->jct_dest) !=
+         (JCTL_MODE_FMEMORY == jtrans_this->jomode.jct_mode)))
+    {
+        jenc_ptr->dest = J_NULL;
+    }
+
+    jtrans_this->jct_dest = jtrans_this->jomode.jct_mode;
+
+    switch (jtrans_this->jomode.jct_mode)
+    {
+    case JCTL_MODE_FMEMORY:
+        jtrans_free_buff(jtrans_this);
+
+        jtrans_this->jbuff.jst_size = jtrans_this->jomode.jst_mlen;
+        jtrans_this->jbuff.jmt_mptr = jtrans_this->jomode.jmt_optr;
+
+        jpeg_mem_dest(
+            jenc_ptr,
+            &jtrans_this->jbuff.jmt_mptr,
+            &jtrans_this->jbuff.jst_size);
+        break;
+
+    case JCTL_MODE_FSTREAM:
+        jpeg_stdio_dest(jenc_ptr, jtrans_this->jomode.jfs_ostr);
+        break;
+
+    case JCTL_MODE_FSZPATH:
+        jtrans_this->jomode.jfs_file = fopen(jtrans_this->jomode.jsz_path, "wb+");
+        if (J_NULL == jtrans_this->jomode.jfs_file)
+        {
+            return JTRANS_ERR_FOPEN;
+        }
+
+        jpeg_stdio_dest(jenc_ptr, jtrans_this->jomode.jfs_file);
+        break;
+
+    default:
+        return JTRANS_ERR_UNCONFIG;
+    }
+
+    return JTRANS_ERR_OK;
+}
+
+/**********************************************************/
+/**
+ * @brief 完成变换操作后，卸载输出目标模式的相关工作参数。
+ * 
+ * @param [in ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in ] jbl_done    : 变换操作是否成功完成（失败时，内存模式的输出数据 被清空）。
+ */
+static j_void_t jtrans_unload_output(jtrans_this_t jtrans_this, j_bool_t jbl_done)
+{
+    if (JCTL_MODE_FMEMORY == jtrans_this->jomode.jct_mode)
+    {
+        if (!jbl_done)
+        {
+            jtrans_free_buff(jtrans_this);
+        }
+    }
+    else if (JCTL_MODE_FSZPATH == jtrans_this->jomode.jct_mode)
+    {
+        if (J_NULL != jtrans_this->jomode.jfs_file)
+        {
+            fclose(jtrans_this->jomode.jfs_file);
+            jtrans_this->jomode.jfs_file = J_NULL;
+        }
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 按 EXIF(TIFF) 的字节序（jbl_mm 为 J_TRUE 时 为大端），读取 16 位整数。
+ */
+static inline j_uint_t jtrans_exif_u16(const j_byte_t * jbt_data, j_bool_t jbl_mm)
+{
+    return jbl_mm ? (((j_uint_t)jbt_data[0] << 8) | jbt_data[1])
+                  : (((j_uint_t)jbt_data[1] << 8) | jbt_data[0]);
+}
+
+/**********************************************************/
+/**
+ * @brief 按 EXIF(TIFF) 的字节序（jbl_mm 为 J_TRUE 时 为大端），读取 32 位整数。
+ */
+static inline j_uint_t jtrans_exif_u32(const j_byte_t * jbt_data, j_bool_t jbl_mm)
+{
+    return jbl_mm ? ((jtrans_exif_u16(jbt_data    , jbl_mm) << 16) | jtrans_exif_u16(jbt_data + 2, jbl_mm))
+                  : ((jtrans_exif_u16(jbt_data + 2, jbl_mm) << 16) | jtrans_exif_u16(jbt_data    , jbl_mm));
+}
+
+/**********************************************************/
+/**
+ * @brief 将 EXIF(APP1) 标记数据中 IFD0 的 Orientation 标签（0x0112）改写为 1 。
+ * @note  数据不完整 或 不含该标签时，不做任何修改。
+ * 
+ * @param [in,out] jmt_data : EXIF 标记的数据（以 "Exif\0\0" 开头）。
+ * @param [in    ] jut_size : EXIF 标记的数据字节数。
+ */
+static j_void_t jtrans_exif_reset_orient(j_mptr_t jmt_data, j_uint_t jut_size)
+{
+    j_mptr_t jmt_tiff = jmt_data + 6;
+    j_uint_t jut_tlen = 0;
+    j_uint_t jut_ifd0 = 0;
+    j_uint_t jut_nent = 0;
+    j_uint_t jut_iter = 0;
+    j_uint_t jut_xpos = 0;
+    j_bool_t jbl_mm   = J_FALSE;
+
+    if ((jut_size < 6 + 8) || (0 != memcmp(jmt_data, "Exif\0\0", 6)))
+    {
+        return;
+    }
+
+    // TIFF 头：字节序（"II"/"MM"）、42、IFD0 的偏移量
+    jut_tlen = jut_size - 6;
+    if (0 == memcmp(jmt_tiff, "MM", 2))
+        jbl_mm = J_TRUE;
+    else if (0 != memcmp(jmt_tiff, "II", 2))
+        return;
+
+    if (42 != jtrans_exif_u16(jmt_tiff + 2, jbl_mm))
+    {
+        return;
+    }
+
+    jut_ifd0 = jtrans_exif_u32(jmt_tiff + 4, jbl_mm);
+    if ((jut_ifd0 < 8) || (jut_ifd0 > jut_tlen - 2))
+    {
+        return;
+    }
+
+    // IFD0 的各个条目（12 字节）：标签、类型、数量、值（或值的偏移量）
+    jut_nent = jtrans_exif_u16(jmt_tiff + jut_ifd0, jbl_mm);
+    for (jut_iter = 0; jut_iter < jut_nent; ++jut_iter)
+    {
+        jut_xpos = jut_ifd0 + 2 + 12 * jut_iter;
+        if (jut_xpos + 12 > jut_tlen)
+        {
+            break;
+        }
+
+        // Orientation 的类型为 SHORT(3)，数量为 1，值位于 值字段 的前 2 字节
+        if ((0x0112 == jtrans_exif_u16(jmt_tiff + jut_xpos    , jbl_mm)) &&
+            (0x0003 == jtrans_exif_u16(jmt_tiff + jut_xpos + 2, jbl_mm)))
+        {
+            jmt_tiff[jut_xpos + 8] = (j_byte_t)(jbl_mm ? 0 : 1);
+            jmt_tiff[jut_xpos + 9] = (j_byte_t)(jbl_mm ? 1 : 0);
+            break;
+        }
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 将源图像中保存的 APPn/COM 标记，写入到输出的 JPEG 数据流中。
+ * @note
+ * 1. libjpeg 会自行写入 JFIF(APP0)/Adobe(APP14) 标记，所以这两者不重复写入；
+ * 2. jut_mkrs 含 JTRANS_MARKER_ORIENT 时，EXIF 的 Orientation 标签 改写为 1；
+ * 3. jut_mkrs 含 JTRANS_MARKER_GRAY 时，不写入 ICC(APP2)/Adobe(APP14) 标记。
+ * 
+ * @param [in ] jdec_ptr : 读取 DCT 系数的 JPEG 解码器（保存了源图像的标记）。
+ * @param [in ] jenc_ptr : 写入 DCT 系数的 JPEG 编码器。
+ * @param [in ] jut_mkrs : 附加处理（ jtrans_marker_t 的组合）。
+ */
+static j_void_t jtrans_copy_markers(
+                    jtdec_obj_t * jdec_ptr,
+                    jtenc_obj_t * jenc_ptr,
+                    j_uint_t      jut_mkrs)
+{
+    jpeg_saved_marker_ptr jmkr_ptr = J_NULL;
+
+    for (jmkr_ptr = jdec_ptr->marker_list; J_NULL != jmkr_ptr; jmkr_ptr = jmkr_ptr->next)
+    {
+        if ((jut_mkrs & JTRANS_MARKER_ORIENT) && ((JPEG_APP0 + 1) == jmkr_ptr->marker))
+        {
+            jtrans_exif_reset_orient(jmkr_ptr->data, jmkr_ptr->data_length);
+        }
+
+        if (jenc_ptr->write_JFIF_header &&
+            (JPEG_APP0 == jmkr_ptr->marker) &&
+            (jmkr_ptr->data_length >= 5) &&
+            (0 == memcmp(jmkr_ptr->data, "JFIF", 5)))
+        {
+            continue;
+        }
+
+        if ((jut_mkrs & JTRANS_MARKER_GRAY) &&
+            ((JPEG_APP0 + 2) == jmkr_ptr->marker) &&
+            (jmkr_ptr->data_length >= 12) &&
+            (0 == memcmp(jmkr_ptr->data, "ICC_PROFILE", 12)))
+        {
+            continue;
+        }
+
+        if ((jenc_ptr->write_Adobe_marker || (jut_mkrs & JTRANS_MARKER_GRAY)) &&
+            ((JPEG_APP0 + 14) == jmkr_ptr->marker) &&
+            (jmkr_ptr->data_length >= 5) &&
+            (0 == memcmp(jmkr_ptr->data, "Adobe", 5)))
+        {
+            continue;
+        }
+
+        jpeg_write_marker(
+            jenc_ptr,
+            jmkr_ptr->marker,
+            jmkr_ptr->data,
+            jmkr_ptr->data_length);
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 执行 无损变换 的公共流程：
+ * 读取 DCT 系数 => 调用变换回调 => 写入 DCT 系数（重新熵编码）。
+ * @note
+ * 输出图像默认保留源图像的 量化表、渐进模式、算术编码、重启间隔，
+ * 以及 APPn/COM 标记，变换回调可再按需调整 编码器 的参数。
+ * 
+ * @param [in ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in ] jfunc_ptr   : 变换操作的回调函数。
+ * @param [in ] jvt_ctxt    : 变换操作的上下文（回调时传回）。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+static j_int_t jtrans_execute(
+                    jtrans_this_t  jtrans_this,
+                    jtrans_xform_t jfunc_ptr,
+                    j_void_t     * jvt_ctxt)
+{
+    j_int_t            jit_err  = JTRANS_ERR_UNKNOWN;
+    j_int_t            jit_iter = 0;
+    jtdec_obj_t      * jdec_ptr = &jtrans_this->jdec_obj;
+    jtenc_obj_t      * jenc_ptr = &jtrans_this->jenc_obj;
+    jvirt_barray_ptr * jsrc_arr = J_NULL;
+    jvirt_barray_ptr * jdst_arr = J_NULL;
+    j_uint_t           jut_rsti = 0;
+
+    //======================================
+
+    if ((JCTL_MODE_UNKNOWN == jtrans_this->jimode.jct_mode) ||
+        (JCTL_MODE_UNKNOWN == jtrans_this->jomode.jct_mode))
+    {
+        return JTRANS_ERR_UNCONFIG;
+    }
+
+    //======================================
+
+    do
+    {
+        //======================================
+        // 设置错误回调跳转代码
+
+        if (0 != setjmp(jtrans_this->jerr_mgr.jerr_jmp))
+        {
+            jit_err = JTRANS_ERR_EXCEPTION;
+            goto __EXIT_FUNC;
+        }
+
+        //======================================
+        // 设置 输入源 与 输出目标
+
+        jit_err = jtrans_load_input(jtrans_this);
+        if (JTRANS_ERR_OK != jit_err)
+        {
+            break;
+        }
+
+        jit_err = jtrans_setup_dest(jtrans_this);
+        if (JTRANS_ERR_OK != jit_err)
+        {
+            break;
+        }
+
+        //======================================
+        // 读取 DCT 系数（保存 APPn/COM 标记）
+
+        jpeg_save_markers(jdec_ptr, JPEG_COM, 0xFFFF);
+        for (jit_iter = 0; jit_iter < 16; ++jit_iter)
+        {
+            jpeg_save_markers(jdec_ptr, JPEG_APP0 + jit_iter, 0xFFFF);
+        }
+
+        if (JPEG_HEADER_OK != jpeg_read_header(jdec_ptr, J_TRUE))
+        {
+            jit_err = JTRANS_ERR_READ_HEADER;
+            break;
+        }
+
+        // 渐进模式下 各个扫描可有不同的 DRI，读完全部扫描后 只剩最后一个扫描的值，
+        // 所以在此记录 首个扫描（交错扫描，与 顺序模式的 MCU 相同）的重启间隔
+        jut_rsti = jdec_ptr->restart_interval;
+
+        jsrc_arr = jpeg_read_coefficients(jdec_ptr);
+
+        //======================================
+        // 按源图像设置编码参数，再执行变换回调
+
+        jpeg_copy_critical_parameters(jdec_ptr, jenc_ptr);
+
+        jenc_ptr->arith_code       = jdec_ptr->arith_code;
+        jenc_ptr->restart_interval = jut_rsti;
+        if (jdec_ptr->progressive_mode)
+        {
+            jpeg_simple_progression(jenc_ptr);
+        }
+
+        jtrans_this->jut_mkrs = JTRANS_MARKER_COPY;
+
+        jdst_arr = jsrc_arr;
+        jit_err  = jfunc_ptr(jtrans_this, jsrc_arr, &jdst_arr, jvt_ctxt);
+        if (JTRANS_ERR_OK != jit_err)
+        {
+            break;
+        }
+
+        //======================================
+        // 写入 DCT 系数（重新熵编码）
+
+        jpeg_write_coefficients(jenc_ptr, jdst_arr);
+        jtrans_copy_markers(jdec_ptr, jenc_ptr, jtrans_this->jut_mkrs);
+
+        jpeg_finish_compress(jenc_ptr);
+        jpeg_finish_decompress(jdec_ptr);
+
+        //======================================
+        jit_err = JTRANS_ERR_OK;
+    } while (0);
+
+    //======================================
+
+__EXIT_FUNC:
+    jpeg_abort_compress(jenc_ptr);
+    jpeg_abort_decompress(jdec_ptr);
+
+    jtrans_unload_input(jtrans_this);
+    jtrans_unload_output(jtrans_this, (JTRANS_ERR_OK == jit_err));
+
+    //======================================
+
+    return jit_err;
+}
+
+/**********************************************************/
+/**
+ * @brief 计算 iMCU 的像素尺寸（单分量图像的输出 按 1x1 采样，以 DCT 块为单位）。
+ */
+static inline j_void_t jtrans_imcu_size(
+                            jtdec_obj_t * jdec_ptr,
+                            j_int_t     * jit_mcuw,
+                            j_int_t     * jit_mcuh)
+{
+    if (1 == jdec_ptr->num_components)
+    {
+        *jit_mcuw = jdec_ptr->min_DCT_h_scaled_size;
+        *jit_mcuh = jdec_ptr->min_DCT_v_scaled_size;
+    }
+    else
+    {
+        *jit_mcuw = jdec_ptr->max_h_samp_factor * jdec_ptr->min_DCT_h_scaled_size;
+        *jit_mcuh = jdec_ptr->max_v_samp_factor * jdec_ptr->min_DCT_v_scaled_size;
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 剪切区域 限制在图像范围内，且左上角 向下对齐到 iMCU 边界
+ *        （宽度、高度 相应扩大，以保证仍然包含整个请求区域）。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+static j_int_t jtrans_crop_align(
+                    j_rect_t      * jrect_ptr,
+                    j_int_t         jit_imgw,
+                    j_int_t         jit_imgh,
+                    j_int_t         jit_mcuw,
+                    j_int_t         jit_mcuh)
+{
+    if ((jrect_ptr->jit_x < 0) || (jrect_ptr->jit_x >= jit_imgw) ||
+        (jrect_ptr->jit_y < 0) || (jrect_ptr->jit_y >= jit_imgh) ||
+        (jrect_ptr->jit_w <= 0) || (jrect_ptr->jit_h <= 0))
+    {
+        return JTRANS_ERR_AREA_EMPTY;
+    }
+
+    if (jrect_ptr->jit_w > jit_imgw - jrect_ptr->jit_x)
+        jrect_ptr->jit_w = jit_imgw - jrect_ptr->jit_x;
+    if (jrect_ptr->jit_h > jit_imgh - jrect_ptr->jit_y)
+        jrect_ptr->jit_h = jit_imgh - jrect_ptr->jit_y;
+
+    jrect_ptr->jit_w += jrect_ptr->jit_x % jit_mcuw;
+    jrect_ptr->jit_h += jrect_ptr->jit_y % jit_mcuh;
+    jrect_ptr->jit_x -= jrect_ptr->jit_x % jit_mcuw;
+    jrect_ptr->jit_y -= jrect_ptr->jit_y % jit_mcuh;
+
+    return JTRANS_ERR_OK;
+}
+
+/**********************************************************/
+/**
+ * @brief 无损剪切操作的 变换回调函数（jvt_ctxt 为 j_rect_t 对象）。
+ */
+static j_int_t jtrans_crop_xform(
+                    jtrans_this_t       jtrans_this,
+                    jvirt_barray_ptr  * jsrc_arr,
+                    jvirt_barray_ptr ** jdst_arr,
+                    j_void_t          * jvt_ctxt)
+{
+    j_rect_t            * jrect_ptr = (j_rect_t *)jvt_ctxt;
+    jtdec_obj_t         * jdec_ptr  = &jtrans_this->jdec_obj;
+    jtenc_obj_t         * jenc_ptr  = &jtrans_this->jenc_obj;
+    jpeg_component_info * jcomp_ptr = J_NULL;
+    jvirt_barray_ptr    * jarr_ptr  = J_NULL;
+    JBLOCKARRAY           jblk_src  = J_NULL;
+    JBLOCKARRAY           jblk_dst  = J_NULL;
+
+    j_int_t  jit_imgw = (j_int_t)jdec_ptr->image_width;
+    j_int_t  jit_imgh = (j_int_t)jdec_ptr->image_height;
+    j_int_t  jit_mcuw = 0;
+    j_int_t  jit_mcuh = 0;
+    j_int_t  jit_iter = 0;
+    j_int_t  jit_hsmp = 1;
+    j_int_t  jit_vsmp = 1;
+    j_uint_t jut_xblk = 0;
+    j_uint_t jut_yblk = 0;
+    j_uint_t jut_wblk = 0;
+    j_uint_t jut_hblk = 0;
+    j_uint_t jut_swid = 0;
+    j_uint_t jut_shgt = 0;
+    j_uint_t jut_brow = 0;
+    j_uint_t jut_ncpy = 0;
+
+    //======================================
+    // 剪切区域 对齐到 iMCU 边界
+
+    jtrans_imcu_size(jdec_ptr, &jit_mcuw, &jit_mcuh);
+
+    if (JTRANS_ERR_OK != jtrans_crop_align(jrect_ptr, jit_imgw, jit_imgh, jit_mcuw, jit_mcuh))
+    {
+        return JTRANS_ERR_AREA_EMPTY;
+    }
+
+    jenc_ptr->image_width  = (JDIMENSION)jrect_ptr->jit_w;
+    jenc_ptr->image_height = (JDIMENSION)jrect_ptr->jit_h;
+    jenc_ptr->jpeg_width   = (JDIMENSION)jrect_ptr->jit_w;
+    jenc_ptr->jpeg_height  = (JDIMENSION)jrect_ptr->jit_h;
+
+    // 单分量图像 强制使用 1x1 采样（某些解码器不支持 其他采样因子 的灰度图像）
+    if (1 == jdec_ptr->num_components)
+    {
+        jenc_ptr->comp_info[0].h_samp_factor = 1;
+        jenc_ptr->comp_info[0].v_samp_factor = 1;
+    }
+
+    // 整幅图像时，直接使用源图像的 DCT 系数
+    if ((jit_imgw == jrect_ptr->jit_w) && (jit_imgh == jrect_ptr->jit_h))
+    {
+        *jdst_arr = jsrc_arr;
+        return JTRANS_ERR_OK;
+    }
+
+    //======================================
+    // 申请输出的 DCT 系数虚拟数组
+
+    jarr_ptr = (jvirt_barray_ptr *)(*jdec_ptr->mem->alloc_small)(
+                    (j_common_ptr)jdec_ptr,
+                    JPOOL_IMAGE,
+                    sizeof(jvirt_barray_ptr) * jdec_ptr->num_components);
+
+    for (jit_iter = 0; jit_iter < jdec_ptr->num_components; ++jit_iter)
+    {
+        jcomp_ptr = &jdec_ptr->comp_info[jit_iter];
+        if (jdec_ptr->num_components > 1)
+        {
+            jit_hsmp = jcomp_ptr->h_samp_factor;
+            jit_vsmp = jcomp_ptr->v_samp_factor;
+        }
+
+        jut_wblk = (j_uint_t)jround_up(
+                        jdiv_round_up((long)jrect_ptr->jit_w * jit_hsmp, (long)jit_mcuw),
+                        (long)jit_hsmp);
+        jut_hblk = (j_uint_t)jround_up(
+                        jdiv_round_up((long)jrect_ptr->jit_h * jit_vsmp, (long)jit_mcuh),
+                        (long)jit_vsmp);
+
+        jarr_ptr[jit_iter] = (*jdec_ptr->mem->request_virt_barray)(
+                                (j_common_ptr)jdec_ptr,
+                                JPOOL_IMAGE,
+                                J_TRUE,
+                                (JDIMENSION)jut_wblk,
+                                (JDIMENSION)jut_hblk,
+                                (JDIMENSION)jit_vsmp);
+    }
+
+    (*jdec_ptr->mem->realize_virt_arrays)((j_common_ptr)jdec_ptr);
+
+    //======================================
+    // 逐行复制 区域内的 DCT 系数块
+
+    for (jit_iter = 0; jit_iter < jdec_ptr->num_components; ++jit_iter)
+    {
+        jcomp_ptr = &jdec_ptr->comp_info[jit_iter];
+        if (jdec_ptr->num_components > 1)
+        {
+            jit_hsmp = jcomp_ptr->h_samp_factor;
+            jit_vsmp = jcomp_ptr->v_samp_factor;
+        }
+
+        jut_xblk = (j_uint_t)(jrect_ptr->jit_x / jit_mcuw * jit_hsmp);
+        jut_yblk = (j_uint_t)(jrect_ptr->jit_y / jit_mcuh * jit_vsmp);
+        jut_wblk = (j_uint_t)jround_up(
+                        jdiv_round_up((long)jrect_ptr->jit_w * jit_hsmp, (long)jit_mcuw),
+                        (long)jit_hsmp);
+        jut_hblk = (j_uint_t)jround_up(
+                        jdiv_round_up((long)jrect_ptr->jit_h * jit_vsmp, (long)jit_mcuh),
+                        (long)jit_vsmp);
+        jut_swid = (j_uint_t)jround_up((long)jcomp_ptr->width_in_blocks,
+                                       (long)jcomp_ptr->h_samp_factor);
+        jut_shgt = (j_uint_t)jround_up((long)jcomp_ptr->height_in_blocks,
+                                       (long)jcomp_ptr->v_samp_factor);
+        jut_ncpy = (jut_xblk + jut_wblk <= jut_swid) ? jut_wblk : (jut_swid - jut_xblk);
+
+        for (jut_brow = 0; (jut_brow < jut_hblk) && (jut_yblk + jut_brow < jut_shgt); ++jut_brow)
+        {
+            jblk_src = (*jdec_ptr->mem->access_virt_barray)(
+                            (j_common_ptr)jdec_ptr, jsrc_arr[jit_iter],
+                            jut_yblk + jut_brow, 1, J_FALSE);
+            jblk_dst = (*jdec_ptr->mem->access_virt_barray)(
+                            (j_common_ptr)jdec_ptr, jarr_ptr[jit_iter],
+                            jut_brow, 1, J_TRUE);
+            memcpy(jblk_dst[0], jblk_src[0] + jut_xblk, jut_ncpy * sizeof(JBLOCK));
+        }
+    }
+
+    *jdst_arr = jarr_ptr;
+
+    //======================================
+
+    return JTRANS_ERR_OK;
+}
+
+/**********************************************************/
+/**
+ * @brief 解析 内存模式 的输入数据流，判断其能否 按重启段 直接切分，
+ *        并记录各个重启段的起始偏移量（结果保存在 jtrans_this->jslice 中）。
+ * @note
+ * 只接受 单次扫描（包含全部分量）的 顺序模式（SOF0/SOF1/SOF9）数据流，
+ * 且必须带有 重启间隔（DRI），RST 标记的数量与编号 都要与 MCU 总数相符。
+ */
+static j_void_t jtrans_slice_parse(jtrans_this_t jtrans_this)
+{
+    jtrans_slice_t * jslc_ptr = &jtrans_this->jslice;
+    const j_byte_t * jbt_data = (const j_byte_t *)jtrans_this->jimode.jmt_iptr;
+    const j_byte_t * jbt_seek = J_NULL;
+    const j_byte_t * jbt_mseg = J_NULL;
+    j_size_t         jst_size = jtrans_this->jimode.jst_mlen;
+    j_size_t         jst_spos = 2;
+    j_size_t         jst_mlen = 0;
+    j_size_t       * jst_segs = J_NULL;
+    j_uint_t         jut_ncmp = 0;
+    j_uint_t         jut_hmax = 1;
+    j_uint_t         jut_vmax = 1;
+    j_uint_t         jut_iter = 0;
+    j_uint_t         jut_nseg = 0;
+    j_byte_t         jbt_mark = 0;
+
+    jslc_ptr->jbl_scan = J_TRUE;
+    jslc_ptr->jbl_able = J_FALSE;
+    jslc_ptr->jst_ypos = 0;
+    jslc_ptr->jst_data = 0;
+    jslc_ptr->jut_rsti = 0;
+    jslc_ptr->jut_nseg = 0;
+
+    if ((jst_size < 4) || (0xFF != jbt_data[0]) || (0xD8 != jbt_data[1]))
+    {
+        return;
+    }
+
+    //======================================
+    // 逐个解析 SOS 之前的标记段
+
+    while (0 == jslc_ptr->jst_data)
+    {
+        if ((jst_spos >= jst_size) || (0xFF != jbt_data[jst_spos]))
+        {
+            return;
+        }
+
+        while ((jst_spos < jst_size) && (0xFF == jbt_data[jst_spos]))
+        {
+            jst_spos += 1;
+        }
+
+        if (jst_spos + 3 > jst_size)
+        {
+            return;
+        }
+
+        // 独立标记（TEM、RSTn、SOI、EOI）不应出现在 头部信息 中
+        jbt_mark = jbt_data[jst_spos++];
+        if ((0x01 == jbt_mark) || ((jbt_mark >= 0xD0) && (jbt_mark <= 0xD9)))
+        {
+            return;
+        }
+
+        jst_mlen = ((j_size_t)jbt_data[jst_spos] << 8) | jbt_data[jst_spos + 1];
+        if ((jst_mlen < 2) || (jst_spos + jst_mlen > jst_size))
+        {
+            return;
+        }
+
+        jbt_mseg = jbt_data + jst_spos + 2;
+        jst_mlen = jst_mlen - 2;
+
+        switch (jbt_mark)
+        {
+        case 0xC0: // SOF0 : 基线
+        case 0xC1: // SOF1 : 扩展顺序，哈夫曼编码
+        case 0xC9: // SOF9 : 扩展顺序，算术编码
+            if ((0 != jut_ncmp) || (jst_mlen < 6))
+            {
+                return;
+            }
+
+            jut_ncmp = jbt_mseg[5];
+            if ((jut_ncmp < 1) || (jut_ncmp > MAX_COMPS_IN_SCAN) || (jst_mlen != 6 + 3 * jut_ncmp))
+            {
+                return;
+            }
+
+            jslc_ptr->jst_ypos = jst_spos + 3;
+            jslc_ptr->jut_imgh = ((j_uint_t)jbt_mseg[1] << 8) | jbt_mseg[2];
+            jslc_ptr->jut_imgw = ((j_uint_t)jbt_mseg[3] << 8) | jbt_mseg[4];
+
+            for (jut_iter = 0; jut_iter < jut_ncmp; ++jut_iter)
+            {
+                if ((0 == (jbt_mseg[7 + 3 * jut_iter] >> 4)) || (0 == (jbt_mseg[7 + 3 * jut_iter] & 0x0F)))
+                {
+                    return;
+                }
+
+                if (jut_hmax < (j_uint_t)(jbt_mseg[7 + 3 * jut_iter] >> 4))
+                    jut_hmax = (j_uint_t)(jbt_mseg[7 + 3 * jut_iter] >> 4);
+                if (jut_vmax < (j_uint_t)(jbt_mseg[7 + 3 * jut_iter] & 0x0F))
+                    jut_vmax = (j_uint_t)(jbt_mseg[7 + 3 * jut_iter] & 0x0F);
+            }
+            break;
+
+        case 0xC2: case 0xC3: case 0xC5: case 0xC6: case 0xC7:
+        case 0xCA: case 0xCB: case 0xCD: case 0xCE: case 0xCF:
+        case 0xDC: // DNL
+        case 0xDE: // DHP
+            // 渐进、无损、分层 等模式，以及 DNL 定义高度的数据流，不支持
+            return;
+
+        case 0xDD: // DRI
+            if (2 != jst_mlen)
+            {
+                return;
+            }
+
+            jslc_ptr->jut_rsti = ((j_uint_t)jbt_mseg[0] << 8) | jbt_mseg[1];
+            break;
+
+        case 0xDA: // SOS : 必须包含全部分量，且为完整的 8x8 频谱（Ss = 0, Se = 63, Ah = Al = 0）
+            if ((0 == jut_ncmp) || (jst_mlen != 4 + 2 * jut_ncmp) || (jbt_mseg[0] != jut_ncmp) ||
+                (0 != jbt_mseg[1 + 2 * jut_ncmp]) || (63 != jbt_mseg[2 + 2 * jut_ncmp]) ||
+                (0 != jbt_mseg[3 + 2 * jut_ncmp]))
+            {
+                return;
+            }
+
+            jslc_ptr->jst_data = jst_spos + 2 + jst_mlen;
+            break;
+
+        default:
+            break;
+        }
+
+        jst_spos += 2 + jst_mlen;
+    }
+
+    if ((0 == jslc_ptr->jut_imgw) || (0 == jslc_ptr->jut_imgh) || (0 == jslc_ptr->jut_rsti))
+    {
+        return;
+    }
+
+    //======================================
+    // MCU 的布局（单分量图像 的 MCU 为一个 DCT 块）
+
+    if (1 == jut_ncmp)
+    {
+        jut_hmax = 1;
+        jut_vmax = 1;
+    }
+
+    jslc_ptr->jut_mcuw = jut_hmax * DCTSIZE;
+    jslc_ptr->jut_mcuh = jut_vmax * DCTSIZE;
+    jslc_ptr->jut_mcux = (jslc_ptr->jut_imgw + jslc_ptr->jut_mcuw - 1) / jslc_ptr->jut_mcuw;
+    jslc_ptr->jut_mcuy = (jslc_ptr->jut_imgh + jslc_ptr->jut_mcuh - 1) / jslc_ptr->jut_mcuh;
+
+    jut_nseg = (j_uint_t)jdiv_round_up(
+                    (long)jslc_ptr->jut_mcux * (long)jslc_ptr->jut_mcuy,
+                    (long)jslc_ptr->jut_rsti);
+
+    if (jut_nseg + 1 > jslc_ptr->jut_capa)
+    {
+        jst_segs = (j_size_t *)realloc(jslc_ptr->jst_segs, (jut_nseg + 1) * sizeof(j_size_t));
+        if (J_NULL == jst_segs)
+        {
+            return;
+        }
+
+        jslc_ptr->jst_segs = jst_segs;
+        jslc_ptr->jut_capa = jut_nseg + 1;
+    }
+
+    //======================================
+    // 扫描熵编码数据 中的标记：FF00 为填充字节，FFFF 为 标记前的填充，
+    // FFD0 ~ FFD7 为 RST 标记，其他标记 则表示熵编码数据结束（必须为 EOI）
+
+    jst_segs = jslc_ptr->jst_segs;
+    jst_segs[0] = jslc_ptr->jst_data;
+    jut_iter = 1;
+
+    for (jst_spos = jslc_ptr->jst_data; ; )
+    {
+        jbt_seek = (const j_byte_t *)memchr(jbt_data + jst_spos, 0xFF, jst_size - jst_spos);
+        if (J_NULL == jbt_seek)
+        {
+            return;
+        }
+
+        jst_spos = (j_size_t)(jbt_seek - jbt_data);
+        if (jst_spos + 1 >= jst_size)
+        {
+            return;
+        }
+
+        jbt_mark = jbt_data[jst_spos + 1];
+        if (0x00 == jbt_mark)
+        {
+            jst_spos += 2;
+        }
+        else if (0xFF == jbt_mark)
+        {
+            jst_spos += 1;
+        }
+        else if ((jbt_mark >= 0xD0) && (jbt_mark <= 0xD7))
+        {
+            if ((jut_iter >= jut_nseg) || (jbt_mark != 0xD0 + ((jut_iter - 1) & 7)))
+            {
+                return;
+            }
+
+            jst_spos += 2;
+            jst_segs[jut_iter++] = jst_spos;
+        }
+        else
+        {
+            if ((0xD9 != jbt_mark) || (jut_iter != jut_nseg))
+            {
+                return;
+            }
+
+            jst_segs[jut_nseg] = jst_spos + 2;
+            break;
+        }
+    }
+
+    jslc_ptr->jut_nseg = jut_nseg;
+    jslc_ptr->jbl_able = J_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 无损剪切的快速路径：全宽度的水平条带，且上下边界都落在 重启段 边界时，
+ *        直接复制 重启段 的字节区间，只修正 SOF 的图像高度 以及 RST 标记的编号，
+ *        不做任何 熵解码/熵编码。
+ * @note
+ * 1. 剪切区域的对齐方式 与 jtrans_crop_xform() 完全相同，输出的 DCT 系数 也完全相同；
+ * 2. 重启段 都是完整的，所以 DRI 无须修改（只有图像最后一段 可能不足重启间隔）。
+ * 
+ * @param [in    ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in,out] jrect_ptr   : 入参为请求的剪切区域，回参为实际的剪切区域。
+ * 
+ * @return j_int_t : 不适用时 返回 JTRANS_SLICE_SKIP，否则返回 jtrans_errno_t 相关枚举值。
+ */
+static j_int_t jtrans_slice_crop(jtrans_this_t jtrans_this, j_rect_t * jrect_ptr)
+{
+    jtrans_slice_t * jslc_ptr = &jtrans_this->jslice;
+    const j_byte_t * jbt_data = (const j_byte_t *)jtrans_this->jimode.jmt_iptr;
+    j_mptr_t         jmt_dptr = J_NULL;
+    j_fstream_t      jfs_ostr = J_NULL;
+    j_rect_t         jrc_area = *jrect_ptr;
+    j_byte_t         jbt_ybuf[2];
+    j_byte_t         jbt_mark[2];
+
+    j_int_t  jit_err  = JTRANS_ERR_UNKNOWN;
+    j_uint_t jut_row0 = 0;
+    j_uint_t jut_row1 = 0;
+    j_uint_t jut_seg0 = 0;
+    j_uint_t jut_seg1 = 0;
+    j_uint_t jut_iter = 0;
+    j_size_t jst_body = 0;
+    j_size_t jst_size = 0;
+
+    //======================================
+    // 判断 能否按重启段切分
+
+    if (JCTL_MODE_FMEMORY != jtrans_this->jimode.jct_mode)
+    {
+        return JTRANS_SLICE_SKIP;
+    }
+
+    if (!jslc_ptr->jbl_scan)
+    {
+        jtrans_slice_parse(jtrans_this);
+    }
+
+    if (!jslc_ptr->jbl_able)
+    {
+        return JTRANS_SLICE_SKIP;
+    }
+
+    // 区域无效时，仍由常规流程 返回错误码
+    jit_err = jtrans_crop_align(
+                    &jrc_area,
+                    (j_int_t)jslc_ptr->jut_imgw,
+                    (j_int_t)jslc_ptr->jut_imgh,
+                    (j_int_t)jslc_ptr->jut_mcuw,
+                    (j_int_t)jslc_ptr->jut_mcuh);
+    if ((JTRANS_ERR_OK != jit_err) ||
+        (0 != jrc_area.jit_x) || ((j_int_t)jslc_ptr->jut_imgw != jrc_area.jit_w))
+    {
+        return JTRANS_SLICE_SKIP;
+    }
+
+    jut_row0 = (j_uint_t)jrc_area.jit_y / jslc_ptr->jut_mcuh;
+    jut_row1 = ((j_uint_t)(jrc_area.jit_y + jrc_area.jit_h) + jslc_ptr->jut_mcuh - 1) / jslc_ptr->jut_mcuh;
+
+    if (0 != (jut_row0 * jslc_ptr->jut_mcux) % jslc_ptr->jut_rsti)
+    {
+        return JTRANS_SLICE_SKIP;
+    }
+
+    jut_seg0 = jut_row0 * jslc_ptr->jut_mcux / jslc_ptr->jut_rsti;
+
+    if (jut_row1 >= jslc_ptr->jut_mcuy)
+    {
+        jut_seg1 = jslc_ptr->jut_nseg;
+    }
+    else if (0 == (jut_row1 * jslc_ptr->jut_mcux) % jslc_ptr->jut_rsti)
+    {
+        jut_seg1 = jut_row1 * jslc_ptr->jut_mcux / jslc_ptr->jut_rsti;
+    }
+    else
+    {
+        return JTRANS_SLICE_SKIP;
+    }
+
+    //======================================
+    // 输出：头部信息（修正图像高度）+ 重启段 [jut_seg0, jut_seg1)（重新编号 RST）+ EOI
+
+    jbt_ybuf[0] = (j_byte_t)(jrc_area.jit_h >> 8);
+    jbt_ybuf[1] = (j_byte_t)(jrc_area.jit_h & 0xFF);
+    jbt_mark[0] = 0xFF;
+
+    jst_body = jslc_ptr->jst_segs[jut_seg1] - 2 - jslc_ptr->jst_segs[jut_seg0];
+    jst_size = jslc_ptr->jst_data + jst_body + 2;
+    jit_err  = JTRANS_ERR_OK;
+
+    switch (jtrans_this->jomode.jct_mode)
+    {
+    case JCTL_MODE_FMEMORY:
+        jtrans_free_buff(jtrans_this);
+
+        if ((J_NULL != jtrans_this->jomode.jmt_optr) && (jtrans_this->jomode.jst_mlen >= jst_size))
+            jmt_dptr = jtrans_this->jomode.jmt_optr;
+        else
+            jmt_dptr = (j_mptr_t)malloc(jst_size);
+
+        if (J_NULL == jmt_dptr)
+        {
+            jit_err = JTRANS_ERR_MALLOC;
+            break;
+        }
+
+        jtrans_this->jbuff.jmt_mptr = jmt_dptr;
+        jtrans_this->jbuff.jst_size = jst_size;
+
+        memcpy(jmt_dptr, jbt_data, jslc_ptr->jst_data);
+        memcpy(jmt_dptr + jslc_ptr->jst_ypos, jbt_ybuf, 2);
+        jmt_dptr += jslc_ptr->jst_data;
+
+        memcpy(jmt_dptr, jbt_data + jslc_ptr->jst_segs[jut_seg0], jst_body);
+        if (0 != (jut_seg0 & 7))
+        {
+            for (jut_iter = jut_seg0 + 1; jut_iter < jut_seg1; ++jut_iter)
+            {
+                jmt_dptr[jslc_ptr->jst_segs[jut_iter] - 1 - jslc_ptr->jst_segs[jut_seg0]] =
+                    (j_byte_t)(0xD0 + ((jut_iter - 1 - jut_seg0) & 7));
+            }
+        }
+
+        jmt_dptr[jst_body + 0] = 0xFF;
+        jmt_dptr[jst_body + 1] = 0xD9;
+        break;
+
+    case JCTL_MODE_FSTREAM:
+    case JCTL_MODE_FSZPATH:
+        if (JCTL_MODE_FSTREAM == jtrans_this->jomode.jct_mode)
+        {
+            jfs_ostr = jtrans_this->jomode.jfs_ostr;
+        }
+        else
+        {
+            jfs_ostr = fopen(jtrans_this->jomode.jsz_path, "wb+");
+            jtrans_this->jomode.jfs_file = jfs_ostr;
+            if (J_NULL == jfs_ostr)
+            {
+                jit_err = JTRANS_ERR_FOPEN;
+                break;
+            }
+        }
+
+        fwrite(jbt_data, 1, jslc_ptr->jst_ypos, jfs_ostr);
+        fwrite(jbt_ybuf, 1, 2, jfs_ostr);
+        fwrite(jbt_data + jslc_ptr->jst_ypos + 2, 1, jslc_ptr->jst_data - jslc_ptr->jst_ypos - 2, jfs_ostr);
+
+        if (0 == (jut_seg0 & 7))
+        {
+            fwrite(jbt_data + jslc_ptr->jst_segs[jut_seg0], 1, jst_body, jfs_ostr);
+        }
+        else
+        {
+            for (jut_iter = jut_seg0; jut_iter < jut_seg1; ++jut_iter)
+            {
+                if (jut_iter > jut_seg0)
+                {
+                    jbt_mark[1] = (j_byte_t)(0xD0 + ((jut_iter - 1 - jut_seg0) & 7));
+                    fwrite(jbt_mark, 1, 2, jfs_ostr);
+                }
+
+                fwrite(jbt_data + jslc_ptr->jst_segs[jut_iter],
+                       1,
+                       jslc_ptr->jst_segs[jut_iter + 1] - 2 - jslc_ptr->jst_segs[jut_iter],
+                       jfs_ostr);
+            }
+        }
+
+        jbt_mark[1] = 0xD9;
+        fwrite(jbt_mark, 1, 2, jfs_ostr);
+
+        if (ferror(jfs_ostr) || (0 != fflush(jfs_ostr)))
+        {
+            jit_err = JTRANS_ERR_EXCEPTION;
+        }
+        break;
+
+    default:
+        jit_err = JTRANS_ERR_UNCONFIG;
+        break;
+    }
+
+    jtrans_unload_output(jtrans_this, (JTRANS_ERR_OK == jit_err));
+
+    if (JTRANS_ERR_OK == jit_err)
+    {
+        *jrect_ptr = jrc_area;
+    }
+
+    //======================================
+
+    return jit_err;
+}
+
+/**
+ * @struct jtrans_block_map_t
+ * @brief  DCT 系数块 的变换映射表：输出块的系数 (v, u) = 源块系数 (v, u)（转置时为 (u, v)） * 符号。
+ */
+typedef struct jtrans_block_map_t
+{
+    j_bool_t jbl_tran;           ///< 是否转置（行列互换）
+    JCOEF    jcf_sign[DCTSIZE2]; ///< 系数符号（镜像时 奇数频率的系数取反）
+} jtrans_block_map_t;
+
+/**********************************************************/
+/**
+ * @brief 构建 DCT 系数块 的变换映射表：先按需转置，再对 水平/垂直 奇数频率的系数取反
+ *        （像素域的镜像 等价于 DCT 域奇数频率系数 取反）。
+ */
+static j_void_t jtrans_block_map(
+                    jtrans_block_map_t * jmap_ptr,
+                    j_bool_t             jbl_tran,
+                    j_bool_t             jbl_mirx,
+                    j_bool_t             jbl_miry)
+{
+    j_int_t jit_v;
+    j_int_t jit_u;
+
+    jmap_ptr->jbl_tran = jbl_tran;
+
+    for (jit_v = 0; jit_v < DCTSIZE; ++jit_v)
+    {
+        for (jit_u = 0; jit_u < DCTSIZE; ++jit_u)
+        {
+            jmap_ptr->jcf_sign[jit_v * DCTSIZE + jit_u] =
+                ((jbl_mirx && (jit_u & 1)) != (jbl_miry && (jit_v & 1))) ? -1 : 1;
+        }
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 按映射表 变换单个 DCT 系数块。
+ */
+static inline j_void_t jtrans_block_xform(
+                            JCOEFPTR                   jcoef_dst,
+                            JCOEFPTR                   jcoef_src,
+                            const jtrans_block_map_t * jmap_ptr)
+{
+    j_int_t jit_v;
+    j_int_t jit_u;
+
+    // 两种情况分开写 固定步长的循环，便于编译器向量化
+    if (jmap_ptr->jbl_tran)
+    {
+        for (jit_v = 0; jit_v < DCTSIZE; ++jit_v)
+        {
+            for (jit_u = 0; jit_u < DCTSIZE; ++jit_u)
+            {
+                jcoef_dst[jit_v * DCTSIZE + jit_u] =
+                    (JCOEF)(jcoef_src[jit_u * DCTSIZE + jit_v] *
+                            jmap_ptr->jcf_sign[jit_v * DCTSIZE + jit_u]);
+            }
+        }
+    }
+    else
+    {
+        for (jit_u = 0; jit_u < DCTSIZE2; ++jit_u)
+        {
+            jcoef_dst[jit_u] = (JCOEF)(jcoef_src[jit_u] * jmap_ptr->jcf_sign[jit_u]);
+        }
+    }
+}
+
+/**
+ * @struct jtrans_rotate_ctx_t
+ * @brief  无损 旋转/翻转 操作的参数（ jtrans_rotate_xform() 的回调上下文）。
+ * @note
+ * 所有操作 都可以分解为：先（可选地）转置，再对输出图像 做 水平/垂直 镜像，
+ * 例如：顺时针旋转 90 度 = 转置 + 水平镜像。
+ */
+typedef struct jtrans_rotate_ctx_t
+{
+    j_bool_t jbl_tran; ///< 是否转置
+    j_bool_t jbl_mirx; ///< 是否水平镜像
+    j_bool_t jbl_miry; ///< 是否垂直镜像
+    j_bool_t jbl_trim; ///< 是否裁掉 边缘不完整的 iMCU
+} jtrans_rotate_ctx_t;
+
+/**********************************************************/
+/**
+ * @brief 无损 旋转/翻转 操作的 变换回调函数（jvt_ctxt 为 jtrans_rotate_ctx_t 对象）。
+ */
+static j_int_t jtrans_rotate_xform(
+                    jtrans_this_t       jtrans_this,
+                    jvirt_barray_ptr  * jsrc_arr,
+                    jvirt_barray_ptr ** jdst_arr,
+                    j_void_t          * jvt_ctxt)
+{
+    jtrans_rotate_ctx_t * jrot_ptr  = (jtrans_rotate_ctx_t *)jvt_ctxt;
+    jtdec_obj_t         * jdec_ptr  = &jtrans_this->jdec_obj;
+    jtenc_obj_t         * jenc_ptr  = &jtrans_this->jenc_obj;
+    jpeg_component_info * jcomp_ptr = J_NULL;
+    jvirt_barray_ptr    * jarr_ptr  = J_NULL;
+    JQUANT_TBL          * jqtbl_ptr = J_NULL;
+    JBLOCKARRAY           jblk_src  = J_NULL;
+    JBLOCKARRAY           jblk_dst  = J_NULL;
+    UINT16                jqval;
+    JBLOCK                jblk_tmp;
+
+    // 块映射表 按 [是否水平镜像][是否垂直镜像] 索引（边缘不完整的 iMCU 不做镜像）
+    jtrans_block_map_t    jmap_tbl[2][2];
+    j_int_t               jit_mapx = 0;
+    j_int_t               jit_mapy = 0;
+
+    j_int_t  jit_imgw = 0;
+    j_int_t  jit_imgh = 0;
+    j_int_t  jit_mcuw = 0;
+    j_int_t  jit_mcuh = 0;
+    j_int_t  jit_iter = 0;
+    j_int_t  jit_ncol = 0;
+    j_int_t  jit_nrow = 0;
+    j_int_t  jit_hsmp = 1;
+    j_int_t  jit_vsmp = 1;
+    j_int_t  jit_u    = 0;
+    j_int_t  jit_v    = 0;
+    j_uint_t jut_wblk = 0;
+    j_uint_t jut_hblk = 0;
+    j_uint_t jut_mblx = 0;
+    j_uint_t jut_mbly = 0;
+    j_uint_t jut_xblk = 0;
+    j_uint_t jut_yblk = 0;
+    j_uint_t jut_xsrc = 0;
+    j_uint_t jut_ysrc = 0;
+
+    //======================================
+    // 输出图像的 尺寸 和 iMCU 尺寸（转置时 交换宽高）
+
+    jtrans_imcu_size(jdec_ptr, &jit_mcuw, &jit_mcuh);
+
+    if (jrot_ptr->jbl_tran)
+    {
+        jit_imgw = (j_int_t)jdec_ptr->image_height;
+        jit_imgh = (j_int_t)jdec_ptr->image_width;
+        jit_iter = jit_mcuw; jit_mcuw = jit_mcuh; jit_mcuh = jit_iter;
+    }
+    else
+    {
+        jit_imgw = (j_int_t)jdec_ptr->image_width;
+        jit_imgh = (j_int_t)jdec_ptr->image_height;
+    }
+
+    // 完整 iMCU 的 列数 和 行数，只有这部分 可以镜像
+    jit_ncol = jit_imgw / jit_mcuw;
+    jit_nrow = jit_imgh / jit_mcuh;
+
+    if (jrot_ptr->jbl_trim)
+    {
+        if (jrot_ptr->jbl_mirx && (jit_ncol > 0))
+            jit_imgw = jit_ncol * jit_mcuw;
+        if (jrot_ptr->jbl_miry && (jit_nrow > 0))
+            jit_imgh = jit_nrow * jit_mcuh;
+    }
+
+    jenc_ptr->image_width  = (JDIMENSION)jit_imgw;
+    jenc_ptr->image_height = (JDIMENSION)jit_imgh;
+    jenc_ptr->jpeg_width   = (JDIMENSION)jit_imgw;
+    jenc_ptr->jpeg_height  = (JDIMENSION)jit_imgh;
+
+    //======================================
+    // 转置时，同时转置 采样因子 和 量化表
+
+    if (1 == jdec_ptr->num_components)
+    {
+        jenc_ptr->comp_info[0].h_samp_factor = 1;
+        jenc_ptr->comp_info[0].v_samp_factor = 1;
+    }
+    else if (jrot_ptr->jbl_tran)
+    {
+        for (jit_iter = 0; jit_iter < jenc_ptr->num_components; ++jit_iter)
+        {
+            jcomp_ptr = &jenc_ptr->comp_info[jit_iter];
+            jit_hsmp  = jcomp_ptr->h_samp_factor;
+            jcomp_ptr->h_samp_factor = jcomp_ptr->v_samp_factor;
+            jcomp_ptr->v_samp_factor = jit_hsmp;
+        }
+    }
+
+    if (jrot_ptr->jbl_tran)
+    {
+        // 编码器的量化表 是 jpeg_copy_critical_parameters() 复制的副本，可直接修改
+        for (jit_iter = 0; jit_iter < NUM_QUANT_TBLS; ++jit_iter)
+        {
+            jqtbl_ptr = jenc_ptr->quant_tbl_ptrs[jit_iter];
+            if (J_NULL == jqtbl_ptr)
+            {
+                continue;
+            }
+
+            for (jit_v = 0; jit_v < DCTSIZE; ++jit_v)
+            {
+                for (jit_u = jit_v + 1; jit_u < DCTSIZE; ++jit_u)
+                {
+                    jqval = jqtbl_ptr->quantval[jit_v * DCTSIZE + jit_u];
+                    jqtbl_ptr->quantval[jit_v * DCTSIZE + jit_u] =
+                        jqtbl_ptr->quantval[jit_u * DCTSIZE + jit_v];
+                    jqtbl_ptr->quantval[jit_u * DCTSIZE + jit_v] = jqval;
+                }
+            }
+        }
+    }
+
+    if (!jrot_ptr->jbl_tran && !jrot_ptr->jbl_mirx && !jrot_ptr->jbl_miry)
+    {
+        *jdst_arr = jsrc_arr;
+        return JTRANS_ERR_OK;
+    }
+
+    // 像素方向已改变，源图像 EXIF 的 Orientation 标签 不再适用于输出图像
+    jtrans_this->jut_mkrs |= JTRANS_MARKER_ORIENT;
+
+    for (jit_mapx = 0; jit_mapx < 2; ++jit_mapx)
+    {
+        for (jit_mapy = 0; jit_mapy < 2; ++jit_mapy)
+        {
+            jtrans_block_map(
+                &jmap_tbl[jit_mapx][jit_mapy],
+                jrot_ptr->jbl_tran,
+                jrot_ptr->jbl_mirx && jit_mapx,
+                jrot_ptr->jbl_miry && jit_mapy);
+        }
+    }
+
+    //======================================
+    // 只做水平镜像时，在源数组上 原地交换 DCT 系数块，
+    // 省去输出数组的申请（以及首次访问新内存的缺页开销）
+
+    if (!jrot_ptr->jbl_tran && !jrot_ptr->jbl_miry)
+    {
+        for (jit_iter = 0; jit_iter < jdec_ptr->num_components; ++jit_iter)
+        {
+            jcomp_ptr = &jdec_ptr->comp_info[jit_iter];
+            if (jdec_ptr->num_components > 1)
+            {
+                jit_hsmp = jcomp_ptr->h_samp_factor;
+                jit_vsmp = jcomp_ptr->v_samp_factor;
+            }
+
+            jut_hblk = (j_uint_t)jround_up((long)jcomp_ptr->height_in_blocks, (long)jit_vsmp);
+            jut_mblx = (j_uint_t)(jit_ncol * jit_hsmp);
+
+            for (jut_yblk = 0; jut_yblk < jut_hblk; ++jut_yblk)
+            {
+                jblk_src = (*jdec_ptr->mem->access_virt_barray)(
+                                (j_common_ptr)jdec_ptr, jsrc_arr[jit_iter],
+                                jut_yblk, 1, J_TRUE);
+
+                for (jut_xblk = 0; jut_xblk < jut_mblx / 2; ++jut_xblk)
+                {
+                    jut_xsrc = jut_mblx - 1 - jut_xblk;
+
+                    jtrans_block_xform(jblk_tmp, jblk_src[0][jut_xblk], &jmap_tbl[1][0]);
+                    jtrans_block_xform(jblk_src[0][jut_xblk], jblk_src[0][jut_xsrc], &jmap_tbl[1][0]);
+                    memcpy(jblk_src[0][jut_xsrc], jblk_tmp, sizeof(JBLOCK));
+                }
+
+                if (jut_mblx & 1)
+                {
+                    jtrans_block_xform(
+                        jblk_src[0][jut_xblk], jblk_src[0][jut_xblk], &jmap_tbl[1][0]);
+                }
+            }
+        }
+
+        *jdst_arr = jsrc_arr;
+        return JTRANS_ERR_OK;
+    }
+
+    //======================================
+    // 申请输出的 DCT 系数虚拟数组
+
+    jarr_ptr = (jvirt_barray_ptr *)(*jdec_ptr->mem->alloc_small)(
+                    (j_common_ptr)jdec_ptr,
+                    JPOOL_IMAGE,
+                    sizeof(jvirt_barray_ptr) * jdec_ptr->num_components);
+
+    for (jit_iter = 0; jit_iter < jdec_ptr->num_components; ++jit_iter)
+    {
+        jcomp_ptr = &jenc_ptr->comp_info[jit_iter];
+        if (jdec_ptr->num_components > 1)
+        {
+            jit_hsmp = jcomp_ptr->h_samp_factor;
+            jit_vsmp = jcomp_ptr->v_samp_factor;
+        }
+
+        jut_wblk = (j_uint_t)jround_up(
+                        jdiv_round_up((long)jit_imgw * jit_hsmp, (long)jit_mcuw),
+                        (long)jit_hsmp);
+        jut_hblk = (j_uint_t)jround_up(
+                        jdiv_round_up((long)jit_imgh * jit_vsmp, (long)jit_mcuh),
+                        (long)jit_vsmp);
+
+        jarr_ptr[jit_iter] = (*jdec_ptr->mem->request_virt_barray)(
+                                (j_common_ptr)jdec_ptr,
+                                JPOOL_IMAGE,
+                                J_FALSE,
+                                (JDIMENSION)jut_wblk,
+                                (JDIMENSION)jut_hblk,
+                                (JDIMENSION)jit_vsmp);
+    }
+
+    (*jdec_ptr->mem->realize_virt_arrays)((j_common_ptr)jdec_ptr);
+
+    //======================================
+    // 逐块 重排 DCT 系数：输出块 (x, y) 先镜像得到 (px, py)，
+    // 转置时 对应源图像的块 (py, px)，否则对应 (px, py)
+
+    for (jit_iter = 0; jit_iter < jdec_ptr->num_components; ++jit_iter)
+    {
+        jcomp_ptr = &jenc_ptr->comp_info[jit_iter];
+        if (jdec_ptr->num_components > 1)
+        {
+            jit_hsmp = jcomp_ptr->h_samp_factor;
+            jit_vsmp = jcomp_ptr->v_samp_factor;
+        }
+
+        jut_wblk = (j_uint_t)jround_up(
+                        jdiv_round_up((long)jit_imgw * jit_hsmp, (long)jit_mcuw),
+                        (long)jit_hsmp);
+        jut_hblk = (j_uint_t)jround_up(
+                        jdiv_round_up((long)jit_imgh * jit_vsmp, (long)jit_mcuh),
+                        (long)jit_vsmp);
+        jut_mblx = (j_uint_t)(jit_ncol * jit_hsmp);
+        jut_mbly = (j_uint_t)(jit_nrow * jit_vsmp);
+
+        for (jut_yblk = 0; jut_yblk < jut_hblk; ++jut_yblk)
+        {
+            jblk_dst = (*jdec_ptr->mem->access_virt_barray)(
+                            (j_common_ptr)jdec_ptr, jarr_ptr[jit_iter],
+                            jut_yblk, 1, J_TRUE);
+
+            jit_mapy = (jrot_ptr->jbl_miry && (jut_yblk < jut_mbly)) ? 1 : 0;
+            jut_ysrc = jit_mapy ? (jut_mbly - 1 - jut_yblk) : jut_yblk;
+
+            if (!jrot_ptr->jbl_tran)
+            {
+                jblk_src = (*jdec_ptr->mem->access_virt_barray)(
+                                (j_common_ptr)jdec_ptr, jsrc_arr[jit_iter],
+                                jut_ysrc, 1, J_FALSE);
+            }
+
+            for (jut_xblk = 0; jut_xblk < jut_wblk; ++jut_xblk)
+            {
+                jit_mapx = (jrot_ptr->jbl_mirx && (jut_xblk < jut_mblx)) ? 1 : 0;
+                jut_xsrc = jit_mapx ? (jut_mblx - 1 - jut_xblk) : jut_xblk;
+
+                if (jrot_ptr->jbl_tran)
+                {
+                    jblk_src = (*jdec_ptr->mem->access_virt_barray)(
+                                    (j_common_ptr)jdec_ptr, jsrc_arr[jit_iter],
+                                    jut_xsrc, 1, J_FALSE);
+
+                    jtrans_block_xform(
+                        jblk_dst[0][jut_xblk],
+                        jblk_src[0][jut_ysrc],
+                        &jmap_tbl[jit_mapx][jit_mapy]);
+                }
+                else
+                {
+                    jtrans_block_xform(
+                        jblk_dst[0][jut_xblk],
+                        jblk_src[0][jut_xsrc],
+                        &jmap_tbl[jit_mapx][jit_mapy]);
+                }
+            }
+        }
+    }
+
+    *jdst_arr = jarr_ptr;
+
+    //======================================
+
+    return JTRANS_ERR_OK;
+}
+
+/**********************************************************/
+/**
+ * @brief 无损重新编码操作的 变换回调函数（jvt_ctxt 为 jtrans_recode_t 对象）。
+ * @note  DCT 系数不变，只调整 编码器 的熵编码参数。
+ */
+static j_int_t jtrans_recode_xform(
+                    jtrans_this_t       jtrans_this,
+                    jvirt_barray_ptr  * jsrc_arr,
+                    jvirt_barray_ptr ** jdst_arr,
+                    j_void_t          * jvt_ctxt)
+{
+    const jtrans_recode_t * jrecode_ptr = (const jtrans_recode_t *)jvt_ctxt;
+    jtenc_obj_t           * jenc_ptr    = &jtrans_this->jenc_obj;
+
+    //======================================
+    // 熵编码方式（libjpeg 开启优化时 会关闭算术编码，所以算术编码优先）
+
+    if (JTRANS_RECODE_KEEP != jrecode_ptr->jit_arith)
+    {
+        jenc_ptr->arith_code = (0 != jrecode_ptr->jit_arith);
+    }
+
+    jenc_ptr->optimize_coding = (jrecode_ptr->jbl_optim && !jenc_ptr->arith_code);
+
+    //======================================
+    // 扫描模式（编码器的 scan_info 为 J_NULL 时，使用基线顺序模式）
+
+    if (1 == jrecode_ptr->jit_prog)
+    {
+        jpeg_simple_progression(jenc_ptr);
+    }
+    else if (0 == jrecode_ptr->jit_prog)
+    {
+        jenc_ptr->scan_info = J_NULL;
+        jenc_ptr->num_scans = 0;
+    }
+
+    //======================================
+    // 重启间隔
+
+    if (JTRANS_RECODE_KEEP != jrecode_ptr->jit_rrows)
+    {
+        jenc_ptr->restart_interval = 0;
+        jenc_ptr->restart_in_rows  = (jrecode_ptr->jit_rrows > 0) ? jrecode_ptr->jit_rrows : 0;
+    }
+
+    //======================================
+
+    *jdst_arr = jsrc_arr;
+
+    return JTRANS_ERR_OK;
+}
+
+/**********************************************************/
+/**
+ * @brief 重新量化操作的 变换回调函数（jvt_ctxt 为 目标质量 j_int_t 对象）。
+ * @note
+ * 1. 目标量化表 取 libjpeg 标准量化表（按目标质量缩放）与 源量化表 的逐项较大值，
+ *    以保证只会变得更粗糙（比源量化表更细的步长 无法恢复已丢失的精度）；
+ * 2. 直接修改源图像的 DCT 系数，不申请输出数组。
+ */
+static j_int_t jtrans_requant_xform(
+                    jtrans_this_t       jtrans_this,
+                    jvirt_barray_ptr  * jsrc_arr,
+                    jvirt_barray_ptr ** jdst_arr,
+                    j_void_t          * jvt_ctxt)
+{
+    jtdec_obj_t         * jdec_ptr  = &jtrans_this->jdec_obj;
+    jtenc_obj_t         * jenc_ptr  = &jtrans_this->jenc_obj;
+    jpeg_component_info * jcomp_ptr = J_NULL;
+    JQUANT_TBL          * jsrc_tbl  = J_NULL;
+    JQUANT_TBL          * jdst_tbl  = J_NULL;
+    JBLOCKARRAY           jblk_row  = J_NULL;
+    JCOEF               * jcf_blk   = J_NULL;
+    UINT16                jstd_tbl[2][DCTSIZE2];
+    j_uint_t              jut_qsrc[DCTSIZE2];
+    j_uint_t              jut_half[DCTSIZE2];
+    unsigned long long    jul_rcp[DCTSIZE2];
+
+    j_int_t  jit_iter = 0;
+    j_int_t  jit_kpos = 0;
+    j_int_t  jit_coef = 0;
+    j_int_t  jit_sign = 0;
+    j_uint_t jut_coef = 0;
+    j_uint_t jut_xblk = 0;
+    j_uint_t jut_yblk = 0;
+
+    //======================================
+    // 按目标质量 生成标准量化表（0 号为亮度表，1 号为色度表）
+
+    jpeg_set_quality(jenc_ptr, *(j_int_t *)jvt_ctxt, J_TRUE);
+
+    memcpy(jstd_tbl[0], jenc_ptr->quant_tbl_ptrs[0]->quantval, sizeof(jstd_tbl[0]));
+    memcpy(jstd_tbl[1], jenc_ptr->quant_tbl_ptrs[1]->quantval, sizeof(jstd_tbl[1]));
+
+    //======================================
+    // 各个量化表槽位：取 源量化表 与 标准量化表 的逐项较大值
+
+    for (jit_iter = 0; jit_iter < NUM_QUANT_TBLS; ++jit_iter)
+    {
+        jsrc_tbl = jdec_ptr->quant_tbl_ptrs[jit_iter];
+        jdst_tbl = jenc_ptr->quant_tbl_ptrs[jit_iter];
+        if ((J_NULL == jsrc_tbl) || (J_NULL == jdst_tbl))
+        {
+            continue;
+        }
+
+        for (jit_kpos = 0; jit_kpos < DCTSIZE2; ++jit_kpos)
+        {
+            jdst_tbl->quantval[jit_kpos] = jstd_tbl[(0 == jit_iter) ? 0 : 1][jit_kpos];
+            if (jdst_tbl->quantval[jit_kpos] < jsrc_tbl->quantval[jit_kpos])
+            {
+                jdst_tbl->quantval[jit_kpos] = jsrc_tbl->quantval[jit_kpos];
+            }
+        }
+
+        jdst_tbl->sent_table = J_FALSE;
+    }
+
+    //======================================
+    // 各个分量的 DCT 系数：按 源步长 / 目标步长 缩放，舍入到最近的整数，
+    // 恰好位于中点时 向 0 舍入（系数的分布 以 0 为峰值，区间内真实值偏向 0，
+    // 步长整倍数变化 如 质量 75 -> 50 时，中点非常普遍，向外舍入 会保留大量 ±1），
+    // 即 q = (|c| * S + (D - 1)/2) / D，以 倒数乘法 代替除法：
+    // S <= D < 2^16，n = |c| * S + (D - 1)/2 < 2^31，则 n * ceil(2^47 / D) < 2^63，
+    // 且误差小于 n / 2^47 < 2^-16 < 1 / D，所以 floor(n * ceil(2^47 / D) / 2^47) == floor(n / D)
+
+    for (jit_iter = 0; jit_iter < jdec_ptr->num_components; ++jit_iter)
+    {
+        jcomp_ptr = &jdec_ptr->comp_info[jit_iter];
+        jsrc_tbl  = jcomp_ptr->quant_table;
+        jdst_tbl  = jenc_ptr->quant_tbl_ptrs[jenc_ptr->comp_info[jit_iter].quant_tbl_no];
+
+        if (0 == memcmp(jsrc_tbl->quantval, jdst_tbl->quantval, sizeof(jsrc_tbl->quantval)))
+        {
+            continue;
+        }
+
+        for (jit_kpos = 0; jit_kpos < DCTSIZE2; ++jit_kpos)
+        {
+            jut_qsrc[jit_kpos] = (j_uint_t)jsrc_tbl->quantval[jit_kpos];
+            jut_half[jit_kpos] = ((j_uint_t)jdst_tbl->quantval[jit_kpos] - 1) >> 1;
+            jul_rcp [jit_kpos] = ((1ULL << 47) + jdst_tbl->quantval[jit_kpos] - 1) /
+                                 jdst_tbl->quantval[jit_kpos];
+        }
+
+        for (jut_yblk = 0; jut_yblk < jcomp_ptr->height_in_blocks; ++jut_yblk)
+        {
+            jblk_row = (*jdec_ptr->mem->access_virt_barray)(
+                            (j_common_ptr)jdec_ptr, jsrc_arr[jit_iter],
+                            jut_yblk, 1, J_TRUE);
+
+            for (jut_xblk = 0; jut_xblk < jcomp_ptr->width_in_blocks; ++jut_xblk)
+            {
+                jcf_blk = jblk_row[0][jut_xblk];
+
+                // 系数 0 的结果仍为 0，不做分支判断，便于编译器向量化
+                for (jit_kpos = 0; jit_kpos < DCTSIZE2; ++jit_kpos)
+                {
+                    jit_coef = jcf_blk[jit_kpos];
+                    jit_sign = jit_coef >> 31;
+                    jut_coef = (j_uint_t)((jit_coef ^ jit_sign) - jit_sign);
+                    jut_coef = (j_uint_t)(((unsigned long long)(
+                                    jut_coef * jut_qsrc[jit_kpos] + jut_half[jit_kpos]) *
+                                    jul_rcp[jit_kpos]) >> 47);
+
+                    jcf_blk[jit_kpos] = (JCOEF)(((j_int_t)jut_coef ^ jit_sign) - jit_sign);
+                }
+            }
+        }
+    }
+
+    *jdst_arr = jsrc_arr;
+
+    //======================================
+
+    return JTRANS_ERR_OK;
+}
+
+/**
+ * @struct jtrans_erase_ctx_t
+ * @brief  区域擦除操作的参数（ jtrans_erase_xform() 的回调上下文）。
+ */
+typedef struct jtrans_erase_ctx_t
+{
+    j_rect_t      * jrect_ptr; ///< 擦除区域
+    j_uint_t        jut_color; ///< 擦除颜色（0x00RRGGBB 格式）
+} jtrans_erase_ctx_t;
+
+/**********************************************************/
+/**
+ * @brief 将 RGB 颜色，按源图像的色彩空间 转换为各个分量的 样本值（0 ~ 255）。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+static j_int_t jtrans_erase_samples(
+                    jtdec_obj_t * jdec_ptr,
+                    j_uint_t      jut_color,
+                    double        jdt_smpl[3])
+{
+    double jdt_r = (double)((jut_color >> 16) & 0xFF);
+    double jdt_g = (double)((jut_color >>  8) & 0xFF);
+    double jdt_b = (double)((jut_color      ) & 0xFF);
+
+    switch (jdec_ptr->jpeg_color_space)
+    {
+    case JCS_GRAYSCALE:
+        jdt_smpl[0] = 0.299 * jdt_r + 0.587 * jdt_g + 0.114 * jdt_b;
+        break;
+
+    case JCS_YCbCr:
+    case JCS_BG_YCC:
+        jdt_smpl[0] =  0.299    * jdt_r + 0.587    * jdt_g + 0.114    * jdt_b;
+        jdt_smpl[1] = -0.168736 * jdt_r - 0.331264 * jdt_g + 0.5      * jdt_b;
+        jdt_smpl[2] =  0.5      * jdt_r - 0.418688 * jdt_g - 0.081312 * jdt_b;
+
+        // BG_YCC 的色差分量 按 1/2 比例存储
+        if (JCS_BG_YCC == jdec_ptr->jpeg_color_space)
+        {
+            jdt_smpl[1] *= 0.5;
+            jdt_smpl[2] *= 0.5;
+        }
+
+        jdt_smpl[1] += CENTERJSAMPLE;
+        jdt_smpl[2] += CENTERJSAMPLE;
+        break;
+
+    case JCS_RGB:
+    case JCS_BG_RGB:
+        if (JCT_SUBTRACT_GREEN == jdec_ptr->color_transform)
+        {
+            jdt_smpl[0] = (double)((((j_int_t)jdt_r - (j_int_t)jdt_g) + CENTERJSAMPLE) & MAXJSAMPLE);
+            jdt_smpl[1] = jdt_g;
+            jdt_smpl[2] = (double)((((j_int_t)jdt_b - (j_int_t)jdt_g) + CENTERJSAMPLE) & MAXJSAMPLE);
+        }
+        else
+        {
+            jdt_smpl[0] = jdt_r;
+            jdt_smpl[1] = jdt_g;
+            jdt_smpl[2] = jdt_b;
+        }
+        break;
+
+    default:
+        return JTRANS_ERR_CS_UNSUPPORT;
+    }
+
+    return JTRANS_ERR_OK;
+}
+
+/**********************************************************/
+/**
+ * @brief 区域擦除操作的 变换回调函数（jvt_ctxt 为 jtrans_erase_ctx_t 对象）。
+ * @note  直接修改源图像的 DCT 系数，不申请输出数组。
+ */
+static j_int_t jtrans_erase_xform(
+                    jtrans_this_t       jtrans_this,
+                    jvirt_barray_ptr  * jsrc_arr,
+                    jvirt_barray_ptr ** jdst_arr,
+                    j_void_t          * jvt_ctxt)
+{
+    jtrans_erase_ctx_t  * jera_ptr  = (jtrans_erase_ctx_t *)jvt_ctxt;
+    j_rect_t            * jrect_ptr = jera_ptr->jrect_ptr;
+    jtdec_obj_t         * jdec_ptr  = &jtrans_this->jdec_obj;
+    jpeg_component_info * jcomp_ptr = J_NULL;
+    JBLOCKARRAY           jblk_row  = J_NULL;
+    double                jdt_smpl[3];
+    JCOEF                 jcf_dc;
+
+    j_int_t  jit_err  = JTRANS_ERR_UNKNOWN;
+    j_int_t  jit_imgw = (j_int_t)jdec_ptr->image_width;
+    j_int_t  jit_imgh = (j_int_t)jdec_ptr->image_height;
+    j_int_t  jit_mcuw = 0;
+    j_int_t  jit_mcuh = 0;
+    j_int_t  jit_xend = 0;
+    j_int_t  jit_yend = 0;
+    j_int_t  jit_iter = 0;
+    j_int_t  jit_hsmp = 1;
+    j_int_t  jit_vsmp = 1;
+    j_uint_t jut_xblk = 0;
+    j_uint_t jut_yblk = 0;
+    j_uint_t jut_xmax = 0;
+    j_uint_t jut_ymax = 0;
+
+    //======================================
+    // 擦除颜色 转换为各个分量的 样本值
+
+    jit_err = jtrans_erase_samples(jdec_ptr, jera_ptr->jut_color, jdt_smpl);
+    if (JTRANS_ERR_OK != jit_err)
+    {
+        return jit_err;
+    }
+
+    //======================================
+    // 擦除区域 向外扩展到 iMCU 边界
+
+    if ((jrect_ptr->jit_x < 0) || (jrect_ptr->jit_x >= jit_imgw) ||
+        (jrect_ptr->jit_y < 0) || (jrect_ptr->jit_y >= jit_imgh) ||
+        (jrect_ptr->jit_w <= 0) || (jrect_ptr->jit_h <= 0))
+    {
+        return JTRANS_ERR_AREA_EMPTY;
+    }
+
+    jtrans_imcu_size(jdec_ptr, &jit_mcuw, &jit_mcuh);
+
+    jit_xend = jrect_ptr->jit_x + jrect_ptr->jit_w;
+    jit_yend = jrect_ptr->jit_y + jrect_ptr->jit_h;
+    if (jit_xend > jit_imgw) jit_xend = jit_imgw;
+    if (jit_yend > jit_imgh) jit_yend = jit_imgh;
+
+    // 右侧/底部 向外扩展到 iMCU 边界（图像边缘不完整的 iMCU 整个擦除）
+    jit_xend = (j_int_t)jround_up((long)jit_xend, (long)jit_mcuw);
+    jit_yend = (j_int_t)jround_up((long)jit_yend, (long)jit_mcuh);
+
+    jrect_ptr->jit_x -= jrect_ptr->jit_x % jit_mcuw;
+    jrect_ptr->jit_y -= jrect_ptr->jit_y % jit_mcuh;
+    jrect_ptr->jit_w  = ((jit_xend < jit_imgw) ? jit_xend : jit_imgw) - jrect_ptr->jit_x;
+    jrect_ptr->jit_h  = ((jit_yend < jit_imgh) ? jit_yend : jit_imgh) - jrect_ptr->jit_y;
+
+    //======================================
+    // 区域内的 DCT 系数块：DC 系数置为 擦除颜色，AC 系数置 0
+
+    for (jit_iter = 0; jit_iter < jdec_ptr->num_components; ++jit_iter)
+    {
+        jcomp_ptr = &jdec_ptr->comp_info[jit_iter];
+        if (jdec_ptr->num_components > 1)
+        {
+            jit_hsmp = jcomp_ptr->h_samp_factor;
+            jit_vsmp = jcomp_ptr->v_samp_factor;
+        }
+
+        // 常量样本块 的 DC 系数 = 8 * (样本值 - CENTERJSAMPLE) / 量化步长
+        jcf_dc = (JCOEF)floor(
+                    8.0 * (jdt_smpl[jit_iter] - CENTERJSAMPLE) /
+                    (double)jcomp_ptr->quant_table->quantval[0] + 0.5);
+
+        jut_xmax = (j_uint_t)(jit_xend / jit_mcuw * jit_hsmp);
+        jut_ymax = (j_uint_t)(jit_yend / jit_mcuh * jit_vsmp);
+
+        for (jut_yblk = (j_uint_t)(jrect_ptr->jit_y / jit_mcuh * jit_vsmp);
+             jut_yblk < jut_ymax;
+             ++jut_yblk)
+        {
+            jblk_row = (*jdec_ptr->mem->access_virt_barray)(
+                            (j_common_ptr)jdec_ptr, jsrc_arr[jit_iter],
+                            jut_yblk, 1, J_TRUE);
+
+            for (jut_xblk = (j_uint_t)(jrect_ptr->jit_x / jit_mcuw * jit_hsmp);
+                 jut_xblk < jut_xmax;
+                 ++jut_xblk)
+            {
+                memset(jblk_row[0][jut_xblk], 0, sizeof(JBLOCK));
+                jblk_row[0][jut_xblk][0] = jcf_dc;
+            }
+        }
+    }
+
+    *jdst_arr = jsrc_arr;
+
+    //======================================
+
+    return JTRANS_ERR_OK;
+}
+
+/**********************************************************/
+/**
+ * @brief 转换为灰度图像的 变换回调函数：只保留 Y 分量的 DCT 系数 与 量化表。
+ * @note  直接使用源图像 Y 分量的 DCT 系数数组，不申请输出数组。
+ */
+static j_int_t jtrans_grayscale_xform(
+                    jtrans_this_t       jtrans_this,
+                    jvirt_barray_ptr  * jsrc_arr,
+                    jvirt_barray_ptr ** jdst_arr,
+                    j_void_t          * jvt_ctxt)
+{
+    jtdec_obj_t         * jdec_ptr  = &jtrans_this->jdec_obj;
+    jtenc_obj_t         * jenc_ptr  = &jtrans_this->jenc_obj;
+    jpeg_component_info * jcomp_ptr = &jdec_ptr->comp_info[0];
+    long                  jlt_rsti  = 0;
+
+    switch (jdec_ptr->jpeg_color_space)
+    {
+    case JCS_GRAYSCALE:
+        *jdst_arr = jsrc_arr;
+        return JTRANS_ERR_OK;
+
+    case JCS_YCbCr:
+    case JCS_BG_YCC:
+        break;
+
+    default:
+        return JTRANS_ERR_CS_UNSUPPORT;
+    }
+
+    //======================================
+    // 编码器 改为单分量：沿用 Y 分量的 标识 与 量化表，采样因子 固定为 1x1
+
+    jpeg_set_colorspace(jenc_ptr, JCS_GRAYSCALE);
+
+    jenc_ptr->comp_info[0].component_id  = jcomp_ptr->component_id;
+    jenc_ptr->comp_info[0].quant_tbl_no  = jcomp_ptr->quant_tbl_no;
+    jenc_ptr->comp_info[0].h_samp_factor = 1;
+    jenc_ptr->comp_info[0].v_samp_factor = 1;
+
+    // 源图像的 ICC 配置 与 Adobe 色彩变换标识 描述的是 彩色图像，输出中不再保留
+    jtrans_this->jut_mkrs |= JTRANS_MARKER_GRAY;
+
+    // 单分量图像的 MCU 为一个 DCT 块，重启间隔 按 Y 分量每个 MCU 的块数 换算
+    // （jenc_ptr->restart_interval 为 源图像 首个扫描 即 交错扫描 的重启间隔）
+    if (jenc_ptr->restart_interval > 0)
+    {
+        jlt_rsti = (long)jenc_ptr->restart_interval *
+                   jcomp_ptr->h_samp_factor * jcomp_ptr->v_samp_factor;
+        jenc_ptr->restart_interval = (unsigned int)((jlt_rsti < 65535L) ? jlt_rsti : 65535L);
+    }
+
+    // 扫描脚本 与 分量数量 相关，需按单分量 重新生成
+    if (jdec_ptr->progressive_mode)
+    {
+        jpeg_simple_progression(jenc_ptr);
+    }
+
+    //======================================
+
+    *jdst_arr = jsrc_arr;
+
+    return JTRANS_ERR_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// JPEG 无损变换 外部接口函数
+
+/**********************************************************/
+/**
+ * @brief 申请 JPEG 无损变换操作的上下文对象。
+ * 
+ * @param [in ] jvt_reserved : 保留参数（当前使用 J_NULL 即可）。
+ * 
+ * @return jtrans_this_t :
+ * 返回 JPEG 无损变换操作的上下文对象，为 J_NULL 时表示申请失败。
+ */
+jtrans_this_t jtrans_alloc(j_void_t * jvt_reserved)
+{
+    jtrans_this_t jtrans_this = (jtrans_this_t)calloc(1, sizeof(jtrans_ctx_t));
+    if (J_NULL == jtrans_this)
+    {
+        return J_NULL;
+    }
+
+    //======================================
+
+    jtrans_this->jut_size = sizeof(jtrans_ctx_t);
+    jtrans_this->jut_type = JTRANS_HANDLE_TYPE;
+
+    jtrans_this->jct_srcm = JCTL_MODE_UNKNOWN;
+    jtrans_this->jct_dest = JCTL_MODE_UNKNOWN;
+    jtrans_this->jimode.jct_mode = JCTL_MODE_UNKNOWN;
+    jtrans_this->jomode.jct_mode = JCTL_MODE_UNKNOWN;
+
+    jtrans_this->jdec_obj.err = jpeg_std_error(&jtrans_this->jerr_mgr.jerr_mgr);
+    jtrans_this->jenc_obj.err = &jtrans_this->jerr_mgr.jerr_mgr;
+    jtrans_this->jerr_mgr.jerr_mgr.error_exit = jerr_exit_callback;
+
+    jpeg_create_decompress(&jtrans_this->jdec_obj);
+    jpeg_create_compress(&jtrans_this->jenc_obj);
+
+    //======================================
+
+    return jtrans_this;
+}
+
+/**********************************************************/
+/**
+ * @brief 释放 JPEG 无损变换操作的上下文对象。
+ */
+j_void_t jtrans_release(jtrans_this_t jtrans_this)
+{
+    if (jtrans_valid(jtrans_this))
+    {
+        jpeg_destroy_compress(&jtrans_this->jenc_obj);
+        jpeg_destroy_decompress(&jtrans_this->jdec_obj);
+
+        jtrans_free_buff(jtrans_this);
+
+        if (J_NULL != jtrans_this->jipath.jsz_path)
+            free(jtrans_this->jipath.jsz_path);
+
+        if (J_NULL != jtrans_this->jopath.jsz_path)
+            free(jtrans_this->jopath.jsz_path);
+
+        if (J_NULL != jtrans_this->jslice.jst_segs)
+            free(jtrans_this->jslice.jst_segs);
+
+        free(jtrans_this);
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 判断 JPEG 无损变换操作的上下文对象 是否有效。
+ */
+j_bool_t jtrans_valid(jtrans_this_t jtrans_this)
+{
+    if (J_NULL == jtrans_this)
+    {
+        return J_FALSE;
+    }
+
+    if (sizeof(jtrans_ctx_t) != jtrans_this->jut_size)
+    {
+        return J_FALSE;
+    }
+
+    if (JTRANS_HANDLE_TYPE != jtrans_this->jut_type)
+    {
+        return J_FALSE;
+    }
+
+    return J_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 配置 无损变换 的输入源。
+ * @note  输入模式的含义，与 jdec_config() 的说明相同。
+ * 
+ * @param [in ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in ] jct_mode    : 输入模式（参看 jctl_mode_t ）。
+ * @param [in ] jfh_iptr    : 指向输入源的操作对象。
+ * @param [in ] jst_mlen    : 只针对于 内存模式，表示输入源缓存的有效字节数。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+j_int_t jtrans_config_input(
+                jtrans_this_t jtrans_this,
+                jctl_mode_t   jct_mode,
+                j_fhandle_t   jfh_iptr,
+                j_size_t      jst_mlen)
+{
+    JASSERT(jtrans_valid(jtrans_this));
+
+    j_int_t jit_err = JTRANS_ERR_EPARAM;
+
+    jtrans_this->jslice.jbl_scan = J_FALSE;
+
+    switch (jct_mode)
+    {
+    case JCTL_MODE_FMEMORY:
+        if ((J_NULL != jfh_iptr) && (jst_mlen > 0))
+        {
+            jtrans_this->jimode.jct_mode = JCTL_MODE_FMEMORY;
+            jtrans_this->jimode.jst_mlen = jst_mlen;
+            jtrans_this->jimode.jmt_iptr = (j_fmemory_t)jfh_iptr;
+
+            jit_err = JTRANS_ERR_OK;
+        }
+        break;
+
+    case JCTL_MODE_FSTREAM:
+        if (J_NULL != jfh_iptr)
+        {
+            jtrans_this->jimode.jct_mode = JCTL_MODE_FSTREAM;
+            jtrans_this->jimode.jbl_spos = J_FALSE;
+            jtrans_this->jimode.jfs_istr = (j_fstream_t)jfh_iptr;
+
+            jit_err = JTRANS_ERR_OK;
+        }
+        break;
+
+    case JCTL_MODE_FSZPATH:
+        if ((J_NULL != jfh_iptr) && ('\0' != ((j_fszpath_t)jfh_iptr)[0]))
+        {
+            jit_err = jtrans_update_path(&jtrans_this->jipath, (j_fszpath_t)jfh_iptr);
+            if (JTRANS_ERR_OK == jit_err)
+            {
+                jtrans_this->jimode.jct_mode = JCTL_MODE_FSZPATH;
+                jtrans_this->jimode.jfs_file = J_NULL;
+                jtrans_this->jimode.jsz_path = jtrans_this->jipath.jsz_path;
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    if (JTRANS_ERR_OK != jit_err)
+    {
+        jtrans_this->jimode.jct_mode = JCTL_MODE_UNKNOWN;
+        jtrans_this->jimode.jst_mlen = 0;
+        jtrans_this->jimode.jmt_iptr = J_NULL;
+    }
+
+    return jit_err;
+}
+
+/**********************************************************/
+/**
+ * @brief 配置 无损变换 的输出目标。
+ * @note
+ * 输出模式的含义，与 jenc_config() 的说明相同，
+ * 内存模式下，使用 jtrans_fmdata() 和 jtrans_fmsize() 获得输出的数据。
+ * 
+ * @param [in ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in ] jct_mode    : 输出模式（参看 jctl_mode_t ）。
+ * @param [in ] jht_optr    : 指向目标输出的操作对象。
+ * @param [in ] jst_mlen    : 只针对于 内存模式，表示目标输出缓存的容量。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+j_int_t jtrans_config_output(
+                jtrans_this_t jtrans_this,
+                jctl_mode_t   jct_mode,
+                j_fhandle_t   jht_optr,
+                j_size_t      jst_mlen)
+{
+    JASSERT(jtrans_valid(jtrans_this));
+
+    j_int_t jit_err = JTRANS_ERR_EPARAM;
+
+    // 先释放上一次（内存模式）输出的数据
+    jtrans_free_buff(jtrans_this);
+
+    switch (jct_mode)
+    {
+    case JCTL_MODE_FMEMORY:
+        {
+            jtrans_this->jomode.jct_mode = JCTL_MODE_FMEMORY;
+            if ((J_NULL == jht_optr) || (0 == jst_mlen))
+            {
+                jtrans_this->jomode.jst_mlen = 0;
+                jtrans_this->jomode.jmt_optr = J_NULL;
+            }
+            else
+            {
+                jtrans_this->jomode.jst_mlen = jst_mlen;
+                jtrans_this->jomode.jmt_optr = (j_fmemory_t)jht_optr;
+            }
+
+            jit_err = JTRANS_ERR_OK;
+        }
+        break;
+
+    case JCTL_MODE_FSTREAM:
+        if (J_NULL != jht_optr)
+        {
+            jtrans_this->jomode.jct_mode = JCTL_MODE_FSTREAM;
+            jtrans_this->jomode.jfs_ostr = (j_fstream_t)jht_optr;
+
+            jit_err = JTRANS_ERR_OK;
+        }
+        break;
+
+    case JCTL_MODE_FSZPATH:
+        if ((J_NULL != jht_optr) && ('\0' != ((j_fszpath_t)jht_optr)[0]))
+        {
+            jit_err = jtrans_update_path(&jtrans_this->jopath, (j_fszpath_t)jht_optr);
+            if (JTRANS_ERR_OK == jit_err)
+            {
+                jtrans_this->jomode.jct_mode = JCTL_MODE_FSZPATH;
+                jtrans_this->jomode.jfs_file = J_NULL;
+                jtrans_this->jomode.jsz_path = jtrans_this->jopath.jsz_path;
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    if (JTRANS_ERR_OK != jit_err)
+    {
+        jtrans_this->jomode.jct_mode = JCTL_MODE_UNKNOWN;
+        jtrans_this->jomode.jst_mlen = 0;
+        jtrans_this->jomode.jmt_optr = J_NULL;
+    }
+
+    return jit_err;
+}
+
+/**********************************************************/
+/**
+ * @brief 在内存模式下，执行变换操作后，所输出的 JPEG 数据流地址。
+ */
+j_mptr_t jtrans_fmdata(jtrans_this_t jtrans_this)
+{
+    return jtrans_this->jbuff.jmt_mptr;
+}
+
+/**********************************************************/
+/**
+ * @brief 在内存模式下，执行变换操作后，所输出的 JPEG 数据流有效字节数。
+ */
+j_size_t jtrans_fmsize(jtrans_this_t jtrans_this)
+{
+    return jtrans_this->jbuff.jst_size;
+}
+
+/**********************************************************/
+/**
+ * @brief 在 DCT 系数域内，无损剪切图像的指定区域。
+ * @note
+ * 1. 区域的左上角 向下对齐到 iMCU 边界（通常为 8 或 16 像素），
+ *    宽度、高度 相应扩大，以保证仍然包含整个请求区域；
+ * 2. 只复制区域内的 DCT 系数块，再重新进行熵编码，不经过 IDCT/FDCT，
+ *    图像质量无损失，且保留源图像的 量化表、渐进模式、算术编码、重启间隔
+ *    以及 APPn/COM 标记；
+ * 3. 快速路径：输入源为 内存模式 的 顺序模式（单次扫描）数据流 且带有 重启间隔 时，
+ *    若区域为 全宽度 的水平条带，并且 上下边界 都落在 重启段（RST 标记之间的 MCU）边界上
+ *    （例如 每个 MCU 行 设置一个 RST 标记），则直接按字节复制 重启段，
+ *    只修正 SOF 中的图像高度 与 RST 标记的编号，不做 熵解码/熵编码，速度接近 memcpy()；
+ *    同一输入源 多次剪切（如 切分条带）时，重启段的索引 只在第一次解析，
+ *    所以 输入缓存的内容改变后，需要重新调用 jtrans_config_input() 。
+ * 
+ * @param [in    ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in,out] jrect_ptr   : 入参为请求的剪切区域，回参为实际的剪切区域。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+j_int_t jtrans_crop(jtrans_this_t jtrans_this, j_rect_t * jrect_ptr)
+{
+    j_int_t jit_err = JTRANS_ERR_UNKNOWN;
+
+    JASSERT(jtrans_valid(jtrans_this));
+
+    if (J_NULL == jrect_ptr)
+    {
+        return JTRANS_ERR_EPARAM;
+    }
+
+    jit_err = jtrans_slice_crop(jtrans_this, jrect_ptr);
+    if (JTRANS_SLICE_SKIP != jit_err)
+    {
+        return jit_err;
+    }
+
+    return jtrans_execute(jtrans_this, jtrans_crop_xform, jrect_ptr);
+}
+
+/**********************************************************/
+/**
+ * @brief 在 DCT 系数域内，无损 旋转/翻转/转置 图像。
+ * @note
+ * 1. 通过 重排 DCT 系数块、转置块内系数 以及 对奇数频率系数取反 完成变换，
+ *    转置类操作同时转置 量化表 和 采样因子，不经过 IDCT/FDCT，图像质量无损失；
+ * 2. 图像 右侧/底部 不完整的 iMCU 无法镜像到另一侧，由 jbl_trim 决定处理策略：
+ *    - J_TRUE  : 裁掉这些不完整的 iMCU（输出图像尺寸 向下对齐到 iMCU 边界，
+ *                若图像尺寸不足一个 iMCU，则不裁剪）；
+ *    - J_FALSE : 保留这些 iMCU，其只做转置、不做镜像（输出图像尺寸不变，
+ *                但边缘的这一条带 方向与图像主体不一致）；
+ * 3. jrotate 不为 JTRANS_ROTATE_NONE 时，输出图像 EXIF(APP1) 的 Orientation 标签 改写为 1，
+ *    以免查看器 按源图像的方向 再次旋转（通常配合 jtrans_exif_rotate() 使用）。
+ * 
+ * @param [in ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in ] jrotate     : 旋转/翻转 操作的类型（参看 jtrans_rotate_t ）。
+ * @param [in ] jbl_trim    : 是否裁掉 边缘不完整的 iMCU。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+j_int_t jtrans_rotate(
+                jtrans_this_t   jtrans_this,
+                jtrans_rotate_t jrotate,
+                j_bool_t        jbl_trim)
+{
+    jtrans_rotate_ctx_t jrot_ctx;
+
+    JASSERT(jtrans_valid(jtrans_this));
+
+    jrot_ctx.jbl_tran = J_FALSE;
+    jrot_ctx.jbl_mirx = J_FALSE;
+    jrot_ctx.jbl_miry = J_FALSE;
+    jrot_ctx.jbl_trim = jbl_trim;
+
+    switch (jrotate)
+    {
+    case JTRANS_ROTATE_NONE      : break;
+    case JTRANS_ROTATE_FLIP_H    : jrot_ctx.jbl_mirx = J_TRUE; break;
+    case JTRANS_ROTATE_FLIP_V    : jrot_ctx.jbl_miry = J_TRUE; break;
+    case JTRANS_ROTATE_TRANSPOSE : jrot_ctx.jbl_tran = J_TRUE; break;
+    case JTRANS_ROTATE_TRANSVERSE:
+        jrot_ctx.jbl_tran = J_TRUE;
+        jrot_ctx.jbl_mirx = J_TRUE;
+        jrot_ctx.jbl_miry = J_TRUE;
+        break;
+    case JTRANS_ROTATE_ROT_90    :
+        jrot_ctx.jbl_tran = J_TRUE;
+        jrot_ctx.jbl_mirx = J_TRUE;
+        break;
+    case JTRANS_ROTATE_ROT_180   :
+        jrot_ctx.jbl_mirx = J_TRUE;
+        jrot_ctx.jbl_miry = J_TRUE;
+        break;
+    case JTRANS_ROTATE_ROT_270   :
+        jrot_ctx.jbl_tran = J_TRUE;
+        jrot_ctx.jbl_miry = J_TRUE;
+        break;
+
+    default:
+        return JTRANS_ERR_EPARAM;
+    }
+
+    return jtrans_execute(jtrans_this, jtrans_rotate_xform, &jrot_ctx);
+}
+
+/**********************************************************/
+/**
+ * @brief 无损重新编码：DCT 系数 与 量化表 保持不变，只改变 熵编码 的方式。
+ * @note
+ * 1. 可以 开启哈夫曼表优化、在 基线顺序 与 渐进 模式间转换、改用 算术编码、
+ *    添加/去除 重启间隔，全程不经过 IDCT/FDCT，图像像素 完全不变；
+ * 2. 渐进模式 使用哈夫曼编码时，libjpeg 总是优化哈夫曼表；
+ * 3. 内存模式下，可通过 jtrans_fmsize() 对比输入数据的大小，得到压缩的收益。
+ * 
+ * @param [in ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in ] jrecode_ptr : 重新编码的参数。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+j_int_t jtrans_recode(
+                jtrans_this_t           jtrans_this,
+                const jtrans_recode_t * jrecode_ptr)
+{
+    JASSERT(jtrans_valid(jtrans_this));
+
+    if (J_NULL == jrecode_ptr)
+    {
+        return JTRANS_ERR_EPARAM;
+    }
+
+    return jtrans_execute(jtrans_this, jtrans_recode_xform, (j_void_t *)jrecode_ptr);
+}
+
+/**********************************************************/
+/**
+ * @brief 在 DCT 系数域内，使用指定颜色 擦除（涂抹）图像的指定区域。
+ * @note
+ * 1. 区域 向外扩展到 iMCU 边界（通常为 8 或 16 像素），以保证完全覆盖请求区域；
+ * 2. 区域内的每个 DCT 系数块，DC 系数设置为 擦除颜色 对应的值，AC 系数全部置 0，
+ *    区域外的系数块 保持不变，并沿用源图像的 量化表 等编码参数，
+ *    所以 区域外的图像质量无损失，整个操作只需一次 熵解码 和 熵编码；
+ * 3. 擦除颜色 经过 DC 量化，与指定颜色 会有少许偏差（不超过 量化步长 / 8）；
+ * 4. 支持 GRAY、YCC、BG_YCC、RGB、BG_RGB 色彩空间的图像，
+ *    CMYK/YCCK 图像返回 JTRANS_ERR_CS_UNSUPPORT 。
+ * 
+ * @param [in    ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in,out] jrect_ptr   : 入参为请求的擦除区域，回参为实际的擦除区域。
+ * @param [in    ] jut_color   : 擦除颜色（0x00RRGGBB 格式）。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+j_int_t jtrans_erase(
+                jtrans_this_t   jtrans_this,
+                j_rect_t      * jrect_ptr,
+                j_uint_t        jut_color)
+{
+    jtrans_erase_ctx_t jera_ctx;
+
+    JASSERT(jtrans_valid(jtrans_this));
+
+    if (J_NULL == jrect_ptr)
+    {
+        return JTRANS_ERR_EPARAM;
+    }
+
+    jera_ctx.jrect_ptr = jrect_ptr;
+    jera_ctx.jut_color = jut_color;
+
+    return jtrans_execute(jtrans_this, jtrans_erase_xform, &jera_ctx);
+}
+
+/**********************************************************/
+/**
+ * @brief 在 DCT 系数域内 重新量化，快速降低图像质量（有损，但不经过像素域）。
+ * @note
+ * 1. 目标量化表 由目标质量 按 libjpeg 标准量化表 缩放得到（与 jpeg_set_quality() 相同），
+ *    且逐项不小于 源量化表（比源量化表更细的步长 不会带来任何画质提升）；
+ * 2. 每个 DCT 系数 按 源步长 / 目标步长 缩放，并舍入到最近的整数（中点向 0 舍入），
+ *    再连同新的 DQT 重新熵编码，全程不经过 IDCT/FDCT、上采样 以及 色彩转换；
+ * 3. 保留源图像的 渐进模式、算术编码、重启间隔 以及 APPn/COM 标记。
+ * 
+ * @param [in ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in ] jit_quality : 目标质量（1 ~ 100）。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+j_int_t jtrans_requant(jtrans_this_t jtrans_this, j_int_t jit_quality)
+{
+    JASSERT(jtrans_valid(jtrans_this));
+
+    if ((jit_quality < 1) || (jit_quality > 100))
+    {
+        return JTRANS_ERR_EPARAM;
+    }
+
+    return jtrans_execute(jtrans_this, jtrans_requant_xform, &jit_quality);
+}
+
+/**********************************************************/
+/**
+ * @brief 在 DCT 系数域内，丢弃色度分量，将彩色图像 无损转换为 灰度图像。
+ * @note
+ * 1. 只保留 Y 分量的 DCT 系数 与 量化表，SOF/SOS 改写为 单分量，再重新熵编码，
+ *    不经过 IDCT/FDCT 以及 色彩转换，灰度图像 与 解码后的 Y 分量 完全相同；
+ * 2. 保留源图像的 渐进模式、算术编码、APPn/COM 标记（ICC(APP2)/Adobe(APP14) 除外，
+ *    其描述的是 彩色图像），重启间隔 按 Y 分量每个 MCU 的块数 换算为 单分量图像的 MCU 数量；
+ * 3. 支持 YCC、BG_YCC 色彩空间的图像（灰度图像 则原样重新编码），
+ *    其他色彩空间的图像 返回 JTRANS_ERR_CS_UNSUPPORT 。
+ * 
+ * @param [in ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+j_int_t jtrans_grayscale(jtrans_this_t jtrans_this)
+{
+    JASSERT(jtrans_valid(jtrans_this));
+
+    return jtrans_execute(jtrans_this, jtrans_grayscale_xform, J_NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,483 @@
+﻿/**
+ * @file jtransform.h
+ * Copyright (c) 2024 Gaaagaa. All rights reserved.
+ * 
+ * @author  : Gaaagaa
+ * @date    : 2024-10-26
+ * @version : 1.0.0.0
+ * @brief   : 声明 JPEG 无损变换（在 DCT 系数域内操作，不经过像素）的相关操作接口及数据类型。
+ */
+
+#ifndef __JTRANSFORM_H__
+#define __JTRANSFORM_H__
+
+#include "jcomm.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+////////////////////////////////////////////////////////////////////////////////
+
+/** 声明 JPEG 无损变换操作的上下文 结构体 */
+struct jtrans_ctx_t;
+
+/** 定义 JPEG 无损变换操作的上下文 结构体指针 */
+typedef struct jtrans_ctx_t * jtrans_this_t;
+
+/**
+ * @enum  jtrans_errno_t
+ * @brief JPEG 无损变换操作的相关错误码表。
+ */
+typedef enum __jtrans_errno__
+{
+    JTRANS_ERR_OK      =    0,   ///< 无错
+    JTRANS_ERR_UNKNOWN = -128,   ///< 未知错误
+
+    JTRANS_ERR_FGETPOS       ,   ///< 调用 fgetpos() 操作失败
+    JTRANS_ERR_FOPEN         ,   ///< 调用 fopen() 操作失败
+    JTRANS_ERR_READ_HEADER   ,   ///< 读取 JPEG （文件头）信息失败
+    JTRANS_ERR_UNCONFIG      ,   ///< 未配置 JPEG 输入源 或 输出目标
+    JTRANS_ERR_AREA_EMPTY    ,   ///< 操作区域为空（或者超出图像范围）
+    JTRANS_ERR_CS_UNSUPPORT  ,   ///< 不支持的 JPEG 色彩空间
+
+    JTRANS_ERR_MALLOC        ,   ///< 申请缓存失败
+    JTRANS_ERR_EPARAM        ,   ///< 输入参数有误
+    JTRANS_ERR_EXCEPTION     ,   ///< 变换操作过程产生异常错误
+} jtrans_errno_t;
+
+/**********************************************************/
+/**
+ * @brief JPEG 无损变换操作的相关错误码的 名称。
+ */
+static inline j_cstring_t jtrans_errno_name(j_int_t jit_err)
+{
+    j_cstring_t jsz_name = "";
+
+    switch (jit_err)
+    {
+    case JTRANS_ERR_OK          : jsz_name = "JTRANS_ERR_OK"         ; break;
+    case JTRANS_ERR_UNKNOWN     : jsz_name = "JTRANS_ERR_UNKNOWN"    ; break;
+    case JTRANS_ERR_FGETPOS     : jsz_name = "JTRANS_ERR_FGETPOS"    ; break;
+    case JTRANS_ERR_FOPEN       : jsz_name = "JTRANS_ERR_FOPEN"      ; break;
+    case JTRANS_ERR_READ_HEADER : jsz_name = "JTRANS_ERR_READ_HEADER"; break;
+    case JTRANS_ERR_UNCONFIG    : jsz_name = "JTRANS_ERR_UNCONFIG"   ; break;
+    case JTRANS_ERR_AREA_EMPTY  : jsz_name = "JTRANS_ERR_AREA_EMPTY" ; break;
+    case JTRANS_ERR_CS_UNSUPPORT: jsz_name = "JTRANS_ERR_CS_UNSUPPORT"; break;
+    case JTRANS_ERR_MALLOC      : jsz_name = "JTRANS_ERR_MALLOC"     ; break;
+    case JTRANS_ERR_EPARAM      : jsz_name = "JTRANS_ERR_EPARAM"     ; break;
+    case JTRANS_ERR_EXCEPTION   : jsz_name = "JTRANS_ERR_EXCEPTION"  ; break;
+    default: break;
+    }
+
+    return jsz_name;
+}
+
+/**
+ * @enum  jtrans_rotate_t
+ * @brief 无损 旋转/翻转 操作的类型。
+ */
+typedef enum __jtrans_rotate__
+{
+    JTRANS_ROTATE_NONE       = 0,  ///< 不变换
+    JTRANS_ROTATE_FLIP_H     = 1,  ///< 水平翻转（左右镜像）
+    JTRANS_ROTATE_FLIP_V     = 2,  ///< 垂直翻转（上下镜像）
+    JTRANS_ROTATE_TRANSPOSE  = 3,  ///< 沿 左上-右下 对角线转置
+    JTRANS_ROTATE_TRANSVERSE = 4,  ///< 沿 右上-左下 对角线转置
+    JTRANS_ROTATE_ROT_90     = 5,  ///< 顺时针旋转 90 度
+    JTRANS_ROTATE_ROT_180    = 6,  ///< 旋转 180 度
+    JTRANS_ROTATE_ROT_270    = 7,  ///< 顺时针旋转 270 度
+} jtrans_rotate_t;
+
+/** 重新编码操作的参数中，表示 保持源图像设置 的参数值 */
+#define JTRANS_RECODE_KEEP  (-1)
+
+/**
+ * @struct jtrans_recode_t
+ * @brief  无损重新编码（只改变熵编码方式）的参数。
+ */
+typedef struct jtrans_recode_t
+{
+    j_int_t  jit_prog;  ///< 扫描模式：0，基线顺序；1，渐进；JTRANS_RECODE_KEEP，保持源图像的模式
+    j_int_t  jit_arith; ///< 熵编码：0，哈夫曼；1，算术；JTRANS_RECODE_KEEP，保持源图像的编码
+    j_int_t  jit_rrows; ///< 重启间隔（以 MCU 行为单位）：0，去除；> 0，设置；JTRANS_RECODE_KEEP，保持
+    j_bool_t jbl_optim; ///< 是否优化哈夫曼表（使用算术编码时忽略）
+} jtrans_recode_t;
+
+/**********************************************************/
+/**
+ * @brief 将 EXIF 的 Orientation 标签值（1 ~ 8），
+ *        映射为 将图像摆正 所需执行的 无损旋转/翻转 操作类型。
+ */
+static inline jtrans_rotate_t jtrans_exif_rotate(j_int_t jit_orient)
+{
+    switch (jit_orient)
+    {
+    case 2 : return JTRANS_ROTATE_FLIP_H;
+    case 3 : return JTRANS_ROTATE_ROT_180;
+    case 4 : return JTRANS_ROTATE_FLIP_V;
+    case 5 : return JTRANS_ROTATE_TRANSPOSE;
+    case 6 : return JTRANS_ROTATE_ROT_90;
+    case 7 : return JTRANS_ROTATE_TRANSVERSE;
+    case 8 : return JTRANS_ROTATE_ROT_270;
+    default: break;
+    }
+
+    return JTRANS_ROTATE_NONE;
+}
+
+/**********************************************************/
+/**
+ * @brief 申请 JPEG 无损变换操作的上下文对象。
+ * 
+ * @param [in ] jvt_reserved : 保留参数（当前使用 J_NULL 即可）。
+ * 
+ * @return jtrans_this_t :
+ * 返回 JPEG 无损变换操作的上下文对象，为 J_NULL 时表示申请失败。
+ */
+jtrans_this_t jtrans_alloc(j_void_t * jvt_reserved);
+
+/**********************************************************/
+/**
+ * @brief 释放 JPEG 无损变换操作的上下文对象。
+ */
+j_void_t jtrans_release(jtrans_this_t jtrans_this);
+
+/**********************************************************/
+/**
+ * @brief 判断 JPEG 无损变换操作的上下文对象 是否有效。
+ */
+j_bool_t jtrans_valid(jtrans_this_t jtrans_this);
+
+/**********************************************************/
+/**
+ * @brief 配置 无损变换 的输入源。
+ * @note  输入模式的含义，与 jdec_config() 的说明相同。
+ * 
+ * @param [in ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in ] jct_mode    : 输入模式（参看 jctl_mode_t ）。
+ * @param [in ] jfh_iptr    : 指向输入源的操作对象。
+ * @param [in ] jst_mlen    : 只针对于 内存模式，表示输入源缓存的有效字节数。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+j_int_t jtrans_config_input(
+                jtrans_this_t jtrans_this,
+                jctl_mode_t   jct_mode,
+                j_fhandle_t   jfh_iptr,
+                j_size_t      jst_mlen);
+
+/**********************************************************/
+/**
+ * @brief 配置 无损变换 的输出目标。
+ * @note
+ * 输出模式的含义，与 jenc_config() 的说明相同，
+ * 内存模式下，使用 jtrans_fmdata() 和 jtrans_fmsize() 获得输出的数据。
+ * 
+ * @param [in ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in ] jct_mode    : 输出模式（参看 jctl_mode_t ）。
+ * @param [in ] jht_optr    : 指向目标输出的操作对象。
+ * @param [in ] jst_mlen    : 只针对于 内存模式，表示目标输出缓存的容量。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+j_int_t jtrans_config_output(
+                jtrans_this_t jtrans_this,
+                jctl_mode_t   jct_mode,
+                j_fhandle_t   jht_optr,
+                j_size_t      jst_mlen);
+
+/**********************************************************/
+/**
+ * @brief 在内存模式下，执行变换操作后，所输出的 JPEG 数据流地址。
+ */
+j_mptr_t jtrans_fmdata(jtrans_this_t jtrans_this);
+
+/**********************************************************/
+/**
+ * @brief 在内存模式下，执行变换操作后，所输出的 JPEG 数据流有效字节数。
+ */
+j_size_t jtrans_fmsize(jtrans_this_t jtrans_this);
+
+/**********************************************************/
+/**
+ * @brief 在 DCT 系数域内，无损剪切图像的指定区域。
+ * @note
+ * 1. 区域的左上角 向下对齐到 iMCU 边界（通常为 8 或 16 像素），
+ *    宽度、高度 相应扩大，以保证仍然包含整个请求区域；
+ * 2. 只复制区域内的 DCT 系数块，再重新进行熵编码，不经过 IDCT/FDCT，
+ *    图像质量无损失，且保留源图像的 量化表、渐进模式、算术编码、重启间隔
+ *    以及 APPn/COM 标记；
+ * 3. 快速路径：输入源为 内存模式 的 顺序模式（单次扫描）数据流 且带有 重启间隔 时，
+ *    若区域为 全宽度 的水平条带，并且 上下边界 都落在 重启段（RST 标记之间的 MCU）边界上
+ *    （例如 每个 MCU 行 设置一个 RST 标记），则直接按字节复制 重启段，
+ *    只修正 SOF 中的图像高度 与 RST 标记的编号，不做 熵解码/熵编码，速度接近 memcpy()；
+ *    同一输入源 多次剪切（如 切分条带）时，重启段的索引 只在第一次解析，
+ *    所以 输入缓存的内容改变后，需要重新调用 jtrans_config_input() 。
+ * 
+ * @param [in    ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in,out] jrect_ptr   : 入参为请求的剪切区域，回参为实际的剪切区域。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+j_int_t jtrans_crop(jtrans_this_t jtrans_this, j_rect_t * jrect_ptr);
+
+/**********************************************************/
+/**
+ * @brief 在 DCT 系数域内，无损 旋转/翻转/转置 图像。
+ * @note
+ * 1. 通过 重排 DCT 系数块、转置块内系数 以及 对奇数频率系数取反 完成变换，
+ *    转置类操作同时转置 量化表 和 采样因子，不经过 IDCT/FDCT，图像质量无损失；
+ * 2. 图像 右侧/底部 不完整的 iMCU 无法镜像到另一侧，由 jbl_trim 决定处理策略：
+ *    - J_TRUE  : 裁掉这些不完整的 iMCU（输出图像尺寸 向下对齐到 iMCU 边界，
+ *                若图像尺寸不足一个 iMCU，则不裁剪）；
+ *    - J_FALSE : 保留这些 iMCU，其只做转置、不做镜像（输出图像尺寸不变，
+ *                但边缘的这一条带 方向与图像主体不一致）；
+ * 3. jrotate 不为 JTRANS_ROTATE_NONE 时，输出图像 EXIF(APP1) 的 Orientation 标签 改写为 1，
+ *    以免查看器 按源图像的方向 再次旋转（通常配合 jtrans_exif_rotate() 使用）。
+ * 
+ * @param [in ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in ] jrotate     : 旋转/翻转 操作的类型（参看 jtrans_rotate_t ）。
+ * @param [in ] jbl_trim    : 是否裁掉 边缘不完整的 iMCU。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+j_int_t jtrans_rotate(
+                jtrans_this_t   jtrans_this,
+                jtrans_rotate_t jrotate,
+                j_bool_t        jbl_trim);
+
+/**********************************************************/
+/**
+ * @brief 无损重新编码：DCT 系数 与 量化表 保持不变，只改变 熵编码 的方式。
+ * @note
+ * 1. 可以 开启哈夫曼表优化、在 基线顺序 与 渐进 模式间转换、改用 算术编码、
+ *    添加/去除 重启间隔，全程不经过 IDCT/FDCT，图像像素 完全不变；
+ * 2. 渐进模式 使用哈夫曼编码时，libjpeg 总是优化哈夫曼表；
+ * 3. 内存模式下，可通过 jtrans_fmsize() 对比输入数据的大小，得到压缩的收益。
+ * 
+ * @param [in ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in ] jrecode_ptr : 重新编码的参数。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+j_int_t jtrans_recode(
+                jtrans_this_t           jtrans_this,
+                const jtrans_recode_t * jrecode_ptr);
+
+/**********************************************************/
+/**
+ * @brief 在 DCT 系数域内，使用指定颜色 擦除（涂抹）图像的指定区域。
+ * @note
+ * 1. 区域 向外扩展到 iMCU 边界（通常为 8 或 16 像素），以保证完全覆盖请求区域；
+ * 2. 区域内的每个 DCT 系数块，DC 系数设置为 擦除颜色 对应的值，AC 系数全部置 0，
+ *    区域外的系数块 保持不变，并沿用源图像的 量化表 等编码参数，
+ *    所以 区域外的图像质量无损失，整个操作只需一次 熵解码 和 熵编码；
+ * 3. 擦除颜色 经过 DC 量化，与指定颜色 会有少许偏差（不超过 量化步长 / 8）；
+ * 4. 支持 GRAY、YCC、BG_YCC、RGB、BG_RGB 色彩空间的图像，
+ *    CMYK/YCCK 图像返回 JTRANS_ERR_CS_UNSUPPORT 。
+ * 
+ * @param [in    ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in,out] jrect_ptr   : 入参为请求的擦除区域，回参为实际的擦除区域。
+ * @param [in    ] jut_color   : 擦除颜色（0x00RRGGBB 格式）。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+j_int_t jtrans_erase(
+                jtrans_this_t   jtrans_this,
+                j_rect_t      * jrect_ptr,
+                j_uint_t        jut_color);
+
+/**********************************************************/
+/**
+ * @brief 在 DCT 系数域内 重新量化，快速降低图像质量（有损，但不经过像素域）。
+ * @note
+ * 1. 目标量化表 由目标质量 按 libjpeg 标准量化表 缩放得到（与 jpeg_set_quality() 相同），
+ *    且逐项不小于 源量化表（比源量化表更细的步长 不会带来任何画质提升）；
+ * 2. 每个 DCT 系数 按 源步长 / 目标步长 缩放，并舍入到最近的整数（中点向 0 舍入），
+ *    再连同新的 DQT 重新熵编码，全程不经过 IDCT/FDCT、上采样 以及 色彩转换；
+ * 3. 保留源图像的 渐进模式、算术编码、重启间隔 以及 APPn/COM 标记。
+ * 
+ * @param [in ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * @param [in ] jit_quality : 目标质量（1 ~ 100）。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+j_int_t jtrans_requant(jtrans_this_t jtrans_this, j_int_t jit_quality);
+
+/**********************************************************/
+/**
+ * @brief 在 DCT 系数域内，丢弃色度分量，将彩色图像 无损转换为 灰度图像。
+ * @note
+ * 1. 只保留 Y 分量的 DCT 系数 与 量化表，SOF/SOS 改写为 单分量，再重新熵编码，
+ *    不经过 IDCT/FDCT 以及 色彩转换，灰度图像 与 解码后的 Y 分量 完全相同；
+ * 2. 保留源图像的 渐进模式、算术编码、APPn/COM 标记（ICC(APP2)/Adobe(APP14) 除外，
+ *    其描述的是 彩色图像），重启间隔 按 Y 分量每个 MCU 的块数 换算为 单分量图像的 MCU 数量；
+ * 3. 支持 YCC、BG_YCC 色彩空间的图像（灰度图像 则原样重新编码），
+ *    其他色彩空间的图像 返回 JTRANS_ERR_CS_UNSUPPORT 。
+ * 
+ * @param [in ] jtrans_this : JPEG 无损变换操作的上下文对象。
+ * 
+ * @return j_int_t : 错误码，请参看 jtrans_errno_t 相关枚举值。
+ */
+j_int_t jtrans_grayscale(jtrans_this_t jtrans_this);
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+}; // extern "C"
+#endif // __cplusplus
+
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef __cplusplus
+
+/**
+ * @class jtransform_t
+ * @brief 封装 JPEG 无损变换相关操作接口 成 C++ 类。
+ */
+class jtransform_t
+{
+    // constructor/destructor
+public:
+    jtransform_t(j_void_t * jvt_reserved = J_NULL)
+    {
+        m_jtrans_this = jtrans_alloc(jvt_reserved);
+    }
+
+    ~jtransform_t(void)
+    {
+        jtrans_release(m_jtrans_this);
+        m_jtrans_this = J_NULL;
+    }
+
+    // public interfaces
+public:
+    /**********************************************************/
+    /**
+     * @brief 判断 当前对象 是否有效。
+     * @note  详情请参看 jtrans_valid() 的说明。
+     */
+    inline j_bool_t valid(void)
+    {
+        return jtrans_valid(m_jtrans_this);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 配置 无损变换 的输入源。
+     * @note  详情请参看 jtrans_config_input() 的说明。
+     */
+    inline j_int_t config_input(
+                jctl_mode_t jct_mode,
+                j_fhandle_t jfh_iptr,
+                j_size_t    jst_mlen)
+    {
+        return jtrans_config_input(m_jtrans_this, jct_mode, jfh_iptr, jst_mlen);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 配置 无损变换 的输出目标。
+     * @note  详情请参看 jtrans_config_output() 的说明。
+     */
+    inline j_int_t config_output(
+                jctl_mode_t jct_mode,
+                j_fhandle_t jht_optr,
+                j_size_t    jst_mlen)
+    {
+        return jtrans_config_output(m_jtrans_this, jct_mode, jht_optr, jst_mlen);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在内存模式下，执行变换操作后，所输出的 JPEG 数据流地址。
+     * @note  详情请参看 jtrans_fmdata() 的说明。
+     */
+    inline j_mptr_t fmdata(void)
+    {
+        return jtrans_fmdata(m_jtrans_this);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在内存模式下，执行变换操作后，所输出的 JPEG 数据流有效字节数。
+     * @note  详情请参看 jtrans_fmsize() 的说明。
+     */
+    inline j_size_t fmsize(void)
+    {
+        return jtrans_fmsize(m_jtrans_this);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在 DCT 系数域内，无损剪切图像的指定区域。
+     * @note  详情请参看 jtrans_crop() 的说明。
+     */
+    inline j_int_t crop(j_rect_t * jrect_ptr)
+    {
+        return jtrans_crop(m_jtrans_this, jrect_ptr);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在 DCT 系数域内，无损 旋转/翻转/转置 图像。
+     * @note  详情请参看 jtrans_rotate() 的说明。
+     */
+    inline j_int_t rotate(jtrans_rotate_t jrotate, j_bool_t jbl_trim = J_FALSE)
+    {
+        return jtrans_rotate(m_jtrans_this, jrotate, jbl_trim);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 无损重新编码：DCT 系数 与 量化表 保持不变，只改变 熵编码 的方式。
+     * @note  详情请参看 jtrans_recode() 的说明。
+     */
+    inline j_int_t recode(const jtrans_recode_t * jrecode_ptr)
+    {
+        return jtrans_recode(m_jtrans_this, jrecode_ptr);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在 DCT 系数域内，使用指定颜色 擦除（涂抹）图像的指定区域。
+     * @note  详情请参看 jtrans_erase() 的说明。
+     */
+    inline j_int_t erase(j_rect_t * jrect_ptr, j_uint_t jut_color)
+    {
+        return jtrans_erase(m_jtrans_this, jrect_ptr, jut_color);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在 DCT 系数域内 重新量化，快速降低图像质量。
+     * @note  详情请参看 jtrans_requant() 的说明。
+     */
+    inline j_int_t requant(j_int_t jit_quality)
+    {
+        return jtrans_requant(m_jtrans_this, jit_quality);
+    }
+
+    /**********************************************************/
+    /**
+     * @brief 在 DCT 系数域内，丢弃色度分量，将彩色图像 无损转换为 灰度图像。
+     * @note  详情请参看 jtrans_grayscale() 的说明。
+     */
+    inline j_int_t grayscale(void)
+    {
+        return jtrans_grayscale(m_jtrans_this);
+    }
+
+    // data members
+private:
+    jtrans_this_t m_jtrans_this; ///< JPEG 无损变换操作的上下文对象
+};
+
+#endif // __cplusplus
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // __JTRANSFORM_H__
@@ -0,0 +1,353 @@
+﻿/**
+ * @file jbatch.cpp
+ * Copyright (c) 2024 Gaaagaa. All rights reserved.
+ * 
+ * @author  : Gaaagaa
+ * @date    : 2024-10-22
+ * @version : 1.0.0.0
+ * @brief   : JPEG 批量编码（jenc_batch()）与 质量阶梯编码（jenc_ladder()）的性能测试程序。
+ */
+
+#include "jencoder.h"
+#include "jthread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+////////////////////////////////////////////////////////////////////////////////
+
+j_uint_t JUT_nimg = 256;   ///< 图像数量
+j_uint_t JUT_imgw = 256;   ///< 图像宽度
+j_uint_t JUT_imgh = 256;   ///< 图像高度
+j_uint_t JUT_qual = 75;    ///< 编码压缩质量
+j_uint_t JUT_nthd = 0;     ///< 最大工作线程数量
+j_uint_t JUT_loop = 3;     ///< 每项测试的重复次数（取最佳值）
+
+/**********************************************************/
+/**
+ * @brief 输出程序帮助信息。
+ */
+void usage(const char * xsz_name)
+{
+    printf(
+        "usage: %s [-n count] [-w width] [-h height] [-q quality] [-t threads] [-l loops]\n"
+        "       -n : the number of images in the batch, the default is 256;\n"
+        "       -w : the image width, the default is 256;\n"
+        "       -h : the image height, the default is 256;\n"
+        "       -q : the encoding quality[ 1 - 100 ], default value is 75;\n"
+        "       -t : the maximum number of worker threads, the default is the number of CPUs;\n"
+        "            the batch is measured at 1, 2, 4, ... up to this value;\n"
+        "       -l : the number of runs per measurement (the best one is reported), default is 3.\n\n",
+        xsz_name);
+}
+
+/**********************************************************/
+/**
+ * @brief 获取当前时刻（以 秒 为单位）。
+ */
+static double jbatch_now(void)
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**********************************************************/
+/**
+ * @brief 生成测试用的 RGB 图像（渐变 + 伪随机噪声，各图像内容不同）。
+ */
+static j_void_t jbatch_image(j_mptr_t jmt_pxls, j_uint_t jut_seed)
+{
+    j_uint_t jut_xpos = 0;
+    j_uint_t jut_ypos = 0;
+    j_uint_t jut_rand = jut_seed * 2654435761u + 1;
+
+    for (jut_ypos = 0; jut_ypos < JUT_imgh; ++jut_ypos)
+    {
+        for (jut_xpos = 0; jut_xpos < JUT_imgw; ++jut_xpos)
+        {
+            jut_rand = jut_rand * 1103515245u + 12345u;
+
+            jmt_pxls[0] = (j_byte_t)(jut_xpos + jut_seed + ((jut_rand >> 16) & 15));
+            jmt_pxls[1] = (j_byte_t)(jut_ypos * 2 + ((jut_rand >> 20) & 15));
+            jmt_pxls[2] = (j_byte_t)((jut_xpos ^ jut_ypos) + ((jut_rand >> 24) & 15));
+            jmt_pxls += 3;
+        }
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 输出一项测试结果。
+ */
+static j_void_t jbatch_report(
+                    j_cstring_t jsz_name,
+                    j_uint_t    jut_nthd,
+                    double      jdt_time,
+                    j_size_t    jst_size)
+{
+    double jdt_mpxl = (double)JUT_nimg * JUT_imgw * JUT_imgh / 1000000.0;
+
+    printf("%-14s threads=%2u  time=%8.3f ms  %9.1f img/s  %8.2f MP/s  %8.2f MB/s(out)\n",
+           jsz_name,
+           jut_nthd,
+           jdt_time * 1000.0,
+           JUT_nimg / jdt_time,
+           jdt_mpxl / jdt_time,
+           jst_size / jdt_time / 1000000.0);
+}
+
+/**********************************************************/
+/**
+ * @brief main function.
+ */
+int main(int argc, char * argv[])
+{
+    j_int_t      jit_iter = 0;
+    j_uint_t     jut_iter = 0;
+    j_uint_t     jut_loop = 0;
+    j_uint_t     jut_nthd = 0;
+    j_int_t      jit_err  = 0;
+    j_size_t     jst_size = 0;
+    j_size_t     jst_olen = 0;
+    double       jdt_time = 0.0;
+    double       jdt_best = 0.0;
+    j_mptr_t     jmt_pxls = J_NULL;
+    j_mptr_t     jmt_obuf = J_NULL;
+    jenc_job_t * jjob_arr = J_NULL;
+
+    //======================================
+    // 解析参数
+
+    for (jit_iter = 1; jit_iter + 1 < argc; jit_iter += 2)
+    {
+        j_uint_t jut_value = (j_uint_t)strtoul(argv[jit_iter + 1], J_NULL, 0);
+
+        if (0 == strcmp("-n", argv[jit_iter]))
+            JUT_nimg = jut_value;
+        else if (0 == strcmp("-w", argv[jit_iter]))
+            JUT_imgw = jut_value;
+        else if (0 == strcmp("-h", argv[jit_iter]))
+            JUT_imgh = jut_value;
+        else if (0 == strcmp("-q", argv[jit_iter]))
+            JUT_qual = jut_value;
+        else if (0 == strcmp("-t", argv[jit_iter]))
+            JUT_nthd = jut_value;
+        else if (0 == strcmp("-l", argv[jit_iter]))
+            JUT_loop = jut_value;
+        else
+        {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    if ((0 == JUT_nimg) || (0 == JUT_imgw) || (0 == JUT_imgh) || (0 == JUT_loop))
+    {
+        usage(argv[0]);
+        return -1;
+    }
+
+    if (0 == JUT_nthd)
+        JUT_nthd = jthrd_ncpus();
+
+    //======================================
+    // 准备测试数据：每张图像的输出缓存容量，按 未压缩数据大小 预留
+
+    jst_olen = (j_size_t)JUT_imgw * JUT_imgh * 3 + 4096;
+
+    jmt_pxls = (j_mptr_t)malloc((j_size_t)JUT_imgw * JUT_imgh * 3 * JUT_nimg);
+    jmt_obuf = (j_mptr_t)malloc(jst_olen * ((JUT_nimg < 4) ? 4 : JUT_nimg));
+    jjob_arr = (jenc_job_t *)calloc(JUT_nimg, sizeof(jenc_job_t));
+    if ((J_NULL == jmt_pxls) || (J_NULL == jmt_obuf) || (J_NULL == jjob_arr))
+    {
+        printf("malloc failed!\n");
+        return -1;
+    }
+
+    for (jut_iter = 0; jut_iter < JUT_nimg; ++jut_iter)
+    {
+        jenc_job_t * jjob_ptr = &jjob_arr[jut_iter];
+
+        jjob_ptr->jccs_conv = JENC_RGB_TO_YCC;
+        jjob_ptr->jmt_pxls  = jmt_pxls + (j_size_t)JUT_imgw * JUT_imgh * 3 * jut_iter;
+        jjob_ptr->jit_step  = (j_int_t)(JUT_imgw * 3);
+        jjob_ptr->jut_imgw  = JUT_imgw;
+        jjob_ptr->jut_imgh  = JUT_imgh;
+        jjob_ptr->jut_qual  = JUT_qual;
+        jjob_ptr->jct_mode  = JCTL_MODE_FMEMORY;
+        jjob_ptr->jht_optr  = jmt_obuf + jst_olen * jut_iter;
+        jjob_ptr->jst_mlen  = jst_olen;
+
+        jbatch_image(jjob_ptr->jmt_pxls, jut_iter);
+    }
+
+    printf("batch: %u images of %ux%u RGB => YCC, quality %u, %u CPU(s)\n\n",
+           JUT_nimg, JUT_imgw, JUT_imgh, JUT_qual, jthrd_ncpus());
+
+    //======================================
+    // 基准：单个编码器对象，逐个编码
+
+    {
+        jencoder_t jencoder;
+
+        jdt_best = 0.0;
+        for (jut_loop = 0; jut_loop < JUT_loop; ++jut_loop)
+        {
+            jst_size = 0;
+            jdt_time = jbatch_now();
+
+            for (jut_iter = 0; jut_iter < JUT_nimg; ++jut_iter)
+            {
+                jenc_job_t * jjob_ptr = &jjob_arr[jut_iter];
+
+                jencoder.config(JCTL_MODE_FMEMORY, jjob_ptr->jht_optr, jjob_ptr->jst_mlen, JUT_qual);
+                jit_err = jencoder.encode_image(
+                                    jjob_ptr->jccs_conv,
+                                    jjob_ptr->jmt_pxls,
+                                    jjob_ptr->jit_step,
+                                    jjob_ptr->jut_imgw,
+                                    jjob_ptr->jut_imgh);
+                if (jit_err <= 0)
+                {
+                    printf("encode_image() return error: %s\n", jenc_errno_name(jit_err));
+                    return -1;
+                }
+
+                jst_size += (j_size_t)jit_err;
+            }
+
+            jdt_time = jbatch_now() - jdt_time;
+            if ((0 == jut_loop) || (jdt_time < jdt_best))
+                jdt_best = jdt_time;
+        }
+
+        jbatch_report("single encoder", 1, jdt_best, jst_size);
+    }
+
+    //======================================
+    // jenc_batch() ：1, 2, 4, ... 个工作线程
+
+    for (jut_nthd = 1; ; jut_nthd *= 2)
+    {
+        if (jut_nthd > JUT_nthd)
+            jut_nthd = JUT_nthd;
+
+        jdt_best = 0.0;
+        for (jut_loop = 0; jut_loop < JUT_loop; ++jut_loop)
+        {
+            jdt_time = jbatch_now();
+            jit_err  = jenc_batch(jjob_arr, JUT_nimg, jut_nthd);
+            jdt_time = jbatch_now() - jdt_time;
+
+            if (jit_err != (j_int_t)JUT_nimg)
+            {
+                printf("jenc_batch() return %d, error: %s\n",
+                       jit_err, jenc_errno_name(jjob_arr[0].jit_err));
+                return -1;
+            }
+
+            if ((0 == jut_loop) || (jdt_time < jdt_best))
+                jdt_best = jdt_time;
+        }
+
+        jst_size = 0;
+        for (jut_iter = 0; jut_iter < JUT_nimg; ++jut_iter)
+            jst_size += jjob_arr[jut_iter].jst_size;
+
+        jbatch_report("jenc_batch", jut_nthd, jdt_best, jst_size);
+
+        if (jut_nthd >= JUT_nthd)
+            break;
+    }
+
+    //======================================
+    // 质量阶梯：同一幅图像 按多个压缩质量编码（逐个 jenc_image() 与 jenc_ladder() 对比）
+
+    {
+        const j_uint_t JUT_qarr[] = { 50, 70, 85, 95 };
+        const j_uint_t JUT_nqua   = (j_uint_t)(sizeof(JUT_qarr) / sizeof(JUT_qarr[0]));
+        jenc_job_t     jjob_lad[sizeof(JUT_qarr) / sizeof(JUT_qarr[0])];
+        jencoder_t     jencoder;
+
+        memset(jjob_lad, 0, sizeof(jjob_lad));
+        for (jut_iter = 0; jut_iter < JUT_nqua; ++jut_iter)
+        {
+            jjob_lad[jut_iter].jut_qual = JUT_qarr[jut_iter];
+            jjob_lad[jut_iter].jct_mode = JCTL_MODE_FMEMORY;
+            jjob_lad[jut_iter].jht_optr = jmt_obuf + jst_olen * jut_iter;
+            jjob_lad[jut_iter].jst_mlen = jst_olen;
+        }
+
+        printf("\nladder: q50/q70/q85/q95 of one %ux%u image (%u rungs)\n\n",
+               JUT_imgw, JUT_imgh, JUT_nqua);
+
+        jdt_best = 0.0;
+        for (jut_loop = 0; jut_loop < JUT_loop; ++jut_loop)
+        {
+            jdt_time = jbatch_now();
+            for (jut_iter = 0; jut_iter < JUT_nqua; ++jut_iter)
+            {
+                jencoder.config(JCTL_MODE_FMEMORY, jjob_lad[jut_iter].jht_optr, jst_olen, JUT_qarr[jut_iter]);
+                jit_err = jencoder.encode_image(
+                    JENC_RGB_TO_YCC, jmt_pxls, (j_int_t)(JUT_imgw * 3), JUT_imgw, JUT_imgh);
+                if (jit_err <= 0)
+                {
+                    printf("encode_image() return error: %s\n", jenc_errno_name(jit_err));
+                    return -1;
+                }
+            }
+            jdt_time = jbatch_now() - jdt_time;
+            if ((0 == jut_loop) || (jdt_time < jdt_best))
+                jdt_best = jdt_time;
+        }
+
+        printf("%-14s threads=%2u  time=%8.3f ms\n", "jenc_image x4", 1, jdt_best * 1000.0);
+
+        for (jut_nthd = 1; ; jut_nthd *= 2)
+        {
+            if (jut_nthd > JUT_nthd)
+                jut_nthd = JUT_nthd;
+
+            jdt_best = 0.0;
+            for (jut_loop = 0; jut_loop < JUT_loop; ++jut_loop)
+            {
+                jdt_time = jbatch_now();
+                jit_err  = jenc_ladder(
+                                JENC_RGB_TO_YCC,
+                                jmt_pxls,
+                                (j_int_t)(JUT_imgw * 3),
+                                JUT_imgw,
+                                JUT_imgh,
+                                jjob_lad,
+                                JUT_nqua,
+                                jut_nthd);
+                jdt_time = jbatch_now() - jdt_time;
+
+                if (jit_err != (j_int_t)JUT_nqua)
+                {
+                    printf("jenc_ladder() return %d, error: %s\n",
+                           jit_err, jenc_errno_name(jjob_lad[0].jit_err));
+                    return -1;
+                }
+
+                if ((0 == jut_loop) || (jdt_time < jdt_best))
+                    jdt_best = jdt_time;
+            }
+
+            printf("%-14s threads=%2u  time=%8.3f ms\n", "jenc_ladder", jut_nthd, jdt_best * 1000.0);
+
+            if (jut_nthd >= JUT_nthd)
+                break;
+        }
+    }
+
+    //======================================
+
+    free(jjob_arr);
+    free(jmt_obuf);
+    free(jmt_pxls);
+
+    return 0;
+}
@@ -0,0 +1,1458 @@
+﻿/**
+ * @file jbench.cpp
+ * Copyright (c) 2024 Gaaagaa. All rights reserved.
+ * 
+ * @author  : Gaaagaa
+ * @date    : 2024-11-03
+ * @version : 1.0.0.0
+ * @brief   : JPEG 解码、编码 与 往返（解码 + 编码）的吞吐量测试程序，
+ *            按工作线程数量扫描，输出 MP/s、MB/s、img/s、p50/p99 延迟 与 相对单线程的加速比，
+ *            可输出 JSON ；条带测试（stripe）以 jenc_image_mt() 测量 单幅图像编码 的多线程扩展性；
+ *            可选读取 硬件性能计数器，输出 IPC 与 每百万像素的 分支预测失败/缓存缺失 次数；
+ *            可与 基准 JSON 比对 MP/s，作为 性能回归检测（ctest -L perf）使用。
+ */
+
+#include "jencoder.h"
+#include "jdecoder.h"
+#include "jthread.h"
+#include "jperf.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <io.h>
+#else // !_WIN32
+#include <dirent.h>
+#endif // _WIN32
+
+////////////////////////////////////////////////////////////////////////////////
+
+j_uint_t    JUT_nimg = 16;       ///< 合成测试集的 图像数量
+j_uint_t    JUT_imgw = 1024;     ///< 合成测试集的 图像宽度
+j_uint_t    JUT_imgh = 768;      ///< 合成测试集的 图像高度
+j_uint_t    JUT_nthd = 0;        ///< 最大工作线程数量（为 0 时，取 CPU 核心数量）
+j_uint_t    JUT_loop = 3;        ///< 每项测试的重复次数（取最佳值）
+j_cstring_t JSZ_qarr = "50,75,90"; ///< 编码测试的 压缩质量列表
+j_cstring_t JSZ_json = J_NULL;   ///< JSON 输出文件（"-" 表示 标准输出）
+j_cstring_t JSZ_only = J_NULL;   ///< 只执行的测试类别（decode、encode、roundtrip、stripe）
+j_bool_t    JBL_perf = J_FALSE;  ///< 是否读取 硬件性能计数器
+j_cstring_t JSZ_base = J_NULL;   ///< 用于性能回归比对的 基准 JSON 文件
+double      JDT_tolr = 10.0;     ///< 性能回归比对的 容差（MP/s 下降的百分比）
+j_size_t    JST_mmax = 0;        ///< 每个解码器的 内存上限（字节，为 0 时 不设上限）
+j_uint_t    JUT_nevt = 0;        ///< 可用的 性能计数器事件数量
+jperf_counter_t JPERF_ctr;       ///< 性能计数器组（JUT_nevt 为 0 时 不可用）
+
+/**
+ * @struct jbench_img_t
+ * @brief  测试集中的 单幅图像。
+ */
+typedef struct jbench_img_t
+{
+    std::string jstr_path;     ///< 文件路径（合成图像为空）
+    j_mptr_t    jmt_jpeg;      ///< JPEG 数据
+    j_size_t    jst_jpeg;      ///< JPEG 数据字节数
+    FILE      * jfs_file;      ///< 文件流模式 使用的文件流
+    jpeg_info_t jinfo;         ///< 图像基本信息
+    j_mptr_t    jmt_pxls;      ///< 编码测试时，预先解码得到的 源像素
+} jbench_img_t;
+
+/**
+ * @struct jbench_work_t
+ * @brief  单个工作线程 可重复使用的工作对象。
+ */
+typedef struct jbench_work_t
+{
+    jdec_this_t jdec_this;     ///< 解码器
+    jenc_this_t jenc_this;     ///< 编码器
+    j_mptr_t    jmt_pxls;      ///< 像素缓存
+    j_size_t    jst_pcap;      ///< 像素缓存容量
+    j_mptr_t    jmt_obuf;      ///< 编码输出缓存
+    j_size_t    jst_ocap;      ///< 编码输出缓存容量
+} jbench_work_t;
+
+/**
+ * @enum  jbench_kind_t
+ * @brief 测试类别。
+ */
+typedef enum jbench_kind_t
+{
+    JBENCH_DECODE    = 0,      ///< 解码
+    JBENCH_ENCODE    = 1,      ///< 编码
+    JBENCH_ROUNDTRIP = 2,      ///< 往返（解码 + 编码）
+    JBENCH_STRIPE    = 3,      ///< 条带并行编码（jenc_image_mt()，逐幅图像执行）
+} jbench_kind_t;
+
+/**
+ * @struct jbench_ctx_t
+ * @brief  单项测试的 任务上下文。
+ */
+typedef struct jbench_ctx_t
+{
+    jbench_kind_t  jkind;      ///< 测试类别
+    jctl_mode_t    jct_mode;   ///< 解码输入模式
+    jctl_cs_t      jcs_conv;   ///< 解码输出的 色彩空间
+    jenc_ccs_t     jccs_conv;  ///< 编码的 色彩空间转换
+    j_uint_t       jut_qual;   ///< 编码的 压缩质量
+    j_uint_t       jut_nthd;   ///< 条带测试中 jenc_image_mt() 的工作线程数量
+    jbench_img_t * jimg_arr;   ///< 测试集
+    j_uint_t     * jut_iarr;   ///< 参与测试的 图像索引
+    double       * jdt_larr;   ///< 各个任务的 延迟（秒）
+    j_size_t     * jst_barr;   ///< 各个任务的 JPEG 字节数
+    j_int_t        jit_err;    ///< 任务的错误码
+    jbench_work_t  jwork_arr[JTHRD_MAX_WORKERS]; ///< 各个工作线程的工作对象
+} jbench_ctx_t;
+
+/**
+ * @struct jbench_result_t
+ * @brief  单项测试（某个线程数量下）的结果。
+ */
+typedef struct jbench_result_t
+{
+    std::string jstr_bench;    ///< 测试类别名称
+    std::string jstr_ccs;      ///< 色彩空间转换名称
+    std::string jstr_mode;     ///< 输入模式名称
+    j_uint_t    jut_qual;      ///< 压缩质量（解码测试为 0）
+    j_uint_t    jut_nthd;      ///< 工作线程数量
+    j_uint_t    jut_nimg;      ///< 参与测试的图像数量
+    double      jdt_wall;      ///< 墙上时间（秒，取最佳值）
+    double      jdt_mpxl;      ///< 像素总量（百万）
+    double      jdt_mbyt;      ///< JPEG 数据总量（MB）
+    double      jdt_p50;       ///< 延迟的 p50（秒）
+    double      jdt_p99;       ///< 延迟的 p99（秒）
+    double      jdt_scale;     ///< 相对于 单线程 的加速比（MP/s 之比）
+    jperf_value_t jperf;       ///< 最佳一次运行的 性能计数值（未启用时 均无效）
+} jbench_result_t;
+
+std::vector< jbench_img_t    > JVEC_imgs;
+std::vector< jbench_result_t > JVEC_rslt;
+
+/**********************************************************/
+/**
+ * @brief 输出程序帮助信息。
+ */
+void usage(const char * xsz_name)
+{
+    printf(
+        "usage: %s [-n count] [-w width] [-h height] [-q qualities] [-t threads] [-l loops]\n"
+        "          [-b decode|encode|roundtrip|stripe] [-p] [-j json] [-c baseline [-r percent]] [-M kbytes] [input ...]\n"
+        "       input : jpeg files or directories (*.jpg, *.jpeg), if no input is given,\n"
+        "               a synthetic corpus (gradient + noise, RGB => YCC, quality 90) is used;\n"
+        "       -n : the number of images in the synthetic corpus, the default is 16;\n"
+        "       -w : the image width of the synthetic corpus, the default is 1024;\n"
+        "       -h : the image height of the synthetic corpus, the default is 768;\n"
+        "       -q : the encoding qualities, separated by comma, the default is 50,75,90;\n"
+        "       -t : the maximum number of worker threads, the default is the number of CPUs;\n"
+        "            each measurement is run at 1, 2, 4, ... up to this value;\n"
+        "       -l : the number of runs per measurement (the best one is reported), default is 3;\n"
+        "       -b : only run one kind of benchmark, stripe encodes one image at a time\n"
+        "            with jenc_image_mt() (RGB => YCC), to measure the multi-thread scaling\n"
+        "            of a single image encoding (larger -w/-h give more stripes);\n"
+        "       -p : read the hardware performance counters (Linux perf_event_open) and\n"
+        "            report IPC and the branch/L1D/LLC misses per megapixel, the counters\n"
+        "            which are not available (VM, perf_event_paranoid, ...) are skipped;\n"
+        "       -j : write the results as JSON to the file (\"-\" is stdout);\n"
+        "       -c : compare the MP/s with a baseline JSON written by -j (same options),\n"
+        "            print a diff table and exit with an error on any regression;\n"
+        "       -r : the tolerated MP/s drop in percent for -c, the default is 10;\n"
+        "       -M : the memory limit of each decoder in KB (libjpeg max_memory_to_use),\n"
+        "            larger images swap their coefficient buffers out to temporary files,\n"
+        "            the default is 0 (no limit).\n"
+        "       MB/s is measured on the JPEG data (decode input, encode output),\n"
+        "       the latency percentiles are per image, taken from the best run,\n"
+        "       the scale is the MP/s speedup over the 1 thread run of the same sweep.\n\n",
+        xsz_name);
+}
+
+/**********************************************************/
+/**
+ * @brief 字符串忽略大小写的比对（只比较 ASCII 字母）。
+ */
+static j_bool_t jbench_iequal(j_cstring_t jsz_lcmp, j_cstring_t jsz_rcmp)
+{
+    for (; ('\0' != *jsz_lcmp) && ('\0' != *jsz_rcmp); ++jsz_lcmp, ++jsz_rcmp)
+    {
+        j_int_t jit_lchr = *jsz_lcmp;
+        j_int_t jit_rchr = *jsz_rcmp;
+
+        if ((jit_lchr >= 'A') && (jit_lchr <= 'Z'))
+            jit_lchr += ('a' - 'A');
+        if ((jit_rchr >= 'A') && (jit_rchr <= 'Z'))
+            jit_rchr += ('a' - 'A');
+        if (jit_lchr != jit_rchr)
+            return J_FALSE;
+    }
+
+    return (*jsz_lcmp == *jsz_rcmp);
+}
+
+/**********************************************************/
+/**
+ * @brief 判断文件名 是否为 JPEG 文件（*.jpg、*.jpeg）。
+ */
+static j_bool_t jbench_is_jpeg(j_cstring_t jsz_name)
+{
+    j_cstring_t jsz_extn = strrchr(jsz_name, '.');
+
+    return ((J_NULL != jsz_extn) &&
+            (jbench_iequal(jsz_extn, ".jpg") || jbench_iequal(jsz_extn, ".jpeg")));
+}
+
+/**********************************************************/
+/**
+ * @brief 读取整个文件的数据（返回的缓存，由调用方 free() 释放）。
+ */
+static j_mptr_t jbench_load(j_cstring_t jsz_path, j_size_t * jst_size)
+{
+    FILE   * jfs_file = fopen(jsz_path, "rb");
+    j_mptr_t jmt_data = J_NULL;
+    long     jlt_size = 0;
+
+    if (J_NULL == jfs_file)
+    {
+        return J_NULL;
+    }
+
+    if ((0 == fseek(jfs_file, 0, SEEK_END)) && ((jlt_size = ftell(jfs_file)) > 0))
+    {
+        fseek(jfs_file, 0, SEEK_SET);
+        jmt_data = (j_mptr_t)malloc((j_size_t)jlt_size);
+        if ((J_NULL != jmt_data) &&
+            ((j_size_t)jlt_size != fread(jmt_data, 1, (j_size_t)jlt_size, jfs_file)))
+        {
+            free(jmt_data);
+            jmt_data = J_NULL;
+        }
+    }
+
+    fclose(jfs_file);
+
+    *jst_size = (j_size_t)jlt_size;
+    return jmt_data;
+}
+
+/**********************************************************/
+/**
+ * @brief 向测试集 加入一个 JPEG 数据（读取其图像信息，无效数据则忽略）。
+ */
+static j_void_t jbench_add(const std::string & jstr_path, j_mptr_t jmt_jpeg, j_size_t jst_jpeg)
+{
+    jbench_img_t jimg;
+    jdecoder_t   jdecoder;
+
+    jimg.jstr_path = jstr_path;
+    jimg.jmt_jpeg  = jmt_jpeg;
+    jimg.jst_jpeg  = jst_jpeg;
+    jimg.jfs_file  = J_NULL;
+    jimg.jmt_pxls  = J_NULL;
+
+    if ((JDEC_ERR_OK != jdecoder.config(JCTL_MODE_FMEMORY, jmt_jpeg, jst_jpeg)) ||
+        (JDEC_ERR_OK != jdecoder.info(&jimg.jinfo)))
+    {
+        printf("%s : not a valid jpeg, skipped!\n", jstr_path.c_str());
+        free(jmt_jpeg);
+        return;
+    }
+
+    JVEC_imgs.push_back(jimg);
+}
+
+/**********************************************************/
+/**
+ * @brief 加载输入的 JPEG 文件 或 目录下的全部 JPEG 文件。
+ */
+static j_void_t jbench_load_input(j_cstring_t jsz_path)
+{
+    std::vector< std::string > jvec_file;
+    j_mptr_t jmt_jpeg = J_NULL;
+    j_size_t jst_jpeg = 0;
+    j_uint_t jut_iter = 0;
+
+#ifdef _WIN32
+    struct _finddata_t jfind_data;
+    intptr_t           jfind_hdl = _findfirst((std::string(jsz_path) + "\\*").c_str(), &jfind_data);
+
+    if (-1 != jfind_hdl)
+    {
+        do
+        {
+            if (!(jfind_data.attrib & _A_SUBDIR) && jbench_is_jpeg(jfind_data.name))
+                jvec_file.push_back(std::string(jsz_path) + "\\" + jfind_data.name);
+        } while (0 == _findnext(jfind_hdl, &jfind_data));
+
+        _findclose(jfind_hdl);
+    }
+    else
+    {
+        jvec_file.push_back(jsz_path);
+    }
+#else // !_WIN32
+    DIR           * jdir_ptr = opendir(jsz_path);
+    struct dirent * jent_ptr = J_NULL;
+
+    if (J_NULL != jdir_ptr)
+    {
+        while (J_NULL != (jent_ptr = readdir(jdir_ptr)))
+        {
+            if (jbench_is_jpeg(jent_ptr->d_name))
+                jvec_file.push_back(std::string(jsz_path) + "/" + jent_ptr->d_name);
+        }
+
+        closedir(jdir_ptr);
+    }
+    else
+    {
+        jvec_file.push_back(jsz_path);
+    }
+#endif // _WIN32
+
+    std::sort(jvec_file.begin(), jvec_file.end());
+
+    for (jut_iter = 0; jut_iter < (j_uint_t)jvec_file.size(); ++jut_iter)
+    {
+        jmt_jpeg = jbench_load(jvec_file[jut_iter].c_str(), &jst_jpeg);
+        if (J_NULL == jmt_jpeg)
+        {
+            printf("%s : read file failed!\n", jvec_file[jut_iter].c_str());
+            continue;
+        }
+
+        jbench_add(jvec_file[jut_iter], jmt_jpeg, jst_jpeg);
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 生成合成测试集（渐变 + 伪随机噪声 的 RGB 图像，以 质量 90 编码）。
+ */
+static j_bool_t jbench_synth(void)
+{
+    j_mptr_t   jmt_pxls = (j_mptr_t)malloc((j_size_t)JUT_imgw * JUT_imgh * 3);
+    j_mptr_t   jmt_jpeg = J_NULL;
+    j_uint_t   jut_iter = 0;
+    j_uint_t   jut_xpos = 0;
+    j_uint_t   jut_ypos = 0;
+    j_uint_t   jut_rand = 0;
+    j_int_t    jit_err  = 0;
+    j_char_t   jsz_name[64];
+    jencoder_t jencoder;
+
+    if (J_NULL == jmt_pxls)
+    {
+        return J_FALSE;
+    }
+
+    for (jut_iter = 0; jut_iter < JUT_nimg; ++jut_iter)
+    {
+        j_mptr_t jmt_iter = jmt_pxls;
+
+        jut_rand = jut_iter * 2654435761u + 1;
+        for (jut_ypos = 0; jut_ypos < JUT_imgh; ++jut_ypos)
+        {
+            for (jut_xpos = 0; jut_xpos < JUT_imgw; ++jut_xpos)
+            {
+                jut_rand = jut_rand * 1103515245u + 12345u;
+
+                jmt_iter[0] = (j_byte_t)(jut_xpos + jut_iter + ((jut_rand >> 16) & 15));
+                jmt_iter[1] = (j_byte_t)(jut_ypos * 2 + ((jut_rand >> 20) & 15));
+                jmt_iter[2] = (j_byte_t)((jut_xpos ^ jut_ypos) + ((jut_rand >> 24) & 15));
+                jmt_iter += 3;
+            }
+        }
+
+        jencoder.config(JCTL_MODE_FMEMORY, J_NULL, 0, 90);
+        jit_err = jencoder.encode_image(
+                        JENC_RGB_TO_YCC, jmt_pxls, (j_int_t)(JUT_imgw * 3), JUT_imgw, JUT_imgh);
+        if (jit_err < 0)
+        {
+            printf("encode_image() return error: %s\n", jenc_errno_name(jit_err));
+            free(jmt_pxls);
+            return J_FALSE;
+        }
+
+        jmt_jpeg = (j_mptr_t)malloc(jencoder.fmsize());
+        if (J_NULL == jmt_jpeg)
+        {
+            free(jmt_pxls);
+            return J_FALSE;
+        }
+
+        memcpy(jmt_jpeg, jencoder.fmdata(), jencoder.fmsize());
+        snprintf(jsz_name, sizeof(jsz_name), "synthetic_%04u", jut_iter);
+        jbench_add(jsz_name, jmt_jpeg, jencoder.fmsize());
+    }
+
+    free(jmt_pxls);
+    return J_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 确保 工作对象 的缓存容量。
+ */
+static j_bool_t jbench_grow(j_mptr_t * jmt_buff, j_size_t * jst_bcap, j_size_t jst_need)
+{
+    if (*jst_bcap < jst_need)
+    {
+        if (J_NULL != *jmt_buff)
+            free(*jmt_buff);
+
+        *jmt_buff = (j_mptr_t)malloc(jst_need);
+        *jst_bcap = (J_NULL != *jmt_buff) ? jst_need : 0;
+    }
+
+    return (J_NULL != *jmt_buff);
+}
+
+/**********************************************************/
+/**
+ * @brief 以 内存模式 编码，返回编码输出的字节数（< 0 时 为错误码）；
+ *        jut_nthd 不为 0 时，使用 jenc_image_mt() 以 jut_nthd 个工作线程 条带并行编码。
+ */
+static j_int_t jbench_encode(
+                    jbench_work_t      * jwork_ptr,
+                    const jbench_img_t & jimg,
+                    jenc_ccs_t           jccs_conv,
+                    j_uint_t             jut_qual,
+                    j_mptr_t             jmt_pxls,
+                    j_uint_t             jut_nthd)
+{
+    j_int_t jit_err = JENC_ERR_UNKNOWN;
+
+    jit_err = jenc_config(
+                jwork_ptr->jenc_this,
+                JCTL_MODE_FMEMORY,
+                jwork_ptr->jmt_obuf,
+                jwork_ptr->jst_ocap,
+                jut_qual);
+    if ((JENC_ERR_OK == jit_err) && (0 != jut_nthd))
+    {
+        jit_err = jenc_image_mt(
+                    jwork_ptr->jenc_this,
+                    jccs_conv,
+                    jmt_pxls,
+                    (j_int_t)(JENC_CCS_NUMC(jccs_conv) * jimg.jinfo.jit_imgw),
+                    (j_uint_t)jimg.jinfo.jit_imgw,
+                    (j_uint_t)jimg.jinfo.jit_imgh,
+                    jut_nthd,
+                    0);
+    }
+    else if (JENC_ERR_OK == jit_err)
+    {
+        jit_err = jenc_image(
+                    jwork_ptr->jenc_this,
+                    jccs_conv,
+                    jmt_pxls,
+                    (j_int_t)(JENC_CCS_NUMC(jccs_conv) * jimg.jinfo.jit_imgw),
+                    (j_uint_t)jimg.jinfo.jit_imgw,
+                    (j_uint_t)jimg.jinfo.jit_imgh);
+    }
+
+    // 输出缓存容量不足时，编码数据存放在编码器的内部缓存中
+    if (JENC_ERR_OK == jit_err)
+    {
+        jit_err = (j_int_t)jenc_fmsize(jwork_ptr->jenc_this);
+    }
+
+    return jit_err;
+}
+
+/**********************************************************/
+/**
+ * @brief 单个测试任务：处理第 jut_tidx 幅 参与测试的图像。
+ */
+static j_void_t jbench_task(
+                    j_void_t * jvt_ctxt,
+                    j_uint_t   jut_widx,
+                    j_uint_t   jut_tidx)
+{
+    jbench_ctx_t  * jctx_ptr  = (jbench_ctx_t *)jvt_ctxt;
+    jbench_work_t * jwork_ptr = &jctx_ptr->jwork_arr[jut_widx];
+    jbench_img_t  & jimg      = jctx_ptr->jimg_arr[jctx_ptr->jut_iarr[jut_tidx]];
+    j_size_t        jst_pxls  = (j_size_t)jimg.jinfo.jit_imgw * jimg.jinfo.jit_imgh * 4;
+    j_fhandle_t     jht_iptr  = J_NULL;
+    j_int_t         jit_err   = 0;
+    double          jdt_tick  = 0.0;
+
+    //======================================
+    // 准备工作对象（不计入耗时）
+
+    if (J_NULL == jwork_ptr->jdec_this)
+    {
+        jwork_ptr->jdec_this = jdec_alloc(J_NULL);
+        if (J_NULL != jwork_ptr->jdec_this)
+            jdec_config_memory(jwork_ptr->jdec_this, JST_mmax);
+    }
+    if (J_NULL == jwork_ptr->jenc_this)
+        jwork_ptr->jenc_this = jenc_alloc(J_NULL);
+
+    if ((J_NULL == jwork_ptr->jdec_this) || (J_NULL == jwork_ptr->jenc_this) ||
+        !jbench_grow(&jwork_ptr->jmt_pxls, &jwork_ptr->jst_pcap, jst_pxls) ||
+        !jbench_grow(&jwork_ptr->jmt_obuf, &jwork_ptr->jst_ocap, jst_pxls + 4096))
+    {
+        jctx_ptr->jit_err = JDEC_ERR_MALLOC;
+        return;
+    }
+
+    switch (jctx_ptr->jct_mode)
+    {
+    case JCTL_MODE_FSTREAM: jht_iptr = (j_fhandle_t)jimg.jfs_file;          break;
+    case JCTL_MODE_FSZPATH: jht_iptr = (j_fhandle_t)jimg.jstr_path.c_str(); break;
+    default               : jht_iptr = (j_fhandle_t)jimg.jmt_jpeg;          break;
+    }
+
+    //======================================
+
+    jdt_tick = jthrd_clock();
+
+    if ((JBENCH_ENCODE != jctx_ptr->jkind) && (JBENCH_STRIPE != jctx_ptr->jkind))
+    {
+        jit_err = jdec_config(jwork_ptr->jdec_this, jctx_ptr->jct_mode, jht_iptr, jimg.jst_jpeg);
+        if (JDEC_ERR_OK == jit_err)
+        {
+            jit_err = jdec_image(
+                        jwork_ptr->jdec_this,
+                        jctx_ptr->jcs_conv,
+                        jwork_ptr->jmt_pxls,
+                        JCTL_CS_NUMC(jctx_ptr->jcs_conv) * jimg.jinfo.jit_imgw,
+                        J_NULL);
+        }
+    }
+
+    if ((jit_err >= 0) && (JBENCH_DECODE != jctx_ptr->jkind))
+    {
+        jit_err = jbench_encode(
+                    jwork_ptr,
+                    jimg,
+                    jctx_ptr->jccs_conv,
+                    jctx_ptr->jut_qual,
+                    (JBENCH_ROUNDTRIP != jctx_ptr->jkind) ? jimg.jmt_pxls : jwork_ptr->jmt_pxls,
+                    (JBENCH_STRIPE == jctx_ptr->jkind) ? jctx_ptr->jut_nthd : 0);
+    }
+
+    jctx_ptr->jdt_larr[jut_tidx] = jthrd_clock() - jdt_tick;
+
+    //======================================
+
+    if (jit_err < 0)
+    {
+        jctx_ptr->jit_err = jit_err;
+        return;
+    }
+
+    jctx_ptr->jst_barr[jut_tidx] =
+        ((JBENCH_ENCODE == jctx_ptr->jkind) || (JBENCH_STRIPE == jctx_ptr->jkind)) ?
+            (j_size_t)jit_err : jimg.jst_jpeg;
+}
+
+/**********************************************************/
+/**
+ * @brief 释放 任务上下文中 各个工作线程的工作对象。
+ */
+static j_void_t jbench_free_work(jbench_ctx_t * jctx_ptr)
+{
+    j_uint_t jut_iter = 0;
+
+    for (jut_iter = 0; jut_iter < JTHRD_MAX_WORKERS; ++jut_iter)
+    {
+        jbench_work_t * jwork_ptr = &jctx_ptr->jwork_arr[jut_iter];
+
+        if (J_NULL != jwork_ptr->jdec_this)
+            jdec_release(jwork_ptr->jdec_this);
+        if (J_NULL != jwork_ptr->jenc_this)
+            jenc_release(jwork_ptr->jenc_this);
+        if (J_NULL != jwork_ptr->jmt_pxls)
+            free(jwork_ptr->jmt_pxls);
+        if (J_NULL != jwork_ptr->jmt_obuf)
+            free(jwork_ptr->jmt_obuf);
+    }
+
+    memset(jctx_ptr->jwork_arr, 0, sizeof(jctx_ptr->jwork_arr));
+}
+
+/**********************************************************/
+/**
+ * @brief 取 已排序延迟数组 的百分位值。
+ */
+static double jbench_percentile(const std::vector< double > & jvec_sort, double jdt_rank)
+{
+    j_size_t jst_indx = (j_size_t)(jdt_rank * (double)jvec_sort.size() + 0.999999);
+
+    if (jst_indx > 0)
+        jst_indx -= 1;
+    if (jst_indx >= jvec_sort.size())
+        jst_indx = jvec_sort.size() - 1;
+
+    return jvec_sort[jst_indx];
+}
+
+/**********************************************************/
+/**
+ * @brief 由性能计数值 计算 IPC（jut_event 为 JPERF_EVENT_COUNT 时）
+ *        或 每百万像素的事件次数，计数值无效时 返回 J_FALSE 。
+ */
+static j_bool_t jbench_perf_rate(const jbench_result_t & jrslt, j_uint_t jut_event, double * jdt_rate)
+{
+    const jperf_value_t & jperf = jrslt.jperf;
+
+    if (JPERF_EVENT_COUNT == jut_event)
+    {
+        if (!jperf.jbl_valid[JPERF_CYCLES] || !jperf.jbl_valid[JPERF_INSTRUCTIONS] ||
+            (jperf.jdt_value[JPERF_CYCLES] <= 0.0))
+            return J_FALSE;
+
+        *jdt_rate = jperf.jdt_value[JPERF_INSTRUCTIONS] / jperf.jdt_value[JPERF_CYCLES];
+        return J_TRUE;
+    }
+
+    if (!jperf.jbl_valid[jut_event] || (jrslt.jdt_mpxl <= 0.0))
+        return J_FALSE;
+
+    *jdt_rate = jperf.jdt_value[jut_event] / jrslt.jdt_mpxl;
+    return J_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 输出 单项测试结果的 性能计数值（不可用的 以 "-" 表示）。
+ */
+static j_void_t jbench_print_perf(const jbench_result_t & jrslt)
+{
+    const j_uint_t    JUT_list[] = { JPERF_EVENT_COUNT, JPERF_CYCLES, JPERF_BRANCH_MISS,
+                                     JPERF_L1D_MISS, JPERF_LLC_MISS, JPERF_TASK_CLOCK };
+    const j_cstring_t JSZ_list[] = { "IPC", "cycles/MP", "br-miss/MP",
+                                     "L1D-miss/MP", "LLC-miss/MP", "cpu-ns/MP" };
+
+    j_uint_t jut_iter = 0;
+    double   jdt_rate = 0.0;
+
+    printf("%-9s", "");
+    for (jut_iter = 0; jut_iter < sizeof(JUT_list) / sizeof(JUT_list[0]); ++jut_iter)
+    {
+        if (!jbench_perf_rate(jrslt, JUT_list[jut_iter], &jdt_rate))
+            printf("  %s=-", JSZ_list[jut_iter]);
+        else if (JPERF_EVENT_COUNT == JUT_list[jut_iter])
+            printf("  %s=%.2f", JSZ_list[jut_iter], jdt_rate);
+        else
+            printf("  %s=%.4g", JSZ_list[jut_iter], jdt_rate);
+    }
+    printf("\n");
+}
+
+/**********************************************************/
+/**
+ * @brief 对 jut_iarr 中的图像执行一项测试，并按 1、2、4、... 个工作线程 扫描；
+ *        条带测试 逐幅图像执行，工作线程 由 jenc_image_mt() 在单幅图像的条带间使用。
+ */
+static j_void_t jbench_run(
+                    jbench_ctx_t                  * jctx_ptr,
+                    const std::vector< j_uint_t > & jvec_indx,
+                    j_cstring_t                     jsz_bench,
+                    j_cstring_t                     jsz_ccs,
+                    j_cstring_t                     jsz_mode)
+{
+    j_uint_t jut_nimg = (j_uint_t)jvec_indx.size();
+    j_uint_t jut_nthd = 0;
+    j_uint_t jut_npar = 0;
+    j_uint_t jut_loop = 0;
+    j_uint_t jut_iter = 0;
+    double   jdt_time = 0.0;
+    double   jdt_rate = 0.0;
+
+    jperf_value_t           jperf;
+    std::vector< double   > jvec_lat(jut_nimg);
+    std::vector< double   > jvec_best(jut_nimg);
+    std::vector< j_size_t > jvec_byte(jut_nimg);
+
+    if (0 == jut_nimg)
+    {
+        return;
+    }
+
+    jctx_ptr->jimg_arr = &JVEC_imgs[0];
+    jctx_ptr->jut_iarr = (j_uint_t *)&jvec_indx[0];
+    jctx_ptr->jdt_larr = &jvec_lat[0];
+    jctx_ptr->jst_barr = &jvec_byte[0];
+
+    for (jut_nthd = 1; ; jut_nthd *= 2)
+    {
+        jbench_result_t jrslt;
+
+        if (jut_nthd > JUT_nthd)
+            jut_nthd = JUT_nthd;
+
+        jctx_ptr->jut_nthd = jut_nthd;
+        jut_npar = (JBENCH_STRIPE == jctx_ptr->jkind) ? 1 : jut_nthd;
+
+        jrslt.jstr_bench = jsz_bench;
+        jrslt.jstr_ccs   = jsz_ccs;
+        jrslt.jstr_mode  = jsz_mode;
+        jrslt.jut_qual   = jctx_ptr->jut_qual;
+        jrslt.jut_nthd   = (JBENCH_STRIPE == jctx_ptr->jkind) ?
+                                jut_nthd : jthrd_workers(jut_nthd, jut_nimg);
+        jrslt.jut_nimg   = jut_nimg;
+        jrslt.jdt_wall   = 0.0;
+        jrslt.jdt_mpxl   = 0.0;
+        jrslt.jdt_mbyt   = 0.0;
+
+        memset(&jrslt.jperf, 0, sizeof(jperf_value_t));
+
+        // 先执行一次 预热（同时让工作对象 分配好各自的缓存）
+        jctx_ptr->jit_err = 0;
+        jthrd_parallel(jut_npar, jut_nimg, jbench_task, jctx_ptr);
+
+        for (jut_loop = 0; (0 == jctx_ptr->jit_err) && (jut_loop < JUT_loop); ++jut_loop)
+        {
+            // 工作线程 在计数器启动后创建，其计数值 在线程退出时 累加到 本线程的计数器中
+            if (JUT_nevt > 0)
+                jperf_start(&JPERF_ctr);
+
+            jdt_time = jthrd_clock();
+            jthrd_parallel(jut_npar, jut_nimg, jbench_task, jctx_ptr);
+            jdt_time = jthrd_clock() - jdt_time;
+
+            if (JUT_nevt > 0)
+                jperf_stop(&JPERF_ctr, &jperf);
+
+            if ((0 == jut_loop) || (jdt_time < jrslt.jdt_wall))
+            {
+                jrslt.jdt_wall = jdt_time;
+                jrslt.jperf    = jperf;
+                jvec_best = jvec_lat;
+            }
+        }
+
+        if (0 != jctx_ptr->jit_err)
+        {
+            printf("%-9s %-14s %-6s : error %d (%s%s)\n",
+                   jsz_bench, jsz_ccs, jsz_mode, jctx_ptr->jit_err,
+                   jdec_errno_name(jctx_ptr->jit_err),
+                   jenc_errno_name(jctx_ptr->jit_err));
+            break;
+        }
+
+        for (jut_iter = 0; jut_iter < jut_nimg; ++jut_iter)
+        {
+            const jpeg_info_t & jinfo = JVEC_imgs[jvec_indx[jut_iter]].jinfo;
+
+            jrslt.jdt_mpxl += (double)jinfo.jit_imgw * jinfo.jit_imgh / 1000000.0;
+            jrslt.jdt_mbyt += (double)jvec_byte[jut_iter] / 1000000.0;
+        }
+
+        std::sort(jvec_best.begin(), jvec_best.end());
+        jrslt.jdt_p50 = jbench_percentile(jvec_best, 0.50);
+        jrslt.jdt_p99 = jbench_percentile(jvec_best, 0.99);
+
+        // 扫描从 1 个工作线程开始，其 MP/s 即为 加速比的基准
+        if (1 == jut_nthd)
+            jdt_rate = jrslt.jdt_mpxl / jrslt.jdt_wall;
+        jrslt.jdt_scale = (jrslt.jdt_mpxl / jrslt.jdt_wall) / jdt_rate;
+
+        printf("%-9s %-14s %-6s q=%3u threads=%2u  %8.2f MP/s  %8.2f MB/s  %9.1f img/s"
+               "  p50=%8.3f ms  p99=%8.3f ms  scale=%5.2fx\n",
+               jsz_bench, jsz_ccs, jsz_mode, jrslt.jut_qual, jrslt.jut_nthd,
+               jrslt.jdt_mpxl / jrslt.jdt_wall,
+               jrslt.jdt_mbyt / jrslt.jdt_wall,
+               jut_nimg / jrslt.jdt_wall,
+               jrslt.jdt_p50 * 1000.0,
+               jrslt.jdt_p99 * 1000.0,
+               jrslt.jdt_scale);
+
+        if (JUT_nevt > 0)
+        {
+            jbench_print_perf(jrslt);
+        }
+
+        JVEC_rslt.push_back(jrslt);
+
+        if (jut_nthd >= JUT_nthd)
+            break;
+    }
+
+    jbench_free_work(jctx_ptr);
+}
+
+/**********************************************************/
+/**
+ * @brief 收集 可按 jcs_conv 解码输出 的图像索引（jvec_indx 返回）。
+ */
+static j_void_t jbench_select(jctl_cs_t jcs_conv, std::vector< j_uint_t > & jvec_indx)
+{
+    j_uint_t jut_iter = 0;
+
+    jvec_indx.clear();
+    for (jut_iter = 0; jut_iter < (j_uint_t)JVEC_imgs.size(); ++jut_iter)
+    {
+        if (jdec_ccs_valid((jdec_ccs_t)JDEC_CCS_MAKE(jcs_conv, JVEC_imgs[jut_iter].jinfo.jcs_type)))
+            jvec_indx.push_back(jut_iter);
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 解码测试：按 输出色彩空间 与 输入模式 分项。
+ */
+static j_void_t jbench_decode(jbench_ctx_t * jctx_ptr)
+{
+    const jctl_cs_t   JCS_list[] = { JCTL_CS_RGB, JCTL_CS_GRAY, JCTL_CS_YCC };
+    const jctl_mode_t JCT_list[] = { JCTL_MODE_FMEMORY, JCTL_MODE_FSTREAM, JCTL_MODE_FSZPATH };
+    const j_cstring_t JSZ_mode[] = { "memory", "stream", "path" };
+
+    std::vector< j_uint_t > jvec_indx;
+    j_uint_t    jut_ics  = 0;
+    j_uint_t    jut_imd  = 0;
+    j_uint_t    jut_iter = 0;
+    j_cstring_t jsz_ics  = J_NULL;
+    j_char_t    jsz_ccs[32];
+
+    for (jut_ics = 0; jut_ics < sizeof(JCS_list) / sizeof(JCS_list[0]); ++jut_ics)
+    {
+        jbench_select(JCS_list[jut_ics], jvec_indx);
+
+        for (jut_imd = 0; jut_imd < sizeof(JCT_list) / sizeof(JCT_list[0]); ++jut_imd)
+        {
+            std::vector< j_uint_t > jvec_mode;
+
+            // 合成图像 没有文件路径，文件流模式 使用 临时文件
+            for (jut_iter = 0; jut_iter < (j_uint_t)jvec_indx.size(); ++jut_iter)
+            {
+                if ((JCTL_MODE_FSZPATH == JCT_list[jut_imd]) &&
+                    JVEC_imgs[jvec_indx[jut_iter]].jstr_path.empty())
+                    continue;
+                if ((JCTL_MODE_FSTREAM == JCT_list[jut_imd]) &&
+                    (J_NULL == JVEC_imgs[jvec_indx[jut_iter]].jfs_file))
+                    continue;
+                jvec_mode.push_back(jvec_indx[jut_iter]);
+            }
+
+            // 测试集的色彩空间 不一致时，输入色彩空间 以 "*" 表示
+            jsz_ics = (jvec_mode.size() > 0) ?
+                        jpeg_cs_name(JVEC_imgs[jvec_mode[0]].jinfo.jcs_type) + 8 : "-";
+            for (jut_iter = 1; jut_iter < (j_uint_t)jvec_mode.size(); ++jut_iter)
+            {
+                if (JVEC_imgs[jvec_mode[jut_iter]].jinfo.jcs_type !=
+                    JVEC_imgs[jvec_mode[0]].jinfo.jcs_type)
+                {
+                    jsz_ics = "*";
+                    break;
+                }
+            }
+
+            snprintf(jsz_ccs, sizeof(jsz_ccs), "%s=>%s",
+                     jsz_ics, jpeg_cs_name(JCTL_CS_TYPE(JCS_list[jut_ics])) + 8);
+
+            jctx_ptr->jkind    = JBENCH_DECODE;
+            jctx_ptr->jct_mode = JCT_list[jut_imd];
+            jctx_ptr->jcs_conv = JCS_list[jut_ics];
+            jctx_ptr->jut_qual = 0;
+            jbench_run(jctx_ptr, jvec_mode, "decode", jsz_ccs, JSZ_mode[jut_imd]);
+        }
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 编码测试：按 压缩质量 与 色彩空间转换 分项（源像素 预先解码，不计入耗时）；
+ *        条带测试（jkind 为 JBENCH_STRIPE）只测 RGB => YCC 。
+ */
+static j_void_t jbench_encode_all(
+                    jbench_ctx_t                  * jctx_ptr,
+                    const std::vector< j_uint_t > & jvec_qual,
+                    jbench_kind_t                   jkind)
+{
+    const jenc_ccs_t JCCS_list[] = { JENC_RGB_TO_YCC, JENC_RGB_TO_GRAY, JENC_YCC_TO_YCC, JENC_GRAY_TO_GRAY };
+    const j_uint_t   JUT_nccs = (JBENCH_STRIPE == jkind) ? 1 : sizeof(JCCS_list) / sizeof(JCCS_list[0]);
+
+    std::vector< j_uint_t > jvec_indx;
+    j_uint_t jut_iccs = 0;
+    j_uint_t jut_iqua = 0;
+    j_uint_t jut_iter = 0;
+    j_char_t jsz_ccs[32];
+
+    for (jut_iccs = 0; jut_iccs < JUT_nccs; ++jut_iccs)
+    {
+        jenc_ccs_t jccs_conv = JCCS_list[jut_iccs];
+        jctl_cs_t  jcs_src   = (jctl_cs_t)(jccs_conv & 0x00FFFFFF);
+
+        //======================================
+        // 预先解码 源像素
+
+        jbench_select(jcs_src, jvec_indx);
+        for (jut_iter = 0; jut_iter < (j_uint_t)jvec_indx.size(); )
+        {
+            jbench_img_t & jimg = JVEC_imgs[jvec_indx[jut_iter]];
+            jdecoder_t     jdecoder;
+
+            jimg.jmt_pxls = (j_mptr_t)malloc(
+                (j_size_t)JCTL_CS_NUMC(jcs_src) * jimg.jinfo.jit_imgw * jimg.jinfo.jit_imgh);
+            if ((J_NULL == jimg.jmt_pxls) ||
+                (JDEC_ERR_OK != jdecoder.config(JCTL_MODE_FMEMORY, jimg.jmt_jpeg, jimg.jst_jpeg)) ||
+                (jdecoder.decode_image(jcs_src, jimg.jmt_pxls,
+                                       JCTL_CS_NUMC(jcs_src) * jimg.jinfo.jit_imgw) <= 0))
+            {
+                printf("%s : decode source pixels failed, skipped!\n", jimg.jstr_path.c_str());
+                if (J_NULL != jimg.jmt_pxls)
+                    free(jimg.jmt_pxls);
+                jimg.jmt_pxls = J_NULL;
+                jvec_indx.erase(jvec_indx.begin() + jut_iter);
+                continue;
+            }
+
+            ++jut_iter;
+        }
+
+        snprintf(jsz_ccs, sizeof(jsz_ccs), "%s=>%s",
+                 jpeg_cs_name(JCTL_CS_TYPE(jcs_src)) + 8,
+                 jpeg_cs_name((jpeg_cs_t)JENC_CCS_OUT(jccs_conv)) + 8);
+
+        for (jut_iqua = 0; jut_iqua < (j_uint_t)jvec_qual.size(); ++jut_iqua)
+        {
+            jctx_ptr->jkind     = jkind;
+            jctx_ptr->jct_mode  = JCTL_MODE_FMEMORY;
+            jctx_ptr->jccs_conv = jccs_conv;
+            jctx_ptr->jut_qual  = jvec_qual[jut_iqua];
+            jbench_run(jctx_ptr, jvec_indx,
+                       (JBENCH_STRIPE == jkind) ? "stripe" : "encode", jsz_ccs, "memory");
+        }
+
+        for (jut_iter = 0; jut_iter < (j_uint_t)jvec_indx.size(); ++jut_iter)
+        {
+            free(JVEC_imgs[jvec_indx[jut_iter]].jmt_pxls);
+            JVEC_imgs[jvec_indx[jut_iter]].jmt_pxls = J_NULL;
+        }
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 往返测试：内存模式 解码为 RGB，再以各个压缩质量 编码为 YCC 。
+ */
+static j_void_t jbench_roundtrip(jbench_ctx_t * jctx_ptr, const std::vector< j_uint_t > & jvec_qual)
+{
+    std::vector< j_uint_t > jvec_indx;
+    j_uint_t jut_iqua = 0;
+
+    jbench_select(JCTL_CS_RGB, jvec_indx);
+
+    for (jut_iqua = 0; jut_iqua < (j_uint_t)jvec_qual.size(); ++jut_iqua)
+    {
+        jctx_ptr->jkind     = JBENCH_ROUNDTRIP;
+        jctx_ptr->jct_mode  = JCTL_MODE_FMEMORY;
+        jctx_ptr->jcs_conv  = JCTL_CS_RGB;
+        jctx_ptr->jccs_conv = JENC_RGB_TO_YCC;
+        jctx_ptr->jut_qual  = jvec_qual[jut_iqua];
+        jbench_run(jctx_ptr, jvec_indx, "roundtrip", "*=>RGB=>YCC", "memory");
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 向 JSON 输出 IPC 或 每百万像素的事件次数（不可用时 为 null）。
+ */
+static j_void_t jbench_json_rate(
+                    FILE                  * jfs_json,
+                    const jbench_result_t & jrslt,
+                    j_uint_t                jut_event,
+                    j_cstring_t             jsz_name,
+                    j_cstring_t             jsz_tail)
+{
+    double jdt_rate = 0.0;
+
+    if (jbench_perf_rate(jrslt, jut_event, &jdt_rate))
+        fprintf(jfs_json, " \"%s\": %.4f%s", jsz_name, jdt_rate, jsz_tail);
+    else
+        fprintf(jfs_json, " \"%s\": null%s", jsz_name, jsz_tail);
+}
+
+/**********************************************************/
+/**
+ * @brief 将测试结果 输出为 JSON 。
+ */
+static j_bool_t jbench_json(j_cstring_t jsz_path, j_bool_t jbl_synth)
+{
+    FILE   * jfs_json = (0 == strcmp("-", jsz_path)) ? stdout : fopen(jsz_path, "w");
+    j_uint_t jut_iter = 0;
+    j_uint_t jut_ievt = 0;
+    double   jdt_mpxl = 0.0;
+    double   jdt_mbyt = 0.0;
+
+    if (J_NULL == jfs_json)
+    {
+        printf("open the json file [%s] failed!\n", jsz_path);
+        return J_FALSE;
+    }
+
+    for (jut_iter = 0; jut_iter < (j_uint_t)JVEC_imgs.size(); ++jut_iter)
+    {
+        jdt_mpxl += (double)JVEC_imgs[jut_iter].jinfo.jit_imgw *
+                    JVEC_imgs[jut_iter].jinfo.jit_imgh / 1000000.0;
+        jdt_mbyt += (double)JVEC_imgs[jut_iter].jst_jpeg / 1000000.0;
+    }
+
+    fprintf(jfs_json, "{\n");
+    fprintf(jfs_json, "  \"tool\": \"jbench\",\n");
+    fprintf(jfs_json, "  \"cpus\": %u,\n", jthrd_ncpus());
+    fprintf(jfs_json, "  \"loops\": %u,\n", JUT_loop);
+    fprintf(jfs_json, "  \"corpus\": { \"synthetic\": %s, \"images\": %u, \"megapixels\": %.6f, \"megabytes\": %.6f },\n",
+            jbl_synth ? "true" : "false", (j_uint_t)JVEC_imgs.size(), jdt_mpxl, jdt_mbyt);
+    fprintf(jfs_json, "  \"perf\": { \"enabled\": %s, \"events\": %u },\n",
+            JBL_perf ? "true" : "false", JUT_nevt);
+    fprintf(jfs_json, "  \"results\": [");
+
+    for (jut_iter = 0; jut_iter < (j_uint_t)JVEC_rslt.size(); ++jut_iter)
+    {
+        const jbench_result_t & jrslt = JVEC_rslt[jut_iter];
+
+        fprintf(jfs_json,
+                "%s\n    { \"bench\": \"%s\", \"ccs\": \"%s\", \"mode\": \"%s\", \"quality\": %u,"
+                " \"threads\": %u, \"images\": %u, \"wall_ms\": %.4f, \"mp_per_s\": %.4f,"
+                " \"mb_per_s\": %.4f, \"img_per_s\": %.4f, \"p50_ms\": %.4f, \"p99_ms\": %.4f,"
+                " \"scale\": %.4f",
+                (0 == jut_iter) ? "" : ",",
+                jrslt.jstr_bench.c_str(),
+                jrslt.jstr_ccs.c_str(),
+                jrslt.jstr_mode.c_str(),
+                jrslt.jut_qual,
+                jrslt.jut_nthd,
+                jrslt.jut_nimg,
+                jrslt.jdt_wall * 1000.0,
+                jrslt.jdt_mpxl / jrslt.jdt_wall,
+                jrslt.jdt_mbyt / jrslt.jdt_wall,
+                jrslt.jut_nimg / jrslt.jdt_wall,
+                jrslt.jdt_p50 * 1000.0,
+                jrslt.jdt_p99 * 1000.0,
+                jrslt.jdt_scale);
+
+        // 性能计数值（启用时输出，不可用的事件 为 null）
+        if (JUT_nevt > 0)
+        {
+            fprintf(jfs_json, ", \"counters\": {");
+            for (jut_ievt = 0; jut_ievt < JPERF_EVENT_COUNT; ++jut_ievt)
+            {
+                if (jrslt.jperf.jbl_valid[jut_ievt])
+                    fprintf(jfs_json, " \"%s\": %.0f,", jperf_event_name(jut_ievt), jrslt.jperf.jdt_value[jut_ievt]);
+                else
+                    fprintf(jfs_json, " \"%s\": null,", jperf_event_name(jut_ievt));
+            }
+
+            jbench_json_rate(jfs_json, jrslt, JPERF_EVENT_COUNT, "ipc", ",");
+            jbench_json_rate(jfs_json, jrslt, JPERF_BRANCH_MISS, "branch_misses_per_mp", ",");
+            jbench_json_rate(jfs_json, jrslt, JPERF_L1D_MISS, "l1d_misses_per_mp", ",");
+            jbench_json_rate(jfs_json, jrslt, JPERF_LLC_MISS, "llc_misses_per_mp", " }");
+        }
+
+        fprintf(jfs_json, " }");
+    }
+
+    fprintf(jfs_json, "\n  ]\n}\n");
+
+    if (stdout != jfs_json)
+        fclose(jfs_json);
+
+    return J_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 从 JSON 行中 读取 字符串类型的键值（只适用于 jbench_json() 输出的格式）。
+ */
+static j_bool_t jbench_json_str(const std::string & jstr_line, j_cstring_t jsz_key, std::string & jstr_value)
+{
+    std::string jstr_key = std::string("\"") + jsz_key + "\": \"";
+    j_size_t    jst_bpos = jstr_line.find(jstr_key);
+    j_size_t    jst_epos = 0;
+
+    if (std::string::npos == jst_bpos)
+        return J_FALSE;
+
+    jst_bpos += jstr_key.size();
+    jst_epos  = jstr_line.find('"', jst_bpos);
+    if (std::string::npos == jst_epos)
+        return J_FALSE;
+
+    jstr_value = jstr_line.substr(jst_bpos, jst_epos - jst_bpos);
+    return J_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 从 JSON 行中 读取 数值类型的键值（只适用于 jbench_json() 输出的格式）。
+ */
+static j_bool_t jbench_json_num(const std::string & jstr_line, j_cstring_t jsz_key, double * jdt_value)
+{
+    std::string jstr_key = std::string("\"") + jsz_key + "\": ";
+    j_size_t    jst_bpos = jstr_line.find(jstr_key);
+    j_char_t  * jsz_next = J_NULL;
+    j_cstring_t jsz_bpos = J_NULL;
+
+    if (std::string::npos == jst_bpos)
+        return J_FALSE;
+
+    jsz_bpos   = jstr_line.c_str() + jst_bpos + jstr_key.size();
+    *jdt_value = strtod(jsz_bpos, &jsz_next);
+
+    return (jsz_next != jsz_bpos);
+}
+
+/**********************************************************/
+/**
+ * @brief 测试结果的比对标识（测试类别、色彩空间转换、输入模式、压缩质量、线程数量）。
+ */
+static std::string jbench_result_key(
+                    const std::string & jstr_bench,
+                    const std::string & jstr_ccs,
+                    const std::string & jstr_mode,
+                    j_uint_t            jut_qual,
+                    j_uint_t            jut_nthd)
+{
+    j_char_t jsz_key[160];
+
+    snprintf(jsz_key, sizeof(jsz_key), "%-9s %-14s %-6s %3u %3u",
+             jstr_bench.c_str(), jstr_ccs.c_str(), jstr_mode.c_str(), jut_qual, jut_nthd);
+    return jsz_key;
+}
+
+/**********************************************************/
+/**
+ * @brief 与 基准 JSON 比对各项测试的 MP/s，输出差异表。
+ * @note
+ * 1. 以 测试类别、色彩空间转换、输入模式、压缩质量、线程数量 匹配测试项；
+ * 2. MP/s 下降超过容差（回归），或 本次执行的测试类别中 缺少基准测试项，均视为失败；
+ *    基准中 本次未执行的测试类别 被忽略，基准中没有的测试项 只做提示。
+ * 
+ * @return j_bool_t : 比对是否通过。
+ */
+static j_bool_t jbench_compare(j_cstring_t jsz_path)
+{
+    FILE      * jfs_base = fopen(jsz_path, "r");
+    j_char_t    jsz_line[1024];
+    j_uint_t    jut_iter = 0;
+    j_uint_t    jut_nbad = 0;
+    j_uint_t    jut_nchk = 0;
+    double      jdt_qual = 0.0;
+    double      jdt_nthd = 0.0;
+    double      jdt_base = 0.0;
+    double      jdt_curr = 0.0;
+    double      jdt_diff = 0.0;
+    j_cstring_t jsz_stat = J_NULL;
+
+    std::string jstr_bench;
+    std::string jstr_ccs;
+    std::string jstr_mode;
+    std::vector< std::string > jvec_bkey;
+    std::vector< double      > jvec_base;
+    std::vector< j_bool_t    > jvec_used;
+
+    if (J_NULL == jfs_base)
+    {
+        printf("\nperf gate: open the baseline [%s] failed!\n", jsz_path);
+        return J_FALSE;
+    }
+
+    // jbench_json() 每个测试项 输出为一行
+    while (J_NULL != fgets(jsz_line, sizeof(jsz_line), jfs_base))
+    {
+        std::string jstr_line(jsz_line);
+
+        if (jbench_json_str(jstr_line, "bench", jstr_bench) &&
+            jbench_json_str(jstr_line, "ccs"  , jstr_ccs  ) &&
+            jbench_json_str(jstr_line, "mode" , jstr_mode ) &&
+            jbench_json_num(jstr_line, "quality" , &jdt_qual) &&
+            jbench_json_num(jstr_line, "threads" , &jdt_nthd) &&
+            jbench_json_num(jstr_line, "mp_per_s", &jdt_base))
+        {
+            jvec_bkey.push_back(jbench_result_key(
+                jstr_bench, jstr_ccs, jstr_mode, (j_uint_t)jdt_qual, (j_uint_t)jdt_nthd));
+            jvec_base.push_back(jdt_base);
+            jvec_used.push_back(J_FALSE);
+        }
+    }
+
+    fclose(jfs_base);
+
+    //======================================
+
+    printf("\nperf gate: baseline [%s], %u entries, tolerance %.1f%%\n\n",
+           jsz_path, (j_uint_t)jvec_bkey.size(), JDT_tolr);
+    printf("%-9s %-14s %-6s %3s %3s  %10s  %10s  %8s  %s\n",
+           "bench", "ccs", "mode", "q", "thr", "base MP/s", "curr MP/s", "delta", "status");
+
+    for (jut_iter = 0; jut_iter < (j_uint_t)JVEC_rslt.size(); ++jut_iter)
+    {
+        const jbench_result_t & jrslt = JVEC_rslt[jut_iter];
+        std::string jstr_key = jbench_result_key(
+            jrslt.jstr_bench, jrslt.jstr_ccs, jrslt.jstr_mode, jrslt.jut_qual, jrslt.jut_nthd);
+        std::vector< std::string >::iterator jitr_find =
+            std::find(jvec_bkey.begin(), jvec_bkey.end(), jstr_key);
+
+        jdt_curr = jrslt.jdt_mpxl / jrslt.jdt_wall;
+        if (jitr_find == jvec_bkey.end())
+        {
+            printf("%s  %10s  %10.2f  %8s  new\n", jstr_key.c_str(), "-", jdt_curr, "-");
+            continue;
+        }
+
+        jdt_base = jvec_base[jitr_find - jvec_bkey.begin()];
+        jvec_used[jitr_find - jvec_bkey.begin()] = J_TRUE;
+        jdt_diff = (jdt_base > 0.0) ? (100.0 * (jdt_curr - jdt_base) / jdt_base) : 0.0;
+
+        if (jdt_diff < -JDT_tolr)
+        {
+            jsz_stat  = "REGRESSED";
+            jut_nbad += 1;
+        }
+        else
+        {
+            jsz_stat = (jdt_diff > JDT_tolr) ? "faster" : "ok";
+        }
+
+        jut_nchk += 1;
+        printf("%s  %10.2f  %10.2f  %+7.1f%%  %s\n",
+               jstr_key.c_str(), jdt_base, jdt_curr, jdt_diff, jsz_stat);
+    }
+
+    // 本次执行的测试类别中，基准里有 而本次没有的测试项
+    for (jut_iter = 0; jut_iter < (j_uint_t)jvec_bkey.size(); ++jut_iter)
+    {
+        j_cstring_t jsz_kind = jvec_bkey[jut_iter].c_str();
+
+        if (jvec_used[jut_iter] ||
+            ((J_NULL != JSZ_only) && (0 != strncmp(JSZ_only, jsz_kind, strlen(JSZ_only)))))
+        {
+            continue;
+        }
+
+        jut_nbad += 1;
+        printf("%s  %10.2f  %10s  %8s  MISSING\n", jsz_kind, jvec_base[jut_iter], "-", "-");
+    }
+
+    printf("\nperf gate: %u compared, %u failed => %s\n",
+           jut_nchk, jut_nbad, ((0 == jut_nbad) && (jut_nchk > 0)) ? "PASSED" : "FAILED");
+
+    return ((0 == jut_nbad) && (jut_nchk > 0));
+}
+
+/**********************************************************/
+/**
+ * @brief main function.
+ */
+int main(int argc, char * argv[])
+{
+    j_int_t        jit_iter = 0;
+    j_uint_t       jut_iter = 0;
+    j_int_t        jit_exit = 0;
+    j_bool_t       jbl_synth = J_FALSE;
+    j_cstring_t    jsz_iter = J_NULL;
+    jbench_ctx_t * jctx_ptr = J_NULL;
+
+    std::vector< j_uint_t > jvec_qual;
+
+    //======================================
+    // 解析参数（选项之后的参数 均为输入文件 或 目录）
+
+    for (jit_iter = 1; jit_iter < argc; jit_iter += 2)
+    {
+        if ('-' != argv[jit_iter][0])
+            break;
+
+        // 无参数值的选项
+        if (0 == strcmp("-p", argv[jit_iter]))
+        {
+            JBL_perf  = J_TRUE;
+            jit_iter -= 1;
+            continue;
+        }
+
+        if (jit_iter + 1 >= argc)
+            break;
+
+        if (0 == strcmp("-n", argv[jit_iter]))
+            JUT_nimg = (j_uint_t)strtoul(argv[jit_iter + 1], J_NULL, 0);
+        else if (0 == strcmp("-w", argv[jit_iter]))
+            JUT_imgw = (j_uint_t)strtoul(argv[jit_iter + 1], J_NULL, 0);
+        else if (0 == strcmp("-h", argv[jit_iter]))
+            JUT_imgh = (j_uint_t)strtoul(argv[jit_iter + 1], J_NULL, 0);
+        else if (0 == strcmp("-q", argv[jit_iter]))
+            JSZ_qarr = argv[jit_iter + 1];
+        else if (0 == strcmp("-t", argv[jit_iter]))
+            JUT_nthd = (j_uint_t)strtoul(argv[jit_iter + 1], J_NULL, 0);
+        else if (0 == strcmp("-l", argv[jit_iter]))
+            JUT_loop = (j_uint_t)strtoul(argv[jit_iter + 1], J_NULL, 0);
+        else if (0 == strcmp("-b", argv[jit_iter]))
+            JSZ_only = argv[jit_iter + 1];
+        else if (0 == strcmp("-j", argv[jit_iter]))
+            JSZ_json = argv[jit_iter + 1];
+        else if (0 == strcmp("-c", argv[jit_iter]))
+            JSZ_base = argv[jit_iter + 1];
+        else if (0 == strcmp("-r", argv[jit_iter]))
+            JDT_tolr = strtod(argv[jit_iter + 1], J_NULL);
+        else if (0 == strcmp("-M", argv[jit_iter]))
+            JST_mmax = (j_size_t)strtoull(argv[jit_iter + 1], J_NULL, 0) * 1024;
+        else
+        {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    if ((jit_iter < argc) && ('-' == argv[jit_iter][0]))
+    {
+        usage(argv[0]);
+        return -1;
+    }
+
+    for (jsz_iter = JSZ_qarr; '\0' != *jsz_iter; )
+    {
+        j_char_t * jsz_next = J_NULL;
+        j_ulong_t  jul_qual = strtoul(jsz_iter, &jsz_next, 10);
+
+        if ((jsz_next == jsz_iter) || (jul_qual < 1) || (jul_qual > 100))
+        {
+            usage(argv[0]);
+            return -1;
+        }
+
+        jvec_qual.push_back((j_uint_t)jul_qual);
+        jsz_iter = (',' == *jsz_next) ? (jsz_next + 1) : jsz_next;
+    }
+
+    if ((0 == JUT_loop) || jvec_qual.empty() || (JDT_tolr < 0.0) ||
+        ((J_NULL != JSZ_only) &&
+         (0 != strcmp("decode", JSZ_only)) &&
+         (0 != strcmp("encode", JSZ_only)) &&
+         (0 != strcmp("roundtrip", JSZ_only)) &&
+         (0 != strcmp("stripe", JSZ_only))))
+    {
+        usage(argv[0]);
+        return -1;
+    }
+
+    if (0 == JUT_nthd)
+        JUT_nthd = jthrd_ncpus();
+    if (JUT_nthd > JTHRD_MAX_WORKERS)
+        JUT_nthd = JTHRD_MAX_WORKERS;
+
+    //======================================
+    // 准备测试集
+
+    for (; jit_iter < argc; ++jit_iter)
+    {
+        jbench_load_input(argv[jit_iter]);
+    }
+
+    if (JVEC_imgs.empty())
+    {
+        if ((0 == JUT_nimg) || (0 == JUT_imgw) || (0 == JUT_imgh) || !jbench_synth())
+        {
+            printf("prepare the synthetic corpus failed!\n");
+            return -1;
+        }
+
+        jbl_synth = J_TRUE;
+    }
+
+    // 文件流模式：文件 直接打开，合成图像 写入临时文件（打开操作 不计入耗时）
+    for (jut_iter = 0; jut_iter < (j_uint_t)JVEC_imgs.size(); ++jut_iter)
+    {
+        jbench_img_t & jimg = JVEC_imgs[jut_iter];
+
+        if (!jimg.jstr_path.empty() && !jbl_synth)
+        {
+            jimg.jfs_file = fopen(jimg.jstr_path.c_str(), "rb");
+        }
+        else
+        {
+            jimg.jfs_file = tmpfile();
+            if ((J_NULL != jimg.jfs_file) &&
+                (jimg.jst_jpeg != fwrite(jimg.jmt_jpeg, 1, jimg.jst_jpeg, jimg.jfs_file)))
+            {
+                fclose(jimg.jfs_file);
+                jimg.jfs_file = J_NULL;
+            }
+        }
+
+        if (J_NULL != jimg.jfs_file)
+            fseek(jimg.jfs_file, 0, SEEK_SET);
+    }
+
+    if (jbl_synth)
+    {
+        for (jut_iter = 0; jut_iter < (j_uint_t)JVEC_imgs.size(); ++jut_iter)
+            JVEC_imgs[jut_iter].jstr_path.clear();
+    }
+
+    printf("corpus: %u %s image(s), %u CPU(s), up to %u thread(s), best of %u run(s)\n",
+           (j_uint_t)JVEC_imgs.size(), jbl_synth ? "synthetic" : "input",
+           jthrd_ncpus(), JUT_nthd, JUT_loop);
+
+    // 性能计数器 不可用时，只给出提示，测试照常进行
+    if (JBL_perf)
+    {
+        JUT_nevt = jperf_open(&JPERF_ctr);
+        printf("perf counters: %u of %u event(s) available", JUT_nevt, (j_uint_t)JPERF_EVENT_COUNT);
+        for (jut_iter = 0, jsz_iter = ", missing:"; jut_iter < JPERF_EVENT_COUNT; ++jut_iter)
+        {
+            if (JPERF_ctr.jit_fd[jut_iter] < 0)
+            {
+                printf("%s %s", jsz_iter, jperf_event_name(jut_iter));
+                jsz_iter = "";
+            }
+        }
+        if (0 != JPERF_ctr.jit_errno)
+            printf(" (%s)", strerror(JPERF_ctr.jit_errno));
+        printf("\n");
+    }
+
+    printf("\n");
+
+    jctx_ptr = (jbench_ctx_t *)calloc(1, sizeof(jbench_ctx_t));
+    if (J_NULL == jctx_ptr)
+    {
+        printf("calloc failed!\n");
+        return -1;
+    }
+
+    //======================================
+    // 执行测试
+
+    if ((J_NULL == JSZ_only) || (0 == strcmp("decode", JSZ_only)))
+        jbench_decode(jctx_ptr);
+    if ((J_NULL == JSZ_only) || (0 == strcmp("encode", JSZ_only)))
+        jbench_encode_all(jctx_ptr, jvec_qual, JBENCH_ENCODE);
+    if ((J_NULL == JSZ_only) || (0 == strcmp("roundtrip", JSZ_only)))
+        jbench_roundtrip(jctx_ptr, jvec_qual);
+    if ((J_NULL == JSZ_only) || (0 == strcmp("stripe", JSZ_only)))
+        jbench_encode_all(jctx_ptr, jvec_qual, JBENCH_STRIPE);
+
+    if (J_NULL != JSZ_json)
+    {
+        jbench_json(JSZ_json, jbl_synth);
+    }
+
+    if ((J_NULL != JSZ_base) && !jbench_compare(JSZ_base))
+    {
+        jit_exit = -1;
+    }
+
+    //======================================
+
+    free(jctx_ptr);
+
+    if (JBL_perf)
+    {
+        jperf_close(&JPERF_ctr);
+    }
+
+    for (jut_iter = 0; jut_iter < (j_uint_t)JVEC_imgs.size(); ++jut_iter)
+    {
+        if (J_NULL != JVEC_imgs[jut_iter].jfs_file)
+            fclose(JVEC_imgs[jut_iter].jfs_file);
+        free(JVEC_imgs[jut_iter].jmt_jpeg);
+    }
+
+    return jit_exit;
+}
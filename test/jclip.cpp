@@ -10,9 +10,13 @@
 
 #include "jencoder.h"
 #include "jdecoder.h"
+#include "jtransform.h"
+#include "jthread.h"
 
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <vector>
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -35,6 +39,14 @@ jpeg_cs_t   JCS_oput = JPEG_CS_UNKNOWN;
 
 jrect_t     JRC_area = { 0, 0, 0, 0 };
 j_uint_t    JUT_qual = 75;
+j_bool_t    JBL_lossless = J_FALSE;
+
+j_cstring_t JSZ_batch = J_NULL;  ///< 批量剪切的 矩形区域列表文件（"-" 表示 标准输入）
+j_cstring_t JSZ_tarf  = J_NULL;  ///< 批量剪切时，输出的 tar 归档文件（为 J_NULL 时，各自输出文件）
+j_uint_t    JUT_nthd  = 0;       ///< 批量剪切时，编码使用的 工作线程数量（为 0 时，取 CPU 核心数量）
+
+/** 区域剪切时，逐个条带 解码/编码 的条带像素行数量 */
+#define JCLIP_BAND_ROWS  16
 
 /**********************************************************/
 /**
@@ -63,7 +75,9 @@ void usage(const char * xsz_name)
 {
     printf(
         "usage: %s -i input [-ics colorspace] [-o output] "
-        "[-x xpos] [-y ypos] [-w width] [-h height] [-ocs colorspace] [-q quality]\n"
+        "[-x xpos] [-y ypos] [-w width] [-h height] [-ocs colorspace] [-q quality] [--lossless]\n"
+        "       %s -i input --batch list [-ics colorspace] [-ocs colorspace] [-q quality] "
+        "[-t threads] [--tar archive]\n"
         "       imgW = the input image width;\n"
         "       imgH = the input image height;\n"
         "       -i   : input jpeg image file;\n"
@@ -78,8 +92,20 @@ void usage(const char * xsz_name)
         "       -h   : the height of the clip area, the default is imgH;\n"
         "              if the height is negative, height = max(0, imgH - (abs(height) %% imgH) - y);\n"
         "       -ocs : the output colorspace, default value is -ics.\n"
-        "       -q   : the output image quality[ 1 - 100 ], default value is 75.\n\n",
-        xsz_name);
+        "       -q   : the output image quality[ 1 - 100 ], default value is 75.\n"
+        "       --lossless : crop in the DCT coefficient domain, without decoding and re-encoding;\n"
+        "              the x/y position is snapped down to the iMCU boundary (8 or 16 pixels),\n"
+        "              -ics/-ocs/-q are ignored; full-width strips of an image with restart\n"
+        "              markers are sliced between the markers, without entropy decoding.\n"
+        "       --batch : clip all the areas listed in the file (\"-\" reads stdin), one area\n"
+        "              per line: \"x y w h [output]\" (the separator may be space or comma,\n"
+        "              '#' starts a comment line, x/y/w/h have the same meaning as above),\n"
+        "              the default output is basename(input)_clip_NNNN.jpg; only the rows\n"
+        "              covered by the areas are decoded (once), then all the areas are\n"
+        "              encoded concurrently on the worker threads;\n"
+        "       -t   : the number of worker threads for --batch, default is the CPU count;\n"
+        "       --tar : write all the clipped images of --batch into one tar archive.\n\n",
+        xsz_name, xsz_name);
 
     printf("jpeg colorspace : GRAY, RGB, YCC, CMYK, YCCK, BGRGB, BGYCC.\n\n");
 
@@ -153,10 +179,10 @@ int main(int argc, char * argv[])
 /**********************************************************/
 /**
  * @brief 字符串忽略大小写的比对操作。
- *
+ * 
  * @param [in ] xsz_lcmp : 比较操作的左值字符串。
  * @param [in ] xsz_rcmp : 比较操作的右值字符串。
- *
+ * 
  * @return int
  *         - xsz_lcmp <  xsz_rcmp，返回 <= -1；
  *         - xsz_lcmp == xsz_rcmp，返回 ==  0；
@@ -369,6 +395,34 @@ j_int_t jclip_getopt(j_int_t jit_argc, j_char_t * jsz_argv[])
             continue;
         }
 
+        if (0 == X_stricmp("--lossless", jsz_argv[jit_iter]))
+        {
+            JBL_lossless = J_TRUE;
+            ++jit_iter;
+            continue;
+        }
+
+        if ((0 == X_stricmp("--batch", jsz_argv[jit_iter])) &&
+            ((jit_iter + 1) < jit_argc))
+        {
+            JSZ_batch = jsz_argv[++jit_iter];
+            continue;
+        }
+
+        if ((0 == X_stricmp("--tar", jsz_argv[jit_iter])) &&
+            ((jit_iter + 1) < jit_argc))
+        {
+            JSZ_tarf = jsz_argv[++jit_iter];
+            continue;
+        }
+
+        if ((0 == X_stricmp("-t", jsz_argv[jit_iter])) &&
+            ((jit_iter + 1) < jit_argc))
+        {
+            JUT_nthd = (j_uint_t)strtoul(jsz_argv[++jit_iter], J_NULL, 0);
+            continue;
+        }
+
         ++jit_iter;
     }
 
@@ -382,6 +436,20 @@ j_int_t jclip_getopt(j_int_t jit_argc, j_char_t * jsz_argv[])
         return -1;
     }
 
+    if ((J_NULL != JSZ_batch) && JBL_lossless)
+    {
+        usage(jsz_argv[0]);
+        printf("Error: --batch can not be used together with --lossless!\n");
+        return -1;
+    }
+
+    if ((J_NULL != JSZ_tarf) && (J_NULL == JSZ_batch))
+    {
+        usage(jsz_argv[0]);
+        printf("Error: --tar is only for --batch!\n");
+        return -1;
+    }
+
     //======================================
 
     return 0;
@@ -389,261 +457,904 @@ j_int_t jclip_getopt(j_int_t jit_argc, j_char_t * jsz_argv[])
 
 /**********************************************************/
 /**
- * @brief 图片解码操作。
+ * @brief 按 输入图像的信息 与 -ics/-ocs 参数，确认编码使用的 色彩空间 转换操作值。
  * 
- * @param [in ] jsz_file  : 图片文件路径。
- * @param [out] jmt_pxls  : 操作返回解码得到的像素缓存。
- * @param [out] jinfo_ctx : 操作返回的图片基本信息。
+ * @param [in ] jinfo_ctx : 输入图片的基本信息。
  * @param [out] jenc_ccs  : 返回目标剪切图像使用的编码 色彩空间 转换操作值。
  * 
- * @return j_int_t : 解码操作返回的 错误码（参看 jdec_errno_t）。
+ * @return j_int_t : 错误码（参看 jenc_errno_t）。
+ */
+j_int_t jclip_ccs(const jpeg_info_t & jinfo_ctx, jenc_ccs_t & jenc_ccs)
+{
+    if (JCTL_CS_UNKNOWN == JCS_iput)
+    {
+        JCS_iput = jcs_mapto_ctl(jinfo_ctx.jcs_type);
+    }
+
+    if (JPEG_CS_UNKNOWN == JCS_oput)
+    {
+        JCS_oput = JCTL_CS_TYPE(JCS_iput);
+    }
+
+    jenc_ccs = (jenc_ccs_t)JENC_CCS_MAKE(JCS_iput, JCS_oput);
+    if (!jenc_ccs_valid(jenc_ccs))
+    {
+        printf("clip to colorspace [0x%08X] is invalid!\n", jenc_ccs);
+        return JENC_ERR_CCS_VALUE;
+    }
+
+    return JENC_ERR_OK;
+}
+
+/**********************************************************/
+/**
+ * @brief 按水平条带 解码裁剪区域所在的像素行，并逐个条带 编码输出裁剪区域。
+ * @note
+ * 1. 裁剪区域之上的像素行，解码至条带缓存的首行后丢弃；
+ * 2. 读完裁剪区域的最后一行后，即中止解码器（jdec_abort()），其后的像素行 不再解码；
+ * 3. 条带缓存只有 JCLIP_BAND_ROWS 个（图像宽度的）像素行，与图像高度、裁剪高度 均无关。
+ * 
+ * @param [in ] jdecoder  : 已配置好输入源的 解码器。
+ * @param [in ] jinfo_ctx : 图象基本信息。
+ * @param [in ] jrc_area  : 编码输出的图片裁剪区域。
+ * @param [in ] jenc_ccs  : 编码 色彩空间 转换操作值。
+ * @param [in ] jsz_file  : 输出图片的文件路径。
+ * 
+ * @return j_int_t : 错误码（参看 jdec_errno_t 或 jenc_errno_t）。
  */
-j_int_t jclip_decode(
-            j_cstring_t   jsz_file,
-            j_mptr_t    & jmt_pxls,
-            jpeg_info_t & jinfo_ctx,
-            jenc_ccs_t  & jenc_ccs)
+j_int_t jclip_banded(
+            jdecoder_t        & jdecoder,
+            const jpeg_info_t & jinfo_ctx,
+            const jrect_t     & jrc_area,
+            jenc_ccs_t          jenc_ccs,
+            j_cstring_t         jsz_file)
 {
-    j_int_t    jit_err = JDEC_ERR_UNKNOWN;
-    jdecoder_t jdecoder;
+    j_int_t    jit_err  = JDEC_ERR_UNKNOWN;
+    j_int_t    jit_step = JENC_CCS_NUMC(jenc_ccs) * jinfo_ctx.jit_imgw;
+    j_int_t    jit_offs = JENC_CCS_NUMC(jenc_ccs) * jrc_area.jit_x;
+    j_int_t    jit_rows = 0;
+    j_int_t    jit_done = 0;
+    j_bool_t   jbl_work = J_FALSE;
+    j_mptr_t   jmt_band = J_NULL;
+    jencoder_t jencoder;
+
+    //======================================
+
+    jmt_band = (j_mptr_t)malloc((j_size_t)jit_step * JCLIP_BAND_ROWS);
+    if (J_NULL == jmt_band)
+    {
+        printf("malloc() return J_NULL!\n");
+        return JDEC_ERR_MALLOC;
+    }
 
     do
     {
         //======================================
-        // 配置图像输入源
+        // 启动 编码器 与 解码器
+
+        jit_err = jencoder.config(JCTL_MODE_FSZPATH, (j_fhandle_t)jsz_file, 0, JUT_qual);
+        if (JENC_ERR_OK != jit_err)
+        {
+            printf(
+                "jencoder.config(, [%s], ) return error: %s\n",
+                jsz_file,
+                jenc_errno_name(jit_err));
+            break;
+        }
 
-        jit_err = jdecoder.config(JCTL_MODE_FSZPATH, (j_fhandle_t)jsz_file, 0);
+        jit_err = jdecoder.start(JCS_iput);
         if (JDEC_ERR_OK != jit_err)
         {
             printf(
-                "jdecoder.config(, [%s],) return error: %s\n",
+                "jdecoder.start() [%s] return error: %s\n",
                 JSZ_iput,
                 jdec_errno_name(jit_err));
             break;
         }
 
-        //======================================
-        // 获取图像基本信息
+        jbl_work = J_TRUE;
 
-        jit_err = jdecoder.info(&jinfo_ctx);
-        if (JDEC_ERR_OK != jit_err)
+        jit_err = jencoder.start(jenc_ccs, jrc_area.jit_w, jrc_area.jit_h);
+        if (JENC_ERR_OK != jit_err)
         {
             printf(
-                "jdecoder.config(, [%s],) return error: %s\n",
-                JSZ_iput,
-                jdec_errno_name(jit_err));
+                "jencoder.start([%s], ...) return error: %s\n",
+                jenc_ccs_name(jenc_ccs),
+                jenc_errno_name(jit_err));
             break;
         }
 
-        printf(
-            "image[%s] info: [w: %d, h: %d, nc: %d, cs: %s]\n",
-            JSZ_iput,
-            jinfo_ctx.jit_imgw,
-            jinfo_ctx.jit_imgh,
-            jinfo_ctx.jit_nchs,
-            jpeg_cs_name(jinfo_ctx.jcs_type));
+        //======================================
+        // 跳过 裁剪区域之上的像素行（步长为 0，都解码至条带缓存的首行）
+
+        if (jrc_area.jit_y > 0)
+        {
+            jit_err = jdecoder.read(jmt_band, 0, jrc_area.jit_y);
+            if (jit_err != jrc_area.jit_y)
+            {
+                printf(
+                    "jdecoder.read() return error: %s\n",
+                    jdec_errno_name((jit_err < 0) ? jit_err : JDEC_ERR_OUT_EMPTY));
+                jit_err = (jit_err < 0) ? jit_err : JDEC_ERR_OUT_EMPTY;
+                break;
+            }
+        }
 
         //======================================
-        // 为后续编码操作，确认像素的 色彩空间 转换是否有效
+        // 逐个条带 解码、编码
 
-        if (JCTL_CS_UNKNOWN == JCS_iput)
+        for (jit_done = 0; jit_done < jrc_area.jit_h; jit_done += jit_rows)
         {
-            JCS_iput = jcs_mapto_ctl(jinfo_ctx.jcs_type);
+            jit_rows = jrc_area.jit_h - jit_done;
+            if (jit_rows > JCLIP_BAND_ROWS)
+                jit_rows = JCLIP_BAND_ROWS;
+
+            jit_rows = jdecoder.read(jmt_band, jit_step, jit_rows);
+            if (jit_rows <= 0)
+            {
+                jit_err = (jit_rows < 0) ? jit_rows : JDEC_ERR_OUT_EMPTY;
+                printf("jdecoder.read() return error: %s\n", jdec_errno_name(jit_err));
+                break;
+            }
+
+            jit_err = jencoder.write(jmt_band + jit_offs, jit_step, jit_rows);
+            if (jit_err < 0)
+            {
+                printf("jencoder.write() return error: %s\n", jenc_errno_name(jit_err));
+                break;
+            }
         }
 
-        if (JPEG_CS_UNKNOWN == JCS_oput)
+        if (jit_done < jrc_area.jit_h)
         {
-            JCS_oput = JCTL_CS_TYPE(JCS_iput);
+            break;
         }
 
-        jenc_ccs = (jenc_ccs_t)JENC_CCS_MAKE(JCS_iput, JCS_oput);
-        if (!jenc_ccs_valid(jenc_ccs))
+        jit_err = jencoder.finish();
+        if (jit_err < 0)
         {
-            printf("clip to colorspace [0x%08X] is invalid!\n", jenc_ccs);
-            jit_err = JENC_ERR_CCS_VALUE;
+            printf("jencoder.finish() return error: %s\n", jenc_errno_name(jit_err));
             break;
         }
 
         //======================================
-        // 分配解码输出像素缓存
+        // 裁剪区域到达图像底部时，正常结束解码；否则中止，其后的像素行 不再解码
 
-        jmt_pxls = (j_mptr_t)malloc(
-            JENC_CCS_NUMC(jenc_ccs) * jinfo_ctx.jit_imgw * jinfo_ctx.jit_imgh);
-        if (J_NULL == jmt_pxls)
+        jbl_work = J_FALSE;
+        if ((jrc_area.jit_y + jrc_area.jit_h) >= jinfo_ctx.jit_imgh)
+            jit_err = jdecoder.finish();
+        else
+            jit_err = jdecoder.abort();
+
+        if (JDEC_ERR_OK != jit_err)
         {
-            printf("malloc() return J_NULL!\n");
-            jit_err = JDEC_ERR_MALLOC;
+            printf("jdecoder.finish() return error: %s\n", jdec_errno_name(jit_err));
             break;
         }
 
+        printf("output image file: %s\n", jsz_file);
+
         //======================================
-        // 解码操作
+        jit_err = JDEC_ERR_OK;
+    } while (0);
 
-        jit_err = jdecoder.decode_image(
-                                JCS_iput,
-                                jmt_pxls,
-                                JENC_CCS_NUMC(jenc_ccs) * jinfo_ctx.jit_imgw);
-        if (jit_err < 0)
+    if (jbl_work)
+    {
+        jdecoder.abort();
+    }
+
+    free(jmt_band);
+
+    return jit_err;
+}
+
+/**********************************************************/
+/**
+ * @brief 按图像尺寸 修正 剪裁区域 的矩形参数（负值 的含义参看 usage()）。
+ * 
+ * @return j_bool_t : 修正后的 剪裁区域 是否为非空区域。
+ */
+j_bool_t jclip_area_fix(jrect_t & jrc_area, j_int_t jit_imgw, j_int_t jit_imgh)
+{
+    if ((0 == jrc_area.jit_x) && (0 == jrc_area.jit_y) &&
+        (0 == jrc_area.jit_w) && (0 == jrc_area.jit_h))
+    {
+        jrc_area.jit_x = 0;
+        jrc_area.jit_y = 0;
+        jrc_area.jit_w = jit_imgw;
+        jrc_area.jit_h = jit_imgh;
+    }
+    else
+    {
+#define JRC_MOD(jval, jmod) ((jmod) - ((-(jval)) % jmod))
+        if (jrc_area.jit_x < 0)
         {
-            printf(
-                "jdecoder.decode_image() return error: %s\n",
-                jdec_errno_name(jit_err));
-            break;
+            jrc_area.jit_x = JRC_MOD(jrc_area.jit_x, jit_imgw);
         }
-
-        if (0 == jit_err)
+        if (jrc_area.jit_y < 0)
+        {
+            jrc_area.jit_y = JRC_MOD(jrc_area.jit_y, jit_imgh);
+        }
+        if (jrc_area.jit_w < 0)
         {
-            printf("input image [%s] is empty!\n", JSZ_iput);
-            jit_err = JDEC_ERR_OUT_EMPTY;
+            jrc_area.jit_w = JRC_MOD(jrc_area.jit_w, jit_imgw) - jrc_area.jit_x;
+            if (jrc_area.jit_w < 0)
+                jrc_area.jit_w = 0;
         }
+        if (jrc_area.jit_h < 0)
+        {
+            jrc_area.jit_h = JRC_MOD(jrc_area.jit_h, jit_imgh) - jrc_area.jit_y;
+            if (jrc_area.jit_h < 0)
+                jrc_area.jit_h = 0;
+        }
+#undef JRC_MOD
 
-        jit_err = JDEC_ERR_OK;
+        if ((jrc_area.jit_x + jrc_area.jit_w) > jit_imgw)
+            jrc_area.jit_w = jit_imgw - jrc_area.jit_x;
+        if ((jrc_area.jit_y + jrc_area.jit_h) > jit_imgh)
+            jrc_area.jit_h = jit_imgh - jrc_area.jit_y;
+    }
 
-        //======================================
-    } while (0);
+    return ((jrc_area.jit_w > 0) && (jrc_area.jit_h > 0));
+}
 
-    if (JDEC_ERR_OK != jit_err)
+/**********************************************************/
+/**
+ * @brief 确认 剪裁区域 的矩形参数。
+ */
+j_bool_t jclip_area(j_int_t jit_imgw, j_int_t jit_imgh)
+{
+    //======================================
+
+    if (!jclip_area_fix(JRC_area, jit_imgw, jit_imgh))
     {
-        if (J_NULL != jmt_pxls)
+        printf(
+            "Error: the clip area[%d, %d, %d, %d] is empty!\n",
+            JRC_area.jit_x,
+            JRC_area.jit_y,
+            JRC_area.jit_w,
+            JRC_area.jit_h);
+        return J_FALSE;
+    }
+
+    printf(
+        "the clip area is [%d, %d, %d, %d]\n",
+        JRC_area.jit_x,
+        JRC_area.jit_y,
+        JRC_area.jit_w,
+        JRC_area.jit_h);
+
+    //======================================
+
+    return J_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 读取整个文件的数据（返回的缓存，由调用方 free() 释放）。
+ */
+static j_mptr_t jclip_load_file(j_cstring_t jsz_path, j_size_t * jst_size)
+{
+    FILE   * jfs_file = fopen(jsz_path, "rb");
+    j_mptr_t jmt_data = J_NULL;
+    long     jlt_size = 0;
+
+    if (J_NULL == jfs_file)
+    {
+        return J_NULL;
+    }
+
+    if ((0 == fseek(jfs_file, 0, SEEK_END)) && ((jlt_size = ftell(jfs_file)) > 0))
+    {
+        fseek(jfs_file, 0, SEEK_SET);
+        jmt_data = (j_mptr_t)malloc((j_size_t)jlt_size);
+        if ((J_NULL != jmt_data) &&
+            ((j_size_t)jlt_size != fread(jmt_data, 1, (j_size_t)jlt_size, jfs_file)))
         {
-            free(jmt_pxls);
-            jmt_pxls = J_NULL;
+            free(jmt_data);
+            jmt_data = J_NULL;
         }
     }
 
-    return jit_err;
+    fclose(jfs_file);
+
+    *jst_size = (j_size_t)jlt_size;
+    return jmt_data;
 }
 
 /**********************************************************/
 /**
- * @brief 对图片裁剪区域进行编码输出操作。
- * 
- * @param [in ] jsz_file  : 输出图片的文件路径。
- * @param [in ] jmt_pxls  : 待编码的图像像素缓存。
- * @param [in ] jinfo_ctx : 图象基本信息。
- * @param [in ] jrc_area  : 编码输出的图片裁剪区域。
- * @param [in ] jenc_ccs  : 编码 色彩空间 转换操作值。
- * 
- * @return j_int_t : 解码操作返回的 错误码（参看 jdec_errno_t）。
+ * @brief 在 DCT 系数域内执行区域剪切工作（无损，不经过 解码/编码）。
  */
-j_int_t jclip_encode(
-            j_cstring_t         jsz_file,
-            j_mptr_t            jmt_pxls,
-            const jpeg_info_t & jinfo_ctx,
-            const jrect_t     & jrc_area,
-            jenc_ccs_t          jenc_ccs)
+j_int_t jclip_lossless(void)
 {
-    j_int_t    jit_err = JENC_ERR_UNKNOWN;
-    jencoder_t jencoder;
-
-    j_int_t    jit_step;
-    j_int_t    jit_offs;
+    j_int_t       jit_err = JTRANS_ERR_UNKNOWN;
+    j_mptr_t      jmt_data = J_NULL;
+    j_size_t      jst_size = 0;
+    jpeg_info_t   jinfo_ctx;
+    j_rect_t      jrc_area;
+    jdecoder_t    jdecoder;
+    jtransform_t  jtransform;
 
     //======================================
+    // 获取图像基本信息
 
-    jit_err = jencoder.config(JCTL_MODE_FSZPATH, (j_fhandle_t)jsz_file, 0, JUT_qual);
-    if (JENC_ERR_OK != jit_err)
+    jit_err = jdecoder.config(JCTL_MODE_FSZPATH, (j_fhandle_t)JSZ_iput, 0);
+    if (JDEC_ERR_OK == jit_err)
+    {
+        jit_err = jdecoder.info(&jinfo_ctx);
+    }
+
+    if (JDEC_ERR_OK != jit_err)
     {
         printf(
-            "jencoder.config(, [%s], ) return error: %s\n",
-            jsz_file,
-            jenc_errno_name(jit_err));
+            "jdecoder.info() [%s] return error: %s\n",
+            JSZ_iput,
+            jdec_errno_name(jit_err));
         return jit_err;
     }
 
-    jit_step = JENC_CCS_NUMC(jenc_ccs) * jinfo_ctx.jit_imgw;
-    jit_offs = jit_step * jrc_area.jit_y + JENC_CCS_NUMC(jenc_ccs) * jrc_area.jit_x;
+    printf(
+        "image[%s] info: [w: %d, h: %d, nc: %d, cs: %s]\n",
+        JSZ_iput,
+        jinfo_ctx.jit_imgw,
+        jinfo_ctx.jit_imgh,
+        jinfo_ctx.jit_nchs,
+        jpeg_cs_name(jinfo_ctx.jcs_type));
 
-    jit_err = jencoder.encode_image(
-                    jenc_ccs,
-                    jmt_pxls + jit_offs,
-                    jit_step,
-                    jrc_area.jit_w,
-                    jrc_area.jit_h);
-    if (JENC_ERR_OK != jit_err)
+    //======================================
+    // 裁剪区域 和 输出图片的文件路径
+
+    if (!jclip_area(jinfo_ctx.jit_imgw, jinfo_ctx.jit_imgh))
+    {
+        return -1;
+    }
+
+    if ('\0' == JSZ_oput[0])
+    {
+        jclip_ofile_path(J_NULL);
+    }
+
+    //======================================
+    // 执行无损剪切
+
+    jrc_area.jit_x = JRC_area.jit_x;
+    jrc_area.jit_y = JRC_area.jit_y;
+    jrc_area.jit_w = JRC_area.jit_w;
+    jrc_area.jit_h = JRC_area.jit_h;
+
+    // 以 内存模式 输入，带有 重启标记 的图像 剪切水平条带时，可走 按字节切分 的快速路径
+    jmt_data = jclip_load_file(JSZ_iput, &jst_size);
+    if (J_NULL == jmt_data)
+    {
+        printf("read input file [%s] failed!\n", JSZ_iput);
+        return -1;
+    }
+
+    jit_err = jtransform.config_input(JCTL_MODE_FMEMORY, (j_fhandle_t)jmt_data, jst_size);
+    if (JTRANS_ERR_OK == jit_err)
+    {
+        jit_err = jtransform.config_output(JCTL_MODE_FSZPATH, (j_fhandle_t)JSZ_oput, 0);
+    }
+
+    if (JTRANS_ERR_OK == jit_err)
+    {
+        jit_err = jtransform.crop(&jrc_area);
+    }
+
+    free(jmt_data);
+
+    if (JTRANS_ERR_OK != jit_err)
     {
         printf(
-            "jencoder.encode_image([%s], ...) return error: %s\n",
-            jenc_ccs_name(jenc_ccs),
-            jenc_errno_name(jit_err));
+            "jtransform.crop() [%s] return error: %s\n",
+            JSZ_iput,
+            jtrans_errno_name(jit_err));
         return jit_err;
     }
 
-    printf("output image file: %s\n", jsz_file);
+    printf(
+        "the lossless clip area is [%d, %d, %d, %d]\n",
+        jrc_area.jit_x,
+        jrc_area.jit_y,
+        jrc_area.jit_w,
+        jrc_area.jit_h);
+    printf("output image file: %s\n", JSZ_oput);
 
     //======================================
 
     return jit_err;
 }
 
+/**
+ * @struct jclip_item_t
+ * @brief  批量剪切时，单个剪切区域的工作参数。
+ */
+typedef struct jclip_item_t
+{
+    j_uint_t    jut_line;       ///< 在列表文件中的行号
+    jrect_t     jrc_area;       ///< 剪切区域（已按图像尺寸修正）
+    j_char_t    jsz_path[256];  ///< 输出文件路径（tar 归档时，取其文件名 作为成员名）
+    j_mptr_t    jmt_data;       ///< tar 归档时，编码输出的缓存
+    j_size_t    jst_mlen;       ///< tar 归档时，编码输出的缓存容量
+} jclip_item_t;
+
 /**********************************************************/
 /**
- * @brief 确认 剪裁区域 的矩形参数。
+ * @brief 读取 剪切区域列表（每行 "x y w h [output]"，'#' 开头的为注释行）。
+ * 
+ * @param [in ] jsz_list  : 列表文件路径（"-" 表示 标准输入）。
+ * @param [in ] jinfo_ctx : 输入图片的基本信息（用于修正剪切区域）。
+ * @param [out] jvec_item : 返回读取到的 各个有效剪切区域。
+ * 
+ * @return j_int_t : 成功，返回 0；失败，返回 -1 。
  */
-j_bool_t jclip_area(j_int_t jit_imgw, j_int_t jit_imgh)
+j_int_t jclip_batch_list(
+            j_cstring_t                  jsz_list,
+            const jpeg_info_t          & jinfo_ctx,
+            std::vector< jclip_item_t > & jvec_item)
+{
+    FILE       * jfs_list = J_NULL;
+    j_char_t     jsz_line[1024];
+    j_char_t   * jsz_iter = J_NULL;
+    j_char_t     jsz_name[256];
+    j_uint_t     jut_line = 0;
+    j_int_t      jit_nfld = 0;
+    jclip_item_t jitem;
+
+    if (0 == strcmp("-", jsz_list))
+    {
+        jfs_list = stdin;
+    }
+    else
+    {
+        jfs_list = fopen(jsz_list, "r");
+        if (J_NULL == jfs_list)
+        {
+            printf("open the area list file [%s] failed!\n", jsz_list);
+            return -1;
+        }
+    }
+
+    while (J_NULL != fgets(jsz_line, sizeof(jsz_line), jfs_list))
+    {
+        jut_line += 1;
+
+        for (jsz_iter = jsz_line; '\0' != *jsz_iter; ++jsz_iter)
+        {
+            if (',' == *jsz_iter)
+                *jsz_iter = ' ';
+        }
+
+        for (jsz_iter = jsz_line; (' ' == *jsz_iter) || ('\t' == *jsz_iter); ++jsz_iter)
+        {
+        }
+
+        if (('#' == *jsz_iter) || ('\r' == *jsz_iter) ||
+            ('\n' == *jsz_iter) || ('\0' == *jsz_iter))
+        {
+            continue;
+        }
+
+        memset(&jitem, 0, sizeof(jclip_item_t));
+        jsz_name[0] = '\0';
+
+        jit_nfld = sscanf(jsz_iter, "%d %d %d %d %255s",
+                          &jitem.jrc_area.jit_x,
+                          &jitem.jrc_area.jit_y,
+                          &jitem.jrc_area.jit_w,
+                          &jitem.jrc_area.jit_h,
+                          jsz_name);
+        if (jit_nfld < 4)
+        {
+            printf("line %u of the area list is invalid, skipped!\n", jut_line);
+            continue;
+        }
+
+        if (!jclip_area_fix(jitem.jrc_area, jinfo_ctx.jit_imgw, jinfo_ctx.jit_imgh))
+        {
+            printf("line %u : the clip area is empty, skipped!\n", jut_line);
+            continue;
+        }
+
+        jitem.jut_line = jut_line;
+        if ('\0' != jsz_name[0])
+        {
+            strcpy(jitem.jsz_path, jsz_name);
+        }
+        else
+        {
+            // 默认的输出文件名：basename(input)_clip_NNNN.jpg
+            jsz_iter = (j_char_t *)X_basename(JSZ_iput);
+            jit_nfld = (J_NULL != strrchr(jsz_iter, '.')) ?
+                            (j_int_t)(strrchr(jsz_iter, '.') - jsz_iter) : (j_int_t)strlen(jsz_iter);
+            snprintf(jitem.jsz_path, sizeof(jitem.jsz_path),
+                     "%.*s_clip_%04u.jpg", (jit_nfld < 200) ? jit_nfld : 200,
+                     jsz_iter, (j_uint_t)jvec_item.size());
+        }
+
+        jvec_item.push_back(jitem);
+    }
+
+    if (stdin != jfs_list)
+    {
+        fclose(jfs_list);
+    }
+
+    return 0;
+}
+
+/**********************************************************/
+/**
+ * @brief 向 tar 归档文件 写入一个成员文件（ustar 格式）。
+ * 
+ * @return j_bool_t : 是否写入成功。
+ */
+j_bool_t jclip_tar_write(
+            FILE      * jfs_tarf,
+            j_cstring_t jsz_name,
+            j_mptr_t    jmt_data,
+            j_size_t    jst_size)
 {
+    j_byte_t jbt_head[512];
+    j_uint_t jut_iter = 0;
+    j_uint_t jut_csum = 0;
+    j_size_t jst_tail = (512 - (jst_size % 512)) % 512;
+
+    memset(jbt_head, 0, sizeof(jbt_head));
+
+    strncpy((j_char_t *)jbt_head, X_basename(jsz_name), 99);
+    memcpy(jbt_head + 100, "0000644", 8);
+    memcpy(jbt_head + 108, "0000000", 8);
+    memcpy(jbt_head + 116, "0000000", 8);
+    sprintf((j_char_t *)jbt_head + 124, "%011llo", (unsigned long long)jst_size);
+    sprintf((j_char_t *)jbt_head + 136, "%011llo", (unsigned long long)time(J_NULL));
+    memset(jbt_head + 148, ' ', 8);
+    jbt_head[156] = '0';
+    memcpy(jbt_head + 257, "ustar", 6);
+    memcpy(jbt_head + 263, "00", 2);
+
+    for (jut_iter = 0; jut_iter < 512; ++jut_iter)
+        jut_csum += jbt_head[jut_iter];
+    sprintf((j_char_t *)jbt_head + 148, "%06o", jut_csum);
+    jbt_head[155] = ' ';
+
+    if ((512 != fwrite(jbt_head, 1, 512, jfs_tarf)) ||
+        (jst_size != fwrite(jmt_data, 1, jst_size, jfs_tarf)))
+    {
+        return J_FALSE;
+    }
+
+    memset(jbt_head, 0, sizeof(jbt_head));
+    return (jst_tail == fwrite(jbt_head, 1, jst_tail, jfs_tarf));
+}
+
+/**********************************************************/
+/**
+ * @brief 批量剪切工作：只解码一次（全部剪切区域所覆盖的像素行），
+ *        再由多个工作线程 并行编码输出各个剪切区域。
+ */
+j_int_t jclip_batch(void)
+{
+    j_int_t      jit_err  = JDEC_ERR_UNKNOWN;
+    j_int_t      jit_nsuc = 0;
+    j_uint_t     jut_iter = 0;
+    j_uint_t     jut_nitm = 0;
+    j_uint_t     jut_ypos = 0;
+    j_uint_t     jut_yend = 0;
+    j_int_t      jit_step = 0;
+    j_mptr_t     jmt_band = J_NULL;
+    FILE       * jfs_tarf = J_NULL;
+    double       jdt_tick = 0.0;
+    double       jdt_tdec = 0.0;
+    double       jdt_tenc = 0.0;
+    double       jdt_tsum = 0.0;
+    jpeg_info_t  jinfo_ctx;
+    jenc_ccs_t   jenc_ccs = JENC_CCS_UNKNOWN;
+    jdecoder_t   jdecoder;
+
+    std::vector< jclip_item_t > jvec_item;
+    std::vector< j_rect_t     > jvec_rect;
+    std::vector< jenc_job_t   > jvec_job;
+
+    jdt_tick = jthrd_clock();
+
     //======================================
+    // 图像基本信息 与 色彩空间转换
 
-    if ((0 == JRC_area.jit_x) && (0 == JRC_area.jit_y) &&
-        (0 == JRC_area.jit_w) && (0 == JRC_area.jit_h))
+    jit_err = jdecoder.config(JCTL_MODE_FSZPATH, (j_fhandle_t)JSZ_iput, 0);
+    if (JDEC_ERR_OK == jit_err)
     {
-        JRC_area.jit_x = 0;
-        JRC_area.jit_y = 0;
-        JRC_area.jit_w = jit_imgw;
-        JRC_area.jit_h = jit_imgh;
+        jit_err = jdecoder.info(&jinfo_ctx);
     }
-    else
+
+    if (JDEC_ERR_OK != jit_err)
     {
-#define JRC_MOD(jval, jmod) ((jmod) - ((-(jval)) % jmod))
-        if (JRC_area.jit_x < 0)
+        printf(
+            "jdecoder.info() [%s] return error: %s\n",
+            JSZ_iput,
+            jdec_errno_name(jit_err));
+        return jit_err;
+    }
+
+    printf(
+        "image[%s] info: [w: %d, h: %d, nc: %d, cs: %s]\n",
+        JSZ_iput,
+        jinfo_ctx.jit_imgw,
+        jinfo_ctx.jit_imgh,
+        jinfo_ctx.jit_nchs,
+        jpeg_cs_name(jinfo_ctx.jcs_type));
+
+    jit_err = jclip_ccs(jinfo_ctx, jenc_ccs);
+    if (JENC_ERR_OK != jit_err)
+    {
+        return jit_err;
+    }
+
+    //======================================
+    // 读取剪切区域列表，并计算其覆盖的 像素行 范围
+
+    if (0 != jclip_batch_list(JSZ_batch, jinfo_ctx, jvec_item))
+    {
+        return -1;
+    }
+
+    jut_nitm = (j_uint_t)jvec_item.size();
+    if (0 == jut_nitm)
+    {
+        printf("Error: no valid clip area in the list [%s]!\n", JSZ_batch);
+        return -1;
+    }
+
+    jut_ypos = (j_uint_t)jinfo_ctx.jit_imgh;
+    jut_yend = 0;
+    for (jut_iter = 0; jut_iter < jut_nitm; ++jut_iter)
+    {
+        const jrect_t & jrc_area = jvec_item[jut_iter].jrc_area;
+
+        if ((j_uint_t)jrc_area.jit_y < jut_ypos)
+            jut_ypos = (j_uint_t)jrc_area.jit_y;
+        if ((j_uint_t)(jrc_area.jit_y + jrc_area.jit_h) > jut_yend)
+            jut_yend = (j_uint_t)(jrc_area.jit_y + jrc_area.jit_h);
+    }
+
+    //======================================
+    // 只解码 [jut_ypos, jut_yend) 范围的像素行（只解码一次）
+
+    jit_step = JENC_CCS_NUMC(jenc_ccs) * jinfo_ctx.jit_imgw;
+    jmt_band = (j_mptr_t)malloc((j_size_t)jit_step * (jut_yend - jut_ypos));
+    if (J_NULL == jmt_band)
+    {
+        printf("malloc() return J_NULL!\n");
+        return JDEC_ERR_MALLOC;
+    }
+
+    jdt_tdec = jthrd_clock();
+    jit_err = jdecoder.decode_rows(JCS_iput, jut_ypos, jut_yend - jut_ypos, jmt_band, jit_step);
+    jdt_tdec = jthrd_clock() - jdt_tdec;
+    if (jit_err < 0)
+    {
+        printf(
+            "jdecoder.decode_rows() return error: %s\n",
+            jdec_errno_name(jit_err));
+        goto __EXIT_FUNC;
+    }
+
+    //======================================
+    // 并行编码各个剪切区域
+
+    jvec_rect.resize(jut_nitm);
+    jvec_job.resize(jut_nitm);
+    memset(&jvec_job[0], 0, jut_nitm * sizeof(jenc_job_t));
+
+    for (jut_iter = 0; jut_iter < jut_nitm; ++jut_iter)
+    {
+        jclip_item_t & jitem = jvec_item[jut_iter];
+
+        jvec_rect[jut_iter].jit_x = jitem.jrc_area.jit_x;
+        jvec_rect[jut_iter].jit_y = jitem.jrc_area.jit_y - (j_int_t)jut_ypos;
+        jvec_rect[jut_iter].jit_w = jitem.jrc_area.jit_w;
+        jvec_rect[jut_iter].jit_h = jitem.jrc_area.jit_h;
+
+        jvec_job[jut_iter].jut_qual = JUT_qual;
+
+        if (J_NULL == JSZ_tarf)
         {
-            JRC_area.jit_x = JRC_MOD(JRC_area.jit_x, jit_imgw);
+            jvec_job[jut_iter].jct_mode = JCTL_MODE_FSZPATH;
+            jvec_job[jut_iter].jht_optr = (j_fhandle_t)jitem.jsz_path;
+            continue;
         }
-        if (JRC_area.jit_y < 0)
+
+        // tar 归档时，先编码输出至内存（容量不足的，按所需容量 重新编码）
+        jitem.jst_mlen = (j_size_t)JENC_CCS_NUMC(jenc_ccs) *
+                         jitem.jrc_area.jit_w * jitem.jrc_area.jit_h + 4096;
+        jitem.jmt_data = (j_mptr_t)malloc(jitem.jst_mlen);
+        if (J_NULL == jitem.jmt_data)
         {
-            JRC_area.jit_y = JRC_MOD(JRC_area.jit_y, jit_imgh);
+            printf("malloc() return J_NULL!\n");
+            jit_err = JENC_ERR_MALLOC;
+            goto __EXIT_FUNC;
         }
-        if (JRC_area.jit_w < 0)
+
+        jvec_job[jut_iter].jct_mode = JCTL_MODE_FMEMORY;
+        jvec_job[jut_iter].jht_optr = (j_fhandle_t)jitem.jmt_data;
+        jvec_job[jut_iter].jst_mlen = jitem.jst_mlen;
+    }
+
+    jdt_tenc = jthrd_clock();
+    jit_nsuc = jenc_crops(
+                    jenc_ccs,
+                    jmt_band,
+                    jit_step,
+                    jinfo_ctx.jit_imgw,
+                    jut_yend - jut_ypos,
+                    &jvec_rect[0],
+                    &jvec_job[0],
+                    jut_nitm,
+                    JUT_nthd);
+
+    for (jut_iter = 0; (jit_nsuc >= 0) && (jut_iter < jut_nitm); ++jut_iter)
+    {
+        jclip_item_t & jitem = jvec_item[jut_iter];
+        jenc_job_t   & jjob  = jvec_job[jut_iter];
+        double         jdt_tone = jjob.jdt_time;
+
+        if ((JENC_ERR_OVERFLOW != jjob.jit_err) || (J_NULL == JSZ_tarf))
+            continue;
+
+        free(jitem.jmt_data);
+        jitem.jst_mlen = jjob.jst_size;
+        jitem.jmt_data = (j_mptr_t)malloc(jitem.jst_mlen);
+        if (J_NULL == jitem.jmt_data)
+            continue;
+
+        jjob.jht_optr = (j_fhandle_t)jitem.jmt_data;
+        jjob.jst_mlen = jitem.jst_mlen;
+        if (1 == jenc_crops(jenc_ccs, jmt_band, jit_step, jinfo_ctx.jit_imgw,
+                            jut_yend - jut_ypos, &jvec_rect[jut_iter], &jjob, 1, 1))
         {
-            JRC_area.jit_w = JRC_MOD(JRC_area.jit_w, jit_imgw) - JRC_area.jit_x;
-            if (JRC_area.jit_w < 0)
-                JRC_area.jit_w = 0;
+            jit_nsuc += 1;
         }
-        if (JRC_area.jit_h < 0)
+
+        jjob.jdt_time += jdt_tone;
+    }
+    jdt_tenc = jthrd_clock() - jdt_tenc;
+
+    if (jit_nsuc < 0)
+    {
+        printf("jenc_crops() return error: %s\n", jenc_errno_name(jit_nsuc));
+        jit_err = jit_nsuc;
+        goto __EXIT_FUNC;
+    }
+
+    //======================================
+    // 写入 tar 归档文件
+
+    if (J_NULL != JSZ_tarf)
+    {
+        jfs_tarf = fopen(JSZ_tarf, "wb");
+        if (J_NULL == jfs_tarf)
         {
-            JRC_area.jit_h = JRC_MOD(JRC_area.jit_h, jit_imgh) - JRC_area.jit_y;
-            if (JRC_area.jit_h < 0)
-                JRC_area.jit_h = 0;
+            printf("open the archive file [%s] failed!\n", JSZ_tarf);
+            jit_err = -1;
+            goto __EXIT_FUNC;
+        }
+
+        for (jut_iter = 0; jut_iter < jut_nitm; ++jut_iter)
+        {
+            if (JENC_ERR_OK != jvec_job[jut_iter].jit_err)
+                continue;
+
+            if (!jclip_tar_write(jfs_tarf,
+                                 jvec_item[jut_iter].jsz_path,
+                                 jvec_item[jut_iter].jmt_data,
+                                 jvec_job[jut_iter].jst_size))
+            {
+                printf("write the archive file [%s] failed!\n", JSZ_tarf);
+                jit_err = -1;
+                goto __EXIT_FUNC;
+            }
         }
-#undef JRC_MOD
 
-        if ((JRC_area.jit_x + JRC_area.jit_w) > jit_imgw)
-            JRC_area.jit_w = jit_imgw - JRC_area.jit_x;
-        if ((JRC_area.jit_y + JRC_area.jit_h) > jit_imgh)
-            JRC_area.jit_h = jit_imgh - JRC_area.jit_y;
+        // tar 归档的结束标识：两个全零的数据块
+        {
+            j_byte_t jbt_zero[1024] = { 0 };
+            if (sizeof(jbt_zero) != fwrite(jbt_zero, 1, sizeof(jbt_zero), jfs_tarf))
+            {
+                printf("write the archive file [%s] failed!\n", JSZ_tarf);
+                jit_err = -1;
+                goto __EXIT_FUNC;
+            }
+        }
     }
 
-    if ((JRC_area.jit_w <= 0) || (JRC_area.jit_h <= 0))
+    //======================================
+    // 输出统计信息
+
+    for (jut_iter = 0; jut_iter < jut_nitm; ++jut_iter)
     {
+        const jclip_item_t & jitem = jvec_item[jut_iter];
+        const jenc_job_t   & jjob  = jvec_job[jut_iter];
+
+        jdt_tsum += jjob.jdt_time;
+
+        if (JENC_ERR_OK != jjob.jit_err)
+        {
+            printf(
+                "[%4u] line %u [%d, %d, %d, %d] : encode error: %s\n",
+                jut_iter,
+                jitem.jut_line,
+                jitem.jrc_area.jit_x,
+                jitem.jrc_area.jit_y,
+                jitem.jrc_area.jit_w,
+                jitem.jrc_area.jit_h,
+                jenc_errno_name(jjob.jit_err));
+            continue;
+        }
+
         printf(
-            "Error: the clip area[%d, %d, %d, %d] is empty!\n",
-            JRC_area.jit_x,
-            JRC_area.jit_y,
-            JRC_area.jit_w,
-            JRC_area.jit_h);
-        return J_FALSE;
+            "[%4u] %-32s [%d, %d, %d, %d] %9.3f ms",
+            jut_iter,
+            jitem.jsz_path,
+            jitem.jrc_area.jit_x,
+            jitem.jrc_area.jit_y,
+            jitem.jrc_area.jit_w,
+            jitem.jrc_area.jit_h,
+            jjob.jdt_time * 1000.0);
+
+        // 文件模式输出时，编码任务不返回 字节数
+        if (J_NULL != JSZ_tarf)
+            printf(" %10zu bytes\n", jjob.jst_size);
+        else
+            printf("\n");
     }
 
     printf(
-        "the clip area is [%d, %d, %d, %d]\n",
-        JRC_area.jit_x,
-        JRC_area.jit_y,
-        JRC_area.jit_w,
-        JRC_area.jit_h);
+        "decode rows [%u, %u) of %d : %9.3f ms\n"
+        "encode %d/%u clips on %u threads : %9.3f ms (per clip: %.3f ms)\n"
+        "total wall time : %9.3f ms\n",
+        jut_ypos,
+        jut_yend,
+        jinfo_ctx.jit_imgh,
+        jdt_tdec * 1000.0,
+        jit_nsuc,
+        jut_nitm,
+        jthrd_workers(JUT_nthd, jut_nitm),
+        jdt_tenc * 1000.0,
+        jdt_tsum * 1000.0 / jut_nitm,
+        (jthrd_clock() - jdt_tick) * 1000.0);
+
+    if (J_NULL != JSZ_tarf)
+    {
+        printf("output archive file: %s\n", JSZ_tarf);
+    }
+
+    jit_err = (jit_nsuc == (j_int_t)jut_nitm) ? 0 : -1;
 
     //======================================
 
-    return J_TRUE;
+__EXIT_FUNC:
+    if (J_NULL != jfs_tarf)
+    {
+        fclose(jfs_tarf);
+        jfs_tarf = J_NULL;
+    }
+
+    for (jut_iter = 0; jut_iter < jut_nitm; ++jut_iter)
+    {
+        if (J_NULL != jvec_item[jut_iter].jmt_data)
+            free(jvec_item[jut_iter].jmt_data);
+    }
+
+    if (J_NULL != jmt_band)
+    {
+        free(jmt_band);
+        jmt_band = J_NULL;
+    }
+
+    //======================================
+
+    return jit_err;
 }
 
 /**********************************************************/
@@ -654,17 +1365,50 @@ j_int_t jclip_proc(void)
 {
     j_int_t     jit_err = 0;
 
-    j_mptr_t    jmt_pxls = J_NULL;
     jpeg_info_t jinfo_ctx;
     jenc_ccs_t  jenc_ccs = JENC_CCS_UNKNOWN;
+    jdecoder_t  jdecoder;
+
+    if (JBL_lossless)
+    {
+        return jclip_lossless();
+    }
+
+    if (J_NULL != JSZ_batch)
+    {
+        return jclip_batch();
+    }
 
     //======================================
-    // 解码输入图像
+    // 获取图像基本信息，确认 色彩空间 转换
+
+    jit_err = jdecoder.config(JCTL_MODE_FSZPATH, (j_fhandle_t)JSZ_iput, 0);
+    if (JDEC_ERR_OK == jit_err)
+    {
+        jit_err = jdecoder.info(&jinfo_ctx);
+    }
 
-    jit_err = jclip_decode(JSZ_iput, jmt_pxls, jinfo_ctx, jenc_ccs);
     if (JDEC_ERR_OK != jit_err)
     {
-        goto __EXIT_FUNC;
+        printf(
+            "jdecoder.info() [%s] return error: %s\n",
+            JSZ_iput,
+            jdec_errno_name(jit_err));
+        return jit_err;
+    }
+
+    printf(
+        "image[%s] info: [w: %d, h: %d, nc: %d, cs: %s]\n",
+        JSZ_iput,
+        jinfo_ctx.jit_imgw,
+        jinfo_ctx.jit_imgh,
+        jinfo_ctx.jit_nchs,
+        jpeg_cs_name(jinfo_ctx.jcs_type));
+
+    jit_err = jclip_ccs(jinfo_ctx, jenc_ccs);
+    if (JENC_ERR_OK != jit_err)
+    {
+        return jit_err;
     }
 
     //======================================
@@ -672,8 +1416,7 @@ j_int_t jclip_proc(void)
 
     if (!jclip_area(jinfo_ctx.jit_imgw, jinfo_ctx.jit_imgh))
     {
-        jit_err = -1;
-        goto __EXIT_FUNC;
+        return -1;
     }
 
     if ('\0' == JSZ_oput[0])
@@ -683,22 +1426,9 @@ j_int_t jclip_proc(void)
     }
 
     //======================================
-    // 执行编码输出
+    // 只解码 裁剪区域 所在的像素行，逐个条带 编码输出
 
-    jit_err = jclip_encode(JSZ_oput, jmt_pxls, jinfo_ctx, JRC_area, jenc_ccs);
-    if (JDEC_ERR_OK != jit_err)
-    {
-        goto __EXIT_FUNC;
-    }
-
-    //======================================
-
-__EXIT_FUNC:
-    if (J_NULL != jmt_pxls)
-    {
-        free(jmt_pxls);
-        jmt_pxls = J_NULL;
-    }
+    jit_err = jclip_banded(jdecoder, jinfo_ctx, JRC_area, jenc_ccs, JSZ_oput);
 
     //======================================
 
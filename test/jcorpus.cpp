@@ -0,0 +1,420 @@
+﻿/**
+ * @file jcorpus.cpp
+ * Copyright (c) 2024 Gaaagaa. All rights reserved.
+ * 
+ * @author  : Gaaagaa
+ * @date    : 2024-11-06
+ * @version : 1.0.0.0
+ * @brief   : 确定性的 JPEG 合成测试集 生成程序（供 jbench 等性能测试 与 回归测试 使用）。
+ * @note
+ * 1. 各个图像 轮流覆盖 所有的 jenc_ccs_t 转换方式、4 种图像内容（纯色、渐变、
+ *    噪声、类照片）与 基线/渐进 两种扫描模式；图像尺寸、压缩质量、采样因子、
+ *    重启间隔 以及 是否优化哈夫曼表，则由 种子值 确定的伪随机序列选取；
+ * 2. 像素生成 只使用整数运算，相同的 种子值 与 参数，在任意平台上 生成的
+ *    文件内容 完全一致。
+ */
+
+#include "jencoder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#else // !_WIN32
+#include <sys/stat.h>
+#endif // _WIN32
+
+////////////////////////////////////////////////////////////////////////////////
+
+j_cstring_t JSZ_odir = ".";    ///< 输出目录
+j_uint_t    JUT_seed = 1;      ///< 种子值
+j_uint_t    JUT_nimg = 112;    ///< 图像数量（默认值 恰好覆盖 14 种 ccs × 4 种内容 × 2 种扫描模式）
+j_uint_t    JUT_mdim = 1024;   ///< 图像宽高的上限值
+
+/** 所有的 色彩空间转换方式 */
+static const jenc_ccs_t JCCS_LIST[] =
+{
+    JENC_GRAY_TO_GRAY  , JENC_RGB_TO_GRAY , JENC_YCC_TO_GRAY , JENC_BGYCC_TO_GRAY,
+    JENC_RGB_TO_RGB    , JENC_BGRGB_TO_BGRGB,
+    JENC_YCC_TO_YCC    , JENC_RGB_TO_YCC  ,
+    JENC_BGYCC_TO_BGYCC, JENC_RGB_TO_BGYCC, JENC_YCC_TO_BGYCC,
+    JENC_CMYK_TO_CMYK  , JENC_YCCK_TO_YCCK, JENC_CMYK_TO_YCCK,
+};
+
+/** 图像内容的名称 */
+static const j_cstring_t JSZ_CONTENT[] = { "flat", "gradient", "noise", "photo" };
+
+/** 候选的图像宽高（包含 MCU 边界附近的 各种边缘尺寸） */
+static const j_uint_t JUT_DIMS[] =
+    { 1, 7, 8, 9, 15, 16, 17, 63, 64, 65, 127, 256, 333, 640, 1023, 1024 };
+
+/** 候选的压缩质量 */
+static const j_int_t JIT_QUALS[] = { 5, 25, 50, 75, 90, 95, 100 };
+
+/** 候选的亮度分量采样因子（依次为 4:4:4、4:2:2、4:2:0、4:4:0、4:1:1） */
+static const j_int_t JIT_SAMPS[][2] = { { 1, 1 }, { 2, 1 }, { 2, 2 }, { 1, 2 }, { 4, 1 } };
+static const j_cstring_t JSZ_SAMPS[] = { "444", "422", "420", "440", "411" };
+
+/** 候选的重启间隔（以 MCU 行为单位，0 表示 不设置） */
+static const j_int_t JIT_RROWS[] = { 0, 0, 1, 4 };
+
+#define JCORPUS_COUNT(xarr)  (sizeof(xarr) / sizeof((xarr)[0]))
+
+/**********************************************************/
+/**
+ * @brief 输出程序帮助信息。
+ */
+void usage(const char * xsz_name)
+{
+    printf(
+        "usage: %s [-o outdir] [-s seed] [-n count] [-d maxdim]\n"
+        "       -o : the output directory (created if missing), the default is the current one;\n"
+        "       -s : the seed of the corpus, the default is 1;\n"
+        "       -n : the number of images, the default is 112 (one full round of\n"
+        "            14 colorspace conversions x 4 contents x baseline/progressive);\n"
+        "       -d : the maximum image width/height (1 ~ 65500), the default is 1024.\n"
+        "       the same seed and options always produce byte-identical files.\n\n",
+        xsz_name);
+}
+
+/**********************************************************/
+/**
+ * @brief splitmix64 伪随机数生成（确定性，与平台无关）。
+ */
+static inline unsigned long long jcorpus_rand(unsigned long long * jull_state)
+{
+    unsigned long long jull_z = (*jull_state += 0x9E3779B97F4A7C15ULL);
+    jull_z = (jull_z ^ (jull_z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    jull_z = (jull_z ^ (jull_z >> 27)) * 0x94D049BB133111EBULL;
+    return jull_z ^ (jull_z >> 31);
+}
+
+/**********************************************************/
+/**
+ * @brief 整数坐标的哈希值（0 ~ 255），用于生成 噪声 与 值噪声 的格点。
+ */
+static inline j_int_t jcorpus_hash(j_uint_t jut_seed, j_int_t jit_x, j_int_t jit_y, j_int_t jit_c)
+{
+    unsigned long long jull_state =
+        ((unsigned long long)jut_seed << 32) ^
+        ((unsigned long long)(j_uint_t)jit_x << 20) ^
+        ((unsigned long long)(j_uint_t)jit_y << 2) ^ (unsigned long long)jit_c;
+    return (j_int_t)(jcorpus_rand(&jull_state) & 0xFF);
+}
+
+/**********************************************************/
+/**
+ * @brief 双线性插值的 值噪声（0 ~ 255），jit_cell 为格点间距。
+ */
+static j_int_t jcorpus_vnoise(
+                    j_uint_t jut_seed, j_int_t jit_x, j_int_t jit_y, j_int_t jit_c, j_int_t jit_cell)
+{
+    j_int_t jit_gx = jit_x / jit_cell;
+    j_int_t jit_gy = jit_y / jit_cell;
+    j_int_t jit_fx = jit_x % jit_cell;
+    j_int_t jit_fy = jit_y % jit_cell;
+
+    j_int_t jit_v00 = jcorpus_hash(jut_seed, jit_gx    , jit_gy    , jit_c);
+    j_int_t jit_v10 = jcorpus_hash(jut_seed, jit_gx + 1, jit_gy    , jit_c);
+    j_int_t jit_v01 = jcorpus_hash(jut_seed, jit_gx    , jit_gy + 1, jit_c);
+    j_int_t jit_v11 = jcorpus_hash(jut_seed, jit_gx + 1, jit_gy + 1, jit_c);
+
+    j_int_t jit_top = jit_v00 * (jit_cell - jit_fx) + jit_v10 * jit_fx;
+    j_int_t jit_bot = jit_v01 * (jit_cell - jit_fx) + jit_v11 * jit_fx;
+
+    return (jit_top * (jit_cell - jit_fy) + jit_bot * jit_fy) / (jit_cell * jit_cell);
+}
+
+/**********************************************************/
+/**
+ * @brief 将数值限制在 0 ~ 255 范围内。
+ */
+static inline j_int_t jcorpus_clamp(j_int_t jit_value)
+{
+    return (jit_value < 0) ? 0 : ((jit_value > 255) ? 255 : jit_value);
+}
+
+/**********************************************************/
+/**
+ * @brief 生成 (x, y) 处的 RGB 与 K 值（类照片内容 另含 矩形色块 与 轻微噪声）。
+ */
+static j_void_t jcorpus_pixel(
+                    j_uint_t   jut_seed,
+                    j_uint_t   jut_kind,
+                    j_int_t    jit_x,
+                    j_int_t    jit_y,
+                    j_int_t    jit_w,
+                    j_int_t    jit_h,
+                    j_int_t    jit_rgbk[4])
+{
+    j_int_t jit_c = 0;
+    j_int_t jit_r = 0;
+
+    for (jit_c = 0; jit_c < 4; ++jit_c)
+    {
+        switch (jut_kind)
+        {
+        case 0: // 纯色
+            jit_rgbk[jit_c] = jcorpus_hash(jut_seed, 0, 0, jit_c);
+            break;
+
+        case 1: // 渐变（各通道方向不同）
+            if (0 == jit_c)
+                jit_rgbk[jit_c] = (jit_w > 1) ? (jit_x * 255 / (jit_w - 1)) : 128;
+            else if (1 == jit_c)
+                jit_rgbk[jit_c] = (jit_h > 1) ? (jit_y * 255 / (jit_h - 1)) : 128;
+            else if (2 == jit_c)
+                jit_rgbk[jit_c] = (jit_w + jit_h > 2) ?
+                                  (255 - (jit_x + jit_y) * 255 / (jit_w + jit_h - 2)) : 128;
+            else
+                jit_rgbk[jit_c] = ((jit_x ^ jit_y) & 0x3F) * 2;
+            break;
+
+        case 2: // 均匀噪声
+            jit_rgbk[jit_c] = jcorpus_hash(jut_seed, jit_x, jit_y, jit_c);
+            break;
+
+        default: // 类照片：多尺度值噪声 + 锐利边缘的矩形 + 轻微噪声
+            jit_rgbk[jit_c] =
+                (jcorpus_vnoise(jut_seed, jit_x, jit_y, jit_c, 64) * 4 +
+                 jcorpus_vnoise(jut_seed, jit_x, jit_y, jit_c + 4, 16) * 3 +
+                 jcorpus_vnoise(jut_seed, jit_x, jit_y, jit_c + 8, 4)) / 8;
+            break;
+        }
+    }
+
+    if (jut_kind >= 3)
+    {
+        for (jit_r = 0; jit_r < 6; ++jit_r)
+        {
+            j_int_t jit_rx = jcorpus_hash(jut_seed, jit_r, -1, 0) * jit_w / 256;
+            j_int_t jit_ry = jcorpus_hash(jut_seed, jit_r, -1, 1) * jit_h / 256;
+            j_int_t jit_rw = jcorpus_hash(jut_seed, jit_r, -1, 2) * jit_w / 512 + 1;
+            j_int_t jit_rh = jcorpus_hash(jut_seed, jit_r, -1, 3) * jit_h / 512 + 1;
+
+            if ((jit_x >= jit_rx) && (jit_x < jit_rx + jit_rw) &&
+                (jit_y >= jit_ry) && (jit_y < jit_ry + jit_rh))
+            {
+                for (jit_c = 0; jit_c < 4; ++jit_c)
+                    jit_rgbk[jit_c] = (jit_rgbk[jit_c] + jcorpus_hash(jut_seed, jit_r, -2, jit_c) * 3) / 4;
+            }
+        }
+
+        for (jit_c = 0; jit_c < 4; ++jit_c)
+        {
+            jit_rgbk[jit_c] = jcorpus_clamp(
+                jit_rgbk[jit_c] + (jcorpus_hash(jut_seed + 1, jit_x, jit_y, jit_c) >> 4) - 8);
+        }
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 按 色彩空间转换方式 的输入格式，生成图像像素（返回的缓存 由调用方 free() 释放）。
+ */
+static j_mptr_t jcorpus_image(
+                    j_uint_t   jut_seed,
+                    j_uint_t   jut_kind,
+                    jenc_ccs_t jccs_conv,
+                    j_int_t    jit_w,
+                    j_int_t    jit_h,
+                    j_int_t  * jit_step)
+{
+    jctl_cs_t jctl_in  = (jctl_cs_t)(jccs_conv & 0x00FFFFFF);
+    j_int_t   jit_nc   = JENC_CCS_NUMC(jccs_conv);
+    j_mptr_t  jmt_pxls = J_NULL;
+    j_mptr_t  jmt_iter = J_NULL;
+    j_int_t   jit_x    = 0;
+    j_int_t   jit_y    = 0;
+    j_int_t   jit_r    = 0;
+    j_int_t   jit_g    = 0;
+    j_int_t   jit_b    = 0;
+    j_int_t   jit_rgbk[4];
+
+    *jit_step = jit_w * jit_nc;
+    jmt_pxls  = (j_mptr_t)malloc((j_size_t)(*jit_step) * jit_h);
+    if (J_NULL == jmt_pxls)
+    {
+        return J_NULL;
+    }
+
+    jmt_iter = jmt_pxls;
+    for (jit_y = 0; jit_y < jit_h; ++jit_y)
+    {
+        for (jit_x = 0; jit_x < jit_w; ++jit_x)
+        {
+            jcorpus_pixel(jut_seed, jut_kind, jit_x, jit_y, jit_w, jit_h, jit_rgbk);
+            jit_r = jit_rgbk[0];
+            jit_g = jit_rgbk[1];
+            jit_b = jit_rgbk[2];
+
+            switch (jctl_in)
+            {
+            case JCTL_CS_GRAY:
+                *jmt_iter++ = (j_byte_t)((77 * jit_r + 150 * jit_g + 29 * jit_b) >> 8);
+                break;
+
+            case JCTL_CS_YCC:
+            case JCTL_CS_BG_YCC:
+            case JCTL_CS_YCCK:
+                *jmt_iter++ = (j_byte_t)((77 * jit_r + 150 * jit_g + 29 * jit_b) >> 8);
+                *jmt_iter++ = (j_byte_t)jcorpus_clamp(((-43 * jit_r - 85 * jit_g + 128 * jit_b) >> 8) + 128);
+                *jmt_iter++ = (j_byte_t)jcorpus_clamp(((128 * jit_r - 107 * jit_g - 21 * jit_b) >> 8) + 128);
+                if (JCTL_CS_YCCK == jctl_in)
+                    *jmt_iter++ = (j_byte_t)jit_rgbk[3];
+                break;
+
+            case JCTL_CS_CMYK:
+                *jmt_iter++ = (j_byte_t)(255 - jit_r);
+                *jmt_iter++ = (j_byte_t)(255 - jit_g);
+                *jmt_iter++ = (j_byte_t)(255 - jit_b);
+                *jmt_iter++ = (j_byte_t)jit_rgbk[3];
+                break;
+
+            default: // RGB、BG_RGB
+                *jmt_iter++ = (j_byte_t)jit_r;
+                *jmt_iter++ = (j_byte_t)jit_g;
+                *jmt_iter++ = (j_byte_t)jit_b;
+                break;
+            }
+        }
+    }
+
+    return jmt_pxls;
+}
+
+/**********************************************************/
+/**
+ * @brief main function.
+ */
+int main(int argc, char * argv[])
+{
+    j_int_t            jit_iter = 0;
+    j_int_t            jit_err  = 0;
+    j_uint_t           jut_iter = 0;
+    j_uint_t           jut_ndim = 0;
+    j_uint_t           jut_nerr = 0;
+    j_uint_t           jut_kind = 0;
+    j_uint_t           jut_samp = 0;
+    j_uint_t           jut_seed = 0;
+    j_int_t            jit_w    = 0;
+    j_int_t            jit_h    = 0;
+    j_int_t            jit_step = 0;
+    j_int_t            jit_qual = 0;
+    jenc_ccs_t         jccs_conv = JENC_CCS_UNKNOWN;
+    j_mptr_t           jmt_pxls = J_NULL;
+    unsigned long long jull_state = 0;
+    jenc_param_t       jparam;
+    j_char_t           jsz_path[1024];
+    jencoder_t         jencoder;
+
+    //======================================
+    // 解析参数
+
+    for (jit_iter = 1; jit_iter < argc; ++jit_iter)
+    {
+        if ((0 == strcmp("-o", argv[jit_iter])) && (jit_iter + 1 < argc))
+            JSZ_odir = argv[++jit_iter];
+        else if ((0 == strcmp("-s", argv[jit_iter])) && (jit_iter + 1 < argc))
+            JUT_seed = (j_uint_t)strtoul(argv[++jit_iter], J_NULL, 0);
+        else if ((0 == strcmp("-n", argv[jit_iter])) && (jit_iter + 1 < argc))
+            JUT_nimg = (j_uint_t)strtoul(argv[++jit_iter], J_NULL, 0);
+        else if ((0 == strcmp("-d", argv[jit_iter])) && (jit_iter + 1 < argc))
+            JUT_mdim = (j_uint_t)strtoul(argv[++jit_iter], J_NULL, 0);
+        else
+        {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    if ((0 == JUT_nimg) || (0 == JUT_mdim) || (JUT_mdim > 65500))
+    {
+        usage(argv[0]);
+        return -1;
+    }
+
+    // 候选尺寸 按升序排列，只取不超过上限值的部分
+    for (jut_ndim = 0; (jut_ndim < JCORPUS_COUNT(JUT_DIMS)) && (JUT_DIMS[jut_ndim] <= JUT_mdim); ++jut_ndim)
+    {
+    }
+
+#ifdef _WIN32
+    _mkdir(JSZ_odir);
+#else // !_WIN32
+    mkdir(JSZ_odir, 0755);
+#endif // _WIN32
+
+    //======================================
+    // 逐个生成图像
+
+    for (jut_iter = 0; jut_iter < JUT_nimg; ++jut_iter)
+    {
+        jull_state = ((unsigned long long)JUT_seed << 32) | jut_iter;
+        jut_seed   = (j_uint_t)jcorpus_rand(&jull_state);
+
+        jccs_conv = JCCS_LIST[jut_iter % JCORPUS_COUNT(JCCS_LIST)];
+        jut_kind  = (jut_iter / JCORPUS_COUNT(JCCS_LIST)) % JCORPUS_COUNT(JSZ_CONTENT);
+
+        jit_w    = (j_int_t)JUT_DIMS[jcorpus_rand(&jull_state) % jut_ndim];
+        jit_h    = (j_int_t)JUT_DIMS[jcorpus_rand(&jull_state) % jut_ndim];
+        jit_qual = JIT_QUALS[jcorpus_rand(&jull_state) % JCORPUS_COUNT(JIT_QUALS)];
+        jut_samp = (j_uint_t)(jcorpus_rand(&jull_state) % JCORPUS_COUNT(JIT_SAMPS));
+
+        jparam.jit_hsamp = JIT_SAMPS[jut_samp][0];
+        jparam.jit_vsamp = JIT_SAMPS[jut_samp][1];
+        jparam.jit_prog  = (j_int_t)((jut_iter / (JCORPUS_COUNT(JCCS_LIST) * JCORPUS_COUNT(JSZ_CONTENT))) % 2);
+        jparam.jit_rrows = JIT_RROWS[jcorpus_rand(&jull_state) % JCORPUS_COUNT(JIT_RROWS)];
+        jparam.jbl_optim = (j_bool_t)(jcorpus_rand(&jull_state) & 1);
+
+        // 不带色度分量的输出色彩空间，采样因子无效，文件名中 统一记为 444
+        switch (JENC_CCS_OUT(jccs_conv))
+        {
+        case JPEG_CS_YCC: case JPEG_CS_BG_YCC: case JPEG_CS_YCCK: break;
+        default: jut_samp = 0; break;
+        }
+
+        snprintf(jsz_path, sizeof(jsz_path), "%s/%04u_%s_%s_%dx%d_q%d_%s_%s_r%d%s.jpg",
+                 JSZ_odir,
+                 jut_iter,
+                 JSZ_CONTENT[jut_kind],
+                 jenc_ccs_name(jccs_conv) + 5,
+                 jit_w,
+                 jit_h,
+                 jit_qual,
+                 JSZ_SAMPS[jut_samp],
+                 jparam.jit_prog ? "prog" : "base",
+                 jparam.jit_rrows,
+                 jparam.jbl_optim ? "_opt" : "");
+
+        jmt_pxls = jcorpus_image(jut_seed, jut_kind, jccs_conv, jit_w, jit_h, &jit_step);
+        if (J_NULL == jmt_pxls)
+        {
+            printf("%s : malloc() failed!\n", jsz_path);
+            ++jut_nerr;
+            continue;
+        }
+
+        jit_err = jencoder.config(JCTL_MODE_FSZPATH, (j_fhandle_t)jsz_path, 0, (j_uint_t)jit_qual);
+        if (JENC_ERR_OK == jit_err)
+            jit_err = jencoder.config_param(&jparam);
+        if (JENC_ERR_OK == jit_err)
+            jit_err = jencoder.encode_image(jccs_conv, jmt_pxls, jit_step, (j_uint_t)jit_w, (j_uint_t)jit_h);
+
+        if (jit_err < 0)
+        {
+            printf("%s : encode failed: %s\n", jsz_path, jenc_errno_name(jit_err));
+            ++jut_nerr;
+        }
+        else
+        {
+            printf("%s\n", jsz_path);
+        }
+
+        free(jmt_pxls);
+    }
+
+    return (0 == jut_nerr) ? 0 : -1;
+}
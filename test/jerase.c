@@ -8,7 +8,9 @@
  * @brief   : 擦除图片中的指定矩形区域。
  */
 
-#include "../XJPEG_wrapper.h"
+#include "jdecoder.h"
+#include "jencoder.h"
+#include "jtransform.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -33,6 +35,7 @@ j_cstring_t jsz_ifile = J_NULL;
 j_cstring_t jsz_ofile = J_NULL;
 jrect_t     jrc_area  = { 0, 0, 0, 0 };
 j_uint_t    jut_eclr  = 0x00FFFFFF;
+j_bool_t    jbl_lossless = J_FALSE;
 
 /**********************************************************/
 /**
@@ -43,7 +46,7 @@ j_uint_t    jut_eclr  = 0x00FFFFFF;
  * 
  * @return j_int_t : 成功，返回 0；失败，返回 -1 。
  */
-j_int_t jerase_getopt(j_int_t jit_argc, j_cstring_t jsz_argv[]);
+j_int_t jerase_getopt(j_int_t jit_argc, j_char_t * jsz_argv[]);
 
 /**********************************************************/
 /**
@@ -59,14 +62,17 @@ j_void_t jerase_proc(void);
  */
 void usage(const char * xszt_name)
 {
-    printf("usage: %s -i input -o output [-x xpos] [-y ypos] -w width -h height [-c color]\n"
+    printf("usage: %s -i input -o output [-x xpos] [-y ypos] -w width -h height [-c color] [--lossless]\n"
            "       -i : input jpeg file.\n"
            "       -o : output jpeg file.\n"
            "       -x : the x position of the erase area, default value: 0.\n"
            "       -y : the y position of the erase area, default value: 0.\n"
            "       -w : the width of the erase area.\n"
            "       -h : the height of the erase area.\n"
-           "       -c : the erase color, default value: 0x00FFFFFF.\n",
+           "       -c : the erase color, default value: 0x00FFFFFF.\n"
+           "       --lossless : erase in the DCT coefficient domain, without decoding and re-encoding;\n"
+           "              the area is expanded to the iMCU boundary (8 or 16 pixels),\n"
+           "              and the blocks outside the area are kept unchanged.\n",
            xszt_name);
 }
 
@@ -139,22 +145,20 @@ static int xstr_icmp(const char * xszt_lcmp, const char * xszt_rcmp)
 
 /**********************************************************/
 /**
- * @brief 解码 JPEG 图片文件 至 指定缓存中。
+ * @brief 解码 JPEG 图片文件 至 指定缓存中（RGB 格式）。
  * 
- * @param [in ] jdec_cptr  : JPEG 解码操作的工作对象。
+ * @param [in ] jdec_this  : JPEG 解码操作的上下文对象。
  * @param [in ] jsz_path   : JPEG 图片文件路径。
- * @param [out] jmem_buf   : 解码输出的缓存。
- * @param [out] jit_size   : 缓存大小。
+ * @param [out] jmt_pxls   : 解码输出的缓存（由调用方 free() 释放）。
  * @param [out] jinfo_ptr  : 操作返回的 JPEG 图像基本信息。
  * 
  * @return j_int_t : 操作错误码，为 JDEC_ERR_OK 时，表示成功。
  */
 j_int_t jpeg_decode(
-            jdec_ctxptr_t jdec_cptr,
-            j_cstring_t   jsz_path,
-            j_mem_t     * jmem_buf,
-            j_int_t     * jit_size,
-            jinfo_ptr_t   jinfo_ptr)
+            jdec_this_t jdec_this,
+            j_cstring_t jsz_path,
+            j_mptr_t  * jmt_pxls,
+            jinfo_ptr_t jinfo_ptr)
 {
     j_int_t jit_errno = JDEC_ERR_UNKNOWN;
 
@@ -162,39 +166,34 @@ j_int_t jpeg_decode(
     {
         //======================================
 
-        jit_errno = jdec_config_src(jdec_cptr, JCTRL_MODE_FILE, (j_handle_t)jsz_path, 0);
+        jit_errno = jdec_config(jdec_this, JCTL_MODE_FSZPATH, (j_fhandle_t)jsz_path, 0);
         if (JDEC_ERR_OK != jit_errno)
         {
-            printf("jdec_config_src() return error : %s\n", jdec_errno_name(jit_errno));
+            printf("jdec_config() return error : %s\n", jdec_errno_name(jit_errno));
             break;
         }
 
-        jit_errno = jdec_src_info(jdec_cptr, jinfo_ptr);
+        jit_errno = jdec_info(jdec_this, jinfo_ptr);
         if (JDEC_ERR_OK != jit_errno)
         {
-            printf("jdec_src_info() return error : %s\n", jdec_errno_name(jit_errno));
+            printf("jdec_info() return error : %s\n", jdec_errno_name(jit_errno));
             break;
         }
 
         printf("input image: %s\n", jsz_path);
-        printf("image size : %d x %d\n", jinfo_ptr->jit_width, jinfo_ptr->jit_height);
-        *jit_size = 4 * jinfo_ptr->jit_width * (jinfo_ptr->jit_height + 16);
-        assert(*jit_size > 0);
-        *jmem_buf = (j_mem_t)malloc(*jit_size);
-        assert(J_NULL != *jmem_buf);
-
-        jdec_set_align(jdec_cptr, J_FALSE);
-        jit_errno = jdec_src_to_rgb(
-                            jdec_cptr,
-                            *jmem_buf,
-                            0,
-                            *jit_size,
-                            J_NULL,
-                            J_NULL,
-                            JCTRL_CS_BGR);
-        if (JDEC_ERR_OK != jit_errno)
+        printf("image size : %d x %d\n", jinfo_ptr->jit_imgw, jinfo_ptr->jit_imgh);
+        *jmt_pxls = (j_mptr_t)malloc(3 * jinfo_ptr->jit_imgw * jinfo_ptr->jit_imgh);
+        assert(J_NULL != *jmt_pxls);
+
+        jit_errno = jdec_image(
+                            jdec_this,
+                            JCTL_CS_RGB,
+                            *jmt_pxls,
+                            3 * jinfo_ptr->jit_imgw,
+                            J_NULL);
+        if (jit_errno < 0)
         {
-            printf("jdec_src_to_rgb() return error : %s\n", jdec_errno_name(jit_errno));
+            printf("jdec_image() return error : %s\n", jdec_errno_name(jit_errno));
             break;
         }
 
@@ -214,7 +213,7 @@ j_int_t jpeg_decode(
  * 
  * @return j_int_t : 成功，返回 0；失败，返回 -1 。
  */
-j_int_t jerase_getopt(j_int_t jit_argc, j_cstring_t jsz_argv[])
+j_int_t jerase_getopt(j_int_t jit_argc, j_char_t * jsz_argv[])
 {
     j_int_t jit_iter = 0;
 
@@ -268,7 +267,14 @@ j_int_t jerase_getopt(j_int_t jit_argc, j_cstring_t jsz_argv[])
         if ((0 == xstr_icmp("-c", jsz_argv[jit_iter])) &&
             ((jit_iter + 1) < jit_argc))
         {
-            jut_eclr = (j_uint_t)strtol(jsz_argv[++jit_iter], J_NULL, 0);
+            jut_eclr = (j_uint_t)strtoul(jsz_argv[++jit_iter], J_NULL, 0);
+            continue;
+        }
+
+        if (0 == xstr_icmp("--lossless", jsz_argv[jit_iter]))
+        {
+            jbl_lossless = J_TRUE;
+            ++jit_iter;
             continue;
         }
 
@@ -308,6 +314,66 @@ j_int_t jerase_getopt(j_int_t jit_argc, j_cstring_t jsz_argv[])
     return 0;
 }
 
+/**********************************************************/
+/**
+ * @brief 在 DCT 系数域内 执行区域擦除工作（只对区域内的系数块 重新赋值，不经过 解码/编码）。
+ */
+j_void_t jerase_lossless(void)
+{
+    j_int_t       jit_errno;
+    jtrans_this_t jtrans_this = J_NULL;
+    j_rect_t      jrect_area;
+
+    //======================================
+
+    jtrans_this = jtrans_alloc(J_NULL);
+    assert(J_NULL != jtrans_this);
+
+    jit_errno = jtrans_config_input(jtrans_this, JCTL_MODE_FSZPATH, (j_fhandle_t)jsz_ifile, 0);
+    if (JTRANS_ERR_OK != jit_errno)
+    {
+        printf("jtrans_config_input() return error: %s\n", jtrans_errno_name(jit_errno));
+        goto __EXIT_FUNC;
+    }
+
+    jit_errno = jtrans_config_output(jtrans_this, JCTL_MODE_FSZPATH, (j_fhandle_t)jsz_ofile, 0);
+    if (JTRANS_ERR_OK != jit_errno)
+    {
+        printf("jtrans_config_output() return error: %s\n", jtrans_errno_name(jit_errno));
+        goto __EXIT_FUNC;
+    }
+
+    jrect_area.jit_x = jrc_area.jit_x;
+    jrect_area.jit_y = jrc_area.jit_y;
+    jrect_area.jit_w = jrc_area.jit_w;
+    jrect_area.jit_h = jrc_area.jit_h;
+
+    jit_errno = jtrans_erase(jtrans_this, &jrect_area, jut_eclr);
+    if (JTRANS_ERR_OK != jit_errno)
+    {
+        printf("jtrans_erase() return error: %s\n", jtrans_errno_name(jit_errno));
+        goto __EXIT_FUNC;
+    }
+
+    printf("erase rectangle: [ %d, %d, %d, %d ]\n",
+           jrect_area.jit_x,
+           jrect_area.jit_y,
+           jrect_area.jit_x + jrect_area.jit_w,
+           jrect_area.jit_y + jrect_area.jit_h);
+    printf("erase OK, output image: %s\n", jsz_ofile);
+
+    //======================================
+__EXIT_FUNC:
+
+    if (J_NULL != jtrans_this)
+    {
+        jtrans_release(jtrans_this);
+        jtrans_this = J_NULL;
+    }
+
+    //======================================
+}
+
 /**********************************************************/
 /**
  * @brief 执行区域擦除工作。
@@ -316,11 +382,10 @@ j_void_t jerase_proc(void)
 {
     j_int_t       jit_errno;
 
-    jdec_ctxptr_t jdec_cptr = J_NULL;
-    jenc_ctxptr_t jenc_cptr = J_NULL;
+    jdec_this_t   jdec_this = J_NULL;
+    jenc_this_t   jenc_this = J_NULL;
 
-    j_int_t       jit_size  = -1;
-    j_mem_t       jmem_buf  = J_NULL;
+    j_mptr_t      jmt_pxls  = J_NULL;
     jpeg_info_t   jinfo_ctx;
 
     j_int_t jit_x;
@@ -333,12 +398,20 @@ j_void_t jerase_proc(void)
     j_int_t jit_b;
 
     //======================================
-    // 解码，获取 BGR 图像像素数据
 
-    jdec_cptr = jdec_alloc(J_NULL);
-    assert(J_NULL != jdec_cptr);
+    if (jbl_lossless)
+    {
+        jerase_lossless();
+        return;
+    }
 
-    jit_errno = jpeg_decode(jdec_cptr, jsz_ifile, &jmem_buf, &jit_size, &jinfo_ctx);
+    //======================================
+    // 解码，获取 RGB 图像像素数据
+
+    jdec_this = jdec_alloc(J_NULL);
+    assert(J_NULL != jdec_this);
+
+    jit_errno = jpeg_decode(jdec_this, jsz_ifile, &jmt_pxls, &jinfo_ctx);
     if (JDEC_ERR_OK != jit_errno)
     {
         goto __EXIT_FUNC;
@@ -347,17 +420,17 @@ j_void_t jerase_proc(void)
     //======================================
     // 执行区域擦除操作
 
-    jit_l = jrc_area.jit_x % jinfo_ctx.jit_width;
-    if (jit_l < 0) jit_l += jinfo_ctx.jit_width;
+    jit_l = jrc_area.jit_x % jinfo_ctx.jit_imgw;
+    if (jit_l < 0) jit_l += jinfo_ctx.jit_imgw;
 
-    jit_t = jrc_area.jit_y % jinfo_ctx.jit_height;
-    if (jit_t < 0) jit_t += jinfo_ctx.jit_height;
+    jit_t = jrc_area.jit_y % jinfo_ctx.jit_imgh;
+    if (jit_t < 0) jit_t += jinfo_ctx.jit_imgh;
 
     jit_r = jit_l + jrc_area.jit_w;
-    if (jit_r > jinfo_ctx.jit_width) jit_r = jinfo_ctx.jit_width;
+    if (jit_r > jinfo_ctx.jit_imgw) jit_r = jinfo_ctx.jit_imgw;
 
     jit_b = jit_t + jrc_area.jit_h;
-    if (jit_b > jinfo_ctx.jit_height) jit_b = jinfo_ctx.jit_height;
+    if (jit_b > jinfo_ctx.jit_imgh) jit_b = jinfo_ctx.jit_imgh;
 
     printf("erase rectangle: [ %d, %d, %d, %d ]\n",
            jit_l,
@@ -369,35 +442,35 @@ j_void_t jerase_proc(void)
     {
         for (jit_x = jit_l; jit_x < jit_r; ++jit_x)
         {
-            jit_i = 3 * (jinfo_ctx.jit_width * jit_y + jit_x);
-            jmem_buf[jit_i + 0] = (j_byte_t)((jut_eclr & 0x000000FF) >>  0); // B
-            jmem_buf[jit_i + 1] = (j_byte_t)((jut_eclr & 0x0000FF00) >>  8); // G
-            jmem_buf[jit_i + 2] = (j_byte_t)((jut_eclr & 0x00FF0000) >> 16); // R
+            jit_i = 3 * (jinfo_ctx.jit_imgw * jit_y + jit_x);
+            jmt_pxls[jit_i + 0] = (j_byte_t)((jut_eclr & 0x00FF0000) >> 16); // R
+            jmt_pxls[jit_i + 1] = (j_byte_t)((jut_eclr & 0x0000FF00) >>  8); // G
+            jmt_pxls[jit_i + 2] = (j_byte_t)((jut_eclr & 0x000000FF) >>  0); // B
         }
     }
 
     //======================================
 
-    jenc_cptr = jenc_alloc(J_NULL);
-    assert(J_NULL != jenc_cptr);
+    jenc_this = jenc_alloc(J_NULL);
+    assert(J_NULL != jenc_this);
 
-    jit_errno = jenc_config_dst(jenc_cptr, JCTRL_MODE_FILE, (j_handle_t)jsz_ofile, 0);
-    if (JDEC_ERR_OK != jit_errno)
+    jit_errno = jenc_config(jenc_this, JCTL_MODE_FSZPATH, (j_fhandle_t)jsz_ofile, 0, 75);
+    if (JENC_ERR_OK != jit_errno)
     {
-        printf("jenc_config_dst() return error: %s\n", jenc_errno_name(jit_errno));
+        printf("jenc_config() return error: %s\n", jenc_errno_name(jit_errno));
         goto __EXIT_FUNC;
     }
 
-    jit_errno = jenc_rgb_to_dst(
-                    jenc_cptr,
-                    jmem_buf,
-                    jinfo_ctx.jit_width * 3,
-                    jinfo_ctx.jit_width,
-                    jinfo_ctx.jit_height,
-                    JENC_BGR_TO_RGB);
-    if (JDEC_ERR_OK != jit_errno)
+    jit_errno = jenc_image(
+                    jenc_this,
+                    JENC_RGB_TO_YCC,
+                    jmt_pxls,
+                    jinfo_ctx.jit_imgw * 3,
+                    (j_uint_t)jinfo_ctx.jit_imgw,
+                    (j_uint_t)jinfo_ctx.jit_imgh);
+    if (jit_errno < 0)
     {
-        printf("jenc_rgb_to_dst() return error: %s\n", jenc_errno_name(jit_errno));
+        printf("jenc_image() return error: %s\n", jenc_errno_name(jit_errno));
         goto __EXIT_FUNC;
     }
 
@@ -406,22 +479,22 @@ j_void_t jerase_proc(void)
     //======================================
 __EXIT_FUNC:
 
-    if (J_NULL != jdec_cptr)
+    if (J_NULL != jdec_this)
     {
-        jdec_release(jdec_cptr);
-        jdec_cptr = J_NULL;
+        jdec_release(jdec_this);
+        jdec_this = J_NULL;
     }
 
-    if (J_NULL != jenc_cptr)
+    if (J_NULL != jenc_this)
     {
-        jenc_release(jenc_cptr);
-        jenc_cptr = J_NULL;
+        jenc_release(jenc_this);
+        jenc_this = J_NULL;
     }
 
-    if (J_NULL != jmem_buf)
+    if (J_NULL != jmt_pxls)
     {
-        free(jmem_buf);
-        jmem_buf = J_NULL;
+        free(jmt_pxls);
+        jmt_pxls = J_NULL;
     }
 
     //======================================
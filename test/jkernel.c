@@ -0,0 +1,1015 @@
+﻿/**
+ * @file jkernel.c
+ * Copyright (c) 2024 Gaaagaa. All rights reserved.
+ * 
+ * @author  : Gaaagaa
+ * @date    : 2024-11-05
+ * @version : 1.0.0.0
+ * @brief   : libjpeg 热点函数（IDCT、FDCT、色彩转换、采样、熵编解码）的微基准测试程序，
+ *            在缓存驻留的数据上 逐个计时，并对同一函数的各个实现版本 比对输出结果。
+ */
+
+#define JPEG_INTERNALS
+#include "jinclude.h"
+#include "jpeglib.h"
+#include "jdct.h"
+#include "jsimd.h"
+
+#include "jthread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define JKERNEL_IMGW    1024    ///< 测试图像 宽度
+#define JKERNEL_IMGH    128     ///< 测试图像 高度
+#define JKERNEL_ROWS    16      ///< 行处理函数 每遍处理的行数
+#define JKERNEL_NBLK    256     ///< 块处理函数 每遍处理的块数
+#define JKERNEL_BATCH   16      ///< 无需复位的函数，每次计时 连续执行的遍数
+
+/**
+ * @enum  jkernel_var_t
+ * @brief 函数的实现版本（位掩码）。
+ */
+typedef enum jkernel_var_t
+{
+    JKERNEL_VAR_SCALAR = 0x0001, ///< C 代码
+    JKERNEL_VAR_SSE2   = 0x0002, ///< SSE2
+    JKERNEL_VAR_AVX2   = 0x0004, ///< AVX2
+    JKERNEL_VAR_AVX512 = 0x0008, ///< AVX-512
+} jkernel_var_t;
+
+/**
+ * 各个函数 具备专门实现的 指令集级别（与 jsimd*.c 的 jsimd_fill_*() 一致）；
+ * 较高的级别 沿用 较低级别的实现，故不再重复测试。
+ */
+#define JKERNEL_VAR_DCT         (JKERNEL_VAR_SCALAR | JKERNEL_VAR_AVX2)
+#define JKERNEL_VAR_COLOR       (JKERNEL_VAR_SCALAR | JKERNEL_VAR_AVX2)
+#define JKERNEL_VAR_SAMPLE      (JKERNEL_VAR_SCALAR | JKERNEL_VAR_SSE2 | JKERNEL_VAR_AVX2)
+#define JKERNEL_VAR_HUFF        (JKERNEL_VAR_SCALAR | JKERNEL_VAR_SSE2 | JKERNEL_VAR_AVX512)
+
+/**
+ * @struct jkernel_ctx_t
+ * @brief  单个函数测试的 工作上下文。
+ */
+typedef struct jkernel_ctx_t
+{
+    struct jpeg_decompress_struct jdinfo;  ///< 解压缩对象
+    struct jpeg_compress_struct   jcinfo;  ///< 压缩对象
+    struct jpeg_error_mgr         jerr;    ///< 错误处理对象
+    struct jpeg_color_deconverter jstub;   ///< 替换 色彩转换 的空操作对象（隔离上采样）
+    j_bool_t     jbl_dinfo;                ///< 是否 已创建解压缩对象
+    j_bool_t     jbl_cinfo;                ///< 是否 已创建压缩对象
+    j_bool_t     jbl_check;                ///< 当前 是否为 比对输出的执行遍
+
+    j_int_t      jit_parm;                 ///< 函数参数（IDCT 的块尺寸）
+    inverse_DCT_method_ptr jfn_idct;       ///< 测试的 IDCT 函数
+    forward_DCT_method_ptr jfn_fdct;       ///< 测试的 FDCT 函数
+    JSAMPIMAGE   jsi_iimg;                 ///< 输入的 分量平面
+    JSAMPIMAGE   jsi_oimg;                 ///< 输出的 分量平面
+    JSAMPARRAY   jsa_irow;                 ///< 输入的 交织像素行
+    JSAMPARRAY   jsa_orow;                 ///< 输出的 交织像素行
+    JBLOCKROW    jbr_blks;                 ///< 系数块
+    JBLOCKROW  * jbr_mcus;                 ///< MCU 的 系数块指针数组
+    DCTELEM    * jde_dcts;                 ///< FDCT 的输出
+    j_uint_t     jut_nmcu;                 ///< MCU 数量
+    j_uint_t     jut_nbim;                 ///< 每个 MCU 的 块数量
+
+    j_mptr_t     jmt_dbuf;                 ///< 编码输出缓存
+    size_t       jst_dlen;                 ///< 编码输出缓存 的容量
+
+    j_mptr_t     jmt_oput;                 ///< 需要比对的 输出数据
+    j_size_t     jst_oput;                 ///< 需要比对的 输出数据 字节数
+    j_uint_t     jut_unit;                 ///< 每遍处理的 计量单位数量
+    double       jdt_mpxl;                 ///< 每遍处理的 像素数量（百万）
+} jkernel_ctx_t;
+
+/**
+ * @struct jkernel_t
+ * @brief  测试的函数 描述信息。
+ */
+typedef struct jkernel_t
+{
+    j_cstring_t jsz_name;                           ///< 函数名称
+    j_cstring_t jsz_unit;                           ///< 计量单位名称
+    j_uint_t    jut_vars;                           ///< 具备的实现版本（jkernel_var_t 位掩码）
+    j_int_t     jit_parm;                           ///< 函数参数
+    j_void_t (* jfn_open )(jkernel_ctx_t * jctx);   ///< 建立工作对象 与 输入数据
+    j_void_t (* jfn_reset)(jkernel_ctx_t * jctx);   ///< 每遍执行前的复位（不计时，可为 J_NULL）
+    j_void_t (* jfn_pass )(jkernel_ctx_t * jctx);   ///< 执行一遍（计时）
+} jkernel_t;
+
+j_cstring_t JSZ_kern = J_NULL;  ///< 只测试 名称包含该字符串的函数
+j_uint_t    JUT_loop = 5;       ///< 每项测试的重复次数（取最佳值）
+j_uint_t    JUT_mint = 20;      ///< 每次计时的 最短时长（毫秒）
+
+JSAMPLE       * JMT_pxls = J_NULL; ///< 合成的 RGB 测试图像
+unsigned char * JMT_jpeg = J_NULL; ///< 测试图像 编码得到的 JPEG 数据
+size_t          JST_jpeg = 0;      ///< JPEG 数据 字节数
+
+/**********************************************************/
+/**
+ * @brief 输出程序帮助信息。
+ */
+void usage(const char * xsz_name)
+{
+    printf(
+        "usage: %s [-k name] [-l loops] [-m milliseconds]\n"
+        "       -k : only run the kernels whose name contains the string;\n"
+        "       -l : the number of runs per kernel (the best one is reported), default is 5;\n"
+        "       -m : the minimum time of each run in milliseconds, default is 20.\n"
+        "       every implementation (scalar, SSE2, AVX2, AVX-512) of a kernel that the CPU\n"
+        "       supports is run, and its output is compared with the one of the scalar\n"
+        "       implementation.\n\n",
+        xsz_name);
+}
+
+/**********************************************************/
+/**
+ * @brief 选择 libjpeg 所使用的 实现版本（通过 jpeg_simd_force()）。
+ * 
+ * @return j_bool_t : CPU 不支持该版本时 返回 J_FALSE 。
+ */
+static j_bool_t jkernel_select(jkernel_var_t jvar)
+{
+    j_int_t jit_level = JSIMD_NONE;
+
+    switch (jvar)
+    {
+    case JKERNEL_VAR_SSE2  : jit_level = JSIMD_SSE2  ; break;
+    case JKERNEL_VAR_AVX2  : jit_level = JSIMD_AVX2  ; break;
+    case JKERNEL_VAR_AVX512: jit_level = JSIMD_AVX512; break;
+    default                : jit_level = JSIMD_NONE  ; break;
+    }
+
+    return (jpeg_simd_force(jit_level) == jit_level) ? J_TRUE : J_FALSE;
+}
+
+/**********************************************************/
+/**
+ * @brief 分配 jut_npln 个分量平面（每个平面 jut_rows 行、jut_cols 列，像素连续存放，
+ *        即 首个平面的首行 jsi_image[0][0] 为整个存储区的起始地址）。
+ */
+static JSAMPIMAGE jkernel_planes(j_uint_t jut_npln, j_uint_t jut_rows, j_uint_t jut_cols)
+{
+    JSAMPIMAGE jsi_image = (JSAMPIMAGE)malloc(jut_npln * sizeof(JSAMPARRAY));
+    JSAMPARRAY jsa_rows  = (JSAMPARRAY)malloc(jut_npln * jut_rows * sizeof(JSAMPROW));
+    j_mptr_t   jmt_pxls  = (j_mptr_t)calloc(jut_npln * jut_rows, jut_cols);
+    j_uint_t   jut_iter  = 0;
+
+    if ((J_NULL == jsi_image) || (J_NULL == jsa_rows) || (J_NULL == jmt_pxls))
+    {
+        fprintf(stderr, "malloc failed!\n");
+        exit(-1);
+    }
+
+    for (jut_iter = 0; jut_iter < jut_npln * jut_rows; ++jut_iter)
+        jsa_rows[jut_iter] = (JSAMPROW)(jmt_pxls + (j_size_t)jut_iter * jut_cols);
+    for (jut_iter = 0; jut_iter < jut_npln; ++jut_iter)
+        jsi_image[jut_iter] = jsa_rows + jut_iter * jut_rows;
+
+    return jsi_image;
+}
+
+/**********************************************************/
+/**
+ * @brief 释放 jkernel_planes() 分配的 分量平面。
+ */
+static j_void_t jkernel_planes_free(JSAMPIMAGE jsi_image)
+{
+    if (J_NULL != jsi_image)
+    {
+        free(jsi_image[0][0]);
+        free(jsi_image[0]);
+        free(jsi_image);
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 生成合成测试图像（渐变 + 硬边缘 + 伪随机噪声），并以 质量 75 编码为 JPEG 。
+ */
+static j_void_t jkernel_source(void)
+{
+    struct jpeg_compress_struct jcinfo;
+    struct jpeg_error_mgr       jerr;
+    JSAMPROW jsr_row  = J_NULL;
+    j_uint_t jut_xpos = 0;
+    j_uint_t jut_ypos = 0;
+    j_uint_t jut_rand = 1;
+
+    JMT_pxls = (JSAMPLE *)malloc(JKERNEL_IMGW * JKERNEL_IMGH * 3);
+    if (J_NULL == JMT_pxls)
+    {
+        fprintf(stderr, "malloc failed!\n");
+        exit(-1);
+    }
+
+    for (jut_ypos = 0; jut_ypos < JKERNEL_IMGH; ++jut_ypos)
+    {
+        jsr_row = JMT_pxls + jut_ypos * JKERNEL_IMGW * 3;
+        for (jut_xpos = 0; jut_xpos < JKERNEL_IMGW; ++jut_xpos)
+        {
+            j_uint_t jut_edge = (((jut_xpos / 40) ^ (jut_ypos / 24)) & 1) ? 96 : 0;
+
+            jut_rand = jut_rand * 1103515245u + 12345u;
+
+            jsr_row[3 * jut_xpos + 0] = (JSAMPLE)((jut_xpos / 4 + jut_edge + ((jut_rand >> 16) & 31)) & 0xFF);
+            jsr_row[3 * jut_xpos + 1] = (JSAMPLE)((jut_ypos * 2 + jut_edge + ((jut_rand >> 21) & 31)) & 0xFF);
+            jsr_row[3 * jut_xpos + 2] = (JSAMPLE)(((jut_xpos ^ jut_ypos) + ((jut_rand >> 26) & 31)) & 0xFF);
+        }
+    }
+
+    jcinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_compress(&jcinfo);
+    jpeg_mem_dest(&jcinfo, &JMT_jpeg, &JST_jpeg);
+
+    jcinfo.image_width      = JKERNEL_IMGW;
+    jcinfo.image_height     = JKERNEL_IMGH;
+    jcinfo.input_components = 3;
+    jcinfo.in_color_space   = JCS_RGB;
+    jpeg_set_defaults(&jcinfo);
+    jpeg_set_quality(&jcinfo, 75, TRUE);
+
+    jpeg_start_compress(&jcinfo, TRUE);
+    while (jcinfo.next_scanline < jcinfo.image_height)
+    {
+        jsr_row = JMT_pxls + jcinfo.next_scanline * JKERNEL_IMGW * 3;
+        jpeg_write_scanlines(&jcinfo, &jsr_row, 1);
+    }
+    jpeg_finish_compress(&jcinfo);
+    jpeg_destroy_compress(&jcinfo);
+}
+
+//====================================================================
+
+//
+// 工作对象
+//
+
+/**********************************************************/
+/**
+ * @brief 建立 解压缩对象，并以指定的 输出色彩空间 启动解压缩。
+ */
+static j_void_t jkernel_dopen(jkernel_ctx_t * jctx, J_COLOR_SPACE jcs_oput, boolean jbl_fancy)
+{
+    if (!jctx->jbl_dinfo)
+    {
+        jctx->jdinfo.err = jpeg_std_error(&jctx->jerr);
+        jpeg_create_decompress(&jctx->jdinfo);
+        jctx->jbl_dinfo = J_TRUE;
+    }
+    else
+    {
+        jpeg_abort_decompress(&jctx->jdinfo);
+    }
+
+    jpeg_mem_src(&jctx->jdinfo, JMT_jpeg, JST_jpeg);
+    jpeg_read_header(&jctx->jdinfo, TRUE);
+    jctx->jdinfo.out_color_space     = jcs_oput;
+    jctx->jdinfo.do_fancy_upsampling = jbl_fancy;
+    jpeg_start_decompress(&jctx->jdinfo);
+}
+
+/**********************************************************/
+/**
+ * @brief 建立 压缩对象（RGB => YCC，质量 75，4:2:0），并启动压缩（输出到 预分配的缓存）。
+ * @note  jbl_fancy 为 TRUE 时，色度分量 以缩放 FDCT（jpeg_fdct_16x16）完成下采样，
+ *        为 FALSE 时，才会使用 jcsample.c 的 h2v2_downsample() 。
+ */
+static j_void_t jkernel_copen(jkernel_ctx_t * jctx, boolean jbl_fancy)
+{
+    if (!jctx->jbl_cinfo)
+    {
+        jctx->jcinfo.err = jpeg_std_error(&jctx->jerr);
+        jpeg_create_compress(&jctx->jcinfo);
+        jctx->jbl_cinfo = J_TRUE;
+
+        jctx->jcinfo.image_width      = JKERNEL_IMGW;
+        jctx->jcinfo.image_height     = JKERNEL_IMGH;
+        jctx->jcinfo.input_components = 3;
+        jctx->jcinfo.in_color_space   = JCS_RGB;
+        jpeg_set_defaults(&jctx->jcinfo);
+        jpeg_set_quality(&jctx->jcinfo, 75, TRUE);
+        jctx->jcinfo.do_fancy_downsampling = jbl_fancy;
+
+        jctx->jst_dlen = JKERNEL_IMGW * JKERNEL_IMGH * 3;
+        jctx->jmt_dbuf = (j_mptr_t)malloc(jctx->jst_dlen);
+        if (J_NULL == jctx->jmt_dbuf)
+        {
+            fprintf(stderr, "malloc failed!\n");
+            exit(-1);
+        }
+    }
+    else
+    {
+        jpeg_abort_compress(&jctx->jcinfo);
+    }
+
+    // 预分配的缓存 足够容纳整幅图像，编码过程中 不会重新分配
+    jctx->jst_dlen = JKERNEL_IMGW * JKERNEL_IMGH * 3;
+    jpeg_mem_dest(&jctx->jcinfo, &jctx->jmt_dbuf, &jctx->jst_dlen);
+    jpeg_start_compress(&jctx->jcinfo, TRUE);
+}
+
+/**********************************************************/
+/**
+ * @brief 释放 工作上下文 中的全部资源。
+ */
+static j_void_t jkernel_close(jkernel_ctx_t * jctx)
+{
+    if (jctx->jbl_dinfo)
+        jpeg_destroy_decompress(&jctx->jdinfo);
+    if (jctx->jbl_cinfo)
+        jpeg_destroy_compress(&jctx->jcinfo);
+
+    jkernel_planes_free(jctx->jsi_iimg);
+    jkernel_planes_free(jctx->jsi_oimg);
+    if (J_NULL != jctx->jsa_irow)
+        free(jctx->jsa_irow);
+    if (J_NULL != jctx->jsa_orow)
+        free(jctx->jsa_orow);
+    if (J_NULL != jctx->jbr_blks)
+        free(jctx->jbr_blks);
+    if (J_NULL != jctx->jbr_mcus)
+        free(jctx->jbr_mcus);
+    if (J_NULL != jctx->jde_dcts)
+        free(jctx->jde_dcts);
+    if (J_NULL != jctx->jmt_dbuf)
+        free(jctx->jmt_dbuf);
+}
+
+/**********************************************************/
+/**
+ * @brief 以测试图像 填充 分量平面（每个平面 取一个 RGB 通道，超出图像宽度的列 重复边缘像素）。
+ */
+static j_void_t jkernel_fill(JSAMPIMAGE jsi_image, j_uint_t jut_npln, j_uint_t jut_rows, j_uint_t jut_cols)
+{
+    j_uint_t jut_ipln = 0;
+    j_uint_t jut_irow = 0;
+    j_uint_t jut_icol = 0;
+
+    for (jut_ipln = 0; jut_ipln < jut_npln; ++jut_ipln)
+    {
+        for (jut_irow = 0; jut_irow < jut_rows; ++jut_irow)
+        {
+            JSAMPLE * jsr_iptr = JMT_pxls + (jut_irow % JKERNEL_IMGH) * JKERNEL_IMGW * 3 + jut_ipln % 3;
+
+            for (jut_icol = 0; jut_icol < jut_cols; ++jut_icol)
+            {
+                jsi_image[jut_ipln][jut_irow][jut_icol] =
+                    jsr_iptr[3 * ((jut_icol < JKERNEL_IMGW) ? jut_icol : (JKERNEL_IMGW - 1))];
+            }
+        }
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 以熵解码 得到测试图像 全部 MCU 的系数块（jbr_blks、jbr_mcus），并保留 jdinfo 供后续使用。
+ */
+static j_void_t jkernel_mcus(jkernel_ctx_t * jctx)
+{
+    j_uint_t jut_iter = 0;
+
+    jkernel_dopen(jctx, JCS_RGB, TRUE);
+
+    jctx->jut_nbim = (j_uint_t)jctx->jdinfo.blocks_in_MCU;
+    jctx->jut_nmcu = (j_uint_t)(jctx->jdinfo.MCUs_per_row * jctx->jdinfo.MCU_rows_in_scan);
+    jctx->jbr_blks = (JBLOCKROW)calloc(jctx->jut_nmcu * jctx->jut_nbim, sizeof(JBLOCK));
+    jctx->jbr_mcus = (JBLOCKROW *)malloc(jctx->jut_nmcu * jctx->jut_nbim * sizeof(JBLOCKROW));
+    if ((J_NULL == jctx->jbr_blks) || (J_NULL == jctx->jbr_mcus))
+    {
+        fprintf(stderr, "malloc failed!\n");
+        exit(-1);
+    }
+
+    for (jut_iter = 0; jut_iter < jctx->jut_nmcu * jctx->jut_nbim; ++jut_iter)
+        jctx->jbr_mcus[jut_iter] = jctx->jbr_blks + jut_iter;
+
+    for (jut_iter = 0; jut_iter < jctx->jut_nmcu; ++jut_iter)
+        (*jctx->jdinfo.entropy->decode_mcu)(&jctx->jdinfo, jctx->jbr_mcus + jut_iter * jctx->jut_nbim);
+}
+
+//====================================================================
+
+//
+// IDCT 与 FDCT
+//
+
+/**
+ * 按块尺寸（1 ~ 16）索引的 IDCT 函数，8 即 jpeg_idct_islow() 。
+ */
+static const inverse_DCT_method_ptr JFN_idct[16] =
+{
+    jpeg_idct_1x1  , jpeg_idct_2x2  , jpeg_idct_3x3  , jpeg_idct_4x4  ,
+    jpeg_idct_5x5  , jpeg_idct_6x6  , jpeg_idct_7x7  , jpeg_idct_islow,
+    jpeg_idct_9x9  , jpeg_idct_10x10, jpeg_idct_11x11, jpeg_idct_12x12,
+    jpeg_idct_13x13, jpeg_idct_14x14, jpeg_idct_15x15, jpeg_idct_16x16,
+};
+
+/**********************************************************/
+/**
+ * @brief IDCT：输入为测试图像 前 JKERNEL_NBLK 个 MCU 的系数块，输出并排存放。
+ * @note  islow 的各个尺寸 共用同一个乘数表（即 量化表），取 Y 分量的。
+ */
+static j_void_t jkernel_idct_open(jkernel_ctx_t * jctx)
+{
+    jkernel_mcus(jctx);
+
+    jctx->jsi_oimg = jkernel_planes(1, 16, JKERNEL_NBLK * 16);
+    jctx->jmt_oput = (j_mptr_t)jctx->jsi_oimg[0][0];
+    jctx->jst_oput = 16 * JKERNEL_NBLK * 16;
+    jctx->jut_unit = JKERNEL_NBLK;
+    jctx->jdt_mpxl = (double)JKERNEL_NBLK * jctx->jit_parm * jctx->jit_parm / 1000000.0;
+
+    // jddctmgr.c 一样，islow 有 SIMD 实现时 选用之
+    jctx->jfn_idct = JFN_idct[jctx->jit_parm - 1];
+    if ((DCTSIZE == jctx->jit_parm) && (J_NULL != jsimd_methods()->idct_islow))
+        jctx->jfn_idct = jsimd_methods()->idct_islow;
+}
+
+static j_void_t jkernel_idct_pass(jkernel_ctx_t * jctx)
+{
+    inverse_DCT_method_ptr jfn_idct = jctx->jfn_idct;
+    jpeg_component_info  * jcompptr = &jctx->jdinfo.comp_info[0];
+    j_uint_t               jut_iter = 0;
+
+    for (jut_iter = 0; jut_iter < JKERNEL_NBLK; ++jut_iter)
+    {
+        (*jfn_idct)(&jctx->jdinfo,
+                    jcompptr,
+                    jctx->jbr_blks[jut_iter % (jctx->jut_nmcu * jctx->jut_nbim)],
+                    jctx->jsi_oimg[0],
+                    (JDIMENSION)(jut_iter * jctx->jit_parm));
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief FDCT：输入为测试图像 G 通道 的 JKERNEL_NBLK 个 8x8 像素块。
+ */
+static j_void_t jkernel_fdct_open(jkernel_ctx_t * jctx)
+{
+    jctx->jsi_iimg = jkernel_planes(3, JKERNEL_IMGH, JKERNEL_IMGW);
+    jkernel_fill(jctx->jsi_iimg, 3, JKERNEL_IMGH, JKERNEL_IMGW);
+
+    jctx->jde_dcts = (DCTELEM *)calloc(JKERNEL_NBLK * DCTSIZE2, sizeof(DCTELEM));
+    if (J_NULL == jctx->jde_dcts)
+    {
+        fprintf(stderr, "malloc failed!\n");
+        exit(-1);
+    }
+
+    jctx->jmt_oput = (j_mptr_t)jctx->jde_dcts;
+    jctx->jst_oput = JKERNEL_NBLK * DCTSIZE2 * sizeof(DCTELEM);
+    jctx->jut_unit = JKERNEL_NBLK;
+    jctx->jdt_mpxl = JKERNEL_NBLK * DCTSIZE2 / 1000000.0;
+
+    // jcdctmgr.c 一样，有 SIMD 实现时 选用之
+    jctx->jfn_fdct = jpeg_fdct_islow;
+    if (J_NULL != jsimd_methods()->fdct_islow)
+        jctx->jfn_fdct = jsimd_methods()->fdct_islow;
+}
+
+static j_void_t jkernel_fdct_pass(jkernel_ctx_t * jctx)
+{
+    const j_uint_t JUT_nbpr = JKERNEL_IMGW / DCTSIZE;
+    j_uint_t       jut_iter = 0;
+
+    for (jut_iter = 0; jut_iter < JKERNEL_NBLK; ++jut_iter)
+    {
+        (*jctx->jfn_fdct)(jctx->jde_dcts + jut_iter * DCTSIZE2,
+                          jctx->jsi_iimg[1] + (jut_iter / JUT_nbpr) * DCTSIZE,
+                          (JDIMENSION)((jut_iter % JUT_nbpr) * DCTSIZE));
+    }
+}
+
+//====================================================================
+
+//
+// 色彩转换
+//
+
+/**********************************************************/
+/**
+ * @brief ycc_rgb_convert()：YCC 4:2:0 以 RGB 输出时 jdcolor.c 选用的转换函数。
+ */
+static j_void_t jkernel_ycc_rgb_open(jkernel_ctx_t * jctx)
+{
+    jkernel_dopen(jctx, JCS_RGB, TRUE);
+
+    jctx->jsi_iimg = jkernel_planes(3, JKERNEL_ROWS, JKERNEL_IMGW);
+    jkernel_fill(jctx->jsi_iimg, 3, JKERNEL_ROWS, JKERNEL_IMGW);
+
+    jctx->jsi_oimg = jkernel_planes(1, JKERNEL_ROWS, JKERNEL_IMGW * 3);
+    jctx->jmt_oput = (j_mptr_t)jctx->jsi_oimg[0][0];
+    jctx->jst_oput = JKERNEL_ROWS * JKERNEL_IMGW * 3;
+    jctx->jut_unit = JKERNEL_ROWS;
+    jctx->jdt_mpxl = JKERNEL_ROWS * JKERNEL_IMGW / 1000000.0;
+}
+
+static j_void_t jkernel_ycc_rgb_pass(jkernel_ctx_t * jctx)
+{
+    (*jctx->jdinfo.cconvert->color_convert)(
+                &jctx->jdinfo, jctx->jsi_iimg, 0, jctx->jsi_oimg[0], JKERNEL_ROWS);
+}
+
+/**********************************************************/
+/**
+ * @brief rgb_ycc_convert()：RGB 编码为 YCC 时 jccolor.c 选用的转换函数。
+ */
+static j_void_t jkernel_rgb_ycc_open(jkernel_ctx_t * jctx)
+{
+    j_uint_t jut_iter = 0;
+
+    jkernel_copen(jctx, TRUE);
+
+    jctx->jsa_irow = (JSAMPARRAY)malloc(JKERNEL_ROWS * sizeof(JSAMPROW));
+    if (J_NULL == jctx->jsa_irow)
+    {
+        fprintf(stderr, "malloc failed!\n");
+        exit(-1);
+    }
+
+    for (jut_iter = 0; jut_iter < JKERNEL_ROWS; ++jut_iter)
+        jctx->jsa_irow[jut_iter] = JMT_pxls + jut_iter * JKERNEL_IMGW * 3;
+
+    jctx->jsi_oimg = jkernel_planes(3, JKERNEL_ROWS, JKERNEL_IMGW);
+    jctx->jmt_oput = (j_mptr_t)jctx->jsi_oimg[0][0];
+    jctx->jst_oput = 3 * JKERNEL_ROWS * JKERNEL_IMGW;
+    jctx->jut_unit = JKERNEL_ROWS;
+    jctx->jdt_mpxl = JKERNEL_ROWS * JKERNEL_IMGW / 1000000.0;
+}
+
+static j_void_t jkernel_rgb_ycc_pass(jkernel_ctx_t * jctx)
+{
+    (*jctx->jcinfo.cconvert->color_convert)(
+                &jctx->jcinfo, jctx->jsa_irow, jctx->jsi_oimg, 0, JKERNEL_ROWS);
+}
+
+//====================================================================
+
+//
+// 上采样 与 下采样
+//
+
+/**********************************************************/
+/**
+ * @brief h2v2_downsample()：关闭 fancy downsampling，经 sep_downsample() 调用，
+ *        4:2:0 的 Cb、Cr 分量 以 h2v2_downsample() 处理，Y 分量 只是行复制。
+ */
+static j_void_t jkernel_h2v2_down_open(jkernel_ctx_t * jctx)
+{
+    jkernel_copen(jctx, FALSE);
+
+    // 输入行 预留右侧的扩展空间（expand_right_edge() 会写入）
+    jctx->jsi_iimg = jkernel_planes(3, JKERNEL_ROWS, JKERNEL_IMGW + 32);
+    jkernel_fill(jctx->jsi_iimg, 3, JKERNEL_ROWS, JKERNEL_IMGW + 32);
+
+    jctx->jsi_oimg = jkernel_planes(3, JKERNEL_ROWS, JKERNEL_IMGW + 32);
+    jctx->jmt_oput = (j_mptr_t)jctx->jsi_oimg[0][0];
+    jctx->jst_oput = 3 * JKERNEL_ROWS * (JKERNEL_IMGW + 32);
+    jctx->jut_unit = JKERNEL_ROWS;
+    jctx->jdt_mpxl = JKERNEL_ROWS * JKERNEL_IMGW / 1000000.0;
+}
+
+static j_void_t jkernel_h2v2_down_pass(jkernel_ctx_t * jctx)
+{
+    j_uint_t jut_vmax = (j_uint_t)jctx->jcinfo.max_v_samp_factor;
+    j_uint_t jut_iter = 0;
+
+    for (jut_iter = 0; jut_iter < JKERNEL_ROWS / jut_vmax; ++jut_iter)
+    {
+        (*jctx->jcinfo.downsample->downsample)(
+                &jctx->jcinfo, jctx->jsi_iimg, jut_iter * jut_vmax, jctx->jsi_oimg, jut_iter);
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 空操作的 色彩转换：只在比对输出的执行遍中，复制 上采样得到的 Cb、Cr 行。
+ */
+static jkernel_ctx_t * JCTX_stub = J_NULL;
+
+METHODDEF(void) jkernel_stub_convert(
+                    j_decompress_ptr jdinfo,
+                    JSAMPIMAGE       jsi_iimg,
+                    JDIMENSION       jdm_irow,
+                    JSAMPARRAY       jsa_orow,
+                    int              jit_rows)
+{
+    j_int_t jit_iter = 0;
+
+    if ((J_NULL == JCTX_stub) || !JCTX_stub->jbl_check)
+    {
+        return;
+    }
+
+    for (jit_iter = 0; jit_iter < jit_rows; ++jit_iter)
+    {
+        memcpy(jsa_orow[jit_iter], jsi_iimg[1][jdm_irow + jit_iter], jdinfo->output_width);
+        memcpy(jsa_orow[jit_iter] + jdinfo->output_width,
+               jsi_iimg[2][jdm_irow + jit_iter], jdinfo->output_width);
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief h2v2_upsample()：关闭 fancy upsampling 并以 YCC 输出，经 sep_upsample() 调用，
+ *        色彩转换 替换为空操作，以隔离 上采样 本身的耗时。
+ * @note  这一版本的 libjpeg 没有 h2v2_fancy_upsample()，fancy upsampling 由
+ *        色度分量的 缩放 IDCT（jpeg_idct_16x16）完成，参看 IDCT 的测试项。
+ */
+static j_void_t jkernel_h2v2_up_open(jkernel_ctx_t * jctx)
+{
+    jkernel_dopen(jctx, JCS_YCbCr, FALSE);
+
+    jctx->jstub.start_pass    = jctx->jdinfo.cconvert->start_pass;
+    jctx->jstub.color_convert = jkernel_stub_convert;
+    jctx->jdinfo.cconvert     = &jctx->jstub;
+    JCTX_stub = jctx;
+
+    jctx->jsi_iimg = jkernel_planes(3, JKERNEL_ROWS, JKERNEL_IMGW + 32);
+    jkernel_fill(jctx->jsi_iimg, 3, JKERNEL_ROWS, JKERNEL_IMGW + 32);
+
+    jctx->jsi_oimg = jkernel_planes(1, JKERNEL_ROWS, JKERNEL_IMGW * 3);
+    jctx->jmt_oput = (j_mptr_t)jctx->jsi_oimg[0][0];
+    jctx->jst_oput = JKERNEL_ROWS * JKERNEL_IMGW * 3;
+    jctx->jut_unit = JKERNEL_ROWS;
+    jctx->jdt_mpxl = JKERNEL_ROWS * JKERNEL_IMGW / 1000000.0;
+}
+
+/**********************************************************/
+/**
+ * @brief h2v2_merged_upsample()：关闭 fancy upsampling 并以 RGB 输出时，
+ *        jdmerge.c 一并完成 上采样 与 色彩转换。
+ */
+static j_void_t jkernel_h2v2_merged_open(jkernel_ctx_t * jctx)
+{
+    jkernel_dopen(jctx, JCS_RGB, FALSE);
+
+    jctx->jsi_iimg = jkernel_planes(3, JKERNEL_ROWS, JKERNEL_IMGW + 32);
+    jkernel_fill(jctx->jsi_iimg, 3, JKERNEL_ROWS, JKERNEL_IMGW + 32);
+
+    jctx->jsi_oimg = jkernel_planes(1, JKERNEL_ROWS, JKERNEL_IMGW * 3);
+    jctx->jmt_oput = (j_mptr_t)jctx->jsi_oimg[0][0];
+    jctx->jst_oput = JKERNEL_ROWS * JKERNEL_IMGW * 3;
+    jctx->jut_unit = JKERNEL_ROWS;
+    jctx->jdt_mpxl = JKERNEL_ROWS * JKERNEL_IMGW / 1000000.0;
+}
+
+/**********************************************************/
+/**
+ * @brief 上采样的执行遍：以 行组 为单位，输出 JKERNEL_ROWS 行。
+ */
+static j_void_t jkernel_upsample_pass(jkernel_ctx_t * jctx)
+{
+    JDIMENSION jdm_igrp = 0;
+    JDIMENSION jdm_orow = 0;
+
+    // 复位 rows_to_go 等状态
+    (*jctx->jdinfo.upsample->start_pass)(&jctx->jdinfo);
+
+    while (jdm_orow < JKERNEL_ROWS)
+    {
+        (*jctx->jdinfo.upsample->upsample)(
+                &jctx->jdinfo,
+                jctx->jsi_iimg,
+                &jdm_igrp,
+                JKERNEL_ROWS / jctx->jdinfo.max_v_samp_factor,
+                jctx->jsi_oimg[0],
+                &jdm_orow,
+                JKERNEL_ROWS);
+    }
+}
+
+//====================================================================
+
+//
+// 熵解码 与 熵编码
+//
+
+/**********************************************************/
+/**
+ * @brief decode_mcu()：jdhuff.c 的顺序模式 Huffman 熵解码，解码测试图像的全部 MCU 。
+ */
+static j_void_t jkernel_decode_mcu_open(jkernel_ctx_t * jctx)
+{
+    jkernel_mcus(jctx);
+
+    jctx->jmt_oput = (j_mptr_t)jctx->jbr_blks;
+    jctx->jst_oput = jctx->jut_nmcu * jctx->jut_nbim * sizeof(JBLOCK);
+    jctx->jut_unit = jctx->jut_nmcu * jctx->jut_nbim;
+    jctx->jdt_mpxl = JKERNEL_IMGW * JKERNEL_IMGH / 1000000.0;
+}
+
+static j_void_t jkernel_decode_mcu_reset(jkernel_ctx_t * jctx)
+{
+    jkernel_dopen(jctx, JCS_RGB, TRUE);
+    memset(jctx->jbr_blks, 0, jctx->jut_nmcu * jctx->jut_nbim * sizeof(JBLOCK));
+}
+
+static j_void_t jkernel_decode_mcu_pass(jkernel_ctx_t * jctx)
+{
+    j_uint_t jut_iter = 0;
+
+    for (jut_iter = 0; jut_iter < jctx->jut_nmcu; ++jut_iter)
+    {
+        (*jctx->jdinfo.entropy->decode_mcu)(&jctx->jdinfo, jctx->jbr_mcus + jut_iter * jctx->jut_nbim);
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief encode_mcu_huff()：jchuff.c 的顺序模式 Huffman 熵编码，
+ *        编码 decode_mcu() 得到的 全部 MCU（编码参数 与 测试图像 相同）。
+ */
+static j_void_t jkernel_encode_mcu_open(jkernel_ctx_t * jctx)
+{
+    jkernel_mcus(jctx);
+    jkernel_copen(jctx, TRUE);
+
+    if ((j_uint_t)jctx->jcinfo.blocks_in_MCU != jctx->jut_nbim)
+    {
+        fprintf(stderr, "encode_mcu_huff : the MCU layout of the encoder does not match!\n");
+        exit(-1);
+    }
+
+    jctx->jut_unit = jctx->jut_nmcu * jctx->jut_nbim;
+    jctx->jdt_mpxl = JKERNEL_IMGW * JKERNEL_IMGH / 1000000.0;
+}
+
+static j_void_t jkernel_encode_mcu_reset(jkernel_ctx_t * jctx)
+{
+    jkernel_copen(jctx, TRUE);
+}
+
+static j_void_t jkernel_encode_mcu_pass(jkernel_ctx_t * jctx)
+{
+    j_uint_t jut_iter = 0;
+
+    for (jut_iter = 0; jut_iter < jctx->jut_nmcu; ++jut_iter)
+    {
+        (*jctx->jcinfo.entropy->encode_mcu)(&jctx->jcinfo, jctx->jbr_mcus + jut_iter * jctx->jut_nbim);
+    }
+
+    (*jctx->jcinfo.entropy->finish_pass)(&jctx->jcinfo);
+
+    // 输出数据 为 文件头 与 熵编码数据
+    jctx->jmt_oput = jctx->jmt_dbuf;
+    jctx->jst_oput = JKERNEL_IMGW * JKERNEL_IMGH * 3 - jctx->jcinfo.dest->free_in_buffer;
+}
+
+//====================================================================
+
+/**
+ * 测试的函数列表。
+ */
+static const jkernel_t JKERNEL_list[] =
+{
+    { "jpeg_idct_islow"     , "block", JKERNEL_VAR_DCT   ,  8, jkernel_idct_open       , J_NULL                  , jkernel_idct_pass       },
+    { "jpeg_idct_1x1"       , "block", JKERNEL_VAR_SCALAR,  1, jkernel_idct_open       , J_NULL                  , jkernel_idct_pass       },
+    { "jpeg_idct_2x2"       , "block", JKERNEL_VAR_SCALAR,  2, jkernel_idct_open       , J_NULL                  , jkernel_idct_pass       },
+    { "jpeg_idct_3x3"       , "block", JKERNEL_VAR_SCALAR,  3, jkernel_idct_open       , J_NULL                  , jkernel_idct_pass       },
+    { "jpeg_idct_4x4"       , "block", JKERNEL_VAR_SCALAR,  4, jkernel_idct_open       , J_NULL                  , jkernel_idct_pass       },
+    { "jpeg_idct_5x5"       , "block", JKERNEL_VAR_SCALAR,  5, jkernel_idct_open       , J_NULL                  , jkernel_idct_pass       },
+    { "jpeg_idct_6x6"       , "block", JKERNEL_VAR_SCALAR,  6, jkernel_idct_open       , J_NULL                  , jkernel_idct_pass       },
+    { "jpeg_idct_7x7"       , "block", JKERNEL_VAR_SCALAR,  7, jkernel_idct_open       , J_NULL                  , jkernel_idct_pass       },
+    { "jpeg_idct_9x9"       , "block", JKERNEL_VAR_SCALAR,  9, jkernel_idct_open       , J_NULL                  , jkernel_idct_pass       },
+    { "jpeg_idct_10x10"     , "block", JKERNEL_VAR_SCALAR, 10, jkernel_idct_open       , J_NULL                  , jkernel_idct_pass       },
+    { "jpeg_idct_11x11"     , "block", JKERNEL_VAR_SCALAR, 11, jkernel_idct_open       , J_NULL                  , jkernel_idct_pass       },
+    { "jpeg_idct_12x12"     , "block", JKERNEL_VAR_SCALAR, 12, jkernel_idct_open       , J_NULL                  , jkernel_idct_pass       },
+    { "jpeg_idct_13x13"     , "block", JKERNEL_VAR_SCALAR, 13, jkernel_idct_open       , J_NULL                  , jkernel_idct_pass       },
+    { "jpeg_idct_14x14"     , "block", JKERNEL_VAR_SCALAR, 14, jkernel_idct_open       , J_NULL                  , jkernel_idct_pass       },
+    { "jpeg_idct_15x15"     , "block", JKERNEL_VAR_SCALAR, 15, jkernel_idct_open       , J_NULL                  , jkernel_idct_pass       },
+    { "jpeg_idct_16x16"     , "block", JKERNEL_VAR_SCALAR, 16, jkernel_idct_open       , J_NULL                  , jkernel_idct_pass       },
+    { "jpeg_fdct_islow"     , "block", JKERNEL_VAR_DCT   ,  8, jkernel_fdct_open       , J_NULL                  , jkernel_fdct_pass       },
+    { "ycc_rgb_convert"     , "row"  , JKERNEL_VAR_COLOR ,  0, jkernel_ycc_rgb_open    , J_NULL                  , jkernel_ycc_rgb_pass    },
+    { "rgb_ycc_convert"     , "row"  , JKERNEL_VAR_COLOR ,  0, jkernel_rgb_ycc_open    , J_NULL                  , jkernel_rgb_ycc_pass    },
+    { "h2v2_upsample"       , "row"  , JKERNEL_VAR_SAMPLE,  0, jkernel_h2v2_up_open    , J_NULL                  , jkernel_upsample_pass   },
+    { "h2v2_merged_upsample", "row"  , JKERNEL_VAR_SCALAR,  0, jkernel_h2v2_merged_open, J_NULL                  , jkernel_upsample_pass   },
+    { "h2v2_downsample"     , "row"  , JKERNEL_VAR_SAMPLE,  0, jkernel_h2v2_down_open  , J_NULL                  , jkernel_h2v2_down_pass  },
+    { "decode_mcu"          , "block", JKERNEL_VAR_SCALAR,  0, jkernel_decode_mcu_open , jkernel_decode_mcu_reset, jkernel_decode_mcu_pass },
+    { "encode_mcu_huff"     , "block", JKERNEL_VAR_HUFF  ,  0, jkernel_encode_mcu_open , jkernel_encode_mcu_reset, jkernel_encode_mcu_pass },
+};
+
+/**********************************************************/
+/**
+ * @brief 以 jvar 版本 测试一个函数，返回每遍的最佳耗时（秒）。
+ * 
+ * @param [out] jmt_oput : 操作成功返回 比对用的输出数据（由调用方 free() 释放）。
+ * @param [out] jst_oput : 操作成功返回 比对用的输出数据 字节数。
+ */
+static double jkernel_run(
+                    const jkernel_t * jkern,
+                    jkernel_var_t     jvar,
+                    jkernel_ctx_t   * jctx,
+                    j_mptr_t        * jmt_oput,
+                    j_size_t        * jst_oput)
+{
+    j_uint_t jut_loop = 0;
+    j_uint_t jut_iter = 0;
+    j_uint_t jut_pass = 0;
+    double   jdt_tick = 0.0;
+    double   jdt_time = 0.0;
+    double   jdt_best = 0.0;
+
+    // 实现版本 在工作对象初始化时 选定
+    jkernel_select(jvar);
+
+    memset(jctx, 0, sizeof(jkernel_ctx_t));
+    jctx->jit_parm = jkern->jit_parm;
+    (*jkern->jfn_open)(jctx);
+
+    // 预热
+    if (J_NULL != jkern->jfn_reset)
+        (*jkern->jfn_reset)(jctx);
+    (*jkern->jfn_pass)(jctx);
+
+    for (jut_loop = 0; jut_loop < JUT_loop; ++jut_loop)
+    {
+        jdt_time = 0.0;
+        jut_pass = 0;
+
+        while (jdt_time < JUT_mint / 1000.0)
+        {
+            if (J_NULL != jkern->jfn_reset)
+            {
+                (*jkern->jfn_reset)(jctx);
+
+                jdt_tick = jthrd_clock();
+                (*jkern->jfn_pass)(jctx);
+                jdt_time += jthrd_clock() - jdt_tick;
+                jut_pass += 1;
+            }
+            else
+            {
+                jdt_tick = jthrd_clock();
+                for (jut_iter = 0; jut_iter < JKERNEL_BATCH; ++jut_iter)
+                    (*jkern->jfn_pass)(jctx);
+                jdt_time += jthrd_clock() - jdt_tick;
+                jut_pass += JKERNEL_BATCH;
+            }
+        }
+
+        jdt_time /= jut_pass;
+        if ((0 == jut_loop) || (jdt_time < jdt_best))
+            jdt_best = jdt_time;
+    }
+
+    // 比对输出的执行遍
+    jctx->jbl_check = J_TRUE;
+    if (J_NULL != jkern->jfn_reset)
+        (*jkern->jfn_reset)(jctx);
+    (*jkern->jfn_pass)(jctx);
+
+    *jst_oput = jctx->jst_oput;
+    *jmt_oput = (j_mptr_t)malloc(jctx->jst_oput);
+    if (J_NULL == *jmt_oput)
+    {
+        fprintf(stderr, "malloc failed!\n");
+        exit(-1);
+    }
+    memcpy(*jmt_oput, jctx->jmt_oput, jctx->jst_oput);
+
+    jkernel_close(jctx);
+    JCTX_stub = J_NULL;
+
+    return jdt_best;
+}
+
+/**********************************************************/
+/**
+ * @brief main function.
+ */
+int main(int argc, char * argv[])
+{
+    const struct { jkernel_var_t jvar; j_cstring_t jsz_name; } JVAR_list[] =
+    {
+        { JKERNEL_VAR_SCALAR, "scalar" },
+        { JKERNEL_VAR_SSE2  , "sse2"   },
+        { JKERNEL_VAR_AVX2  , "avx2"   },
+        { JKERNEL_VAR_AVX512, "avx512" },
+    };
+
+    j_int_t         jit_iter = 0;
+    j_uint_t        jut_kern = 0;
+    j_uint_t        jut_ivar = 0;
+    j_int_t         jit_fail = 0;
+    double          jdt_time = 0.0;
+    j_mptr_t        jmt_refr = J_NULL;
+    j_size_t        jst_refr = 0;
+    j_mptr_t        jmt_oput = J_NULL;
+    j_size_t        jst_oput = 0;
+    jkernel_ctx_t * jctx_ptr = J_NULL;
+
+    //======================================
+    // 解析参数
+
+    for (jit_iter = 1; jit_iter < argc; jit_iter += 2)
+    {
+        if (jit_iter + 1 >= argc)
+        {
+            usage(argv[0]);
+            return -1;
+        }
+
+        if (0 == strcmp("-k", argv[jit_iter]))
+            JSZ_kern = argv[jit_iter + 1];
+        else if (0 == strcmp("-l", argv[jit_iter]))
+            JUT_loop = (j_uint_t)strtoul(argv[jit_iter + 1], J_NULL, 0);
+        else if (0 == strcmp("-m", argv[jit_iter]))
+            JUT_mint = (j_uint_t)strtoul(argv[jit_iter + 1], J_NULL, 0);
+        else
+        {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    if (0 == JUT_loop)
+    {
+        usage(argv[0]);
+        return -1;
+    }
+
+    jctx_ptr = (jkernel_ctx_t *)calloc(1, sizeof(jkernel_ctx_t));
+    if (J_NULL == jctx_ptr)
+    {
+        fprintf(stderr, "calloc failed!\n");
+        return -1;
+    }
+
+    jkernel_source();
+
+    printf("%-22s %-8s %14s %10s  %s\n", "kernel", "variant", "ns/unit", "MP/s", "check");
+
+    //======================================
+    // 逐个函数、逐个实现版本 测试
+
+    for (jut_kern = 0; jut_kern < sizeof(JKERNEL_list) / sizeof(JKERNEL_list[0]); ++jut_kern)
+    {
+        const jkernel_t * jkern = &JKERNEL_list[jut_kern];
+
+        if ((J_NULL != JSZ_kern) && (J_NULL == strstr(jkern->jsz_name, JSZ_kern)))
+            continue;
+
+        for (jut_ivar = 0; jut_ivar < sizeof(JVAR_list) / sizeof(JVAR_list[0]); ++jut_ivar)
+        {
+            j_cstring_t jsz_check = "ref";
+
+            if (0 == (jkern->jut_vars & JVAR_list[jut_ivar].jvar))
+                continue;
+            if (!jkernel_select(JVAR_list[jut_ivar].jvar))
+                continue;
+
+            jdt_time = jkernel_run(jkern, JVAR_list[jut_ivar].jvar, jctx_ptr, &jmt_oput, &jst_oput);
+
+            // 第一个版本（C 代码）的输出 作为比对基准
+            if (J_NULL == jmt_refr)
+            {
+                jmt_refr = jmt_oput;
+                jst_refr = jst_oput;
+            }
+            else
+            {
+                if ((jst_refr == jst_oput) && (0 == memcmp(jmt_refr, jmt_oput, jst_oput)))
+                {
+                    jsz_check = "match";
+                }
+                else
+                {
+                    jsz_check = "MISMATCH";
+                    jit_fail  = -1;
+                }
+
+                free(jmt_oput);
+            }
+
+            printf("%-22s %-8s %8.2f/%-5s %10.2f  %s\n",
+                   jkern->jsz_name,
+                   JVAR_list[jut_ivar].jsz_name,
+                   jdt_time * 1.0e9 / jctx_ptr->jut_unit,
+                   jkern->jsz_unit,
+                   jctx_ptr->jdt_mpxl / jdt_time,
+                   jsz_check);
+        }
+
+        if (J_NULL != jmt_refr)
+        {
+            free(jmt_refr);
+            jmt_refr = J_NULL;
+        }
+    }
+
+    //======================================
+
+    free(jctx_ptr);
+    free(JMT_pxls);
+    free(JMT_jpeg);
+
+    return jit_fail;
+}
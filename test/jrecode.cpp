@@ -0,0 +1,311 @@
+﻿/**
+ * @file jrecode.cpp
+ * Copyright (c) 2024 Gaaagaa. All rights reserved.
+ * 
+ * @author  : Gaaagaa
+ * @date    : 2024-10-27
+ * @version : 1.0.0.0
+ * @brief   : JPEG 无损重新编码（jtrans_recode()）、重新量化（jtrans_requant()）、
+ *            灰度转换（jtrans_grayscale()）与 旋转/翻转（jtrans_rotate()）程序，
+ *            同时输出 吞吐量 与 压缩收益。
+ */
+
+#include "jtransform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+////////////////////////////////////////////////////////////////////////////////
+
+jtrans_recode_t JRC_parm = { JTRANS_RECODE_KEEP, JTRANS_RECODE_KEEP, JTRANS_RECODE_KEEP, J_FALSE };
+j_int_t         JIT_qual = 0;       ///< 重新量化的目标质量（0 表示 只做无损重新编码）
+j_bool_t        JBL_gray = J_FALSE; ///< 是否丢弃色度分量 转换为灰度图像
+j_int_t         JIT_rota = -1;      ///< 旋转/翻转 操作的类型（-1 表示 不做旋转/翻转）
+j_bool_t        JBL_trim = J_FALSE; ///< 旋转/翻转 时 是否裁掉 边缘不完整的 iMCU
+j_cstring_t     JSZ_oput = J_NULL;  ///< 输出文件（只针对单个输入文件）
+j_uint_t        JUT_loop = 3;       ///< 每个文件的重复次数（取最佳值）
+
+/**********************************************************/
+/**
+ * @brief 输出程序帮助信息。
+ */
+void usage(const char * xsz_name)
+{
+    printf(
+        "usage: %s [-p | -s] [-a | -H] [-O] [-r rows] [-l loops] [-o output] input [input ...]\n"
+        "       %s -q quality [-l loops] [-o output] input [input ...]\n"
+        "       %s -g [-l loops] [-o output] input [input ...]\n"
+        "       %s -t op [-T] [-l loops] [-o output] input [input ...]\n"
+        "       -p : recode to progressive mode;\n"
+        "       -s : recode to baseline (sequential) mode;\n"
+        "       -a : recode with arithmetic coding;\n"
+        "       -H : recode with Huffman coding;\n"
+        "       -O : optimize the Huffman tables (ignored with arithmetic coding);\n"
+        "       -r : the restart interval in MCU rows, 0 removes the restart markers;\n"
+        "       -l : the number of runs per file (the best one is reported), default is 3;\n"
+        "       -o : the output file, only for a single input file;\n"
+        "       -q : requantize the DCT coefficients to the given quality (1 ~ 100),\n"
+        "            it can not be used together with the lossless recoding options;\n"
+        "       -g : drop the chroma components (lossless color to grayscale conversion),\n"
+        "            it can not be used together with the other options;\n"
+        "       -t : lossless rotation/flip, op is one of flip_h, flip_v, transpose,\n"
+        "            transverse, rot_90, rot_180, rot_270, or an EXIF orientation (1 ~ 8)\n"
+        "            to undo, the EXIF orientation of the output is reset to 1;\n"
+        "       -T : trim the partial iMCUs on the mirrored edges (with -t only).\n"
+        "       the settings which are not specified keep the ones of the input image,\n"
+        "       the pixels are never touched (only the entropy coding is changed).\n\n",
+        xsz_name, xsz_name, xsz_name, xsz_name);
+}
+
+/**********************************************************/
+/**
+ * @brief 解析 -t 选项的 旋转/翻转 操作名称（或 EXIF 的 Orientation 标签值）。
+ *
+ * @return j_int_t : 操作类型（jtrans_rotate_t），无效名称 返回 -1 。
+ */
+static j_int_t jrecode_rotate(j_cstring_t jsz_name)
+{
+    static const struct
+    {
+        j_cstring_t     jsz_name;
+        jtrans_rotate_t jrotate;
+    } JROTATE_list[] =
+    {
+        { "flip_h"    , JTRANS_ROTATE_FLIP_H     },
+        { "flip_v"    , JTRANS_ROTATE_FLIP_V     },
+        { "transpose" , JTRANS_ROTATE_TRANSPOSE  },
+        { "transverse", JTRANS_ROTATE_TRANSVERSE },
+        { "rot_90"    , JTRANS_ROTATE_ROT_90     },
+        { "rot_180"   , JTRANS_ROTATE_ROT_180    },
+        { "rot_270"   , JTRANS_ROTATE_ROT_270    },
+    };
+
+    for (j_uint_t jut_iter = 0; jut_iter < sizeof(JROTATE_list) / sizeof(JROTATE_list[0]); ++jut_iter)
+    {
+        if (0 == strcmp(jsz_name, JROTATE_list[jut_iter].jsz_name))
+            return JROTATE_list[jut_iter].jrotate;
+    }
+
+    if (('1' <= jsz_name[0]) && (jsz_name[0] <= '8') && ('\0' == jsz_name[1]))
+        return jtrans_exif_rotate(jsz_name[0] - '0');
+
+    return -1;
+}
+
+/**********************************************************/
+/**
+ * @brief 获取当前时刻（以 秒 为单位）。
+ */
+static double jrecode_now(void)
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**********************************************************/
+/**
+ * @brief 读取整个文件的数据（返回的缓存，由调用方 free() 释放）。
+ */
+static j_mptr_t jrecode_load(j_cstring_t jsz_path, j_size_t * jst_size)
+{
+    FILE   * jfs_file = fopen(jsz_path, "rb");
+    j_mptr_t jmt_data = J_NULL;
+    long     jlt_size = 0;
+
+    if (J_NULL == jfs_file)
+    {
+        return J_NULL;
+    }
+
+    if ((0 == fseek(jfs_file, 0, SEEK_END)) && ((jlt_size = ftell(jfs_file)) > 0))
+    {
+        fseek(jfs_file, 0, SEEK_SET);
+        jmt_data = (j_mptr_t)malloc((j_size_t)jlt_size);
+        if ((J_NULL != jmt_data) &&
+            ((j_size_t)jlt_size != fread(jmt_data, 1, (j_size_t)jlt_size, jfs_file)))
+        {
+            free(jmt_data);
+            jmt_data = J_NULL;
+        }
+    }
+
+    fclose(jfs_file);
+
+    *jst_size = (j_size_t)jlt_size;
+    return jmt_data;
+}
+
+/**********************************************************/
+/**
+ * @brief main function.
+ */
+int main(int argc, char * argv[])
+{
+    j_int_t      jit_iter = 0;
+    j_int_t      jit_nfil = 0;
+    j_uint_t     jut_loop = 0;
+    j_int_t      jit_err  = 0;
+    j_size_t     jst_isize = 0;
+    j_size_t     jst_osize = 0;
+    j_size_t     jst_itotal = 0;
+    j_size_t     jst_ototal = 0;
+    double       jdt_time = 0.0;
+    double       jdt_best = 0.0;
+    double       jdt_total = 0.0;
+    j_mptr_t     jmt_idata = J_NULL;
+    jtransform_t jtransform;
+
+    //======================================
+    // 解析参数（选项之后的参数 均为输入文件）
+
+    for (jit_iter = 1; jit_iter < argc; ++jit_iter)
+    {
+        if ('-' != argv[jit_iter][0])
+            break;
+
+        if (0 == strcmp("-p", argv[jit_iter]))
+            JRC_parm.jit_prog = 1;
+        else if (0 == strcmp("-s", argv[jit_iter]))
+            JRC_parm.jit_prog = 0;
+        else if (0 == strcmp("-a", argv[jit_iter]))
+            JRC_parm.jit_arith = 1;
+        else if (0 == strcmp("-H", argv[jit_iter]))
+            JRC_parm.jit_arith = 0;
+        else if (0 == strcmp("-O", argv[jit_iter]))
+            JRC_parm.jbl_optim = J_TRUE;
+        else if ((0 == strcmp("-r", argv[jit_iter])) && (jit_iter + 1 < argc))
+            JRC_parm.jit_rrows = (j_int_t)strtol(argv[++jit_iter], J_NULL, 0);
+        else if ((0 == strcmp("-l", argv[jit_iter])) && (jit_iter + 1 < argc))
+            JUT_loop = (j_uint_t)strtoul(argv[++jit_iter], J_NULL, 0);
+        else if ((0 == strcmp("-o", argv[jit_iter])) && (jit_iter + 1 < argc))
+            JSZ_oput = argv[++jit_iter];
+        else if ((0 == strcmp("-q", argv[jit_iter])) && (jit_iter + 1 < argc))
+            JIT_qual = (j_int_t)strtol(argv[++jit_iter], J_NULL, 0);
+        else if (0 == strcmp("-g", argv[jit_iter]))
+            JBL_gray = J_TRUE;
+        else if ((0 == strcmp("-t", argv[jit_iter])) && (jit_iter + 1 < argc) &&
+                 ((JIT_rota = jrecode_rotate(argv[jit_iter + 1])) >= 0))
+            jit_iter += 1;
+        else if (0 == strcmp("-T", argv[jit_iter]))
+            JBL_trim = J_TRUE;
+        else
+        {
+            usage(argv[0]);
+            return -1;
+        }
+    }
+
+    jit_nfil = argc - jit_iter;
+    if ((jit_nfil <= 0) || (0 == JUT_loop) || ((J_NULL != JSZ_oput) && (1 != jit_nfil)) ||
+        (((0 != JIT_qual) || JBL_gray || (JIT_rota >= 0)) &&
+                            ((JTRANS_RECODE_KEEP != JRC_parm.jit_prog ) ||
+                             (JTRANS_RECODE_KEEP != JRC_parm.jit_arith) ||
+                             (JTRANS_RECODE_KEEP != JRC_parm.jit_rrows) ||
+                             JRC_parm.jbl_optim)) ||
+        ((0 != JIT_qual) && (JBL_gray || (JIT_qual < 1) || (JIT_qual > 100))) ||
+        ((JIT_rota >= 0) && ((0 != JIT_qual) || JBL_gray)) ||
+        (JBL_trim && (JIT_rota < 0)))
+    {
+        usage(argv[0]);
+        return -1;
+    }
+
+    if (!jtransform.valid())
+    {
+        printf("jtrans_alloc() failed!\n");
+        return -1;
+    }
+
+    //======================================
+    // 逐个文件 在内存中重新编码
+
+    for (; jit_iter < argc; ++jit_iter)
+    {
+        jmt_idata = jrecode_load(argv[jit_iter], &jst_isize);
+        if (J_NULL == jmt_idata)
+        {
+            printf("%s : read file failed!\n", argv[jit_iter]);
+            continue;
+        }
+
+        jtransform.config_input(JCTL_MODE_FMEMORY, jmt_idata, jst_isize);
+        jtransform.config_output(JCTL_MODE_FMEMORY, J_NULL, 0);
+
+        jdt_best = 0.0;
+        for (jut_loop = 0; jut_loop < JUT_loop; ++jut_loop)
+        {
+            jdt_time = jrecode_now();
+            if (0 != JIT_qual)
+                jit_err = jtransform.requant(JIT_qual);
+            else if (JBL_gray)
+                jit_err = jtransform.grayscale();
+            else if (JIT_rota >= 0)
+                jit_err = jtransform.rotate((jtrans_rotate_t)JIT_rota, JBL_trim);
+            else
+                jit_err = jtransform.recode(&JRC_parm);
+            jdt_time = jrecode_now() - jdt_time;
+
+            if (JTRANS_ERR_OK != jit_err)
+                break;
+
+            if ((0 == jut_loop) || (jdt_time < jdt_best))
+                jdt_best = jdt_time;
+        }
+
+        if (JTRANS_ERR_OK != jit_err)
+        {
+            printf("%s : %s() return error: %s\n",
+                   argv[jit_iter],
+                   (0 != JIT_qual) ? "jtrans_requant" :
+                   (JBL_gray ? "jtrans_grayscale" : ((JIT_rota >= 0) ? "jtrans_rotate" : "jtrans_recode")),
+                   jtrans_errno_name(jit_err));
+            free(jmt_idata);
+            continue;
+        }
+
+        jst_osize = jtransform.fmsize();
+
+        printf("%-40s %10zu -> %10zu bytes  %+7.2f%%  %8.2f MB/s\n",
+               argv[jit_iter],
+               jst_isize,
+               jst_osize,
+               100.0 * ((double)jst_osize - (double)jst_isize) / (double)jst_isize,
+               jst_isize / jdt_best / 1000000.0);
+
+        jst_itotal += jst_isize;
+        jst_ototal += jst_osize;
+        jdt_total  += jdt_best;
+
+        if (J_NULL != JSZ_oput)
+        {
+            FILE * jfs_file = fopen(JSZ_oput, "wb");
+            if ((J_NULL == jfs_file) ||
+                (jst_osize != fwrite(jtransform.fmdata(), 1, jst_osize, jfs_file)))
+            {
+                printf("write output file [%s] failed!\n", JSZ_oput);
+            }
+
+            if (J_NULL != jfs_file)
+                fclose(jfs_file);
+        }
+
+        free(jmt_idata);
+    }
+
+    //======================================
+    // 汇总
+
+    if ((jit_nfil > 1) && (jst_itotal > 0))
+    {
+        printf("%-40s %10zu -> %10zu bytes  %+7.2f%%  %8.2f MB/s\n",
+               "total",
+               jst_itotal,
+               jst_ototal,
+               100.0 * ((double)jst_ototal - (double)jst_itotal) / (double)jst_itotal,
+               jst_itotal / jdt_total / 1000000.0);
+    }
+
+    return 0;
+}
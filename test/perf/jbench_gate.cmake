@@ -0,0 +1,26 @@
+# jbench performance regression gate, run by the perf_* tests (ctest -L perf):
+#   cmake -DJBENCH=<jbench> -DJBENCH_ARGS="<options>" -DJBENCH_KIND=<kind>
+#         -DJBENCH_BASELINE=<json> -DJBENCH_TOLERANCE=<percent> -P jbench_gate.cmake
+# The baseline is machine specific and lives in the build directory: when it
+# does not exist yet, the current build records it (all kinds) and the test
+# passes; later runs compare against it. Refresh it with: make perf_baseline
+
+separate_arguments(JBENCH_ARGS)
+
+if (NOT EXISTS ${JBENCH_BASELINE})
+    message(STATUS "perf gate: no baseline yet, recording ${JBENCH_BASELINE}")
+    execute_process(COMMAND ${JBENCH} ${JBENCH_ARGS} -j ${JBENCH_BASELINE}
+                    RESULT_VARIABLE JBENCH_RESULT)
+    if (NOT JBENCH_RESULT EQUAL 0)
+        file(REMOVE ${JBENCH_BASELINE})
+        message(FATAL_ERROR "perf gate: recording the baseline failed (${JBENCH_RESULT})")
+    endif()
+    return()
+endif()
+
+execute_process(COMMAND ${JBENCH} ${JBENCH_ARGS} -b ${JBENCH_KIND}
+                        -c ${JBENCH_BASELINE} -r ${JBENCH_TOLERANCE}
+                RESULT_VARIABLE JBENCH_RESULT)
+if (NOT JBENCH_RESULT EQUAL 0)
+    message(FATAL_ERROR "perf gate: ${JBENCH_KIND} regressed against ${JBENCH_BASELINE}")
+endif()
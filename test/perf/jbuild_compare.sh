@@ -0,0 +1,66 @@
+#!/bin/sh
+# ====================================================================
+# Builds the optimization variants of CMakeLists.txt side by side and
+# compares their jbench throughput against the plain Release build.
+#
+# usage: test/perf/jbuild_compare.sh [workdir] [jbench options ...]
+#        the default jbench options are: -n 8 -w 1024 -h 768 -t 1 -l 5 -q 75
+# ====================================================================
+
+set -e
+
+JSRC=$(cd "$(dirname "$0")/../.." && pwd)
+JWORK=${1:-${TMPDIR:-/tmp}/jbuild_compare}
+[ $# -gt 0 ] && shift
+JARGS=${*:--n 8 -w 1024 -h 768 -t 1 -l 5 -q 75}
+JNCPU=$(getconf _NPROCESSORS_ONLN 2>/dev/null || echo 1)
+
+# name : cmake options
+JVARIANTS="
+noopt:-DCMAKE_BUILD_TYPE=None
+release:
+amalg:-DJPEG_AMALGAMATE=ON
+lto:-DJPEG_LTO=ON
+amalg_lto:-DJPEG_AMALGAMATE=ON -DJPEG_LTO=ON
+pgo:-DJPEG_AMALGAMATE=ON -DJPEG_LTO=ON -DJPEG_PGO=GENERATE
+"
+
+jbuild()
+{
+    JDIR=${JWORK}/$1
+    shift
+    cmake -S "${JSRC}" -B "${JDIR}" "$@" \
+          -DCMAKE_RUNTIME_OUTPUT_DIRECTORY="${JDIR}/bin" \
+          -DCMAKE_ARCHIVE_OUTPUT_DIRECTORY="${JDIR}/lib" > "${JDIR}.log" 2>&1
+    cmake --build "${JDIR}" -j"${JNCPU}" --target jbench jcorpus >> "${JDIR}.log" 2>&1
+}
+
+mkdir -p "${JWORK}"
+
+echo "${JVARIANTS}" | while IFS=: read -r JNAME JOPTS; do
+    [ -z "${JNAME}" ] && continue
+    echo "== building ${JNAME} (${JOPTS:-Release})"
+
+    # shellcheck disable=SC2086
+    jbuild "${JNAME}" ${JOPTS}
+
+    # PGO: train the instrumented build, then rebuild with the profile
+    if [ "${JNAME}" = "pgo" ]; then
+        cmake --build "${JWORK}/pgo" --target pgo_train >> "${JWORK}/pgo.log" 2>&1
+        jbuild pgo -DJPEG_PGO=USE
+    fi
+done
+
+echo
+echo "== jbench ${JARGS}"
+
+# shellcheck disable=SC2086
+"${JWORK}/release/bin/jbench" ${JARGS} -j "${JWORK}/release.json" > /dev/null
+
+for JNAME in noopt amalg lto amalg_lto pgo; do
+    echo
+    echo "== ${JNAME} vs release"
+    # shellcheck disable=SC2086
+    "${JWORK}/${JNAME}/bin/jbench" ${JARGS} -c "${JWORK}/release.json" -r 1000 | \
+        sed -n '/^perf gate: baseline/,$p' | sed '1,2d;$d;s/  [a-zA-Z]*$//' || true
+done
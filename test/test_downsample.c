@@ -0,0 +1,176 @@
+﻿/**
+ * @file test_downsample.c
+ * Copyright (c) 2024 Gaaagaa. All rights reserved.
+ * 
+ * @author  : Gaaagaa
+ * @date    : 2024-11-12
+ * @version : 1.0.0.0
+ * @brief   : 比对 jcsample.c 的 2:1 下采样（h2v1、h2v2、h2v2 平滑）在各个 SIMD 级别下
+ *            与 C 代码的输出结果：图像宽度 取 1 ~ 64（覆盖 向量宽度 32 的全部余数，
+ *            以及 需要 右侧边缘扩展 的奇数宽度），输入为 随机像素行。
+ */
+
+#define JPEG_INTERNALS
+#include "jinclude.h"
+#include "jpeglib.h"
+
+#include "jcomm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define JTEST_WMAX      64      ///< 测试的 最大图像宽度
+#define JTEST_COLS      256     ///< 分量行的 缓存宽度（含 右侧扩展 的余量）
+#define JTEST_ROWS      4       ///< 每个分量的 行数（上下各一行 平滑所需的上下文行）
+#define JTEST_NCHS      3       ///< 分量数量
+
+/**
+ * @struct jtest_mode_t
+ * @brief  下采样的 测试方式。
+ */
+typedef struct jtest_mode_t
+{
+    j_cstring_t jsz_name;       ///< 名称
+    j_int_t     jit_hsmp;       ///< 亮度分量 水平采样因子
+    j_int_t     jit_vsmp;       ///< 亮度分量 垂直采样因子
+    j_int_t     jit_smooth;     ///< 平滑因子（smoothing_factor）
+} jtest_mode_t;
+
+static const jtest_mode_t JMODE_list[] =
+{
+    { "h2v1_downsample"       , 2, 1,  0 },
+    { "h2v2_downsample"       , 2, 2,  0 },
+    { "h2v2_smooth_downsample", 2, 2, 50 },
+};
+
+static const j_cstring_t JSZ_level[] = { "scalar", "SSE2", "AVX2", "AVX-512" };
+
+/**********************************************************/
+/**
+ * @brief 伪随机数（固定种子，各次运行的输入相同）。
+ */
+static j_uint_t jtest_rand(j_uint_t * jut_seed)
+{
+    *jut_seed = *jut_seed * 1103515245u + 12345u;
+    return (*jut_seed >> 16);
+}
+
+/**********************************************************/
+/**
+ * @brief 在当前 SIMD 级别下，对宽度为 jut_imgw 的 随机像素行 执行一次下采样。
+ * 
+ * @param [in ] jmode_ptr : 下采样的 测试方式。
+ * @param [in ] jut_imgw  : 图像宽度。
+ * @param [out] jmt_oput  : 各个分量的 输出行（JTEST_NCHS * 2 * JTEST_COLS 字节）。
+ */
+static j_void_t jtest_downsample(
+                    const jtest_mode_t * jmode_ptr,
+                    j_uint_t             jut_imgw,
+                    j_mptr_t             jmt_oput)
+{
+    struct jpeg_compress_struct jcinfo;
+    struct jpeg_error_mgr       jerr;
+
+    JSAMPLE    jsm_iput[JTEST_NCHS][JTEST_ROWS][JTEST_COLS];
+    JSAMPROW   jsr_irow[JTEST_NCHS][JTEST_ROWS];
+    JSAMPROW   jsr_orow[JTEST_NCHS][2];
+    JSAMPARRAY jsa_iimg[JTEST_NCHS];
+    JSAMPARRAY jsa_oimg[JTEST_NCHS];
+
+    j_mptr_t      jmt_dbuf = J_NULL;
+    unsigned long jul_dlen = 0;
+    j_uint_t      jut_seed = jut_imgw;
+    j_int_t       jit_iter = 0;
+    j_int_t       jit_irow = 0;
+    j_int_t       jit_icol = 0;
+
+    for (jit_iter = 0; jit_iter < JTEST_NCHS; ++jit_iter)
+    {
+        for (jit_irow = 0; jit_irow < JTEST_ROWS; ++jit_irow)
+        {
+            for (jit_icol = 0; jit_icol < JTEST_COLS; ++jit_icol)
+                jsm_iput[jit_iter][jit_irow][jit_icol] = (JSAMPLE)jtest_rand(&jut_seed);
+            jsr_irow[jit_iter][jit_irow] = jsm_iput[jit_iter][jit_irow];
+        }
+
+        jsr_orow[jit_iter][0] = jmt_oput + (2 * jit_iter + 0) * JTEST_COLS;
+        jsr_orow[jit_iter][1] = jmt_oput + (2 * jit_iter + 1) * JTEST_COLS;
+
+        // 第 0 行 为 平滑时 读取的 上方上下文行
+        jsa_iimg[jit_iter] = jsr_irow[jit_iter] + 1;
+        jsa_oimg[jit_iter] = jsr_orow[jit_iter];
+    }
+
+    memset(jmt_oput, 0, JTEST_NCHS * 2 * JTEST_COLS);
+
+    jcinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_compress(&jcinfo);
+
+    jcinfo.image_width      = jut_imgw;
+    jcinfo.image_height     = 16;
+    jcinfo.input_components = JTEST_NCHS;
+    jcinfo.in_color_space   = JCS_RGB;
+    jpeg_set_defaults(&jcinfo);
+    jcinfo.comp_info[0].h_samp_factor = jmode_ptr->jit_hsmp;
+    jcinfo.comp_info[0].v_samp_factor = jmode_ptr->jit_vsmp;
+    jcinfo.do_fancy_downsampling      = FALSE;
+    jcinfo.smoothing_factor           = jmode_ptr->jit_smooth;
+
+    // jpeg_start_compress() 按 当前的 SIMD 级别 选择 下采样的方法
+    jpeg_mem_dest(&jcinfo, &jmt_dbuf, &jul_dlen);
+    jpeg_start_compress(&jcinfo, TRUE);
+
+    (*jcinfo.downsample->downsample)(&jcinfo, jsa_iimg, 0, jsa_oimg, 0);
+
+    jpeg_destroy_compress(&jcinfo);
+    if (J_NULL != jmt_dbuf)
+        free(jmt_dbuf);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char * argv[])
+{
+    j_byte_t jbt_cref[JTEST_NCHS * 2 * JTEST_COLS];
+    j_byte_t jbt_csmd[JTEST_NCHS * 2 * JTEST_COLS];
+
+    j_uint_t jut_mode = 0;
+    j_uint_t jut_imgw = 0;
+    j_int_t  jit_levl = 0;
+    j_int_t  jit_nerr = 0;
+
+    for (jit_levl = JSIMD_SSE2; jit_levl <= JSIMD_AVX512; ++jit_levl)
+    {
+        if (jpeg_simd_force(jit_levl) != jit_levl)
+        {
+            printf("%-8s : not supported by the CPU, skipped\n", JSZ_level[jit_levl]);
+            continue;
+        }
+
+        for (jut_mode = 0; jut_mode < sizeof(JMODE_list) / sizeof(JMODE_list[0]); ++jut_mode)
+        {
+            for (jut_imgw = 1; jut_imgw <= JTEST_WMAX; ++jut_imgw)
+            {
+                jpeg_simd_force(JSIMD_NONE);
+                jtest_downsample(&JMODE_list[jut_mode], jut_imgw, jbt_cref);
+
+                jpeg_simd_force(jit_levl);
+                jtest_downsample(&JMODE_list[jut_mode], jut_imgw, jbt_csmd);
+
+                if (0 != memcmp(jbt_cref, jbt_csmd, sizeof(jbt_cref)))
+                {
+                    printf("%-8s : %s, width %u : MISMATCH\n",
+                           JSZ_level[jit_levl], JMODE_list[jut_mode].jsz_name, jut_imgw);
+                    jit_nerr += 1;
+                }
+            }
+        }
+
+        printf("%-8s : widths 1 ~ %d checked\n", JSZ_level[jit_levl], JTEST_WMAX);
+    }
+
+    return (0 == jit_nerr) ? 0 : 1;
+}
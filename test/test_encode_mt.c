@@ -0,0 +1,536 @@
+﻿/**
+ * @file test_encode_mt.c
+ * Copyright (c) 2024 Gaaagaa. All rights reserved.
+ *
+ * @author  : Gaaagaa
+ * @date    : 2024-11-28
+ * @version : 1.0.0.0
+ * @brief   : 检查 jenc_image_mt()、jenc_batch()、jenc_ladder() 对 jenc_param_t 编码参数的支持：
+ *            条带并行编码 按各种采样因子（及 哈夫曼表优化）输出的 DCT 系数，须与 jenc_image()
+ *            的结果相同；渐进模式 与 重启间隔 须返回 JENC_ERR_EPARAM；批量编码 与 质量阶梯
+ *            各个任务的输出，须与 按相同参数 调用 jenc_image() 的结果 逐字节相同。
+ */
+
+#include "jencoder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "jpeglib.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define JTEST_IMGW      157     ///< 测试图像的 宽度（非 MCU 的整数倍）
+#define JTEST_IMGH      203     ///< 测试图像的 高度（非 MCU 的整数倍）
+#define JTEST_NCHS      3       ///< 测试图像的 通道数量（RGB）
+#define JTEST_QUAL      85      ///< 条带测试 与 批量测试 的压缩质量
+#define JTEST_SROWS     2       ///< 每个条带的 MCU 行数量（4:4:4 时 有 13 个条带，RST 序号会回绕）
+#define JTEST_NTHD      3       ///< 工作线程数量
+
+/** 测试图像（RGB） */
+static j_byte_t JBT_image[JTEST_IMGW * JTEST_IMGH * JTEST_NCHS];
+
+/** 条带测试 使用的 采样因子（哈夫曼表优化 逐个开关） */
+static const jenc_param_t JPARAM_samp[] =
+{
+    { JENC_PARAM_DEFAULT, JENC_PARAM_DEFAULT, JENC_PARAM_DEFAULT, JENC_PARAM_DEFAULT, J_FALSE },
+    { 1                 , 1                 , JENC_PARAM_DEFAULT, JENC_PARAM_DEFAULT, J_FALSE },
+    { 2                 , 1                 , JENC_PARAM_DEFAULT, JENC_PARAM_DEFAULT, J_FALSE },
+    { 1                 , 2                 , JENC_PARAM_DEFAULT, JENC_PARAM_DEFAULT, J_FALSE },
+};
+
+/** 批量测试 使用的 编码参数（最后一个 为无效参数） */
+static const jenc_param_t JPARAM_batch[] =
+{
+    { JENC_PARAM_DEFAULT, JENC_PARAM_DEFAULT, JENC_PARAM_DEFAULT, JENC_PARAM_DEFAULT, J_FALSE },
+    { 1                 , 1                 , 1                 , JENC_PARAM_DEFAULT, J_TRUE  },
+    { 2                 , 1                 , 0                 , 2                 , J_TRUE  },
+    { 1                 , 2                 , JENC_PARAM_DEFAULT, 1                 , J_FALSE },
+    { 5                 , 1                 , JENC_PARAM_DEFAULT, JENC_PARAM_DEFAULT, J_FALSE },
+};
+
+/** 质量阶梯测试 各个任务的 压缩质量 与 编码参数（最后一个 采样因子 与 第一个不同） */
+static const j_uint_t JUT_lqual[] = { 70, 85, 50, 90 };
+static const jenc_param_t JPARAM_ladder[] =
+{
+    { 1                 , 1                 , JENC_PARAM_DEFAULT, JENC_PARAM_DEFAULT, J_FALSE },
+    { 1                 , 1                 , 1                 , JENC_PARAM_DEFAULT, J_TRUE  },
+    { 1                 , 1                 , 0                 , 1                 , J_TRUE  },
+    { 2                 , 2                 , JENC_PARAM_DEFAULT, JENC_PARAM_DEFAULT, J_FALSE },
+};
+
+/**
+ * @struct jtest_coefs_t
+ * @brief  libjpeg 读出的 JPEG 图像的 DCT 系数 与 编码参数。
+ */
+typedef struct jtest_coefs_t
+{
+    j_int_t  jit_nchs;              ///< 分量数量
+    j_uint_t jut_rsti;              ///< 重启间隔（MCU 数量）
+    j_int_t  jit_hsmp[JTEST_NCHS];  ///< 各个分量的 水平采样因子
+    j_int_t  jit_vsmp[JTEST_NCHS];  ///< 各个分量的 垂直采样因子
+    j_uint_t jut_nblk[JTEST_NCHS];  ///< 各个分量的 DCT 块数量
+    UINT16   jqt_qval[JTEST_NCHS][DCTSIZE2]; ///< 各个分量的 量化表
+    JCOEF  * jcf_data[JTEST_NCHS];  ///< 各个分量的 全部 DCT 系数块（按行存放）
+} jtest_coefs_t;
+
+/**********************************************************/
+/**
+ * @brief 伪随机数（固定种子，各次运行的输入相同）。
+ */
+static j_uint_t jtest_rand(j_uint_t * jut_seed)
+{
+    *jut_seed = *jut_seed * 1103515245u + 12345u;
+    return (*jut_seed >> 16);
+}
+
+/**********************************************************/
+/**
+ * @brief 生成 渐变 + 噪声 的 RGB 测试图像。
+ */
+static j_void_t jtest_image(j_void_t)
+{
+    j_uint_t   jut_seed = 1;
+    j_uint_t   jut_xpos = 0;
+    j_uint_t   jut_ypos = 0;
+    j_byte_t * jbt_pixl = JBT_image;
+
+    for (jut_ypos = 0; jut_ypos < JTEST_IMGH; ++jut_ypos)
+    {
+        for (jut_xpos = 0; jut_xpos < JTEST_IMGW; ++jut_xpos, jbt_pixl += JTEST_NCHS)
+        {
+            jbt_pixl[0] = (j_byte_t)(jut_xpos * 3 + (jtest_rand(&jut_seed) & 31));
+            jbt_pixl[1] = (j_byte_t)(jut_ypos * 5);
+            jbt_pixl[2] = (j_byte_t)(255 - jut_xpos * 2 - jut_ypos + (jtest_rand(&jut_seed) & 15));
+        }
+    }
+}
+
+/**********************************************************/
+/**
+ * @brief 按指定的编码参数 编码测试图像（内存模式），输出拷贝至新申请的缓存。
+ *
+ * @param [in ] jparam_ptr : 编码参数。
+ * @param [in ] jut_qual   : 压缩质量。
+ * @param [in ] jut_nthd   : 为 0 时 使用 jenc_image()，否则 以此线程数量 使用 jenc_image_mt()。
+ * @param [out] jmt_jpeg   : 操作返回的 JPEG 数据（使用 free() 释放）。
+ * @param [out] jst_jlen   : 操作返回的 JPEG 数据字节数。
+ *
+ * @return j_int_t : 编码接口的错误码（JENC_ERR_OK 表示成功）。
+ */
+static j_int_t jtest_encode(
+                    const jenc_param_t * jparam_ptr,
+                    j_uint_t             jut_qual,
+                    j_uint_t             jut_nthd,
+                    j_mptr_t           * jmt_jpeg,
+                    j_size_t           * jst_jlen)
+{
+    jenc_this_t jenc_this = jenc_alloc(J_NULL);
+    j_int_t     jit_err   = JENC_ERR_UNKNOWN;
+
+    *jmt_jpeg = J_NULL;
+    *jst_jlen = 0;
+
+    jenc_config(jenc_this, JCTL_MODE_FMEMORY, J_NULL, 0, jut_qual);
+
+    jit_err = jenc_config_param(jenc_this, jparam_ptr);
+    if (JENC_ERR_OK == jit_err)
+    {
+        if (0 == jut_nthd)
+            jit_err = jenc_image(jenc_this, JENC_RGB_TO_YCC, JBT_image,
+                                 JTEST_IMGW * JTEST_NCHS, JTEST_IMGW, JTEST_IMGH);
+        else
+            jit_err = jenc_image_mt(jenc_this, JENC_RGB_TO_YCC, JBT_image,
+                                    JTEST_IMGW * JTEST_NCHS, JTEST_IMGW, JTEST_IMGH,
+                                    jut_nthd, JTEST_SROWS);
+    }
+
+    if (JENC_ERR_OK == jit_err)
+    {
+        *jst_jlen = jenc_fmsize(jenc_this);
+        *jmt_jpeg = (j_mptr_t)malloc(*jst_jlen);
+        memcpy(*jmt_jpeg, jenc_fmdata(jenc_this), *jst_jlen);
+    }
+
+    jenc_release(jenc_this);
+
+    return jit_err;
+}
+
+/**********************************************************/
+/**
+ * @brief 释放 jtest_read() 读出的 DCT 系数。
+ */
+static j_void_t jtest_free(jtest_coefs_t * jcoefs_ptr)
+{
+    j_int_t jit_iter = 0;
+
+    for (jit_iter = 0; jit_iter < JTEST_NCHS; ++jit_iter)
+    {
+        if (J_NULL != jcoefs_ptr->jcf_data[jit_iter])
+            free(jcoefs_ptr->jcf_data[jit_iter]);
+    }
+
+    memset(jcoefs_ptr, 0, sizeof(jtest_coefs_t));
+}
+
+/**********************************************************/
+/**
+ * @brief 使用 libjpeg 读出 JPEG 数据的 DCT 系数 与 编码参数。
+ *
+ * @return j_bool_t : 解码过程 是否没有警告（如 RST 标记序号错误；出错时 libjpeg 直接退出）。
+ */
+static j_bool_t jtest_read(
+                    j_mptr_t        jmt_jpeg,
+                    j_size_t        jst_jlen,
+                    jtest_coefs_t * jcoefs_ptr)
+{
+    struct jpeg_decompress_struct jdinfo;
+    struct jpeg_error_mgr         jerr;
+
+    jvirt_barray_ptr    * jarr_ptr  = J_NULL;
+    jpeg_component_info * jcomp_ptr = J_NULL;
+    JBLOCKARRAY           jblk_row  = J_NULL;
+    j_int_t               jit_iter  = 0;
+    j_uint_t              jut_yblk  = 0;
+
+    memset(jcoefs_ptr, 0, sizeof(jtest_coefs_t));
+
+    jdinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_decompress(&jdinfo);
+    jpeg_mem_src(&jdinfo, jmt_jpeg, (unsigned long)jst_jlen);
+    jpeg_read_header(&jdinfo, TRUE);
+
+    jcoefs_ptr->jut_rsti = jdinfo.restart_interval;
+    jcoefs_ptr->jit_nchs = jdinfo.num_components;
+
+    jarr_ptr = jpeg_read_coefficients(&jdinfo);
+
+    for (jit_iter = 0; (jit_iter < jdinfo.num_components) && (jit_iter < JTEST_NCHS); ++jit_iter)
+    {
+        jcomp_ptr = &jdinfo.comp_info[jit_iter];
+
+        jcoefs_ptr->jit_hsmp[jit_iter] = jcomp_ptr->h_samp_factor;
+        jcoefs_ptr->jit_vsmp[jit_iter] = jcomp_ptr->v_samp_factor;
+        jcoefs_ptr->jut_nblk[jit_iter] = jcomp_ptr->width_in_blocks * jcomp_ptr->height_in_blocks;
+        memcpy(jcoefs_ptr->jqt_qval[jit_iter], jcomp_ptr->quant_table->quantval, sizeof(UINT16) * DCTSIZE2);
+
+        jcoefs_ptr->jcf_data[jit_iter] = (JCOEF *)malloc(
+            (j_size_t)jcoefs_ptr->jut_nblk[jit_iter] * sizeof(JBLOCK));
+
+        for (jut_yblk = 0; jut_yblk < jcomp_ptr->height_in_blocks; ++jut_yblk)
+        {
+            jblk_row = (*jdinfo.mem->access_virt_barray)(
+                            (j_common_ptr)&jdinfo, jarr_ptr[jit_iter], jut_yblk, 1, FALSE);
+            memcpy(jcoefs_ptr->jcf_data[jit_iter] +
+                       (j_size_t)jut_yblk * jcomp_ptr->width_in_blocks * DCTSIZE2,
+                   jblk_row[0],
+                   jcomp_ptr->width_in_blocks * sizeof(JBLOCK));
+        }
+    }
+
+    jpeg_finish_decompress(&jdinfo);
+    jpeg_destroy_decompress(&jdinfo);
+
+    return (0 == jerr.num_warnings);
+}
+
+/**********************************************************/
+/**
+ * @brief 比较两份 DCT 系数（含 采样因子 与 量化表）是否相同，忽略重启间隔。
+ */
+static j_bool_t jtest_same_coefs(const jtest_coefs_t * jcoefs_lhs, const jtest_coefs_t * jcoefs_rhs)
+{
+    j_int_t jit_iter = 0;
+
+    if ((jcoefs_lhs->jit_nchs != JTEST_NCHS) || (jcoefs_rhs->jit_nchs != JTEST_NCHS))
+    {
+        return J_FALSE;
+    }
+
+    for (jit_iter = 0; jit_iter < JTEST_NCHS; ++jit_iter)
+    {
+        if ((jcoefs_lhs->jit_hsmp[jit_iter] != jcoefs_rhs->jit_hsmp[jit_iter]) ||
+            (jcoefs_lhs->jit_vsmp[jit_iter] != jcoefs_rhs->jit_vsmp[jit_iter]) ||
+            (jcoefs_lhs->jut_nblk[jit_iter] != jcoefs_rhs->jut_nblk[jit_iter]) ||
+            (0 != memcmp(jcoefs_lhs->jqt_qval[jit_iter], jcoefs_rhs->jqt_qval[jit_iter],
+                         sizeof(UINT16) * DCTSIZE2)) ||
+            (0 != memcmp(jcoefs_lhs->jcf_data[jit_iter], jcoefs_rhs->jcf_data[jit_iter],
+                         jcoefs_lhs->jut_nblk[jit_iter] * sizeof(JBLOCK))))
+        {
+            return J_FALSE;
+        }
+    }
+
+    return J_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief 条带并行编码：各种采样因子 及 哈夫曼表优化 下，DCT 系数 与 jenc_image() 相同，
+ *        重启间隔 为条带的 MCU 数量，优化后的数据 更小，且与线程数量无关。
+ *
+ * @return j_int_t : 失败的检查项数量。
+ */
+static j_int_t jtest_stripe(j_void_t)
+{
+    jenc_param_t  jparam;
+    jtest_coefs_t jcoefs_ref;
+    jtest_coefs_t jcoefs_str;
+    j_mptr_t      jmt_jref = J_NULL;
+    j_mptr_t      jmt_jstr = J_NULL;
+    j_mptr_t      jmt_jone = J_NULL;
+    j_size_t      jst_lref = 0;
+    j_size_t      jst_lstr = 0;
+    j_size_t      jst_lone = 0;
+    j_size_t      jst_lpln = 0;
+    j_uint_t      jut_iter = 0;
+    j_uint_t      jut_rsti = 0;
+    j_int_t       jit_nerr = 0;
+    j_bool_t      jbl_okay = J_FALSE;
+
+    memset(&jcoefs_ref, 0, sizeof(jcoefs_ref));
+    memset(&jcoefs_str, 0, sizeof(jcoefs_str));
+
+    for (jut_iter = 0; jut_iter < 2 * sizeof(JPARAM_samp) / sizeof(JPARAM_samp[0]); ++jut_iter)
+    {
+        jparam           = JPARAM_samp[jut_iter / 2];
+        jparam.jbl_optim = (j_bool_t)(jut_iter & 1);
+
+        jbl_okay = (JENC_ERR_OK == jtest_encode(&jparam, JTEST_QUAL, 0, &jmt_jref, &jst_lref)) &&
+                   (JENC_ERR_OK == jtest_encode(&jparam, JTEST_QUAL, JTEST_NTHD, &jmt_jstr, &jst_lstr)) &&
+                   (JENC_ERR_OK == jtest_encode(&jparam, JTEST_QUAL, 1, &jmt_jone, &jst_lone));
+
+        if (jbl_okay)
+        {
+            jbl_okay = jtest_read(jmt_jref, jst_lref, &jcoefs_ref) &&
+                       jtest_read(jmt_jstr, jst_lstr, &jcoefs_str) &&
+                       jtest_same_coefs(&jcoefs_ref, &jcoefs_str);
+
+            // 重启间隔 = 条带的 MCU 行数量 × 每行的 MCU 数量
+            jut_rsti = (JTEST_IMGW + 8 * jcoefs_str.jit_hsmp[0] - 1) / (8 * jcoefs_str.jit_hsmp[0]);
+            jbl_okay = jbl_okay && (JTEST_SROWS * jut_rsti == jcoefs_str.jut_rsti);
+
+            jbl_okay = jbl_okay && (jst_lone == jst_lstr) && (0 == memcmp(jmt_jone, jmt_jstr, jst_lstr));
+
+            if (jparam.jbl_optim)
+                jbl_okay = jbl_okay && (jst_lstr < jst_lpln);
+            else
+                jst_lpln = jst_lstr;
+        }
+
+        if (!jbl_okay)
+        {
+            printf("stripe %d x %d, optimize %d : MISMATCH\n",
+                   jparam.jit_hsamp, jparam.jit_vsamp, (j_int_t)jparam.jbl_optim);
+            jit_nerr += 1;
+        }
+
+        jtest_free(&jcoefs_ref);
+        jtest_free(&jcoefs_str);
+        free(jmt_jref);
+        free(jmt_jstr);
+        free(jmt_jone);
+        jmt_jref = jmt_jstr = jmt_jone = J_NULL;
+    }
+
+    return jit_nerr;
+}
+
+/**********************************************************/
+/**
+ * @brief 条带并行编码：渐进模式 与 重启间隔 返回 JENC_ERR_EPARAM 。
+ *
+ * @return j_int_t : 失败的检查项数量。
+ */
+static j_int_t jtest_eparam(j_void_t)
+{
+    static const jenc_param_t JPARAM_list[] =
+    {
+        { JENC_PARAM_DEFAULT, JENC_PARAM_DEFAULT, 1                 , JENC_PARAM_DEFAULT, J_FALSE },
+        { JENC_PARAM_DEFAULT, JENC_PARAM_DEFAULT, JENC_PARAM_DEFAULT, 1                 , J_FALSE },
+    };
+
+    j_mptr_t jmt_jpeg = J_NULL;
+    j_size_t jst_jlen = 0;
+    j_uint_t jut_iter = 0;
+    j_int_t  jit_nerr = 0;
+
+    for (jut_iter = 0; jut_iter < sizeof(JPARAM_list) / sizeof(JPARAM_list[0]); ++jut_iter)
+    {
+        if (JENC_ERR_EPARAM != jtest_encode(&JPARAM_list[jut_iter], JTEST_QUAL, JTEST_NTHD, &jmt_jpeg, &jst_jlen))
+        {
+            printf("stripe prog %d, rrows %d : not rejected\n",
+                   JPARAM_list[jut_iter].jit_prog, JPARAM_list[jut_iter].jit_rrows);
+            jit_nerr += 1;
+        }
+
+        free(jmt_jpeg);
+        jmt_jpeg = J_NULL;
+    }
+
+    return jit_nerr;
+}
+
+/**********************************************************/
+/**
+ * @brief 比对 各个任务的输出 与 按相同参数调用 jenc_image() 的结果（逐字节）；
+ *        jit_ebad 所指的任务（为 -1 时 无），须返回 JENC_ERR_EPARAM 。
+ *
+ * @return j_int_t : 失败的检查项数量。
+ */
+static j_int_t jtest_check_jobs(
+                    j_cstring_t          jsz_name,
+                    const jenc_job_t   * jjob_arr,
+                    const jenc_param_t * jparam_arr,
+                    j_uint_t             jut_njob,
+                    j_int_t              jit_ebad)
+{
+    j_mptr_t jmt_jref = J_NULL;
+    j_size_t jst_lref = 0;
+    j_uint_t jut_iter = 0;
+    j_int_t  jit_nerr = 0;
+    j_bool_t jbl_okay = J_FALSE;
+
+    for (jut_iter = 0; jut_iter < jut_njob; ++jut_iter)
+    {
+        if ((j_int_t)jut_iter == jit_ebad)
+        {
+            jbl_okay = (JENC_ERR_EPARAM == jjob_arr[jut_iter].jit_err);
+        }
+        else
+        {
+            jbl_okay = (JENC_ERR_OK == jjob_arr[jut_iter].jit_err) &&
+                       (JENC_ERR_OK == jtest_encode(&jparam_arr[jut_iter], jjob_arr[jut_iter].jut_qual,
+                                                    0, &jmt_jref, &jst_lref)) &&
+                       (jst_lref == jjob_arr[jut_iter].jst_size) &&
+                       (0 == memcmp(jmt_jref, jjob_arr[jut_iter].jht_optr, jst_lref));
+        }
+
+        if (!jbl_okay)
+        {
+            printf("%s job %u (%s) : MISMATCH\n",
+                   jsz_name, jut_iter, jenc_errno_name(jjob_arr[jut_iter].jit_err));
+            jit_nerr += 1;
+        }
+
+        free(jmt_jref);
+        jmt_jref = J_NULL;
+    }
+
+    return jit_nerr;
+}
+
+/**********************************************************/
+/**
+ * @brief 批量编码：各个任务的编码参数 由其 jparam_ptr 字段指定。
+ *
+ * @return j_int_t : 失败的检查项数量。
+ */
+static j_int_t jtest_batch(j_void_t)
+{
+    const j_uint_t JUT_njob = (j_uint_t)(sizeof(JPARAM_batch) / sizeof(JPARAM_batch[0]));
+    const j_size_t JST_mlen = JTEST_IMGW * JTEST_IMGH * JTEST_NCHS;
+
+    jenc_job_t jjob_arr[sizeof(JPARAM_batch) / sizeof(JPARAM_batch[0])];
+    j_mptr_t   jmt_obuf = (j_mptr_t)malloc(JST_mlen * JUT_njob);
+    j_uint_t   jut_iter = 0;
+    j_int_t    jit_nerr = 0;
+
+    memset(jjob_arr, 0, sizeof(jjob_arr));
+    for (jut_iter = 0; jut_iter < JUT_njob; ++jut_iter)
+    {
+        jjob_arr[jut_iter].jccs_conv  = JENC_RGB_TO_YCC;
+        jjob_arr[jut_iter].jmt_pxls   = JBT_image;
+        jjob_arr[jut_iter].jit_step   = JTEST_IMGW * JTEST_NCHS;
+        jjob_arr[jut_iter].jut_imgw   = JTEST_IMGW;
+        jjob_arr[jut_iter].jut_imgh   = JTEST_IMGH;
+        jjob_arr[jut_iter].jut_qual   = JTEST_QUAL;
+        jjob_arr[jut_iter].jparam_ptr = &JPARAM_batch[jut_iter];
+        jjob_arr[jut_iter].jct_mode   = JCTL_MODE_FMEMORY;
+        jjob_arr[jut_iter].jht_optr   = jmt_obuf + JST_mlen * jut_iter;
+        jjob_arr[jut_iter].jst_mlen   = JST_mlen;
+    }
+
+    jenc_batch(jjob_arr, JUT_njob, JTEST_NTHD);
+    jit_nerr = jtest_check_jobs("batch", jjob_arr, JPARAM_batch, JUT_njob, (j_int_t)JUT_njob - 1);
+
+    free(jmt_obuf);
+
+    return jit_nerr;
+}
+
+/**********************************************************/
+/**
+ * @brief 质量阶梯：采样因子 以第一个任务为准，其余参数 逐个任务生效。
+ *
+ * @return j_int_t : 失败的检查项数量。
+ */
+static j_int_t jtest_ladder(j_void_t)
+{
+    const j_uint_t JUT_njob = (j_uint_t)(sizeof(JPARAM_ladder) / sizeof(JPARAM_ladder[0]));
+    const j_size_t JST_mlen = JTEST_IMGW * JTEST_IMGH * JTEST_NCHS;
+
+    jenc_job_t jjob_arr[sizeof(JPARAM_ladder) / sizeof(JPARAM_ladder[0])];
+    j_mptr_t   jmt_obuf = (j_mptr_t)malloc(JST_mlen * JUT_njob);
+    j_uint_t   jut_iter = 0;
+    j_int_t    jit_nerr = 0;
+
+    memset(jjob_arr, 0, sizeof(jjob_arr));
+    for (jut_iter = 0; jut_iter < JUT_njob; ++jut_iter)
+    {
+        jjob_arr[jut_iter].jut_qual   = JUT_lqual[jut_iter];
+        jjob_arr[jut_iter].jparam_ptr = &JPARAM_ladder[jut_iter];
+        jjob_arr[jut_iter].jct_mode   = JCTL_MODE_FMEMORY;
+        jjob_arr[jut_iter].jht_optr   = jmt_obuf + JST_mlen * jut_iter;
+        jjob_arr[jut_iter].jst_mlen   = JST_mlen;
+    }
+
+    jenc_ladder(JENC_RGB_TO_YCC, JBT_image, JTEST_IMGW * JTEST_NCHS,
+                JTEST_IMGW, JTEST_IMGH, jjob_arr, JUT_njob, JTEST_NTHD);
+    jit_nerr = jtest_check_jobs("ladder", jjob_arr, JPARAM_ladder, JUT_njob, (j_int_t)JUT_njob - 1);
+
+    free(jmt_obuf);
+
+    return jit_nerr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @struct jtest_case_t
+ * @brief  单项测试。
+ */
+typedef struct jtest_case_t
+{
+    j_cstring_t jsz_name;           ///< 名称
+    j_int_t  (* jfunc_ptr)(j_void_t); ///< 测试函数（返回 不一致的数量）
+} jtest_case_t;
+
+static const jtest_case_t JCASE_list[] =
+{
+    { "stripe", jtest_stripe },
+    { "eparam", jtest_eparam },
+    { "batch" , jtest_batch  },
+    { "ladder", jtest_ladder },
+};
+
+int main(int argc, char * argv[])
+{
+    j_uint_t jut_iter = 0;
+    j_int_t  jit_nerr = 0;
+    j_int_t  jit_case = 0;
+
+    jtest_image();
+
+    for (jut_iter = 0; jut_iter < sizeof(JCASE_list) / sizeof(JCASE_list[0]); ++jut_iter)
+    {
+        jit_case  = JCASE_list[jut_iter].jfunc_ptr();
+        jit_nerr += jit_case;
+
+        printf("%-6s : %s\n", JCASE_list[jut_iter].jsz_name, (0 == jit_case) ? "checked" : "FAILED");
+    }
+
+    return (0 == jit_nerr) ? 0 : 1;
+}
@@ -0,0 +1,357 @@
+﻿/**
+ * @file test_ladder.c
+ * Copyright (c) 2024 Gaaagaa. All rights reserved.
+ * 
+ * @author  : Gaaagaa
+ * @date    : 2024-11-14
+ * @version : 1.0.0.0
+ * @brief   : 比对 jdec_ladder() 各个缩放输出（1/1、1/2、1/4、1/8）与 常规解码的结果：
+ *            1/1 以 jdec_image() 为基准，其余尺寸 以 libjpeg 设置相同 scale_denom 的
+ *            解码为基准；输入为 libjpeg 现场编码的 基线、非交错多扫描、渐进式、
+ *            DC 非交错的渐进式 四种 JPEG 图像（奇数尺寸，4:2:0 采样）；
+ *            非 Windows 平台 还在设置 内存上限（DCT 系数缓存 换出至临时文件）时 重复比对，
+ *            并确认 需要换出时 若临时文件目录 不存在，jdec_ladder() 失败（即 上限 确实作用于其解码器）。
+ */
+
+#include "jdecoder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "jpeglib.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define JTEST_IMGW      67      ///< 测试图像的 宽度（非 MCU 的整数倍）
+#define JTEST_IMGH      45      ///< 测试图像的 高度（非 MCU 的整数倍）
+#define JTEST_NCHS      3       ///< 测试图像的 通道数量（RGB）
+#define JTEST_NRUNG     4       ///< 缩放输出的数量（1/1、1/2、1/4、1/8）
+#define JTEST_MMAX      1024    ///< 测试的 解码器内存上限（远小于 DCT 系数缓存）
+
+/**
+ * @struct jtest_input_t
+ * @brief  测试输入的 编码方式。
+ */
+typedef struct jtest_input_t
+{
+    j_cstring_t            jsz_name;   ///< 名称
+    j_bool_t               jbl_prog;   ///< 是否使用 jpeg_simple_progression()
+    const jpeg_scan_info * jscan_arr;  ///< 自定义的扫描脚本（J_NULL 时 不使用）
+    j_int_t                jit_nscan;  ///< 自定义扫描脚本的 扫描数量
+    j_bool_t               jbl_swap;   ///< 设置内存上限时 DCT 系数缓存 是否换出至临时文件
+} jtest_input_t;
+
+/** 顺序模式，每个分量 各自一个扫描（后两个分量 不在第一个扫描中） */
+static const jpeg_scan_info JSCAN_seq[] =
+{
+    { 1, { 0 }, 0, 63, 0, 0 },
+    { 1, { 1 }, 0, 63, 0, 0 },
+    { 1, { 2 }, 0, 63, 0, 0 },
+};
+
+/** 渐进模式，DC 扫描 也按分量 非交错 */
+static const jpeg_scan_info JSCAN_prog[] =
+{
+    { 1, { 0 }, 0,  0, 0, 1 },
+    { 1, { 1 }, 0,  0, 0, 1 },
+    { 1, { 2 }, 0,  0, 0, 1 },
+    { 1, { 0 }, 1, 63, 0, 0 },
+    { 1, { 2 }, 1, 63, 0, 0 },
+    { 1, { 1 }, 1, 63, 0, 0 },
+    { 1, { 0 }, 0,  0, 1, 0 },
+    { 1, { 1 }, 0,  0, 1, 0 },
+    { 1, { 2 }, 0,  0, 1, 0 },
+};
+
+// 渐进式图像 为块平滑 预留了 多个 iMCU 行 的访问窗口（jdcoefct.c），已覆盖整幅测试图像，
+// 所以 设置内存上限 也不会换出至临时文件
+static const jtest_input_t JINPUT_list[] =
+{
+    { "baseline"                   , J_FALSE, J_NULL    , 0, J_TRUE  },
+    { "sequential, non-interleaved", J_FALSE, JSCAN_seq , sizeof(JSCAN_seq ) / sizeof(JSCAN_seq [0]), J_TRUE  },
+    { "progressive"                , J_TRUE , J_NULL    , 0, J_FALSE },
+    { "progressive, DC per channel", J_FALSE, JSCAN_prog, sizeof(JSCAN_prog) / sizeof(JSCAN_prog[0]), J_FALSE },
+};
+
+/**********************************************************/
+/**
+ * @brief 伪随机数（固定种子，各次运行的输入相同）。
+ */
+static j_uint_t jtest_rand(j_uint_t * jut_seed)
+{
+    *jut_seed = *jut_seed * 1103515245u + 12345u;
+    return (*jut_seed >> 16);
+}
+
+/**********************************************************/
+/**
+ * @brief 按 jinput_ptr 的编码方式，将 渐变 + 噪声 的 RGB 图像 编码为 JPEG 。
+ * 
+ * @param [in ] jinput_ptr : 编码方式。
+ * @param [out] jmt_jpeg   : 操作返回的 JPEG 数据（使用 free() 释放）。
+ * @param [out] jul_jlen   : 操作返回的 JPEG 数据字节数。
+ */
+static j_void_t jtest_encode(
+                    const jtest_input_t * jinput_ptr,
+                    j_mptr_t            * jmt_jpeg,
+                    unsigned long       * jul_jlen)
+{
+    struct jpeg_compress_struct jcinfo;
+    struct jpeg_error_mgr       jerr;
+
+    JSAMPLE  jsm_line[JTEST_IMGW * JTEST_NCHS];
+    JSAMPROW jsr_line = jsm_line;
+    j_uint_t jut_seed = 1;
+    j_uint_t jut_xpos = 0;
+
+    *jmt_jpeg = J_NULL;
+    *jul_jlen = 0;
+
+    jcinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_compress(&jcinfo);
+    jpeg_mem_dest(&jcinfo, jmt_jpeg, jul_jlen);
+
+    jcinfo.image_width      = JTEST_IMGW;
+    jcinfo.image_height     = JTEST_IMGH;
+    jcinfo.input_components = JTEST_NCHS;
+    jcinfo.in_color_space   = JCS_RGB;
+    jpeg_set_defaults(&jcinfo);
+    jpeg_set_quality(&jcinfo, 85, TRUE);
+
+    if (jinput_ptr->jbl_prog)
+    {
+        jpeg_simple_progression(&jcinfo);
+    }
+    else if (J_NULL != jinput_ptr->jscan_arr)
+    {
+        jcinfo.scan_info = jinput_ptr->jscan_arr;
+        jcinfo.num_scans = jinput_ptr->jit_nscan;
+    }
+
+    jpeg_start_compress(&jcinfo, TRUE);
+
+    // 色度 须有足够的变化，量化表缺失时（平坦的灰色）才能被比对出来
+    while (jcinfo.next_scanline < jcinfo.image_height)
+    {
+        for (jut_xpos = 0; jut_xpos < JTEST_IMGW; ++jut_xpos)
+        {
+            jsm_line[3 * jut_xpos + 0] = (JSAMPLE)(jut_xpos * 3 + (jtest_rand(&jut_seed) & 15));
+            jsm_line[3 * jut_xpos + 1] = (JSAMPLE)(jcinfo.next_scanline * 5);
+            jsm_line[3 * jut_xpos + 2] = (JSAMPLE)(255 - jut_xpos * 2 - jcinfo.next_scanline);
+        }
+
+        jpeg_write_scanlines(&jcinfo, &jsr_line, 1);
+    }
+
+    jpeg_finish_compress(&jcinfo);
+    jpeg_destroy_compress(&jcinfo);
+}
+
+/**********************************************************/
+/**
+ * @brief 使用 libjpeg 按 1/jut_sden 缩放解码为 RGB（输出步长 为 JTEST_NCHS * JTEST_IMGW）。
+ * 
+ * @return j_bool_t : 输出尺寸 是否为 jut_outw * jut_outh 。
+ */
+static j_bool_t jtest_decode_scaled(
+                    j_mptr_t      jmt_jpeg,
+                    unsigned long jul_jlen,
+                    j_uint_t      jut_sden,
+                    j_uint_t      jut_outw,
+                    j_uint_t      jut_outh,
+                    j_mptr_t      jmt_pxls)
+{
+    struct jpeg_decompress_struct jdinfo;
+    struct jpeg_error_mgr         jerr;
+
+    JSAMPROW jsr_line = J_NULL;
+    j_bool_t jbl_size = J_FALSE;
+
+    jdinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_decompress(&jdinfo);
+    jpeg_mem_src(&jdinfo, jmt_jpeg, jul_jlen);
+    jpeg_read_header(&jdinfo, TRUE);
+
+    jdinfo.out_color_space = JCS_RGB;
+    jdinfo.scale_num       = 1;
+    jdinfo.scale_denom     = jut_sden;
+    jpeg_start_decompress(&jdinfo);
+
+    jbl_size = (jdinfo.output_width == jut_outw) && (jdinfo.output_height == jut_outh);
+
+    while (jbl_size && (jdinfo.output_scanline < jdinfo.output_height))
+    {
+        jsr_line = jmt_pxls + jdinfo.output_scanline * JTEST_NCHS * JTEST_IMGW;
+        jpeg_read_scanlines(&jdinfo, &jsr_line, 1);
+    }
+
+    jpeg_abort_decompress(&jdinfo);
+    jpeg_destroy_decompress(&jdinfo);
+
+    return jbl_size;
+}
+
+/**********************************************************/
+/**
+ * @brief 比对 jmt_jpeg 的 jdec_ladder() 输出 与 常规解码的结果，返回 不一致的缩放输出数量。
+ * @note  jst_mmax 为 解码器的内存上限（0 表示 不设上限），同时作用于 常规解码。
+ */
+static j_int_t jtest_ladder(
+                    const jtest_input_t * jinput_ptr,
+                    j_mptr_t              jmt_jpeg,
+                    unsigned long         jul_jlen,
+                    j_size_t              jst_mmax)
+{
+    const j_int_t JIT_step = JTEST_NCHS * JTEST_IMGW;
+    const j_uint_t JUT_sden[JTEST_NRUNG] = { 1, 2, 4, 8 };
+
+    static j_byte_t jbt_rung[JTEST_NRUNG][JTEST_NCHS * JTEST_IMGW * JTEST_IMGH];
+    static j_byte_t jbt_cref[JTEST_NCHS * JTEST_IMGW * JTEST_IMGH];
+
+    jdec_rung_t jrung_arr[JTEST_NRUNG];
+    jdec_this_t jdec_this = jdec_alloc(J_NULL);
+    j_int_t     jit_nerr  = 0;
+    j_int_t     jit_err   = 0;
+    j_uint_t    jut_iter  = 0;
+    j_uint_t    jut_line  = 0;
+
+    if (J_NULL == jdec_this)
+    {
+        printf("%-28s : jdec_alloc() failed\n", jinput_ptr->jsz_name);
+        return JTEST_NRUNG;
+    }
+
+    memset(jbt_rung, 0, sizeof(jbt_rung));
+    for (jut_iter = 0; jut_iter < JTEST_NRUNG; ++jut_iter)
+    {
+        jrung_arr[jut_iter].jut_sden = JUT_sden[jut_iter];
+        jrung_arr[jut_iter].jmt_pxls = jbt_rung[jut_iter];
+        jrung_arr[jut_iter].jit_step = JIT_step;
+    }
+
+    jdec_config_memory(jdec_this, jst_mmax);
+    jdec_config(jdec_this, JCTL_MODE_FMEMORY, (j_fhandle_t)jmt_jpeg, (j_size_t)jul_jlen);
+    jit_err = jdec_ladder(jdec_this, JCTL_CS_RGB, jrung_arr, JTEST_NRUNG, 0, J_NULL);
+    if (JTEST_NRUNG != jit_err)
+    {
+        printf("%-28s : jdec_ladder() returned %d\n", jinput_ptr->jsz_name, jit_err);
+        jdec_release(jdec_this);
+        return JTEST_NRUNG;
+    }
+
+    for (jut_iter = 0; jut_iter < JTEST_NRUNG; ++jut_iter)
+    {
+        const jdec_rung_t * jrung_ptr = &jrung_arr[jut_iter];
+
+        memset(jbt_cref, 0, sizeof(jbt_cref));
+
+        // 1/1 尺寸 以 jdec_image() 为基准
+        if (1 == jrung_ptr->jut_sden)
+        {
+            jdec_config(jdec_this, JCTL_MODE_FMEMORY, (j_fhandle_t)jmt_jpeg, (j_size_t)jul_jlen);
+            jit_err = (JTEST_IMGH == jdec_image(jdec_this, JCTL_CS_RGB, jbt_cref, JIT_step, J_NULL)) &&
+                      (JTEST_IMGW == jrung_ptr->jut_outw) && (JTEST_IMGH == jrung_ptr->jut_outh);
+        }
+        else
+        {
+            jit_err = jtest_decode_scaled(
+                        jmt_jpeg, jul_jlen, jrung_ptr->jut_sden,
+                        jrung_ptr->jut_outw, jrung_ptr->jut_outh, jbt_cref);
+        }
+
+        for (jut_line = 0; jit_err && (jut_line < jrung_ptr->jut_outh); ++jut_line)
+        {
+            jit_err = (0 == memcmp(jbt_rung[jut_iter] + jut_line * JIT_step,
+                                   jbt_cref + jut_line * JIT_step,
+                                   JTEST_NCHS * jrung_ptr->jut_outw));
+        }
+
+        if (!jit_err)
+        {
+            printf("%-28s : 1/%u (%u x %u) : MISMATCH\n",
+                   jinput_ptr->jsz_name, jrung_ptr->jut_sden,
+                   jrung_ptr->jut_outw, jrung_ptr->jut_outh);
+            jit_nerr += 1;
+        }
+    }
+
+    jdec_release(jdec_this);
+
+    return jit_nerr;
+}
+
+#ifndef _WIN32
+
+/**********************************************************/
+/**
+ * @brief 设置 内存上限 且 临时文件目录 不存在时，jdec_ladder() 无法换出 DCT 系数缓存，
+ *        应返回 JDEC_ERR_EXCEPTION；返回 不一致的数量（0 或 1）。
+ */
+static j_int_t jtest_ladder_nodir(
+                    const jtest_input_t * jinput_ptr,
+                    j_mptr_t              jmt_jpeg,
+                    unsigned long         jul_jlen)
+{
+    static j_byte_t jbt_rung[JTEST_NCHS * JTEST_IMGW * JTEST_IMGH];
+
+    jdec_rung_t jrung_one = { 1, jbt_rung, JTEST_NCHS * JTEST_IMGW, 0, 0, JDEC_ERR_UNKNOWN };
+    jdec_this_t jdec_this = jdec_alloc(J_NULL);
+    j_char_t  * jsz_tdir  = getenv("TMPDIR");
+    j_char_t    jsz_save[1024] = { 0 };
+    j_int_t     jit_err   = 0;
+
+    if (J_NULL != jsz_tdir)
+    {
+        strncpy(jsz_save, jsz_tdir, sizeof(jsz_save) - 1);
+    }
+
+    setenv("TMPDIR", "/nonexistent/jtest_ladder", 1);
+
+    jdec_config_memory(jdec_this, JTEST_MMAX);
+    jdec_config(jdec_this, JCTL_MODE_FMEMORY, (j_fhandle_t)jmt_jpeg, (j_size_t)jul_jlen);
+    jit_err = jdec_ladder(jdec_this, JCTL_CS_RGB, &jrung_one, 1, 1, J_NULL);
+    jdec_release(jdec_this);
+
+    if (J_NULL != jsz_tdir)
+        setenv("TMPDIR", jsz_save, 1);
+    else
+        unsetenv("TMPDIR");
+
+    if (JDEC_ERR_EXCEPTION != jit_err)
+    {
+        printf("%-28s : memory limit ignored (jdec_ladder() returned %d)\n",
+               jinput_ptr->jsz_name, jit_err);
+        return 1;
+    }
+
+    return 0;
+}
+
+#endif // !_WIN32
+
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char * argv[])
+{
+    j_mptr_t      jmt_jpeg = J_NULL;
+    unsigned long jul_jlen = 0;
+    j_uint_t      jut_iter = 0;
+    j_int_t       jit_nerr = 0;
+
+    for (jut_iter = 0; jut_iter < sizeof(JINPUT_list) / sizeof(JINPUT_list[0]); ++jut_iter)
+    {
+        jtest_encode(&JINPUT_list[jut_iter], &jmt_jpeg, &jul_jlen);
+        jit_nerr += jtest_ladder(&JINPUT_list[jut_iter], jmt_jpeg, jul_jlen, 0);
+#ifndef _WIN32
+        jit_nerr += jtest_ladder(&JINPUT_list[jut_iter], jmt_jpeg, jul_jlen, JTEST_MMAX);
+        if (JINPUT_list[jut_iter].jbl_swap)
+            jit_nerr += jtest_ladder_nodir(&JINPUT_list[jut_iter], jmt_jpeg, jul_jlen);
+#endif // !_WIN32
+        free(jmt_jpeg);
+
+        printf("%-28s : 1/1, 1/2, 1/4, 1/8 checked\n", JINPUT_list[jut_iter].jsz_name);
+    }
+
+    return (0 == jit_nerr) ? 0 : 1;
+}
@@ -0,0 +1,1368 @@
+﻿/**
+ * @file test_transform.c
+ * Copyright (c) 2024 Gaaagaa. All rights reserved.
+ *
+ * @author  : Gaaagaa
+ * @date    : 2024-11-14
+ * @version : 1.0.0.0
+ * @brief   : 比对 jtransform.c 各个无损变换的 输出 DCT 系数 与 参考结果：
+ *            参考结果 由测试程序 直接在 libjpeg 读出的 源 DCT 系数上 按定义计算，
+ *            输入为 libjpeg 现场编码的 RGB => YCC（4:2:0）图像。
+ */
+
+#include "jtransform.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "jpeglib.h"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#define JTEST_MAX_COMPS     4       ///< 测试图像的 最大分量数量
+
+#define JTEST_MKR_EXIF_II   0x0001  ///< 写入 EXIF(APP1) 标记（小端字节序，带 Orientation 标签）
+#define JTEST_MKR_EXIF_MM   0x0002  ///< 写入 EXIF(APP1) 标记（大端字节序，带 Orientation 标签）
+#define JTEST_MKR_ICC       0x0004  ///< 写入 ICC(APP2) 标记
+#define JTEST_MKR_ADOBE     0x0008  ///< 写入 Adobe(APP14) 标记
+
+/**
+ * @struct jtest_input_t
+ * @brief  测试输入图像的 编码参数。
+ */
+typedef struct jtest_input_t
+{
+    j_uint_t jut_imgw;      ///< 图像宽度
+    j_uint_t jut_imgh;      ///< 图像高度
+    j_bool_t jbl_prog;      ///< 是否为 渐进模式
+    j_int_t  jit_rrows;     ///< 重启间隔（以 MCU 行为单位，0 表示 无）
+    j_int_t  jit_mkrs;      ///< 写入的 附加标记（ JTEST_MKR_* 的组合）
+    j_int_t  jit_orient;    ///< EXIF 的 Orientation 标签值
+} jtest_input_t;
+
+/**
+ * @struct jtest_comp_t
+ * @brief  单个分量的 DCT 系数 与 量化表。
+ */
+typedef struct jtest_comp_t
+{
+    j_uint_t jut_wblk;              ///< 宽度（以 DCT 块为单位）
+    j_uint_t jut_hblk;              ///< 高度（以 DCT 块为单位）
+    j_int_t  jit_hsmp;              ///< 水平采样因子
+    j_int_t  jit_vsmp;              ///< 垂直采样因子
+    UINT16   jqt_qval[DCTSIZE2];    ///< 量化表（自然顺序）
+    JCOEF  * jcf_data;              ///< 全部 DCT 系数块（按行存放，每块 DCTSIZE2 个系数）
+} jtest_comp_t;
+
+/**
+ * @struct jtest_coefs_t
+ * @brief  libjpeg 读出的 JPEG 图像的 DCT 系数 与 编码参数。
+ */
+typedef struct jtest_coefs_t
+{
+    j_uint_t     jut_imgw;  ///< 图像宽度
+    j_uint_t     jut_imgh;  ///< 图像高度
+    j_int_t      jit_nchs;  ///< 分量数量
+    j_bool_t     jbl_prog;  ///< 是否为 渐进模式
+    j_bool_t     jbl_arith; ///< 是否为 算术编码
+    j_uint_t     jut_rsti;  ///< 首个扫描的 重启间隔（MCU 数量）
+    j_int_t      jit_orient; ///< EXIF 的 Orientation 标签值（-1 表示 无此标签）
+    j_bool_t     jbl_icc;   ///< 是否有 ICC(APP2) 标记
+    j_bool_t     jbl_adobe; ///< 是否有 Adobe(APP14) 标记
+    jtest_comp_t jcomp[JTEST_MAX_COMPS]; ///< 各个分量
+} jtest_coefs_t;
+
+/**********************************************************/
+/**
+ * @brief 伪随机数（固定种子，各次运行的输入相同）。
+ */
+static j_uint_t jtest_rand(j_uint_t * jut_seed)
+{
+    *jut_seed = *jut_seed * 1103515245u + 12345u;
+    return (*jut_seed >> 16);
+}
+
+/**********************************************************/
+/**
+ * @brief 按字节序（jbl_mm 为 J_TRUE 时 为大端）读写 EXIF(TIFF) 的 16 位整数。
+ */
+static j_uint_t jtest_exif_get16(const j_byte_t * jbt_data, j_bool_t jbl_mm)
+{
+    return jbl_mm ? ((j_uint_t)(jbt_data[0] << 8) | jbt_data[1])
+                  : ((j_uint_t)(jbt_data[1] << 8) | jbt_data[0]);
+}
+
+static j_void_t jtest_exif_set16(j_byte_t * jbt_data, j_uint_t jut_value, j_bool_t jbl_mm)
+{
+    jbt_data[jbl_mm ? 0 : 1] = (j_byte_t)(jut_value >> 8);
+    jbt_data[jbl_mm ? 1 : 0] = (j_byte_t)(jut_value);
+}
+
+/**********************************************************/
+/**
+ * @brief 构建 EXIF(APP1) 标记数据：IFD0 位于 TIFF 头之后，含 Make 与 Orientation 两个标签。
+ *
+ * @return j_uint_t : 标记数据的字节数（jbt_data 至少需要 64 字节）。
+ */
+static j_uint_t jtest_exif_build(j_byte_t * jbt_data, j_bool_t jbl_mm, j_int_t jit_orient)
+{
+    j_byte_t * jbt_tiff = jbt_data + 6;
+
+    memset(jbt_data, 0, 64);
+    memcpy(jbt_data, "Exif\0\0", 6);
+    memcpy(jbt_tiff, jbl_mm ? "MM" : "II", 2);
+    jtest_exif_set16(jbt_tiff + 2, 42, jbl_mm);
+    jtest_exif_set16(jbt_tiff + (jbl_mm ? 6 : 4), 8, jbl_mm);   // IFD0 的偏移量（32 位）
+
+    jtest_exif_set16(jbt_tiff +  8, 2, jbl_mm);                 // 条目数量
+
+    jtest_exif_set16(jbt_tiff + 10, 0x010F, jbl_mm);            // Make : ASCII[4]
+    jtest_exif_set16(jbt_tiff + 12, 2, jbl_mm);
+    jtest_exif_set16(jbt_tiff + (jbl_mm ? 16 : 14), 4, jbl_mm);
+    memcpy(jbt_tiff + 18, "jpg", 4);
+
+    jtest_exif_set16(jbt_tiff + 22, 0x0112, jbl_mm);            // Orientation : SHORT[1]
+    jtest_exif_set16(jbt_tiff + 24, 3, jbl_mm);
+    jtest_exif_set16(jbt_tiff + (jbl_mm ? 28 : 26), 1, jbl_mm);
+    jtest_exif_set16(jbt_tiff + 30, (j_uint_t)jit_orient, jbl_mm);
+
+    return 6 + 8 + 2 + 2 * 12 + 4;
+}
+
+/**********************************************************/
+/**
+ * @brief 读取 jtest_exif_build() 所构建的 EXIF 标记数据中的 Orientation 标签值。
+ *
+ * @return j_int_t : 标签值，数据不符时 返回 -1 。
+ */
+static j_int_t jtest_exif_orient(const j_byte_t * jbt_data, j_uint_t jut_size)
+{
+    const j_byte_t * jbt_tiff = jbt_data + 6;
+    j_bool_t         jbl_mm   = J_FALSE;
+
+    if ((jut_size < 6 + 8 + 2 + 2 * 12 + 4) || (0 != memcmp(jbt_data, "Exif\0\0", 6)))
+    {
+        return -1;
+    }
+
+    jbl_mm = (0 == memcmp(jbt_tiff, "MM", 2));
+    if ((2 != jtest_exif_get16(jbt_tiff + 8, jbl_mm)) ||
+        (0x0112 != jtest_exif_get16(jbt_tiff + 22, jbl_mm)))
+    {
+        return -1;
+    }
+
+    return (j_int_t)jtest_exif_get16(jbt_tiff + 30, jbl_mm);
+}
+
+/**********************************************************/
+/**
+ * @brief 按 jinput_ptr 的编码参数，将 渐变 + 噪声 的 RGB 图像 编码为 JPEG（质量 90）。
+ *
+ * @param [in ] jinput_ptr : 编码参数。
+ * @param [out] jmt_jpeg   : 操作返回的 JPEG 数据（使用 free() 释放）。
+ * @param [out] jul_jlen   : 操作返回的 JPEG 数据字节数。
+ */
+static j_void_t jtest_encode(
+                    const jtest_input_t * jinput_ptr,
+                    j_mptr_t            * jmt_jpeg,
+                    unsigned long       * jul_jlen)
+{
+    struct jpeg_compress_struct jcinfo;
+    struct jpeg_error_mgr       jerr;
+
+    JSAMPROW jsr_line = J_NULL;
+    j_byte_t jbt_exif[64];
+    j_uint_t jut_seed = jinput_ptr->jut_imgw * jinput_ptr->jut_imgh;
+    j_uint_t jut_xpos = 0;
+    j_uint_t jut_ypos = 0;
+
+    *jmt_jpeg = J_NULL;
+    *jul_jlen = 0;
+
+    jsr_line = (JSAMPROW)malloc(3 * jinput_ptr->jut_imgw);
+
+    jcinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_compress(&jcinfo);
+    jpeg_mem_dest(&jcinfo, jmt_jpeg, jul_jlen);
+
+    jcinfo.image_width      = jinput_ptr->jut_imgw;
+    jcinfo.image_height     = jinput_ptr->jut_imgh;
+    jcinfo.input_components = 3;
+    jcinfo.in_color_space   = JCS_RGB;
+    jpeg_set_defaults(&jcinfo);
+    jpeg_set_quality(&jcinfo, 90, TRUE);
+
+    jcinfo.restart_in_rows    = jinput_ptr->jit_rrows;
+    jcinfo.write_Adobe_marker = (jinput_ptr->jit_mkrs & JTEST_MKR_ADOBE) ? TRUE : FALSE;
+    if (jinput_ptr->jbl_prog)
+    {
+        jpeg_simple_progression(&jcinfo);
+    }
+
+    jpeg_start_compress(&jcinfo, TRUE);
+
+    if (jinput_ptr->jit_mkrs & (JTEST_MKR_EXIF_II | JTEST_MKR_EXIF_MM))
+    {
+        jpeg_write_marker(
+            &jcinfo,
+            JPEG_APP0 + 1,
+            jbt_exif,
+            jtest_exif_build(jbt_exif,
+                             (jinput_ptr->jit_mkrs & JTEST_MKR_EXIF_MM) ? J_TRUE : J_FALSE,
+                             jinput_ptr->jit_orient));
+    }
+
+    if (jinput_ptr->jit_mkrs & JTEST_MKR_ICC)
+    {
+        // 单个分段的 ICC 配置（内容只用于 检查标记是否保留）
+        memset(jbt_exif, 0, sizeof(jbt_exif));
+        memcpy(jbt_exif, "ICC_PROFILE", 12);
+        jbt_exif[12] = 1;
+        jbt_exif[13] = 1;
+        jpeg_write_marker(&jcinfo, JPEG_APP0 + 2, jbt_exif, sizeof(jbt_exif));
+    }
+
+    for (jut_ypos = 0; jut_ypos < jinput_ptr->jut_imgh; ++jut_ypos)
+    {
+        for (jut_xpos = 0; jut_xpos < jinput_ptr->jut_imgw; ++jut_xpos)
+        {
+            jsr_line[3 * jut_xpos + 0] = (JSAMPLE)(jut_xpos * 2 + (jtest_rand(&jut_seed) & 31));
+            jsr_line[3 * jut_xpos + 1] = (JSAMPLE)(jut_ypos * 3 + (jtest_rand(&jut_seed) & 15));
+            jsr_line[3 * jut_xpos + 2] = (JSAMPLE)((jut_xpos ^ jut_ypos) * 4);
+        }
+
+        jpeg_write_scanlines(&jcinfo, &jsr_line, 1);
+    }
+
+    jpeg_finish_compress(&jcinfo);
+    jpeg_destroy_compress(&jcinfo);
+
+    free(jsr_line);
+}
+
+/**********************************************************/
+/**
+ * @brief 释放 jtest_read() 读出的 DCT 系数。
+ */
+static j_void_t jtest_free(jtest_coefs_t * jcoefs_ptr)
+{
+    j_int_t jit_iter = 0;
+
+    for (jit_iter = 0; jit_iter < JTEST_MAX_COMPS; ++jit_iter)
+    {
+        if (J_NULL != jcoefs_ptr->jcomp[jit_iter].jcf_data)
+            free(jcoefs_ptr->jcomp[jit_iter].jcf_data);
+    }
+
+    memset(jcoefs_ptr, 0, sizeof(jtest_coefs_t));
+    jcoefs_ptr->jit_orient = -1;
+}
+
+/**********************************************************/
+/**
+ * @brief 使用 libjpeg 读出 JPEG 数据的 DCT 系数 与 编码参数。
+ *
+ * @return j_bool_t : 解码过程 是否没有警告（如 RST 标记序号错误；出错时 libjpeg 直接退出）。
+ */
+static j_bool_t jtest_read(
+                    j_mptr_t        jmt_jpeg,
+                    j_size_t        jst_jlen,
+                    jtest_coefs_t * jcoefs_ptr)
+{
+    struct jpeg_decompress_struct jdinfo;
+    struct jpeg_error_mgr         jerr;
+
+    jvirt_barray_ptr    * jarr_ptr  = J_NULL;
+    jpeg_saved_marker_ptr jmkr_ptr  = J_NULL;
+    jpeg_component_info * jcomp_ptr = J_NULL;
+    jtest_comp_t        * jtcmp_ptr = J_NULL;
+    JBLOCKARRAY           jblk_row  = J_NULL;
+    j_int_t               jit_iter  = 0;
+    j_uint_t              jut_yblk  = 0;
+
+    memset(jcoefs_ptr, 0, sizeof(jtest_coefs_t));
+
+    jdinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_decompress(&jdinfo);
+    jpeg_mem_src(&jdinfo, jmt_jpeg, (unsigned long)jst_jlen);
+    jpeg_save_markers(&jdinfo, JPEG_APP0 +  1, 0xFFFF);
+    jpeg_save_markers(&jdinfo, JPEG_APP0 +  2, 0xFFFF);
+    jpeg_save_markers(&jdinfo, JPEG_APP0 + 14, 0xFFFF);
+    jpeg_read_header(&jdinfo, TRUE);
+
+    // 渐进模式下 各个扫描可有不同的 DRI，只记录 首个扫描（交错扫描）的重启间隔
+    jcoefs_ptr->jut_rsti = jdinfo.restart_interval;
+
+    jcoefs_ptr->jit_orient = -1;
+    for (jmkr_ptr = jdinfo.marker_list; J_NULL != jmkr_ptr; jmkr_ptr = jmkr_ptr->next)
+    {
+        if ((JPEG_APP0 + 1) == jmkr_ptr->marker)
+            jcoefs_ptr->jit_orient = jtest_exif_orient(jmkr_ptr->data, jmkr_ptr->data_length);
+        else if (((JPEG_APP0 + 2) == jmkr_ptr->marker) && (jmkr_ptr->data_length >= 12) &&
+                 (0 == memcmp(jmkr_ptr->data, "ICC_PROFILE", 12)))
+            jcoefs_ptr->jbl_icc = J_TRUE;
+        else if (((JPEG_APP0 + 14) == jmkr_ptr->marker) && (jmkr_ptr->data_length >= 5) &&
+                 (0 == memcmp(jmkr_ptr->data, "Adobe", 5)))
+            jcoefs_ptr->jbl_adobe = J_TRUE;
+    }
+
+    jarr_ptr = jpeg_read_coefficients(&jdinfo);
+
+    jcoefs_ptr->jut_imgw  = jdinfo.image_width;
+    jcoefs_ptr->jut_imgh  = jdinfo.image_height;
+    jcoefs_ptr->jit_nchs  = jdinfo.num_components;
+    jcoefs_ptr->jbl_prog  = jdinfo.progressive_mode;
+    jcoefs_ptr->jbl_arith = jdinfo.arith_code;
+
+    for (jit_iter = 0; (jit_iter < jdinfo.num_components) && (jit_iter < JTEST_MAX_COMPS); ++jit_iter)
+    {
+        jcomp_ptr = &jdinfo.comp_info[jit_iter];
+        jtcmp_ptr = &jcoefs_ptr->jcomp[jit_iter];
+
+        jtcmp_ptr->jut_wblk = jcomp_ptr->width_in_blocks;
+        jtcmp_ptr->jut_hblk = jcomp_ptr->height_in_blocks;
+        jtcmp_ptr->jit_hsmp = jcomp_ptr->h_samp_factor;
+        jtcmp_ptr->jit_vsmp = jcomp_ptr->v_samp_factor;
+        memcpy(jtcmp_ptr->jqt_qval, jcomp_ptr->quant_table->quantval, sizeof(jtcmp_ptr->jqt_qval));
+
+        jtcmp_ptr->jcf_data = (JCOEF *)malloc(
+            (j_size_t)jtcmp_ptr->jut_wblk * jtcmp_ptr->jut_hblk * sizeof(JBLOCK));
+
+        for (jut_yblk = 0; jut_yblk < jtcmp_ptr->jut_hblk; ++jut_yblk)
+        {
+            jblk_row = (*jdinfo.mem->access_virt_barray)(
+                            (j_common_ptr)&jdinfo, jarr_ptr[jit_iter], jut_yblk, 1, FALSE);
+            memcpy(jtcmp_ptr->jcf_data + (j_size_t)jut_yblk * jtcmp_ptr->jut_wblk * DCTSIZE2,
+                   jblk_row[0],
+                   jtcmp_ptr->jut_wblk * sizeof(JBLOCK));
+        }
+    }
+
+    jpeg_finish_decompress(&jdinfo);
+    jpeg_destroy_decompress(&jdinfo);
+
+    return (0 == jerr.num_warnings);
+}
+
+/**********************************************************/
+/**
+ * @brief 取 分量 jtcmp_ptr 中 第 jut_yblk 行、第 jut_xblk 列 的 DCT 系数块。
+ */
+static inline JCOEF * jtest_block(
+                        const jtest_comp_t * jtcmp_ptr,
+                        j_uint_t             jut_xblk,
+                        j_uint_t             jut_yblk)
+{
+    return jtcmp_ptr->jcf_data + ((j_size_t)jut_yblk * jtcmp_ptr->jut_wblk + jut_xblk) * DCTSIZE2;
+}
+
+/**********************************************************/
+/**
+ * @brief 对 内存模式 的输入 执行一次变换，并读出输出的 DCT 系数。
+ *
+ * @param [in ] jmt_jpeg   : 输入的 JPEG 数据。
+ * @param [in ] jul_jlen   : 输入的 JPEG 数据字节数。
+ * @param [in ] jfunc_ptr  : 执行变换的回调函数（返回 jtransform.c 的错误码）。
+ * @param [in ] jvt_ctxt   : 回调函数的 上下文参数。
+ * @param [out] jcoefs_ptr : 操作返回的 输出图像的 DCT 系数。
+ * @param [out] jmt_oput   : 入参不为 J_NULL 时，返回 输出的 JPEG 数据副本（使用 free() 释放）。
+ * @param [out] jst_olen   : 入参不为 J_NULL 时，返回 输出的 JPEG 数据字节数。
+ *
+ * @return j_int_t : 变换操作的 错误码。
+ */
+static j_int_t jtest_transform(
+                    j_mptr_t        jmt_jpeg,
+                    unsigned long   jul_jlen,
+                    j_int_t      (* jfunc_ptr)(jtrans_this_t, j_void_t *),
+                    j_void_t      * jvt_ctxt,
+                    jtest_coefs_t * jcoefs_ptr,
+                    j_mptr_t      * jmt_oput,
+                    j_size_t      * jst_olen)
+{
+    jtrans_this_t jtrans_this = jtrans_alloc(J_NULL);
+    j_int_t       jit_err     = JTRANS_ERR_UNKNOWN;
+
+    memset(jcoefs_ptr, 0, sizeof(jtest_coefs_t));
+
+    if (J_NULL == jtrans_this)
+    {
+        return JTRANS_ERR_MALLOC;
+    }
+
+    jtrans_config_input(jtrans_this, JCTL_MODE_FMEMORY, (j_fhandle_t)jmt_jpeg, (j_size_t)jul_jlen);
+    jtrans_config_output(jtrans_this, JCTL_MODE_FMEMORY, J_NULL, 0);
+
+    jit_err = jfunc_ptr(jtrans_this, jvt_ctxt);
+    if ((JTRANS_ERR_OK == jit_err) &&
+        !jtest_read(jtrans_fmdata(jtrans_this), jtrans_fmsize(jtrans_this), jcoefs_ptr))
+    {
+        jit_err = JTRANS_ERR_EXCEPTION;
+    }
+
+    if (JTRANS_ERR_OK == jit_err)
+    {
+
+        if ((J_NULL != jmt_oput) && (J_NULL != jst_olen))
+        {
+            *jst_olen = jtrans_fmsize(jtrans_this);
+            *jmt_oput = (j_mptr_t)malloc(*jst_olen);
+            memcpy(*jmt_oput, jtrans_fmdata(jtrans_this), *jst_olen);
+        }
+    }
+
+    jtrans_release(jtrans_this);
+
+    return jit_err;
+}
+
+/**********************************************************/
+/**
+ * @brief 比对 jdst_ptr 的全部 DCT 系数 与 jsrc_ptr 中 以 (jut_xblk, jut_yblk) 为左上角 的区域。
+ */
+static j_bool_t jtest_same_region(
+                    const jtest_comp_t * jdst_ptr,
+                    const jtest_comp_t * jsrc_ptr,
+                    j_uint_t             jut_xblk,
+                    j_uint_t             jut_yblk)
+{
+    j_uint_t jut_yiter = 0;
+
+    if ((jut_xblk + jdst_ptr->jut_wblk > jsrc_ptr->jut_wblk) ||
+        (jut_yblk + jdst_ptr->jut_hblk > jsrc_ptr->jut_hblk) ||
+        (0 != memcmp(jdst_ptr->jqt_qval, jsrc_ptr->jqt_qval, sizeof(jdst_ptr->jqt_qval))))
+    {
+        return J_FALSE;
+    }
+
+    for (jut_yiter = 0; jut_yiter < jdst_ptr->jut_hblk; ++jut_yiter)
+    {
+        if (0 != memcmp(jtest_block(jdst_ptr, 0, jut_yiter),
+                        jtest_block(jsrc_ptr, jut_xblk, jut_yblk + jut_yiter),
+                        jdst_ptr->jut_wblk * sizeof(JBLOCK)))
+        {
+            return J_FALSE;
+        }
+    }
+
+    return J_TRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// 各项测试（返回 不一致的数量）
+
+/**********************************************************/
+/**
+ * @brief jtest_transform() 的回调：jtrans_crop() 。
+ */
+static j_int_t jtest_do_crop(jtrans_this_t jtrans_this, j_void_t * jvt_ctxt)
+{
+    return jtrans_crop(jtrans_this, (j_rect_t *)jvt_ctxt);
+}
+
+/**********************************************************/
+/**
+ * @brief jtrans_crop()：输出的 DCT 系数 与 源图像 对应区域（iMCU 对齐后）的系数 完全相同。
+ */
+static j_int_t jtest_crop(j_void_t)
+{
+    const jtest_input_t JINPUT_list[] =
+    {
+        { 100, 70, J_FALSE, 0, 0, 0 },
+        { 100, 70, J_TRUE , 0, 0, 0 },
+    };
+
+    const j_rect_t JRECT_list[] =
+    {
+        {  0,  0, 100, 70 },
+        { 17,  9,  40, 30 },
+        { 33, 50,  67, 20 },
+        { 96, 64,   4,  6 },
+    };
+
+    jtest_coefs_t jsrc_coef;
+    jtest_coefs_t jdst_coef;
+    j_rect_t      jrect;
+    j_mptr_t      jmt_jpeg = J_NULL;
+    unsigned long jul_jlen = 0;
+    j_uint_t      jut_iinp = 0;
+    j_uint_t      jut_irct = 0;
+    j_int_t       jit_iter = 0;
+    j_int_t       jit_nerr = 0;
+    j_bool_t      jbl_same = J_FALSE;
+
+    for (jut_iinp = 0; jut_iinp < sizeof(JINPUT_list) / sizeof(JINPUT_list[0]); ++jut_iinp)
+    {
+        jtest_encode(&JINPUT_list[jut_iinp], &jmt_jpeg, &jul_jlen);
+        jtest_read(jmt_jpeg, jul_jlen, &jsrc_coef);
+
+        for (jut_irct = 0; jut_irct < sizeof(JRECT_list) / sizeof(JRECT_list[0]); ++jut_irct)
+        {
+            jrect = JRECT_list[jut_irct];
+
+            // 4:2:0 的 iMCU 为 16 x 16 像素
+            jbl_same = (JTRANS_ERR_OK == jtest_transform(
+                                            jmt_jpeg, jul_jlen, jtest_do_crop, &jrect,
+                                            &jdst_coef, J_NULL, J_NULL)) &&
+                       (0 == jrect.jit_x % 16) && (0 == jrect.jit_y % 16) &&
+                       (jdst_coef.jut_imgw == (j_uint_t)jrect.jit_w) &&
+                       (jdst_coef.jut_imgh == (j_uint_t)jrect.jit_h) &&
+                       (jdst_coef.jit_nchs == jsrc_coef.jit_nchs) &&
+                       (jdst_coef.jbl_prog == jsrc_coef.jbl_prog);
+
+            for (jit_iter = 0; jbl_same && (jit_iter < jsrc_coef.jit_nchs); ++jit_iter)
+            {
+                jbl_same = jtest_same_region(
+                                &jdst_coef.jcomp[jit_iter],
+                                &jsrc_coef.jcomp[jit_iter],
+                                jrect.jit_x / 16 * jsrc_coef.jcomp[jit_iter].jit_hsmp,
+                                jrect.jit_y / 16 * jsrc_coef.jcomp[jit_iter].jit_vsmp);
+            }
+
+            if (!jbl_same)
+            {
+                printf("crop      : %s, rect (%d, %d, %d, %d) : MISMATCH\n",
+                       JINPUT_list[jut_iinp].jbl_prog ? "progressive" : "sequential",
+                       JRECT_list[jut_irct].jit_x, JRECT_list[jut_irct].jit_y,
+                       JRECT_list[jut_irct].jit_w, JRECT_list[jut_irct].jit_h);
+                jit_nerr += 1;
+            }
+
+            jtest_free(&jdst_coef);
+        }
+
+        jtest_free(&jsrc_coef);
+        free(jmt_jpeg);
+    }
+
+    return jit_nerr;
+}
+
+/**********************************************************/
+/**
+ * @struct jtest_rotate_t
+ * @brief  旋转/翻转 操作 在 源图像上的 坐标映射（与 jtransform.c 的分解方式 无关）：
+ *         输出的 (x, y) 取自 源图像的 (tran ? y : x, tran ? x : y)，再按 revx/revy 反向。
+ */
+typedef struct jtest_rotate_t
+{
+    jtrans_rotate_t jrotate;    ///< 操作类型
+    j_cstring_t     jsz_name;   ///< 名称
+    j_bool_t        jbl_tran;   ///< 源坐标 x/y 是否 对调
+    j_bool_t        jbl_revx;   ///< 源坐标 x 是否反向
+    j_bool_t        jbl_revy;   ///< 源坐标 y 是否反向
+} jtest_rotate_t;
+
+/**********************************************************/
+/**
+ * @brief jtrans_crop() 的 按重启段切分 快速路径（顺序模式 带重启间隔 的内存输入，整行裁剪）：
+ *        输出的 DCT 系数 与 源图像 对应 MCU 行 完全相同，重启间隔不变，RST 序号连续。
+ */
+static j_int_t jtest_slice(j_void_t)
+{
+    // 13 个 MCU 行，每行 7 个 MCU；重启间隔为 1 行时，第 9 行起 切分 需要重新编号 RST
+    const jtest_input_t JINPUT_list[] =
+    {
+        { 100, 200, J_FALSE, 1, 0, 0 },
+        { 100, 200, J_FALSE, 2, 0, 0 },
+    };
+
+    const j_rect_t JRECT_list[] =
+    {
+        { 0,   0, 100, 200 },
+        { 0,  16, 100,  32 },
+        { 0,  20, 100,  10 },
+        { 0,  64, 100,  64 },
+        { 0, 144, 100,  40 },
+        { 0, 160, 100,  40 },
+    };
+
+    jtest_coefs_t jsrc_coef;
+    jtest_coefs_t jdst_coef;
+    j_rect_t      jrect;
+    j_mptr_t      jmt_jpeg = J_NULL;
+    unsigned long jul_jlen = 0;
+    j_uint_t      jut_iinp = 0;
+    j_uint_t      jut_irct = 0;
+    j_int_t       jit_iter = 0;
+    j_int_t       jit_nerr = 0;
+    j_bool_t      jbl_same = J_FALSE;
+
+    for (jut_iinp = 0; jut_iinp < sizeof(JINPUT_list) / sizeof(JINPUT_list[0]); ++jut_iinp)
+    {
+        jtest_encode(&JINPUT_list[jut_iinp], &jmt_jpeg, &jul_jlen);
+        jtest_read(jmt_jpeg, jul_jlen, &jsrc_coef);
+
+        for (jut_irct = 0; jut_irct < sizeof(JRECT_list) / sizeof(JRECT_list[0]); ++jut_irct)
+        {
+            jrect = JRECT_list[jut_irct];
+
+            jbl_same = (JTRANS_ERR_OK == jtest_transform(
+                                            jmt_jpeg, jul_jlen, jtest_do_crop, &jrect,
+                                            &jdst_coef, J_NULL, J_NULL)) &&
+                       (0 == jrect.jit_y % 16) &&
+                       (jdst_coef.jut_imgw == jsrc_coef.jut_imgw) &&
+                       (jdst_coef.jut_imgh == (j_uint_t)jrect.jit_h) &&
+                       (jdst_coef.jit_nchs == jsrc_coef.jit_nchs) &&
+                       (jdst_coef.jut_rsti == jsrc_coef.jut_rsti);
+
+            for (jit_iter = 0; jbl_same && (jit_iter < jsrc_coef.jit_nchs); ++jit_iter)
+            {
+                jbl_same = (jdst_coef.jcomp[jit_iter].jut_wblk == jsrc_coef.jcomp[jit_iter].jut_wblk) &&
+                           jtest_same_region(
+                                &jdst_coef.jcomp[jit_iter],
+                                &jsrc_coef.jcomp[jit_iter],
+                                0,
+                                jrect.jit_y / 16 * jsrc_coef.jcomp[jit_iter].jit_vsmp);
+            }
+
+            if (!jbl_same)
+            {
+                printf("slice     : restart %d rows, rows (%d, %d) : MISMATCH\n",
+                       JINPUT_list[jut_iinp].jit_rrows,
+                       JRECT_list[jut_irct].jit_y, JRECT_list[jut_irct].jit_h);
+                jit_nerr += 1;
+            }
+
+            jtest_free(&jdst_coef);
+        }
+
+        jtest_free(&jsrc_coef);
+        free(jmt_jpeg);
+    }
+
+    return jit_nerr;
+}
+
+/**********************************************************/
+/**
+ * @brief jtest_transform() 的回调：jtrans_rotate() 。
+ */
+static j_int_t jtest_do_rotate(jtrans_this_t jtrans_this, j_void_t * jvt_ctxt)
+{
+    return jtrans_rotate(jtrans_this, ((const jtest_rotate_t *)jvt_ctxt)->jrotate, J_TRUE);
+}
+
+/**********************************************************/
+/**
+ * @brief 比对 旋转/翻转 后 单个分量的 量化表 与 DCT 系数。
+ */
+static j_bool_t jtest_same_rotate(
+                    const jtest_comp_t   * jdst_ptr,
+                    const jtest_comp_t   * jsrc_ptr,
+                    const jtest_rotate_t * jrot_ptr)
+{
+    const JCOEF * jcf_dst  = J_NULL;
+    const JCOEF * jcf_src  = J_NULL;
+    j_uint_t      jut_xblk = 0;
+    j_uint_t      jut_yblk = 0;
+    j_uint_t      jut_xsrc = 0;
+    j_uint_t      jut_ysrc = 0;
+    j_int_t       jit_u    = 0;
+    j_int_t       jit_v    = 0;
+    j_int_t       jit_su   = 0;
+    j_int_t       jit_sv   = 0;
+    j_int_t       jit_sign = 0;
+
+    if ((jdst_ptr->jut_wblk != (jrot_ptr->jbl_tran ? jsrc_ptr->jut_hblk : jsrc_ptr->jut_wblk)) ||
+        (jdst_ptr->jut_hblk != (jrot_ptr->jbl_tran ? jsrc_ptr->jut_wblk : jsrc_ptr->jut_hblk)) ||
+        (jdst_ptr->jit_hsmp != (jrot_ptr->jbl_tran ? jsrc_ptr->jit_vsmp : jsrc_ptr->jit_hsmp)) ||
+        (jdst_ptr->jit_vsmp != (jrot_ptr->jbl_tran ? jsrc_ptr->jit_hsmp : jsrc_ptr->jit_vsmp)))
+    {
+        return J_FALSE;
+    }
+
+    for (jit_v = 0; jit_v < DCTSIZE; ++jit_v)
+    {
+        for (jit_u = 0; jit_u < DCTSIZE; ++jit_u)
+        {
+            jit_su = jrot_ptr->jbl_tran ? jit_v : jit_u;
+            jit_sv = jrot_ptr->jbl_tran ? jit_u : jit_v;
+            if (jdst_ptr->jqt_qval[jit_v * DCTSIZE + jit_u] != jsrc_ptr->jqt_qval[jit_sv * DCTSIZE + jit_su])
+                return J_FALSE;
+        }
+    }
+
+    for (jut_yblk = 0; jut_yblk < jdst_ptr->jut_hblk; ++jut_yblk)
+    {
+        for (jut_xblk = 0; jut_xblk < jdst_ptr->jut_wblk; ++jut_xblk)
+        {
+            jut_xsrc = jrot_ptr->jbl_tran ? jut_yblk : jut_xblk;
+            jut_ysrc = jrot_ptr->jbl_tran ? jut_xblk : jut_yblk;
+            if (jrot_ptr->jbl_revx) jut_xsrc = jsrc_ptr->jut_wblk - 1 - jut_xsrc;
+            if (jrot_ptr->jbl_revy) jut_ysrc = jsrc_ptr->jut_hblk - 1 - jut_ysrc;
+
+            jcf_dst = jtest_block(jdst_ptr, jut_xblk, jut_yblk);
+            jcf_src = jtest_block(jsrc_ptr, jut_xsrc, jut_ysrc);
+
+            // 源坐标反向时，对应方向上的 奇数频率系数 取反
+            for (jit_v = 0; jit_v < DCTSIZE; ++jit_v)
+            {
+                for (jit_u = 0; jit_u < DCTSIZE; ++jit_u)
+                {
+                    jit_su   = jrot_ptr->jbl_tran ? jit_v : jit_u;
+                    jit_sv   = jrot_ptr->jbl_tran ? jit_u : jit_v;
+                    jit_sign = (((jrot_ptr->jbl_revx ? jit_su : 0) + (jrot_ptr->jbl_revy ? jit_sv : 0)) & 1) ? -1 : 1;
+
+                    if (jcf_dst[jit_v * DCTSIZE + jit_u] != jit_sign * jcf_src[jit_sv * DCTSIZE + jit_su])
+                        return J_FALSE;
+                }
+            }
+        }
+    }
+
+    return J_TRUE;
+}
+
+/**********************************************************/
+/**
+ * @brief jtrans_rotate()：全部 7 种操作（以及 NONE）的 输出尺寸、采样因子、量化表、
+ *        DCT 系数块的位置 与 系数符号，以及 EXIF 的 Orientation 标签（非 NONE 时 改写为 1）。
+ */
+static j_int_t jtest_rotate(j_void_t)
+{
+    // 图像尺寸为 iMCU 的整数倍，不涉及 边缘不完整 iMCU 的裁剪
+    const jtest_input_t JINPUT_list[] =
+    {
+        { 64, 48, J_FALSE, 0, JTEST_MKR_EXIF_MM, 6 },
+        { 64, 48, J_TRUE , 0, JTEST_MKR_EXIF_II, 3 },
+    };
+
+    const jtest_rotate_t JROTATE_list[] =
+    {
+        { JTRANS_ROTATE_NONE      , "none"      , J_FALSE, J_FALSE, J_FALSE },
+        { JTRANS_ROTATE_FLIP_H    , "flip_h"    , J_FALSE, J_TRUE , J_FALSE },
+        { JTRANS_ROTATE_FLIP_V    , "flip_v"    , J_FALSE, J_FALSE, J_TRUE  },
+        { JTRANS_ROTATE_TRANSPOSE , "transpose" , J_TRUE , J_FALSE, J_FALSE },
+        { JTRANS_ROTATE_TRANSVERSE, "transverse", J_TRUE , J_TRUE , J_TRUE  },
+        { JTRANS_ROTATE_ROT_90    , "rot_90"    , J_TRUE , J_FALSE, J_TRUE  },
+        { JTRANS_ROTATE_ROT_180   , "rot_180"   , J_FALSE, J_TRUE , J_TRUE  },
+        { JTRANS_ROTATE_ROT_270   , "rot_270"   , J_TRUE , J_TRUE , J_FALSE },
+    };
+
+    jtest_coefs_t          jsrc_coef;
+    jtest_coefs_t          jdst_coef;
+    const jtest_rotate_t * jrot_ptr = J_NULL;
+    j_mptr_t               jmt_jpeg = J_NULL;
+    unsigned long          jul_jlen = 0;
+    j_uint_t               jut_iinp = 0;
+    j_uint_t               jut_irot = 0;
+    j_int_t                jit_iter = 0;
+    j_int_t                jit_nerr = 0;
+    j_bool_t               jbl_same = J_FALSE;
+
+    for (jut_iinp = 0; jut_iinp < sizeof(JINPUT_list) / sizeof(JINPUT_list[0]); ++jut_iinp)
+    {
+        jtest_encode(&JINPUT_list[jut_iinp], &jmt_jpeg, &jul_jlen);
+        jtest_read(jmt_jpeg, jul_jlen, &jsrc_coef);
+
+        for (jut_irot = 0; jut_irot < sizeof(JROTATE_list) / sizeof(JROTATE_list[0]); ++jut_irot)
+        {
+            jrot_ptr = &JROTATE_list[jut_irot];
+
+            jbl_same = (JTRANS_ERR_OK == jtest_transform(
+                                            jmt_jpeg, jul_jlen, jtest_do_rotate,
+                                            (j_void_t *)jrot_ptr, &jdst_coef, J_NULL, J_NULL)) &&
+                       (jdst_coef.jut_imgw == (jrot_ptr->jbl_tran ? jsrc_coef.jut_imgh : jsrc_coef.jut_imgw)) &&
+                       (jdst_coef.jut_imgh == (jrot_ptr->jbl_tran ? jsrc_coef.jut_imgw : jsrc_coef.jut_imgh)) &&
+                       (jdst_coef.jit_nchs == jsrc_coef.jit_nchs) &&
+                       (jdst_coef.jbl_prog == jsrc_coef.jbl_prog) &&
+                       (jdst_coef.jit_orient ==
+                            ((JTRANS_ROTATE_NONE == jrot_ptr->jrotate) ? JINPUT_list[jut_iinp].jit_orient : 1));
+
+            for (jit_iter = 0; jbl_same && (jit_iter < jsrc_coef.jit_nchs); ++jit_iter)
+            {
+                jbl_same = jtest_same_rotate(&jdst_coef.jcomp[jit_iter], &jsrc_coef.jcomp[jit_iter], jrot_ptr);
+            }
+
+            if (!jbl_same)
+            {
+                printf("rotate    : %s, %s : MISMATCH\n",
+                       JINPUT_list[jut_iinp].jbl_prog ? "progressive" : "sequential",
+                       jrot_ptr->jsz_name);
+                jit_nerr += 1;
+            }
+
+            jtest_free(&jdst_coef);
+        }
+
+        jtest_free(&jsrc_coef);
+        free(jmt_jpeg);
+    }
+
+    return jit_nerr;
+}
+
+/**********************************************************/
+/**
+ * @struct jtest_erase_t
+ * @brief  jtrans_erase() 的参数（ jtest_do_erase() 的回调上下文）。
+ */
+typedef struct jtest_erase_t
+{
+    j_rect_t      jrect;     ///< 擦除区域（返回 扩展到 iMCU 边界后的区域）
+    j_uint_t      jut_color; ///< 擦除颜色（0xRRGGBB）
+} jtest_erase_t;
+
+/**********************************************************/
+/**
+ * @brief jtest_transform() 的回调：jtrans_erase() 。
+ */
+static j_int_t jtest_do_erase(jtrans_this_t jtrans_this, j_void_t * jvt_ctxt)
+{
+    jtest_erase_t * jera_ptr = (jtest_erase_t *)jvt_ctxt;
+    return jtrans_erase(jtrans_this, &jera_ptr->jrect, jera_ptr->jut_color);
+}
+
+/**********************************************************/
+/**
+ * @brief 使用 libjpeg 将 JPEG 数据 解码为 RGB 像素（关闭平滑上采样，色度块 不会渗入相邻区域）。
+ *
+ * @return JSAMPLE * : RGB 像素（使用 free() 释放）。
+ */
+static JSAMPLE * jtest_decode_rgb(j_mptr_t jmt_jpeg, j_size_t jst_jlen)
+{
+    struct jpeg_decompress_struct jdinfo;
+    struct jpeg_error_mgr         jerr;
+
+    JSAMPLE * jsp_rgb  = J_NULL;
+    JSAMPROW  jsr_line = J_NULL;
+
+    jdinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_decompress(&jdinfo);
+    jpeg_mem_src(&jdinfo, jmt_jpeg, (unsigned long)jst_jlen);
+    jpeg_read_header(&jdinfo, TRUE);
+
+    jdinfo.out_color_space     = JCS_RGB;
+    jdinfo.do_fancy_upsampling = FALSE;
+    jpeg_start_decompress(&jdinfo);
+
+    jsp_rgb = (JSAMPLE *)malloc((j_size_t)3 * jdinfo.output_width * jdinfo.output_height);
+    while (jdinfo.output_scanline < jdinfo.output_height)
+    {
+        jsr_line = jsp_rgb + (j_size_t)3 * jdinfo.output_width * jdinfo.output_scanline;
+        jpeg_read_scanlines(&jdinfo, &jsr_line, 1);
+    }
+
+    jpeg_finish_decompress(&jdinfo);
+    jpeg_destroy_decompress(&jdinfo);
+
+    return jsp_rgb;
+}
+
+/**********************************************************/
+/**
+ * @brief jtrans_erase()：区域（向外扩展到 iMCU 边界）内的块 AC 系数为 0，
+ *        DC 系数 等于 擦除颜色 按 JFIF 公式 转换为 YCC 后的量化值，
+ *        解码后的像素 接近 擦除颜色；区域外的块 与 源图像 完全相同。
+ */
+static j_int_t jtest_erase(j_void_t)
+{
+    const jtest_input_t JINPUT_list[] =
+    {
+        { 100, 70, J_FALSE, 0, 0, 0 },
+        { 100, 70, J_TRUE , 0, 0, 0 },
+    };
+
+    const jtest_erase_t JERASE_list[] =
+    {
+        { { 17,  9,  40, 30 }, 0xFF0000 },
+        { { 90, 60,  50, 50 }, 0x204080 },
+        { {  0,  0, 100, 70 }, 0xFFFFFF },
+    };
+
+    jtest_coefs_t        jsrc_coef;
+    jtest_coefs_t        jdst_coef;
+    jtest_erase_t        jerase;
+    const jtest_comp_t * jdst_ptr = J_NULL;
+    const jtest_comp_t * jsrc_ptr = J_NULL;
+    const JCOEF        * jcf_dst  = J_NULL;
+    JSAMPLE            * jsp_rgb  = J_NULL;
+    JSAMPLE            * jsp_pixl = J_NULL;
+    j_mptr_t             jmt_jpeg = J_NULL;
+    j_mptr_t             jmt_oput = J_NULL;
+    unsigned long        jul_jlen = 0;
+    j_size_t             jst_olen = 0;
+    j_int_t              jit_rgb[3];
+    double               jdt_smpl[3];
+    j_uint_t             jut_iinp = 0;
+    j_uint_t             jut_iera = 0;
+    j_uint_t             jut_xblk = 0;
+    j_uint_t             jut_yblk = 0;
+    j_uint_t             jut_xpos = 0;
+    j_uint_t             jut_ypos = 0;
+    j_uint_t             jut_xbeg = 0;
+    j_uint_t             jut_ybeg = 0;
+    j_uint_t             jut_xend = 0;
+    j_uint_t             jut_yend = 0;
+    j_int_t              jit_iter = 0;
+    j_int_t              jit_nerr = 0;
+    j_bool_t             jbl_same = J_FALSE;
+
+    for (jut_iinp = 0; jut_iinp < sizeof(JINPUT_list) / sizeof(JINPUT_list[0]); ++jut_iinp)
+    {
+        jtest_encode(&JINPUT_list[jut_iinp], &jmt_jpeg, &jul_jlen);
+        jtest_read(jmt_jpeg, jul_jlen, &jsrc_coef);
+
+        for (jut_iera = 0; jut_iera < sizeof(JERASE_list) / sizeof(JERASE_list[0]); ++jut_iera)
+        {
+            jerase = JERASE_list[jut_iera];
+
+            jit_rgb[0]  = (j_int_t)((jerase.jut_color >> 16) & 0xFF);
+            jit_rgb[1]  = (j_int_t)((jerase.jut_color >>  8) & 0xFF);
+            jit_rgb[2]  = (j_int_t)((jerase.jut_color      ) & 0xFF);
+            jdt_smpl[0] =  0.299    * jit_rgb[0] + 0.587    * jit_rgb[1] + 0.114    * jit_rgb[2];
+            jdt_smpl[1] = -0.168736 * jit_rgb[0] - 0.331264 * jit_rgb[1] + 0.5      * jit_rgb[2] + 128.0;
+            jdt_smpl[2] =  0.5      * jit_rgb[0] - 0.418688 * jit_rgb[1] - 0.081312 * jit_rgb[2] + 128.0;
+
+            // 4:2:0 的 iMCU 为 16 x 16 像素：左上角 向下对齐，右下角（先裁剪到图像内）向上对齐
+            jut_xbeg = (j_uint_t)jerase.jrect.jit_x / 16;
+            jut_ybeg = (j_uint_t)jerase.jrect.jit_y / 16;
+            jut_xend = (j_uint_t)(jerase.jrect.jit_x + jerase.jrect.jit_w);
+            jut_yend = (j_uint_t)(jerase.jrect.jit_y + jerase.jrect.jit_h);
+            if (jut_xend > jsrc_coef.jut_imgw) jut_xend = jsrc_coef.jut_imgw;
+            if (jut_yend > jsrc_coef.jut_imgh) jut_yend = jsrc_coef.jut_imgh;
+            jut_xend = (jut_xend + 15) / 16;
+            jut_yend = (jut_yend + 15) / 16;
+
+            jbl_same = (JTRANS_ERR_OK == jtest_transform(
+                                            jmt_jpeg, jul_jlen, jtest_do_erase, &jerase,
+                                            &jdst_coef, &jmt_oput, &jst_olen)) &&
+                       (jerase.jrect.jit_x == (j_int_t)(jut_xbeg * 16)) &&
+                       (jerase.jrect.jit_y == (j_int_t)(jut_ybeg * 16)) &&
+                       (jdst_coef.jut_imgw == jsrc_coef.jut_imgw) &&
+                       (jdst_coef.jut_imgh == jsrc_coef.jut_imgh) &&
+                       (jdst_coef.jit_nchs == jsrc_coef.jit_nchs) &&
+                       (jdst_coef.jbl_prog == jsrc_coef.jbl_prog);
+
+            for (jit_iter = 0; jbl_same && (jit_iter < jsrc_coef.jit_nchs); ++jit_iter)
+            {
+                jdst_ptr = &jdst_coef.jcomp[jit_iter];
+                jsrc_ptr = &jsrc_coef.jcomp[jit_iter];
+
+                jbl_same = (jdst_ptr->jut_wblk == jsrc_ptr->jut_wblk) &&
+                           (jdst_ptr->jut_hblk == jsrc_ptr->jut_hblk) &&
+                           (0 == memcmp(jdst_ptr->jqt_qval, jsrc_ptr->jqt_qval, sizeof(jdst_ptr->jqt_qval)));
+
+                for (jut_yblk = 0; jbl_same && (jut_yblk < jdst_ptr->jut_hblk); ++jut_yblk)
+                {
+                    for (jut_xblk = 0; jbl_same && (jut_xblk < jdst_ptr->jut_wblk); ++jut_xblk)
+                    {
+                        jcf_dst = jtest_block(jdst_ptr, jut_xblk, jut_yblk);
+
+                        if ((jut_xblk <  jut_xbeg * jsrc_ptr->jit_hsmp) ||
+                            (jut_xblk >= jut_xend * jsrc_ptr->jit_hsmp) ||
+                            (jut_yblk <  jut_ybeg * jsrc_ptr->jit_vsmp) ||
+                            (jut_yblk >= jut_yend * jsrc_ptr->jit_vsmp))
+                        {
+                            jbl_same = (0 == memcmp(jcf_dst, jtest_block(jsrc_ptr, jut_xblk, jut_yblk), sizeof(JBLOCK)));
+                            continue;
+                        }
+
+                        // 常量样本块：DC = 8 * (样本值 - 128) / 量化步长，AC = 0
+                        jbl_same = (jcf_dst[0] ==
+                            (JCOEF)floor(8.0 * (jdt_smpl[jit_iter] - 128.0) / jsrc_ptr->jqt_qval[0] + 0.5));
+                        for (jut_xpos = 1; jbl_same && (jut_xpos < DCTSIZE2); ++jut_xpos)
+                        {
+                            jbl_same = (0 == jcf_dst[jut_xpos]);
+                        }
+                    }
+                }
+            }
+
+            // 区域内 解码后的像素 接近 擦除颜色（允许 DC 量化 与 色彩转换的误差）
+            if (jbl_same)
+            {
+                jsp_rgb = jtest_decode_rgb(jmt_oput, jst_olen);
+
+                jut_xend = (jut_xend * 16 < jsrc_coef.jut_imgw) ? jut_xend * 16 : jsrc_coef.jut_imgw;
+                jut_yend = (jut_yend * 16 < jsrc_coef.jut_imgh) ? jut_yend * 16 : jsrc_coef.jut_imgh;
+                for (jut_ypos = jut_ybeg * 16; jbl_same && (jut_ypos < jut_yend); ++jut_ypos)
+                {
+                    for (jut_xpos = jut_xbeg * 16; jbl_same && (jut_xpos < jut_xend); ++jut_xpos)
+                    {
+                        jsp_pixl = jsp_rgb + 3 * ((j_size_t)jut_ypos * jsrc_coef.jut_imgw + jut_xpos);
+                        for (jit_iter = 0; jit_iter < 3; ++jit_iter)
+                        {
+                            if (abs((j_int_t)jsp_pixl[jit_iter] - jit_rgb[jit_iter]) > 4)
+                                jbl_same = J_FALSE;
+                        }
+                    }
+                }
+
+                free(jsp_rgb);
+            }
+
+            if (!jbl_same)
+            {
+                printf("erase     : %s, rect (%d, %d, %d, %d) : MISMATCH\n",
+                       JINPUT_list[jut_iinp].jbl_prog ? "progressive" : "sequential",
+                       JERASE_list[jut_iera].jrect.jit_x, JERASE_list[jut_iera].jrect.jit_y,
+                       JERASE_list[jut_iera].jrect.jit_w, JERASE_list[jut_iera].jrect.jit_h);
+                jit_nerr += 1;
+            }
+
+            if (J_NULL != jmt_oput)
+            {
+                free(jmt_oput);
+                jmt_oput = J_NULL;
+            }
+
+            jtest_free(&jdst_coef);
+        }
+
+        jtest_free(&jsrc_coef);
+        free(jmt_jpeg);
+    }
+
+    return jit_nerr;
+}
+
+/**********************************************************/
+/**
+ * @brief jtest_transform() 的回调：jtrans_recode() 。
+ */
+static j_int_t jtest_do_recode(jtrans_this_t jtrans_this, j_void_t * jvt_ctxt)
+{
+    return jtrans_recode(jtrans_this, (const jtrans_recode_t *)jvt_ctxt);
+}
+
+/**********************************************************/
+/**
+ * @brief jtrans_recode()：DCT 系数 与 量化表 完全不变，
+ *        扫描模式、熵编码、重启间隔 按参数改变（ JTRANS_RECODE_KEEP 时 与源图像相同）。
+ */
+static j_int_t jtest_recode(j_void_t)
+{
+    const jtest_input_t JINPUT_list[] =
+    {
+        { 100, 70, J_FALSE, 0, 0, 0 },
+        { 100, 70, J_TRUE , 1, 0, 0 },
+    };
+
+    const jtrans_recode_t JRECODE_list[] =
+    {
+        { JTRANS_RECODE_KEEP, JTRANS_RECODE_KEEP, JTRANS_RECODE_KEEP, J_FALSE },
+        { 1                 , JTRANS_RECODE_KEEP, JTRANS_RECODE_KEEP, J_FALSE },
+        { 0                 , JTRANS_RECODE_KEEP, JTRANS_RECODE_KEEP, J_TRUE  },
+        { JTRANS_RECODE_KEEP, 1                 , JTRANS_RECODE_KEEP, J_FALSE },
+        { 1                 , 1                 , 2                 , J_FALSE },
+        { JTRANS_RECODE_KEEP, 0                 , 0                 , J_TRUE  },
+        { JTRANS_RECODE_KEEP, JTRANS_RECODE_KEEP, 3                 , J_FALSE },
+    };
+
+    jtest_coefs_t           jsrc_coef;
+    jtest_coefs_t           jdst_coef;
+    const jtrans_recode_t * jrc_ptr  = J_NULL;
+    j_mptr_t                jmt_jpeg = J_NULL;
+    unsigned long           jul_jlen = 0;
+    j_uint_t                jut_mcux = 0;
+    j_uint_t                jut_iinp = 0;
+    j_uint_t                jut_irec = 0;
+    j_int_t                 jit_iter = 0;
+    j_int_t                 jit_nerr = 0;
+    j_bool_t                jbl_same = J_FALSE;
+
+    for (jut_iinp = 0; jut_iinp < sizeof(JINPUT_list) / sizeof(JINPUT_list[0]); ++jut_iinp)
+    {
+        jtest_encode(&JINPUT_list[jut_iinp], &jmt_jpeg, &jul_jlen);
+        jtest_read(jmt_jpeg, jul_jlen, &jsrc_coef);
+
+        // 4:2:0 的 MCU 为 16 x 16 像素
+        jut_mcux = (jsrc_coef.jut_imgw + 15) / 16;
+
+        for (jut_irec = 0; jut_irec < sizeof(JRECODE_list) / sizeof(JRECODE_list[0]); ++jut_irec)
+        {
+            jrc_ptr  = &JRECODE_list[jut_irec];
+            jbl_same = (JTRANS_ERR_OK == jtest_transform(
+                                            jmt_jpeg, jul_jlen, jtest_do_recode, (j_void_t *)jrc_ptr,
+                                            &jdst_coef, J_NULL, J_NULL)) &&
+                       (jdst_coef.jut_imgw == jsrc_coef.jut_imgw) &&
+                       (jdst_coef.jut_imgh == jsrc_coef.jut_imgh) &&
+                       (jdst_coef.jit_nchs == jsrc_coef.jit_nchs) &&
+                       (jdst_coef.jbl_prog == ((JTRANS_RECODE_KEEP == jrc_ptr->jit_prog) ?
+                                                    jsrc_coef.jbl_prog : (1 == jrc_ptr->jit_prog))) &&
+                       (jdst_coef.jbl_arith == ((JTRANS_RECODE_KEEP == jrc_ptr->jit_arith) ?
+                                                    jsrc_coef.jbl_arith : (1 == jrc_ptr->jit_arith))) &&
+                       (jdst_coef.jut_rsti == ((JTRANS_RECODE_KEEP == jrc_ptr->jit_rrows) ?
+                                                    jsrc_coef.jut_rsti : (j_uint_t)jrc_ptr->jit_rrows * jut_mcux));
+
+            for (jit_iter = 0; jbl_same && (jit_iter < jsrc_coef.jit_nchs); ++jit_iter)
+            {
+                jbl_same = (jdst_coef.jcomp[jit_iter].jut_wblk == jsrc_coef.jcomp[jit_iter].jut_wblk) &&
+                           (jdst_coef.jcomp[jit_iter].jut_hblk == jsrc_coef.jcomp[jit_iter].jut_hblk) &&
+                           jtest_same_region(&jdst_coef.jcomp[jit_iter], &jsrc_coef.jcomp[jit_iter], 0, 0);
+            }
+
+            if (!jbl_same)
+            {
+                printf("recode    : %s, { %d, %d, %d, %d } : MISMATCH\n",
+                       JINPUT_list[jut_iinp].jbl_prog ? "progressive" : "sequential",
+                       jrc_ptr->jit_prog, jrc_ptr->jit_arith, jrc_ptr->jit_rrows, jrc_ptr->jbl_optim);
+                jit_nerr += 1;
+            }
+
+            jtest_free(&jdst_coef);
+        }
+
+        jtest_free(&jsrc_coef);
+        free(jmt_jpeg);
+    }
+
+    return jit_nerr;
+}
+
+/**********************************************************/
+/**
+ * @brief jtest_transform() 的回调：jtrans_requant() 。
+ */
+static j_int_t jtest_do_requant(jtrans_this_t jtrans_this, j_void_t * jvt_ctxt)
+{
+    return jtrans_requant(jtrans_this, *(j_int_t *)jvt_ctxt);
+}
+
+/**********************************************************/
+/**
+ * @brief 取 libjpeg 在 jit_quality 下的 标准量化表（0 号为亮度表，1 号为色度表，强制基线）。
+ */
+static j_void_t jtest_std_tables(j_int_t jit_quality, UINT16 jqt_qval[2][DCTSIZE2])
+{
+    struct jpeg_compress_struct jcinfo;
+    struct jpeg_error_mgr       jerr;
+
+    jcinfo.err = jpeg_std_error(&jerr);
+    jpeg_create_compress(&jcinfo);
+
+    jcinfo.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&jcinfo);
+    jpeg_set_quality(&jcinfo, jit_quality, TRUE);
+
+    memcpy(jqt_qval[0], jcinfo.quant_tbl_ptrs[0]->quantval, sizeof(jqt_qval[0]));
+    memcpy(jqt_qval[1], jcinfo.quant_tbl_ptrs[1]->quantval, sizeof(jqt_qval[1]));
+
+    jpeg_destroy_compress(&jcinfo);
+}
+
+/**********************************************************/
+/**
+ * @brief jtrans_requant()：目标量化表 为 标准量化表 与 源量化表 的逐项较大值，
+ *        DCT 系数 c 变为 c * 源步长 / 目标步长 四舍五入（恰好位于中点时 向 0 舍入）。
+ */
+static j_int_t jtest_requant(j_void_t)
+{
+    const jtest_input_t JINPUT_list[] =
+    {
+        { 100, 70, J_FALSE, 0, 0, 0 },
+        { 100, 70, J_TRUE , 1, 0, 0 },
+    };
+
+    // 源图像的质量为 90，质量 95 的标准量化表 更细，输出应与源图像相同
+    const j_int_t JQUALITY_list[] = { 1, 30, 50, 75, 95 };
+
+    jtest_coefs_t        jsrc_coef;
+    jtest_coefs_t        jdst_coef;
+    const jtest_comp_t * jdst_ptr = J_NULL;
+    const jtest_comp_t * jsrc_ptr = J_NULL;
+    const JCOEF        * jcf_dst  = J_NULL;
+    const JCOEF        * jcf_src  = J_NULL;
+    UINT16               jstd_tbl[2][DCTSIZE2];
+    UINT16               jqt_qval[DCTSIZE2];
+    j_mptr_t             jmt_jpeg = J_NULL;
+    unsigned long        jul_jlen = 0;
+    j_uint_t             jut_iinp = 0;
+    j_uint_t             jut_iqua = 0;
+    j_uint_t             jut_xblk = 0;
+    j_uint_t             jut_yblk = 0;
+    j_uint_t             jut_nume = 0;
+    j_uint_t             jut_quot = 0;
+    j_int_t              jit_kpos = 0;
+    j_int_t              jit_iter = 0;
+    j_int_t              jit_qual = 0;
+    j_int_t              jit_nerr = 0;
+    j_bool_t             jbl_same = J_FALSE;
+
+    for (jut_iinp = 0; jut_iinp < sizeof(JINPUT_list) / sizeof(JINPUT_list[0]); ++jut_iinp)
+    {
+        jtest_encode(&JINPUT_list[jut_iinp], &jmt_jpeg, &jul_jlen);
+        jtest_read(jmt_jpeg, jul_jlen, &jsrc_coef);
+
+        for (jut_iqua = 0; jut_iqua < sizeof(JQUALITY_list) / sizeof(JQUALITY_list[0]); ++jut_iqua)
+        {
+            jit_qual = JQUALITY_list[jut_iqua];
+            jtest_std_tables(jit_qual, jstd_tbl);
+
+            jbl_same = (JTRANS_ERR_OK == jtest_transform(
+                                            jmt_jpeg, jul_jlen, jtest_do_requant, &jit_qual,
+                                            &jdst_coef, J_NULL, J_NULL)) &&
+                       (jdst_coef.jut_imgw  == jsrc_coef.jut_imgw ) &&
+                       (jdst_coef.jut_imgh  == jsrc_coef.jut_imgh ) &&
+                       (jdst_coef.jit_nchs  == jsrc_coef.jit_nchs ) &&
+                       (jdst_coef.jbl_prog  == jsrc_coef.jbl_prog ) &&
+                       (jdst_coef.jbl_arith == jsrc_coef.jbl_arith) &&
+                       (jdst_coef.jut_rsti  == jsrc_coef.jut_rsti );
+
+            for (jit_iter = 0; jbl_same && (jit_iter < jsrc_coef.jit_nchs); ++jit_iter)
+            {
+                jdst_ptr = &jdst_coef.jcomp[jit_iter];
+                jsrc_ptr = &jsrc_coef.jcomp[jit_iter];
+
+                // 亮度分量 使用 0 号量化表，色度分量 使用 1 号量化表
+                for (jit_kpos = 0; jit_kpos < DCTSIZE2; ++jit_kpos)
+                {
+                    jqt_qval[jit_kpos] = jstd_tbl[(0 == jit_iter) ? 0 : 1][jit_kpos];
+                    if (jqt_qval[jit_kpos] < jsrc_ptr->jqt_qval[jit_kpos])
+                        jqt_qval[jit_kpos] = jsrc_ptr->jqt_qval[jit_kpos];
+                }
+
+                jbl_same = (jdst_ptr->jut_wblk == jsrc_ptr->jut_wblk) &&
+                           (jdst_ptr->jut_hblk == jsrc_ptr->jut_hblk) &&
+                           (0 == memcmp(jdst_ptr->jqt_qval, jqt_qval, sizeof(jqt_qval)));
+
+                for (jut_yblk = 0; jbl_same && (jut_yblk < jdst_ptr->jut_hblk); ++jut_yblk)
+                {
+                    for (jut_xblk = 0; jbl_same && (jut_xblk < jdst_ptr->jut_wblk); ++jut_xblk)
+                    {
+                        jcf_dst = jtest_block(jdst_ptr, jut_xblk, jut_yblk);
+                        jcf_src = jtest_block(jsrc_ptr, jut_xblk, jut_yblk);
+
+                        for (jit_kpos = 0; jbl_same && (jit_kpos < DCTSIZE2); ++jit_kpos)
+                        {
+                            jut_nume = (j_uint_t)abs(jcf_src[jit_kpos]) * jsrc_ptr->jqt_qval[jit_kpos];
+                            jut_quot = jut_nume / jqt_qval[jit_kpos];
+                            if (2 * (jut_nume % jqt_qval[jit_kpos]) > jqt_qval[jit_kpos])
+                                jut_quot += 1;
+
+                            jbl_same = (jcf_dst[jit_kpos] ==
+                                        ((jcf_src[jit_kpos] < 0) ? -(j_int_t)jut_quot : (j_int_t)jut_quot));
+                        }
+                    }
+                }
+            }
+
+            if (!jbl_same)
+            {
+                printf("requant   : %s, quality %d : MISMATCH\n",
+                       JINPUT_list[jut_iinp].jbl_prog ? "progressive" : "sequential", jit_qual);
+                jit_nerr += 1;
+            }
+
+            jtest_free(&jdst_coef);
+        }
+
+        jtest_free(&jsrc_coef);
+        free(jmt_jpeg);
+    }
+
+    return jit_nerr;
+}
+
+/**********************************************************/
+/**
+ * @brief jtest_transform() 的回调：jtrans_grayscale() 。
+ */
+static j_int_t jtest_do_grayscale(jtrans_this_t jtrans_this, j_void_t * jvt_ctxt)
+{
+    return jtrans_grayscale(jtrans_this);
+}
+
+/**********************************************************/
+/**
+ * @brief jtrans_grayscale()：输出为单分量，DCT 系数 与 量化表 等于 源图像的 Y 分量，
+ *        重启间隔 按 Y 分量每个 MCU 的块数 换算，ICC/Adobe 标记 被丢弃，EXIF 标记 保留。
+ */
+static j_int_t jtest_grayscale(j_void_t)
+{
+    const jtest_input_t JINPUT_list[] =
+    {
+        { 100, 70, J_FALSE, 0, JTEST_MKR_ICC | JTEST_MKR_ADOBE, 0 },
+        { 100, 70, J_FALSE, 1, JTEST_MKR_ICC | JTEST_MKR_ADOBE | JTEST_MKR_EXIF_II, 6 },
+        { 100, 70, J_TRUE , 2, JTEST_MKR_ICC | JTEST_MKR_EXIF_MM, 3 },
+    };
+
+    jtest_coefs_t jsrc_coef;
+    jtest_coefs_t jdst_coef;
+    j_mptr_t      jmt_jpeg = J_NULL;
+    unsigned long jul_jlen = 0;
+    j_uint_t      jut_iinp = 0;
+    j_int_t       jit_nerr = 0;
+    j_bool_t      jbl_same = J_FALSE;
+
+    for (jut_iinp = 0; jut_iinp < sizeof(JINPUT_list) / sizeof(JINPUT_list[0]); ++jut_iinp)
+    {
+        jtest_encode(&JINPUT_list[jut_iinp], &jmt_jpeg, &jul_jlen);
+        jtest_read(jmt_jpeg, jul_jlen, &jsrc_coef);
+
+        // 4:2:0 的 每个 MCU 含 2 x 2 个 Y 分量的 DCT 块
+        jbl_same = jsrc_coef.jbl_icc &&
+                   (jsrc_coef.jbl_adobe == (0 != (JINPUT_list[jut_iinp].jit_mkrs & JTEST_MKR_ADOBE))) &&
+                   (JTRANS_ERR_OK == jtest_transform(
+                                        jmt_jpeg, jul_jlen, jtest_do_grayscale, J_NULL,
+                                        &jdst_coef, J_NULL, J_NULL)) &&
+                   (1 == jdst_coef.jit_nchs) &&
+                   (jdst_coef.jut_imgw   == jsrc_coef.jut_imgw) &&
+                   (jdst_coef.jut_imgh   == jsrc_coef.jut_imgh) &&
+                   (jdst_coef.jbl_prog   == jsrc_coef.jbl_prog) &&
+                   (jdst_coef.jut_rsti   == jsrc_coef.jut_rsti * 4) &&
+                   (jdst_coef.jit_orient == jsrc_coef.jit_orient) &&
+                   !jdst_coef.jbl_icc && !jdst_coef.jbl_adobe &&
+                   (jdst_coef.jcomp[0].jut_wblk == jsrc_coef.jcomp[0].jut_wblk) &&
+                   (jdst_coef.jcomp[0].jut_hblk == jsrc_coef.jcomp[0].jut_hblk) &&
+                   jtest_same_region(&jdst_coef.jcomp[0], &jsrc_coef.jcomp[0], 0, 0);
+
+        if (!jbl_same)
+        {
+            printf("grayscale : %s, restart %d rows : MISMATCH\n",
+                   JINPUT_list[jut_iinp].jbl_prog ? "progressive" : "sequential",
+                   JINPUT_list[jut_iinp].jit_rrows);
+            jit_nerr += 1;
+        }
+
+        jtest_free(&jdst_coef);
+        jtest_free(&jsrc_coef);
+        free(jmt_jpeg);
+    }
+
+    return jit_nerr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @struct jtest_case_t
+ * @brief  单项测试。
+ */
+typedef struct jtest_case_t
+{
+    j_cstring_t jsz_name;           ///< 名称
+    j_int_t  (* jfunc_ptr)(j_void_t); ///< 测试函数（返回 不一致的数量）
+} jtest_case_t;
+
+static const jtest_case_t JCASE_list[] =
+{
+    { "crop"     , jtest_crop      },
+    { "slice"    , jtest_slice     },
+    { "rotate"   , jtest_rotate    },
+    { "erase"    , jtest_erase     },
+    { "recode"   , jtest_recode    },
+    { "requant"  , jtest_requant   },
+    { "grayscale", jtest_grayscale },
+};
+
+int main(int argc, char * argv[])
+{
+    j_uint_t jut_iter = 0;
+    j_int_t  jit_nerr = 0;
+    j_int_t  jit_case = 0;
+
+    for (jut_iter = 0; jut_iter < sizeof(JCASE_list) / sizeof(JCASE_list[0]); ++jut_iter)
+    {
+        jit_case  = JCASE_list[jut_iter].jfunc_ptr();
+        jit_nerr += jit_case;
+
+        printf("%-9s : %s\n", JCASE_list[jut_iter].jsz_name, (0 == jit_case) ? "checked" : "FAILED");
+    }
+
+    return (0 == jit_nerr) ? 0 : 1;
+}